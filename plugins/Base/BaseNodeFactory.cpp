@@ -5,6 +5,10 @@
 #include "DADockingAreaInterface.h"
 #include "DAUIInterface.h"
 #include "DAProjectInterface.h"
+#include "BasePythonFunctionNode.h"
+#include "StandardNodes/DAStandardNodeConstValue.h"
+#include "StandardNodes/DAStandardNodeBatchSplit.h"
+#include "StandardNodes/DAStandardNodeBatchCollect.h"
 
 #ifndef REGISTE_CLASS
 #define REGISTE_CLASS(className)                                                                                       \
@@ -23,6 +27,10 @@
 
 BaseNodeFactory::BaseNodeFactory() : DA::DAAbstractNodeFactory()
 {
+	REGISTE_CLASS(BasePythonFunctionNode);
+	REGISTE_CLASS(DA::DAStandardNodeConstValue);
+	REGISTE_CLASS(DA::DAStandardNodeBatchSplit);
+	REGISTE_CLASS(DA::DAStandardNodeBatchCollect);
 }
 
 BaseNodeFactory::~BaseNodeFactory()
@@ -0,0 +1,138 @@
+﻿#include "BasePythonFunctionNode.h"
+#include <QDebug>
+#include <QObject>
+#include "DAData.h"
+#include "DAPyWorkerPool.h"
+#include "DAStandardNodeRectGraphicsItem.h"
+#include "pandas/DAPySeries.h"
+
+/**
+ * @brief 把输入转换为共享内存中的dataframe
+ * @param pool
+ * @param v 输入
+ * @param f 转换结果，写入失败时为空
+ * @param err 错误信息
+ * @return 输入不是dataframe时返回false，作为普通参数传递
+ */
+static bool python_function_shared_input(DA::DAPyWorkerPool& pool, const QVariant& v, DA::DAPySharedFrame& f, QString* err)
+{
+	const int type = v.userType();
+	if (type == qMetaTypeId< DA::DAPySharedFrame >()) {
+		f = v.value< DA::DAPySharedFrame >();
+		return true;
+	}
+	if (type != qMetaTypeId< DA::DAPyDataFrame >() && type != qMetaTypeId< DA::DAPySeries >() && type != qMetaTypeId< DA::DAData >()) {
+		return false;
+	}
+	// 主程序中的python对象，取值和写入都需要持有GIL
+	pybind11::gil_scoped_acquire gil;
+	DA::DAPyObjectWrapper obj;
+	if (type == qMetaTypeId< DA::DAPyDataFrame >()) {
+		obj = v.value< DA::DAPyDataFrame >();
+	} else if (type == qMetaTypeId< DA::DAPySeries >()) {
+		obj = v.value< DA::DAPySeries >();
+	} else {
+		const DA::DAData d = v.value< DA::DAData >();
+		if (d.isDataFrame()) {
+			obj = d.toDataFrame();
+		} else if (d.isSeries()) {
+			obj = d.toSeries();
+		} else {
+			return false;
+		}
+	}
+	f = pool.writeShared(obj, err);
+	return true;
+}
+
+BasePythonFunctionNode::BasePythonFunctionNode() : DA::DAAbstractNode()
+{
+	metaData().setNodePrototype("Base.PythonFunction");
+	metaData().setGroup(u8"python");
+	metaData().setNodeName(u8"Python Function");
+	metaData().setNodeTooltip(QObject::tr("execute a python function in python worker process"));  // cn:在python工作进程中执行python函数
+	// 在工作进程中执行，执行线程不持有GIL
+	metaData().setThreadSafe(true);
+	metaData().setUsePython(true);
+	addInputKey("df");
+	addOutputKey("result");
+	addOutputKey("value");
+}
+
+BasePythonFunctionNode::~BasePythonFunctionNode()
+{
+}
+
+void BasePythonFunctionNode::setFunction(const QString& fun)
+{
+	setProperty("function", fun);
+}
+
+QString BasePythonFunctionNode::getFunction() const
+{
+	return getProperty("function").toString();
+}
+
+/**
+ * @brief 在工作进程中执行函数
+ * @return 函数不存在或者抛出异常时返回false
+ */
+bool BasePythonFunctionNode::exec()
+{
+	const QString fun = getFunction();
+	if (fun.isEmpty()) {
+		qCritical() << QObject::tr("python function node \"%1\" has no function").arg(getNodeName());  // cn:python函数节点“%1”没有设置函数
+		return false;
+	}
+	QVariantMap kwargs;
+	const QList< QString > propertyKeys = getPropertyKeys();
+	for (const QString& k : propertyKeys) {
+		if (k != "function" && !k.startsWith("_da.")) {
+			kwargs[ k ] = getProperty(k);
+		}
+	}
+	DA::DAPyWorkerPool& pool = DA::DAPyWorkerPool::getInstance();
+	QMap< QString, DA::DAPySharedFrame > frames;
+	QString returnFrame;
+	const QList< QString > inputKeys = getInputKeys();
+	for (const QString& k : inputKeys) {
+		const QVariant v = getInputData(k);
+		if (!v.isValid()) {
+			continue;
+		}
+		DA::DAPySharedFrame f;
+		QString err;
+		if (!python_function_shared_input(pool, v, f, &err)) {
+			kwargs[ k ] = v;
+			continue;
+		}
+		if (f.isNull()) {
+			qCritical() << QObject::tr("python function node \"%1\" can not write input %2:%3").arg(getNodeName(), k, err);  // cn:python函数节点“%1”无法写入输入%2
+			return false;
+		}
+		frames[ k ] = f;
+		if (returnFrame.isEmpty()) {
+			returnFrame = k;
+		}
+	}
+	const DA::DAPyWorkerPool::SharedResult r =
+		pool.callShared(fun, frames, kwargs, -1, std::function< bool() >(), returnFrame);
+	if (!r.success) {
+		qCritical().noquote() << QObject::tr("python function node \"%1\" failed:%2").arg(getNodeName(), r.error);  // cn:python函数节点“%1”执行失败
+		return false;
+	}
+	DA::DAPySharedFrame result = r.frames.value("result");
+	if (result.isNull() && !r.frames.isEmpty()) {
+		result = r.frames.first();
+	}
+	setOutputData("result", result.isNull() ? QVariant() : QVariant::fromValue(result));
+	setOutputData("value", r.value);
+	return true;
+}
+
+DA::DAAbstractNodeGraphicsItem* BasePythonFunctionNode::createGraphicsItem()
+{
+	DA::DAStandardNodeRectGraphicsItem* item = new DA::DAStandardNodeRectGraphicsItem(this);
+	item->setText(getFunction().isEmpty() ? metaData().getNodeName() : getFunction());
+	return item;
+}
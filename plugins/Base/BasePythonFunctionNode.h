@@ -0,0 +1,33 @@
+﻿#ifndef BASEPYTHONFUNCTIONNODE_H
+#define BASEPYTHONFUNCTIONNODE_H
+#include "BaseGlobal.h"
+#include "DAAbstractNode.h"
+
+/**
+ * @brief 在python工作进程中执行一个python函数的节点
+ *
+ * 属性function为函数全名（模块.函数，例如DAWorkbench.dataframe.da_query_datas），
+ * 除function和“_da.”开头的内部属性外，其余属性都作为函数的关键字参数；
+ * 每个输入以输入名作为参数名传入（默认输入为df），输出result为函数返回的dataframe，
+ * 函数返回None时（直接修改输入的da_函数）result为修改后的第一个dataframe输入，返回其他值时通过value输出
+ *
+ * 节点通过@ref DA::DAPyWorkerPool::callShared 在工作进程中执行，result为共享内存中的dataframe（@ref DA::DAPySharedFrame ），
+ * 多个此节点串联时dataframe在工作进程之间直接传递，执行线程不获取主程序的GIL，
+ * 因此节点是线程安全的，并行执行时多个节点同时分派给空闲的工作进程；
+ * 只有输入是主程序中的dataframe（DAPyDataFrame、DAPySeries、DAData）时，写入共享内存需要短暂获取GIL
+ */
+class BasePythonFunctionNode : public DA::DAAbstractNode
+{
+public:
+	BasePythonFunctionNode();
+	~BasePythonFunctionNode();
+	// 函数全名
+	void setFunction(const QString& fun);
+	QString getFunction() const;
+	// 运行
+	virtual bool exec() override;
+	//
+	virtual DA::DAAbstractNodeGraphicsItem* createGraphicsItem() override;
+};
+
+#endif  // BASEPYTHONFUNCTIONNODE_H
@@ -36,6 +36,10 @@
 //
 #include "DAAppSettingDialog.h"
 #include "SettingPages/DAAppConfig.h"
+#include "DAWaitCursorScoped.h"
+#if DA_ENABLE_PYTHON
+#include "DAPyAsyncTask.h"
+#endif
 // Qt-Advanced-Docking-System
 #include "DockManager.h"
 namespace DA
@@ -119,6 +123,28 @@ void AppMainWindow::changeEvent(QEvent* e)
  */
 void AppMainWindow::closeEvent(QCloseEvent* e)
 {
+#if DA_ENABLE_PYTHON
+	// 后台的dataframe操作需要先结束，否则保存会得到不完整的数据，退出时线程池析构也会等待拿不到GIL的工作线程
+	const int taskCount = DAPyAsyncTask::getActiveTaskCount();
+	if (taskCount > 0) {
+		auto btn = QMessageBox::question(this,
+		                                 tr("Question"),  // cn:疑问
+		                                 tr("%1 background data operations are running, cancel them and exit?")
+		                                     .arg(taskCount),  // cn:有%1个后台数据操作正在执行，是否取消并退出？
+		                                 QMessageBox::StandardButton::Yes | QMessageBox::StandardButton::No,
+		                                 QMessageBox::StandardButton::No);
+		if (QMessageBox::StandardButton::Yes != btn) {
+			e->ignore();
+			return;
+		}
+		DA_WAIT_CURSOR_SCOPED();
+		DAPyAsyncTask::cancelAll();
+		// 等待期间释放GIL，执行中的任务在下一次检查时中止
+		DAPyAsyncTask::waitForAll();
+		// 处理任务结束的通知，任务会回滚数据并删除自身
+		QCoreApplication::sendPostedEvents();
+	}
+#endif
 	// 判断是否需要保存
 	if (mController->isDirty()) {
 		// 是否保存
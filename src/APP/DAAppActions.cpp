@@ -88,6 +88,7 @@ void DAAppActions::buildDataAction()
     actionDataFrameDataFilterColumn = createAction("actionDataFrameDataSelect",
                                                    ":/app/bright/Icon/dataframe-data-select.svg");
     actionDataFrameSort             = createAction("actionDataFrameSort", ":/app/bright/Icon/dataframe-sort.svg");
+    actionDataFrameRepeatOperations = createAction("actionDataFrameRepeatOperations", ":/app/bright/Icon/redo.svg");
 	actionCreatePivotTable = createAction("actionDataFrameCreatePivotTable", ":/app/bright/Icon/pivot-table.svg");
 }
 
@@ -199,8 +200,13 @@ void DAAppActions::buildWorkflowAction()
 	actionWorkflowViewMarker = createAction("actionWorkflowViewMarker", ":/app/bright/Icon/view-marker.svg", true, false);
 	// 运行
 	actionWorkflowRun       = createAction("actionWorkflowRun", ":/app/bright/Icon/run.svg");
+	actionWorkflowRunToSelectedNode = createAction("actionWorkflowRunToSelectedNode", ":/app/bright/Icon/run.svg");
+	actionWorkflowSweep             = createAction("actionWorkflowSweep", ":/app/bright/Icon/run.svg");
 	actionWorkflowTerminate = createAction("actionWorkflowTerminate", ":/app/bright/Icon/stop.svg");
 	actionWorkflowTerminate->setEnabled(false);
+	actionWorkflowEnableProfile = createAction("actionWorkflowEnableProfile", ":/app/bright/Icon/showInfomation.svg", true, false);
+	actionWorkflowExportProfileTrace = createAction("actionWorkflowExportProfileTrace",
+	                                                ":/app/bright/Icon/exportIndividualData.svg");
 	// 导出
 	actionExportWorkflowSceneToImage = createAction("actionExportWorkflowSceneToImage", ":/app/bright/Icon/exportToPic.svg");
 	actionExportWorkflowSceneToPNG = createAction("actionExportWorkflowSceneToPNG", ":/app/bright/Icon/exportToPng.svg");
@@ -310,6 +316,9 @@ void DAAppActions::retranslateUi()
     actionDataFrameDataFilterColumn->setText(tr("Filter by Column"));                       // cn:列数据过滤
     actionDataFrameSort->setText(tr("Sort"));                                               // cn:数据排序
     actionDataFrameSort->setToolTip(tr("Sort Data"));                                       // cn:对数据进行排序
+    actionDataFrameRepeatOperations->setText(tr("Repeat \nOperations"));  // cn:重复\n操作
+    actionDataFrameRepeatOperations->setToolTip(
+        tr("Apply the data cleaning and filtering operations of the current table to the other opened tables"));  // cn:在其它打开的表格上执行当前表格的数据清洗和过滤操作
     actionCreatePivotTable->setText(tr("Pivot Table"));                                     // cn: 数据\n透视表
     actionCreatePivotTable->setToolTip(tr("Create Pivot Table"));                           // cn: 创建数据透视表
 
@@ -325,7 +334,15 @@ void DAAppActions::retranslateUi()
     actionWorkflowShowGrid->setText(tr("Show \nGrid"));                               // cn:显示\n网格
     actionWorkflowViewReadOnly->setText(tr("Lock \nView"));                           // cn:锁定\n视图
     actionWorkflowRun->setText(tr("Run \nWorkflow"));                                 // cn:运行\n工作流
+    actionWorkflowRunToSelectedNode->setText(tr("Run To \nSelected"));                // cn:运行到\n选中节点
+    actionWorkflowSweep->setText(tr("Parameter \nSweep"));                           // cn:参数\n扫描
     actionWorkflowTerminate->setText(tr("Terminate \nWorkflow"));                     // cn:停止\n工作流
+    actionWorkflowEnableProfile->setText(tr("Profile \nNodes"));                      // cn:记录\n节点性能
+    actionWorkflowEnableProfile->setToolTip(
+        tr("Record the time cost and data size of each node when the workflow runs"));  // cn:运行工作流时记录每个节点的耗时和数据量
+    actionWorkflowExportProfileTrace->setText(tr("Export \nTrace"));                  // cn:导出\n性能时间线
+    actionWorkflowExportProfileTrace->setToolTip(
+        tr("Export the last profile of current workflow as chrome trace json"));  // cn:把当前工作流最近一次的性能记录导出为chrome trace json
     actionWorkflowLinkEnable->setText(tr("Link"));                                    // cn:连线
     actionWorkflowAddBackgroundPixmap->setText(tr("Add \nBackground"));               // cn:添加\n背景
     actionWorkflowLockBackgroundPixmap->setText(tr("Lock Background"));               // cn:锁定背景
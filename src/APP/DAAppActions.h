@@ -82,6 +82,7 @@ public:
     QAction* actionDataFrameDataRetrieval;     ///< 检索指定数据
     QAction* actionDataFrameDataFilterColumn;  ///< 过滤范围外的数据
     QAction* actionDataFrameSort;              ///< 数据排序
+    QAction* actionDataFrameRepeatOperations;  ///< 在其它表格重复当前表格的操作
     QAction* actionCreatePivotTable;           ///< 创建数据透视表
 	//===================================================
 	// workflow的上下文标签
@@ -107,7 +108,11 @@ public:
 	QAction* actionWorkflowLinkEnable;  ///< 允许连接
 	// workflow的运行操作
 	QAction* actionWorkflowRun;        ///< 运行工作流
+	QAction* actionWorkflowRunToSelectedNode;  ///< 运行到选中的节点
+	QAction* actionWorkflowSweep;              ///< 参数扫描
 	QAction* actionWorkflowTerminate;  ///< 停止工作流
+	QAction* actionWorkflowEnableProfile;       ///< 记录节点性能
+	QAction* actionWorkflowExportProfileTrace;  ///< 导出性能时间线
 	//===================================================
 	// 绘图标签 Chart Category
 	//===================================================
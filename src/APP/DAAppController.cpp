@@ -43,6 +43,7 @@
 #include "Dialog/DAExportToPngSettingDialog.h"
 #include "Dialog/DAWorkbenchAboutDialog.h"
 #include "Dialog/DADialogDataFrameFillna.h"
+#include "Dialog/DADialogWorkFlowSweep.h"
 // DACommonWidgets
 #include "DAFontEditPannelWidget.h"
 #include "DAShapeEditPannelWidget.h"
@@ -57,6 +58,8 @@
 #if DA_ENABLE_PYTHON
 #include "DAPyDTypeComboBox.h"
 #include "DAPyScripts.h"
+#include "DAPyWorkerPool.h"
+#include "DAPyAsyncTask.h"
 #include "pandas/DAPyDataFrame.h"
 #include "numpy/DAPyDType.h"
 // Widget
@@ -277,6 +280,7 @@ void DAAppController::initConnection()
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionDataFrameQueryDatas, onActionDataFrameQueryDatasTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionDataFrameDataFilterColumn, onActionDataFrameFilterByColumnTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionDataFrameSort, onActionDataFrameSortTriggered);
+	DAAPPCONTROLLER_ACTION_BIND(mActions->actionDataFrameRepeatOperations, onActionDataFrameRepeatOperationsTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionDataFrameDataRetrieval, onActionDataFrameDataRetrievalTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionCreatePivotTable, onActionCreatePivotTableTriggered);
 #if DA_ENABLE_PYTHON
@@ -309,7 +313,11 @@ void DAAppController::initConnection()
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionItemGrouping, onActionItemGroupingTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionItemUngroup, onActionItemUngroupTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowRun, onActionRunCurrentWorkflowTriggered);
+	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowRunToSelectedNode, onActionRunCurrentWorkflowToSelectedNodeTriggered);
+	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowSweep, onActionWorkflowSweepTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowTerminate, onActionTerminateCurrentWorkflowTriggered);
+	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowEnableProfile, onActionWorkflowEnableProfileTriggered);
+	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowExportProfileTrace, onActionWorkflowExportProfileTraceTriggered);
 	// workflow edit 工作流编辑/data edit 绘图编辑
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowStartDrawRect, onActionStartDrawRectTriggered);
 	DAAPPCONTROLLER_ACTION_BIND(mActions->actionWorkflowStartDrawText, onActionStartDrawTextTriggered);
@@ -470,6 +478,9 @@ QString DAAppController::makeWindowTitle(DAProjectInterface* proj)
 
 void DAAppController::save()
 {
+	if (!checkBackgroundTasksBeforeSave()) {
+		return;
+	}
 	DAAppProject* project   = DA_APP_CORE.getAppProject();
 	QString projectFilePath = project->getProjectFilePath();
 	qDebug() << "Save Project,Path=" << projectFilePath;
@@ -492,11 +503,36 @@ void DAAppController::save()
 	}
 }
 
+/**
+ * @brief 保存前检查后台的dataframe操作
+ *
+ * 后台操作执行中dataframe可能只修改了一部分，此时序列化会得到不完整的数据，因此不允许保存
+ * @return 可以保存返回true
+ */
+bool DAAppController::checkBackgroundTasksBeforeSave()
+{
+#if DA_ENABLE_PYTHON
+	const int cnt = DAPyAsyncTask::getActiveTaskCount();
+	if (cnt > 0) {
+		QMessageBox::warning(app(),
+		                     tr("Warning"),
+		                     tr("%1 background data operations are running, "
+		                        "please save the project after they finish or cancel them")
+		                         .arg(cnt));  // cn:有%1个后台数据操作正在执行，请在完成或取消后再保存工程
+		return false;
+	}
+#endif
+	return true;
+}
+
 /**
  * @brief 另存为
  */
 void DAAppController::saveAs()
 {
+	if (!checkBackgroundTasksBeforeSave()) {
+		return;
+	}
 	QString projectPath =
 		QFileDialog::getSaveFileName(app(),
 									 tr("Save Project"),  // 保存工程
@@ -928,6 +964,14 @@ void DAAppController::onDataOperatePageCreated(DADataOperatePageWidget* page)
 				&DADataOperateOfDataFrameWidget::selectTypeChanged,
 				this,
 				&DAAppController::onDataOperateDataFrameWidgetSelectTypeChanged);
+		connect(w,
+				&DADataOperateOfDataFrameWidget::asyncOperationFinished,
+				this,
+				&DAAppController::onDataOperateDataFrameWidgetAsyncOperationFinished);
+		connect(w,
+				&DADataOperateOfDataFrameWidget::pivotTableCreated,
+				this,
+				&DAAppController::onDataOperateDataFrameWidgetPivotTableCreated);
 #endif
 	} break;
 	default:
@@ -960,6 +1004,37 @@ void DAAppController::onDataOperateDataFrameWidgetSelectTypeChanged(const QList<
 	mRibbon->setDataframeOperateCurrentDType(dt);
 }
 
+/**
+ * @brief dataframe的后台操作结束
+ * @param success 数据被改变时为true
+ */
+void DAAppController::onDataOperateDataFrameWidgetAsyncOperationFinished(bool success)
+{
+	if (success) {
+		setDirty();
+	}
+}
+
+/**
+ * @brief 后台创建数据透视表完成，把透视表作为新的数据添加
+ * @param df
+ */
+void DAAppController::onDataOperateDataFrameWidgetPivotTableCreated(const DAPyDataFrame& df)
+{
+	DADataOperateOfDataFrameWidget* dfopt = qobject_cast< DADataOperateOfDataFrameWidget* >(sender());
+	if (!dfopt || df.empty()) {
+		return;
+	}
+	DAData originData = dfopt->data();
+	DAData data       = df;
+	data.setName(tr("%1_PviotTable").arg(originData.getName()));
+	data.setDescribe(tr("Generate pivot table of %1").arg(originData.getName()));
+	mDatas->addData_(data);
+	// showDataOperate要在m_dataManagerStack.push之后，因为m_dataManagerStack.push可能会导致data的名字改变
+	mDock->showDataOperateWidget(data);
+	setDirty();
+}
+
 /**
  * @brief dataframe的列数据类型改变
  * @param index
@@ -1106,6 +1181,52 @@ void DAAppController::onActionRunCurrentWorkflowTriggered()
 	mDock->getWorkFlowOperateWidget()->runCurrentWorkFlow();
 }
 
+/**
+ * @brief 运行当前工作流到选中的节点
+ *
+ * 只运行计算选中节点所需的上游节点
+ */
+void DAAppController::onActionRunCurrentWorkflowToSelectedNodeTriggered()
+{
+	qDebug() << "onActionRunCurrentWorkflowToSelectedNodeTriggered";
+	DAAppProject* p = DA_APP_CORE.getAppProject();
+	if (nullptr == p) {
+		qCritical() << tr("get null project");  // cn:空工程，接口异常
+		return;
+	}
+	if (p->getProjectBaseName().isEmpty()) {
+		QMessageBox::warning(app(),
+							 tr("warning"),                                                   // cn:警告
+							 tr("Before running the workflow, you need to save the project")  // cn：在运行工作流之前，需要先保存工程
+		);
+		return;
+	}
+	mDock->getWorkFlowOperateWidget()->runCurrentWorkFlowToSelectedNode();
+}
+
+/**
+ * @brief 对当前工作流做参数扫描
+ *
+ * 默认选中场景中选中的节点
+ */
+void DAAppController::onActionWorkflowSweepTriggered()
+{
+	DAWorkFlowEditWidget* w = mDock->getWorkFlowOperateWidget()->getCurrentWorkFlowWidget();
+	if (nullptr == w || nullptr == w->getWorkflow()) {
+		qWarning() << tr("No active workflow detected");  // cn:未检测到激活的工作流
+		return;
+	}
+	if (w->getWorkflow()->isRunning()) {
+		qWarning() << tr("workflow is running");  // cn:工作流正在运行
+		return;
+	}
+	DADialogWorkFlowSweep dlg(w->getWorkflow(), app());
+	if (DAAbstractNodeGraphicsItem* item = w->getWorkFlowGraphicsScene()->getSelectedNodeGraphicsItem()) {
+		dlg.setCurrentNode(item->node());
+	}
+	dlg.exec();
+}
+
 /**
  * @brief 终止当前的工作流
  */
@@ -1113,6 +1234,56 @@ void DAAppController::onActionTerminateCurrentWorkflowTriggered()
 {
 	qDebug() << "onActionTerminateCurrentWorkflowTriggered";
 	mDock->getWorkFlowOperateWidget()->terminateCurrentWorkFlow();
+#if DA_ENABLE_PYTHON
+	// 节点可能正阻塞在python工作进程的调用上，python函数无法中断，只能结束工作进程
+	DAPyWorkerPool::getInstance().cancelAll();
+#endif
+}
+
+/**
+ * @brief 记录节点性能
+ *
+ * 开启后所有工作流在执行时记录节点的耗时和数据量，执行完成在节点上显示热力图
+ * @param on
+ */
+void DAAppController::onActionWorkflowEnableProfileTriggered(bool on)
+{
+	mDock->getWorkFlowOperateWidget()->setEnableProfile(on);
+}
+
+/**
+ * @brief 导出当前工作流最近一次执行的性能时间线
+ *
+ * 导出的json可以用chrome://tracing或Perfetto打开
+ */
+void DAAppController::onActionWorkflowExportProfileTraceTriggered()
+{
+	DAWorkFlow* wf = mDock->getWorkFlowOperateWidget()->getCurrentWorkflow();
+	if (nullptr == wf) {
+		qWarning() << tr("No active workflow detected");  // cn:未检测到激活的工作流
+		return;
+	}
+	DAWorkFlowProfiler::SharedPointer profiler = wf->getLastExecuteProfiler();
+	if (!profiler) {
+		QMessageBox::warning(app(),
+		                     tr("Warning"),  // cn:警告
+		                     tr("There is no profile record for current workflow, please turn on "
+		                        "\"Profile Nodes\" and run the workflow first"));  // cn:当前工作流没有性能记录，请先开启“记录节点性能”并运行工作流
+		return;
+	}
+	QString path = QFileDialog::getSaveFileName(app(),
+	                                            tr("Export Trace"),  // cn:导出性能时间线
+	                                            QString(),
+	                                            tr("Chrome Trace (*.json)")  // cn:Chrome时间线 (*.json)
+	);
+	if (path.isEmpty()) {
+		return;
+	}
+	if (profiler->saveChromeTrace(path)) {
+		qInfo() << tr("The trace was successfully saved in path %1").arg(path);  // cn:性能时间线成功保存到：%1
+	} else {
+		qCritical() << tr("Trace save failed at path %1").arg(path);  // cn:性能时间线保存失败：%1
+	}
 }
 
 void DAAppController::onEditFontChanged(const QFont& f)
@@ -1214,6 +1385,7 @@ void DAAppController::onWorkflowStartExecute(DAWorkFlowEditWidget* wfw)
 {
 	Q_UNUSED(wfw);
 	mActions->actionWorkflowRun->setEnabled(false);
+	mActions->actionWorkflowRunToSelectedNode->setEnabled(false);
 	mActions->actionWorkflowTerminate->setEnabled(true);
 }
 
@@ -1225,6 +1397,7 @@ void DAAppController::onWorkflowStartExecute(DAWorkFlowEditWidget* wfw)
 void DAAppController::onWorkflowFinished(DAWorkFlowEditWidget* wfw, bool success)
 {
 	mActions->actionWorkflowRun->setEnabled(true);
+	mActions->actionWorkflowRunToSelectedNode->setEnabled(true);
 	mActions->actionWorkflowTerminate->setEnabled(false);
 }
 
@@ -1876,18 +2049,8 @@ void DAAppController::onActionCreatePivotTableTriggered()
 	// TODO 此函数应该移动到dataOperateWidget中
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
-		DAPyDataFrame df = dfopt->createPivotTable();
-		if (df.empty()) {
-			return;
-		}
-		DAData originData = dfopt->data();
-		DAData data       = df;
-		data.setName(tr("%1_PviotTable").arg(originData.getName()));
-		data.setDescribe(tr("Generate pivot table of %1").arg(originData.getName()));
-		mDatas->addData_(data);
-		// showDataOperate要在m_dataManagerStack.push之后，因为m_dataManagerStack.push可能会导致data的名字改变
-		mDock->showDataOperateWidget(data);
-		setDirty();
+		// 在后台创建，完成后在onDataOperateDataFrameWidgetPivotTableCreated中添加数据
+		dfopt->createPivotTable();
 	}
 #endif
 }
@@ -1899,8 +2062,8 @@ void DAAppController::onActionDataFrameDropNoneTriggered()
 {
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
+		// 在后台执行，完成后在onDataOperateDataFrameWidgetAsyncOperationFinished中设置dirty
 		dfopt->dropna();
-		setDirty();
 	}
 #endif
 }
@@ -1926,9 +2089,7 @@ void DAAppController::onActionDataFrameFillInterpolateTriggered()
 {
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
-		if (dfopt->interpolate()) {
-			setDirty();
-		}
+		dfopt->interpolate();
 	}
 #endif
 }
@@ -2023,9 +2184,7 @@ void DAAppController::onActionDataFrameQueryDatasTriggered()
 {
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
-		if (dfopt->queryDatas()) {
-			setDirty();
-		}
+		dfopt->queryDatas();
 	}
 #endif
 }
@@ -2065,9 +2224,51 @@ void DAAppController::onActionDataFrameSortTriggered()
 {
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
-		if (dfopt->sortDatas()) {
-			setDirty();
-		}
+		dfopt->sortDatas();
+	}
+#endif
+}
+
+/**
+ * @brief 在其它打开的表格上重复当前表格的操作
+ *
+ * 当前表格已执行的清洗、过滤操作合并为一个批量操作，在每个其它表格上通过一次python调用执行，
+ * 每个表格各自作为一个undo步骤，在后台执行，完成后在onDataOperateDataFrameWidgetAsyncOperationFinished中设置dirty
+ */
+void DAAppController::onActionDataFrameRepeatOperationsTriggered()
+{
+#if DA_ENABLE_PYTHON
+	DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget();
+	if (!dfopt) {
+		return;
+	}
+	int unsupported                = 0;
+	DAPyDataFramePipeline pipeline = dfopt->getOperationPipeline(&unsupported);
+	if (pipeline.isEmpty()) {
+		QMessageBox::warning(app(),
+							 tr("Warning"),
+							 tr("The current table has no operation that can be repeated"));  // cn:当前表格没有可以重复执行的操作
+		return;
+	}
+	QList< DADataOperateOfDataFrameWidget* > targets = getDataOperateWidget()->getDataFrameWidgets();
+	targets.removeAll(dfopt);
+	if (targets.isEmpty()) {
+		QMessageBox::warning(app(), tr("Warning"), tr("There is no other opened table"));  // cn:没有其它打开的表格
+		return;
+	}
+	QString text = tr("Apply %1 operations of the current table to %2 other opened tables?")
+					   .arg(pipeline.size())
+					   .arg(targets.size());  // cn:在其它%2个打开的表格上执行当前表格的%1个操作？
+	if (unsupported > 0) {
+		text += "\n"
+				+ tr("%1 operations depend on the content of the current table (such as editing cells) and will be skipped")
+					  .arg(unsupported);  // cn:%1个操作依赖当前表格的内容（例如编辑单元格），将被跳过
+	}
+	if (QMessageBox::question(app(), tr("Repeat Operations"), text) != QMessageBox::Yes) {
+		return;
+	}
+	for (DADataOperateOfDataFrameWidget* w : qAsConst(targets)) {
+		w->applyPipeline(pipeline);
 	}
 #endif
 }
@@ -2101,7 +2302,6 @@ void DAAppController::onActionCastToDatetimeTriggered()
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* dfopt = getCurrentDataFrameOperateWidget()) {
 		dfopt->castSelectToDatetime();
-		setDirty();
 	}
 #endif
 }
@@ -8,6 +8,7 @@
 #include "DAWorkFlowGraphicsScene.h"
 #if DA_ENABLE_PYTHON
 #include "numpy/DAPyDType.h"
+#include "pandas/DAPyDataFrame.h"
 #endif
 // Qt
 class QComboBox;
@@ -257,10 +258,16 @@ private Q_SLOTS:
 	void onActionDataFrameFilterByColumnTriggered();
 	// 数据排序
 	void onActionDataFrameSortTriggered();
+	// 在其它表格重复当前表格的操作
+	void onActionDataFrameRepeatOperationsTriggered();
 #if DA_ENABLE_PYTHON
 	// 列数据类型改变
 	void onComboxColumnTypesCurrentDTypeChanged(const DA::DAPyDType& dt);
 	void onDataOperateDataFrameWidgetSelectTypeChanged(const QList< int >& column, DA::DAPyDType dt);
+	// dataframe的后台操作结束
+	void onDataOperateDataFrameWidgetAsyncOperationFinished(bool success);
+	// 后台创建数据透视表完成
+	void onDataOperateDataFrameWidgetPivotTableCreated(const DA::DAPyDataFrame& df);
 #endif
 	// 选中列转换为数值
 	void onActionCastToNumTriggered();
@@ -336,8 +343,16 @@ private Q_SLOTS:
 	/////////---运行------
 	// 运行
 	void onActionRunCurrentWorkflowTriggered();
+	// 运行到选中节点
+	void onActionRunCurrentWorkflowToSelectedNodeTriggered();
+	// 参数扫描
+	void onActionWorkflowSweepTriggered();
 	// 终止
 	void onActionTerminateCurrentWorkflowTriggered();
+	// 记录节点性能
+	void onActionWorkflowEnableProfileTriggered(bool on);
+	// 导出性能时间线
+	void onActionWorkflowExportProfileTraceTriggered();
 	//===================================================
 	// 其他
 	//===================================================
@@ -404,6 +419,8 @@ private slots:
 private:
 	// 初始化信号槽
 	void initConnection();
+	// 保存前检查后台的dataframe操作
+	bool checkBackgroundTasksBeforeSave();
 #if DA_ENABLE_PYTHON
 	// 初始化脚本信息
 	void initScripts();
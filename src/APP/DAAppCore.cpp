@@ -16,6 +16,7 @@
 // DA Python
 #include "DAPyInterpreter.h"
 #include "DAPyScripts.h"
+#include "DAWorkFlowSizeEstimators.h"
 #else
 #include <QProcess>
 #include <QList>
@@ -124,6 +125,8 @@ bool DAAppCore::initializePythonEnv()
 			qCritical() << tr("Scripts initialize error");
 			return false;
 		}
+		// 工作流性能记录估算dataframe的大小
+		DA::registerWorkFlowSizeEstimators();
 	} catch (const std::exception& e) {
 		qCritical() << tr("Initialize python environment error:%1").arg(e.what());
 		return false;
@@ -3,8 +3,17 @@
 #include <QFileInfo>
 #include <QUndoStack>
 #include <QDebug>
+#include <QThread>
+#include <QEventLoop>
+#include <QTimer>
+#include <QProgressDialog>
+#include <QMainWindow>
+#include <atomic>
+#include "DACoreInterface.h"
+#include "DAUIInterface.h"
 // DAUtils
 #include "DAStringUtil.h"
+#include "DACsvChunkReader.h"
 #if DA_ENABLE_PYTHON
 // DAPyScript
 #include "DAPyScripts.h"
@@ -25,14 +34,84 @@ DAAppDataManager::~DAAppDataManager()
 {
 }
 
+/**
+ * @brief 在工作线程中读取csv，读取过程显示可以取消的进度对话框
+ *
+ * 读取期间界面保持响应，对话框为窗口模态，避免读取过程中再次导入
+ * @param reader
+ * @param f
+ * @return 读取是否成功，取消时reader.isCanceled()为true
+ */
+bool DAAppDataManager::readCsvInWorker(DACsvChunkReader& reader, const QString& f)
+{
+	std::atomic< int > percent { 0 };
+	reader.setProgressCallback([ &percent ](qint64 processed, qint64 total) -> bool {
+		if (total > 0) {
+			percent = static_cast< int >(processed * 100 / total);
+		}
+		return true;
+	});
+	QWidget* parent = nullptr;
+	if (core() && core()->getUiInterface()) {
+		parent = core()->getUiInterface()->getMainWindow();
+	}
+	QProgressDialog dlg(tr("Reading %1").arg(QFileInfo(f).fileName()),  // cn:正在读取%1
+						tr("Cancel"),                                       // cn:取消
+						0,
+						100,
+						parent);
+	dlg.setWindowModality(Qt::WindowModal);
+	dlg.setMinimumDuration(500);
+	dlg.setAutoClose(false);
+	dlg.setAutoReset(false);
+	connect(&dlg, &QProgressDialog::canceled, &dlg, [ &reader ]() { reader.cancel(); });
+
+	bool ok         = false;
+	QThread* thread = QThread::create([ &reader, &ok, f ]() { ok = reader.read(f); });
+	QEventLoop loop;
+	QTimer timer;
+	timer.setInterval(100);
+	connect(&timer, &QTimer::timeout, &dlg, [ &dlg, &percent ]() { dlg.setValue(percent); });
+	connect(thread, &QThread::finished, &loop, &QEventLoop::quit);
+	thread->start();
+	timer.start();
+	loop.exec();
+	thread->wait();
+	delete thread;
+	timer.stop();
+	return ok;
+}
+
 bool DAAppDataManager::importFromFile(const QString& f, const QVariantMap& args, QString* err)
 {
 #if DA_ENABLE_PYTHON
 	qInfo() << tr("begin import file:%1").arg(f);
+	QFileInfo fi(f);
+	// 没有额外参数的csv文件在工作线程中并行分块解析，解析结果和pandas不一致的情况会读取失败，再回退到pandas
+	if (args.isEmpty() && fi.suffix().compare(QStringLiteral("csv"), Qt::CaseInsensitive) == 0) {
+		DACsvChunkReader reader;
+		const bool readOk = readCsvInWorker(reader, f);
+		if (reader.isCanceled()) {
+			qInfo() << tr("import file:%1 canceled").arg(f);  // cn:取消导入文件:%1
+			if (err) {
+				*err = reader.getLastErrorString();
+			}
+			return false;
+		}
+		if (readOk && reader.rowCount() > 0) {
+			DAData data = DAData::fromCsvReader(reader);
+			if (!data.isNull()) {
+				data.setName(fi.baseName());
+				data.setDescribe(fi.absoluteFilePath());
+				addData_(data);
+				return true;
+			}
+		}
+		qDebug() << "fast csv reader can not read file" << f << reader.getLastErrorString() << ",fallback to pandas";
+	}
 	DAPyObjectWrapper res = DAPyScripts::getInstance().getIO().read(f, args, err);
 	if (DAPyDataFrame::isDataFrame(res.object())) {
 		qInfo() << tr("file:%1,conver to dataframe").arg(f);
-		QFileInfo fi(f);
 		DAPyDataFrame df = res;  // 调用的是DAPyDataFrame(const DAPyObjectWrapper& df)
 		if (df.size() == 0) {
 			qWarning() << tr("The file '%1' has been successfully imported, "
@@ -9,6 +9,7 @@ namespace DA
 {
 DA_IMPL_FORWARD_DECL(DAAppDataManager)
 class DACoreInterface;
+class DACsvChunkReader;
 
 /**
  * @brief DA的变量管理类，da的变量统一由此类管理
@@ -24,6 +25,10 @@ public:
 	// 从文件导入数据,带redo/undo
 	bool importFromFile(const QString& f, const QVariantMap& args = QVariantMap(), QString* err = nullptr);
 	int importFromFiles(const QStringList& fileNames);
+
+protected:
+	// 在工作线程中读取csv，显示可取消的进度
+	bool readCsvInWorker(DACsvChunkReader& reader, const QString& f);
 };
 }  // namespace DA
 
@@ -3,12 +3,15 @@
 #include <QBuffer>
 #include <QDomDocument>
 #include <QFile>
+#include <QFileInfo>
 #include <QScopedPointer>
 #include <QVariant>
 #include <QPen>
 #include <QElapsedTimer>
 #include <QSet>
 #include <QSysInfo>
+#include <QThreadPool>
+#include <QRunnable>
 // DA
 #include "DAWorkFlowOperateWidget.h"
 #include "DAXmlHelper.h"
@@ -28,10 +31,12 @@
 #include "DAWaitCursorScoped.h"
 #include "DAChartItemsManager.h"
 #include "DAChartOperateWidget.h"
+#include "da_concurrent_queue.hpp"
 // python
 #if DA_ENABLE_PYTHON
 #include "DAPyScripts.h"
 #include "DAPyScriptsDataFrame.h"
+#include "DAPyAsyncTask.h"
 #endif
 const QString c_workflowxml_save_filename = QStringLiteral("workflow.xml");
 const QString c_chartsxml_save_filename   = QStringLiteral("charts.xml");
@@ -67,6 +72,13 @@ const QString c_chartitem_save_folder     = QStringLiteral("chart-data");
 #ifndef DAAPPPROJECT_TASK_LOAD_ID_CHARTS_INFO
 #define DAAPPPROJECT_TASK_LOAD_ID_CHARTS_INFO (DAAPPPROJECT_TASK_LOAD_ID_BEGIN + 4)
 #endif
+
+/**
+ *@def 保存任务id - datamanager
+ */
+#ifndef DAAPPPROJECT_TASK_SAVE_ID_DATAMANAGER
+#define DAAPPPROJECT_TASK_SAVE_ID_DATAMANAGER (DAAPPPROJECT_TASK_LOAD_ID_BEGIN + 5)
+#endif
 namespace DA
 {
 
@@ -82,15 +94,24 @@ public:
 
 public:
 	/**
-	 * @brief 获取zip文件路径对应的本地临时文件的路径
+	 * @brief 档案中是否存在数据条目
 	 *
 	 * 此函数必须是执行完任务之后调用，否则没有内容
 	 * @param zipPath
 	 * @return
 	 */
-	QString getLocalTempFilePath(const QString& zipPath) const
+	bool hasDataEntry(const QString& zipPath) const
+	{
+		return mDataEntries.contains(zipPath);
+	}
+
+	/**
+	 * @brief 档案的路径
+	 * @return
+	 */
+	QString getArchiveFilePath() const
 	{
-		return mZipPathToTempFilePath.value(zipPath);
+		return mArchiveFilePath;
 	}
 
 	/**
@@ -136,39 +157,274 @@ public:
 			qDebug() << QString("parse data-manager.xml file error:%1").arg(errorString);
 			return false;
 		}
-		// 准备解压临时数据
-		// 所有数据都在zip的datas目录下
-		mZipPathToTempFilePath = extractDatasFolder(zip, QStringLiteral("datas"), mTempDir);
+		// 所有数据都在zip的datas目录下，数据条目不解压，在主线程中直接从档案读取（见DAData::readFromArchive）
+		const QStringList allFiles = zip->getFolderFileNameList(QStringLiteral("datas"));
+		mDataEntries               = qlist_to_qset(allFiles);
+		mArchiveFilePath           = zip->getBaseFilePath();
 		return true;
 	}
 
-	QHash< QString, QString > extractDatasFolder(DAZipArchive* zip, const QString& zipFolderPath, const QTemporaryDir& tempDir)
+private:
+	QSet< QString > mDataEntries;  ///< 档案中的数据条目
+	QString mArchiveFilePath;
+	QDomDocument mDataManagerDomDocument;
+};
+
+#if DA_ENABLE_PYTHON
+/**
+ * @brief dataframe序列化任务，在线程池中执行
+ *
+ * 执行python前先获取GIL，parquet的写入由pyarrow完成，pyarrow在写入时会释放GIL，
+ * 因此多个数据集的序列化可以并行
+ *
+ * 如果数据内容的哈希和上次保存时一致且临时文件还在，则跳过序列化，直接复用上次的临时文件，
+ * 没有被修改过（非dirty）的数据不计算哈希，有上次的临时文件时直接复用
+ */
+class DADataFrameSerializeRunnable : public QRunnable
+{
+public:
+	struct Result
+	{
+		int index { -1 };         ///< 在数据管理器中的索引
+		bool success { false };    ///< 是否成功
+		bool unchanged { false };  ///< 内容没有变化，跳过了序列化
+		quint64 hash { 0 };       ///< 内容哈希
+	};
+	using ResultQueue = da_concurrent_queue< Result >;
+
+public:
+	DADataFrameSerializeRunnable(int index, const DAData& data, const QString& tempFilePath, quint64 lastHash, bool dirty)
+	    : QRunnable(), mIndex(index), mData(data), mTempFilePath(tempFilePath), mLastHash(lastHash), mDirty(dirty)
+	{
+		setAutoDelete(true);
+	}
+
+	~DADataFrameSerializeRunnable()
 	{
-		QHash< QString, QString > res;
-		// 获取压缩包内所有文件信息
-		const QStringList allFiles = zip->getFolderFileNameList(zipFolderPath);
-		for (const QString& zipfilePath : allFiles) {
-			// 创建目标路径
-			QString fileName = zipfilePath.mid(zipFolderPath.length() + 1);
-
-			QString tempPath = tempDir.filePath(fileName);
-			// 创建文件夹，如果zipFolderPath不是在顶层下面，就应该执行下面这2句
-			//  QFileInfo tempFileInfo(tempPath);
-			//  QDir().mkpath(tempFileInfo.absolutePath());
-			if (zip->readToFile(zipfilePath, tempPath)) {
-				res[ zipfilePath ] = tempPath;
+		// 没有执行就被删除时，DAData同样需要在持有GIL时释放
+		if (!mData.isNull()) {
+			pybind11::gil_scoped_acquire gil;
+			mData = DAData();
+		}
+	}
+
+	void setResultQueue(ResultQueue* queue)
+	{
+		mQueue = queue;
+	}
+
+	void run() override
+	{
+		Result res;
+		res.index = mIndex;
+		if (!mDirty && mLastHash != 0 && QFile::exists(mTempFilePath)) {
+			// 没有修改过，不需要计算哈希
+			res.hash      = mLastHash;
+			res.unchanged = true;
+			res.success   = true;
+			mQueue->push(res);
+			return;
+		}
+		{
+			pybind11::gil_scoped_acquire gil;
+			DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+			if (mDirty) {
+				res.hash = pydf.content_hash(mData.toDataFrame());
+			}
+			if (res.hash != 0 && res.hash == mLastHash && QFile::exists(mTempFilePath)) {
+				res.unchanged = true;
+				res.success   = true;
 			} else {
-				qDebug() << QString("extract file %1 to %2 occur error").arg(zipfilePath, tempPath);
-				continue;
+				res.success = DAData::writeToFile(mData, mTempFilePath);
 			}
+			// DAData持有python对象，需要在持有GIL时释放
+			mData = DAData();
 		}
-		return res;
+		mQueue->push(res);
 	}
 
 private:
-	QHash< QString, QString > mZipPathToTempFilePath;  ///< 记录zip的相对位置和解压的临时文件的相对位置的关系
+	int mIndex;
+	DAData mData;
+	QString mTempFilePath;
+	quint64 mLastHash;
+	bool mDirty;
+	ResultQueue* mQueue { nullptr };
+};
+#endif
+
+/**
+ * @brief 保存数据管理器的任务，在archive线程中执行
+ *
+ * dataframe的序列化在此任务中提交到线程池，按完成的顺序写入档案，
+ * 全部完成后生成data-manager.xml（去掉序列化失败的数据），主线程不需要等待序列化完成。
+ *
+ * 线程池中的任务需要获取GIL，主线程空闲时由DAPyGILIdleRelease释放GIL
+ */
+class DAZipArchiveTask_SaveDataManager : public DAAbstractArchiveTask
+{
+public:
+	DAZipArchiveTask_SaveDataManager(const QDomDocument& doc) : DAAbstractArchiveTask(), mDataManagerDomDocument(doc)
+	{
+		setCode(DAAPPPROJECT_TASK_SAVE_ID_DATAMANAGER);
+	}
+	~DAZipArchiveTask_SaveDataManager()
+	{
+#if DA_ENABLE_PYTHON
+		// 任务没有执行时删除未提交的序列化任务
+		qDeleteAll(mRunnables);
+#endif
+	}
+
+#if DA_ENABLE_PYTHON
+	/**
+	 * @brief 添加一个需要序列化的dataframe，必须在主线程调用
+	 * @param index 在数据管理器中的索引
+	 * @param name 数据名
+	 * @param data 数据
+	 * @param tempFilePath 序列化的临时文件
+	 * @param archivePath 在档案中的路径
+	 * @param lastHash 上次保存时的内容哈希
+	 * @param dirty 数据是否被修改过
+	 */
+	void appendDataFrame(int index,
+	                     const QString& name,
+	                     const DAData& data,
+	                     const QString& tempFilePath,
+	                     const QString& archivePath,
+	                     quint64 lastHash,
+	                     bool dirty)
+	{
+		mRunnables.append(new DADataFrameSerializeRunnable(index, data, tempFilePath, lastHash, dirty));
+		mNames[ index ]         = name;
+		mTempFilePaths[ index ] = tempFilePath;
+		mArchivePaths[ index ]  = archivePath;
+	}
+#endif
+
+	/**
+	 * @brief 序列化完成的数据的内容哈希，任务执行完成后调用
+	 * @return
+	 */
+	QHash< QString, quint64 > getContentHash() const
+	{
+		return mContentHash;
+	}
+
+	/**
+	 * @brief 写入档案的数据条目，任务执行完成后调用
+	 * @return
+	 */
+	QSet< QString > getSavedEntries() const
+	{
+		return mSavedEntries;
+	}
+
+	/**
+	 * @brief 内容没有变化，复用了上次临时文件的数据
+	 * @return
+	 */
+	QStringList getUnchangedNames() const
+	{
+		return mUnchangedNames;
+	}
+
+	/**
+	 * @brief 序列化失败的数据，返回数据名和临时文件路径
+	 * @return
+	 */
+	QList< QPair< QString, QString > > getFailedDatas() const
+	{
+		return mFailedDatas;
+	}
+
+	/**
+	 * @brief exec 注意此函数是在其它线程中执行
+	 * @param archive
+	 * @param mode
+	 * @return
+	 */
+	virtual bool exec(DAAbstractArchive* archive, DAAbstractArchiveTask::Mode mode) override
+	{
+		if (!archive || mode != DAAbstractArchiveTask::WriteMode) {
+			// 只支持写模式
+			return false;
+		}
+		DAZipArchive* zip = static_cast< DAZipArchive* >(archive);
+		if (!zip->isOpened()) {
+			if (!zip->create()) {
+				qDebug() << QString("create archive error:%1").arg(zip->getBaseFilePath());
+				return false;
+			}
+		}
+		QSet< QString > failedNames;
+#if DA_ENABLE_PYTHON
+		if (!mRunnables.isEmpty()) {
+			DADataFrameSerializeRunnable::ResultQueue resultQueue;
+			QThreadPool pool;
+			const int cnt = mRunnables.size();
+			pool.setMaxThreadCount(qMax(1, qMin(QThread::idealThreadCount(), cnt)));
+			for (DADataFrameSerializeRunnable* r : qAsConst(mRunnables)) {
+				r->setResultQueue(&resultQueue);
+				pool.start(r);
+			}
+			// 线程池负责删除
+			mRunnables.clear();
+			// 按完成的顺序写入档案
+			for (int n = 0; n < cnt; ++n) {
+				DADataFrameSerializeRunnable::Result res = resultQueue.get();
+				const QString name                       = mNames.value(res.index);
+				const QString archivePath                = mArchivePaths.value(res.index);
+				if (!res.success) {
+					failedNames.insert(name);
+					mFailedDatas.append(qMakePair(name, mTempFilePaths.value(res.index)));
+					continue;
+				}
+				if (res.unchanged) {
+					mUnchangedNames.append(name);
+				}
+				if (res.hash != 0) {
+					mContentHash[ name ] = res.hash;
+				}
+				if (!zip->writeFileToZip(archivePath, mTempFilePaths.value(res.index))) {
+					qDebug() << QString("Unable to write the file from %1 to %2").arg(mTempFilePaths.value(res.index), archivePath);
+					pool.waitForDone();
+					return false;
+				}
+				mSavedEntries.insert(archivePath);
+			}
+			pool.waitForDone();
+		}
+#endif
+		// 去掉序列化失败的数据
+		QDomElement datasEle = mDataManagerDomDocument.documentElement().firstChildElement(QStringLiteral("datas"));
+		QDomElement dEle     = datasEle.firstChildElement(QStringLiteral("d"));
+		while (!dEle.isNull()) {
+			QDomElement next = dEle.nextSiblingElement(QStringLiteral("d"));
+			if (failedNames.contains(dEle.attribute(QStringLiteral("name")))) {
+				datasEle.removeChild(dEle);
+			}
+			dEle = next;
+		}
+		if (!zip->write(QStringLiteral("data-manager.xml"), mDataManagerDomDocument.toByteArray())) {
+			qDebug() << QString("write data to \"data-manager.xml\" error");
+			return false;
+		}
+		return true;
+	}
+
+private:
+#if DA_ENABLE_PYTHON
+	QList< DADataFrameSerializeRunnable* > mRunnables;  ///< 未提交的序列化任务
+#endif
+	QHash< int, QString > mNames;
+	QHash< int, QString > mTempFilePaths;
+	QHash< int, QString > mArchivePaths;
 	QDomDocument mDataManagerDomDocument;
-	QTemporaryDir mTempDir;
+	QHash< QString, quint64 > mContentHash;
+	QSet< QString > mSavedEntries;
+	QStringList mUnchangedNames;
+	QList< QPair< QString, QString > > mFailedDatas;
 };
 
 ////////////////////////////////////////////////////
@@ -347,6 +603,11 @@ void DAAppProject::clear()
 	DADataOperateWidget* dow = getDataOperateWidget();
 	Q_CHECK_PTR(dow);
 	dow->clear();
+	// 数据释放后，保存时因被内存映射而没能删除的旧工程文件可以删除了
+	DAAbstractArchive::removeReplacedFiles(getProjectFilePath());
+	mDataContentHash.clear();
+	mLastArchivePath.clear();
+	mLastArchiveDataEntries.clear();
 	DAProjectInterface::clear();
 }
 
@@ -371,9 +632,19 @@ bool DAAppProject::save(const QString& path)
 		qInfo() << tr("current project is busy");  // cn:当前工程正繁忙
 		return false;
 	}
+#if DA_ENABLE_PYTHON
+	// 后台操作可能只修改了dataframe的一部分，此时序列化会得到不完整的数据
+	if (DAPyAsyncTask::getActiveTaskCount() > 0) {
+		qWarning() << tr("background data operations are running, the project can not be saved now");  // cn:后台数据操作正在执行，当前无法保存工程
+		return false;
+	}
+#endif
 
 	setProjectPath(path);
 	DA_WAIT_CURSOR_SCOPED();
+	// 保存是异步的，记录开始保存时的修改计数，保存过程中的修改在保存完成后保持dirty
+	mSavingProjectModifiedCount = getModifiedCount();
+	mSavingDataModifiedCount    = getDataManagerInterface()->dataManager()->getModifiedCount();
     //! 保存系统信息，仅仅保存不读取
     makeSaveSystemInfoTask(mArchive);
 
@@ -476,6 +747,13 @@ void DAAppProject::makeSaveWorkFlowTask(DAZipArchiveThreadWrapper* archive)
 
 /**
  * @brief 保存数据的任务
+ *
+ * 没有被修改过且上一次保存的档案中已有的数据，直接从上一次的档案中原样复制，不再序列化；
+ * 其余dataframe在@ref DAZipArchiveTask_SaveDataManager 中序列化，任务在archive线程中执行，
+ * 序列化在线程池中并行，每个数据集序列化完成后立即写入档案，主线程不等待，
+ * 内容哈希和上次保存一致的数据集不再重复序列化，没有修改过的数据集不计算哈希
+ *
+ * 结果（内容哈希、写入的条目、失败的数据）在@ref onTaskProgress 中取回
  * @param archive
  */
 void DAAppProject::makeSaveDataManagerTask(DAZipArchiveThreadWrapper* archive)
@@ -491,26 +769,11 @@ void DAAppProject::makeSaveDataManagerTask(DAZipArchiveThreadWrapper* archive)
 	QDomElement dataListEle = doc.createElement(QStringLiteral("datas"));
 	const int datacnt       = dataMgr->getDataCount();
 	for (int i = 0; i < datacnt; ++i) {
-		// 逐个遍历DAData，并生成datamanager.xml和把数据文件进行持久化
+		// 逐个遍历DAData，并生成datamanager.xml，序列化失败的数据由保存任务去掉
 		DAData data                   = dataMgr->getData(i);
 		DAAbstractData::DataType type = data.getDataType();
 		QString name                  = data.getName();
-		QString tempFilePath          = makeDataTemporaryFilePath(name);
 		QString dataZipPath           = makeDataArchiveFilePath(name);
-		switch (type) {
-		case DAAbstractData::TypePythonDataFrame: {
-			// 写文件，对于大文件，这里可能比较耗时，但python的gli机制，无法在线程里面写
-			if (!DAData::writeToFile(data, tempFilePath)) {
-				qCritical() << tr("An exception occurred while serializing the dataframe named %1 to %2")
-                                   .arg(name, tempFilePath);  // cn:把名称为%1的dataframe序列化到%2时出现异常
-				continue;
-			}
-			// 创建archive任务队列
-			mArchive->appendFileSaveTask(dataZipPath, tempFilePath);
-		} break;
-		default:
-			break;
-		}
 		// 创建ele
 		QDomElement dataEle = doc.createElement(QStringLiteral("d"));
 
@@ -527,8 +790,40 @@ void DAAppProject::makeSaveDataManagerTask(DAZipArchiveThreadWrapper* archive)
 		dataListEle.appendChild(dataEle);
 	}
 	root.appendChild(dataListEle);
+	std::shared_ptr< DAZipArchiveTask_SaveDataManager > saveDataTask = std::make_shared< DAZipArchiveTask_SaveDataManager >(doc);
+	mSavingArchiveDataEntries.clear();
+#if DA_ENABLE_PYTHON
+	// 未修改的数据从上一次的档案复制，其余的交给保存任务序列化
+	const bool canReuseLastArchive = !mLastArchivePath.isEmpty() && QFileInfo::exists(mLastArchivePath);
+	QStringList reuseEntries;
+	QHash< QString, quint64 > contentHash;
+	for (int i = 0; i < datacnt; ++i) {
+		DAData data = dataMgr->getData(i);
+		if (data.getDataType() != DAAbstractData::TypePythonDataFrame) {
+			continue;
+		}
+		const QString name        = data.getName();
+		const QString dataZipPath = makeDataArchiveFilePath(name);
+		const bool dirty          = dataMgr->dataManager()->isDataDirty(data);
+		if (canReuseLastArchive && !dirty && mLastArchiveDataEntries.contains(dataZipPath)) {
+			reuseEntries.append(dataZipPath);
+			if (mDataContentHash.contains(name)) {
+				contentHash[ name ] = mDataContentHash.value(name);
+			}
+		} else {
+			saveDataTask->appendDataFrame(
+			    i, name, data, makeDataTemporaryFilePath(name), dataZipPath, mDataContentHash.value(name, 0), dirty);
+		}
+	}
+	if (!reuseEntries.isEmpty()) {
+		archive->appendEntryCopyTask(mLastArchivePath, reuseEntries);
+	}
+	mSavingArchiveDataEntries = qlist_to_qset(reuseEntries);
+	// 序列化的数据的哈希在保存任务完成后合并
+	mDataContentHash = contentHash;
+#endif
 	// 创建archive任务队列
-	archive->appendXmlSaveTask(QStringLiteral("data-manager.xml"), doc);
+	archive->appendTask(saveDataTask);
 }
 
 /**
@@ -656,24 +951,21 @@ void DAAppProject::onTaskProgress(int total, int pos, const std::shared_ptr< DAA
 			switch (t) {
 #if DA_ENABLE_PYTHON
 			case DAAbstractData::TypePythonDataFrame: {
-				QString tempLocalFilePath = datamgrTask->getLocalTempFilePath(valueText);
-				if (tempLocalFilePath.isEmpty()) {
-					qCritical() << tr("Unable to find the temporary file corresponding to %1").arg(valueText);  // cn:无法在找到%1对应的临时文件
+				if (!datamgrTask->hasDataEntry(valueText)) {
+					qCritical() << tr("Unable to find the file corresponding to %1 in archive").arg(valueText);  // cn:无法在档案中找到%1对应的文件
 					return;
 				}
-				DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
-				DAPyDataFrame df;
-				if (!pydf.from_parquet(df, tempLocalFilePath)) {
-					qCritical() << tr("Unable to serialize the file %1 into a Dataframe").arg(tempLocalFilePath);  // cn:无法把文件%1序列化为Dataframe
+				// 新版本为不压缩存放的DA列式文件（直接内存映射工程文件按需加载），旧版本为parquet
+				DAData dataDataframe = DAData::readFromArchive(datamgrTask->getArchiveFilePath(), valueText, t);
+				if (dataDataframe.isNull()) {
+					qCritical() << tr("Unable to serialize the file %1 into a Dataframe").arg(valueText);  // cn:无法把文件%1序列化为Dataframe
 					return;
 				}
-				qDebug() << df;
-				// 创建DAData
-				DAData dataDataframe(df);
 				dataDataframe.setName(name);
 				dataDataframe.setDescribe(describeText);
 				// 不使用dataMgr->addData(),因为这个是带回退的
 				dataMgr->dataManager()->addData(dataDataframe);
+				mLastArchiveDataEntries.insert(valueText);
 			} break;
 #endif
 			default:
@@ -681,6 +973,25 @@ void DAAppProject::onTaskProgress(int total, int pos, const std::shared_ptr< DAA
 			}
 		}
 	} break;
+	case DAAPPPROJECT_TASK_SAVE_ID_DATAMANAGER: {
+		//! 取回保存数据的结果
+		const std::shared_ptr< DAZipArchiveTask_SaveDataManager >
+		    saveDataTask                         = std::static_pointer_cast< DAZipArchiveTask_SaveDataManager >(t);
+		const QHash< QString, quint64 > hashs = saveDataTask->getContentHash();
+		for (auto i = hashs.begin(); i != hashs.end(); ++i) {
+			mDataContentHash[ i.key() ] = i.value();
+		}
+		mSavingArchiveDataEntries.unite(saveDataTask->getSavedEntries());
+		const QStringList unchangedNames = saveDataTask->getUnchangedNames();
+		if (!unchangedNames.isEmpty()) {
+			qDebug() << "skip serializing unchanged dataframes:" << unchangedNames;
+		}
+		const QList< QPair< QString, QString > > failedDatas = saveDataTask->getFailedDatas();
+		for (const QPair< QString, QString >& f : failedDatas) {
+			qCritical() << tr("An exception occurred while serializing the dataframe named %1 to %2")
+                               .arg(f.first, f.second);  // cn:把名称为%1的dataframe序列化到%2时出现异常
+		}
+	} break;
     case DAAPPPROJECT_TASK_LOAD_ID_CHARTITEMMANAGER: {
         const std::shared_ptr< DAZipArchiveTask_ChartItem > chartMgrArchive = std::static_pointer_cast< DAZipArchiveTask_ChartItem >(
             t);
@@ -712,7 +1023,15 @@ void DAAppProject::onSaveFinish(bool success)
 {
 	QString savePath = getProjectFilePath();
 	if (success) {
-		setModified(false);
+		// 记录本次保存的档案，下次保存时未修改的数据直接从这个档案复制
+		mLastArchivePath        = savePath;
+		mLastArchiveDataEntries = mSavingArchiveDataEntries;
+		getDataManagerInterface()->dataManager()->clearDirtyFlagBefore(mSavingDataModifiedCount);
+		if (getModifiedCount() == mSavingProjectModifiedCount) {
+			setModified(false);
+		} else {
+			qInfo() << tr("The project was modified during saving and needs to be saved again");  // cn:工程在保存过程中发生了修改，需要再次保存
+		}
 		Q_EMIT projectSaved(savePath);
 		qInfo() << tr("Successfully save archive : %1").arg(savePath);  // cn:成功保存工程:%1
 	} else {
@@ -728,6 +1047,9 @@ void DAAppProject::onLoadFinish(bool success)
 {
 	QString loadPath = getProjectFilePath();
 	if (success) {
+		// 加载的数据和档案一致，清除数据的脏标记
+		mLastArchivePath = loadPath;
+		getDataManagerInterface()->dataManager()->setDirtyFlag(false);
 		setModified(false);
 		qInfo() << tr("Successfully load archive : %1").arg(loadPath);  // cn:成功加载工程:%1
 		Q_EMIT projectLoaded(loadPath);
@@ -4,6 +4,8 @@
 #include <QDomElement>
 #include <QDomDocument>
 #include <QTemporaryDir>
+#include <QHash>
+#include <QSet>
 #include "DAProjectInterface.h"
 #include "DAGlobals.h"
 #include "DAAbstractNodeLinkGraphicsItem.h"
@@ -87,6 +89,12 @@ private:
 	DAXmlHelper mXml;
 	std::unique_ptr< QTemporaryDir > mTempDir;
     DAChartItemsManager mChartItemManager;
+	QHash< QString, quint64 > mDataContentHash;  ///< 上次保存时数据内容的哈希，key为数据名，用于跳过未变化数据的序列化
+	QString mLastArchivePath;                    ///< 上一次保存或加载的档案路径
+	QSet< QString > mLastArchiveDataEntries;     ///< 上一次档案中已有的数据条目
+	QSet< QString > mSavingArchiveDataEntries;   ///< 正在保存的档案中的数据条目，保存成功后成为mLastArchiveDataEntries
+	quint64 mSavingProjectModifiedCount { 0 };   ///< 开始保存时工程的修改计数
+	quint64 mSavingDataModifiedCount { 0 };      ///< 开始保存时数据的修改计数
 };
 
 }  // namespace DA
@@ -404,6 +404,8 @@ void DAAppRibbonArea::buildContextCategoryDataFrame()
 	// 数据过滤
 	m_pannelDataframeOperateDataFiltering->addLargeAction(m_actions->actionDataFrameDataFilterColumn);
 	m_pannelDataframeOperateDataFiltering->addLargeAction(m_actions->actionDataFrameSort);
+	m_pannelDataframeOperateDataFiltering->addSeparator();
+	m_pannelDataframeOperateDataFiltering->addLargeAction(m_actions->actionDataFrameRepeatOperations);
 	//  Statistic Pannel
 	m_pannelDataframeOperateStatistic = m_categoryDataframeOperate->addPannel(tr("Statistic"));  // cn：统计
 	m_pannelDataframeOperateStatistic->addLargeAction(m_actions->actionCreateDataDescribe);
@@ -603,7 +605,11 @@ void DAAppRibbonArea::buildContextCategoryWorkflowRun_()
 	m_pannelWorkflowRun = m_categoryWorkflowRun->addPannel(tr("Run"));
 	m_pannelWorkflowRun->setObjectName(QStringLiteral("da-pannel-context.workflow.run"));
 	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowRun);
+	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowRunToSelectedNode);
+	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowSweep);
 	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowTerminate);
+	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowEnableProfile);
+	m_pannelWorkflowRun->addLargeAction(m_actions->actionWorkflowExportProfileTrace);
 }
 
 /**
@@ -1,6 +1,7 @@
 ﻿#include "DADataWorkFlow.h"
 #include "DAAppPluginManager.h"
 #include "DAAbstractNodeFactory.h"
+#include "DAData.h"
 //===================================================
 // using DA namespace -- 禁止在头文件using！！
 //===================================================
@@ -22,4 +23,12 @@ DADataWorkFlow::DADataWorkFlow(QObject* p) : DA::DAWorkFlow(p)
         // 注册工厂
         registFactory(factory);
     }
+    // 节点之间传递的DAData通过id和修订号计算指纹，不遍历数据内容
+    DAAbstractNode::registVariantHashFunction(qMetaTypeId< DAData >(), [](const QVariant& v) -> uint64_t {
+        const DAData d = v.value< DAData >();
+        if (!d) {
+            return 0;
+        }
+        return (d.id() * 0x9e3779b97f4a7c15ULL) ^ (d.getRevision() + 1);
+    });
 }
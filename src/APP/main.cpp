@@ -28,6 +28,7 @@
 #include "DAPyScripts.h"
 #include "DAPyInterpreter.h"
 #include "DAPybind11QtTypeCast.h"
+#include "DAPyGILIdleRelease.h"
 #endif
 // SARibbon
 #include "SARibbonBar.h"
@@ -112,7 +113,17 @@ int main(int argc, char* argv[])
 		}
 	}
 	w.show();
+#if DA_ENABLE_PYTHON
+	// 事件循环空闲时释放GIL，工作流执行器、异步任务等线程才能执行python
+	if (core.isPythonInterpreterInitialized()) {
+		DA::DAPyGILIdleRelease::getInstance().install();
+	}
+#endif
 	int r = app.exec();
+#if DA_ENABLE_PYTHON
+	// 主窗口析构和python结束都需要持有GIL
+	DA::DAPyGILIdleRelease::getInstance().uninstall();
+#endif
 	DA::daUnregisterMessageHandler();
 	return r;
 }
@@ -95,6 +95,26 @@ void DAAbstractData::setID(DAAbstractData::IdType d)
     mID = d;
 }
 
+/**
+ * @brief 获取修订号
+ *
+ * 修订号在数据内容改变时增加（@ref DAData::setValue ，以及DADataManager中数据被标记为dirty时），
+ * 工作流通过id和修订号判断节点的输入是否发生了变化
+ * @return
+ */
+uint64_t DAAbstractData::getRevision() const
+{
+    return mRevision;
+}
+
+/**
+ * @brief 修订号加1
+ */
+void DAAbstractData::increaseRevision()
+{
+    ++mRevision;
+}
+
 QString DAAbstractData::typeToString(DAAbstractData::DataType d)
 {
 	switch (d) {
@@ -57,6 +57,9 @@ public:
 	// id操作
 	IdType id() const;
 	void setID(IdType d);
+	// 修订号，数据内容每改变一次加1，可用于判断数据是否改变
+	uint64_t getRevision() const;
+	void increaseRevision();
 
 public:
 	// 类型转换为文字
@@ -69,6 +72,7 @@ private:
 	QString mDescribe;  ///< 描述
 	Pointer mParent;    ///< 记录父级节点
 	IdType mID;         ///< id
+	uint64_t mRevision { 0 };  ///< 修订号
 };
 
 }  // namespace DA
@@ -1,10 +1,14 @@
 ﻿// qt
 #include <QFileDialog>
 #include <QFileInfo>
+#include <QFile>
+#include <QDebug>
 
 #include "DAData.h"
 #include "DADataManager.h"
+#include "DACsvChunkReader.h"
 #if DA_ENABLE_PYTHON
+#include "DAPybind11QtTypeCast.h"
 #include "DAPyScripts.h"
 #include "DADataPyObject.h"
 #include "DADataPyDataFrame.h"
@@ -149,6 +153,7 @@ bool DAData::setValue(const QVariant& v) const
 	}
 	bool r = mData->setValue(v);
 	if (r) {
+		mData->increaseRevision();
 		if (mDataMgr) {
 			mDataMgr->callDataChangedSignal(*this, DADataManager::ChangeValue);
 		}
@@ -219,6 +224,16 @@ DAData::IdType DAData::id() const
 	return mData->id();
 }
 
+/**
+ * @brief 获取修订号
+ * @return 空数据返回0
+ * @sa DAAbstractData::getRevision
+ */
+uint64_t DAData::getRevision() const
+{
+	return mData ? mData->getRevision() : 0;
+}
+
 bool DAData::isDataFrame() const
 {
 	if (!mData) {
@@ -307,6 +322,9 @@ DADataManager* DAData::getDataManager() const
 
 /**
  * @brief 把数据写到文件
+ *
+ * dataframe写为DA列式文件，读取时可以内存映射按需加载，
+ * 含有列式文件无法无损保存的值（如date、Decimal）时写为parquet，@sa readFromFile
  * @param data
  * @param filePath
  * @return
@@ -319,7 +337,8 @@ bool DAData::writeToFile(const DAData& data, const QString& filePath)
     switch (data.getDataType()) {
 #if DA_ENABLE_PYTHON
     case DAAbstractData::TypePythonDataFrame: {
-        return data.toDataFrame().to_parquet(filePath);
+        DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+        return pydf.to_columnar(data.toDataFrame(), filePath);
     } break;
 #endif
     default:
@@ -328,6 +347,137 @@ bool DAData::writeToFile(const DAData& data, const QString& filePath)
     return true;
 }
 
+/**
+ * @brief 从writeToFile写出的文件读取数据
+ *
+ * 对于dataframe，根据文件头判断是DA列式文件还是旧版本工程的parquet文件
+ * @param filePath
+ * @param type 数据类型
+ * @return 失败返回空的DAData
+ */
+DAData DAData::readFromFile(const QString& filePath, DAAbstractData::DataType type)
+{
+    switch (type) {
+#if DA_ENABLE_PYTHON
+    case DAAbstractData::TypePythonDataFrame: {
+        QFile file(filePath);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return DAData();
+        }
+        const QByteArray magic = file.read(5);
+        file.close();
+        DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+        DAPyDataFrame df;
+        bool isok = false;
+        // 版本号由da_from_columnar检查
+        if (magic == QByteArrayLiteral("DACOL")) {
+            isok = pydf.from_columnar(df, filePath);
+        } else {
+            isok = pydf.from_parquet(df, filePath);
+        }
+        if (!isok) {
+            return DAData();
+        }
+        return DAData(df);
+    } break;
+#endif
+    default:
+        break;
+    }
+    return DAData();
+}
+
+/**
+ * @brief 直接从工程档案（zip）的条目读取writeToFile写出的数据，不需要先解压
+ *
+ * 对于dataframe，不压缩存放的DA列式条目会内存映射档案文件，按需加载
+ * @param archivePath 档案路径
+ * @param entry 条目在档案中的路径
+ * @param type 数据类型
+ * @return 失败返回空的DAData
+ */
+DAData DAData::readFromArchive(const QString& archivePath, const QString& entry, DAAbstractData::DataType type)
+{
+    switch (type) {
+#if DA_ENABLE_PYTHON
+    case DAAbstractData::TypePythonDataFrame: {
+        DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+        DAPyDataFrame df;
+        if (!pydf.from_archive(df, archivePath, entry)) {
+            return DAData();
+        }
+        return DAData(df);
+    } break;
+#endif
+    default:
+        break;
+    }
+    return DAData();
+}
+
+#if DA_ENABLE_PYTHON
+/**
+ * @brief 把std::vector的所有权转移给numpy数组，避免再复制一次数据
+ */
+template< typename T >
+static pybind11::array vectorToNumpyArray(std::vector< T >&& v)
+{
+    auto* holder = new std::vector< T >(std::move(v));
+    pybind11::capsule owner(holder, [](void* p) { delete static_cast< std::vector< T >* >(p); });
+    return pybind11::array_t< T >(holder->size(), holder->data(), owner);
+}
+
+/**
+ * @brief 把DACsvChunkReader读取的列直接构建为dataframe
+ *
+ * 数值和日期时间列直接转移为numpy数组，不经过pandas的csv解析，
+ * 调用后reader中的数据会被取走
+ * @param reader 已经读取成功的reader
+ * @return 失败返回空的DAData
+ */
+DAData DAData::fromCsvReader(DACsvChunkReader& reader)
+{
+    try {
+        std::vector< DACsvChunkReader::Column > columns = reader.takeColumns();
+        pybind11::dict datas;
+        for (DACsvChunkReader::Column& c : columns) {
+            pybind11::object arr;
+            switch (c.type) {
+            case DACsvChunkReader::ColumnInt64:
+                arr = vectorToNumpyArray(std::move(c.int64s));
+                break;
+            case DACsvChunkReader::ColumnDouble:
+                arr = vectorToNumpyArray(std::move(c.doubles));
+                break;
+            case DACsvChunkReader::ColumnDateTime:
+                // NullDateTime和numpy的NaT一致
+                arr = vectorToNumpyArray(std::move(c.int64s)).attr("view")("datetime64[ms]");
+                break;
+            default: {
+                pybind11::list strs(c.strings.size());
+                for (size_t i = 0; i < c.strings.size(); ++i) {
+                    if (c.strings[ i ].isNull()) {
+                        strs[ i ] = pybind11::none();
+                    } else {
+                        strs[ i ] = PY::toPyStr(c.strings[ i ]);
+                    }
+                }
+                std::vector< QString >().swap(c.strings);
+                arr = strs;
+            } break;
+            }
+            datas[ PY::toPyStr(c.name) ] = arr;
+        }
+        pybind11::module pd = pybind11::module::import("pandas");
+        pybind11::object df = pd.attr("DataFrame")(datas, pybind11::arg("copy") = false);
+        return DAData(DAPyDataFrame(df));
+    } catch (const std::exception& e) {
+        qCritical() << e.what();
+    }
+    return DAData();
+}
+#endif
+
 /**
  * @brief 导出数据
  * @param data
@@ -11,6 +11,7 @@
 namespace DA
 {
 class DADataManager;
+class DACsvChunkReader;
 /**
  * @brief DAAbstractData的封装
  * 可以放入QMap，QHash中，DAData的等于操作相当于创建一个引用
@@ -65,6 +66,8 @@ public:  // DAAbstractData Wrapper
 	const Pointer getPointer() const;
 	// 获取id
 	IdType id() const;
+	// 获取修订号，数据内容改变后修订号会增加
+	uint64_t getRevision() const;
 	// 是否为dataframe
 	bool isDataFrame() const;
 	bool isSeries() const;
@@ -85,6 +88,14 @@ public:  // DAAbstractData Wrapper
 public:
     // 把数据写到文件
     static bool writeToFile(const DAData& data, const QString& filePath);
+    // 从writeToFile写出的文件读取数据
+    static DAData readFromFile(const QString& filePath, DAAbstractData::DataType type);
+    // 直接从工程档案的条目读取数据
+    static DAData readFromArchive(const QString& archivePath, const QString& entry, DAAbstractData::DataType type);
+#if DA_ENABLE_PYTHON
+    // 把DACsvChunkReader读取的列直接构建为dataframe，不经过pandas解析csv
+    static DAData fromCsvReader(DACsvChunkReader& reader);
+#endif
     //导出数据
     static bool exportToFile(const DAData& data, const QString& filePath, const QString& sep = ",");
 
@@ -1,6 +1,8 @@
 ﻿#include "DADataManager.h"
 #include <QList>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QDebug>
 #include <QUndoStack>
 // DAUtils
@@ -17,7 +19,11 @@ public:
 	PrivateData(DADataManager* p);
 	QList< DAData > _dataList;
 	QMap< DAData::IdType, DAData > _dataMap;
+	// 标记数据为dirty，记录标记时的修改计数
+	void markDataDirty(DAData::IdType id);
 	bool _dirtyFlag;               ///< 标记是否dirty
+	QHash< DAData::IdType, quint64 > _dirtyDatas;  ///< 记录dirty的数据，value为标记时的修改计数
+	quint64 _modifiedCount { 0 };  ///< 修改计数，每次标记dirty都会增加
 	QUndoStack _dataManagerStack;  ///< 数据管理的stack
 };
 
@@ -29,6 +35,11 @@ DADataManager::PrivateData::PrivateData(DADataManager* p) : q_ptr(p), _dirtyFlag
 {
 }
 
+void DADataManager::PrivateData::markDataDirty(DAData::IdType id)
+{
+	_dirtyDatas[ id ] = ++_modifiedCount;
+}
+
 //===================================================
 // DADataManager
 //===================================================
@@ -61,6 +72,7 @@ void DADataManager::addData(DAData& d)
 	d.setDataManager(this);
 	d_ptr->_dataList.push_back(d);
 	d_ptr->_dataMap[ d.id() ] = d;
+	d_ptr->markDataDirty(d.id());
 	setDirtyFlag(true);
 	Q_EMIT dataAdded(d);
 }
@@ -214,6 +226,76 @@ bool DADataManager::isDirty() const
 void DADataManager::setDirtyFlag(bool on)
 {
     d_ptr->_dirtyFlag = on;
+    if (on) {
+        ++(d_ptr->_modifiedCount);
+    } else {
+        d_ptr->_dirtyDatas.clear();
+    }
+}
+
+/**
+ * @brief 修改计数
+ *
+ * 每次标记dirty都会增加，异步保存开始时记录此计数，保存完成后通过@ref clearDirtyFlagBefore 清除脏标记，
+ * 这样保存过程中发生的修改不会被清除
+ * @return
+ */
+quint64 DADataManager::getModifiedCount() const
+{
+    return d_ptr->_modifiedCount;
+}
+
+/**
+ * @brief 清除修改计数为count及之前的脏标记
+ *
+ * count之后标记为dirty的数据保持dirty，如果count之后有任何修改，整体也保持dirty
+ * @param count 通过@ref getModifiedCount 获取
+ */
+void DADataManager::clearDirtyFlagBefore(quint64 count)
+{
+    if (count >= d_ptr->_modifiedCount) {
+        setDirtyFlag(false);
+        return;
+    }
+    for (auto i = d_ptr->_dirtyDatas.begin(); i != d_ptr->_dirtyDatas.end();) {
+        if (i.value() <= count) {
+            i = d_ptr->_dirtyDatas.erase(i);
+        } else {
+            ++i;
+        }
+    }
+}
+
+/**
+ * @brief 判断某个数据是否dirty
+ *
+ * 数据添加、改名、改描述、内容改变后为true，直到调用setDirtyFlag(false)，工程保存时通过此函数判断数据是否需要重新写入
+ * @param d
+ * @return
+ */
+bool DADataManager::isDataDirty(const DAData& d) const
+{
+    return d_ptr->_dirtyDatas.contains(d.id());
+}
+
+/**
+ * @brief 设置某个数据的脏标记
+ *
+ * 对于直接修改数据内容而不经过DAData接口的操作（例如dataframe的编辑命令），需要调用此函数标记
+ * @param d
+ * @param on
+ */
+void DADataManager::setDataDirtyFlag(const DAData& d, bool on)
+{
+    if (on) {
+        if (d) {
+            d.getPointer()->increaseRevision();
+        }
+        d_ptr->markDataDirty(d.id());
+        setDirtyFlag(true);
+    } else {
+        d_ptr->_dirtyDatas.remove(d.id());
+    }
 }
 
 /**
@@ -232,6 +314,10 @@ QUndoStack* DADataManager::getUndoStack() const
  */
 void DADataManager::callDataChangedSignal(const DAData& d, DADataManager::ChangeType t)
 {
+	d_ptr->markDataDirty(d.id());
+	if (ChangeDataframeColumnName == t && d) {
+		d.getPointer()->increaseRevision();
+	}
 	setDirtyFlag(true);
 	Q_EMIT dataChanged(d, t);
 }
@@ -270,6 +356,7 @@ void DADataManager::doRemoveData(DAData& d)
 	int index = d_ptr->_dataList.indexOf(d);
 	d_ptr->_dataList.removeAt(index);
 	d_ptr->_dataMap.remove(d.id());
+	d_ptr->_dirtyDatas.remove(d.id());
 	d.setDataManager(nullptr);
 	setDirtyFlag(true);
 }
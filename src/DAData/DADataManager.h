@@ -55,8 +55,16 @@ public:
 	DAData getDataById(DAData::IdType id) const;
 	// 判断是否dirty，数据的改变和添加都会把此flag标记为true
 	bool isDirty() const;
-	// 设置脏标记
+	// 设置脏标记，设置为false时会同时清除所有数据的脏标记
 	void setDirtyFlag(bool on);
+	// 修改计数，每次标记dirty都会增加
+	quint64 getModifiedCount() const;
+	// 清除修改计数为count及之前的脏标记，之后的修改保持dirty
+	void clearDirtyFlagBefore(quint64 count);
+	// 判断某个数据是否dirty，数据添加、改名、内容改变后为true，直到调用setDirtyFlag(false)
+	bool isDataDirty(const DAData& d) const;
+	// 设置某个数据的脏标记，设置为true时也会把整体标记为dirty
+	void setDataDirtyFlag(const DAData& d, bool on);
 	// 获取undo stack
 	QUndoStack* getUndoStack() const;
 
@@ -0,0 +1,57 @@
+﻿#include "DAChartDecimatedCurve.h"
+#include "DAChartDecimatedSeriesData.h"
+#include "qwt_plot.h"
+#include "qwt_scale_map.h"
+namespace DA
+{
+DAChartDecimatedCurve::DAChartDecimatedCurve(const QString& title) : QwtPlotCurve(title)
+{
+}
+
+DAChartDecimatedCurve::~DAChartDecimatedCurve()
+{
+}
+
+/**
+ * @brief 设置数据，使用抽稀数据
+ * @param samples
+ */
+void DAChartDecimatedCurve::setDecimatedSamples(const QVector< QPointF >& samples)
+{
+    DAChartDecimatedSeriesData* d = new DAChartDecimatedSeriesData(samples);
+    // 数据归曲线所有，曲线析构时数据也会析构并清空回调，因此这里可以捕获this
+    d->setPyramidReadyCallback([ this ]() {
+        if (QwtPlot* p = plot()) {
+            p->replot();
+        }
+    });
+    setData(d);
+}
+
+/**
+ * @brief 抽稀绘制
+ *
+ * 只对线型曲线进行抽稀，散点、阶梯等样式以及拟合曲线按原始数据绘制
+ */
+void DAChartDecimatedCurve::drawSeries(QPainter* painter,
+                                       const QwtScaleMap& xMap,
+                                       const QwtScaleMap& yMap,
+                                       const QRectF& canvasRect,
+                                       int from,
+                                       int to) const
+{
+    const DAChartDecimatedSeriesData* d = dynamic_cast< const DAChartDecimatedSeriesData* >(data());
+    const bool isFullRange = (0 == from) && (to < 0 || to == static_cast< int >(dataSize()) - 1);
+    if (nullptr == d || !isFullRange || style() != QwtPlotCurve::Lines || testCurveAttribute(QwtPlotCurve::Fitted)) {
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+        return;
+    }
+    int f = 0, t = -1;
+    if (!d->activateLevel(xMap.s1(), xMap.s2(), qAbs(xMap.p2() - xMap.p1()), f, t)) {
+        QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, from, to);
+        return;
+    }
+    QwtPlotCurve::drawSeries(painter, xMap, yMap, canvasRect, f, t);
+    d->deactivateLevel();
+}
+}
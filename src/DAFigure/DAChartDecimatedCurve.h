@@ -0,0 +1,33 @@
+﻿#ifndef DACHARTDECIMATEDCURVE_H
+#define DACHARTDECIMATEDCURVE_H
+#include "DAFigureAPI.h"
+#include "qwt_plot_curve.h"
+namespace DA
+{
+/**
+ * @brief 支持抽稀绘制的曲线
+ *
+ * 数据为@ref DAChartDecimatedSeriesData 且为线型曲线时，按当前可见范围的像素宽度选择金字塔层进行绘制，
+ * 其它情况和QwtPlotCurve完全一致，rtti也保持为Rtti_PlotCurve
+ *
+ * 一般不直接使用此类，而是通过@ref DAChartPlotItemFactory::createCurve 创建
+ */
+class DAFIGURE_API DAChartDecimatedCurve : public QwtPlotCurve
+{
+public:
+    explicit DAChartDecimatedCurve(const QString& title = QString());
+    ~DAChartDecimatedCurve();
+    // 设置数据，使用抽稀数据，金字塔建立完成后会自动重绘
+    void setDecimatedSamples(const QVector< QPointF >& samples);
+
+protected:
+    virtual void drawSeries(QPainter* painter,
+                            const QwtScaleMap& xMap,
+                            const QwtScaleMap& yMap,
+                            const QRectF& canvasRect,
+                            int from,
+                            int to) const override;
+};
+}
+
+#endif  // DACHARTDECIMATEDCURVE_H
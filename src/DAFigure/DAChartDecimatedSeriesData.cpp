@@ -0,0 +1,292 @@
+﻿#include "DAChartDecimatedSeriesData.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QtConcurrent>
+namespace DA
+{
+/**
+ * @brief 第1层每个桶包含的原始点数
+ */
+static const int c_decimatedFirstBucketSize = 16;
+/**
+ * @brief 每层合并的桶数
+ */
+static const int c_decimatedLevelFactor = 4;
+/**
+ * @brief 当某层的桶数少于此值时不再建立更粗的层
+ */
+static const int c_decimatedMinBucketCount = 512;
+
+/**
+ * @brief 金字塔数据，在后台线程和DAChartDecimatedSeriesData之间共享
+ */
+class _DAChartDecimatedPyramid
+{
+public:
+    std::atomic_bool ready { false };        ///< 金字塔建立完成
+    std::atomic_bool cancel { false };       ///< 取消建立
+    QVector< QVector< QPointF > > levels;    ///< 各层数据，每个桶2个点，levels[0]为第1层
+    QVector< int > bucketSizes;              ///< 各层一个桶对应的原始点数
+    std::function< void() > onReady;         ///< 建立完成的回调，只在主线程访问
+};
+
+/**
+ * @brief 把in按group个点一组，每组取y最小和y最大的两个点（保持原始顺序），结果追加到out
+ *
+ * 每组固定输出两个点，使第k个桶对应out的第2k和2k+1个点
+ */
+static void decimateMinMax(const QPointF* in, int count, int group, QVector< QPointF >& out)
+{
+    out.reserve((count + group - 1) / group * 2);
+    for (int begin = 0; begin < count; begin += group) {
+        const int end = std::min(begin + group, count);
+        int imin      = -1;
+        int imax      = -1;
+        for (int i = begin; i < end; ++i) {
+            const double y = in[ i ].y();
+            if (std::isnan(y)) {
+                continue;
+            }
+            if (imin < 0 || y < in[ imin ].y()) {
+                imin = i;
+            }
+            if (imax < 0 || y > in[ imax ].y()) {
+                imax = i;
+            }
+        }
+        if (imin < 0) {
+            // 整组都是nan
+            imin = imax = begin;
+        }
+        if (imin <= imax) {
+            out.append(in[ imin ]);
+            out.append(in[ imax ]);
+        } else {
+            out.append(in[ imax ]);
+            out.append(in[ imin ]);
+        }
+    }
+}
+
+/**
+ * @brief 建立金字塔，在后台线程执行
+ */
+static void buildDecimatedPyramid(_DAChartDecimatedPyramid& p, const QVector< QPointF >& raw)
+{
+    const int n = raw.size();
+    // x必须有序，否则无法通过二分查找定位可见范围
+    for (int i = 1; i < n; ++i) {
+        if (!(raw[ i ].x() >= raw[ i - 1 ].x())) {
+            return;
+        }
+        if ((i & 0xFFFF) == 0 && p.cancel) {
+            return;
+        }
+    }
+    QVector< QVector< QPointF > > levels;
+    QVector< int > bucketSizes;
+    QVector< QPointF > lv;
+    decimateMinMax(raw.constData(), n, c_decimatedFirstBucketSize, lv);
+    int bucketSize = c_decimatedFirstBucketSize;
+    while (!p.cancel) {
+        const int bucketCount = lv.size() / 2;
+        levels.append(lv);
+        bucketSizes.append(bucketSize);
+        if (bucketCount < c_decimatedMinBucketCount * c_decimatedLevelFactor) {
+            break;
+        }
+        QVector< QPointF > next;
+        decimateMinMax(lv.constData(), lv.size(), 2 * c_decimatedLevelFactor, next);
+        lv = std::move(next);
+        bucketSize *= c_decimatedLevelFactor;
+    }
+    if (p.cancel) {
+        return;
+    }
+    p.levels      = std::move(levels);
+    p.bucketSizes = std::move(bucketSizes);
+}
+
+//===================================================
+// DAChartDecimatedSeriesData::PrivateData
+//===================================================
+class DAChartDecimatedSeriesData::PrivateData
+{
+    DA_DECLARE_PUBLIC(DAChartDecimatedSeriesData)
+public:
+    PrivateData(DAChartDecimatedSeriesData* p);
+    // 开始在后台建立金字塔
+    void startBuild();
+
+public:
+    QVector< QPointF > mRaw;
+    std::shared_ptr< _DAChartDecimatedPyramid > mPyramid;
+    int mActiveLevel { -1 };  ///< 当前激活的层，-1代表原始数据
+};
+
+DAChartDecimatedSeriesData::PrivateData::PrivateData(DAChartDecimatedSeriesData* p) : q_ptr(p)
+{
+    mPyramid = std::make_shared< _DAChartDecimatedPyramid >();
+}
+
+void DAChartDecimatedSeriesData::PrivateData::startBuild()
+{
+    std::shared_ptr< _DAChartDecimatedPyramid > pyramid = mPyramid;
+    QVector< QPointF > raw                               = mRaw;  // 隐式共享，不会复制数据
+    QtConcurrent::run([ pyramid, raw ]() {
+        buildDecimatedPyramid(*pyramid, raw);
+        if (pyramid->cancel || pyramid->levels.isEmpty()) {
+            return;
+        }
+        pyramid->ready = true;
+        QCoreApplication* app = QCoreApplication::instance();
+        if (!app) {
+            return;
+        }
+        // 回到主线程通知，如果数据已经析构，weak_ptr会失效或回调已被清空
+        std::weak_ptr< _DAChartDecimatedPyramid > wp = pyramid;
+        QMetaObject::invokeMethod(
+            app,
+            [ wp ]() {
+                if (auto sp = wp.lock()) {
+                    if (sp->onReady) {
+                        sp->onReady();
+                    }
+                }
+            },
+            Qt::QueuedConnection);
+    });
+}
+
+//===================================================
+// DAChartDecimatedSeriesData
+//===================================================
+DAChartDecimatedSeriesData::DAChartDecimatedSeriesData(const QVector< QPointF >& samples) : DA_PIMPL_CONSTRUCT
+{
+    d_ptr->mRaw = samples;
+    if (samples.size() > c_decimatedFirstBucketSize * c_decimatedMinBucketCount) {
+        d_ptr->startBuild();
+    }
+}
+
+DAChartDecimatedSeriesData::~DAChartDecimatedSeriesData()
+{
+    d_ptr->mPyramid->cancel = true;
+    d_ptr->mPyramid->onReady = nullptr;
+}
+
+size_t DAChartDecimatedSeriesData::size() const
+{
+    if (d_ptr->mActiveLevel >= 0) {
+        return static_cast< size_t >(d_ptr->mPyramid->levels[ d_ptr->mActiveLevel ].size());
+    }
+    return static_cast< size_t >(d_ptr->mRaw.size());
+}
+
+QPointF DAChartDecimatedSeriesData::sample(size_t i) const
+{
+    if (d_ptr->mActiveLevel >= 0) {
+        return d_ptr->mPyramid->levels[ d_ptr->mActiveLevel ][ static_cast< int >(i) ];
+    }
+    return d_ptr->mRaw[ static_cast< int >(i) ];
+}
+
+/**
+ * @brief 原始数据的范围
+ * @return
+ */
+QRectF DAChartDecimatedSeriesData::boundingRect() const
+{
+    if (cachedBoundingRect.width() < 0.0) {
+        const int oldLevel  = d_ptr->mActiveLevel;
+        d_ptr->mActiveLevel = -1;
+        cachedBoundingRect  = qwtBoundingRect(*this);
+        d_ptr->mActiveLevel = oldLevel;
+    }
+    return cachedBoundingRect;
+}
+
+const QVector< QPointF >& DAChartDecimatedSeriesData::rawSamples() const
+{
+    return d_ptr->mRaw;
+}
+
+bool DAChartDecimatedSeriesData::isPyramidReady() const
+{
+    return d_ptr->mPyramid->ready;
+}
+
+int DAChartDecimatedSeriesData::levelCount() const
+{
+    return isPyramidReady() ? d_ptr->mPyramid->levels.size() : 0;
+}
+
+/**
+ * @brief 根据可见的x范围和像素宽度激活合适的层
+ *
+ * 选择桶数不少于像素宽度的最粗层，因此每个像素最多绘制8个点。
+ * 如果可见范围内的原始点数本身就不多，不激活层，from/to为原始数据的可见范围
+ *
+ * @param x1 可见范围
+ * @param x2 可见范围
+ * @param pixelWidth 可见范围对应的像素宽度
+ * @param from 激活后的数据中需要绘制的起始索引
+ * @param to 激活后的数据中需要绘制的结束索引（包含）
+ * @return 金字塔未建立完成时返回false，此时应该按原始数据绘制
+ * @note 绘制完成后要调用@ref deactivateLevel 恢复
+ */
+bool DAChartDecimatedSeriesData::activateLevel(double x1, double x2, double pixelWidth, int& from, int& to) const
+{
+    d_ptr->mActiveLevel = -1;
+    if (!isPyramidReady()) {
+        return false;
+    }
+    if (x1 > x2) {
+        std::swap(x1, x2);
+    }
+    const QVector< QPointF >& raw = d_ptr->mRaw;
+    auto lessX                    = [](const QPointF& p, double x) { return p.x() < x; };
+    auto greaterX                 = [](double x, const QPointF& p) { return x < p.x(); };
+    // 可见范围两侧各多取一个点，保证线条能连接到画布边缘
+    int i1 = static_cast< int >(std::lower_bound(raw.cbegin(), raw.cend(), x1, lessX) - raw.cbegin()) - 1;
+    int i2 = static_cast< int >(std::upper_bound(raw.cbegin(), raw.cend(), x2, greaterX) - raw.cbegin());
+    i1     = std::max(i1, 0);
+    i2     = std::min(i2, raw.size() - 1);
+    if (i2 < i1) {
+        i2 = i1;
+    }
+    const double pointsPerPixel = (i2 - i1 + 1) / std::max(pixelWidth, 1.0);
+    const QVector< int >& bs    = d_ptr->mPyramid->bucketSizes;
+    int level                   = -1;
+    for (int l = 0; l < bs.size(); ++l) {
+        if (bs[ l ] <= pointsPerPixel) {
+            level = l;
+        }
+    }
+    if (level < 0) {
+        from = i1;
+        to   = i2;
+        return true;
+    }
+    const int bucketSize = bs[ level ];
+    const int lvSize     = d_ptr->mPyramid->levels[ level ].size();
+    from                 = 2 * (i1 / bucketSize);
+    to                   = std::min(2 * (i2 / bucketSize) + 1, lvSize - 1);
+    d_ptr->mActiveLevel  = level;
+    return true;
+}
+
+void DAChartDecimatedSeriesData::deactivateLevel() const
+{
+    d_ptr->mActiveLevel = -1;
+}
+
+void DAChartDecimatedSeriesData::setPyramidReadyCallback(const std::function< void() >& fn)
+{
+    d_ptr->mPyramid->onReady = fn;
+}
+}
@@ -0,0 +1,49 @@
+﻿#ifndef DACHARTDECIMATEDSERIESDATA_H
+#define DACHARTDECIMATEDSERIESDATA_H
+#include "DAFigureAPI.h"
+#include <functional>
+#include <QVector>
+#include <QPointF>
+#include "qwt_series_data.h"
+namespace DA
+{
+/**
+ * @brief 带多分辨率min/max抽稀金字塔的曲线数据
+ *
+ * 数据按x有序时，会在后台线程建立抽稀金字塔：第1层每16个点为一个桶，之后每层把4个桶合并为1个，
+ * 每个桶只保留y最小和y最大的两个点（按原始顺序），因此峰值不会丢失。
+ *
+ * 绘制时由@ref DAChartDecimatedCurve 根据可见的x范围和像素宽度激活合适的层，
+ * 绘制的点数和像素宽度成正比，而不是和原始点数成正比。
+ *
+ * 没有激活层时，此类和QwtPointSeriesData表现一致，size和sample返回原始数据，
+ * 因此数据拾取、序列化等功能不受影响
+ *
+ * @note x无序（或含nan）的数据不会建立金字塔，绘制时使用原始数据
+ */
+class DAFIGURE_API DAChartDecimatedSeriesData : public QwtSeriesData< QPointF >
+{
+    DA_DECLARE_PRIVATE(DAChartDecimatedSeriesData)
+public:
+    DAChartDecimatedSeriesData(const QVector< QPointF >& samples);
+    ~DAChartDecimatedSeriesData();
+    // QwtSeriesData接口
+    virtual size_t size() const override;
+    virtual QPointF sample(size_t i) const override;
+    virtual QRectF boundingRect() const override;
+    // 原始数据
+    const QVector< QPointF >& rawSamples() const;
+    // 金字塔是否已经建立完成
+    bool isPyramidReady() const;
+    // 金字塔层数，0代表没有金字塔
+    int levelCount() const;
+    // 根据可见的x范围和像素宽度激活合适的层，from/to返回激活层中需要绘制的范围
+    bool activateLevel(double x1, double x2, double pixelWidth, int& from, int& to) const;
+    // 恢复为原始数据
+    void deactivateLevel() const;
+    // 金字塔建立完成后的回调，回调在主线程执行
+    void setPyramidReadyCallback(const std::function< void() >& fn);
+};
+}
+
+#endif  // DACHARTDECIMATEDSERIESDATA_H
@@ -18,8 +18,14 @@
 #include "qwt_plot_textlabel.h"
 #include "qwt_plot_zoneitem.h"
 #include "qwt_plot_vectorfield.h"
+#include "DAChartDecimatedCurve.h"
 namespace DA
 {
+/**
+ * @brief 曲线抽稀的点数阈值
+ */
+static int s_curveDecimationThreshold = 100000;
+
 /**
  * @brief qwt的默认plotitem注册到工厂
  * @return
@@ -27,7 +33,7 @@ namespace DA
 static QHash< int, DAChartPlotItemFactory::FpItemCreate > initDAChartPlotItemFactory()
 {
     QHash< int, DAChartPlotItemFactory::FpItemCreate > res;
-    res[ QwtPlotItem::Rtti_PlotCurve ]         = []() -> QwtPlotItem* { return new QwtPlotCurve(); };
+    res[ QwtPlotItem::Rtti_PlotCurve ]         = []() -> QwtPlotItem* { return new DAChartDecimatedCurve(); };
     res[ QwtPlotItem::Rtti_PlotGrid ]          = []() -> QwtPlotItem* { return new QwtPlotGrid(); };
     res[ QwtPlotItem::Rtti_PlotScale ]         = []() -> QwtPlotItem* { return new QwtPlotScaleItem(); };
     res[ QwtPlotItem::Rtti_PlotLegend ]        = []() -> QwtPlotItem* { return new QwtPlotLegendItem(); };
@@ -70,6 +76,33 @@ bool DAChartPlotItemFactory::isHaveCreateItemFucntion(int rtti)
     return factoryFunctionMap().contains(rtti);
 }
 
+QwtPlotCurve* DAChartPlotItemFactory::createCurve(const QVector< QPointF >& xy)
+{
+    QwtPlotCurve* curve = new DAChartDecimatedCurve();
+    setCurveSamples(curve, xy);
+    return curve;
+}
+
+void DAChartPlotItemFactory::setCurveSamples(QwtPlotCurve* curve, const QVector< QPointF >& xy)
+{
+    DAChartDecimatedCurve* dc = dynamic_cast< DAChartDecimatedCurve* >(curve);
+    if (dc && s_curveDecimationThreshold > 0 && xy.size() > s_curveDecimationThreshold) {
+        dc->setDecimatedSamples(xy);
+    } else {
+        curve->setSamples(xy);
+    }
+}
+
+void DAChartPlotItemFactory::setCurveDecimationThreshold(int count)
+{
+    s_curveDecimationThreshold = count;
+}
+
+int DAChartPlotItemFactory::getCurveDecimationThreshold()
+{
+    return s_curveDecimationThreshold;
+}
+
 /**
  * @brief 工程函数map
  * @return
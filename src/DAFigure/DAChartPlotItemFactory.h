@@ -1,15 +1,22 @@
 #ifndef DACHARTPLOTITEMFACTORY_H
 #define DACHARTPLOTITEMFACTORY_H
+#include "DAFigureAPI.h"
 #include <functional>
 #include <unordered_map>
+#include <QVector>
+#include <QPointF>
 #include "qwt_plot_item.h"
+class QwtPlotCurve;
 namespace DA
 {
 
 /**
  * @brief  针对QwtPlotItem的工厂类
+ *
+ * 曲线（Rtti_PlotCurve）默认创建为@ref DAChartDecimatedCurve ，
+ * 通过@ref setCurveSamples 设置数据时，点数超过@ref getCurveDecimationThreshold 会自动使用抽稀绘制
  */
-class DAChartPlotItemFactory
+class DAFIGURE_API DAChartPlotItemFactory
 {
 public:
     using FpItemCreate = std::function< QwtPlotItem*() >;  ///< 函数指针：QwtPlotItem* itemCreate(int rtti);
@@ -37,6 +44,27 @@ public:
      */
     static bool isHaveCreateItemFucntion(int rtti);
 
+    /**
+     * @brief 创建曲线并设置数据，点数超过抽稀阈值时使用抽稀绘制
+     * @param xy
+     * @return
+     */
+    static QwtPlotCurve* createCurve(const QVector< QPointF >& xy);
+
+    /**
+     * @brief 设置曲线数据，如果曲线为DAChartDecimatedCurve且点数超过抽稀阈值，使用抽稀数据，否则等同setSamples
+     * @param curve
+     * @param xy
+     */
+    static void setCurveSamples(QwtPlotCurve* curve, const QVector< QPointF >& xy);
+
+    /**
+     * @brief 设置曲线抽稀的点数阈值，小于等于0代表不抽稀
+     * @param count
+     */
+    static void setCurveDecimationThreshold(int count);
+    static int getCurveDecimationThreshold();
+
 private:
     static QHash< int, DAChartPlotItemFactory::FpItemCreate >& factoryFunctionMap();
 };
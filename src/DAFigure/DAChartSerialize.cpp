@@ -613,7 +613,7 @@ QDataStream& operator>>(QDataStream& in, QwtPlotCurve* item)
 		throw DA::DABadSerializeExpection();
 		return in;
 	}
-	item->setSamples(sample);
+	DAChartPlotItemFactory::setCurveSamples(item, sample);
 	// QwtSymbol的序列化
 	bool isHaveSymbol;
 	in >> isHaveSymbol;
@@ -26,6 +26,7 @@
 #include "DAChartCanvas.h"
 
 #include "DAChartUtil.h"
+#include "DAChartPlotItemFactory.h"
 #include "DAFigureWidget.h"
 // unsigned int ChartWave_qwt::staticValue_nAutoLineID = 0;//静态变量初始化
 namespace DA
@@ -574,13 +575,11 @@ QwtPlotCurve* DAChartWidget::addCurve(const double* xData, const double* yData,
 	if (size <= 0) {
 		return (nullptr);
 	}
-	QwtPlotCurve* ser = new QwtPlotCurve();
-	ser->setYAxis(yLeft);
-	ser->setXAxis(xBottom);
-	ser->setStyle(QwtPlotCurve::Lines);
-	ser->setSamples(xData, yData, size);
-	ser->attach(this);
-	return (ser);
+	QVector< QPointF > xy(size);
+	for (int i = 0; i < size; ++i) {
+		xy[ i ] = QPointF(xData[ i ], yData[ i ]);
+	}
+	return addCurve(xy);
 }
 
 /**
@@ -590,11 +589,11 @@ QwtPlotCurve* DAChartWidget::addCurve(const double* xData, const double* yData,
  */
 QwtPlotCurve* DAChartWidget::addCurve(const QVector< QPointF >& xyDatas)
 {
-	QwtPlotCurve* series = new QwtPlotCurve();
+	// 点数超过阈值时工厂会创建抽稀绘制的曲线
+	QwtPlotCurve* series = DAChartPlotItemFactory::createCurve(xyDatas);
 	series->setYAxis(yLeft);
 	series->setXAxis(xBottom);
 	series->setStyle(QwtPlotCurve::Lines);
-	series->setSamples(xyDatas);
 	series->attach(this);
 	return (series);
 }
@@ -607,13 +606,12 @@ QwtPlotCurve* DAChartWidget::addCurve(const QVector< QPointF >& xyDatas)
  */
 QwtPlotCurve* DAChartWidget::addCurve(const QVector< double >& xData, const QVector< double >& yData)
 {
-	QwtPlotCurve* series = new QwtPlotCurve();
-	series->setYAxis(yLeft);
-	series->setXAxis(xBottom);
-	series->setStyle(QwtPlotCurve::Lines);
-	series->setSamples(xData, yData);
-	series->attach(this);
-	return (series);
+	const int size = qMin(xData.size(), yData.size());
+	QVector< QPointF > xy(size);
+	for (int i = 0; i < size; ++i) {
+		xy[ i ] = QPointF(xData[ i ], yData[ i ]);
+	}
+	return addCurve(xy);
 }
 
 /**
@@ -41,6 +41,10 @@ DAGraphicsItem::DAGraphicsItem(QGraphicsItem* parent) : QGraphicsObject(parent),
 
 DAGraphicsItem::~DAGraphicsItem()
 {
+	// QGraphicsItem析构时不会再调用itemChange，因此要在这里注销场景的id索引
+	if (DAGraphicsScene* sc = daScene()) {
+		sc->unregistItemID(this, d_ptr->mID);
+	}
 }
 /**
  * @brief 保存到xml中
@@ -305,7 +309,11 @@ uint64_t DAGraphicsItem::getItemID() const
 
 void DAGraphicsItem::setItemID(uint64_t id)
 {
-    d_ptr->mID = id;
+	if (DAGraphicsScene* sc = daScene()) {
+		sc->unregistItemID(this, d_ptr->mID);
+		sc->registItemID(this, id);
+	}
+	d_ptr->mID = id;
 }
 
 /**
@@ -388,6 +396,17 @@ QVariant DAGraphicsItem::itemChange(GraphicsItemChange change, const QVariant& v
 			return opacity();
 		}
 	} break;
+	case QGraphicsItem::ItemSceneChange: {
+		// 移出原场景，注销id索引
+		if (DAGraphicsScene* sc = daScene()) {
+			sc->unregistItemID(this, d_ptr->mID);
+		}
+	} break;
+	case QGraphicsItem::ItemSceneHasChanged: {
+		if (DAGraphicsScene* sc = daScene()) {
+			sc->registItemID(this, d_ptr->mID);
+		}
+	} break;
 	default:
 		break;
 	}
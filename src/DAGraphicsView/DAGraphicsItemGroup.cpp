@@ -52,6 +52,9 @@ DAGraphicsItemGroup::DAGraphicsItemGroup(QGraphicsItem* parent) : QGraphicsItemG
 
 DAGraphicsItemGroup::~DAGraphicsItemGroup()
 {
+	if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+		sc->unregistItemID(this, d_ptr->mID);
+	}
 }
 /**
  * @brief 保存到xml中
@@ -159,6 +162,10 @@ uint64_t DAGraphicsItemGroup::getItemID() const
 
 void DAGraphicsItemGroup::setItemID(uint64_t id)
 {
+    if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+        sc->unregistItemID(this, d_ptr->mID);
+        sc->registItemID(this, id);
+    }
     d_ptr->mID = id;
 }
 
@@ -214,7 +221,17 @@ QVariant DAGraphicsItemGroup::itemChange(QGraphicsItem::GraphicsItemChange chang
 				di->groupPositionChanged(p);
 			}
 		}
-	}
+	} break;
+	case QGraphicsItem::ItemSceneChange: {
+		if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+			sc->unregistItemID(this, d_ptr->mID);
+		}
+	} break;
+	case QGraphicsItem::ItemSceneHasChanged: {
+		if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+			sc->registItemID(this, d_ptr->mID);
+		}
+	} break;
 	default:
 		break;
 	}
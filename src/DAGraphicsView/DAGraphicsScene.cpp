@@ -13,6 +13,7 @@
 #include <QDebug>
 #include <QApplication>
 #include <QScreen>
+#include <QHash>
 #include "DAGraphicsCommandsFactory.h"
 namespace DA
 {
@@ -70,6 +71,10 @@ public:
 	std::unique_ptr< DAAbstractGraphicsSceneAction > mSceneAction;
 	bool mIsReadOnlyMode { false };  ///< 是否为只读状态
 	std::unique_ptr< DAGraphicsCommandsFactory > commandsFactory;
+	QHash< uint64_t, QGraphicsItem* > mIDToItem;  ///< id索引，由带id的item在加入/移出场景时维护
+	int mBulkLoadDepth { 0 };                     ///< 批量加载的嵌套层数
+	QGraphicsScene::ItemIndexMethod mBulkLoadIndexMethod { QGraphicsScene::BspTreeIndex };  ///< 批量加载前的索引方式
+	QList< QPair< bool, QList< QGraphicsItem* > > > mBulkLoadSignals;  ///< 批量加载期间延迟的信号，first为true代表添加
 };
 
 ////////////////////////////////////////////////
@@ -246,7 +251,7 @@ QUndoCommand* DAGraphicsScene::addItem_(QGraphicsItem* item)
 {
 	DACommandsForGraphicsItemAdd* cmd = commandsFactory()->createItemAdd(item);
 	push(cmd);
-	emit itemsAdded({ item });
+	emitItemsAdded({ item });
 	return cmd;
 }
 
@@ -259,7 +264,7 @@ QUndoCommand* DAGraphicsScene::addItems_(const QList< QGraphicsItem* >& its)
 {
 	DACommandsForGraphicsItemsAdd* cmd = commandsFactory()->createItemsAdd(its);
 	push(cmd);
-	emit itemsAdded(its);
+	emitItemsAdded(its);
 	return cmd;
 }
 
@@ -273,7 +278,7 @@ QUndoCommand* DAGraphicsScene::removeItem_(QGraphicsItem* item)
 {
 	DACommandsForGraphicsItemRemove* cmd = commandsFactory()->createItemRemove(item);
 	push(cmd);
-	emit itemsRemoved({ item });
+	emitItemsRemoved({ item });
 	return cmd;
 }
 
@@ -281,7 +286,7 @@ QUndoCommand* DAGraphicsScene::removeItems_(const QList< QGraphicsItem* >& its)
 {
 	DACommandsForGraphicsItemsRemove* cmd = commandsFactory()->createItemsRemove(its);
 	push(cmd);
-	emit itemsRemoved(its);
+	emitItemsRemoved(its);
 	return cmd;
 }
 
@@ -697,15 +702,41 @@ void DAGraphicsScene::push(QUndoCommand* cmd)
 }
 
 /**
-   @brief 通过id查找item,此函数性能为O(n)
+   @brief 通过id查找item
+
+   场景维护了id到item的索引（包含子item），因此此函数性能为O(1)，
+   索引由@sa DAGraphicsItem，@sa DAGraphicsItemGroup，@sa DAGraphicsStandardTextItem 在加入/移出场景以及id改变时维护
    @param id
-   @param recursion 递归查找
-   @return
+   @param recursion 为兼容保留，索引本身包含了所有层级的item
+   @return 没有找到返回nullptr
  */
 QGraphicsItem* DAGraphicsScene::findItemByID(uint64_t id, bool recursion) const
 {
-	QList< QGraphicsItem* > allItems = items();
-	return findItemByID(allItems, id, recursion);
+	Q_UNUSED(recursion);
+	return d_ptr->mIDToItem.value(id, nullptr);
+}
+
+/**
+   @brief 登记item的id索引
+   @param item
+   @param id
+ */
+void DAGraphicsScene::registItemID(QGraphicsItem* item, uint64_t id)
+{
+	d_ptr->mIDToItem.insert(id, item);
+}
+
+/**
+   @brief 注销item的id索引，只有索引中记录的是此item时才会注销
+   @param item
+   @param id
+ */
+void DAGraphicsScene::unregistItemID(QGraphicsItem* item, uint64_t id)
+{
+	auto i = d_ptr->mIDToItem.find(id);
+	if (i != d_ptr->mIDToItem.end() && i.value() == item) {
+		d_ptr->mIDToItem.erase(i);
+	}
 }
 
 /**
@@ -805,6 +836,58 @@ bool DAGraphicsScene::isReady() const
     return d_ptr->mIsReady;
 }
 
+/**
+ * @brief 开始批量加载
+ *
+ * 批量加载期间场景不维护bsp索引，itemsAdded/itemsRemoved信号会被合并，
+ * 在@ref endBulkLoad 时统一重建索引并发射信号，适用于工程加载、粘贴等大量添加item的场景
+ *
+ * @note beginBulkLoad和endBulkLoad必须成对调用，可以嵌套
+ */
+void DAGraphicsScene::beginBulkLoad()
+{
+	if (0 == d_ptr->mBulkLoadDepth++) {
+		d_ptr->mBulkLoadIndexMethod = itemIndexMethod();
+		if (d_ptr->mBulkLoadIndexMethod != QGraphicsScene::NoIndex) {
+			setItemIndexMethod(QGraphicsScene::NoIndex);
+		}
+	}
+}
+
+/**
+ * @brief 结束批量加载，恢复场景索引并按顺序发射批量加载期间的信号
+ */
+void DAGraphicsScene::endBulkLoad()
+{
+	if (d_ptr->mBulkLoadDepth <= 0) {
+		return;
+	}
+	if (0 != --d_ptr->mBulkLoadDepth) {
+		return;
+	}
+	if (d_ptr->mBulkLoadIndexMethod != QGraphicsScene::NoIndex) {
+		setItemIndexMethod(d_ptr->mBulkLoadIndexMethod);
+	}
+	const auto pending = std::move(d_ptr->mBulkLoadSignals);
+	d_ptr->mBulkLoadSignals.clear();
+	for (const auto& s : pending) {
+		if (s.first) {
+			emit itemsAdded(s.second);
+		} else {
+			emit itemsRemoved(s.second);
+		}
+	}
+}
+
+/**
+ * @brief 是否处于批量加载模式
+ * @return
+ */
+bool DAGraphicsScene::isBulkLoading() const
+{
+	return d_ptr->mBulkLoadDepth > 0;
+}
+
 /**
  * @brief 获取默认的dpi
  * @return
@@ -1075,7 +1158,41 @@ void DAGraphicsScene::emitItemRotationChanged(DAGraphicsResizeableItem* item, co
 void DAGraphicsScene::addItemWithSignal(QGraphicsItem* item)
 {
 	addItem(item);
-	emit itemsAdded({ item });
+	emitItemsAdded({ item });
+}
+
+/**
+ * @brief 发射itemsAdded信号，批量加载模式下，信号会延迟到@ref endBulkLoad 发射，连续的添加会合并为一次信号
+ * @param its
+ */
+void DAGraphicsScene::emitItemsAdded(const QList< QGraphicsItem* >& its)
+{
+	if (d_ptr->mBulkLoadDepth > 0) {
+		if (!d_ptr->mBulkLoadSignals.isEmpty() && d_ptr->mBulkLoadSignals.last().first) {
+			d_ptr->mBulkLoadSignals.last().second.append(its);
+		} else {
+			d_ptr->mBulkLoadSignals.append(qMakePair(true, its));
+		}
+		return;
+	}
+	emit itemsAdded(its);
+}
+
+/**
+ * @brief 发射itemsRemoved信号，批量加载模式下，信号会延迟到@ref endBulkLoad 发射，连续的移除会合并为一次信号
+ * @param its
+ */
+void DAGraphicsScene::emitItemsRemoved(const QList< QGraphicsItem* >& its)
+{
+	if (d_ptr->mBulkLoadDepth > 0) {
+		if (!d_ptr->mBulkLoadSignals.isEmpty() && !d_ptr->mBulkLoadSignals.last().first) {
+			d_ptr->mBulkLoadSignals.last().second.append(its);
+		} else {
+			d_ptr->mBulkLoadSignals.append(qMakePair(false, its));
+		}
+		return;
+	}
+	emit itemsRemoved(its);
 }
 
 void DAGraphicsScene::mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent)
@@ -106,9 +106,12 @@ public:
 	void setUndoStackActive();
 	void push(QUndoCommand* cmd);
 
-	// 通过id查找item,此函数性能为O(n)
+	// 通过id查找item,场景维护了id索引，此函数性能为O(1)
 	QGraphicsItem* findItemByID(uint64_t id, bool recursion = false) const;
 	static QGraphicsItem* findItemByID(const QList< QGraphicsItem* >& its, uint64_t id, bool recursion = false);
+	// 登记/注销item的id索引，此函数由带id的item在加入/移出场景以及id改变时调用，一般无需手动调用
+	void registItemID(QGraphicsItem* item, uint64_t id);
+	void unregistItemID(QGraphicsItem* item, uint64_t id);
 
 	// 返回所有顶层的item
 	QList< QGraphicsItem* > topItems() const;
@@ -118,6 +121,10 @@ public:
 	// 设置场景就绪，如果场景还没加载完成，ready为false，一般这个函数在工程加载的时候应用
 	void setReady(bool on);
 	bool isReady() const;
+	// 批量加载模式，批量加载期间itemsAdded/itemsRemoved信号会被合并，场景索引在结束时统一重建，可嵌套调用
+	void beginBulkLoad();
+	void endBulkLoad();
+	bool isBulkLoading() const;
 
 	// 是否当前存在场景动作
 	bool isHaveSceneAction() const;
@@ -253,6 +260,9 @@ protected:
 	void emitItemRotationChanged(DAGraphicsResizeableItem* item, const qreal& rotation);
 	// 带信号的addItm
 	void addItemWithSignal(QGraphicsItem* item);
+	// 发射itemsAdded/itemsRemoved信号，批量加载模式下会延迟到endBulkLoad再发射
+	void emitItemsAdded(const QList< QGraphicsItem* >& its);
+	void emitItemsRemoved(const QList< QGraphicsItem* >& its);
 
 protected:
 	// 鼠标点击事件
@@ -37,6 +37,9 @@ DAGraphicsStandardTextItem::DAGraphicsStandardTextItem(const QFont& f, QGraphics
 
 DAGraphicsStandardTextItem::~DAGraphicsStandardTextItem()
 {
+	if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+		sc->unregistItemID(this, mID);
+	}
 }
 
 void DAGraphicsStandardTextItem::initItem()
@@ -160,6 +163,10 @@ uint64_t DAGraphicsStandardTextItem::getItemID() const
 
 void DAGraphicsStandardTextItem::setItemID(uint64_t id)
 {
+	if (DAGraphicsScene* sc = qobject_cast< DAGraphicsScene* >(scene())) {
+		sc->unregistItemID(this, mID);
+		sc->registItemID(this, id);
+	}
 	mID = id;
 }
 
@@ -396,6 +403,16 @@ void DAGraphicsStandardTextItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent*
 
 QVariant DAGraphicsStandardTextItem::itemChange(QGraphicsItem::GraphicsItemChange change, const QVariant& value)
 {
+	// 维护场景的id索引
+	if (change == QGraphicsItem::ItemSceneChange) {
+		if (DAGraphicsScene* oldScene = qobject_cast< DAGraphicsScene* >(scene())) {
+			oldScene->unregistItemID(this, mID);
+		}
+	} else if (change == QGraphicsItem::ItemSceneHasChanged) {
+		if (DAGraphicsScene* newScene = qobject_cast< DAGraphicsScene* >(scene())) {
+			newScene->registItemID(this, mID);
+		}
+	}
 	if (change == QGraphicsItem::ItemSceneChange) {
 		if (QGraphicsScene* newScene = value.value< QGraphicsScene* >()) {
 			if (DAGraphicsScene* daScene = qobject_cast< DAGraphicsScene* >(newScene)) {
@@ -7,6 +7,10 @@
 namespace DA
 {
 
+// 默认内存快照预算为256MB
+std::atomic< qint64 > DACommandWithTemporaryData::s_memoryBudget { qint64(256) * 1024 * 1024 };
+std::atomic< qint64 > DACommandWithTemporaryData::s_memoryUsage { 0 };
+
 //===================================================
 // DACommandWithTemplateData
 //===================================================
@@ -20,7 +24,7 @@ DACommandWithTemporaryData::DACommandWithTemporaryData(const DAPyDataFrame& df,
 
 DACommandWithTemporaryData::~DACommandWithTemporaryData()
 {
-    QFile::remove(getTemplateFilePath());
+	releaseSnapshot();
 }
 
 /**
@@ -52,23 +56,272 @@ QString DACommandWithTemporaryData::getTemplateFilePath() const
 }
 
 /**
- * @brief 把dataframe保存到临时文件中
+ * @brief 保存整个dataframe
+ *
+ * 内存预算足够时在内存中保存一份深拷贝，否则保存到临时文件中，
+ * 预算在拷贝之前预留，多个线程同时保存时不会超出预算
  * @return
  */
 bool DACommandWithTemporaryData::save()
 {
+	releaseSnapshot();
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	const qint64 bytes       = py.memory_usage(mDataframe);
+	if (bytes >= 0 && reserveMemory(bytes)) {
+		DAPyDataFrame snapshot = py.copy(mDataframe);
+		if (!snapshot.isNone()) {
+			mSnapshot      = snapshot;
+			mSnapshotBytes = bytes;
+			mSnapshotType  = SnapshotFrame;
+			return true;
+		}
+		s_memoryUsage -= bytes;
+	}
+	// 超出预算，直接把原始dataframe写入临时文件，避免多一次拷贝
+	if (!py.to_pickle(mDataframe, getTemplateFilePath())) {
+		return false;
+	}
+	mSnapshotInFile = true;
+	mSnapshotType   = SnapshotFrame;
+	return true;
+}
+
+/**
+ * @brief 只保存内容会被改变的列
+ *
+ * 适用于astype这类只改变列内容，不改变行列数量的操作，
+ * eval这类会在最后追加新列的操作需要传入操作前的列数
+ * @param cols 列索引
+ * @param columnCount 操作前的列数，小于0表示操作不改变列数
+ * @return
+ */
+bool DACommandWithTemporaryData::saveChangedColumns(const QList< int >& cols, int columnCount)
+{
+	releaseSnapshot();
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	if (!storeSnapshot(py.snapshot_columns(mDataframe, cols), SnapshotChangedColumns, cols)) {
+		return false;
+	}
+	mSnapshotColumnCount = columnCount;
+	return true;
+}
+
+/**
+ * @brief 只保存含有缺失值的列
+ *
+ * 适用于fillna/interpolate这类只填充缺失值的操作，没有缺失值的列不会被改变
+ * @return
+ */
+bool DACommandWithTemporaryData::saveNanColumns()
+{
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	QList< int > cols;
+	if (py.nan_columns(mDataframe, cols) && saveChangedColumns(cols)) {
+		return true;
+	}
+	return save();
+}
+
+/**
+ * @brief 只保存将被删除的列
+ * @param cols 删除前的列索引
+ * @return
+ */
+bool DACommandWithTemporaryData::saveDroppedColumns(const QList< int >& cols)
+{
+	releaseSnapshot();
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	return storeSnapshot(py.snapshot_columns(mDataframe, cols), SnapshotDroppedColumns, cols);
+}
+
+/**
+ * @brief 只保存将被删除的行
+ *
+ * 行是按标签删除的，如果index存在重复值，将退化为保存整个dataframe
+ * @param rows 删除前的行索引
+ * @return
+ */
+bool DACommandWithTemporaryData::saveDroppedRows(const QList< int >& rows)
+{
+	releaseSnapshot();
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	DAPyDataFrame snapshot   = py.snapshot_rows(mDataframe, rows);
+	if (snapshot.isNone()) {
+		return save();
+	}
+	return storeSnapshot(snapshot, SnapshotDroppedRows, rows);
+}
+
+/**
+ * @brief 只保存逐行过滤操作将删除的行
+ *
+ * 适用于dropna、query这类按条件删除行的操作，被删除的行由python端按操作的参数计算
+ * @param op 去掉da_前缀的函数名
+ * @param args 操作的参数，和@ref DAPyScriptsDataFrame 中对应函数传入python的参数一致
+ * @return
+ */
+bool DACommandWithTemporaryData::saveFilteredRows(const QString& op, const QVariantMap& args)
+{
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	QList< int > rows;
+	if (py.dropped_rows(mDataframe, op, args, rows)) {
+		return saveDroppedRows(rows);
+	}
+	return save();
+}
+
+/**
+ * @brief 只保存排序的排列
+ *
+ * 排序不改变行的内容，撤销时按排列恢复原来的顺序
+ * @param by 排序依据
+ * @param ascending 排序方式
+ * @return
+ */
+bool DACommandWithTemporaryData::saveSortPermutation(const QString& by, bool ascending)
+{
+	releaseSnapshot();
 	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
-	return py.to_pickle(mDataframe, getTemplateFilePath());
+	if (storeSnapshot(py.sort_permutation(mDataframe, by, ascending), SnapshotPermutation, QList< int >())) {
+		return true;
+	}
+	return save();
 }
 
 /**
- * @brief 从文件加载回来
+ * @brief 从快照恢复
  * @return
  */
 bool DACommandWithTemporaryData::load()
 {
 	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
-	return py.from_pickle(mDataframe, getTemplateFilePath());
+	if (mSnapshotType == SnapshotFrame) {
+		if (mSnapshotInFile) {
+			return py.from_pickle(mDataframe, getTemplateFilePath());
+		}
+		return py.restore(mDataframe, mSnapshot);
+	}
+	DAPyDataFrame snapshot = fetchSnapshot();
+	if (snapshot.isNone()) {
+		return false;
+	}
+	switch (mSnapshotType) {
+	case SnapshotChangedColumns:
+		return py.restore_columns(mDataframe, mSnapshotIndex, snapshot, mSnapshotColumnCount);
+	case SnapshotDroppedColumns:
+		return py.restore_dropped_columns(mDataframe, mSnapshotIndex, snapshot);
+	case SnapshotDroppedRows:
+		return py.restore_dropped_rows(mDataframe, mSnapshotIndex, snapshot);
+	case SnapshotPermutation:
+		return py.restore_permutation(mDataframe, snapshot);
+	default:
+		break;
+	}
+	return false;
+}
+
+/**
+ * @brief 快照类型
+ * @return
+ */
+DACommandWithTemporaryData::SnapshotType DACommandWithTemporaryData::getSnapshotType() const
+{
+	return mSnapshotType;
+}
+
+/**
+ * @brief 快照是否在内存中
+ * @return
+ */
+bool DACommandWithTemporaryData::isSnapshotInMemory() const
+{
+	return (mSnapshotType != SnapshotNone) && !mSnapshotInFile;
+}
+
+/**
+ * @brief 快照占用的内存（字节），快照写入临时文件时为0
+ * @return
+ */
+qint64 DACommandWithTemporaryData::getSnapshotBytes() const
+{
+	return mSnapshotBytes;
+}
+
+/**
+ * @brief 保存快照，内存预算足够时放在内存，否则写入临时文件
+ * @param snapshot
+ * @param type
+ * @param index
+ * @return
+ */
+bool DACommandWithTemporaryData::storeSnapshot(const DAPyDataFrame& snapshot, SnapshotType type, const QList< int >& index)
+{
+	if (snapshot.isNone()) {
+		return false;
+	}
+	DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+	const qint64 bytes       = py.memory_usage(snapshot);
+	if (bytes >= 0 && reserveMemory(bytes)) {
+		mSnapshot      = snapshot;
+		mSnapshotBytes = bytes;
+	} else {
+		if (!py.to_pickle(snapshot, getTemplateFilePath())) {
+			return false;
+		}
+		mSnapshotInFile = true;
+	}
+	mSnapshotType  = type;
+	mSnapshotIndex = index;
+	return true;
+}
+
+/**
+ * @brief 预留内存预算
+ *
+ * 检查和增加在一次原子操作中完成，避免多个线程同时通过检查后超出预算
+ * @param bytes 字节数
+ * @return 超出预算返回false，不预留
+ */
+bool DACommandWithTemporaryData::reserveMemory(qint64 bytes)
+{
+	const qint64 budget = s_memoryBudget;
+	qint64 used         = s_memoryUsage.load();
+	do {
+		if (used + bytes > budget) {
+			return false;
+		}
+	} while (!s_memoryUsage.compare_exchange_weak(used, used + bytes));
+	return true;
+}
+
+/**
+ * @brief 获取快照，快照在临时文件中时会读取文件
+ * @return
+ */
+DAPyDataFrame DACommandWithTemporaryData::fetchSnapshot() const
+{
+	if (mSnapshotInFile) {
+		DAPyScriptsDataFrame& py = DAPyScripts::getInstance().getDataFrame();
+		return py.read_pickle(getTemplateFilePath());
+	}
+	return mSnapshot;
+}
+
+/**
+ * @brief 释放快照，归还内存预算并删除临时文件
+ */
+void DACommandWithTemporaryData::releaseSnapshot()
+{
+	s_memoryUsage -= mSnapshotBytes;
+	mSnapshotBytes = 0;
+	mSnapshot      = DAPyDataFrame();
+	if (mSnapshotInFile) {
+		QFile::remove(getTemplateFilePath());
+		mSnapshotInFile = false;
+	}
+	mSnapshotType = SnapshotNone;
+	mSnapshotIndex.clear();
+	mSnapshotColumnCount = -1;
 }
 
 DAPyDataFrame& DACommandWithTemporaryData::dataframe()
@@ -87,4 +340,46 @@ QString DACommandWithTemporaryData::getDataframeTempPath()
 	return s_temp_dataframe;
 }
 
+/**
+ * @brief 设置内存快照的总预算
+ *
+ * 只影响之后保存的快照，已经保存的快照不会迁移
+ * @param bytes 字节数，小于等于0时所有快照都写入临时文件
+ */
+void DACommandWithTemporaryData::setMemoryBudget(qint64 bytes)
+{
+	s_memoryBudget = bytes;
+}
+
+/**
+ * @brief 内存快照的总预算
+ * @return
+ */
+qint64 DACommandWithTemporaryData::getMemoryBudget()
+{
+	return s_memoryBudget;
+}
+
+/**
+ * @brief 当前所有命令的内存快照占用的总字节数
+ * @return
+ */
+qint64 DACommandWithTemporaryData::getMemoryUsage()
+{
+	return s_memoryUsage;
+}
+
+/**
+ * @brief 把命令对应的操作追加到构建器，用于在其它dataframe上重复执行
+ *
+ * 只有参数不依赖于当前dataframe内容（例如选中的行）的操作才支持，默认不支持
+ * @param pipeline
+ * @return 不支持返回false，pipeline不变
+ */
+bool DACommandWithTemporaryData::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	Q_UNUSED(pipeline);
+	return false;
+}
+
 }
@@ -1,17 +1,44 @@
 ﻿#ifndef DACOMMANDWITHTEMPORARYDATA_H
 #define DACOMMANDWITHTEMPORARYDATA_H
+#include <atomic>
 #include <QDir>
 #include "DAGuiAPI.h"
 #include "DACommandWithRedoCount.h"
 #include "DAData.h"
+#include "DAPyDataFramePipeline.h"
 namespace DA
 {
 /**
  * @brief 此命令实现了临时文件接口，需要保存临时文件的继承此类
+ *
+ * 撤销数据并不总是保存整个dataframe：
+ * - 只改变部分列内容的操作，通过@ref saveChangedColumns 仅保存这些列，填充缺失值的操作通过@ref saveNanColumns 仅保存含缺失值的列
+ * - 删除行/列的操作，通过@ref saveDroppedRows /@ref saveDroppedColumns 仅保存被删除的行/列，
+ *   逐行过滤的操作通过@ref saveFilteredRows 先计算将被删除的行
+ * - 排序操作通过@ref saveSortPermutation 仅保存行的排列
+ * - 其余操作通过@ref save 保存整个dataframe
+ *
+ * 保存的快照优先放在内存中，所有命令的内存快照总量受@ref setMemoryBudget 限制，
+ * 超出预算的快照会写入临时目录的pickle文件，命令可能在后台线程中构造，预算先预留再拷贝
+ *
  * TODO:这个类的名字需要修改为DACommandDataframeWithTemplateData
  */
 class DAGUI_API DACommandWithTemporaryData : public DACommandWithRedoCount
 {
+public:
+	/**
+	 * @brief 快照类型
+	 */
+	enum SnapshotType
+	{
+		SnapshotNone,            ///< 没有快照
+		SnapshotFrame,           ///< 整个dataframe
+		SnapshotChangedColumns,  ///< 内容被改变的列
+		SnapshotDroppedColumns,  ///< 被删除的列
+		SnapshotDroppedRows,     ///< 被删除的行
+		SnapshotPermutation      ///< 排序前行的排列
+	};
+
 public:
 	/**
 	 * @brief 构造函数执行会自动把原始的dataframe保存到临时目录中
@@ -28,10 +55,30 @@ public:
 	QDir templateDir() const;
 	// 获取临时文件的完整l路径
 	QString getTemplateFilePath() const;
-	// 保存
+	// 保存整个dataframe
 	bool save();
-	// 从文件加载回来
+	// 只保存内容会被改变的列，列的位置不能改变，columnCount>=0时恢复会删除追加在后面的列
+	bool saveChangedColumns(const QList< int >& cols, int columnCount = -1);
+	// 只保存含有缺失值的列，用于填充缺失值的操作，无法获取时会保存整个dataframe
+	bool saveNanColumns();
+	// 只保存将被删除的列
+	bool saveDroppedColumns(const QList< int >& cols);
+	// 只保存将被删除的行，无法按行保存时会保存整个dataframe
+	bool saveDroppedRows(const QList< int >& rows);
+	// 只保存逐行过滤操作将删除的行，op为去掉da_前缀的函数名，无法确定时会保存整个dataframe
+	bool saveFilteredRows(const QString& op, const QVariantMap& args);
+	// 只保存排序的排列，无法获取时会保存整个dataframe
+	bool saveSortPermutation(const QString& by, bool ascending);
+	// 从快照恢复
 	bool load();
+	// 快照类型
+	SnapshotType getSnapshotType() const;
+	// 快照是否在内存中
+	bool isSnapshotInMemory() const;
+	// 快照占用的内存（字节）
+	qint64 getSnapshotBytes() const;
+	// 把命令对应的操作追加到构建器，用于在其它dataframe上重复执行
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const;
 	// 存放dataframe
 	DAPyDataFrame& dataframe();
 	const DAPyDataFrame& dataframe() const;
@@ -40,12 +87,32 @@ public:
 	 * @return
 	 */
 	static QString getDataframeTempPath();
+	// 内存快照的总预算（字节），小于等于0时所有快照都写入临时文件
+	static void setMemoryBudget(qint64 bytes);
+	static qint64 getMemoryBudget();
+	// 当前内存快照占用的总字节数
+	static qint64 getMemoryUsage();
 
 protected:
 	DAPyDataFrame mDataframe;
 
 private:
+	bool storeSnapshot(const DAPyDataFrame& snapshot, SnapshotType type, const QList< int >& index);
+	// 预留内存预算，超出预算返回false
+	static bool reserveMemory(qint64 bytes);
+	DAPyDataFrame fetchSnapshot() const;
+	void releaseSnapshot();
+
+private:
+	SnapshotType mSnapshotType { SnapshotNone };
+	QList< int > mSnapshotIndex;    ///< 快照对应的行/列索引
+	int mSnapshotColumnCount { -1 };  ///< 保存改变的列时操作前的列数
+	DAPyDataFrame mSnapshot;        ///< 内存中的快照
+	qint64 mSnapshotBytes { 0 };    ///< 内存快照占用的字节数
+	bool mSnapshotInFile { false };  ///< 快照是否写入了临时文件
 	static QString s_temp_dataframe;
+	static std::atomic< qint64 > s_memoryBudget;
+	static std::atomic< qint64 > s_memoryUsage;
 };
 }  // end of namespace DA
 #endif  // DACOMMANDWITHTEMPLATEDATA_H
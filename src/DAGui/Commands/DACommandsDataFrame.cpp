@@ -10,6 +10,21 @@
 namespace DA
 {
 
+/**
+ * @brief 列索引转换为QVariantList，用于传给DACommandWithTemporaryData::saveFilteredRows
+ * @param index
+ * @return
+ */
+static QVariantList indexToVariantList(const QList< int >& index)
+{
+	QVariantList res;
+	res.reserve(index.size());
+	for (int i : index) {
+		res.append(i);
+	}
+	return res;
+}
+
 //===================================================
 // DACommandDataFrame_iat
 //===================================================
@@ -174,9 +189,11 @@ DACommandDataFrame_dropIRow::DACommandDataFrame_dropIRow(const DAPyDataFrame& df
                                                          const QList< int >& index,
                                                          DAPyDataFrameTableModel* model,
                                                          QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mIndex(index), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mIndex(index), mModel(model)
 {
 	setText(QObject::tr("drop dataframe rows"));  // cn:移除dataframe行
+	// 只保存被删除的行
+	saveDroppedRows(mIndex);
 }
 
 void DACommandDataFrame_dropIRow::undo()
@@ -205,9 +222,11 @@ DACommandDataFrame_dropIColumn::DACommandDataFrame_dropIColumn(const DAPyDataFra
                                                                const QList< int >& index,
                                                                DAPyDataFrameTableModel* model,
                                                                QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mIndex(index), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mIndex(index), mModel(model)
 {
 	setText(QObject::tr("drop dataframe columns"));  // cn:移除dataframe列
+	// 只保存被删除的列
+	saveDroppedColumns(mIndex);
 }
 
 void DACommandDataFrame_dropIColumn::undo()
@@ -276,9 +295,11 @@ DACommandDataFrame_astype::DACommandDataFrame_astype(const DAPyDataFrame& df,
                                                      const DAPyDType& dt,
                                                      DAPyDataFrameTableModel* model,
                                                      QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mIndex(index), mDtype(dt), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mIndex(index), mDtype(dt), mModel(model)
 {
 	setText(QObject::tr("change column type"));  // cn:改变列数据类型
+	// 只保存被改变的列
+	saveChangedColumns(mIndex);
 }
 
 void DACommandDataFrame_astype::undo()
@@ -353,9 +374,22 @@ DACommandDataFrame_dropna::DACommandDataFrame_dropna(const DAPyDataFrame& df,
                                                      const QList< int >& index,
                                                      std::optional< int > thresh,
                                                      QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mAxis(axis), mHow(how), mIndex(index), mThresh(thresh)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mAxis(axis), mHow(how), mIndex(index), mThresh(thresh)
 {
     setText(QObject::tr("drop nan"));  // cn:改变列数据为数值
+    // 删除行时只保存被删除的行，参数和DAPyScriptsDataFrame::dropna一致，index总是列表
+    if (axis != 0) {
+        save();
+        return;
+    }
+    QVariantMap args;
+    args[ "axis" ]  = axis;
+    args[ "how" ]   = how;
+    args[ "index" ] = indexToVariantList(index);
+    if (thresh) {
+        args[ "thresh" ] = thresh.value();
+    }
+    saveFilteredRows(QStringLiteral("drop_na"), args);
 }
 
 void DACommandDataFrame_dropna::undo()
@@ -388,6 +422,12 @@ bool DACommandDataFrame_dropna::exec()
 	return true;
 }
 
+bool DACommandDataFrame_dropna::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.dropna(mAxis, mHow, mIndex, mThresh);
+	return true;
+}
+
 int DACommandDataFrame_dropna::getDropedCount() const
 {
 	return mDropedCount;
@@ -400,9 +440,10 @@ DACommandDataFrame_fillna::DACommandDataFrame_fillna(const DAPyDataFrame& df,
                                                      double value,
                                                      int limit,
                                                      QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mValue(value), mLimit(limit)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mValue(value), mLimit(limit)
 {
     setText(QObject::tr("fill nan"));  // cn:填充缺失值
+    saveNanColumns();
 }
 
 void DACommandDataFrame_fillna::undo()
@@ -428,6 +469,12 @@ bool DACommandDataFrame_fillna::exec()
 	return true;
 }
 
+bool DACommandDataFrame_fillna::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.fillna(mValue, mLimit);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_interpolate::DACommandDataFrame_interpolate(const DAPyDataFrame& df,
@@ -436,9 +483,10 @@ DACommandDataFrame_interpolate::DACommandDataFrame_interpolate(const DAPyDataFra
                                                                int order,
                                                                int limit,
                                                                QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mMethod(method), mOrder(order), mLimit(limit)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mMethod(method), mOrder(order), mLimit(limit)
 {
     setText(QObject::tr("interpolate"));  // cn:插值填充缺失值
+    saveNanColumns();
 }
 
 void DACommandDataFrame_interpolate::undo()
@@ -464,6 +512,12 @@ bool DACommandDataFrame_interpolate::exec()
 	return true;
 }
 
+bool DACommandDataFrame_interpolate::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.interpolate(mMethod, mOrder, mLimit);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_ffillna::DACommandDataFrame_ffillna(const DAPyDataFrame& df,
@@ -471,9 +525,10 @@ DACommandDataFrame_ffillna::DACommandDataFrame_ffillna(const DAPyDataFrame& df,
                                                        int axis,
                                                        int limit,
                                                        QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mAxis(axis), mLimit(limit)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mAxis(axis), mLimit(limit)
 {
     setText(QObject::tr("ffill nan"));  // cn:前向填充缺失值
+    saveNanColumns();
 }
 
 void DACommandDataFrame_ffillna::undo()
@@ -499,6 +554,12 @@ bool DACommandDataFrame_ffillna::exec()
 	return true;
 }
 
+bool DACommandDataFrame_ffillna::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.ffillna(mAxis, mLimit);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_bfillna::DACommandDataFrame_bfillna(const DAPyDataFrame& df,
@@ -506,9 +567,10 @@ DACommandDataFrame_bfillna::DACommandDataFrame_bfillna(const DAPyDataFrame& df,
                                                        int axis,
                                                        int limit,
                                                        QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mAxis(axis), mLimit(limit)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mAxis(axis), mLimit(limit)
 {
     setText(QObject::tr("bfill nan"));  // cn:后向填充缺失值
+    saveNanColumns();
 }
 
 void DACommandDataFrame_bfillna::undo()
@@ -534,6 +596,12 @@ bool DACommandDataFrame_bfillna::exec()
 	return true;
 }
 
+bool DACommandDataFrame_bfillna::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.bfillna(mAxis, mLimit);
+	return true;
+}
+
 ///////////////////
 /// \brief DACommandDataFrame_dropduplicates::DACommandDataFrame_dropduplicates
 /// \param df
@@ -550,9 +618,16 @@ DACommandDataFrame_dropduplicates::DACommandDataFrame_dropduplicates(const DAPyD
                                                                      const QString& keep,
                                                                      const QList< int >& index,
                                                                      QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mKeep(keep), mIndex(index)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mKeep(keep), mIndex(index)
 {
     setText(QObject::tr("drop duplicates"));  // cn:删除重复值
+    // 参数和DAPyScriptsDataFrame::dropduplicates一致，index为空时为None
+    QVariantMap args;
+    args[ "keep" ] = keep;
+    if (!index.isEmpty()) {
+        args[ "index" ] = indexToVariantList(index);
+    }
+    saveFilteredRows(QStringLiteral("drop_duplicates"), args);
 }
 
 void DACommandDataFrame_dropduplicates::undo()
@@ -585,6 +660,12 @@ bool DACommandDataFrame_dropduplicates::exec()
 	return true;
 }
 
+bool DACommandDataFrame_dropduplicates::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.dropduplicates(mKeep, mIndex);
+	return true;
+}
+
 int DACommandDataFrame_dropduplicates::getDropedCount() const
 {
 	return mDropedCount;
@@ -598,9 +679,17 @@ DACommandDataFrame_nstdfilteroutlier::DACommandDataFrame_nstdfilteroutlier(const
                                                                            int axis,
                                                                            const QList< int >& index,
                                                                            QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mN(n), mAxis(axis), mIndex(index)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mN(n), mAxis(axis), mIndex(index)
 {
     setText(QObject::tr("nstd filter"));  // cn:填充缺失值
+    // 参数和DAPyScriptsDataFrame::nstdfilteroutlier一致，index为空时为None
+    QVariantMap args;
+    args[ "n" ]    = n;
+    args[ "axis" ] = axis;
+    if (!index.isEmpty()) {
+        args[ "index" ] = indexToVariantList(index);
+    }
+    saveFilteredRows(QStringLiteral("nstd_filter_outlier"), args);
 }
 
 void DACommandDataFrame_nstdfilteroutlier::undo()
@@ -633,6 +722,12 @@ bool DACommandDataFrame_nstdfilteroutlier::exec()
 	return true;
 }
 
+bool DACommandDataFrame_nstdfilteroutlier::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.nstdfilteroutlier(mN, mAxis, mIndex);
+	return true;
+}
+
 int DACommandDataFrame_nstdfilteroutlier::getDropedCount() const
 {
 	return mDropedCount;
@@ -646,9 +741,15 @@ DACommandDataFrame_clipoutlier::DACommandDataFrame_clipoutlier(const DAPyDataFra
                                                                double uppervalue,
                                                                int axis,
                                                                QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mlowervalue(lowervalue), mUppervalue(uppervalue), mAxis(axis)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mlowervalue(lowervalue), mUppervalue(uppervalue), mAxis(axis)
 {
     setText(QObject::tr("clip outlier"));  // cn:替换异常值
+    // 只有存在越界值的数值列会被改变
+    QList< int > cols;
+    DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+    if (!pydf.clip_columns(df, lowervalue, uppervalue, cols) || !saveChangedColumns(cols)) {
+        save();
+    }
 }
 
 void DACommandDataFrame_clipoutlier::undo()
@@ -672,6 +773,12 @@ bool DACommandDataFrame_clipoutlier::exec()
 	return true;
 }
 
+bool DACommandDataFrame_clipoutlier::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.clipoutlier(mlowervalue, mUppervalue, mAxis);
+	return true;
+}
+
 //----------------------------------------------------
 //
 //----------------------------------------------------
@@ -679,9 +786,16 @@ DACommandDataFrame_evalDatas::DACommandDataFrame_evalDatas(const DAPyDataFrame&
                                                            const QString& exper,
                                                            DAPyDataFrameTableModel* model,
                                                            QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mExper(exper), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mExper(exper), mModel(model)
 {
     setText(QObject::tr("eval datas"));  // cn:列运算
+    // 只保存被赋值的已有列，新增的列撤销时删除
+    QList< int > cols;
+    int columnCount            = -1;
+    DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+    if (!pydf.eval_columns(df, exper, cols, columnCount) || !saveChangedColumns(cols, columnCount)) {
+        save();
+    }
 }
 
 void DACommandDataFrame_evalDatas::undo()
@@ -704,6 +818,12 @@ bool DACommandDataFrame_evalDatas::exec()
 	}
 	return true;
 }
+
+bool DACommandDataFrame_evalDatas::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.evalDatas(mExper);
+	return true;
+}
 //----------------------------------------------------
 //
 //----------------------------------------------------
@@ -713,9 +833,12 @@ DACommandDataFrame_querydatas::DACommandDataFrame_querydatas(const DAPyDataFrame
                                                              const QString& exper,
                                                              DAPyDataFrameTableModel* model,
                                                              QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mExper(exper), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mExper(exper), mModel(model)
 {
     setText(QObject::tr("query datas"));  // cn:条件查询
+    QVariantMap args;
+    args[ "expr" ] = exper;
+    saveFilteredRows(QStringLiteral("query_datas"), args);
 }
 
 void DACommandDataFrame_querydatas::undo()
@@ -739,6 +862,12 @@ bool DACommandDataFrame_querydatas::exec()
 	return true;
 }
 
+bool DACommandDataFrame_querydatas::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.queryDatas(mExper);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_filterByColumn::DACommandDataFrame_filterByColumn(const DAPyDataFrame& df,
@@ -747,9 +876,19 @@ DACommandDataFrame_filterByColumn::DACommandDataFrame_filterByColumn(const DAPyD
                                                                      const QString& index,
                                                                      DAPyDataFrameTableModel* model,
                                                                      QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mModel(model), mlowervalue(lowervalue), mUppervalue(uppervalue), mIndex(index)
+    : DACommandWithTemporaryData(df, par, false), mModel(model), mlowervalue(lowervalue), mUppervalue(uppervalue), mIndex(index)
 {
     setText(QObject::tr("data select"));  // cn:数据过滤
+    // 参数和DAPyScriptsDataFrame::dataselect一致，上下界为0时不限制
+    QVariantMap args;
+    args[ "index" ] = index;
+    if (lowervalue != 0.0) {
+        args[ "lower" ] = lowervalue;
+    }
+    if (uppervalue != 0.0) {
+        args[ "upper" ] = uppervalue;
+    }
+    saveFilteredRows(QStringLiteral("data_select"), args);
 }
 
 void DACommandDataFrame_filterByColumn::undo()
@@ -770,6 +909,12 @@ bool DACommandDataFrame_filterByColumn::exec()
 	return true;
 }
 
+bool DACommandDataFrame_filterByColumn::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.dataselect(mlowervalue, mUppervalue, mIndex);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_sort::DACommandDataFrame_sort(const DAPyDataFrame& df,
@@ -777,9 +922,10 @@ DACommandDataFrame_sort::DACommandDataFrame_sort(const DAPyDataFrame& df,
                                                  const bool ascending,
                                                  DAPyDataFrameTableModel* model,
                                                  QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mBy(by), mAscending(ascending), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mBy(by), mAscending(ascending), mModel(model)
 {
     setText(QObject::tr("sort datas"));  // cn:对相关数据进行排序
+    saveSortPermutation(by, ascending);
 }
 
 void DACommandDataFrame_sort::undo()
@@ -800,6 +946,12 @@ bool DACommandDataFrame_sort::exec()
 	return true;
 }
 
+bool DACommandDataFrame_sort::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.sort(mBy, mAscending);
+	return true;
+}
+
 ///////////////////
 
 DACommandDataFrame_castNum::DACommandDataFrame_castNum(const DAPyDataFrame& df,
@@ -807,9 +959,10 @@ DACommandDataFrame_castNum::DACommandDataFrame_castNum(const DAPyDataFrame& df,
                                                        const pybind11::dict& args,
                                                        DAPyDataFrameTableModel* model,
                                                        QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mIndex(index), mArgs(args), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mIndex(index), mArgs(args), mModel(model)
 {
 	setText(QObject::tr("cast column to num"));  // cn:改变列数据为数值
+	saveChangedColumns(mIndex);
 }
 
 void DACommandDataFrame_castNum::undo()
@@ -843,9 +996,10 @@ DACommandDataFrame_castDatetime::DACommandDataFrame_castDatetime(const DAPyDataF
                                                                  const pybind11::dict& args,
                                                                  DAPyDataFrameTableModel* model,
                                                                  QUndoCommand* par)
-    : DACommandWithTemporaryData(df, par), mIndex(index), mArgs(args), mModel(model)
+    : DACommandWithTemporaryData(df, par, false), mIndex(index), mArgs(args), mModel(model)
 {
 	setText(QObject::tr("cast column to datetime"));  // cn:改变列数据为日期
+	saveChangedColumns(mIndex);
 }
 
 void DACommandDataFrame_castDatetime::undo()
@@ -905,4 +1059,84 @@ bool DACommandDataFrame_setIndex::exec()
 	return true;
 }
 
+////////////////////////
+
+DACommandDataFrame_pipeline::DACommandDataFrame_pipeline(const DAPyDataFrame& df,
+                                                         const DAPyDataFramePipeline& pipeline,
+                                                         DAPyDataFrameTableModel* model,
+                                                         QUndoCommand* par)
+    : DACommandWithTemporaryData(df, par), mPipeline(pipeline), mModel(model)
+{
+	setText(QObject::tr("batch operate(%1 steps)").arg(pipeline.size()));  // cn:批量操作(%1步)
+}
+
+void DACommandDataFrame_pipeline::undo()
+{
+	load();
+	if (mModel) {
+		mModel->refreshData();
+	}
+}
+
+bool DACommandDataFrame_pipeline::exec()
+{
+	if (!mPipeline.apply(dataframe())) {
+		// 执行了部分操作，恢复到执行前
+		load();
+		if (mModel) {
+			mModel->refreshData();
+		}
+		return false;
+	}
+	if (mModel) {
+		mModel->refreshData();
+	}
+	return true;
+}
+
+bool DACommandDataFrame_pipeline::appendToPipeline(DAPyDataFramePipeline& pipeline) const
+{
+	pipeline.append(mPipeline);
+	return true;
+}
+
+///////////////////
+
+/**
+ * @brief 构造
+ * @param cmd 已经执行过exec的命令，所有权转移给此命令
+ * @param model
+ * @param par
+ */
+DACommandDataFrame_async::DACommandDataFrame_async(DACommandWithRedoCount* cmd, DAPyDataFrameTableModel* model, QUndoCommand* par)
+    : QUndoCommand(par), mCommand(cmd), mModel(model)
+{
+	setText(cmd->text());
+}
+
+DACommandDataFrame_async::~DACommandDataFrame_async()
+{
+}
+
+void DACommandDataFrame_async::redo()
+{
+	mCommand->redo();
+	if (mModel) {
+		mModel->refreshData();
+	}
+}
+
+void DACommandDataFrame_async::undo()
+{
+	mCommand->undo();
+	if (mModel) {
+		mModel->refreshData();
+	}
+}
+
+DACommandWithRedoCount* DACommandDataFrame_async::command() const
+{
+	return mCommand.get();
+}
+
 }  // end DA
@@ -2,6 +2,7 @@
 #define DACOMMANDSDATAFRAME_H
 #include <QUndoCommand>
 #include <QPoint>
+#include <memory>
 #include <optional>
 #include "DAGuiAPI.h"
 #include "DACommandWithRedoCount.h"
@@ -9,6 +10,7 @@
 #include "DAData.h"
 #include "numpy/DAPyDType.h"
 #include "pandas/DAPySeries.h"
+#include "DAPyDataFramePipeline.h"
 class QHeaderView;
 
 namespace DA
@@ -242,6 +244,7 @@ public:
 							  QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 	int getDropedCount() const;
 
@@ -267,6 +270,7 @@ public:
 							  QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -288,6 +292,7 @@ public:
 								   QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -309,6 +314,7 @@ public:
 							   QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -329,6 +335,7 @@ public:
 							   QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -349,6 +356,7 @@ public:
 									  QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 	int getDropedCount() const;
 
@@ -373,6 +381,7 @@ public:
 										 QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 	int getDropedCount() const;
 
 private:
@@ -397,6 +406,7 @@ public:
 								   QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -418,6 +428,7 @@ public:
 								 QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	QString mExper;
@@ -436,6 +447,7 @@ public:
 								  QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	QString mExper;
@@ -457,6 +469,7 @@ public:
 									  QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	DAPyDataFrameTableModel* mModel { nullptr };
@@ -478,6 +491,7 @@ public:
 							QUndoCommand* par              = nullptr);
 	virtual void undo() override;
 	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
 
 private:
 	QString mBy;
@@ -543,5 +557,45 @@ private:
 	QList< int > mIndex;
 	DAPyDataFrameTableModel* mModel;
 };
+
+/**
+ * @brief 一次执行多个操作，只保存一次临时数据，undo一次回退所有操作
+ */
+class DAGUI_API DACommandDataFrame_pipeline : public DACommandWithTemporaryData
+{
+public:
+	DACommandDataFrame_pipeline(const DAPyDataFrame& df,
+								const DAPyDataFramePipeline& pipeline,
+								DAPyDataFrameTableModel* model = nullptr,
+								QUndoCommand* par              = nullptr);
+	virtual void undo() override;
+	virtual bool exec() override;
+	virtual bool appendToPipeline(DAPyDataFramePipeline& pipeline) const override;
+
+private:
+	DAPyDataFramePipeline mPipeline;
+	DAPyDataFrameTableModel* mModel;
+};
+
+/**
+ * @brief 包装在python工作线程中已经执行完成的命令
+ *
+ * 工作线程中不能访问表格模型，被包装的命令以model=nullptr构造并已经调用过exec，
+ * 推入undo栈时由此命令在redo/undo之后刷新模型（被包装命令的第一次redo会跳过）
+ */
+class DAGUI_API DACommandDataFrame_async : public QUndoCommand
+{
+public:
+	DACommandDataFrame_async(DACommandWithRedoCount* cmd, DAPyDataFrameTableModel* model = nullptr, QUndoCommand* par = nullptr);
+	~DACommandDataFrame_async();
+	virtual void redo() override;
+	virtual void undo() override;
+	// 被包装的命令
+	DACommandWithRedoCount* command() const;
+
+private:
+	std::unique_ptr< DACommandWithRedoCount > mCommand;
+	DAPyDataFrameTableModel* mModel;
+};
 }  // end of namespace DA
 #endif  // DACOMMANDSDATAFRAME_H
@@ -4,6 +4,7 @@
 #include <QFileInfo>
 #include <QDir>
 #include <QFile>
+#include <QDateTime>
 #include <QDebug>
 namespace DA
 {
@@ -121,17 +122,32 @@ bool DAAbstractArchive::replaceFile(const QString& file, const QString& beReplac
 	}
 
 	//! 将 beReplaceFile 重命名为 file,如果beReplaceFile已经存在，QFile::copy(file, beReplaceFile)这个函数会返回false，
-	//! 因此，beReplaceFile如果存在，先要删除beReplaceFile
+	//! 因此，beReplaceFile如果存在，先把beReplaceFile改名移开，替换成功后再删除
+	//! beReplaceFile可能正被内存映射（工程中的数据直接映射工程文件），windows下这种文件无法删除但可以改名，
+	//! 此时改名后的文件留到下次调用removeReplacedFiles时再删除
+	QString oldFile;
 	if (QFile::exists(beReplaceFile)) {
-		if (!QFile::remove(beReplaceFile)) {
-			qDebug() << QString("Failed to remove %1 file").arg(beReplaceFile);
+		oldFile = QString("%1.~old-%2").arg(beReplaceFile).arg(QDateTime::currentMSecsSinceEpoch());
+		if (!QFile::rename(beReplaceFile, oldFile)) {
+			qDebug() << QString("Failed to move %1 file").arg(beReplaceFile);
 			return false;
 		}
 	}
-	if (!QFile::copy(file, beReplaceFile)) {
+	//! 临时文件和目标文件在同一个目录下，优先直接重命名，避免大文件的整体复制
+	if (!QFile::rename(file, beReplaceFile) && !QFile::copy(file, beReplaceFile)) {
 		qDebug() << "Failed to copy replacement file to target location:" << file << "->" << beReplaceFile;
+		// 恢复原文件
+		if (!oldFile.isEmpty()) {
+			QFile::rename(oldFile, beReplaceFile);
+		}
 		return false;
 	}
+	if (!oldFile.isEmpty() && !QFile::remove(oldFile)) {
+		qDebug() << "The replaced file is still in use and will be removed later:" << oldFile;
+	}
+	if (!QFile::exists(file)) {
+		return true;
+	}
 	// 删除目标文件（file）
 	if (!QFile::remove(file)) {
 		qDebug() << "Failed to remove the original file:" << file;
@@ -141,4 +157,23 @@ bool DAAbstractArchive::replaceFile(const QString& file, const QString& beReplac
 	return true;
 }
 
+/**
+ * @brief 删除replaceFile时因被占用而没能删除的旧文件
+ * @param filePath 被替换的文件路径
+ */
+void DAAbstractArchive::removeReplacedFiles(const QString& filePath)
+{
+	if (filePath.isEmpty()) {
+		return;
+	}
+	QFileInfo fileInfo(filePath);
+	QDir dir                   = fileInfo.absoluteDir();
+	const QStringList oldFiles = dir.entryList({ QString("%1.~old-*").arg(fileInfo.fileName()) }, QDir::Files | QDir::Hidden);
+	for (const QString& f : oldFiles) {
+		if (!QFile::remove(dir.filePath(f))) {
+			qDebug() << "Failed to remove the replaced file:" << dir.filePath(f);
+		}
+	}
+}
+
 }
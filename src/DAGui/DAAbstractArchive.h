@@ -84,6 +84,8 @@ public:
 	static QString toTemporaryPath(const QString& path);
 	// 替换文件
 	static bool replaceFile(const QString& file, const QString& beReplaceFile);
+	// 删除替换时因被占用而没能删除的旧文件
+	static void removeReplacedFiles(const QString& filePath);
 
 Q_SIGNALS:
 	/**
@@ -1,6 +1,7 @@
 ﻿#include "DAChartAddCurveWidget.h"
 #include <QMessageBox>
 #include "qwt_plot_curve.h"
+#include "DAChartPlotItemFactory.h"
 namespace DA
 {
 
@@ -26,9 +27,8 @@ QwtPlotItem* DAChartAddCurveWidget::createPlotItem()
 	if (xy.empty()) {
 		return nullptr;
 	}
-	QwtPlotCurve* item = new QwtPlotCurve();
-	item->setSamples(xy);
-	return item;
+	// 点数较多时工厂会创建抽稀绘制的曲线
+	return DAChartPlotItemFactory::createCurve(xy);
 }
 
 }  // end DA
@@ -91,6 +91,17 @@ QVector< QVector< double > > DAChartAddtGridRasterDataWidget::dataframeToMatrix(
 	try {
 		auto shape = df.shape();
         res.reserve(static_cast< int >(shape.second));
+		// 整个dataframe一次性转换为列优先的numpy数组，每列直接拷贝
+		using ArrayType = pybind11::array_t< double, pybind11::array::f_style | pybind11::array::forcecast >;
+		ArrayType arr   = ArrayType::ensure(df.object().attr("to_numpy")());
+		if (arr && arr.ndim() == 2) {
+			const double* p = arr.data();
+			for (std::size_t i = 0; i < shape.second; ++i) {
+				const double* colBegin = p + i * shape.first;
+				res.push_back(QVector< double >(colBegin, colBegin + shape.first));
+			}
+			return res;
+		}
 		for (std::size_t i = 0; i < shape.second; ++i) {
 			QVector< double > col;
             col.reserve(static_cast< int >(shape.first));
@@ -59,10 +59,21 @@ DADataOperateOfDataFrameWidget::DADataOperateOfDataFrameWidget(const DAData& d,
 	// 关闭不必要的绘制特性
 	setDAData(d);
 	connect(ui->tableView, &QTableView::clicked, this, &DADataOperateOfDataFrameWidget::onTableViewClicked);
+	connect(getUndoStack(), &QUndoStack::indexChanged, this, &DADataOperateOfDataFrameWidget::onUndoStackIndexChanged);
+	// 后台操作的进度
+	ui->widgetAsync->hide();
+	// 进度条和取消按钮不访问python，后台操作执行C扩展时仍可响应
+	DAPyAsyncTask::markGILFree(ui->widgetAsync);
+	connect(ui->toolButtonCancelAsync, &QToolButton::clicked, this, &DADataOperateOfDataFrameWidget::cancelAsyncOperation);
 }
 
 DADataOperateOfDataFrameWidget::~DADataOperateOfDataFrameWidget()
 {
+	if (mAsyncTask) {
+		// 后台操作还在使用dataframe，取消并等待其结束
+		mAsyncTask->cancel();
+		mAsyncTask->wait();
+	}
     delete ui;
 }
 
@@ -125,6 +136,9 @@ void DADataOperateOfDataFrameWidget::insertRowBelowBySelect()
  */
 void DADataOperateOfDataFrameWidget::insertRowAt(int row)
 {
+	if (warningIfBusy()) {
+		return;
+	}
 	std::unique_ptr< DACommandDataFrame_insertNanRow > cmd(
 		new DACommandDataFrame_insertNanRow(mData.toDataFrame(), row, mModel));
 	if (!cmd->exec()) {
@@ -163,6 +177,9 @@ void DADataOperateOfDataFrameWidget::insertColumnLeftBySelect()
  */
 void DADataOperateOfDataFrameWidget::insertColumnAt(int col)
 {
+	if (warningIfBusy()) {
+		return;
+	}
 	DADialogInsertNewColumn dlg(this);
 	if (QDialog::Accepted != dlg.exec()) {
 		return;
@@ -196,6 +213,9 @@ void DADataOperateOfDataFrameWidget::insertColumnAt(int col)
  */
 int DADataOperateOfDataFrameWidget::removeSelectRow()
 {
+	if (warningIfBusy()) {
+		return 0;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return 0;
@@ -219,6 +239,9 @@ int DADataOperateOfDataFrameWidget::removeSelectRow()
  */
 int DADataOperateOfDataFrameWidget::removeSelectColumn()
 {
+	if (warningIfBusy()) {
+		return 0;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return 0;
@@ -243,6 +266,9 @@ int DADataOperateOfDataFrameWidget::removeSelectColumn()
  */
 int DADataOperateOfDataFrameWidget::removeSelectCell()
 {
+	if (warningIfBusy()) {
+		return 0;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return 0;
@@ -276,6 +302,9 @@ int DADataOperateOfDataFrameWidget::removeSelectCell()
  */
 void DADataOperateOfDataFrameWidget::renameColumns()
 {
+	if (warningIfBusy()) {
+		return;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return;
@@ -314,6 +343,9 @@ void DADataOperateOfDataFrameWidget::renameColumns()
  */
 bool DADataOperateOfDataFrameWidget::changeSelectColumnType(const DAPyDType& dt)
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	qDebug() << "changeSelectColumnType:" << dt;
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
@@ -343,6 +375,9 @@ bool DADataOperateOfDataFrameWidget::changeSelectColumnType(const DAPyDType& dt)
  */
 void DADataOperateOfDataFrameWidget::castSelectToNum()
 {
+	if (warningIfBusy()) {
+		return;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return;
@@ -377,6 +412,9 @@ void DADataOperateOfDataFrameWidget::castSelectToNum()
  */
 void DADataOperateOfDataFrameWidget::castSelectToDatetime()
 {
+	if (warningIfBusy()) {
+		return;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return;
@@ -392,18 +430,39 @@ void DADataOperateOfDataFrameWidget::castSelectToDatetime()
 	if (QDialog::Accepted != mDialogCastDatetimeArgs->exec()) {
 		return;
 	}
-	DAPyDType dt        = df.dtypes(colsIndex.first());
 	pybind11::dict args = mDialogCastDatetimeArgs->getArgs();
-	std::unique_ptr< DACommandDataFrame_castDatetime > cmd(new DACommandDataFrame_castDatetime(df, colsIndex, args, mModel));
-	if (!cmd->exec()) {
-		return;
-	}
-	getUndoStack()->push(cmd.release());  // 推入后不会执行redo逻辑部分
-	// 如果类型改变了刷新类型
-	DAPyDType dt2 = df.dtypes(colsIndex.first());
-	if (dt != dt2) {
-		emit selectTypeChanged(colsIndex, dt2);
+	castToDatetimeAsync(df, colsIndex, args);
+}
+
+/**
+ * @brief 在后台把列转换为日期
+ * @param df
+ * @param colsIndex 列索引
+ * @param args 转换参数，见@ref DADialogDataframeColumnCastToDatetime::getArgs
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::castToDatetimeAsync(const DAPyDataFrame& df,
+                                                          const QList< int >& colsIndex,
+                                                          const pybind11::dict& args)
+{
+	if (colsIndex.isEmpty()) {
+		return false;
 	}
+	DAPyDType dt = df.dtypes(colsIndex.first());
+	return execCommandAsync(
+		tr("cast column to datetime"),
+		[ df, colsIndex, args ]() -> std::unique_ptr< DACommandWithRedoCount > {
+			return std::make_unique< DACommandDataFrame_castDatetime >(df, colsIndex, args);
+		},
+		[ this, df, colsIndex, dt ](DACommandWithRedoCount* cmd) -> bool {
+			Q_UNUSED(cmd);
+			// 如果类型改变了刷新类型
+			DAPyDType dt2 = df.dtypes(colsIndex.first());
+			if (dt != dt2) {
+				emit selectTypeChanged(colsIndex, dt2);
+			}
+			return true;
+		});
 }
 
 /**
@@ -412,6 +471,9 @@ void DADataOperateOfDataFrameWidget::castSelectToDatetime()
  */
 bool DADataOperateOfDataFrameWidget::changeSelectColumnToIndex()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -436,11 +498,14 @@ bool DADataOperateOfDataFrameWidget::changeSelectColumnToIndex()
  * @param thresh 可选参数，表示在删除之前需要满足的非缺失值的最小数量。如果行或列中的非缺失值数量小于等于thresh，则会被删除，-1代表不生效
  * @return 返回删除的数量，0代表没有删除任何内容
  */
-int DADataOperateOfDataFrameWidget::dropna(const QString& how, std::optional< int > thresh)
+bool DADataOperateOfDataFrameWidget::dropna(const QString& how, std::optional< int > thresh)
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
-		return 0;
+		return false;
 	}
 	int axis = 0;
 	QList< int > index;
@@ -459,7 +524,7 @@ int DADataOperateOfDataFrameWidget::dropna(const QString& how, std::optional< in
 			}
 		}
 	}
-	return dropna(df, axis, how, index, thresh);
+	return dropnaAsync(df, axis, how, index, thresh);
 }
 
 /**
@@ -491,12 +556,36 @@ int DADataOperateOfDataFrameWidget::dropna(const DAPyDataFrame& df,
 	return dropcnt;
 }
 
+/**
+ * @brief 在后台删除缺失值，参数同@ref dropna
+ * @return 开始执行返回true，没有删除任何内容时@ref asyncOperationFinished 的参数为false
+ */
+bool DADataOperateOfDataFrameWidget::dropnaAsync(const DAPyDataFrame& df,
+                                                 int axis,
+                                                 const QString& how,
+                                                 const QList< int > index,
+                                                 std::optional< int > thresh)
+{
+	return execCommandAsync(
+		tr("drop nan"),
+		[ df, axis, how, index, thresh ]() -> std::unique_ptr< DACommandWithRedoCount > {
+			return std::make_unique< DACommandDataFrame_dropna >(df, nullptr, axis, how, index, thresh);
+		},
+		[](DACommandWithRedoCount* cmd) -> bool {
+			// 没有删除任何内容时不推入undo栈
+			return static_cast< DACommandDataFrame_dropna* >(cmd)->getDropedCount() != 0;
+		});
+}
+
 /**
  * @brief 填充缺失值
  * @return 成功返回true,反之返回false
  */
 bool DADataOperateOfDataFrameWidget::fillna()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -540,6 +629,9 @@ bool DADataOperateOfDataFrameWidget::fillna(const DAPyDataFrame& df, double valu
  */
 bool DADataOperateOfDataFrameWidget::interpolate()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -561,7 +653,7 @@ bool DADataOperateOfDataFrameWidget::interpolate()
 	if (mDialogDataFrameFillInterpolate->isEnableLimitCount()) {
 		limitCount = mDialogDataFrameFillInterpolate->getLimitCount();
 	}
-	return interpolate(df, method, order, limitCount);
+	return interpolateAsync(df, method, order, limitCount);
 }
 
 bool DADataOperateOfDataFrameWidget::interpolate(const DAPyDataFrame& df, const QString& method, int order, int limit)
@@ -575,12 +667,26 @@ bool DADataOperateOfDataFrameWidget::interpolate(const DAPyDataFrame& df, const
 	return true;
 }
 
+/**
+ * @brief 在后台插值填充缺失值，插值按列分块执行，可以显示进度
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::interpolateAsync(const DAPyDataFrame& df, const QString& method, int order, int limit)
+{
+	return execCommandAsync(tr("interpolate"), [ df, method, order, limit ]() -> std::unique_ptr< DACommandWithRedoCount > {
+		return std::make_unique< DACommandDataFrame_interpolate >(df, nullptr, method, order, limit);
+	});
+}
+
 /**
  * @brief 前向填充缺失值
  * @return 返回删除的数量，0代表没有删除任何内容
  */
 bool DADataOperateOfDataFrameWidget::ffillna()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -611,6 +717,9 @@ bool DADataOperateOfDataFrameWidget::ffillna(const DAPyDataFrame& df, int axis,
  */
 bool DADataOperateOfDataFrameWidget::bfillna()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -643,6 +752,9 @@ bool DADataOperateOfDataFrameWidget::bfillna(const DAPyDataFrame& df, int axis,
  */
 int DADataOperateOfDataFrameWidget::dropduplicates(const QString& keep)
 {
+	if (warningIfBusy()) {
+		return 0;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return 0;
@@ -683,6 +795,9 @@ int DADataOperateOfDataFrameWidget::dropduplicates(const DAPyDataFrame& df, cons
  */
 int DADataOperateOfDataFrameWidget::nstdfilteroutlier(double n)
 {
+	if (warningIfBusy()) {
+		return 0;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -718,6 +833,9 @@ int DADataOperateOfDataFrameWidget::nstdfilteroutlier(const DAPyDataFrame& df, d
  */
 bool DADataOperateOfDataFrameWidget::clipoutlier()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -761,6 +879,9 @@ bool DADataOperateOfDataFrameWidget::clipoutlier(const DAPyDataFrame& df, double
  */
 bool DADataOperateOfDataFrameWidget::queryDatas()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -774,7 +895,7 @@ bool DADataOperateOfDataFrameWidget::queryDatas()
 	}
 	// 获取填充值
 	QString exper = mDialogDataFrameQueryDatas->getExpr();
-	return queryDatas(df, exper);
+	return queryDatasAsync(df, exper);
 }
 
 /**
@@ -792,6 +913,17 @@ bool DADataOperateOfDataFrameWidget::queryDatas(const DAPyDataFrame& df, const Q
 	return true;
 }
 
+/**
+ * @brief 在后台过滤给定条件外的数据
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::queryDatasAsync(const DAPyDataFrame& df, const QString& exper)
+{
+	return execCommandAsync(tr("query datas"), [ df, exper ]() -> std::unique_ptr< DACommandWithRedoCount > {
+		return std::make_unique< DACommandDataFrame_querydatas >(df, exper);
+	});
+}
+
 /**
  * @brief 检索给定的数据
  * @return 成功返回true,反之返回false
@@ -829,6 +961,9 @@ QList< QPair< int, int > > DADataOperateOfDataFrameWidget::searchData(const DAPy
  */
 bool DADataOperateOfDataFrameWidget::evalDatas()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -868,6 +1003,9 @@ bool DADataOperateOfDataFrameWidget::evalDatas(const DAPyDataFrame& df, const QS
  */
 bool DADataOperateOfDataFrameWidget::sortDatas()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -889,7 +1027,7 @@ bool DADataOperateOfDataFrameWidget::sortDatas()
 	// 获取排序参数
 	QString by     = mDADialogDataFrameSort->getSortBy();
 	bool ascending = mDADialogDataFrameSort->getSortType();
-	return sortDatas(df, by, ascending);
+	return sortDatasAsync(df, by, ascending);
 }
 
 /**
@@ -906,12 +1044,90 @@ bool DADataOperateOfDataFrameWidget::sortDatas(const DAPyDataFrame& df, const QS
 	return true;
 }
 
+/**
+ * @brief 在后台数据排序
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::sortDatasAsync(const DAPyDataFrame& df, const QString& by, const bool ascending)
+{
+	return execCommandAsync(tr("sort datas"), [ df, by, ascending ]() -> std::unique_ptr< DACommandWithRedoCount > {
+		return std::make_unique< DACommandDataFrame_sort >(df, by, ascending);
+	});
+}
+
+/**
+ * @brief 对当前的dataframe批量执行多个操作
+ * @param pipeline
+ * @return 成功返回true,反之返回false
+ */
+bool DADataOperateOfDataFrameWidget::applyPipeline(const DAPyDataFramePipeline& pipeline)
+{
+	if (warningIfBusy()) {
+		return false;
+	}
+	DAPyDataFrame df = getDataframe();
+	if (df.isNone()) {
+		return false;
+	}
+	return applyPipeline(df, pipeline);
+}
+
+/**
+ * @brief 批量执行多个操作
+ *
+ * 所有操作在一次python调用中完成，连续的逐行过滤会合并执行，整体作为一个undo步骤，
+ * 在后台执行，失败或取消时dataframe会恢复到执行前
+ * @param df
+ * @param pipeline
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::applyPipeline(const DAPyDataFrame& df, const DAPyDataFramePipeline& pipeline)
+{
+	if (pipeline.isEmpty()) {
+		return false;
+	}
+	return execCommandAsync(tr("apply operations"), [ df, pipeline ]() -> std::unique_ptr< DACommandWithRedoCount > {
+		return std::make_unique< DACommandDataFrame_pipeline >(df, pipeline);
+	});
+}
+
+/**
+ * @brief 当前表格已执行（未撤销）的操作中可以在其它表格重复执行的部分
+ *
+ * 按undo栈的顺序收集，依赖当前表格内容的操作（例如编辑单元格、删除选中的行）无法重复，会被跳过，
+ * 按列序号指定的操作在其它表格上作用于相同位置的列
+ * @param unsupportedCount 被跳过的操作数量
+ * @return
+ */
+DAPyDataFramePipeline DADataOperateOfDataFrameWidget::getOperationPipeline(int* unsupportedCount) const
+{
+	DAPyDataFramePipeline pipeline;
+	int unsupported = 0;
+	for (int i = 0; i < mUndoStack.index(); ++i) {
+		const QUndoCommand* cmd = mUndoStack.command(i);
+		if (const DACommandDataFrame_async* asyncCmd = dynamic_cast< const DACommandDataFrame_async* >(cmd)) {
+			cmd = asyncCmd->command();
+		}
+		const DACommandWithTemporaryData* tmpCmd = dynamic_cast< const DACommandWithTemporaryData* >(cmd);
+		if (!tmpCmd || !tmpCmd->appendToPipeline(pipeline)) {
+			++unsupported;
+		}
+	}
+	if (unsupportedCount) {
+		*unsupportedCount = unsupported;
+	}
+	return pipeline;
+}
+
 /**
  * @brief 过滤给定条件外的数据
  * @return 成功返回true,反之返回false
  */
 bool DADataOperateOfDataFrameWidget::filterByColumn()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
 		return false;
@@ -971,11 +1187,14 @@ DAPyDataFrame DADataOperateOfDataFrameWidget::createDataDescribe()
  * @return
  */
 
-DAPyDataFrame DADataOperateOfDataFrameWidget::createPivotTable()
+bool DADataOperateOfDataFrameWidget::createPivotTable()
 {
+	if (warningIfBusy()) {
+		return false;
+	}
 	DAPyDataFrame df = getDataframe();
 	if (df.isNone()) {
-		return DAPyDataFrame();
+		return false;
 	}
 	if (!mDialogCreatePivotTable) {
 		mDialogCreatePivotTable = new DADialogCreatePivotTable(this);
@@ -983,7 +1202,7 @@ DAPyDataFrame DADataOperateOfDataFrameWidget::createPivotTable()
 	mDialogCreatePivotTable->setDataframe(df);
 	if (QDialog::Accepted != mDialogCreatePivotTable->exec()) {
 		// 说明用户取消
-		return DAPyDataFrame();
+		return false;
 	}
 	// 获取创建透视表的参数
 	QStringList value   = mDialogCreatePivotTable->getPivotTableValue();
@@ -996,9 +1215,9 @@ DAPyDataFrame DADataOperateOfDataFrameWidget::createPivotTable()
 
 	// 如果用户没有选定分组，则返回空
 	if (index.empty())
-		return DAPyDataFrame();
+		return false;
 
-	return createPivotTable(df, value, index, columns, aggfunc, margins, marginsName, sort);
+	return createPivotTableAsync(df, value, index, columns, aggfunc, margins, marginsName, sort);
 }
 
 /**
@@ -1028,6 +1247,43 @@ DAPyDataFrame DADataOperateOfDataFrameWidget::createPivotTable(const DAPyDataFra
 	return df_pivottable;
 }
 
+/**
+ * @brief 在后台创建数据透视表，参数同@ref createPivotTable ，成功后发射@ref pivotTableCreated
+ * @return 开始执行返回true
+ */
+bool DADataOperateOfDataFrameWidget::createPivotTableAsync(const DAPyDataFrame& df,
+                                                           const QStringList value,
+                                                           const QStringList index,
+                                                           const QStringList columns,
+                                                           const QString& aggfunc,
+                                                           bool margins,
+                                                           const QString& marginsName,
+                                                           bool sort)
+{
+	// 结果在工作线程中赋值，在主线程中读取和销毁
+	std::shared_ptr< DAPyDataFrame > result = std::make_shared< DAPyDataFrame >();
+	return runAsync(
+		tr("create pivot table"),
+		[ df, value, index, columns, aggfunc, margins, marginsName, sort, result ](DAPyAsyncTask* task) -> bool {
+			DAPyScriptsDataFrame& pydf = DAPyScripts::getInstance().getDataFrame();
+			// 透视表不改变原数据，可以随时中断
+			task->setInterruptible(true);
+			DAPyDataFrame res = pydf.pivotTable(df, value, index, columns, aggfunc, margins, marginsName, sort);
+			task->setInterruptible(false);
+			if (res.isNone() || res.empty()) {
+				return false;
+			}
+			*result = res;
+			return true;
+		},
+		[ this, result ](bool success) {
+			if (success) {
+				emit pivotTableCreated(*result);
+			}
+			emit asyncOperationFinished(success);
+		});
+}
+
 /**
  * @brief dataframe表格是否有选中项
  * @return
@@ -1295,6 +1551,188 @@ QList< QPoint > DADataOperateOfDataFrameWidget::getSelectedDataframeCells(bool e
 	return res;
 }
 
+/**
+ * @brief 是否有正在后台执行的操作
+ * @return
+ */
+bool DADataOperateOfDataFrameWidget::isBusy() const
+{
+	return !mAsyncTask.isNull();
+}
+
+/**
+ * @brief 取消正在后台执行的操作
+ */
+void DADataOperateOfDataFrameWidget::cancelAsyncOperation()
+{
+	if (!mAsyncTask) {
+		return;
+	}
+	ui->toolButtonCancelAsync->setEnabled(false);
+	mAsyncTask->cancel();
+}
+
+/**
+ * @brief 在后台执行任务
+ *
+ * 执行期间表格不可操作，显示进度和取消按钮
+ * @param name 任务名称，显示在进度条旁
+ * @param fn 任务函数，在工作线程中调用
+ * @param onFinished 结束时在主线程调用，参数为是否成功
+ * @return 已有后台操作时返回false
+ */
+bool DADataOperateOfDataFrameWidget::runAsync(const QString& name,
+                                              const DAPyAsyncTask::Function& fn,
+                                              const std::function< void(bool) >& onFinished)
+{
+	if (warningIfBusy()) {
+		return false;
+	}
+	// 任务开始前冻结表格，执行期间不读取中间状态，也不等待GIL
+	mModel->setFrozen(true);
+	DAPyAsyncTask* task = DAPyAsyncTask::run(fn, name);
+	connect(task, &DAPyAsyncTask::progressChanged, this, &DADataOperateOfDataFrameWidget::onAsyncTaskProgressChanged);
+	connect(task, &DAPyAsyncTask::finished, this, [ this, task, onFinished ](bool success) {
+		if (!success) {
+			if (task->getState() == DAPyAsyncTask::Canceled) {
+				qInfo() << tr("%1 is canceled").arg(task->getName());  // cn:%1已取消
+			} else if (!task->getErrorString().isEmpty()) {
+				qWarning() << tr("%1 failed:%2").arg(task->getName(), task->getErrorString());  // cn:%1执行失败:%2
+			}
+		}
+		setBusy(nullptr);
+		if (onFinished) {
+			onFinished(success);
+		}
+	});
+	setBusy(task);
+	return true;
+}
+
+/**
+ * @brief 在后台构造并执行命令
+ *
+ * 命令在工作线程中构造（保存undo数据）并执行，执行失败或被取消时dataframe恢复到执行前；
+ * 执行成功后在主线程由@ref DACommandDataFrame_async 包装推入undo栈并刷新表格，结果和undo命令同时生效
+ * @param name 任务名称
+ * @param factory 在工作线程中构造命令，命令不能持有表格模型
+ * @param accept 判断执行完成的命令是否推入undo栈，为空时都推入
+ * @return 已有后台操作时返回false
+ */
+bool DADataOperateOfDataFrameWidget::execCommandAsync(const QString& name, const CommandFactory& factory, const CommandAccept& accept)
+{
+	// 命令在工作线程中创建，在主线程中推入undo栈或销毁
+	std::shared_ptr< std::unique_ptr< DACommandWithRedoCount > > result =
+		std::make_shared< std::unique_ptr< DACommandWithRedoCount > >();
+	DAPyAsyncTask::Function fn = [ factory, result ](DAPyAsyncTask* task) -> bool {
+		std::unique_ptr< DACommandWithRedoCount > cmd;
+		bool ok = false;
+		try {
+			cmd = factory();
+			if (!cmd) {
+				return false;
+			}
+			task->setInterruptible(true);
+			ok = cmd->exec();
+		} catch (const std::exception& e) {
+			task->setErrorString(e.what());
+		}
+		task->setInterruptible(false);
+		if (!ok) {
+			// 中止时dataframe可能已经执行了部分操作，整体快照可以重复恢复，恢复到执行前
+			DACommandWithTemporaryData* tmp = dynamic_cast< DACommandWithTemporaryData* >(cmd.get());
+			if (tmp
+				&& (tmp->getSnapshotType() == DACommandWithTemporaryData::SnapshotFrame
+					|| tmp->getSnapshotType() == DACommandWithTemporaryData::SnapshotChangedColumns)) {
+				tmp->load();
+			}
+			return false;
+		}
+		*result = std::move(cmd);
+		return true;
+	};
+	return runAsync(name, fn, [ this, result, accept ](bool success) {
+		std::unique_ptr< DACommandWithRedoCount > cmd = std::move(*result);
+		if (!success || !cmd || (accept && !accept(cmd.get()))) {
+			// 执行期间表格可能读取到了中间状态
+			mModel->refreshData();
+			emit asyncOperationFinished(false);
+			return;
+		}
+		getUndoStack()->push(new DACommandDataFrame_async(cmd.release(), mModel));  // 推入后只刷新表格，不会再次执行
+		emit asyncOperationFinished(true);
+	});
+}
+
+/**
+ * @brief 有后台操作时给出提示
+ * @return 有后台操作返回true
+ */
+bool DADataOperateOfDataFrameWidget::warningIfBusy() const
+{
+	if (!isBusy()) {
+		return false;
+	}
+	qWarning() << tr("%1 is running in background, please wait for it to finish or cancel it")
+					  .arg(mAsyncTask->getName());  // cn:%1正在后台执行，请等待执行完成或取消
+	return true;
+}
+
+/**
+ * @brief 设置正在执行的后台操作
+ * @param task 为nullptr代表后台操作结束
+ */
+void DADataOperateOfDataFrameWidget::setBusy(DAPyAsyncTask* task)
+{
+	mAsyncTask      = task;
+	const bool busy = (task != nullptr);
+	ui->tableView->setEnabled(!busy);
+	ui->widgetAsync->setVisible(busy);
+	if (busy) {
+		ui->labelAsync->setText(task->getName());
+		ui->toolButtonCancelAsync->setEnabled(true);
+		onAsyncTaskProgressChanged(task->getProgress());
+		// 后台操作期间不允许撤销/重做
+		mUndoStackWasActive = getUndoStack()->isActive();
+		getUndoStack()->setActive(false);
+	} else {
+		mModel->setFrozen(false);
+		// 执行期间切换到了其它页面时，不抢占其它页面的undo栈
+		if (mUndoStackWasActive && isVisible()) {
+			getUndoStack()->setActive(true);
+		}
+	}
+}
+
+/**
+ * @brief 激活undo栈
+ *
+ * 后台操作期间undo会修改正在被工作线程使用的dataframe，此时只记录，操作结束后再激活
+ */
+void DADataOperateOfDataFrameWidget::activeUndoStack()
+{
+	if (isBusy()) {
+		mUndoStackWasActive = true;
+		return;
+	}
+	DADataOperatePageWidget::activeUndoStack();
+}
+
+/**
+ * @brief 后台操作的进度
+ * @param percent 小于0代表无法确定进度
+ */
+void DADataOperateOfDataFrameWidget::onAsyncTaskProgressChanged(int percent)
+{
+	if (percent < 0) {
+		// 无法确定进度时显示忙碌
+		ui->progressBarAsync->setRange(0, 0);
+	} else {
+		ui->progressBarAsync->setRange(0, 100);
+		ui->progressBarAsync->setValue(percent);
+	}
+}
+
 /**
  * @brief 表格点击
  * @param index
@@ -1320,6 +1758,21 @@ void DADataOperateOfDataFrameWidget::onTableViewClicked(const QModelIndex& index
 	emit selectTypeChanged({ index.column() }, t);
 }
 
+/**
+ * @brief undo stack变化
+ *
+ * dataframe的编辑命令直接修改python对象，不经过DAData接口，这里把数据标记为dirty，
+ * 工程保存时才会重新写入这个数据
+ * @param idx
+ */
+void DADataOperateOfDataFrameWidget::onUndoStackIndexChanged(int idx)
+{
+	Q_UNUSED(idx);
+	if (DADataManager* mgr = mData.getDataManager()) {
+		mgr->setDataDirtyFlag(mData, true);
+	}
+}
+
 void DADataOperateOfDataFrameWidget::changeEvent(QEvent* e)
 {
 	QWidget::changeEvent(e);
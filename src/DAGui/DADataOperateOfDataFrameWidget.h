@@ -2,12 +2,17 @@
 #define DADATAOPERATEOFDATAFRAMEWIDGET_H
 #include <QtWidgets/QWidget>
 #include <QUndoStack>
+#include <QPointer>
+#include <functional>
+#include <memory>
 #include <optional>
 #include "DAGuiAPI.h"
 #include "DAData.h"
 #include "DADataPyDataFrame.h"
 #include "numpy/DAPyDType.h"
 #include "DADataOperatePageWidget.h"
+#include "DAPyDataFramePipeline.h"
+#include "DAPyAsyncTask.h"
 namespace Ui
 {
 class DADataOperateOfDataFrameWidget;
@@ -28,10 +33,16 @@ class DADialogDataFrameQueryDatas;
 class DADialogDataFrameDataSearch;
 class DADialogDataFrameSort;
 class DADialogCreatePivotTable;
+class DACommandWithRedoCount;
 
 /**
  * @brief 针对DataFrame的操作窗口
  *
+ * 耗时的操作（删除缺失值、插值、排序、过滤、转换为日期、数据透视表）通过界面交互执行时，
+ * 在python工作线程中执行（见@ref DAPyAsyncTask ），执行期间表格不可操作，显示进度并可取消，
+ * 执行成功后结果和undo命令一起生效，失败或取消时dataframe恢复到执行前，结束时发射@ref asyncOperationFinished
+ *
+ * 每个窗口同时只执行一个后台操作，不同窗口（不同的dataframe）的后台操作可以同时执行
  */
 class DAGUI_API DADataOperateOfDataFrameWidget : public DADataOperatePageWidget
 {
@@ -65,6 +76,10 @@ public:
 
 	// 获取选中的序列，如果用户打开一个表格，选中了其中一列，那么将返回那一列pd.Series作为数据，如果用户选中了多列，那么每列作为一个DAData并组成list返回
 	QList< DAData > getSlectedSeries() const;
+	// 是否有正在后台执行的操作
+	bool isBusy() const;
+	// 激活undo栈，有后台操作时推迟到操作结束
+	void activeUndoStack() override;
 
 public Q_SLOTS:
 	void setDAData(const DA::DAData& d);
@@ -88,15 +103,21 @@ public Q_SLOTS:
 	// 把选择的行转换为数值，带交互
 	void castSelectToNum();
 	void castSelectToDatetime();
+	bool castToDatetimeAsync(const DAPyDataFrame& df, const QList< int >& colsIndex, const pybind11::dict& args);
 	// 把选择的列转换为索引
 	bool changeSelectColumnToIndex();
-	// 删除缺失值,返回删除的数量
-	int dropna(const QString& how = QStringLiteral("any"), std::optional< int > thresh = std::nullopt);
+	// 删除缺失值,返回删除的数量，交互执行时在后台执行，返回是否开始执行
+	bool dropna(const QString& how = QStringLiteral("any"), std::optional< int > thresh = std::nullopt);
 	int dropna(const DAPyDataFrame& df,
 			   int axis,
 			   const QString& how          = QStringLiteral("any"),
 			   const QList< int > index    = QList< int >(),
 			   std::optional< int > thresh = std::nullopt);
+	bool dropnaAsync(const DAPyDataFrame& df,
+					 int axis,
+					 const QString& how          = QStringLiteral("any"),
+					 const QList< int > index    = QList< int >(),
+					 std::optional< int > thresh = std::nullopt);
 	// 删除重复值
 	int dropduplicates(const QString& keep = QStringLiteral("first"));
 	int dropduplicates(const DAPyDataFrame& df,
@@ -108,6 +129,7 @@ public Q_SLOTS:
 	// 插值法填充缺失值，成功返回true
 	bool interpolate();
 	bool interpolate(const DAPyDataFrame& df, const QString& method, int order, int limit);
+	bool interpolateAsync(const DAPyDataFrame& df, const QString& method, int order, int limit);
 	// 前向填充缺失值，执行成功返回true
 	bool ffillna();
 	bool ffillna(const DAPyDataFrame& df, int axis = 0, int limit = -1);
@@ -123,6 +145,7 @@ public Q_SLOTS:
 	// 过滤给定条件外的数据
 	bool queryDatas();
 	bool queryDatas(const DAPyDataFrame& df, const QString& exper);
+	bool queryDatasAsync(const DAPyDataFrame& df, const QString& exper);
 	// 检索给定的数据
 	bool searchData();
 	QList< QPair< int, int > > searchData(const DAPyDataFrame& df, const QString& exper) const;
@@ -135,8 +158,14 @@ public Q_SLOTS:
 	// 数据排序
 	bool sortDatas();
 	bool sortDatas(const DAPyDataFrame& df, const QString& by, const bool ascending);
-	// 创建数据透视表
-	DAPyDataFrame createPivotTable();
+	bool sortDatasAsync(const DAPyDataFrame& df, const QString& by, const bool ascending);
+	// 批量执行多个操作，只跨越一次python调用，作为一个undo步骤，在后台执行
+	bool applyPipeline(const DAPyDataFramePipeline& pipeline);
+	bool applyPipeline(const DAPyDataFrame& df, const DAPyDataFramePipeline& pipeline);
+	// 当前表格已执行（未撤销）的操作中可以在其它表格重复执行的部分
+	DAPyDataFramePipeline getOperationPipeline(int* unsupportedCount = nullptr) const;
+	// 创建数据透视表，交互执行时在后台执行，结果通过pivotTableCreated信号返回
+	bool createPivotTable();
 	DAPyDataFrame createPivotTable(const DAPyDataFrame& df,
 								   const QStringList value    = QStringList(),
 								   const QStringList index    = QStringList(),
@@ -145,6 +174,16 @@ public Q_SLOTS:
 								   bool margins               = false,
 								   const QString& marginsName = QStringLiteral("All"),
 								   bool sort                  = false);
+	bool createPivotTableAsync(const DAPyDataFrame& df,
+							   const QStringList value    = QStringList(),
+							   const QStringList index    = QStringList(),
+							   const QStringList columns  = QStringList(),
+							   const QString& aggfunc     = QStringLiteral("mean"),
+							   bool margins               = false,
+							   const QString& marginsName = QStringLiteral("All"),
+							   bool sort                  = false);
+	// 取消正在后台执行的操作
+	void cancelAsyncOperation();
 Q_SIGNALS:
 	/**
 	 * @brief 选中的列或者类型发生了变化
@@ -153,17 +192,51 @@ Q_SIGNALS:
 	 * @note 此函数主要是通知主界面ribbon上面的类型变化，调用setDataframeOperateCurrentDType
 	 */
 	void selectTypeChanged(const QList< int >& column, DA::DAPyDType dt);
+
+	/**
+	 * @brief 后台操作结束
+	 * @param success 操作成功并推入了undo栈为true，失败、取消或没有改变数据为false
+	 */
+	void asyncOperationFinished(bool success);
+
+	/**
+	 * @brief 后台创建数据透视表完成
+	 * @param df 数据透视表
+	 */
+	void pivotTableCreated(const DA::DAPyDataFrame& df);
 private Q_SLOTS:
 	// 表格点击
 	void onTableViewClicked(const QModelIndex& index);
+	// undo stack变化，说明dataframe内容被修改
+	void onUndoStackIndexChanged(int idx);
 
 protected:
 	void changeEvent(QEvent* e);
+	/**
+	 * @brief 在工作线程中构造命令，构造时需以model=nullptr创建
+	 */
+	using CommandFactory = std::function< std::unique_ptr< DACommandWithRedoCount >() >;
+	/**
+	 * @brief 在主线程判断执行完成的命令是否推入undo栈，返回false时命令被丢弃
+	 */
+	using CommandAccept = std::function< bool(DACommandWithRedoCount*) >;
+	// 在后台执行任务，onFinished在主线程调用
+	bool runAsync(const QString& name, const DAPyAsyncTask::Function& fn, const std::function< void(bool) >& onFinished);
+	// 在后台构造并执行命令，成功后推入undo栈
+	bool execCommandAsync(const QString& name, const CommandFactory& factory, const CommandAccept& accept = CommandAccept());
+	// 有后台操作时给出提示并返回true
+	bool warningIfBusy() const;
+
+private:
+	void setBusy(DAPyAsyncTask* task);
+	void onAsyncTaskProgressChanged(int percent);
 
 private:
 	Ui::DADataOperateOfDataFrameWidget* ui;
 	DAData mData;
 	DAPyDataFrameTableModel* mModel { nullptr };
+	QPointer< DAPyAsyncTask > mAsyncTask;  ///< 正在后台执行的操作
+	bool mUndoStackWasActive { false };    ///< 后台操作开始前undo栈是否处于激活状态
 
 	DADialogDataframeColumnCastToNumeric* mDialogCastNumArgs { nullptr };
 	DADialogDataframeColumnCastToDatetime* mDialogCastDatetimeArgs { nullptr };
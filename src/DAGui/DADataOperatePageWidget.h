@@ -24,7 +24,7 @@ public:
 	virtual int getDataOperatePageType() const = 0;
 	QUndoStack* getUndoStack();
 	// 激活此窗口的UndoStack
-	void activeUndoStack();
+	virtual void activeUndoStack();
 
 protected:
 	QUndoStack mUndoStack;
@@ -95,6 +95,23 @@ DADataOperateOfDataFrameWidget* DADataOperateWidget::getCurrentDataFrameWidget()
 #endif
 }
 
+/**
+ * @brief 所有打开的DataFrame窗口，按tab的顺序
+ * @return
+ */
+QList< DADataOperateOfDataFrameWidget* > DADataOperateWidget::getDataFrameWidgets() const
+{
+	QList< DADataOperateOfDataFrameWidget* > res;
+#if DA_ENABLE_PYTHON
+	for (int i = 0; i < ui->tabWidget->count(); ++i) {
+		if (DADataOperateOfDataFrameWidget* w = qobject_cast< DADataOperateOfDataFrameWidget* >(ui->tabWidget->widget(i))) {
+			res.append(w);
+		}
+	}
+#endif
+	return res;
+}
+
 /**
  * @brief 获取当前表格操作选中的数据
  *
@@ -275,7 +292,7 @@ void DADataOperateWidget::onTabWidgetCurrentChanged(int index)
 	}
 #if DA_ENABLE_PYTHON
 	if (DADataOperateOfDataFrameWidget* d = qobject_cast< DADataOperateOfDataFrameWidget* >(w)) {
-		// 激活undostack
+		// 激活undostack，有后台操作时会推迟到操作结束
 		d->activeUndoStack();
 	}
 #endif
@@ -37,6 +37,8 @@ public:
 
 	// 当前显示的DataFrame窗口，如果不是DataFrame窗口，返回nullptr
 	DADataOperateOfDataFrameWidget* getCurrentDataFrameWidget() const;
+	// 所有打开的DataFrame窗口
+	QList< DADataOperateOfDataFrameWidget* > getDataFrameWidgets() const;
 	// 获取当前表格操作选中的数据，如果用户打开一个表格，选中了其中一列，那么将返回那一列pd.Series作为数据，如果用户选中了多列，那么每列作为一个DAData并组成list返回
 	QList< DAData > getCurrentSelectDatas() const;
 
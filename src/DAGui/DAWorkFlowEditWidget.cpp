@@ -54,6 +54,12 @@ void DAWorkFlowEditWidget::setWorkFlow(DAWorkFlow* w)
 	ui->workflowGraphicsView->setWorkFlow(w);
 	connect(w, &DAWorkFlow::startExecute, this, &DAWorkFlowEditWidget::startExecute);
 	connect(w, &DAWorkFlow::nodeExecuteFinished, this, &DAWorkFlowEditWidget::nodeExecuteFinished);
+	// 开启性能记录时，执行完成后在节点上显示耗时热力图
+	connect(w, &DAWorkFlow::finished, this, [ this, w ](bool) {
+		if (mScene && (w->isEnableProfile() || mScene->getProfileOverlay())) {
+			mScene->setProfileOverlay(w->getLastExecuteProfiler());
+		}
+	});
 	connect(w, &DAWorkFlow::finished, this, &DAWorkFlowEditWidget::finished);
 }
 
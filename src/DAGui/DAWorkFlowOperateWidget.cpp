@@ -31,6 +31,7 @@ public:
 	bool mIsDestorying { false };
 	bool mOnlyOneWorkflow { false };    ///< 设置只允许一个工作流
 	bool mEnableWorkflowLink { true };  ///< 是否允许工作流连接
+	bool mEnableProfile { false };      ///< 是否记录节点性能
 	QAction* mActionCopy { nullptr };
 	QAction* mActionCut { nullptr };
 	QAction* mActionPaste { nullptr };
@@ -101,6 +102,7 @@ DAWorkFlowEditWidget* DAWorkFlowOperateWidget::appendWorkflow(const QString& nam
 	DAWorkFlowEditWidget* wfe = new DAWorkFlowEditWidget(ui->tabWidget);
 	DAWorkFlow* wf            = createWorkflow();
 	wf->setParent(wfe);
+	wf->setEnableProfile(d->mEnableProfile);
 	wfe->setWorkFlow(wf);
 	// 把undo添加进去
 	wfe->setEnableShowGrid(d->mIsShowGrid);
@@ -525,6 +527,32 @@ void DAWorkFlowOperateWidget::runCurrentWorkFlow()
 	wf->exec();
 }
 
+/**
+ * @brief 运行工作流到选中的节点
+ *
+ * 只运行计算选中节点所需的上游节点，和选中节点无关的分支不会运行
+ * @sa DAWorkFlow::execTo
+ */
+void DAWorkFlowOperateWidget::runCurrentWorkFlowToSelectedNode()
+{
+	DAWorkFlowEditWidget* w = getCurrentWorkFlowWidget();
+	if (nullptr == w) {
+		qWarning() << tr("No active workflow detected");  // 未检测到激活的工作流
+		return;
+	}
+	DAWorkFlow* wf = w->getWorkflow();
+	if (nullptr == wf) {
+		qCritical() << tr("Unable to get workflow correctly");  // 无法正确获取工作流
+		return;
+	}
+	DAAbstractNodeGraphicsItem* item = w->getWorkFlowGraphicsScene()->getSelectedNodeGraphicsItem();
+	if (nullptr == item) {
+		qWarning() << tr("Select the node to run to first");  // cn:请先选中要运行到的节点
+		return;
+	}
+	wf->execTo(item->node());
+}
+
 /**
  * @brief 终止当前工作流
  */
@@ -630,6 +658,32 @@ bool DAWorkFlowOperateWidget::isEnableWorkflowLink() const
 	return d_ptr->mEnableWorkflowLink;
 }
 
+/**
+ * @brief 设置是否记录节点性能
+ *
+ * 开启后工作流执行完成会在节点上显示耗时热力图，性能记录通过@ref DAWorkFlow::getLastExecuteProfiler 获取
+ * @param on
+ */
+void DAWorkFlowOperateWidget::setEnableProfile(bool on)
+{
+	d_ptr->mEnableProfile = on;
+	const QList< DAWorkFlowEditWidget* > wfes = getAllWorkFlowWidgets();
+	for (DAWorkFlowEditWidget* wfe : wfes) {
+		if (DAWorkFlow* wf = wfe->getWorkflow()) {
+			wf->setEnableProfile(on);
+		}
+	}
+}
+
+/**
+ * @brief 是否记录节点性能
+ * @return
+ */
+bool DAWorkFlowOperateWidget::isEnableProfile() const
+{
+	return d_ptr->mEnableProfile;
+}
+
 /**
  * @brief 文本字体
  * @param c
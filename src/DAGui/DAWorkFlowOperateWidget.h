@@ -152,6 +152,8 @@ public Q_SLOTS:
 	void setCurrentWorkflowSelectAll();
 	// 运行工作流
 	void runCurrentWorkFlow();
+	// 运行工作流到选中的节点
+	void runCurrentWorkFlowToSelectedNode();
 	// 终止工作流
 	void terminateCurrentWorkFlow();
 	// 复制当前选中的items
@@ -167,6 +169,9 @@ public Q_SLOTS:
 	// 设置是否允许连接
 	void setEnableWorkflowLink(bool on);
 	bool isEnableWorkflowLink() const;
+	// 设置所有工作流是否记录节点性能，新建的工作流同样生效
+	void setEnableProfile(bool on);
+	bool isEnableProfile() const;
 Q_SIGNALS:
 
 	/**
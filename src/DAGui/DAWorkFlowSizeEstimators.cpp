@@ -0,0 +1,68 @@
+﻿#include "DAWorkFlowSizeEstimators.h"
+#include "DAWorkFlowProfiler.h"
+#include "DAData.h"
+#include "DAPybind11InQt.h"
+#include "pandas/DAPyDataFrame.h"
+#include "pandas/DAPySeries.h"
+#include "DAPySharedFrame.h"
+#include <QDebug>
+namespace DA
+{
+/**
+ * @brief dataframe或series的浅内存占用
+ *
+ * 估算只用于性能记录，使用deep=False，object列只统计指针大小，避免遍历所有元素
+ * @param obj pandas对象，调用前需要持有gil
+ * @return 无法估算返回-1
+ */
+static qint64 estimator_pandas_memory_usage(const pybind11::object& obj)
+{
+    if (obj.is_none()) {
+        return 0;
+    }
+    try {
+        pybind11::object usage = obj.attr("memory_usage")(pybind11::arg("index") = true, pybind11::arg("deep") = false);
+        if (pybind11::hasattr(usage, "sum")) {
+            usage = usage.attr("sum")();
+        }
+        return usage.cast< qint64 >();
+    } catch (const std::exception& e) {
+        qDebug() << e.what();
+    }
+    return -1;
+}
+
+/**
+ * @brief 注册工作流性能记录的数据大小估算函数
+ *
+ * 估算函数会在执行器的工作线程中调用，这些线程不持有gil。
+ * 为了不让性能记录和其他线程竞争gil（主线程执行python时执行器会被阻塞），估算函数不获取gil：
+ * 当前线程没有持有gil时，pandas对象的大小记为未知（-1）；
+ * 共享内存中的dataframe（@ref DAPySharedFrame ）直接使用文件大小，不需要gil
+ */
+void registerWorkFlowSizeEstimators()
+{
+    DAWorkFlowProfiler::registerSizeEstimator(qMetaTypeId< DAPyDataFrame >(), [](const QVariant& v) -> qint64 {
+        if (!PyGILState_Check()) {
+            return -1;
+        }
+        return estimator_pandas_memory_usage(v.value< DAPyDataFrame >().object());
+    });
+    DAWorkFlowProfiler::registerSizeEstimator(qMetaTypeId< DAPySeries >(), [](const QVariant& v) -> qint64 {
+        if (!PyGILState_Check()) {
+            return -1;
+        }
+        return estimator_pandas_memory_usage(v.value< DAPySeries >().object());
+    });
+    DAWorkFlowProfiler::registerSizeEstimator(qMetaTypeId< DAData >(), [](const QVariant& v) -> qint64 {
+        const DAData d = v.value< DAData >();
+        if ((!d.isDataFrame() && !d.isSeries()) || !PyGILState_Check()) {
+            return -1;
+        }
+        return estimator_pandas_memory_usage(d.isDataFrame() ? d.toDataFrame().object() : d.toSeries().object());
+    });
+    DAWorkFlowProfiler::registerSizeEstimator(qMetaTypeId< DAPySharedFrame >(), [](const QVariant& v) -> qint64 {
+        return v.value< DAPySharedFrame >().getFileSize();
+    });
+}
+}
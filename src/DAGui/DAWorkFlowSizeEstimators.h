@@ -0,0 +1,9 @@
+﻿#ifndef DAWORKFLOWSIZEESTIMATORS_H
+#define DAWORKFLOWSIZEESTIMATORS_H
+#include "DAGuiAPI.h"
+namespace DA
+{
+// 向DAWorkFlowProfiler注册DAData、DAPyDataFrame、DAPySeries的数据大小估算，需要在python环境初始化后调用
+DAGUI_API void registerWorkFlowSizeEstimators();
+}
+#endif  // DAWORKFLOWSIZEESTIMATORS_H
@@ -51,6 +51,8 @@ public:
 	// 保存工作流
 	void saveWorkflow(DAWorkFlowEditWidget* wfe, QDomDocument& doc, QDomElement& workflowEle);
 	bool loadWorkflow(DAWorkFlowEditWidget* wfe, const QDomElement& workflowEle);
+	// 无界面加载工作流
+	bool loadWorkflowWithoutItems(DAWorkFlow* workflow, const QDomElement& workflowEle);
 	// copy type类型
 	void saveWorkflowFromClipBoard(const QList< DAGraphicsItem* > its, QDomDocument& doc, QDomElement& workflowEle);
 	bool loadWorkflowFromClipBoard(DAWorkFlowGraphicsScene* scene, const QDomElement& workflowEle, bool isCreateNewId = true);
@@ -67,7 +69,7 @@ public:
 							const QDomElement& workflowEle,
 							QMap< qulonglong, qulonglong >* idMap);
 
-	[[deprecated("This function is deprecated. Use loadNodeAndItem() instead.")]]
+	// 只加载节点，不创建图元，界面加载使用loadNodeAndItem
 	DAAbstractNode::SharedPointer loadNode(const QDomElement& nodeEle, DAWorkFlow* workflow, bool isLoadID = true);
 	DAAbstractNodeGraphicsItem* loadNodeAndItem(const QDomElement& nodeEle, DAWorkFlowGraphicsScene* workFlowScene);
 	// 这种是针对需要redo/undo的加载节点
@@ -91,6 +93,7 @@ public:
 	void saveNodeLinks(const DAWorkFlow* workflow, QDomDocument& doc, QDomElement& workflowEle);
 	QDomElement makeNodeLinkElement(DAAbstractNodeLinkGraphicsItem* link, const QString& tagName, QDomDocument& doc);
 	bool loadNodeLinks(DAWorkFlowGraphicsScene* scene, DAWorkFlow* wf, const QDomElement& workflowEle);
+	bool loadNodeLinksWithoutItems(DAWorkFlow* wf, const QDomElement& workflowEle);
 	bool loadNodeLinksClipBoardCopy(DAWorkFlowGraphicsScene* scene,
 									const QDomElement& workflowEle,
 									const QMap< qulonglong, qulonglong >* idMap);
@@ -178,6 +181,8 @@ bool DAXmlHelper::PrivateData::loadWorkflow(DAWorkFlowEditWidget* wfe, const QDo
 	// 一定要设置disableFactoryCallBack，否则在加载过程会 一直触发回调，加载过程会很慢，加载过程通过最后的ready信号进行触发
 	workflow->disableFactoryCallBack();
 	workFlowScene->setReady(false);
+	// 批量加载模式，加载过程不维护场景索引，信号在加载完成后统一发射
+	workFlowScene->beginBulkLoad();
 	//
 	clearDealItemSet();  // 清空保存过的item的记录
 	QDomElement externEle = workflowEle.firstChildElement("extern");
@@ -214,6 +219,7 @@ bool DAXmlHelper::PrivateData::loadWorkflow(DAWorkFlowEditWidget* wfe, const QDo
 	qDebug() << QObject::tr("load secen info cost: %1 ms").arg(tes.restart());
 
 	// 加载完成，设置场景没有就绪
+	workFlowScene->endBulkLoad();
 	workFlowScene->setReady(true);
 	// 加载完成后开启回调
 	workflow->enableFactoryCallBack();
@@ -221,6 +227,55 @@ bool DAXmlHelper::PrivateData::loadWorkflow(DAWorkFlowEditWidget* wfe, const QDo
 	return true;
 }
 
+/**
+ * @brief 无界面加载工作流
+ *
+ * 只加载工作流的扩展信息、节点、连接和工厂信息，节点通过@ref DAAbstractNode::linkTo 直接建立连接，
+ * 不会调用@ref DAAbstractNode::createGraphicsItem ，场景信息和文本等特殊图元会被忽略
+ * @param workflow
+ * @param workflowEle
+ * @return
+ */
+bool DAXmlHelper::PrivateData::loadWorkflowWithoutItems(DAWorkFlow* workflow, const QDomElement& workflowEle)
+{
+	QElapsedTimer tes;
+	tes.start();
+	workflow->disableFactoryCallBack();
+	QDomElement externEle = workflowEle.firstChildElement("extern");
+	if (!externEle.isNull()) {
+		workflow->loadExternInfoFromXml(&externEle, mLoadedVersion);
+	}
+	bool isok              = true;
+	QDomElement nodesEle   = workflowEle.firstChildElement("nodes");
+	QDomNodeList nodeslist = nodesEle.childNodes();
+	for (int i = 0; i < nodeslist.size(); ++i) {
+		QDomElement nodeEle = nodeslist.at(i).toElement();
+		if (nodeEle.tagName() != "node") {
+			continue;
+		}
+		DAAbstractNode::SharedPointer node = loadNode(nodeEle, workflow, true);
+		if (!node) {
+			// 异常提示在loadNode函数中已经有，不用重复提示
+			isok = false;
+			continue;
+		}
+		workflow->addNode(node);
+	}
+	qDebug() << QObject::tr("load workflow nodes cost: %1 ms").arg(tes.restart());
+	if (!loadNodeLinksWithoutItems(workflow, workflowEle)) {
+		qCritical() << QObject::tr("load nodes link occurce error");
+		isok = false;
+	}
+	qDebug() << QObject::tr("load workflow links cost: %1 ms").arg(tes.restart());
+	//! 注意，工厂的加载要在节点和连接之后
+	if (!loadFactoryInfo(workflow, workflowEle)) {
+		qCritical() << QObject::tr("load factorys occurce error");
+	}
+	workflow->enableFactoryCallBack();
+	workflow->callWorkflowReady();
+	return isok;
+}
+
 void DAXmlHelper::PrivateData::saveWorkflowFromClipBoard(const QList< DAGraphicsItem* > its,
                                                          QDomDocument& doc,
                                                          QDomElement& workflowEle)
@@ -297,6 +352,7 @@ bool DAXmlHelper::PrivateData::loadWorkflowFromClipBoard(DAWorkFlowGraphicsScene
 	// 计算当前view的中心点
 	// 加载开始，设置场景没有就绪
 	scene->setReady(false);
+	scene->beginBulkLoad();
 	auto wf = scene->getWorkflow();
 	// 一定要设置disableFactoryCallBack，否则在加载过程会 一直触发回调，加载过程会很慢，加载过程通过最后的ready信号进行触发
 	wf->disableFactoryCallBack();
@@ -317,6 +373,7 @@ bool DAXmlHelper::PrivateData::loadWorkflowFromClipBoard(DAWorkFlowGraphicsScene
 		qCritical() << QObject::tr("load items occurce error");
 	}
 	scene->getUndoStack()->endMacro();
+	scene->endBulkLoad();
 	scene->setReady(true);
 	wf->enableFactoryCallBack();
 	wf->callWorkflowReady();
@@ -1124,6 +1181,48 @@ bool DAXmlHelper::PrivateData::loadNodeLinks(DAWorkFlowGraphicsScene* scene, DAW
 	return true;
 }
 
+/**
+ * @brief 无界面加载连接，通过节点直接建立连接，连接线的图元信息被忽略
+ * @param wf
+ * @param workflowEle
+ * @return 存在无法建立的连接时返回false
+ */
+bool DAXmlHelper::PrivateData::loadNodeLinksWithoutItems(DAWorkFlow* wf, const QDomElement& workflowEle)
+{
+	bool isok            = true;
+	QDomElement linksEle = workflowEle.firstChildElement("links");
+	QDomNodeList list    = linksEle.childNodes();
+	for (int i = 0; i < list.size(); ++i) {
+		QDomElement linkEle = list.at(i).toElement();
+		if (linkEle.tagName() != "link") {
+			continue;
+		}
+		QDomElement fromEle = linkEle.firstChildElement("from");
+		QDomElement toEle   = linkEle.firstChildElement("to");
+		if (fromEle.isNull() || toEle.isNull()) {
+			continue;
+		}
+		bool okFrom                            = false;
+		bool okTo                              = false;
+		DAAbstractNode::SharedPointer fromNode = wf->getNode(fromEle.attribute("id").toULongLong(&okFrom));
+		DAAbstractNode::SharedPointer toNode   = wf->getNode(toEle.attribute("id").toULongLong(&okTo));
+		if (!okFrom || !okTo || nullptr == fromNode || nullptr == toNode) {
+			qWarning() << QObject::tr("link info can not find node in workflow,id = %1")
+							  .arg(okFrom && fromNode ? toEle.attribute("id") : fromEle.attribute("id"));
+			isok = false;
+			continue;
+		}
+		const QString fromKey = fromEle.attribute("name");
+		const QString toKey   = toEle.attribute("name");
+		if (!fromNode->linkTo(fromKey, toNode, toKey)) {
+			qWarning() << QObject::tr("Unable to link to node %3's link point %4 through link point %2 of node %1")
+							  .arg(fromNode->getNodeName(), fromKey, toNode->getNodeName(), toKey);
+			isok = false;
+		}
+	}
+	return isok;
+}
+
 bool DAXmlHelper::PrivateData::loadNodeLinksClipBoardCopy(DAWorkFlowGraphicsScene* scene,
                                                           const QDomElement& workflowEle,
                                                           const QMap< qulonglong, qulonglong >* idMap)
@@ -1567,6 +1666,20 @@ bool DAXmlHelper::loadElement(DAWorkFlowEditWidget* wfe, const QDomElement* ele)
 	return d_ptr->loadWorkflow(wfe, *ele);
 }
 
+/**
+ * @brief 无界面加载工作流
+ *
+ * 节点只需实现exec，不会创建图元，用于命令行批处理等没有界面的场景，调用前需要通过
+ * @ref setLoadedVersionNumber 设置文件版本
+ * @param workflow 已经注册了工厂的工作流
+ * @param workflowEle &lt;workflow&gt;节点
+ * @return
+ */
+bool DAXmlHelper::loadElement(DAWorkFlow* workflow, const QDomElement* workflowEle)
+{
+	return d_ptr->loadWorkflowWithoutItems(workflow, *workflowEle);
+}
+
 QDomElement DAXmlHelper::makeElement(DAWorkFlowOperateWidget* wfo, const QString& tagName, QDomDocument* doc)
 {
 	QDomElement workflowsElement = doc->createElement(tagName);
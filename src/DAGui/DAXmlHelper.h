@@ -61,6 +61,8 @@ public:
 	// 标准保存—— DAWorkFlowEditWidget
 	QDomElement makeElement(DAWorkFlowOperateWidget* wfo, const QString& tagName, QDomDocument* doc);
 	bool loadElement(DAWorkFlowOperateWidget* wfo, const QDomElement* workflowsEle);
+	// 无界面加载——只加载节点、连接和工厂信息，不创建图元，用于命令行批处理
+	bool loadElement(DAWorkFlow* workflow, const QDomElement* workflowEle);
 	// 创建剪切板描述xml
 	QDomElement makeClipBoardElement(const QList< DAGraphicsItem* > its,
                                      const QString& tagName,
@@ -31,6 +31,7 @@ public:
 	// 打开
 	static const char* password();
 	static int compressLevel();
+	static int compressMethod();
 
 public:
 	std::unique_ptr< QuaZip > mZip;
@@ -71,6 +72,18 @@ int DAZipArchive::PrivateData::compressLevel()
 	return s_zip_compress_level;
 }
 
+/**
+ * @brief 压缩方式
+ *
+ * 不压缩时以stored方式存放，数据在档案中连续存放，没有deflate的分块头，
+ * 工程中的数据条目因此可以直接内存映射档案文件读取（见da_from_archive），不需要解压
+ * @return
+ */
+int DAZipArchive::PrivateData::compressMethod()
+{
+	return (s_zip_compress_level == Z_NO_COMPRESSION) ? 0 : Z_DEFLATED;
+}
+
 QStringList DAZipArchive::PrivateData::getAllFiles() const
 {
     if (!mZip->isOpen() || mZip->getMode() != QuaZip::mdUnzip) {
@@ -139,42 +152,8 @@ QString DAZipArchive::PrivateData::errorStringFromZipError(int errorCode) const
 
 bool DAZipArchive::PrivateData::copyZipEntry(QuaZip* sourceZip, QuaZip* destZip, const QString& fileName)
 {
-    if (!sourceZip->setCurrentFile(fileName)) {
-        return false;
-    }
-
-    QuaZipFile inFile(sourceZip);
-    if (!inFile.open(QIODevice::ReadOnly)) {
-        return false;
-    }
-
-    QuaZipFile outFile(destZip);
-    if (!outFile.open(QIODevice::WriteOnly, QuaZipNewInfo(fileName), s_password, 0, Z_DEFLATED, s_zip_compress_level)) {
-        inFile.close();
-        return false;
-    }
-
-    // 分块复制（4MB块）
-    const qint64 CHUNK_SIZE = 4 * 1024 * 1024;
-    char buffer[ CHUNK_SIZE ];
-    bool success = true;
-
-    while (!inFile.atEnd()) {
-        qint64 bytesRead = inFile.read(buffer, CHUNK_SIZE);
-        if (bytesRead == -1) {
-            success = false;
-            break;
-        }
-
-        if (outFile.write(buffer, bytesRead) != bytesRead) {
-            success = false;
-            break;
-        }
-    }
-
-    inFile.close();
-    outFile.close();
-    return success;
+    // 原样复制，避免解压后再重新压缩
+    return DAZipArchive::copyRawEntry(sourceZip, destZip, fileName);
 }
 //===============================================================
 // DAZipArchive
@@ -287,7 +266,7 @@ bool DAZipArchive::write(const QString& relatePath, const QByteArray& byte)
                       QuaZipNewInfo(relatePath),
                       DAZipArchive::PrivateData::s_password,
                       0,
-                      Z_DEFLATED,
+                      DAZipArchive::PrivateData::compressMethod(),
                       DAZipArchive::PrivateData::s_zip_compress_level)) {
         d->mLastErrorString = zipFile.errorString();
         qDebug() << tr("The file %1 in the archive could not be opened. The reason for the error is %2")
@@ -355,6 +334,24 @@ bool DAZipArchive::writeFileToZip(const QString& relatePath, const QString& loca
     return writeFileToZip(d->mZip.get(), relatePath, localFilePath, chunk_mb);
 }
 
+/**
+ * @brief 把另外一个zip中的条目原样复制到本压缩包中
+ * @param sourceZip 源zip，需要以QuaZip::mdUnzip模式打开
+ * @param relatePath 条目在zip中的相对路径，复制后路径保持不变
+ * @param chunk_mb 分块大小
+ * @return
+ * @sa copyRawEntry
+ */
+bool DAZipArchive::copyRawEntryFrom(QuaZip* sourceZip, const QString& relatePath, std::size_t chunk_mb)
+{
+	DA_D(d);
+	if (!isOpened() || !d->ensureOpenForWrite()) {
+		qDebug() << tr("archive is not open");  // cn:文件还未打开
+		return false;
+	}
+	return copyRawEntry(sourceZip, d->mZip.get(), relatePath, chunk_mb);
+}
+
 /**
  * @brief 读数据
  * @param relatePath
@@ -904,7 +901,7 @@ bool DAZipArchive::writeFileToZip(QuaZip* zip, const QString& relatePath, const
 	QuaZipFile zipFile(zip);
 	QuaZipNewInfo zipInfo(relatePath, localFilePath);  // 使用本地文件信息设置zip条目属性
 
-    if (!zipFile.open(QIODevice::WriteOnly, zipInfo, PrivateData::s_password, 0, Z_DEFLATED, PrivateData::s_zip_compress_level)) {
+    if (!zipFile.open(QIODevice::WriteOnly, zipInfo, PrivateData::s_password, 0, PrivateData::compressMethod(), PrivateData::s_zip_compress_level)) {
 		localFile.close();
 		return false;
 	}
@@ -953,6 +950,61 @@ bool DAZipArchive::writeFileToZip(QuaZip* zip, const QString& relatePath, const
 	return success;
 }
 
+/**
+ * @brief 把一个zip中的条目原样复制到另外一个zip中
+ *
+ * 以raw模式读取和写入，压缩后的字节直接复制，不经过解压和重新压缩，条目的crc、大小、时间等信息保持不变，
+ * 工程增量保存时，未改变的条目通过此函数从上一次的档案中复制
+ *
+ * @param[in] sourceZip 源zip，需要以QuaZip::mdUnzip模式打开
+ * @param[in] destZip 目标zip，需要以QuaZip::mdCreate或QuaZip::mdAdd模式打开
+ * @param[in] relatePath 条目在zip中的相对路径
+ * @param[in] chunk_mb 分块大小，默认为4mb
+ * @return 成功返回true
+ */
+bool DAZipArchive::copyRawEntry(QuaZip* sourceZip, QuaZip* destZip, const QString& relatePath, std::size_t chunk_mb)
+{
+	if (!sourceZip || !destZip || relatePath.isEmpty() || chunk_mb == 0) {
+		return false;
+	}
+	if (!sourceZip->setCurrentFile(relatePath)) {
+		return false;
+	}
+	QuaZipFileInfo64 info;
+	if (!sourceZip->getCurrentFileInfo(&info)) {
+		return false;
+	}
+	QuaZipFile inFile(sourceZip);
+	int method = 0;
+	int level  = 0;
+	if (!inFile.open(QIODevice::ReadOnly, &method, &level, true)) {
+		return false;
+	}
+	QuaZipFile outFile(destZip);
+	// raw模式下crc和未压缩大小直接沿用源条目的信息
+	if (!outFile.open(QIODevice::WriteOnly, QuaZipNewInfo(info), nullptr, info.crc, method, level, true)) {
+		inFile.close();
+		return false;
+	}
+	const qint64 chunkSize = static_cast< qint64 >(chunk_mb) * 1024 * 1024;
+	QByteArray buffer(chunkSize, Qt::Uninitialized);
+	bool success = true;
+	while (!inFile.atEnd()) {
+		qint64 bytesRead = inFile.read(buffer.data(), chunkSize);
+		if (bytesRead < 0) {
+			success = false;
+			break;
+		}
+		if (outFile.write(buffer.constData(), bytesRead) != bytesRead) {
+			success = false;
+			break;
+		}
+	}
+	inFile.close();
+	outFile.close();
+	return success && (outFile.getZipError() == ZIP_OK);
+}
+
 /**
  * @brief 从 ZIP 归档中提取指定文件到本地路径
  *
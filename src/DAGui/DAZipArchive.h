@@ -32,6 +32,8 @@ public:
 	bool write(const QString& relatePath, const QByteArray& byte) override;
 	// 将本地文件写入ZIP压缩包中的指定路径
 	bool writeFileToZip(const QString& relatePath, const QString& localFilePath, std::size_t chunk_mb = 4);
+	// 把另外一个zip中的条目原样（不解压不重新压缩）复制到本压缩包中
+	bool copyRawEntryFrom(QuaZip* sourceZip, const QString& relatePath, std::size_t chunk_mb = 4);
 	// 读取数据
 	QByteArray read(const QString& relatePath) override;
 	// 从 ZIP 归档中提取指定文件到本地路径
@@ -89,6 +91,7 @@ public:
 	static bool compressDirectory(const QString& folderPath, QuaZip* zip, const QString& relativeBase = QString("./"));
 	static bool writeFileToZip(QuaZip* zip, const QString& relatePath, const QString& localFilePath, std::size_t chunk_mb = 4);
 	static bool readToFile(QuaZip* zip, const QString& zipRelatePath, const QString& localFilePath, std::size_t chunk_mb = 4);
+	static bool copyRawEntry(QuaZip* sourceZip, QuaZip* destZip, const QString& relatePath, std::size_t chunk_mb = 4);
 };
 }
 
@@ -0,0 +1,59 @@
+﻿#include "DAZipArchiveTask_CopyEntry.h"
+#include "DAZipArchive.h"
+#include <QDebug>
+#include "quazip/quazip.h"
+namespace DA
+{
+DAZipArchiveTask_CopyEntry::DAZipArchiveTask_CopyEntry(const QString& sourceArchivePath, const QStringList& entries)
+    : DAAbstractArchiveTask(), mSourceArchivePath(sourceArchivePath), mEntries(entries)
+{
+}
+
+DAZipArchiveTask_CopyEntry::~DAZipArchiveTask_CopyEntry()
+{
+}
+
+QString DAZipArchiveTask_CopyEntry::getSourceArchivePath() const
+{
+	return mSourceArchivePath;
+}
+
+QStringList DAZipArchiveTask_CopyEntry::getEntries() const
+{
+	return mEntries;
+}
+
+bool DAZipArchiveTask_CopyEntry::exec(DAAbstractArchive* archive, DAAbstractArchiveTask::Mode mode)
+{
+	if (!archive) {
+		return false;
+	}
+	if (mode != DAAbstractArchiveTask::WriteMode) {
+		// 只支持写模式
+		return false;
+	}
+	DAZipArchive* zip = static_cast< DAZipArchive* >(archive);
+	if (!zip->isOpened()) {
+		if (!zip->create()) {
+			qDebug() << QString("create archive error:%1").arg(zip->getBaseFilePath());
+			return false;
+		}
+	}
+	QuaZip source(mSourceArchivePath);
+	if (!source.open(QuaZip::mdUnzip)) {
+		qDebug() << QString("open archive error:%1").arg(mSourceArchivePath);
+		return false;
+	}
+	bool success = true;
+	for (const QString& entry : qAsConst(mEntries)) {
+		if (!zip->copyRawEntryFrom(&source, entry)) {
+			qDebug() << QString("Unable to copy %1 from %2").arg(entry, mSourceArchivePath);  // cn:无法从%2复制%1
+			success = false;
+			break;
+		}
+	}
+	source.close();
+	return success;
+}
+
+}  // end DA
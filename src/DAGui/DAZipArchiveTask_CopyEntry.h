@@ -0,0 +1,33 @@
+﻿#ifndef DAZIPARCHIVETASK_COPYENTRY_H
+#define DAZIPARCHIVETASK_COPYENTRY_H
+#include "DAGuiAPI.h"
+#include "DAAbstractArchiveTask.h"
+#include <QString>
+#include <QStringList>
+namespace DA
+{
+/**
+ * @brief 从另外一个zip档案原样复制条目的任务，只支持写模式
+ *
+ * 工程增量保存时，没有变化的条目不需要重新序列化，直接从上一次保存的档案中以raw方式复制，
+ * 不经过解压和重新压缩
+ */
+class DAGUI_API DAZipArchiveTask_CopyEntry : public DAAbstractArchiveTask
+{
+public:
+	DAZipArchiveTask_CopyEntry(const QString& sourceArchivePath, const QStringList& entries);
+	virtual ~DAZipArchiveTask_CopyEntry();
+	// 源档案路径
+	QString getSourceArchivePath() const;
+	// 要复制的条目
+	QStringList getEntries() const;
+	//
+	virtual bool exec(DAAbstractArchive* archive, DAAbstractArchiveTask::Mode mode) override;
+
+private:
+	QString mSourceArchivePath;
+	QStringList mEntries;
+};
+}
+
+#endif  // DAZIPARCHIVETASK_COPYENTRY_H
@@ -6,6 +6,7 @@
 #include "DAZipArchiveTask_Xml.h"
 #include "DAZipArchiveTask_ArchiveFile.h"
 #include "DAZipArchiveTask_ChartItem.h"
+#include "DAZipArchiveTask_CopyEntry.h"
 namespace DA
 {
 class DAZipArchiveThreadWrapper::PrivateData
@@ -105,6 +106,15 @@ bool DAZipArchiveThreadWrapper::appendChartItemSaveTask(const QString& zipRelate
 	return true;
 }
 
+bool DAZipArchiveThreadWrapper::appendEntryCopyTask(const QString& sourceArchivePath, const QStringList& entries)
+{
+	if (isBusy()) {
+		return false;
+	}
+	d_ptr->mArchive->appendTask(std::make_shared< DAZipArchiveTask_CopyEntry >(sourceArchivePath, entries));
+	return true;
+}
+
 bool DAZipArchiveThreadWrapper::appendByteLoadTask(const QString& zipRelatePath, int code)
 {
 	if (isBusy()) {
@@ -26,6 +26,8 @@ public:
 	bool appendXmlSaveTask(const QString& zipRelatePath, const QDomDocument& data);
 	bool appendFileSaveTask(const QString& zipRelatePath, const QString& localFilePath);
 	bool appendChartItemSaveTask(const QString& zipRelateFolderPath, DAChartItemsManager chartItemMgr);
+	// 从另外一个档案原样复制条目
+	bool appendEntryCopyTask(const QString& sourceArchivePath, const QStringList& entries);
 	// 读取任务
 	bool appendByteLoadTask(const QString& zipRelatePath, int code);
 	bool appendXmlLoadTask(const QString& zipRelatePath, int code);
@@ -0,0 +1,210 @@
+﻿#include "DADialogWorkFlowSweep.h"
+#include "ui_DADialogWorkFlowSweep.h"
+#include <QMessageBox>
+#include <QThread>
+#include "DAWorkFlow.h"
+#include "DAXmlHelper.h"
+#include "Models/DAVariantTableModel.h"
+#if DA_ENABLE_PYTHON
+#include "DAPybind11InQt.h"
+#endif
+//===================================================
+// using DA namespace -- 禁止在头文件using!!
+//===================================================
+
+using namespace DA;
+
+//===================================================
+// DADialogWorkFlowSweep
+//===================================================
+DADialogWorkFlowSweep::DADialogWorkFlowSweep(DAWorkFlow* wf, QWidget* parent) : QDialog(parent), ui(new Ui::DADialogWorkFlowSweep)
+{
+	ui->setupUi(this);
+	mSweep = new DAWorkFlowSweep(wf, this);
+	mSweep->setVersionNumber(DAXmlHelper::getCurrentVersionNumber());
+	if (wf) {
+		mNodes = wf->nodes();
+	}
+	for (const DAAbstractNode::SharedPointer& n : qAsConst(mNodes)) {
+		ui->comboBoxParamNode->addItem(n->getIcon(), n->getNodeName());
+		ui->comboBoxOutputNode->addItem(n->getIcon(), n->getNodeName());
+	}
+	ui->spinBoxThreads->setValue(QThread::idealThreadCount());
+	mResultModel = new DAVariantTableModel(&mResult, this);
+	ui->tableViewResult->setModel(mResultModel);
+
+	connect(ui->comboBoxParamNode, QOverload< int >::of(&QComboBox::currentIndexChanged), this, &DADialogWorkFlowSweep::onParamNodeChanged);
+	connect(ui->comboBoxOutputNode, QOverload< int >::of(&QComboBox::currentIndexChanged), this, &DADialogWorkFlowSweep::onOutputNodeChanged);
+	connect(ui->pushButtonAddParam, &QPushButton::clicked, this, &DADialogWorkFlowSweep::onAddParamClicked);
+	connect(ui->pushButtonRemoveParam, &QPushButton::clicked, this, &DADialogWorkFlowSweep::onRemoveParamClicked);
+	connect(ui->pushButtonAddOutput, &QPushButton::clicked, this, &DADialogWorkFlowSweep::onAddOutputClicked);
+	connect(ui->pushButtonRemoveOutput, &QPushButton::clicked, this, &DADialogWorkFlowSweep::onRemoveOutputClicked);
+	connect(ui->pushButtonRun, &QPushButton::clicked, this, &DADialogWorkFlowSweep::onRunClicked);
+	connect(ui->pushButtonStop, &QPushButton::clicked, mSweep, &DAWorkFlowSweep::terminate);
+	// 进度在线程池的线程中发射
+	connect(mSweep, &DAWorkFlowSweep::progress, this, &DADialogWorkFlowSweep::onSweepProgress, Qt::QueuedConnection);
+	connect(mSweep, &DAWorkFlowSweep::finished, this, &DADialogWorkFlowSweep::onSweepFinished);
+	onParamNodeChanged(ui->comboBoxParamNode->currentIndex());
+	onOutputNodeChanged(ui->comboBoxOutputNode->currentIndex());
+	updateVariantCount();
+}
+
+DADialogWorkFlowSweep::~DADialogWorkFlowSweep()
+{
+	if (mSweep->isRunning()) {
+		// 扫描中的python节点需要GIL，等待期间释放
+		mSweep->terminate();
+#if DA_ENABLE_PYTHON
+		pybind11::gil_scoped_release release;
+#endif
+		mSweep->wait();
+	}
+	delete ui;
+}
+
+/**
+ * @brief 默认选中的节点，通常为场景中选中的节点
+ * @param n
+ */
+void DADialogWorkFlowSweep::setCurrentNode(const DAAbstractNode::SharedPointer& n)
+{
+	const int i = mNodes.indexOf(n);
+	if (i >= 0) {
+		ui->comboBoxParamNode->setCurrentIndex(i);
+	}
+}
+
+DAWorkFlowSweep* DADialogWorkFlowSweep::getSweep() const
+{
+	return mSweep;
+}
+
+DAAbstractNode::SharedPointer DADialogWorkFlowSweep::nodeAt(int index) const
+{
+	return mNodes.value(index);
+}
+
+void DADialogWorkFlowSweep::onParamNodeChanged(int index)
+{
+	ui->comboBoxParamKey->clear();
+	if (DAAbstractNode::SharedPointer n = nodeAt(index)) {
+		ui->comboBoxParamKey->addItems(n->getPropertyKeys());
+	}
+}
+
+void DADialogWorkFlowSweep::onOutputNodeChanged(int index)
+{
+	ui->comboBoxOutputKey->clear();
+	if (DAAbstractNode::SharedPointer n = nodeAt(index)) {
+		ui->comboBoxOutputKey->addItems(n->getOutputKeys());
+	}
+}
+
+void DADialogWorkFlowSweep::onAddParamClicked()
+{
+	DAWorkFlowSweep::Parameter p;
+	p.node        = nodeAt(ui->comboBoxParamNode->currentIndex());
+	p.propertyKey = ui->comboBoxParamKey->currentText().trimmed();
+	p.values      = DAWorkFlowSweep::parseValues(ui->lineEditParamValues->text());
+	if (!p.node || p.propertyKey.isEmpty() || p.values.isEmpty()) {
+		QMessageBox::warning(this, tr("warning"), tr("please select a node property and input valid values"));  // cn:请选择节点属性并输入有效的取值
+		return;
+	}
+	mParams.append(p);
+	const int r = ui->tableWidgetParams->rowCount();
+	ui->tableWidgetParams->insertRow(r);
+	ui->tableWidgetParams->setItem(r, 0, new QTableWidgetItem(p.name()));
+	ui->tableWidgetParams->setItem(r, 1, new QTableWidgetItem(ui->lineEditParamValues->text()));
+	ui->tableWidgetParams->setItem(r, 2, new QTableWidgetItem(QString::number(p.values.size())));
+	updateVariantCount();
+}
+
+void DADialogWorkFlowSweep::onRemoveParamClicked()
+{
+	const int r = ui->tableWidgetParams->currentRow();
+	if (r < 0 || r >= mParams.size()) {
+		return;
+	}
+	mParams.removeAt(r);
+	ui->tableWidgetParams->removeRow(r);
+	updateVariantCount();
+}
+
+void DADialogWorkFlowSweep::onAddOutputClicked()
+{
+	DAWorkFlowSweep::Output o;
+	o.node      = nodeAt(ui->comboBoxOutputNode->currentIndex());
+	o.outputKey = ui->comboBoxOutputKey->currentText();
+	if (!o.node || o.outputKey.isEmpty()) {
+		return;
+	}
+	mOutputs.append(o);
+	ui->listWidgetOutputs->addItem(o.name());
+}
+
+void DADialogWorkFlowSweep::onRemoveOutputClicked()
+{
+	const int r = ui->listWidgetOutputs->currentRow();
+	if (r < 0 || r >= mOutputs.size()) {
+		return;
+	}
+	mOutputs.removeAt(r);
+	delete ui->listWidgetOutputs->takeItem(r);
+}
+
+void DADialogWorkFlowSweep::onRunClicked()
+{
+	mSweep->clearParameters();
+	mSweep->clearOutputs();
+	for (const DAWorkFlowSweep::Parameter& p : qAsConst(mParams)) {
+		mSweep->addParameter(p);
+	}
+	for (const DAWorkFlowSweep::Output& o : qAsConst(mOutputs)) {
+		mSweep->addOutput(o);
+	}
+	mSweep->setMaxThreadCount(ui->spinBoxThreads->value());
+	mResultModel->clearTable();
+	ui->progressBar->setRange(0, mSweep->getVariantCount());
+	ui->progressBar->setValue(0);
+	if (!mSweep->exec()) {
+		QMessageBox::warning(this, tr("warning"), mSweep->getLastErrorString());
+		return;
+	}
+	ui->labelInfo->setText(tr("%1 shared nodes,%2 nodes per variant").arg(mSweep->getSharedNodeCount()).arg(mSweep->getVariantNodeCount()));  // cn:%1个公共节点，每个变体%2个节点
+	setRunning(true);
+}
+
+void DADialogWorkFlowSweep::onSweepProgress(int finishedCount, int totalCount)
+{
+	ui->progressBar->setRange(0, totalCount);
+	ui->progressBar->setValue(finishedCount);
+}
+
+void DADialogWorkFlowSweep::onSweepFinished(bool success)
+{
+	setRunning(false);
+	if (!success) {
+		const QString err = mSweep->getLastErrorString();
+		QMessageBox::warning(this, tr("warning"), err.isEmpty() ? tr("sweep is terminated") : err);  // cn:扫描已终止
+		return;
+	}
+	mResult = mSweep->getResultTable();
+	mResultModel->setHeader(mSweep->getResultColumnNames());
+	mResultModel->update();
+	ui->tableViewResult->resizeColumnsToContents();
+}
+
+void DADialogWorkFlowSweep::updateVariantCount()
+{
+	int c = mParams.isEmpty() ? 0 : 1;
+	for (const DAWorkFlowSweep::Parameter& p : qAsConst(mParams)) {
+		c *= p.values.size();
+	}
+	ui->labelInfo->setText(tr("%1 variants").arg(c));  // cn:%1个变体
+}
+
+void DADialogWorkFlowSweep::setRunning(bool on)
+{
+	ui->pushButtonRun->setEnabled(!on);
+	ui->pushButtonStop->setEnabled(on);
+}
@@ -0,0 +1,56 @@
+﻿#ifndef DADIALOGWORKFLOWSWEEP_H
+#define DADIALOGWORKFLOWSWEEP_H
+#include <QDialog>
+#include "DAGuiAPI.h"
+#include "DAWorkFlowSweep.h"
+namespace Ui
+{
+class DADialogWorkFlowSweep;
+}
+namespace DA
+{
+class DAWorkFlow;
+class DAVariantTableModel;
+/**
+ * @brief 工作流参数扫描对话框
+ *
+ * 选择若干节点属性及其取值，选择需要对比的节点输出，执行后在表格中显示每个变体的输出
+ */
+class DAGUI_API DADialogWorkFlowSweep : public QDialog
+{
+	Q_OBJECT
+public:
+	DADialogWorkFlowSweep(DAWorkFlow* wf, QWidget* parent = nullptr);
+	~DADialogWorkFlowSweep();
+	// 默认选中的节点
+	void setCurrentNode(const DAAbstractNode::SharedPointer& n);
+	// 扫描对象
+	DAWorkFlowSweep* getSweep() const;
+
+private slots:
+	void onParamNodeChanged(int index);
+	void onOutputNodeChanged(int index);
+	void onAddParamClicked();
+	void onRemoveParamClicked();
+	void onAddOutputClicked();
+	void onRemoveOutputClicked();
+	void onRunClicked();
+	void onSweepProgress(int finishedCount, int totalCount);
+	void onSweepFinished(bool success);
+
+private:
+	DAAbstractNode::SharedPointer nodeAt(int index) const;
+	void updateVariantCount();
+	void setRunning(bool on);
+
+private:
+	Ui::DADialogWorkFlowSweep* ui;
+	DAWorkFlowSweep* mSweep { nullptr };
+	QList< DAAbstractNode::SharedPointer > mNodes;
+	QList< DAWorkFlowSweep::Parameter > mParams;
+	QList< DAWorkFlowSweep::Output > mOutputs;
+	DATable< QVariant > mResult;
+	DAVariantTableModel* mResultModel { nullptr };
+};
+}  // end of namespace DA
+#endif  // DADIALOGWORKFLOWSWEEP_H
@@ -0,0 +1,109 @@
+#include "DAColumnarTableModel.h"
+namespace DA
+{
+class DAColumnarTableModel::PrivateData
+{
+public:
+	DA_DECLARE_PUBLIC(DAColumnarTableModel)
+public:
+	PrivateData(DAColumnarTableModel* p);
+
+public:
+	DAColumnarTable mTable;
+};
+
+DAColumnarTableModel::PrivateData::PrivateData(DAColumnarTableModel* p) : q_ptr(p)
+{
+}
+
+//----------------------------------------------------
+// DAColumnarTableModel
+//----------------------------------------------------
+DAColumnarTableModel::DAColumnarTableModel(QObject* p) : QAbstractTableModel(p), DA_PIMPL_CONSTRUCT
+{
+}
+
+DAColumnarTableModel::~DAColumnarTableModel()
+{
+}
+
+QVariant DAColumnarTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (role != Qt::DisplayRole) {
+		return QVariant();
+	}
+	if (Qt::Horizontal == orientation) {
+		if (section < d_ptr->mTable.columnCount()) {
+			return d_ptr->mTable.column(section)->name();
+		}
+		return QVariant();
+	}
+	return section + 1;
+}
+
+int DAColumnarTableModel::columnCount(const QModelIndex& parent) const
+{
+	Q_UNUSED(parent);
+	return d_ptr->mTable.columnCount();
+}
+
+int DAColumnarTableModel::rowCount(const QModelIndex& parent) const
+{
+	Q_UNUSED(parent);
+	return d_ptr->mTable.rowCount();
+}
+
+QVariant DAColumnarTableModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid()) {
+		return QVariant();
+	}
+	if (index.row() >= d_ptr->mTable.rowCount() || index.column() >= d_ptr->mTable.columnCount()) {
+		return QVariant();
+	}
+	switch (role) {
+	case Qt::TextAlignmentRole:
+		return int(Qt::AlignLeft | Qt::AlignVCenter);
+	case Qt::DisplayRole:
+		return d_ptr->mTable.value(index.row(), index.column());
+	default:
+		break;
+	}
+	return QVariant();
+}
+
+Qt::ItemFlags DAColumnarTableModel::flags(const QModelIndex& index) const
+{
+	if (!index.isValid()) {
+		return Qt::NoItemFlags;
+	}
+	return Qt::ItemIsSelectable | Qt::ItemIsEnabled;
+}
+
+/**
+ * @brief 设置表格
+ * @param t
+ */
+void DAColumnarTableModel::setTable(const DAColumnarTable& t)
+{
+	beginResetModel();
+	d_ptr->mTable = t;
+	endResetModel();
+}
+
+const DAColumnarTable& DAColumnarTableModel::getTable() const
+{
+	return d_ptr->mTable;
+}
+
+/**
+ * @brief 清空表格
+ */
+void DAColumnarTableModel::clearTable()
+{
+	beginResetModel();
+	d_ptr->mTable.clear();
+	endResetModel();
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef DACOLUMNARTABLEMODEL_H
+#define DACOLUMNARTABLEMODEL_H
+#include "DAGuiAPI.h"
+#include "DAColumnarTable.hpp"
+#include <QAbstractTableModel>
+namespace DA
+{
+/**
+ * @brief 对DAColumnarTable显示的model，只读
+ *
+ * 表头为列名，null显示为空
+ */
+class DAGUI_API DAColumnarTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+	DA_DECLARE_PRIVATE(DAColumnarTableModel)
+public:
+	DAColumnarTableModel(QObject* p = nullptr);
+	~DAColumnarTableModel();
+	QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+	int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+	int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+	// 设置table，表的列是共享的，复制很廉价
+	void setTable(const DAColumnarTable& t);
+	const DAColumnarTable& getTable() const;
+	// 清空表格
+	void clearTable();
+};
+}
+
+#endif  // DACOLUMNARTABLEMODEL_H
@@ -247,6 +247,7 @@ void DADataManagerTreeModel::doExpandOneDataframeToSeries(DADataManagerTreeItem*
 	if (on) {
 #if DA_ENABLE_PYTHON
 		// 需要添加
+		pybind11::gil_scoped_acquire gil;
         DAData d = dfItem->toData();
         if (!d.isDataFrame()) {
             return;
@@ -558,6 +559,7 @@ QVariant DADataManagerTreeModel::data(const QModelIndex& index, int role) const
 #if DA_ENABLE_PYTHON
 		if (d.isDataFrame()) {
 			//            qDebug() << ti->text() << " is df";
+			pybind11::gil_scoped_acquire gil;
 			DAPyDataFrame df = d.toDataFrame();
 			auto shape       = df.shape();
 			//            qDebug() << QString("[%1,%2]").arg(shape.first).arg(shape.second);
@@ -2,7 +2,10 @@
 #include "Commands/DACommandsDataFrame.h"
 #include <QUndoStack>
 #include <algorithm>
+#include <limits>
+#include <memory>
 #include <QCache>
+#include <QTimer>
 #ifndef DAPYDATAFRAMETABLEMODULE_PROFILE_PRINT
 #define DAPYDATAFRAMETABLEMODULE_PROFILE_PRINT 1
 #endif
@@ -31,6 +34,17 @@ namespace DA
 class DAPyDataFrameTableModel::PrivateData
 {
 	DA_DECLARE_PUBLIC(DAPyDataFrameTableModel)
+public:
+	/**
+	 * @brief 数据块缓存，一个数据块包含tileRowSize行tileColumnSize列的数据
+	 */
+	struct CacheTile
+	{
+		QVector< QVariant > values;  ///< 按行优先排列的数据
+		int rowCount { 0 };
+		int columnCount { 0 };
+	};
+
 public:
 	PrivateData(DAPyDataFrameTableModel* p);
 	// 根据是否使用缓存来获取对应数据
@@ -40,6 +54,17 @@ public:
 	QString getDataframeColumnName(int i) const;
 	QVariant getDataframeIndexName(int i) const;
 	void clearCacheData();
+	// 单元格数据，通过数据块缓存获取
+	QVariant getCellData(int r, int c) const;
+	// 获取数据块，如果没有缓存会从dataframe中一次性读取
+	const CacheTile* fetchTile(int tileRow, int tileColumn) const;
+	// 预取数据块
+	void prefetchTile(int tileRow, int tileColumn) const;
+	// 让覆盖了指定范围的数据块失效，rowEnd/colEnd为-1代表直到末尾
+	void invalidateTiles(int rowStart, int rowEnd, int colStart, int colEnd);
+	static quint64 tileKey(int tileRow, int tileColumn);
+	// 获取GIL，冻结期间不访问dataframe，不获取
+	std::unique_ptr< pybind11::gil_scoped_acquire > acquireGIL() const;
 
 public:
 	DAPyDataFrame dataframe;
@@ -61,6 +86,12 @@ public:
 	int currentPage{ 0 };          // 当前页码
 								   // 滑动窗需要的参数
 	bool useCacheMode{ false };  ///< 是否使用缓存，使用缓存模式，在设置dataframe时，会把dataframe的关键数据直接缓存到内存
+	bool frozen{ false };        ///< 冻结，冻结期间不访问dataframe，只显示缓存的内容
+	// 数据块缓存
+	int tileRowSize{ 128 };                              ///< 数据块的行数
+	int tileColumnSize{ 32 };                            ///< 数据块的列数
+	mutable QCache< quint64, CacheTile > tileCache{ 64 };  ///< 数据块缓存，cost为数据块数量
+	mutable int lastTileRow{ -1 };                       ///< 最后访问的数据块行，用于判断滚动方向
 };
 
 //===================================================
@@ -78,7 +109,7 @@ bool DAPyDataFrameTableModel::PrivateData::isNoneDataframe() const
 
 int DAPyDataFrameTableModel::PrivateData::getDataframeRowCount() const
 {
-	if (useCacheMode) {
+	if (useCacheMode || frozen) {
 		return dataframeRow;
 	}
 	return static_cast< int >(dataframe.shape().first);
@@ -86,7 +117,7 @@ int DAPyDataFrameTableModel::PrivateData::getDataframeRowCount() const
 
 int DAPyDataFrameTableModel::PrivateData::getDataframeColumnCount() const
 {
-	if (useCacheMode) {
+	if (useCacheMode || frozen) {
 		return dataframeColumn;
 	}
 	return static_cast< int >(dataframe.shape().second);
@@ -94,8 +125,8 @@ int DAPyDataFrameTableModel::PrivateData::getDataframeColumnCount() const
 
 QString DAPyDataFrameTableModel::PrivateData::getDataframeColumnName(int i) const
 {
-	if (useCacheMode) {
-		return columnsName[ i ];
+	if (useCacheMode || frozen) {
+		return columnsName.value(i);
 	} else {
 		return dataframe.columnName(i);
 	}
@@ -104,6 +135,10 @@ QString DAPyDataFrameTableModel::PrivateData::getDataframeColumnName(int i) cons
 QVariant DAPyDataFrameTableModel::PrivateData::getDataframeIndexName(int i) const
 {
 	QVariant res;
+	if (frozen) {
+		// 冻结期间索引可能正在被修改，显示序号
+		return i;
+	}
 	try {
 		if (dataframe.isNone()) {
 			// 如果索引为空，就显示序号
@@ -137,6 +172,135 @@ void DAPyDataFrameTableModel::PrivateData::clearCacheData()
 	columnsName.clear();
 }
 
+/**
+ * @brief 获取单元格数据
+ *
+ * 单元格数据从数据块缓存中获取，数据块不存在时会通过@ref DAPyDataFrame::ilocBlock 一次性读取整个数据块，
+ * 访问到新的数据块行时，会沿滚动方向预取下一个数据块
+ * @param r 实际行
+ * @param c 实际列
+ * @return
+ */
+QVariant DAPyDataFrameTableModel::PrivateData::getCellData(int r, int c) const
+{
+	const int tr          = r / tileRowSize;
+	const int tc          = c / tileColumnSize;
+	const CacheTile* tile = fetchTile(tr, tc);
+	if (!tile) {
+		return frozen ? QVariant() : dataframe.iat(r, c);
+	}
+	const int lr = r - tr * tileRowSize;
+	const int lc = c - tc * tileColumnSize;
+	if (lr >= tile->rowCount || lc >= tile->columnCount) {
+		return frozen ? QVariant() : dataframe.iat(r, c);
+	}
+	QVariant res = tile->values[ lr * tile->columnCount + lc ];
+	if (!frozen && tr != lastTileRow) {
+		// 沿滚动方向预取
+		const int nextTileRow = (tr > lastTileRow) ? tr + 1 : tr - 1;
+		lastTileRow           = tr;
+		prefetchTile(nextTileRow, tc);
+	}
+	return res;
+}
+
+/**
+ * @brief 获取数据块
+ * @param tileRow
+ * @param tileColumn
+ * @return 如果超出范围或读取失败返回nullptr
+ * @note 返回的指针在下一次插入缓存前有效
+ */
+const DAPyDataFrameTableModel::PrivateData::CacheTile* DAPyDataFrameTableModel::PrivateData::fetchTile(int tileRow,
+                                                                                                         int tileColumn) const
+{
+	const quint64 key = tileKey(tileRow, tileColumn);
+	if (CacheTile* t = tileCache.object(key)) {
+		return t;
+	}
+	if (frozen) {
+		return nullptr;
+	}
+	const int r0 = tileRow * tileRowSize;
+	const int c0 = tileColumn * tileColumnSize;
+	const int r1 = qMin(r0 + tileRowSize, getDataframeRowCount());
+	const int c1 = qMin(c0 + tileColumnSize, getDataframeColumnCount());
+	if (r0 < 0 || c0 < 0 || r0 >= r1 || c0 >= c1) {
+		return nullptr;
+	}
+	std::unique_ptr< CacheTile > t(new CacheTile());
+	t->values      = dataframe.ilocBlock(r0, r1, c0, c1);
+	t->rowCount    = r1 - r0;
+	t->columnCount = c1 - c0;
+	if (t->values.size() != t->rowCount * t->columnCount) {
+		return nullptr;
+	}
+	CacheTile* res = t.get();
+	tileCache.insert(key, t.release());
+	return res;
+}
+
+/**
+ * @brief 预取数据块
+ *
+ * 预取在事件循环中进行，不阻塞当前的绘制
+ * @param tileRow
+ * @param tileColumn
+ */
+void DAPyDataFrameTableModel::PrivateData::prefetchTile(int tileRow, int tileColumn) const
+{
+	if (tileRow < 0 || tileRow * tileRowSize >= getDataframeRowCount()) {
+		return;
+	}
+	if (tileCache.contains(tileKey(tileRow, tileColumn))) {
+		return;
+	}
+	const PrivateData* d = this;
+	QTimer::singleShot(0, q_ptr, [ d, tileRow, tileColumn ]() {
+		if (d->frozen) {
+			return;
+		}
+		pybind11::gil_scoped_acquire gil;
+		d->fetchTile(tileRow, tileColumn);
+	});
+}
+
+/**
+ * @brief 让覆盖了指定范围的数据块失效
+ * @param rowStart
+ * @param rowEnd -1代表直到末尾
+ * @param colStart
+ * @param colEnd -1代表直到末尾
+ */
+void DAPyDataFrameTableModel::PrivateData::invalidateTiles(int rowStart, int rowEnd, int colStart, int colEnd)
+{
+	const int trs = rowStart / tileRowSize;
+	const int tre = (rowEnd < 0) ? std::numeric_limits< int >::max() : rowEnd / tileRowSize;
+	const int tcs = colStart / tileColumnSize;
+	const int tce = (colEnd < 0) ? std::numeric_limits< int >::max() : colEnd / tileColumnSize;
+	const QList< quint64 > keys = tileCache.keys();
+	for (quint64 k : keys) {
+		const int tr = static_cast< int >(k >> 32);
+		const int tc = static_cast< int >(k & 0xFFFFFFFF);
+		if (tr >= trs && tr <= tre && tc >= tcs && tc <= tce) {
+			tileCache.remove(k);
+		}
+	}
+}
+
+quint64 DAPyDataFrameTableModel::PrivateData::tileKey(int tileRow, int tileColumn)
+{
+	return (static_cast< quint64 >(static_cast< quint32 >(tileRow)) << 32) | static_cast< quint32 >(tileColumn);
+}
+
+std::unique_ptr< pybind11::gil_scoped_acquire > DAPyDataFrameTableModel::PrivateData::acquireGIL() const
+{
+	if (frozen) {
+		return nullptr;
+	}
+	return std::unique_ptr< pybind11::gil_scoped_acquire >(new pybind11::gil_scoped_acquire());
+}
+
 //===================================================
 // DAPyDataFrameTableModule
 //===================================================
@@ -158,7 +322,11 @@ DAPyDataFrameTableModel::~DAPyDataFrameTableModel()
 QVariant DAPyDataFrameTableModel::actualHeaderData(int actualSection, Qt::Orientation orientation, int role) const
 {
 	DA_DC(d);
-	if ((role != Qt::DisplayRole && role != Qt::ToolTipRole) || d->isNoneDataframe()) {
+	if (role != Qt::DisplayRole && role != Qt::ToolTipRole) {
+		return QAbstractTableModel::headerData(actualSection, orientation, role);
+	}
+	auto gil = d->acquireGIL();
+	if (d->isNoneDataframe()) {
 		return QAbstractTableModel::headerData(actualSection, orientation, role);
 	}
 	// tooltips 和 display
@@ -181,6 +349,7 @@ int DAPyDataFrameTableModel::columnCount(const QModelIndex& parent) const
 {
 	Q_UNUSED(parent);
 	DA_DC(d);
+	auto gil = d->acquireGIL();
 	if (d->isNoneDataframe()) {
 		return d->minShowColumn;
 	}
@@ -190,6 +359,7 @@ int DAPyDataFrameTableModel::columnCount(const QModelIndex& parent) const
 int DAPyDataFrameTableModel::actualRowCount() const
 {
 	DA_DC(d);
+	auto gil = d->acquireGIL();
 	if (d->isNoneDataframe()) {
 		return d->minShowRow;
 	}
@@ -199,6 +369,10 @@ int DAPyDataFrameTableModel::actualRowCount() const
 QVariant DAPyDataFrameTableModel::actualData(int actualRow, int actualColumn, int role) const
 {
 	DA_DC(d);
+	if (role != Qt::DisplayRole && role != Qt::TextAlignmentRole) {
+		return QVariant();
+	}
+	auto gil = d->acquireGIL();
 	if (d->isNoneDataframe()) {
 		return QVariant();
 	}
@@ -211,7 +385,7 @@ QVariant DAPyDataFrameTableModel::actualData(int actualRow, int actualColumn, in
 	case Qt::BackgroundRole:
 		return QVariant();
 	case Qt::DisplayRole: {
-		return d->dataframe.iat(actualRow, actualColumn);
+		return d->getCellData(actualRow, actualColumn);
 	}
 	default:
 		break;
@@ -226,6 +400,10 @@ bool DAPyDataFrameTableModel::setActualData(int actualRow, int actualColumn, con
 		return false;
 	}
 	DA_D(d);
+	if (d->frozen) {
+		return false;
+	}
+	pybind11::gil_scoped_acquire gil;
 	if (d->isNoneDataframe()) {
 		return false;
 	}
@@ -246,6 +424,7 @@ bool DAPyDataFrameTableModel::setActualData(int actualRow, int actualColumn, con
 	}
 	if (!(d->undoStack)) {
 		// 如果d->_undoStack设置为nullptr，将不使用redo/undo
+		d->invalidateTiles(actualRow, actualRow, actualColumn, actualColumn);
 		return d->dataframe.iat(actualRow, actualColumn, value);
 	}
 	std::unique_ptr< DACommandDataFrame_iat > cmd_iat(
@@ -272,6 +451,7 @@ const DAPyDataFrame& DAPyDataFrameTableModel::dataFrame() const
 
 void DAPyDataFrameTableModel::setDAData(const DAData& d)
 {
+	pybind11::gil_scoped_acquire gil;
 	if (!d.isDataFrame()) {
 		d_ptr->dataframe = DAPyDataFrame();
 		refreshData();
@@ -288,6 +468,7 @@ void DAPyDataFrameTableModel::setDataFrame(const DAPyDataFrame& d)
 	__elasper.start();
 	qDebug() << "setDAData begin";
 #endif
+	pybind11::gil_scoped_acquire gil;
 	d_ptr->dataframe = d;
 	refreshData();
 #if DAPYDATAFRAMETABLEMODULE_PROFILE_PRINT
@@ -295,6 +476,33 @@ void DAPyDataFrameTableModel::setDataFrame(const DAPyDataFrame& d)
 #endif
 }
 
+/**
+ * @brief 冻结模型
+ *
+ * dataframe在后台线程被修改期间，读取到的是中间状态，而且访问dataframe需要等待后台线程释放GIL，
+ * 冻结期间模型不再访问dataframe，只显示冻结前的形状和已经缓存的数据块，其余单元格为空，行表头显示序号，
+ * 不允许编辑。解除冻结后需调用@ref refreshData 显示最新的数据
+ * @param on
+ */
+void DAPyDataFrameTableModel::setFrozen(bool on)
+{
+	DA_D(d);
+	if (d->frozen == on) {
+		return;
+	}
+	if (on) {
+		// 冻结前缓存形状
+		pybind11::gil_scoped_acquire gil;
+		cacheShape();
+	}
+	d->frozen = on;
+}
+
+bool DAPyDataFrameTableModel::isFrozen() const
+{
+	return d_ptr->frozen;
+}
+
 void DAPyDataFrameTableModel::setUseCacheMode(bool on)
 {
 	d_ptr->useCacheMode = on;
@@ -308,6 +516,7 @@ void DAPyDataFrameTableModel::setUseCacheMode(bool on)
 void DAPyDataFrameTableModel::setCacheWindowStartRow(int startRow)
 {
 	DA_D(d);
+	auto gil = d->acquireGIL();
 
 	// startRow限制在指定的最小值和最大值之间。它能够确保startRow不会超出给定的范围
 	const int dr        = d->getDataframeRowCount();
@@ -321,6 +530,7 @@ void DAPyDataFrameTableModel::setCacheWindowStartRow(int startRow)
 
 void DAPyDataFrameTableModel::notifyRowChanged(int row)
 {
+	d_ptr->invalidateTiles(row, row, 0, -1);
 	if (row >= rowCount()) {
 		return;
 	}
@@ -334,6 +544,7 @@ void DAPyDataFrameTableModel::notifyRowChanged(int row)
 
 void DAPyDataFrameTableModel::notifyColumnChanged(int col)
 {
+	d_ptr->invalidateTiles(0, -1, col, col);
 	if (col >= columnCount()) {
 		return;
 	}
@@ -352,6 +563,7 @@ void DAPyDataFrameTableModel::notifyColumnChanged(int col)
  */
 void DAPyDataFrameTableModel::notifyDataChanged(int row, int col)
 {
+	d_ptr->invalidateTiles(row, row, col, col);
 	if (row >= rowCount() || col >= columnCount()) {
 		return;
 	}
@@ -360,6 +572,7 @@ void DAPyDataFrameTableModel::notifyDataChanged(int row, int col)
 
 void DAPyDataFrameTableModel::notifyDataChanged(int rowStart, int colStart, int rowEnd, int colEnd)
 {
+	d_ptr->invalidateTiles(rowStart, rowEnd, colStart, colEnd);
 	if (rowEnd >= rowCount() || colEnd >= columnCount()) {
 		return;
 	}
@@ -371,7 +584,10 @@ void DAPyDataFrameTableModel::notifyDataChanged(int rowStart, int colStart, int
  */
 void DAPyDataFrameTableModel::refreshData()
 {
+	pybind11::gil_scoped_acquire gil;
 	beginResetModel();
+	d_ptr->tileCache.clear();
+	d_ptr->lastTileRow = -1;
 	if (d_ptr->useCacheMode) {
 		cacheShape();
 	} else {
@@ -386,6 +602,7 @@ void DAPyDataFrameTableModel::refreshData()
 void DAPyDataFrameTableModel::cacheShape()
 {
 	DA_D(d);
+	pybind11::gil_scoped_acquire gil;
 	auto shape         = d->dataframe.shape();
 	d->dataframeRow    = static_cast< int >(shape.first);
 	d->dataframeColumn = static_cast< int >(shape.second);
@@ -398,6 +615,7 @@ void DAPyDataFrameTableModel::cacheShape()
 void DAPyDataFrameTableModel::cacheRowShape()
 {
 	DA_D(d);
+	pybind11::gil_scoped_acquire gil;
 	auto shape      = d->dataframe.shape();
 	d->dataframeRow = static_cast< int >(shape.first);
 }
@@ -405,6 +623,7 @@ void DAPyDataFrameTableModel::cacheRowShape()
 void DAPyDataFrameTableModel::cacheColumnShape()
 {
 	DA_D(d);
+	pybind11::gil_scoped_acquire gil;
 	auto shape         = d->dataframe.shape();
 	d->dataframeColumn = static_cast< int >(shape.second);
 	d->columnsName     = d->dataframe.columns();
@@ -423,6 +642,7 @@ void DAPyDataFrameTableModel::notifyRowsRemoved(const QList< int >& r)
 	cacheRowShape();
 	// 获取最小和最大行号
 	int minRow = *std::min_element(r.begin(), r.end());
+	d_ptr->invalidateTiles(minRow, -1, 0, -1);
 	emit dataChanged(createIndex(minRow, 0), createIndex(rowCount() - 1, columnCount() - 1));
 }
 
@@ -439,6 +659,7 @@ void DAPyDataFrameTableModel::notifyRowsInserted(const QList< int >& r)
 	cacheRowShape();
 	// 获取最小和最大行号
 	int minRow = *std::min_element(r.begin(), r.end());
+	d_ptr->invalidateTiles(minRow, -1, 0, -1);
 	emit dataChanged(createIndex(minRow, 0), createIndex(rowCount() - 1, columnCount() - 1));
 }
 
@@ -454,6 +675,7 @@ void DAPyDataFrameTableModel::notifyColumnsRemoved(const QList< int >& c)
 	// 由于使用了缓存表，删除只需要刷新数据即可
 	cacheColumnShape();
 	int minCol = *std::min_element(c.begin(), c.end());
+	d_ptr->invalidateTiles(0, -1, minCol, -1);
 	emit dataChanged(createIndex(0, minCol), createIndex(rowCount() - 1, columnCount() - 1));
 }
 
@@ -469,6 +691,7 @@ void DAPyDataFrameTableModel::notifyColumnsInserted(const QList< int >& c)
 	// 由于使用了缓存表，删除只需要刷新数据即可
 	cacheColumnShape();
 	int minCol = *std::min_element(c.begin(), c.end());
+	d_ptr->invalidateTiles(0, -1, minCol, -1);
 	emit dataChanged(createIndex(0, minCol), createIndex(rowCount() - 1, columnCount() - 1));
 }
 
@@ -44,6 +44,9 @@ public:
 	void setDataFrame(const DAPyDataFrame& d);
 	// 设置使用缓存模式，缓存模式不会频繁调用dataframe，在setdataframe时把常用的参数缓存
 	void setUseCacheMode(bool on = true);
+	// 冻结，冻结期间不访问dataframe，用于dataframe在后台被修改期间
+	void setFrozen(bool on);
+	bool isFrozen() const;
 	/// @group 滑动窗模式
 	/// @{
 	// 设置滑动窗模式的起始行
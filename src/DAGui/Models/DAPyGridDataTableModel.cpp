@@ -23,6 +23,7 @@ QVariant DAPyGridDataTableModel::actualHeaderData(int actualSection, Qt::Orienta
 		return QVariant();
 	}
 	// 剩下都是DisplayRole
+	pybind11::gil_scoped_acquire gil;
 	if (Qt::Horizontal == orientation) {  // 说明是水平表头
 		if (mXSeries.isNone()) {
 			return QVariant();
@@ -56,6 +56,7 @@ int DAPySeriesTableModel::PrivateData::columnCount() const
 
 int DAPySeriesTableModel::PrivateData::rowCount() const
 {
+	pybind11::gil_scoped_acquire gil;
 	int r = 0;
 	for (auto i = seriesMap.begin(); i != seriesMap.end(); ++i) {
 		const DAPySeries& ser = i.value();
@@ -161,6 +162,7 @@ QVariant DAPySeriesTableModel::actualHeaderData(int actualSection, Qt::Orientati
         // 如果没有，查看是否是series，series有名称，显示名称
         auto iteSer = d->seriesMap.find(actualSection);
         if (iteSer != d->seriesMap.end()) {
+            pybind11::gil_scoped_acquire gil;
             return iteSer.value().name();
         }
         return QVariant();
@@ -189,6 +191,7 @@ QVariant DAPySeriesTableModel::actualData(int actualRow, int actualColumn, int r
         auto ite = d->seriesMap.find(actualColumn);
         if (ite != d->seriesMap.end()) {
             // 说明是序列列
+            pybind11::gil_scoped_acquire gil;
             try {
                 const DAPySeries& ser = ite.value();
                 if (ser.isNone()) {
@@ -270,21 +270,23 @@ void DAVariantTableModel::setTableData(int row, int col, const QVariant& v)
 
 /**
  * @brief 获取表格数据
+ *
+ * 表格按行存储，只在这一行内查找，显示时同一行的单元格在连续内存中
  * @param row
  * @param col
  * @return
  */
 QVariant DAVariantTableModel::getTableData(int row, int col) const
 {
-	auto i = d_ptr->mData->find(row, col);
-	if (i == d_ptr->mData->end()) {
+	const QVariant* v = d_ptr->mData->cellData(row, col);
+	if (!v) {
 		return QVariant();
 	}
 	if (d_ptr->mToDisplayString) {
 		// 如果注册了显示函数指针，先调用显示函数指针
-		return d_ptr->mToDisplayString(i->second);
+		return d_ptr->mToDisplayString(*v);
 	}
-	return i->second;
+	return *v;
 }
 
 /**
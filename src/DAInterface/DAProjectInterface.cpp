@@ -23,6 +23,7 @@ public:
 
 public:
 	bool mIsDirty { false };  ///< 脏标识
+	quint64 mModifiedCount { 0 };  ///< 修改计数，每次设置为dirty都会增加
 	DADockingAreaInterface* mDockingArea { nullptr };
 	DAWorkFlowOperateWidget* mWorkFlowOperateWidget { nullptr };
 	DADataManagerInterface* mDataManagerInterface { nullptr };
@@ -161,6 +162,18 @@ bool DAProjectInterface::isDirty() const
     return d_ptr->mIsDirty;
 }
 
+/**
+ * @brief 修改计数
+ *
+ * 每次调用setModified(true)都会增加，即使工程已经是dirty，
+ * 异步保存时通过比较保存开始和结束时的计数判断保存过程中工程是否有修改
+ * @return
+ */
+quint64 DAProjectInterface::getModifiedCount() const
+{
+	return d_ptr->mModifiedCount;
+}
+
 /**
  * @brief 清空工程
  */
@@ -215,6 +228,9 @@ void DAProjectInterface::setProjectFileSuffix(const QString& f)
  */
 void DAProjectInterface::setModified(bool on)
 {
+	if (on) {
+		++(d_ptr->mModifiedCount);
+	}
 	if (on != d_ptr->mIsDirty) {
 		d_ptr->mIsDirty = on;
 		Q_EMIT dirtyStateChanged(on);
@@ -42,6 +42,8 @@ public:
 	QString getWorkingDirectory() const;
 	// 是否dirty
 	bool isDirty() const;
+	// 修改计数，每次设置为dirty都会增加
+	quint64 getModifiedCount() const;
 	// 工程文件的版本,版本组成有大版本.中间版本.小版本组成，例如0.1.1
 	static QVersionNumber getProjectVersion();
 	// 是否繁忙，正在保存文件过程中会为繁忙状态
@@ -324,6 +324,41 @@ bool DAPyDataFrame::iat(std::size_t r, std::size_t c, const pybind11::object& v)
 	return false;
 }
 
+/**
+ * @brief 一次性获取一块数据，相当于DataFrame.iloc[rowStart:rowEnd,colStart:colEnd]
+ *
+ * 相对于逐个单元格调用@ref iat ，此函数只进行一次切片，适用于表格批量显示
+ * @param rowStart 开始行
+ * @param rowEnd 结束行(不包含)
+ * @param colStart 开始列
+ * @param colEnd 结束列(不包含)
+ * @return 结果按行优先排列，尺寸为(rowEnd-rowStart)*(colEnd-colStart)，如果异常返回空
+ */
+QVector< QVariant > DAPyDataFrame::ilocBlock(std::size_t rowStart, std::size_t rowEnd, std::size_t colStart, std::size_t colEnd) const
+{
+	QVector< QVariant > res;
+	if (rowEnd <= rowStart || colEnd <= colStart) {
+		return res;
+	}
+	try {
+		pybind11::slice rowSlice(static_cast< pybind11::ssize_t >(rowStart), static_cast< pybind11::ssize_t >(rowEnd), 1);
+		pybind11::slice colSlice(static_cast< pybind11::ssize_t >(colStart), static_cast< pybind11::ssize_t >(colEnd), 1);
+		pybind11::object block = object().attr("iloc")[ pybind11::make_tuple(rowSlice, colSlice) ];
+		// itertuples按行迭代，每一行为一个tuple
+		pybind11::object rows = block.attr("itertuples")(pybind11::arg("index") = false, pybind11::arg("name") = pybind11::none());
+		res.reserve(static_cast< int >((rowEnd - rowStart) * (colEnd - colStart)));
+		for (pybind11::handle row : rows) {
+			for (pybind11::handle v : row) {
+				res.append(DA::PY::toVariant(pybind11::reinterpret_borrow< pybind11::object >(v)));
+			}
+		}
+	} catch (const std::exception& e) {
+		qCritical().noquote() << e.what();
+		res.clear();
+	}
+	return res;
+}
+
 DAPySeries DAPyDataFrame::iloc(std::size_t c) const
 {
 	try {
@@ -8,6 +8,7 @@
 #include <QVariant>
 #include <QDebug>
 #include <QList>
+#include <QVector>
 namespace DA
 {
 /**
@@ -56,6 +57,8 @@ public:
 	pybind11::object iatObj(std::size_t r, std::size_t c) const;
 	bool iat(std::size_t r, std::size_t c, const QVariant& v);
 	bool iat(std::size_t r, std::size_t c, const pybind11::object& v);
+	// DataFrame.iloc[rowStart:rowEnd,colStart:colEnd] 一次性获取一块数据，结果按行优先排列
+	QVector< QVariant > ilocBlock(std::size_t rowStart, std::size_t rowEnd, std::size_t colStart, std::size_t colEnd) const;
 	// DataFrame.loc 获取一行
 	DAPySeries iloc(std::size_t c) const;
 	DAPySeries loc(const QString& n) const;
@@ -238,6 +238,11 @@ std::vector< double > toVectorDouble(const DAPySeries& ser)
 		if (!dt.isNumeral()) {
 			return std::vector< double >();
 		}
+		auto arr = ser.toNumpyArray< double >();
+		if (arr) {
+			// 缓冲区直接拷贝
+			return std::vector< double >(arr.data(), arr.data() + arr.size());
+		}
 		std::vector< double > res;
 		res.reserve(ser.size());
 		ser.castTo< double >(std::back_insert_iterator< std::vector< double > >(res));
@@ -264,6 +269,13 @@ QVector< double > toQVectorDouble(const DAPySeries& ser)
 			return QVector< double >();
 		}
 		QVector< double > res;
+		auto arr = ser.toNumpyArray< double >();
+		if (arr) {
+			// 缓冲区直接拷贝
+			res.resize(static_cast< int >(arr.size()));
+			std::copy(arr.data(), arr.data() + arr.size(), res.begin());
+			return res;
+		}
 		res.reserve(static_cast< int >(ser.size()));
 		ser.castTo< double >(std::back_insert_iterator< QVector< double > >(res));
 		return res;
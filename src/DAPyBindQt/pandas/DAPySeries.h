@@ -5,7 +5,10 @@
 #include <QDebug>
 #include <QList>
 #include <QVariant>
+#include <type_traits>
+#include <algorithm>
 #include "DAPybind11InQt.h"
+#include "numpy/DAPyDType.h"
 namespace DA
 {
 /**
@@ -44,9 +47,26 @@ public:
 	static bool isSeries(const pybind11::object& obj);
 
 public:
+	/**
+	 * @brief 把series转换为numpy数组(Series.to_numpy)
+	 *
+	 * 如果series的dtype和T一致且内存连续，不会发生拷贝，否则会进行一次向量化的astype转换
+	 * @return 如果无法转换，返回的数组为空(operator bool为false)
+	 */
+	template< typename T >
+	pybind11::array_t< T, pybind11::array::c_style | pybind11::array::forcecast > toNumpyArray() const
+	{
+		using ArrayType = pybind11::array_t< T, pybind11::array::c_style | pybind11::array::forcecast >;
+		pybind11::object arr = object().attr("to_numpy")();
+		return ArrayType::ensure(arr);
+	}
+
 	/**
 	 * @brief 把series转换为一个容器数组
 	 *
+	 * 对于数值型的series，会通过numpy的缓冲区协议一次性拷贝，避免逐个元素的python调用，
+	 * 其它类型则逐个元素进行转换
+	 *
 	 * @code
 	 * DAPySeries x;
 	 * ...
@@ -59,6 +79,16 @@ public:
 	template< typename T, typename VectLikeIte >
 	void castTo(VectLikeIte begin) const
 	{
+		if constexpr (std::is_arithmetic< T >::value) {
+			if (DAPyDType(dtype()).isNumeral()) {
+				auto arr = toNumpyArray< T >();
+				if (arr) {
+					const T* p = arr.data();
+					std::copy(p, p + arr.size(), begin);
+					return;
+				}
+			}
+		}
 		std::size_t s            = size();
 		pybind11::object obj_iat = object().attr("iat");
 		for (std::size_t i = 0; i < s; ++i) {
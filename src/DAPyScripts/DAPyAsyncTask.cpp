@@ -0,0 +1,408 @@
+﻿#include "DAPyAsyncTask.h"
+#include <atomic>
+#include <QCoreApplication>
+#include <memory>
+#include <QDeadlineTimer>
+#include <QDebug>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include "DAPyGILIdleRelease.h"
+#include "DAPyModule.h"
+
+namespace DA
+{
+
+/**
+ * @brief 异步任务的线程池
+ */
+static QThreadPool* async_task_thread_pool()
+{
+	static QThreadPool* s_pool = []() {
+		QThreadPool* p = new QThreadPool(QCoreApplication::instance());
+		p->setMaxThreadCount(qBound(2, QThread::idealThreadCount(), 4));
+		return p;
+	}();
+	return s_pool;
+}
+
+/**
+ * @brief 未结束的任务，只在主线程访问
+ */
+static QSet< DAPyAsyncTask* > s_async_active_tasks;
+
+/**
+ * @brief 工作线程的中断状态，只在持有GIL时访问
+ *
+ * 取消请求可能在任务删除后才拿到GIL，因此单独共享
+ */
+struct DAPyAsyncTaskInterrupt
+{
+	unsigned long threadId { 0 };  ///< 工作线程的python线程id，执行中才有效
+	bool interruptible { false };
+	// 向工作线程注入KeyboardInterrupt，需持有GIL
+	void inject()
+	{
+		if (interruptible && threadId != 0) {
+			PyThreadState_SetAsyncExc(threadId, PyExc_KeyboardInterrupt);
+		}
+	}
+};
+
+/**
+ * @brief 在线程池中执行任务
+ */
+class DAPyAsyncTaskRunnable : public QRunnable
+{
+public:
+	DAPyAsyncTaskRunnable(DAPyAsyncTask* t) : mTask(t)
+	{
+		setAutoDelete(true);
+	}
+	void run() override
+	{
+		mTask->execute();
+	}
+
+private:
+	DAPyAsyncTask* mTask;
+};
+
+//===================================================
+// DAPyAsyncTask::PrivateData
+//===================================================
+class DAPyAsyncTask::PrivateData
+{
+	DA_DECLARE_PUBLIC(DAPyAsyncTask)
+public:
+	PrivateData(DAPyAsyncTask* p);
+	// 为工作线程设置进度回调，需持有GIL
+	void installProgressCallback();
+	void uninstallProgressCallback();
+
+public:
+	Function mFunction;
+	QString mName;
+	std::atomic< int > mState { DAPyAsyncTask::Pending };
+	std::atomic< int > mProgress { -1 };
+	std::atomic< bool > mCancelRequested { false };
+	mutable QMutex mMutex;
+	QWaitCondition mDoneCondition;
+	QString mError;
+	std::shared_ptr< DAPyAsyncTaskInterrupt > mInterrupt { std::make_shared< DAPyAsyncTaskInterrupt >() };
+	bool mDone { false };
+};
+
+DAPyAsyncTask::PrivateData::PrivateData(DAPyAsyncTask* p) : q_ptr(p)
+{
+}
+
+void DAPyAsyncTask::PrivateData::installProgressCallback()
+{
+	try {
+		DAPyAsyncTask* task = q_ptr;
+		pybind11::cpp_function callback([ task ](int done, int total) {
+			if (task->isCancelRequested()) {
+				PyErr_SetNone(PyExc_KeyboardInterrupt);
+				throw pybind11::error_already_set();
+			}
+			task->setProgress(total > 0 ? static_cast< int >(qint64(done) * 100 / total) : -1);
+		});
+		DAPyModule progress("DAWorkbench.progress");
+		progress.attr("da_set_progress_callback")(callback);
+	} catch (const std::exception& e) {
+		// 没有进度回调时任务仍然可以执行
+		qWarning() << e.what();
+	}
+}
+
+void DAPyAsyncTask::PrivateData::uninstallProgressCallback()
+{
+	try {
+		DAPyModule progress("DAWorkbench.progress");
+		progress.attr("da_set_progress_callback")(pybind11::none());
+	} catch (const std::exception& e) {
+		qWarning() << e.what();
+	}
+}
+
+//===================================================
+// DAPyAsyncTask
+//===================================================
+DAPyAsyncTask::DAPyAsyncTask(const Function& fn, const QString& name) : QObject(nullptr), DA_PIMPL_CONSTRUCT
+{
+	d_ptr->mFunction = fn;
+	d_ptr->mName     = name;
+}
+
+DAPyAsyncTask::~DAPyAsyncTask()
+{
+}
+
+/**
+ * @brief 提交任务
+ *
+ * 需在主线程调用，任务结束后自动删除
+ * @param fn 任务函数，在工作线程中调用
+ * @param name 任务名称
+ * @return 任务
+ */
+DAPyAsyncTask* DAPyAsyncTask::run(const Function& fn, const QString& name)
+{
+	DAPyAsyncTask* task = new DAPyAsyncTask(fn, name);
+	s_async_active_tasks.insert(task);
+	// 工作线程只能在主线程空闲时拿到GIL，正常情况下程序初始化python后已经安装
+	DAPyGILIdleRelease::getInstance().install();
+	// 进度通知不需要GIL，结束通知在onExecuted中自行获取
+	DAPyGILIdleRelease::getInstance().markGILFree(task);
+	async_task_thread_pool()->start(new DAPyAsyncTaskRunnable(task));
+	return task;
+}
+
+void DAPyAsyncTask::setMaxThreadCount(int c)
+{
+	async_task_thread_pool()->setMaxThreadCount(qMax(1, c));
+}
+
+int DAPyAsyncTask::getMaxThreadCount()
+{
+	return async_task_thread_pool()->maxThreadCount();
+}
+
+int DAPyAsyncTask::getActiveTaskCount()
+{
+	return s_async_active_tasks.size();
+}
+
+/**
+ * @brief 取消所有未结束的任务
+ *
+ * 需在主线程调用，不会等待任务结束，需要等待时配合@ref waitForAll
+ */
+void DAPyAsyncTask::cancelAll()
+{
+	const QList< DAPyAsyncTask* > tasks = s_async_active_tasks.values();
+	for (DAPyAsyncTask* t : tasks) {
+		t->cancel();
+	}
+}
+
+/**
+ * @brief 等待所有任务函数执行结束
+ *
+ * 需在主线程调用，等待期间释放GIL，任务的@ref finished 信号仍会在之后的事件循环中发射。
+ * 退出程序前应先@ref cancelAll 再等待，否则线程池析构时等待的工作线程拿不到GIL
+ * @param msecs 超时，小于0代表一直等待
+ * @return 所有任务函数都已结束返回true
+ */
+bool DAPyAsyncTask::waitForAll(int msecs)
+{
+	if (Py_IsInitialized() && PyGILState_Check()) {
+		pybind11::gil_scoped_release release;
+		return async_task_thread_pool()->waitForDone(msecs);
+	}
+	return async_task_thread_pool()->waitForDone(msecs);
+}
+
+QString DAPyAsyncTask::getName() const
+{
+	return d_ptr->mName;
+}
+
+DAPyAsyncTask::State DAPyAsyncTask::getState() const
+{
+	return static_cast< State >(d_ptr->mState.load());
+}
+
+bool DAPyAsyncTask::isActive() const
+{
+	const int s = d_ptr->mState.load();
+	return (s == Pending) || (s == Running);
+}
+
+bool DAPyAsyncTask::isCancelRequested() const
+{
+	return d_ptr->mCancelRequested.load();
+}
+
+int DAPyAsyncTask::getProgress() const
+{
+	return d_ptr->mProgress.load();
+}
+
+QString DAPyAsyncTask::getErrorString() const
+{
+	QMutexLocker locker(&(d_ptr->mMutex));
+	return d_ptr->mError;
+}
+
+/**
+ * @brief 设置进度，进度改变时在主线程发射@ref progressChanged
+ * @param percent 0~100，-1代表无法确定
+ */
+void DAPyAsyncTask::setProgress(int percent)
+{
+	percent = qBound(-1, percent, 100);
+	if (d_ptr->mProgress.exchange(percent) == percent) {
+		return;
+	}
+	QMetaObject::invokeMethod(this, [ this, percent ]() { Q_EMIT progressChanged(percent); }, Qt::QueuedConnection);
+}
+
+void DAPyAsyncTask::setErrorString(const QString& err)
+{
+	QMutexLocker locker(&(d_ptr->mMutex));
+	d_ptr->mError = err;
+}
+
+/**
+ * @brief 设置可中断区域
+ *
+ * 在工作线程中调用，调用时需持有GIL。只在任务数据可以整体回滚的操作外设置，
+ * 离开可中断区域后，回滚等收尾操作不会再被中断
+ * @param on
+ */
+void DAPyAsyncTask::setInterruptible(bool on)
+{
+	DAPyAsyncTaskInterrupt* interrupt = d_ptr->mInterrupt.get();
+	interrupt->interruptible          = on;
+	if (interrupt->threadId == 0) {
+		return;
+	}
+	if (on) {
+		// 进入前已经请求了取消
+		if (d_ptr->mCancelRequested.load()) {
+			interrupt->inject();
+		}
+	} else {
+		// 清除还未抛出的中断
+		PyThreadState_SetAsyncExc(interrupt->threadId, nullptr);
+	}
+}
+
+/**
+ * @brief 等待任务结束
+ *
+ * 等待期间会释放当前线程持有的GIL，返回后@ref finished 信号仍会在主线程的事件循环中发射
+ * @param msecs 超时，小于0代表一直等待
+ * @return 任务函数已经执行结束返回true
+ */
+bool DAPyAsyncTask::wait(int msecs)
+{
+	auto waitDone = [ this, msecs ]() -> bool {
+		QDeadlineTimer deadline(msecs < 0 ? QDeadlineTimer(QDeadlineTimer::Forever) : QDeadlineTimer(msecs));
+		QMutexLocker locker(&(d_ptr->mMutex));
+		while (!d_ptr->mDone) {
+			if (!d_ptr->mDoneCondition.wait(&(d_ptr->mMutex), deadline)) {
+				break;
+			}
+		}
+		return d_ptr->mDone;
+	};
+	if (Py_IsInitialized() && PyGILState_Check()) {
+		pybind11::gil_scoped_release release;
+		return waitDone();
+	}
+	return waitDone();
+}
+
+/**
+ * @brief 请求取消
+ *
+ * 还在排队的任务不会执行；执行中的任务在下一次报告进度时中止，处于可中断区域时会向工作线程注入KeyboardInterrupt。
+ * 取消请求到达前任务函数已经执行完成时，任务仍然算作成功
+ *
+ * 注入需要GIL，当前线程未持有GIL时由辅助线程等待GIL后注入，不会阻塞调用线程
+ */
+void DAPyAsyncTask::cancel()
+{
+	if (!isActive() || d_ptr->mCancelRequested.exchange(true)) {
+		return;
+	}
+	std::shared_ptr< DAPyAsyncTaskInterrupt > interrupt = d_ptr->mInterrupt;
+	if (PyGILState_Check()) {
+		interrupt->inject();
+		return;
+	}
+	QThread* t = QThread::create([ interrupt ]() {
+		if (!Py_IsInitialized()) {
+			return;
+		}
+		pybind11::gil_scoped_acquire gil;
+		interrupt->inject();
+	});
+	QObject::connect(t, &QThread::finished, t, &QObject::deleteLater);
+	t->start();
+}
+
+/**
+ * @brief 标记不会执行python的对象
+ *
+ * 发给此对象及其子对象的事件不会让主线程取回GIL，适用于进度条、取消按钮等只操作界面的控件，
+ * 这些对象的事件处理中如果需要访问python，需通过pybind11::gil_scoped_acquire自行获取。
+ * 需在主线程调用，对象销毁时自动移除
+ * @param obj
+ */
+void DAPyAsyncTask::markGILFree(QObject* obj)
+{
+	DAPyGILIdleRelease::getInstance().markGILFree(obj);
+}
+
+/**
+ * @brief 工作线程中执行任务函数
+ */
+void DAPyAsyncTask::execute()
+{
+	bool success = false;
+	{
+		pybind11::gil_scoped_acquire gil;
+		d_ptr->mInterrupt->threadId = PyThread_get_thread_ident();
+		if (!isCancelRequested()) {
+			d_ptr->mState.store(Running);
+			d_ptr->installProgressCallback();
+			try {
+				success = d_ptr->mFunction(this);
+			} catch (const std::exception& e) {
+				setErrorString(e.what());
+				success = false;
+			}
+			setInterruptible(false);
+			d_ptr->uninstallProgressCallback();
+		}
+		d_ptr->mInterrupt->threadId = 0;
+		// 任务函数捕获的python对象在工作线程释放，主线程不一定持有GIL
+		d_ptr->mFunction = Function();
+	}
+	{
+		QMutexLocker locker(&(d_ptr->mMutex));
+		d_ptr->mDone = true;
+		d_ptr->mDoneCondition.wakeAll();
+	}
+	QMetaObject::invokeMethod(this, [ this, success ]() { onExecuted(success); }, Qt::QueuedConnection);
+}
+
+/**
+ * @brief 主线程中处理任务结束
+ * @param success
+ */
+void DAPyAsyncTask::onExecuted(bool success)
+{
+	if (success) {
+		d_ptr->mState.store(Finished);
+	} else {
+		d_ptr->mState.store(isCancelRequested() ? Canceled : Failed);
+	}
+	s_async_active_tasks.remove(this);
+	{
+		// 结束的处理一般会刷新表格、推入命令，需持有GIL
+		pybind11::gil_scoped_acquire gil;
+		Q_EMIT finished(success);
+	}
+	deleteLater();
+}
+
+}  // end DA
@@ -0,0 +1,127 @@
+﻿#ifndef DAPYASYNCTASK_H
+#define DAPYASYNCTASK_H
+#include <functional>
+#include <QObject>
+#include <QString>
+#include "DAPyScriptsGlobal.h"
+namespace DA
+{
+
+/**
+ * @brief 在python工作线程中执行的异步任务
+ *
+ * 任务在独立的线程池中执行，执行期间持有GIL，不同的任务（例如针对不同dataframe的操作）可以同时提交，
+ * 由python按字节码交替执行，线程池的大小通过@ref setMaxThreadCount 设置
+ *
+ * 主线程只在事件循环空闲时释放GIL（见@ref DAPyGILIdleRelease ），分发事件前取回，
+ * 只操作界面的控件（进度条、取消按钮）可通过@ref markGILFree 标记，其事件不会等待工作线程释放GIL
+ *
+ * 退出程序前需要@ref cancelAll 并@ref waitForAll ，有任务未结束时不应保存工程
+ *
+ * 进度：任务执行前会通过DAWorkbench.progress.da_set_progress_callback为工作线程设置进度回调，
+ * 支持分块执行的python操作会报告进度，通过@ref progressChanged 信号在主线程接收，无法分块的操作进度为-1
+ *
+ * 取消：@ref cancel 后进度回调会抛出KeyboardInterrupt，处于可中断区域（@ref setInterruptible ）内时
+ * 还会向工作线程注入KeyboardInterrupt，python在执行下一条字节码时中止，耗时的C扩展调用返回后才会生效，
+ * @ref cancel 本身不会等待GIL
+ *
+ * 任务对象属于主线程，结束后发射@ref finished 并自动删除，不要手动delete
+ *
+ * @code
+ * DAPyAsyncTask* task = DAPyAsyncTask::run([ df ](DAPyAsyncTask* t) -> bool {
+ *     // 工作线程，已持有GIL
+ *     t->setInterruptible(true);
+ *     bool ok = DAPyScripts::getInstance().getDataFrame().sort(df, "time", true);
+ *     t->setInterruptible(false);
+ *     return ok;
+ * });
+ * connect(task, &DAPyAsyncTask::finished, this, [](bool ok) { ... });
+ * @endcode
+ *
+ * @note 任务函数捕获的python对象在工作线程执行完后释放；@ref progressChanged 在主线程未持有GIL时发射，
+ * @ref finished 发射时持有GIL
+ */
+class DAPYSCRIPTS_API DAPyAsyncTask : public QObject
+{
+	Q_OBJECT
+	DA_DECLARE_PRIVATE(DAPyAsyncTask)
+public:
+	/**
+	 * @brief 任务状态
+	 */
+	enum State
+	{
+		Pending,   ///< 排队中
+		Running,   ///< 执行中
+		Finished,  ///< 执行成功
+		Failed,    ///< 执行失败
+		Canceled   ///< 已取消
+	};
+	Q_ENUM(State)
+
+	/**
+	 * @brief 任务函数，在工作线程中调用，调用时已持有GIL，返回false代表失败
+	 */
+	using Function = std::function< bool(DAPyAsyncTask*) >;
+
+public:
+	// 提交任务，需在主线程调用
+	static DAPyAsyncTask* run(const Function& fn, const QString& name = QString());
+	// 同时执行的最大任务数
+	static void setMaxThreadCount(int c);
+	static int getMaxThreadCount();
+	// 未结束的任务数
+	static int getActiveTaskCount();
+	// 取消所有未结束的任务
+	static void cancelAll();
+	// 等待所有任务函数执行结束，等待期间释放GIL
+	static bool waitForAll(int msecs = -1);
+	// 标记不会执行python的对象，其事件不取回GIL
+	static void markGILFree(QObject* obj);
+
+	QString getName() const;
+	State getState() const;
+	// 任务是否还未结束
+	bool isActive() const;
+	// 是否已经请求取消，可在工作线程中调用
+	bool isCancelRequested() const;
+	// 进度，0~100，-1代表无法确定
+	int getProgress() const;
+	// 错误信息
+	QString getErrorString() const;
+	// 以下在工作线程中调用
+	void setProgress(int percent);
+	void setErrorString(const QString& err);
+	// 设置可中断区域，离开可中断区域时会清除还未抛出的中断
+	void setInterruptible(bool on);
+	// 等待任务结束，等待期间释放GIL，超时返回false
+	bool wait(int msecs = -1);
+
+public Q_SLOTS:
+	// 请求取消
+	void cancel();
+
+Q_SIGNALS:
+	/**
+	 * @brief 进度改变
+	 * @param percent 0~100，-1代表无法确定
+	 */
+	void progressChanged(int percent);
+
+	/**
+	 * @brief 任务结束，发射后任务会自动删除
+	 * @param success 执行成功为true，失败或取消为false，取消时@ref getState 为Canceled
+	 */
+	void finished(bool success);
+
+private:
+	DAPyAsyncTask(const Function& fn, const QString& name);
+	~DAPyAsyncTask();
+	// 工作线程执行
+	void execute();
+	// 主线程处理结束
+	void onExecuted(bool success);
+	friend class DAPyAsyncTaskRunnable;
+};
+}  // end DA
+#endif  // DAPYASYNCTASK_H
@@ -0,0 +1,191 @@
+﻿#include "DAPyDataFramePipeline.h"
+#include "DAPyScripts.h"
+namespace DA
+{
+
+/**
+ * @brief 界面中0.0代表没有界限
+ */
+static QVariant pipeline_bound(double v)
+{
+	return (v == 0.0) ? QVariant() : QVariant(v);
+}
+
+/**
+ * @brief 小于等于0代表不限制
+ */
+static QVariant pipeline_limit(int limit)
+{
+	return (limit > 0) ? QVariant(limit) : QVariant();
+}
+
+static QVariant pipeline_indexs(const QList< int >& indexs)
+{
+	if (indexs.isEmpty()) {
+		return QVariant();
+	}
+	QVariantList res;
+	for (int i : indexs) {
+		res.append(i);
+	}
+	return res;
+}
+
+//===================================================
+// DAPyDataFramePipeline
+//===================================================
+DAPyDataFramePipeline::DAPyDataFramePipeline()
+{
+}
+
+DAPyDataFramePipeline::~DAPyDataFramePipeline()
+{
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::append(const QString& op, const QVariantMap& args)
+{
+	mSteps.append(qMakePair(op, args));
+	return *this;
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::dropna(int axis, const QString& how, const QList< int >& indexs, std::optional< int > thresh)
+{
+	QVariantMap args;
+	args[ "axis" ]   = axis;
+	args[ "how" ]    = how;
+	args[ "index" ]  = pipeline_indexs(indexs);
+	args[ "thresh" ] = thresh ? QVariant(thresh.value()) : QVariant();
+	return append("drop_na", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::fillna(double value, int limit)
+{
+	QVariantMap args;
+	args[ "value" ] = value;
+	args[ "limit" ] = pipeline_limit(limit);
+	return append("fill_na", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::ffillna(int axis, int limit)
+{
+	QVariantMap args;
+	args[ "axis" ]  = axis;
+	args[ "limit" ] = pipeline_limit(limit);
+	return append("ffill_na", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::bfillna(int axis, int limit)
+{
+	QVariantMap args;
+	args[ "axis" ]  = axis;
+	args[ "limit" ] = pipeline_limit(limit);
+	return append("bfill_na", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::interpolate(const QString& method, int order, int limit)
+{
+	QVariantMap args;
+	args[ "method" ] = method;
+	args[ "order" ]  = order;
+	args[ "limit" ]  = pipeline_limit(limit);
+	return append("fill_interpolate", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::dropduplicates(const QString& keep, const QList< int >& indexs)
+{
+	QVariantMap args;
+	args[ "keep" ]  = keep;
+	args[ "index" ] = pipeline_indexs(indexs);
+	return append("drop_duplicates", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::nstdfilteroutlier(double n, int axis, const QList< int >& indexs)
+{
+	QVariantMap args;
+	args[ "n" ]     = n;
+	args[ "axis" ]  = axis;
+	args[ "index" ] = pipeline_indexs(indexs);
+	return append("nstd_filter_outlier", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::clipoutlier(double lowervalue, double uppervalue, int axis)
+{
+	QVariantMap args;
+	args[ "lower" ] = pipeline_bound(lowervalue);
+	args[ "upper" ] = pipeline_bound(uppervalue);
+	args[ "axis" ]  = axis;
+	return append("clip_outlier", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::queryDatas(const QString& expr)
+{
+	QVariantMap args;
+	args[ "expr" ] = expr;
+	return append("query_datas", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::evalDatas(const QString& expr)
+{
+	QVariantMap args;
+	args[ "expr" ] = expr;
+	return append("eval_datas", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::sort(const QString& by, bool ascending)
+{
+	QVariantMap args;
+	args[ "by" ]        = by;
+	args[ "ascending" ] = ascending;
+	return append("sort", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::dataselect(double lowervalue, double uppervalue, const QString& index)
+{
+	QVariantMap args;
+	args[ "lower" ] = pipeline_bound(lowervalue);
+	args[ "upper" ] = pipeline_bound(uppervalue);
+	args[ "index" ] = index;
+	return append("data_select", args);
+}
+
+DAPyDataFramePipeline& DAPyDataFramePipeline::append(const DAPyDataFramePipeline& other)
+{
+	mSteps.append(other.mSteps);
+	return *this;
+}
+
+const QList< DAPyDataFramePipeline::Step >& DAPyDataFramePipeline::steps() const
+{
+	return mSteps;
+}
+
+int DAPyDataFramePipeline::size() const
+{
+	return mSteps.size();
+}
+
+bool DAPyDataFramePipeline::isEmpty() const
+{
+	return mSteps.isEmpty();
+}
+
+void DAPyDataFramePipeline::clear()
+{
+	mSteps.clear();
+}
+
+/**
+ * @brief 执行所有操作
+ * @param df
+ * @param err 错误信息
+ * @return 没有操作时返回true
+ */
+bool DAPyDataFramePipeline::apply(DAPyDataFrame& df, QString* err) const noexcept
+{
+	if (mSteps.isEmpty()) {
+		return true;
+	}
+	return DAPyScripts::getInstance().getDataFrame().apply_pipeline(df, mSteps, err);
+}
+
+}  // end DA
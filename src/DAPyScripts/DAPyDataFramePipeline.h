@@ -0,0 +1,68 @@
+﻿#ifndef DAPYDATAFRAMEPIPELINE_H
+#define DAPYDATAFRAMEPIPELINE_H
+#include "DAPyScriptsGlobal.h"
+#include <optional>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QVariantMap>
+#include "pandas/DAPyDataFrame.h"
+namespace DA
+{
+
+/**
+ * @brief dataframe操作的延迟构建器
+ *
+ * 逐个调用@ref DAPyScriptsDataFrame 的函数时，每一步都要跨越一次C++/python边界并转换参数，
+ * 构建器先记录操作，@ref apply 时通过DAWorkbench.dataframe.da_apply_pipeline一次执行完，
+ * python端会把连续的逐行过滤合并为一个掩码，只删除一次行，减少中间的dataframe复制
+ *
+ * 参数的含义和@ref DAPyScriptsDataFrame 中同名函数一致
+ *
+ * @code
+ * DAPyDataFramePipeline p;
+ * p.dropna().fillna(0).clipoutlier(-10, 10).sort("time", true);
+ * p.apply(df);
+ * @endcode
+ */
+class DAPYSCRIPTS_API DAPyDataFramePipeline
+{
+public:
+	using Step = QPair< QString, QVariantMap >;
+
+public:
+	DAPyDataFramePipeline();
+	~DAPyDataFramePipeline();
+	// 添加一个操作，op为DAWorkbench.dataframe中去掉da_前缀的函数名
+	DAPyDataFramePipeline& append(const QString& op, const QVariantMap& args = QVariantMap());
+	// 常用的操作
+	DAPyDataFramePipeline& dropna(int axis                    = 0,
+	                              const QString& how          = QStringLiteral("any"),
+	                              const QList< int >& indexs  = QList< int >(),
+	                              std::optional< int > thresh = std::nullopt);
+	DAPyDataFramePipeline& fillna(double value, int limit = -1);
+	DAPyDataFramePipeline& ffillna(int axis = 0, int limit = -1);
+	DAPyDataFramePipeline& bfillna(int axis = 0, int limit = -1);
+	DAPyDataFramePipeline& interpolate(const QString& method, int order, int limit = -1);
+	DAPyDataFramePipeline& dropduplicates(const QString& keep, const QList< int >& indexs = QList< int >());
+	DAPyDataFramePipeline& nstdfilteroutlier(double n, int axis, const QList< int >& indexs);
+	DAPyDataFramePipeline& clipoutlier(double lowervalue, double uppervalue, int axis = 0);
+	DAPyDataFramePipeline& queryDatas(const QString& expr);
+	DAPyDataFramePipeline& evalDatas(const QString& expr);
+	DAPyDataFramePipeline& sort(const QString& by, bool ascending);
+	DAPyDataFramePipeline& dataselect(double lowervalue, double uppervalue, const QString& index);
+	// 追加另外一个构建器的所有操作
+	DAPyDataFramePipeline& append(const DAPyDataFramePipeline& other);
+	// 操作
+	const QList< Step >& steps() const;
+	int size() const;
+	bool isEmpty() const;
+	void clear();
+	// 执行所有操作，直接改变df，失败时df可能已经执行了部分操作
+	bool apply(DAPyDataFrame& df, QString* err = nullptr) const noexcept;
+
+private:
+	QList< Step > mSteps;
+};
+}  // end DA
+#endif  // DAPYDATAFRAMEPIPELINE_H
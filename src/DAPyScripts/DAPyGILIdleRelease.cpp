@@ -0,0 +1,157 @@
+﻿#include "DAPyGILIdleRelease.h"
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+#include <QSet>
+#include <QThread>
+#include "DAPyModule.h"
+
+namespace DA
+{
+
+//===================================================
+// DAPyGILIdleRelease::PrivateData
+//===================================================
+class DAPyGILIdleRelease::PrivateData
+{
+	DA_DECLARE_PUBLIC(DAPyGILIdleRelease)
+public:
+	PrivateData(DAPyGILIdleRelease* p);
+	void saveThread();
+	void restoreThread();
+	// 对象及其父对象是否标记为不会执行python
+	bool isGILFree(QObject* watched) const;
+
+public:
+	bool mInstalled { false };
+	PyThreadState* mMainState { nullptr };  ///< 主线程的线程状态，释放GIL后记录，取回后置空
+	QMetaObject::Connection mAboutToBlock;
+	QSet< QObject* > mGILFreeObjects;
+};
+
+DAPyGILIdleRelease::PrivateData::PrivateData(DAPyGILIdleRelease* p) : q_ptr(p)
+{
+}
+
+void DAPyGILIdleRelease::PrivateData::saveThread()
+{
+	if (mMainState || !Py_IsInitialized() || !PyGILState_Check()) {
+		return;
+	}
+	mMainState = PyEval_SaveThread();
+}
+
+void DAPyGILIdleRelease::PrivateData::restoreThread()
+{
+	if (!mMainState) {
+		return;
+	}
+	PyThreadState* s = mMainState;
+	mMainState       = nullptr;
+	// gil_scoped_acquire范围内GIL已经在当前线程
+	if (!PyGILState_Check()) {
+		PyEval_RestoreThread(s);
+	}
+}
+
+bool DAPyGILIdleRelease::PrivateData::isGILFree(QObject* watched) const
+{
+	if (mGILFreeObjects.isEmpty()) {
+		return false;
+	}
+	for (QObject* o = watched; o; o = o->parent()) {
+		if (mGILFreeObjects.contains(o)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+//===================================================
+// DAPyGILIdleRelease
+//===================================================
+DAPyGILIdleRelease::DAPyGILIdleRelease() : QObject(nullptr), DA_PIMPL_CONSTRUCT
+{
+}
+
+DAPyGILIdleRelease::~DAPyGILIdleRelease()
+{
+}
+
+DAPyGILIdleRelease& DAPyGILIdleRelease::getInstance()
+{
+	static DAPyGILIdleRelease s_release;
+	return s_release;
+}
+
+/**
+ * @brief 安装，需在主线程、python初始化之后调用，重复调用无效
+ */
+void DAPyGILIdleRelease::install()
+{
+	QCoreApplication* app = QCoreApplication::instance();
+	if (d_ptr->mInstalled || !app || !Py_IsInitialized()) {
+		return;
+	}
+	Q_ASSERT(QThread::currentThread() == app->thread());
+	d_ptr->mInstalled = true;
+	app->installEventFilter(this);
+	if (QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance(app->thread())) {
+		d_ptr->mAboutToBlock = QObject::connect(
+		    dispatcher, &QAbstractEventDispatcher::aboutToBlock, this, [ this ]() { d_ptr->saveThread(); }, Qt::DirectConnection);
+	}
+}
+
+/**
+ * @brief 卸载，返回后主线程持有GIL，需在python结束前调用
+ */
+void DAPyGILIdleRelease::uninstall()
+{
+	if (!d_ptr->mInstalled) {
+		return;
+	}
+	d_ptr->mInstalled = false;
+	d_ptr->restoreThread();
+	QObject::disconnect(d_ptr->mAboutToBlock);
+	if (QCoreApplication* app = QCoreApplication::instance()) {
+		app->removeEventFilter(this);
+	}
+}
+
+bool DAPyGILIdleRelease::isInstalled() const
+{
+	return d_ptr->mInstalled;
+}
+
+/**
+ * @brief 标记不会执行python的对象，发给此对象及其子对象的事件都不取回GIL
+ *
+ * 对象销毁时自动移除
+ * @param obj
+ */
+void DAPyGILIdleRelease::markGILFree(QObject* obj)
+{
+	if (!obj || d_ptr->mGILFreeObjects.contains(obj)) {
+		return;
+	}
+	d_ptr->mGILFreeObjects.insert(obj);
+	QObject::connect(obj, &QObject::destroyed, this, [ this, obj ]() { d_ptr->mGILFreeObjects.remove(obj); });
+}
+
+/**
+ * @brief 分发事件前取回GIL
+ *
+ * 无法从事件类型判断处理中是否会执行python（例如QTimer::singleShot的函数对象由内部的定时器对象触发），
+ * 因此除了标记为不会执行python的对象，所有事件都取回
+ * @param watched
+ * @param e
+ * @return
+ */
+bool DAPyGILIdleRelease::eventFilter(QObject* watched, QEvent* e)
+{
+	if (d_ptr->mMainState && !d_ptr->isGILFree(watched)) {
+		d_ptr->restoreThread();
+	}
+	return QObject::eventFilter(watched, e);
+}
+
+}  // end DA
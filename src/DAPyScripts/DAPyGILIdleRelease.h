@@ -0,0 +1,49 @@
+﻿#ifndef DAPYGILIDLERELEASE_H
+#define DAPYGILIDLERELEASE_H
+#include <QObject>
+#include "DAPyScriptsGlobal.h"
+namespace DA
+{
+
+/**
+ * @brief 主线程事件循环空闲期间释放GIL
+ *
+ * 主线程初始化python后一直持有GIL，界面代码（表格模型、命令、DAPyDataFrame等）都默认在持有GIL时执行。
+ * 安装后，事件循环即将阻塞（aboutToBlock）时释放GIL，让执行器线程、异步任务、进程池等其他线程可以执行python；
+ * 之后分发任何事件前都会取回GIL（不区分事件类型，QTimer::singleShot等内部对象的事件同样取回），
+ * 因此事件处理中的代码和安装前一样持有GIL。
+ *
+ * 只操作界面的控件（进度条、取消按钮）可通过@ref markGILFree 标记，其事件不取回GIL，
+ * 这些对象的事件处理中如果需要访问python，需通过pybind11::gil_scoped_acquire自行获取
+ *
+ * 在python初始化完成后、进入事件循环前@ref install ，退出事件循环后、python结束前@ref uninstall ：
+ * @code
+ * DAPyGILIdleRelease::getInstance().install();
+ * int r = app.exec();
+ * DAPyGILIdleRelease::getInstance().uninstall();
+ * @endcode
+ *
+ * @note 只在主线程使用；主线程中需要长时间阻塞等待其他线程（例如QThreadPool::waitForDone）时，
+ * 需通过pybind11::gil_scoped_release释放GIL，否则等待的线程拿不到GIL
+ */
+class DAPYSCRIPTS_API DAPyGILIdleRelease : public QObject
+{
+	Q_OBJECT
+	DA_DECLARE_PRIVATE(DAPyGILIdleRelease)
+public:
+	static DAPyGILIdleRelease& getInstance();
+	// 安装，之后事件循环空闲时释放GIL
+	void install();
+	// 卸载，并确保主线程持有GIL
+	void uninstall();
+	bool isInstalled() const;
+	// 标记不会执行python的对象
+	void markGILFree(QObject* obj);
+	bool eventFilter(QObject* watched, QEvent* e) override;
+
+private:
+	DAPyGILIdleRelease();
+	~DAPyGILIdleRelease();
+};
+}  // end DA
+#endif  // DAPYGILIDLERELEASE_H
@@ -1,5 +1,6 @@
 ﻿#include "DAPyScriptsDataFrame.h"
 #include "DAPybind11QtTypeCast.h"
+#include "DAScriptTimeScope.h"
 #include <QDebug>
 namespace DA
 {
@@ -35,6 +36,8 @@ DAPyScriptsDataFrame::~DAPyScriptsDataFrame()
  */
 bool DAPyScriptsDataFrame::drop_irow(DAPyDataFrame& df, const QList< int >& index) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_drop_irow = attr("da_drop_irow");
 		da_drop_irow(df.object(), DA::PY::toPyList(index));
@@ -53,6 +56,8 @@ bool DAPyScriptsDataFrame::drop_irow(DAPyDataFrame& df, const QList< int >& inde
  */
 bool DAPyScriptsDataFrame::drop_icolumn(DAPyDataFrame& df, const QList< int >& index) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_drop_icolumn = attr("da_drop_icolumn");
 		da_drop_icolumn(df.object(), DA::PY::toPyList(index));
@@ -71,6 +76,8 @@ bool DAPyScriptsDataFrame::drop_icolumn(DAPyDataFrame& df, const QList< int >& i
  */
 bool DAPyScriptsDataFrame::insert_nanrow(DAPyDataFrame& df, int r) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_insert_nanrow = attr("da_insert_nanrow");
 		da_insert_nanrow(df.object(), pybind11::int_(r));
@@ -91,6 +98,8 @@ bool DAPyScriptsDataFrame::insert_nanrow(DAPyDataFrame& df, int r) noexcept
  */
 bool DAPyScriptsDataFrame::insert_column(DAPyDataFrame& df, int c, const QString& name, const QVariant& defaultvalue) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_insert_column = attr("da_insert_column");
 		pybind11::dict args;
@@ -123,6 +132,8 @@ bool DAPyScriptsDataFrame::insert_column(DAPyDataFrame& df,
                                          const QVariant& start,
                                          const QVariant& stop) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_insert_column = attr("da_insert_column");
 		pybind11::dict args;
@@ -151,6 +162,8 @@ bool DAPyScriptsDataFrame::insert_column(DAPyDataFrame& df,
  */
 bool DAPyScriptsDataFrame::to_csv(const DAPyDataFrame& df, const QString& path, const QString& sep) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_to_csv = attr("da_to_csv");
 		da_to_csv(df.object(), DA::PY::toPyStr(path), DA::PY::toPyStr(sep));
@@ -169,6 +182,8 @@ bool DAPyScriptsDataFrame::to_csv(const DAPyDataFrame& df, const QString& path,
  */
 bool DAPyScriptsDataFrame::to_excel(const DAPyDataFrame& df, const QString& path) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_to_excel = attr("da_to_excel");
 		da_to_excel(df.object(), DA::PY::toPyStr(path));
@@ -187,6 +202,8 @@ bool DAPyScriptsDataFrame::to_excel(const DAPyDataFrame& df, const QString& path
  */
 bool DAPyScriptsDataFrame::to_pickle(const DAPyDataFrame& df, const QString& path) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_to_pickle = attr("da_to_pickle");
 		da_to_pickle(df.object(), DA::PY::toPyStr(path));
@@ -205,6 +222,8 @@ bool DAPyScriptsDataFrame::to_pickle(const DAPyDataFrame& df, const QString& pat
  */
 bool DAPyScriptsDataFrame::to_parquet(const DAPyDataFrame& df, const QString& path) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_to_parquet = attr("da_to_parquet");
 		da_to_parquet(df.object(), DA::PY::toPyStr(path));
@@ -223,6 +242,8 @@ bool DAPyScriptsDataFrame::to_parquet(const DAPyDataFrame& df, const QString& pa
  */
 bool DAPyScriptsDataFrame::from_pickle(DAPyDataFrame& df, const QString& path) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_from_pickle = attr("da_from_pickle");
 		da_from_pickle(df.object(), DA::PY::toPyStr(path));
@@ -241,6 +262,8 @@ bool DAPyScriptsDataFrame::from_pickle(DAPyDataFrame& df, const QString& path) n
  */
 bool DAPyScriptsDataFrame::from_parquet(DAPyDataFrame& df, const QString& path) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_from_parquet = attr("da_from_parquet");
 		da_from_parquet(df.object(), DA::PY::toPyStr(path));
@@ -251,6 +274,439 @@ bool DAPyScriptsDataFrame::from_parquet(DAPyDataFrame& df, const QString& path)
 	return false;
 }
 
+/**
+ * @brief 保存为DA列式文件，对应da_to_columnar
+ * @param df
+ * @param path
+ * @return
+ */
+bool DAPyScriptsDataFrame::to_columnar(const DAPyDataFrame& df, const QString& path) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_to_columnar = attr("da_to_columnar");
+		da_to_columnar(df.object(), DA::PY::toPyStr(path));
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 从DA列式文件加载，对应da_from_columnar
+ * @param df
+ * @param path
+ * @return
+ */
+bool DAPyScriptsDataFrame::from_columnar(DAPyDataFrame& df, const QString& path) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_from_columnar = attr("da_from_columnar");
+		da_from_columnar(df.object(), DA::PY::toPyStr(path));
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 从工程档案的条目加载，对应da_from_archive
+ * @param df
+ * @param archivePath 档案路径
+ * @param entry 条目在档案中的路径
+ * @return
+ */
+bool DAPyScriptsDataFrame::from_archive(DAPyDataFrame& df, const QString& archivePath, const QString& entry) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_from_archive = attr("da_from_archive");
+		da_from_archive(df.object(), DA::PY::toPyStr(archivePath), DA::PY::toPyStr(entry));
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 读取pickle文件为一个新的dataframe
+ * @param path
+ * @return 失败返回none
+ */
+DAPyDataFrame DAPyScriptsDataFrame::read_pickle(const QString& path) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_read_pickle = attr("da_read_pickle");
+		return da_read_pickle(DA::PY::toPyStr(path));
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return DAPyDataFrame();
+}
+
+/**
+ * @brief dataframe内容的哈希，对应da_content_hash
+ * @param df
+ * @return 哈希值，失败（例如含有无法哈希的对象）返回0
+ */
+quint64 DAPyScriptsDataFrame::content_hash(const DAPyDataFrame& df) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_content_hash = attr("da_content_hash");
+		return da_content_hash(df.object()).cast< quint64 >();
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return 0;
+}
+
+/**
+ * @brief dataframe占用的内存，对应da_memory_usage
+ * @param df
+ * @return 字节数，失败返回-1
+ */
+qint64 DAPyScriptsDataFrame::memory_usage(const DAPyDataFrame& df) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_memory_usage = attr("da_memory_usage");
+		return da_memory_usage(df.object()).cast< qint64 >();
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return -1;
+}
+
+/**
+ * @brief 深拷贝dataframe
+ * @param df
+ * @return 失败返回none
+ */
+DAPyDataFrame DAPyScriptsDataFrame::copy(const DAPyDataFrame& df) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_copy = attr("da_copy");
+		return da_copy(df.object());
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return DAPyDataFrame();
+}
+
+/**
+ * @brief 用快照恢复dataframe，快照本身不会改变
+ * @param df
+ * @param snapshot
+ * @return
+ */
+bool DAPyScriptsDataFrame::restore(DAPyDataFrame& df, const DAPyDataFrame& snapshot) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_restore = attr("da_restore");
+		da_restore(df.object(), snapshot.object());
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 含有缺失值的列
+ * @param df
+ * @param colsIndex 列索引
+ * @return
+ */
+bool DAPyScriptsDataFrame::nan_columns(const DAPyDataFrame& df, QList< int >& colsIndex) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_nan_columns = attr("da_nan_columns");
+		pybind11::list cols             = da_nan_columns(df.object());
+		colsIndex.clear();
+		for (const pybind11::handle& c : cols) {
+			colsIndex.append(c.cast< int >());
+		}
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief clipoutlier会改变的列
+ *
+ * 和@ref clipoutlier 一致，上下界为0时不限制
+ * @param df
+ * @param lowervalue 下界
+ * @param uppervalue 上界
+ * @param colsIndex 列索引
+ * @return
+ */
+bool DAPyScriptsDataFrame::clip_columns(const DAPyDataFrame& df, double lowervalue, double uppervalue, QList< int >& colsIndex) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_clip_columns = attr("da_clip_columns");
+		pybind11::object lower           = pybind11::none();
+		pybind11::object upper           = pybind11::none();
+		if (lowervalue != 0.0) {
+			lower = pybind11::float_(lowervalue);
+		}
+		if (uppervalue != 0.0) {
+			upper = pybind11::float_(uppervalue);
+		}
+		pybind11::list cols = da_clip_columns(df.object(), lower, upper);
+		colsIndex.clear();
+		for (const pybind11::handle& c : cols) {
+			colsIndex.append(c.cast< int >());
+		}
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 提取指定列的副本
+ * @param df
+ * @param colsIndex
+ * @return 失败返回none
+ */
+DAPyDataFrame DAPyScriptsDataFrame::snapshot_columns(const DAPyDataFrame& df, const QList< int >& colsIndex) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_snapshot_columns = attr("da_snapshot_columns");
+		return da_snapshot_columns(df.object(), DA::PY::toPyList(colsIndex));
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return DAPyDataFrame();
+}
+
+/**
+ * @brief 用列快照恢复被修改的列
+ * @param df
+ * @param colsIndex
+ * @param snapshot
+ * @param columnCount 操作前的列数，操作追加的列会被删除，小于0表示列数没有改变
+ * @return
+ */
+bool DAPyScriptsDataFrame::restore_columns(DAPyDataFrame& df,
+                                           const QList< int >& colsIndex,
+                                           const DAPyDataFrame& snapshot,
+                                           int columnCount) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_restore_columns = attr("da_restore_columns");
+		pybind11::object count              = pybind11::none();
+		if (columnCount >= 0) {
+			count = pybind11::int_(columnCount);
+		}
+		da_restore_columns(df.object(), DA::PY::toPyList(colsIndex), snapshot.object(), count);
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 把列快照插回原来的位置
+ * @param df
+ * @param colsIndex
+ * @param snapshot
+ * @return
+ */
+bool DAPyScriptsDataFrame::restore_dropped_columns(DAPyDataFrame& df,
+                                                   const QList< int >& colsIndex,
+                                                   const DAPyDataFrame& snapshot) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_restore_dropped_columns = attr("da_restore_dropped_columns");
+		da_restore_dropped_columns(df.object(), DA::PY::toPyList(colsIndex), snapshot.object());
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 提取指定行的副本
+ * @param df
+ * @param rowsIndex
+ * @return index有重复值或失败时返回none
+ */
+DAPyDataFrame DAPyScriptsDataFrame::snapshot_rows(const DAPyDataFrame& df, const QList< int >& rowsIndex) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_snapshot_rows = attr("da_snapshot_rows");
+		return da_snapshot_rows(df.object(), DA::PY::toPyList(rowsIndex));
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return DAPyDataFrame();
+}
+
+/**
+ * @brief 把行快照插回原来的位置
+ * @param df
+ * @param rowsIndex
+ * @param snapshot
+ * @return
+ */
+bool DAPyScriptsDataFrame::restore_dropped_rows(DAPyDataFrame& df,
+                                                const QList< int >& rowsIndex,
+                                                const DAPyDataFrame& snapshot) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_restore_dropped_rows = attr("da_restore_dropped_rows");
+		da_restore_dropped_rows(df.object(), DA::PY::toPyList(rowsIndex), snapshot.object());
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 逐行过滤操作将删除的行
+ *
+ * 用于撤销时只保存被删除的行，args的约定需要和对应的包装函数一致
+ * @param df
+ * @param op 去掉da_前缀的函数名，如drop_na、query_datas
+ * @param args 操作的参数
+ * @param rowsIndex 删除前的行索引
+ * @return 操作不支持或无法确定时返回false
+ */
+bool DAPyScriptsDataFrame::dropped_rows(const DAPyDataFrame& df,
+                                        const QString& op,
+                                        const QVariantMap& args,
+                                        QList< int >& rowsIndex) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_dropped_rows = attr("da_dropped_rows");
+		pybind11::object rows = da_dropped_rows(df.object(), DA::PY::toPyStr(op), DA::PY::toPyDict(args));
+		if (rows.is_none()) {
+			return false;
+		}
+		rowsIndex.clear();
+		for (const pybind11::handle& r : rows) {
+			rowsIndex.append(r.cast< int >());
+		}
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief eval会改变的已有列
+ *
+ * 新增的列追加在最后，撤销时按操作前的列数删除
+ * @param df
+ * @param expr 表达式
+ * @param colsIndex 会被改变的已有列
+ * @param columnCount 操作前的列数
+ * @return 表达式无法解析时返回false
+ */
+bool DAPyScriptsDataFrame::eval_columns(const DAPyDataFrame& df, const QString& expr, QList< int >& colsIndex, int& columnCount) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_eval_columns = attr("da_eval_columns");
+		pybind11::object cols            = da_eval_columns(df.object(), DA::PY::toPyStr(expr));
+		if (cols.is_none()) {
+			return false;
+		}
+		colsIndex.clear();
+		for (const pybind11::handle& c : cols) {
+			colsIndex.append(c.cast< int >());
+		}
+		pybind11::tuple shape = df.object().attr("shape");
+		columnCount           = shape[ 1 ].cast< int >();
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
+/**
+ * @brief 排序后每一行在排序前的位置
+ * @param df
+ * @param by 排序依据
+ * @param ascending 排序方式
+ * @return 只有一列的dataframe，失败返回none
+ */
+DAPyDataFrame DAPyScriptsDataFrame::sort_permutation(const DAPyDataFrame& df, const QString& by, bool ascending) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_sort_permutation = attr("da_sort_permutation");
+		return da_sort_permutation(df.object(), DA::PY::toPyStr(by), ascending);
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return DAPyDataFrame();
+}
+
+/**
+ * @brief 用排列恢复排序前的行顺序
+ * @param df
+ * @param snapshot @ref sort_permutation 的结果
+ * @return
+ */
+bool DAPyScriptsDataFrame::restore_permutation(DAPyDataFrame& df, const DAPyDataFrame& snapshot) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_restore_permutation = attr("da_restore_permutation");
+		da_restore_permutation(df.object(), snapshot.object());
+		return true;
+	} catch (const std::exception& e) {
+		dealException(e);
+	}
+	return false;
+}
+
 /**
  * @brief 对列转换为对应的类型
  * @param df
@@ -260,6 +716,8 @@ bool DAPyScriptsDataFrame::from_parquet(DAPyDataFrame& df, const QString& path)
  */
 bool DAPyScriptsDataFrame::astype(DAPyDataFrame& df, const QList< int >& colsIndex, const DAPyDType& dt) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_astype = attr("da_astype");
 		pybind11::list index;
@@ -283,6 +741,8 @@ bool DAPyScriptsDataFrame::astype(DAPyDataFrame& df, const QList< int >& colsInd
  */
 bool DAPyScriptsDataFrame::setnan(DAPyDataFrame& df, const QList< int >& rowsIndex, const QList< int >& colsIndex) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_setnan = attr("da_setnan");
 		pybind11::list rows;
@@ -301,6 +761,8 @@ bool DAPyScriptsDataFrame::setnan(DAPyDataFrame& df, const QList< int >& rowsInd
 
 bool DAPyScriptsDataFrame::import() noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::module m = pybind11::module::import("DAWorkbench");
 		object()           = m.attr("dataframe");
@@ -319,6 +781,8 @@ bool DAPyScriptsDataFrame::import() noexcept
  */
 bool DAPyScriptsDataFrame::cast_to_num(DAPyDataFrame& df, const QList< int >& colsIndex, pybind11::dict args) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_cast_to_num = attr("da_cast_to_num");
 		pybind11::list index;
@@ -340,6 +804,8 @@ bool DAPyScriptsDataFrame::cast_to_num(DAPyDataFrame& df, const QList< int >& co
  */
 bool DAPyScriptsDataFrame::cast_to_datetime(DAPyDataFrame& df, const QList< int >& colsIndex, pybind11::dict args) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_cast_to_datetime = attr("da_cast_to_datetime");
 		pybind11::list index;
@@ -362,6 +828,8 @@ bool DAPyScriptsDataFrame::cast_to_datetime(DAPyDataFrame& df, const QList< int
  */
 bool DAPyScriptsDataFrame::set_index(DAPyDataFrame& df, const QList< int >& colsIndex) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_setindex = attr("da_setindex");
 		pybind11::list index;
@@ -384,6 +852,8 @@ bool DAPyScriptsDataFrame::set_index(DAPyDataFrame& df, const QList< int >& cols
  */
 DAPySeries DAPyScriptsDataFrame::itake_column(DAPyDataFrame& df, int col) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_itake_column = attr("da_itake_column");
 		// 执行
@@ -404,6 +874,8 @@ DAPySeries DAPyScriptsDataFrame::itake_column(DAPyDataFrame& df, int col) noexce
  */
 bool DAPyScriptsDataFrame::insert_at(DAPyDataFrame& df, int col, const DAPySeries& series) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_insert_at = attr("da_insert_at");
 		da_insert_at(df.object(), pybind11::int_(col), series.object());
@@ -429,6 +901,8 @@ bool DAPyScriptsDataFrame::dropna(DAPyDataFrame& df,
                                   const QList< int >& indexs,
                                   std::optional< int > thresh) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_drop_na = attr("da_drop_na");
 		pybind11::object threshobj  = pybind11::none();
@@ -457,6 +931,8 @@ bool DAPyScriptsDataFrame::dropna(DAPyDataFrame& df,
  */
 bool DAPyScriptsDataFrame::fillna(DAPyDataFrame& df, double value, int limit) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_fill_na = attr("da_fill_na");
 		pybind11::object limitObj   = pybind11::none();
@@ -483,6 +959,8 @@ bool DAPyScriptsDataFrame::fillna(DAPyDataFrame& df, double value, int limit) no
  */
 bool DAPyScriptsDataFrame::ffillna(DAPyDataFrame& df, int axis, int limit) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_ffill_na = attr("da_ffill_na");
 		pybind11::object limitObj    = pybind11::none();
@@ -509,6 +987,8 @@ bool DAPyScriptsDataFrame::ffillna(DAPyDataFrame& df, int axis, int limit) noexc
  */
 bool DAPyScriptsDataFrame::bfillna(DAPyDataFrame& df, int axis, int limit) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_bfill_na = attr("da_bfill_na");
 		pybind11::object limitObj    = pybind11::none();
@@ -535,6 +1015,8 @@ bool DAPyScriptsDataFrame::bfillna(DAPyDataFrame& df, int axis, int limit) noexc
  */
 bool DAPyScriptsDataFrame::interpolate(DAPyDataFrame& df, const QString& method, int order, int limit) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_interpolate = attr("da_fill_interpolate");
 		pybind11::object limitObj       = pybind11::none();
@@ -561,6 +1043,8 @@ bool DAPyScriptsDataFrame::interpolate(DAPyDataFrame& df, const QString& method,
  */
 bool DAPyScriptsDataFrame::dropduplicates(DAPyDataFrame& df, const QString& keep, const QList< int >& indexs) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_drop_duplicates = attr("da_drop_duplicates");
 		pybind11::dict args;
@@ -587,6 +1071,8 @@ bool DAPyScriptsDataFrame::dropduplicates(DAPyDataFrame& df, const QString& keep
  */
 bool DAPyScriptsDataFrame::nstdfilteroutlier(DAPyDataFrame& df, double n, int axis, const QList< int >& indexs) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_nstd_filter_outlier = attr("da_nstd_filter_outlier");
 		if (n > 10 || n < 0.1) {
@@ -617,6 +1103,8 @@ bool DAPyScriptsDataFrame::nstdfilteroutlier(DAPyDataFrame& df, double n, int ax
  */
 bool DAPyScriptsDataFrame::clipoutlier(DAPyDataFrame& df, double lowervalue, double uppervalue, int axis) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_clip_outlier = attr("da_clip_outlier");
 		pybind11::dict args;
@@ -647,6 +1135,8 @@ bool DAPyScriptsDataFrame::clipoutlier(DAPyDataFrame& df, double lowervalue, dou
  */
 bool DAPyScriptsDataFrame::queryDatas(DAPyDataFrame& df, const QString& expr) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		if (expr.isEmpty()) {
 			return false;
@@ -668,6 +1158,8 @@ bool DAPyScriptsDataFrame::queryDatas(DAPyDataFrame& df, const QString& expr) no
  */
 QList< QPair< int, int > > DAPyScriptsDataFrame::searchData(const DAPyDataFrame& df, const QString& expr) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	QList< QPair< int, int > > matches;
 	try {
 		if (expr.isEmpty()) {
@@ -697,6 +1189,8 @@ QList< QPair< int, int > > DAPyScriptsDataFrame::searchData(const DAPyDataFrame&
  */
 bool DAPyScriptsDataFrame::evalDatas(DAPyDataFrame& df, const QString& expr) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		if (expr.isEmpty()) {
 			return false;
@@ -719,6 +1213,8 @@ bool DAPyScriptsDataFrame::evalDatas(DAPyDataFrame& df, const QString& expr) noe
  */
 bool DAPyScriptsDataFrame::sort(DAPyDataFrame& df, const QString& by, bool ascending) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_sort = attr("da_sort");
 		pybind11::dict args;
@@ -745,6 +1241,8 @@ bool DAPyScriptsDataFrame::sort(DAPyDataFrame& df, const QString& by, bool ascen
  */
 bool DAPyScriptsDataFrame::dataselect(DAPyDataFrame& df, double lowervalue, double uppervalue, const QString& index) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_data_select = attr("da_data_select");
 		pybind11::dict args;
@@ -767,6 +1265,39 @@ bool DAPyScriptsDataFrame::dataselect(DAPyDataFrame& df, double lowervalue, doub
 	return false;
 }
 
+/**
+ * @brief 一次执行多个操作
+ *
+ * 参数只在此处转换一次，python端连续的逐行过滤会合并执行
+ * @param df
+ * @param steps （操作名，参数），操作名为da_xxx函数去掉da_前缀
+ * @param err 错误信息
+ * @return
+ */
+bool DAPyScriptsDataFrame::apply_pipeline(DAPyDataFrame& df, const QList< QPair< QString, QVariantMap > >& steps, QString* err) noexcept
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	try {
+		pybind11::object da_apply_pipeline = attr("da_apply_pipeline");
+		pybind11::list stepsObj;
+		for (const QPair< QString, QVariantMap >& s : steps) {
+			pybind11::dict step;
+			step[ "op" ]   = DA::PY::toPyStr(s.first);
+			step[ "args" ] = DA::PY::toPyDict(s.second);
+			stepsObj.append(step);
+		}
+		da_apply_pipeline(df.object(), stepsObj);
+		return true;
+	} catch (const std::exception& e) {
+		if (err) {
+			*err = e.what();
+		}
+		dealException(e);
+	}
+	return false;
+}
+
 /**
  * @brief pivot_table方法的wrapper
  * @param values 要进行汇总的数据值
@@ -786,6 +1317,8 @@ DAPyDataFrame DAPyScriptsDataFrame::pivotTable(const DAPyDataFrame& df,
                                                const QString& marginsName,
                                                bool sort) noexcept
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object da_pivot_table = attr("da_create_pivot_table");
 		pybind11::dict args;
@@ -5,6 +5,7 @@
 #include <optional>
 #include <QString>
 #include <QList>
+#include <QVariantMap>
 #include "DAPyObjectWrapper.h"
 #include "numpy/DAPyDType.h"
 #include "pandas/DAPyDataFrame.h"
@@ -48,6 +49,43 @@ public:
 	bool from_pickle(DAPyDataFrame& df, const QString& path) noexcept;
 	// 从parquet加载
 	bool from_parquet(DAPyDataFrame& df, const QString& path) noexcept;
+	// 保存为DA列式文件
+	bool to_columnar(const DAPyDataFrame& df, const QString& path) noexcept;
+	// 从DA列式文件加载，数值列通过内存映射按需加载
+	bool from_columnar(DAPyDataFrame& df, const QString& path) noexcept;
+	// 从工程档案（zip）的条目加载，不压缩存放的列式条目直接内存映射档案文件
+	bool from_archive(DAPyDataFrame& df, const QString& archivePath, const QString& entry) noexcept;
+	// 读取pickle文件为一个新的dataframe
+	DAPyDataFrame read_pickle(const QString& path) noexcept;
+	// dataframe内容的哈希，失败返回0
+	quint64 content_hash(const DAPyDataFrame& df) noexcept;
+	// dataframe占用的内存（字节），失败返回-1
+	qint64 memory_usage(const DAPyDataFrame& df) noexcept;
+	// 深拷贝
+	DAPyDataFrame copy(const DAPyDataFrame& df) noexcept;
+	// 用快照恢复dataframe
+	bool restore(DAPyDataFrame& df, const DAPyDataFrame& snapshot) noexcept;
+	// 含有缺失值的列，填充缺失值只会改变这些列
+	bool nan_columns(const DAPyDataFrame& df, QList< int >& colsIndex) noexcept;
+	// clipoutlier会改变的列，和clipoutlier一样上下界为0时不限制
+	bool clip_columns(const DAPyDataFrame& df, double lowervalue, double uppervalue, QList< int >& colsIndex) noexcept;
+	// 列快照及恢复
+	DAPyDataFrame snapshot_columns(const DAPyDataFrame& df, const QList< int >& colsIndex) noexcept;
+	bool restore_columns(DAPyDataFrame& df,
+	                     const QList< int >& colsIndex,
+	                     const DAPyDataFrame& snapshot,
+	                     int columnCount = -1) noexcept;
+	bool restore_dropped_columns(DAPyDataFrame& df, const QList< int >& colsIndex, const DAPyDataFrame& snapshot) noexcept;
+	// 行快照及恢复，index有重复值时无法按行保存，返回none
+	DAPyDataFrame snapshot_rows(const DAPyDataFrame& df, const QList< int >& rowsIndex) noexcept;
+	bool restore_dropped_rows(DAPyDataFrame& df, const QList< int >& rowsIndex, const DAPyDataFrame& snapshot) noexcept;
+	// 逐行过滤操作将删除的行，op为去掉da_前缀的函数名，无法确定时返回false
+	bool dropped_rows(const DAPyDataFrame& df, const QString& op, const QVariantMap& args, QList< int >& rowsIndex) noexcept;
+	// eval会改变的已有列及操作前的列数，无法确定时返回false
+	bool eval_columns(const DAPyDataFrame& df, const QString& expr, QList< int >& colsIndex, int& columnCount) noexcept;
+	// 排序的排列及恢复
+	DAPyDataFrame sort_permutation(const DAPyDataFrame& df, const QString& by, bool ascending) noexcept;
+	bool restore_permutation(DAPyDataFrame& df, const DAPyDataFrame& snapshot) noexcept;
 	// 类型转换
 	bool astype(DAPyDataFrame& df, const QList< int >& colsIndex, const DAPyDType& dt) noexcept;
 	// 设置nan值
@@ -91,6 +129,8 @@ public:
 	bool sort(DAPyDataFrame& df, const QString& by, bool ascending) noexcept;
 	// dataselect()
 	bool dataselect(DAPyDataFrame& df, double lowervalue, double uppervalue, const QString& index) noexcept;
+	// 一次执行多个操作，对应da_apply_pipeline，steps为（操作名，参数）
+	bool apply_pipeline(DAPyDataFrame& df, const QList< QPair< QString, QVariantMap > >& steps, QString* err = nullptr) noexcept;
 
 	// 创建数据透视表
 	DAPyDataFrame pivotTable(const DAPyDataFrame& df,
@@ -1,8 +1,49 @@
 ﻿#include "DAPyScriptsDataProcess.h"
+#include <atomic>
+#include <QCoreApplication>
+#include <QThread>
 #include "DAPybind11QtTypeCast.h"
+#include "DAPyWorkerPool.h"
+#include "DAScriptTimeScope.h"
 namespace DA
 {
 
+static std::atomic< bool > s_enableWorkerPool { true };
+
+/**
+ * @brief 非主线程调用时通过python工作进程池执行，需持有GIL
+ * @param fun data_processing中的函数名
+ * @param wave 波形，以waveform参数传入
+ * @param kwargs 其余参数
+ * @param res 结果
+ * @param err 错误信息
+ * @return 没有通过进程池执行时返回false，由调用方在内嵌解释器中执行
+ */
+static bool callInWorkerPool(const QString& fun,
+                             const DAPySeries& wave,
+                             const QVariantMap& kwargs,
+                             DAPyDataFrame& res,
+                             QString* err)
+{
+	if (!s_enableWorkerPool || QThread::currentThread() == QCoreApplication::instance()->thread()) {
+		return false;
+	}
+	DAPyWorkerPool& pool = DAPyWorkerPool::getInstance();
+	if (!pool.start()) {
+		return false;
+	}
+	DAPyWorkerPool::Result r = pool.call("DAWorkbench.data_processing." + fun, { { "waveform", wave } }, kwargs);
+	if (!r.success) {
+		if (err) {
+			*err = r.error;
+		}
+		qDebug() << r.error;
+		return true;
+	}
+	res = r.frames.value("result");
+	return true;
+}
+
 DAPyScriptsDataProcess::DAPyScriptsDataProcess(bool autoImport) : DAPyModule()
 {
 	if (autoImport) {
@@ -34,6 +75,12 @@ DAPyScriptsDataProcess::~DAPyScriptsDataProcess()
 DAPyDataFrame
 DAPyScriptsDataProcess::spectrum_analysis(const DAPySeries& wave, double fs, const QVariantMap& args, QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	DAPyDataFrame res;
+	if (callInWorkerPool("da_spectrum_analysis", wave, { { "sampling_rate", fs }, { "args", args } }, res, err)) {
+		return res;
+	}
 	try {
 		pybind11::object fn = attr("da_spectrum_analysis");
 		if (fn.is_none()) {
@@ -54,6 +101,12 @@ DAPyScriptsDataProcess::spectrum_analysis(const DAPySeries& wave, double fs, con
 DAPyDataFrame
 DAPyScriptsDataProcess::butterworth_filter(const DAPySeries& wave, double fs, int fo, const QVariantMap& args, QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	DAPyDataFrame res;
+	if (callInWorkerPool("da_butterworth_filter", wave, { { "sampling_freq", fs }, { "filter_order", fo }, { "args", args } }, res, err)) {
+		return res;
+	}
 	try {
 		pybind11::object fn = attr("da_butterworth_filter");
 		if (fn.is_none()) {
@@ -73,6 +126,12 @@ DAPyScriptsDataProcess::butterworth_filter(const DAPySeries& wave, double fs, in
 
 DAPyDataFrame DAPyScriptsDataProcess::peak_analysis(const DAPySeries& wave, double fs, const QVariantMap& args, QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	DAPyDataFrame res;
+	if (callInWorkerPool("da_peak_analysis", wave, { { "sampling_rate", fs }, { "args", args } }, res, err)) {
+		return res;
+	}
 	try {
 		pybind11::object fn = attr("da_peak_analysis");
 		if (fn.is_none()) {
@@ -92,6 +151,8 @@ DAPyDataFrame DAPyScriptsDataProcess::peak_analysis(const DAPySeries& wave, doub
 
 pybind11::dict DAPyScriptsDataProcess::stft_analysis(const DAPySeries& wave, double fs, const QVariantMap& args, QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object fn = attr("da_stft_analysis");
 		if (fn.is_none()) {
@@ -115,6 +176,8 @@ pybind11::dict DAPyScriptsDataProcess::wavelet_cwt(const DAPySeries& wave,
                                                    const QVariantMap& args,
                                                    QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::object fn = attr("da_wavelet_cwt");
 		if (fn.is_none()) {
@@ -134,6 +197,12 @@ pybind11::dict DAPyScriptsDataProcess::wavelet_cwt(const DAPySeries& wave,
 
 DAPyDataFrame DAPyScriptsDataProcess::wavelet_dwt(const DAPySeries& wave, double fs, const QVariantMap& args, QString* err)
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	DAPyDataFrame res;
+	if (callInWorkerPool("da_wavelet_dwt", wave, { { "sampling_rate", fs }, { "args", args } }, res, err)) {
+		return res;
+	}
 	try {
 		pybind11::object fn = attr("da_wavelet_dwt");
 		if (fn.is_none()) {
@@ -150,8 +219,24 @@ DAPyDataFrame DAPyScriptsDataProcess::wavelet_dwt(const DAPySeries& wave, double
 	}
 	return DAPyDataFrame();
 }
+/**
+ * @brief 设置非主线程调用时是否通过python工作进程池执行
+ * @param on
+ */
+void DAPyScriptsDataProcess::setEnableWorkerPool(bool on)
+{
+	s_enableWorkerPool = on;
+}
+
+bool DAPyScriptsDataProcess::isEnableWorkerPool()
+{
+	return s_enableWorkerPool;
+}
+
 bool DAPyScriptsDataProcess::import()
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::module m = pybind11::module::import("DAWorkbench");
 		object()           = m.attr("data_processing");
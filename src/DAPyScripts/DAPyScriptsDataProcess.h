@@ -11,6 +11,9 @@ namespace DA
 
 /**
  * @brief 封装的da_io.py
+ *
+ * 在非主线程（例如工作流节点）调用返回dataframe的函数时，默认通过@ref DAPyWorkerPool 在独立的python进程中执行，
+ * 不占用内嵌解释器的GIL，进程池无法启动时在内嵌解释器中执行
  */
 class DAPYSCRIPTS_API DAPyScriptsDataProcess : public DAPyModule
 {
@@ -35,6 +38,9 @@ public:
                                QString* err = nullptr);
 	//离散小波变换
 	DAPyDataFrame wavelet_dwt(const DAPySeries& wave, double fs, const QVariantMap& args, QString* err = nullptr);
+	// 非主线程调用时是否通过python工作进程池执行，默认为true
+	static void setEnableWorkerPool(bool on);
+	static bool isEnableWorkerPool();
 	// 引入
 	bool import();
 };
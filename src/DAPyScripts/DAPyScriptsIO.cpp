@@ -1,5 +1,6 @@
 ﻿#include "DAPyScriptsIO.h"
 #include "DAPybind11QtTypeCast.h"
+#include "DAScriptTimeScope.h"
 #include <QDebug>
 
 /**
@@ -17,6 +18,8 @@
  * @code
  * DAPyDataFrame DAPyScriptsIO::read_csv(const QString& filepath, const QVariantMap& args)
  * {
+ *     DAScriptTimeScope scriptTime;
+ *     pybind11::gil_scoped_acquire gil;
  *     try {
  *         pybind11::object fn = attr("read_csv");
  *         if (fn.is_none()) {
@@ -35,6 +38,8 @@
 #define FUNCTION_STR_DICT(returnType, functionName, pyFunctionName)                                                    \
 	returnType DAPyScriptsIO::functionName(const QString& filepath, const QVariantMap& args, QString* err)             \
 	{                                                                                                                  \
+		DAScriptTimeScope scriptTime;                                                                                  \
+		pybind11::gil_scoped_acquire gil;                                                                              \
 		try {                                                                                                          \
 			pybind11::object fn = attr(#pyFunctionName);                                                               \
 			if (fn.is_none()) {                                                                                        \
@@ -96,6 +101,8 @@ DAPyScriptsIO::~DAPyScriptsIO()
  */
 QList< QString > DAPyScriptsIO::getFileReadFilters() const
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	QList< QString > res;
 	try {
 		pybind11::object da_get_file_read_filters = attr("da_get_file_read_filters");
@@ -171,6 +178,8 @@ FUNCTION_STR_DICT(DAPyDataFrame, read_pkl, read_pkl)
  */
 bool DAPyScriptsIO::import()
 {
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
 	try {
 		pybind11::module m = pybind11::module::import("DAWorkbench");
 		object()           = m.attr("io");
@@ -0,0 +1,79 @@
+﻿#include "DAPySharedFrame.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include "DAPyModule.h"
+#include "DAPybind11QtTypeCast.h"
+#include "DAScriptTimeScope.h"
+namespace DA
+{
+
+DAPySharedFrame::DAPySharedFrame()
+{
+}
+
+/**
+ * @brief 接管共享内存文件
+ * @param path 文件路径，最后一个引用销毁时删除此文件
+ */
+DAPySharedFrame::DAPySharedFrame(const QString& path)
+    : mPath(new QString(path), [](const QString* p) {
+	    QFile::remove(*p);
+	    delete p;
+    })
+{
+}
+
+DAPySharedFrame::~DAPySharedFrame()
+{
+}
+
+bool DAPySharedFrame::isNull() const
+{
+	return (mPath == nullptr);
+}
+
+QString DAPySharedFrame::getPath() const
+{
+	return mPath ? *mPath : QString();
+}
+
+/**
+ * @brief 文件大小，可作为dataframe内存占用的估算
+ * @return 为空时返回-1
+ */
+qint64 DAPySharedFrame::getFileSize() const
+{
+	if (!mPath) {
+		return -1;
+	}
+	return QFileInfo(*mPath).size();
+}
+
+/**
+ * @brief 在主程序中读取为dataframe
+ *
+ * 函数内部会获取GIL，文件不会删除；返回的dataframe和其他DAPy对象一样需要在持有GIL时销毁
+ * @param err 错误信息
+ * @return 为空或者读取失败时返回空的dataframe
+ */
+DAPyDataFrame DAPySharedFrame::toDataFrame(QString* err) const
+{
+	DAScriptTimeScope scriptTime;
+	pybind11::gil_scoped_acquire gil;
+	if (!mPath) {
+		return DAPyDataFrame();
+	}
+	try {
+		DAPyModule worker("DAWorkbench.worker");
+		return DAPyDataFrame(worker.attr("da_read_shared")(DA::PY::toPyStr(*mPath), false, true));
+	} catch (const std::exception& e) {
+		if (err) {
+			*err = e.what();
+		}
+		qDebug() << e.what();
+	}
+	return DAPyDataFrame();
+}
+
+}  // end DA
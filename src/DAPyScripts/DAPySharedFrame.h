@@ -0,0 +1,42 @@
+﻿#ifndef DAPYSHAREDFRAME_H
+#define DAPYSHAREDFRAME_H
+#include <memory>
+#include <QMetaType>
+#include <QString>
+#include "DAPyScriptsGlobal.h"
+#include "pandas/DAPyDataFrame.h"
+namespace DA
+{
+
+/**
+ * @brief 共享内存中的dataframe
+ *
+ * 指向@ref DAPyWorkerPool 共享内存目录下的一个Arrow IPC文件，只记录文件路径，
+ * 复制、传递和销毁都不需要GIL，最后一个引用销毁时删除文件
+ *
+ * 进程池执行的节点之间直接传递此句柄（例如上一个节点的输出作为下一个节点的输入），
+ * dataframe不经过主程序的解释器，调度这些节点的线程不需要获取GIL；
+ * 需要在主程序中使用时通过@ref toDataFrame 读取
+ */
+class DAPYSCRIPTS_API DAPySharedFrame
+{
+public:
+	DAPySharedFrame();
+	// 接管文件，最后一个引用销毁时删除
+	explicit DAPySharedFrame(const QString& path);
+	~DAPySharedFrame();
+	// 是否为空
+	bool isNull() const;
+	// 文件路径
+	QString getPath() const;
+	// 文件大小，不需要GIL
+	qint64 getFileSize() const;
+	// 读取为dataframe，会获取GIL，文件保留
+	DAPyDataFrame toDataFrame(QString* err = nullptr) const;
+
+private:
+	std::shared_ptr< const QString > mPath;
+};
+}  // end DA
+Q_DECLARE_METATYPE(DA::DAPySharedFrame)
+#endif  // DAPYSHAREDFRAME_H
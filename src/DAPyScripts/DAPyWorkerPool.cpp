@@ -0,0 +1,628 @@
+﻿#include "DAPyWorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QPointer>
+#include <QThread>
+#include <QUuid>
+#include "DAProcess.h"
+#include "DAPyModule.h"
+#include "DAPyInterpreter.h"
+#include "DAPybind11QtTypeCast.h"
+#include "DAScriptTimeScope.h"
+
+namespace DA
+{
+
+/**
+ * @brief 回复的前缀，没有此前缀的标准输出会当作日志
+ */
+static const QString c_worker_reply_prefix = QStringLiteral("@DA-WORKER ");
+
+/**
+ * @brief 工作进程的回复，dataframe只记录共享内存文件路径
+ */
+struct DAPyWorkerReply
+{
+	bool success { false };
+	QString error;
+	QMap< QString, QString > framePaths;
+	QVariant value;
+};
+
+/**
+ * @brief 一次请求
+ */
+struct DAPyWorkerTask
+{
+	QByteArray request;
+	std::promise< DAPyWorkerReply > promise;
+	std::atomic< bool > canceled { false };  ///< 由cancelAll设置
+};
+using DAPyWorkerTaskPtr = std::shared_ptr< DAPyWorkerTask >;
+
+/**
+ * @brief 一个工作进程
+ */
+struct DAPyWorker
+{
+	int index { 0 };
+	DAProcessWithThread* process { nullptr };
+	DAPyWorkerTaskPtr current;  ///< 正在执行的请求
+	bool alive { false };
+	bool ready { false };  ///< 收到就绪消息后才派发请求
+};
+using DAPyWorkerPtr = std::shared_ptr< DAPyWorker >;
+
+/**
+ * @brief 进程池的调度状态
+ *
+ * 进程的输出在进程线程中直接处理，不依赖任何线程的事件循环，
+ * 状态由进程的回调共同持有，进程池销毁后仍在运行的进程回调不会访问已销毁的对象
+ */
+class DAPyWorkerPoolCore
+{
+public:
+	// 派发请求给空闲的工作进程，需持有锁
+	void dispatchLocked();
+	// 让请求失败，需持有锁
+	static void failTask(const DAPyWorkerTaskPtr& t, const QString& err);
+	// 放弃请求，排队中的直接移除，执行中的结束对应的工作进程，需持有锁
+	void abandonLocked(const DAPyWorkerTaskPtr& t);
+	// 工作进程的回调，在进程线程调用
+	void onOutput(const DAPyWorkerPtr& w, const QString& line);
+	void onExit(const DAPyWorkerPtr& w, const QString& reason);
+
+public:
+	mutable QMutex mMutex;
+	std::vector< DAPyWorkerPtr > mWorkers;
+	std::deque< DAPyWorkerTaskPtr > mPending;
+	bool mStarted { false };
+};
+
+void DAPyWorkerPoolCore::dispatchLocked()
+{
+	for (const DAPyWorkerPtr& w : mWorkers) {
+		if (mPending.empty()) {
+			return;
+		}
+		if (!w->alive || !w->ready || w->current) {
+			continue;
+		}
+		w->current = mPending.front();
+		mPending.pop_front();
+		w->process->sendData(w->current->request);
+	}
+}
+
+void DAPyWorkerPoolCore::failTask(const DAPyWorkerTaskPtr& t, const QString& err)
+{
+	DAPyWorkerReply r;
+	r.error = err;
+	t->promise.set_value(r);
+}
+
+void DAPyWorkerPoolCore::abandonLocked(const DAPyWorkerTaskPtr& t)
+{
+	auto it = std::find(mPending.begin(), mPending.end(), t);
+	if (it != mPending.end()) {
+		mPending.erase(it);
+		return;
+	}
+	for (const DAPyWorkerPtr& w : mWorkers) {
+		if (w->current != t) {
+			continue;
+		}
+		// 不再给它派发请求，进程退出后由onExit回收
+		w->current.reset();
+		w->ready = false;
+		if (w->process) {
+			w->process->kill();
+		}
+		return;
+	}
+}
+
+void DAPyWorkerPoolCore::onOutput(const DAPyWorkerPtr& w, const QString& line)
+{
+	if (!line.startsWith(c_worker_reply_prefix)) {
+		qDebug().noquote() << QString("[python worker %1] %2").arg(w->index).arg(line);
+		return;
+	}
+	QJsonParseError jsonErr;
+	const QJsonObject obj = QJsonDocument::fromJson(line.mid(c_worker_reply_prefix.size()).toUtf8(), &jsonErr).object();
+	if (obj.value("ready").toBool()) {
+		QMutexLocker locker(&mMutex);
+		w->ready = w->alive;
+		dispatchLocked();
+		return;
+	}
+	DAPyWorkerReply r;
+	if (jsonErr.error != QJsonParseError::NoError) {
+		r.error = QObject::tr("invalid reply of python worker:%1").arg(jsonErr.errorString());  // cn:python工作进程的回复无效
+	} else {
+		r.success                 = obj.value("ok").toBool();
+		r.error                   = obj.value("error").toString();
+		r.value                   = obj.value("value").toVariant();
+		const QJsonObject framesObj = obj.value("frames").toObject();
+		for (auto i = framesObj.begin(); i != framesObj.end(); ++i) {
+			r.framePaths[ i.key() ] = i.value().toString();
+		}
+	}
+	QMutexLocker locker(&mMutex);
+	DAPyWorkerTaskPtr t = w->current;
+	w->current.reset();
+	if (t) {
+		t->promise.set_value(r);
+	} else {
+		// 请求已经被放弃，输出文件无人读取
+		for (const QString& p : qAsConst(r.framePaths)) {
+			QFile::remove(p);
+		}
+	}
+	dispatchLocked();
+}
+
+void DAPyWorkerPoolCore::onExit(const DAPyWorkerPtr& w, const QString& reason)
+{
+	QMutexLocker locker(&mMutex);
+	if (!w->alive) {
+		return;
+	}
+	w->alive = false;
+	w->ready = false;
+	if (w->current) {
+		failTask(w->current, reason);
+		w->current.reset();
+	}
+	if (w->process) {
+		w->process->deleteLater();
+		w->process = nullptr;
+	}
+	// 没有可用的工作进程时，排队中的请求也无法完成
+	bool anyAlive = false;
+	for (const DAPyWorkerPtr& other : mWorkers) {
+		anyAlive |= other->alive;
+	}
+	if (!anyAlive) {
+		while (!mPending.empty()) {
+			failTask(mPending.front(), reason);
+			mPending.pop_front();
+		}
+	}
+}
+
+//===================================================
+// DAPyWorkerPool::PrivateData
+//===================================================
+class DAPyWorkerPool::PrivateData
+{
+	DA_DECLARE_PUBLIC(DAPyWorkerPool)
+public:
+	PrivateData(DAPyWorkerPool* p);
+	// 启动一个工作进程，需持有锁
+	void launchLocked(const DAPyWorkerPtr& w);
+	// 共享内存文件路径
+	QString makeSharedPath() const;
+
+public:
+	std::shared_ptr< DAPyWorkerPoolCore > mCore;
+	QString mProgram;
+	QString mScriptsPath;
+	QString mSharedDir;
+	int mWorkerCount { 1 };
+	std::atomic< qint64 > mNextID { 1 };
+};
+
+DAPyWorkerPool::PrivateData::PrivateData(DAPyWorkerPool* p) : q_ptr(p), mCore(std::make_shared< DAPyWorkerPoolCore >())
+{
+	mWorkerCount = qMax(1, QThread::idealThreadCount() - 1);
+	mSharedDir   = QDir("/dev/shm").exists() ? QStringLiteral("/dev/shm") : QDir::tempPath();
+}
+
+void DAPyWorkerPool::PrivateData::launchLocked(const DAPyWorkerPtr& w)
+{
+	DAProcessWithThread* process = new DAProcessWithThread();
+	// 回调在进程线程执行，对象本身交给主线程销毁
+	process->moveToThread(QCoreApplication::instance()->thread());
+	process->setProgram(mProgram);
+	process->setArguments({ "-u", QDir(mScriptsPath).absoluteFilePath("DAWorkbench/worker.py"), "--shm-dir", mSharedDir });
+	std::shared_ptr< DAPyWorkerPoolCore > core = mCore;
+	QObject::connect(
+	    process,
+	    &DAProcessWithThread::processStarandOutput,
+	    process,
+	    [ core, w ](const QString& line) { core->onOutput(w, line); },
+	    Qt::DirectConnection);
+	QObject::connect(
+	    process,
+	    &DAProcessWithThread::processErrorOutput,
+	    process,
+	    [ w ](const QString& line) { qDebug().noquote() << QString("[python worker %1] %2").arg(w->index).arg(line); },
+	    Qt::DirectConnection);
+	QObject::connect(
+	    process,
+	    &DAProcessWithThread::processFinished,
+	    process,
+	    [ core, w ](int code) {
+		    core->onExit(w, QObject::tr("python worker %1 exited with code %2").arg(w->index).arg(code));  // cn:python工作进程%1退出，返回值%2
+	    },
+	    Qt::DirectConnection);
+	QObject::connect(
+	    process,
+	    &DAProcessWithThread::errorOccurred,
+	    process,
+	    [ core, w ](QProcess::ProcessError error, const QString& errString) {
+		    // 启动失败时不会有finished信号
+		    if (error == QProcess::FailedToStart) {
+			    core->onExit(w, QObject::tr("python worker %1 failed to start:%2").arg(w->index).arg(errString));  // cn:python工作进程%1启动失败
+		    }
+	    },
+	    Qt::DirectConnection);
+	w->process = process;
+	w->alive   = true;
+	process->runProcess();
+}
+
+QString DAPyWorkerPool::PrivateData::makeSharedPath() const
+{
+	return QDir(mSharedDir).absoluteFilePath(QString("da-%1-%2.arrow")
+	                                             .arg(QCoreApplication::applicationPid())
+	                                             .arg(QUuid::createUuid().toString(QUuid::Id128)));
+}
+
+//===================================================
+// DAPyWorkerPool
+//===================================================
+DAPyWorkerPool::DAPyWorkerPool(QObject* par) : QObject(par), DA_PIMPL_CONSTRUCT
+{
+}
+
+DAPyWorkerPool::~DAPyWorkerPool()
+{
+	stop();
+}
+
+DAPyWorkerPool& DAPyWorkerPool::getInstance()
+{
+	static QPointer< DAPyWorkerPool > s_pool = []() {
+		// 第一次获取可能在执行器线程，不能直接以QCoreApplication为父对象
+		DAPyWorkerPool* p = new DAPyWorkerPool();
+		p->moveToThread(QCoreApplication::instance()->thread());
+		QObject::connect(QCoreApplication::instance(), &QObject::destroyed, [ p ]() { delete p; });
+		return QPointer< DAPyWorkerPool >(p);
+	}();
+	return *s_pool;
+}
+
+void DAPyWorkerPool::setPythonProgram(const QString& program)
+{
+	d_ptr->mProgram = program;
+}
+
+QString DAPyWorkerPool::getPythonProgram() const
+{
+	return d_ptr->mProgram;
+}
+
+void DAPyWorkerPool::setScriptsPath(const QString& path)
+{
+	d_ptr->mScriptsPath = path;
+}
+
+QString DAPyWorkerPool::getScriptsPath() const
+{
+	return d_ptr->mScriptsPath;
+}
+
+void DAPyWorkerPool::setSharedDir(const QString& dir)
+{
+	d_ptr->mSharedDir = dir;
+}
+
+QString DAPyWorkerPool::getSharedDir() const
+{
+	return d_ptr->mSharedDir;
+}
+
+void DAPyWorkerPool::setWorkerCount(int c)
+{
+	d_ptr->mWorkerCount = qMax(1, c);
+}
+
+int DAPyWorkerPool::getWorkerCount() const
+{
+	return d_ptr->mWorkerCount;
+}
+
+/**
+ * @brief 启动工作进程，已经启动时只会重新启动退出的工作进程
+ * @return 找不到python解释器时返回false
+ */
+bool DAPyWorkerPool::start()
+{
+	// call可能在多个线程中同时调用
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	if (d_ptr->mProgram.isEmpty()) {
+		d_ptr->mProgram = DAPyInterpreter::getPythonInterpreterPath();
+	}
+	if (d_ptr->mScriptsPath.isEmpty()) {
+		d_ptr->mScriptsPath = QCoreApplication::applicationDirPath() + "/PyScripts";
+	}
+	if (d_ptr->mProgram.isEmpty()) {
+		qCritical() << tr("can not find python interpreter for python worker");  // cn:找不到python工作进程使用的python解释器
+		return false;
+	}
+	std::vector< DAPyWorkerPtr >& workers = d_ptr->mCore->mWorkers;
+	workers.resize(d_ptr->mWorkerCount);
+	for (int i = 0; i < d_ptr->mWorkerCount; ++i) {
+		if (!workers[ i ]) {
+			workers[ i ]        = std::make_shared< DAPyWorker >();
+			workers[ i ]->index = i;
+		}
+		if (!workers[ i ]->alive) {
+			d_ptr->launchLocked(workers[ i ]);
+		}
+	}
+	d_ptr->mCore->mStarted = true;
+	return true;
+}
+
+/**
+ * @brief 停止工作进程
+ *
+ * 排队中的请求返回失败，正在执行的请求执行完成后进程退出
+ */
+void DAPyWorkerPool::stop()
+{
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	std::shared_ptr< DAPyWorkerPoolCore > core = d_ptr->mCore;
+	while (!core->mPending.empty()) {
+		DAPyWorkerPoolCore::failTask(core->mPending.front(), tr("python worker pool is stopped"));  // cn:python工作进程池已停止
+		core->mPending.pop_front();
+	}
+	for (const DAPyWorkerPtr& w : core->mWorkers) {
+		if (w->alive && w->process) {
+			w->process->sendData("{\"exit\":true}\n");
+		}
+	}
+	core->mWorkers.clear();
+	core->mStarted = false;
+	// 退出中的进程仍持有旧的状态，新的状态用于下次启动
+	d_ptr->mCore = std::make_shared< DAPyWorkerPoolCore >();
+}
+
+bool DAPyWorkerPool::isStarted() const
+{
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	return d_ptr->mCore->mStarted;
+}
+
+int DAPyWorkerPool::getIdleWorkerCount() const
+{
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	int c = 0;
+	for (const DAPyWorkerPtr& w : d_ptr->mCore->mWorkers) {
+		if (w->alive && !w->current) {
+			++c;
+		}
+	}
+	return c;
+}
+
+int DAPyWorkerPool::getPendingCount() const
+{
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	return static_cast< int >(d_ptr->mCore->mPending.size());
+}
+
+/**
+ * @brief 取消所有正在等待的调用
+ *
+ * 调用方在下一次检查时中止，正在执行的工作进程会被结束
+ */
+void DAPyWorkerPool::cancelAll()
+{
+	QMutexLocker locker(&(d_ptr->mCore->mMutex));
+	for (const DAPyWorkerTaskPtr& t : d_ptr->mCore->mPending) {
+		t->canceled = true;
+	}
+	for (const DAPyWorkerPtr& w : d_ptr->mCore->mWorkers) {
+		if (w->current) {
+			w->current->canceled = true;
+		}
+	}
+}
+
+/**
+ * @brief 把主程序中的dataframe或series写入共享内存
+ *
+ * 函数内部会获取GIL
+ * @param obj pd.DataFrame或者pd.Series
+ * @param err 错误信息
+ * @return 失败返回空的句柄
+ */
+DAPySharedFrame DAPyWorkerPool::writeShared(const DAPyObjectWrapper& obj, QString* err)
+{
+	DAScriptTimeScope scriptTime;
+	const QString path = d_ptr->makeSharedPath();
+	try {
+		pybind11::gil_scoped_acquire gil;
+		DAPyModule worker("DAWorkbench.worker");
+		worker.attr("da_write_shared")(obj.object(), DA::PY::toPyStr(path));
+	} catch (const std::exception& e) {
+		if (err) {
+			*err = e.what();
+		}
+		QFile::remove(path);
+		return DAPySharedFrame();
+	}
+	return DAPySharedFrame(path);
+}
+
+/**
+ * @brief 在工作进程中调用python函数
+ *
+ * 输入的dataframe在当前进程写入共享内存（需要GIL），通过@ref callShared 交给工作进程执行，
+ * 返回后在当前进程读取输出的dataframe
+ *
+ * 超时或者取消时，排队中的请求直接移除，正在执行的请求会结束对应的工作进程，
+ * 返回的@ref Result::canceled 为true
+ * @param function 函数全名，格式为“模块.函数”，例如DAWorkbench.dataframe.da_xxx
+ * @param frames dataframe或者series参数，key为参数名
+ * @param kwargs 其余参数，需要能转换为json
+ * @param timeoutMs 超时时间，小于0不超时，包含排队和工作进程启动的时间
+ * @param isCanceled 取消判断函数，等待期间定时调用（不持有GIL），返回true时中止
+ * @return
+ */
+DAPyWorkerPool::Result DAPyWorkerPool::call(const QString& function,
+                                            const QMap< QString, DAPyObjectWrapper >& frames,
+                                            const QVariantMap& kwargs,
+                                            int timeoutMs,
+                                            const std::function< bool() >& isCanceled)
+{
+	DAScriptTimeScope scriptTime;
+	Result res;
+	QMap< QString, DAPySharedFrame > sharedFrames;
+	for (auto i = frames.begin(); i != frames.end(); ++i) {
+		DAPySharedFrame f = writeShared(i.value(), &res.error);
+		if (f.isNull()) {
+			return res;
+		}
+		sharedFrames[ i.key() ] = f;
+	}
+	SharedResult sr = callShared(function, sharedFrames, kwargs, timeoutMs, isCanceled);
+	res.success     = sr.success;
+	res.canceled    = sr.canceled;
+	res.error       = sr.error;
+	res.value       = sr.value;
+	if (sr.frames.isEmpty()) {
+		return res;
+	}
+	// dataframe的复制和销毁都需要持有GIL
+	pybind11::gil_scoped_acquire gil;
+	for (auto i = sr.frames.begin(); i != sr.frames.end() && res.success; ++i) {
+		QString err;
+		DAPyDataFrame df = i.value().toDataFrame(&err);
+		if (!err.isEmpty()) {
+			res.success = false;
+			res.error   = err;
+			break;
+		}
+		res.frames.insert(i.key(), df);
+	}
+	return res;
+}
+
+/**
+ * @brief 在工作进程中调用python函数，输入输出都是共享内存中的dataframe
+ *
+ * 调用过程不获取GIL，调用线程持有GIL时等待期间会释放，请求交给已就绪的空闲工作进程执行
+ *
+ * 超时或者取消时，排队中的请求直接移除，正在执行的请求会结束对应的工作进程，
+ * 返回的@ref SharedResult::canceled 为true
+ * @param function 函数全名，格式为“模块.函数”
+ * @param frames dataframe或者series参数，key为参数名
+ * @param kwargs 其余参数，需要能转换为json
+ * @param timeoutMs 超时时间，小于0不超时，包含排队和工作进程启动的时间
+ * @param isCanceled 取消判断函数，等待期间定时调用，返回true时中止
+ * @param returnFrame 函数返回None时（直接修改输入的函数，如DAWorkbench.dataframe中的da_函数），
+ * 把名为returnFrame的dataframe参数作为结果result返回，为空时不返回
+ * @return
+ */
+DAPyWorkerPool::SharedResult DAPyWorkerPool::callShared(const QString& function,
+                                                        const QMap< QString, DAPySharedFrame >& frames,
+                                                        const QVariantMap& kwargs,
+                                                        int timeoutMs,
+                                                        const std::function< bool() >& isCanceled,
+                                                        const QString& returnFrame)
+{
+	DAScriptTimeScope scriptTime;
+	QElapsedTimer timer;
+	timer.start();
+	SharedResult res;
+	// 有工作进程退出时重新启动
+	if (!start()) {
+		res.error = tr("python worker pool can not start");  // cn:python工作进程池无法启动
+		return res;
+	}
+	QJsonObject framesObj;
+	for (auto i = frames.begin(); i != frames.end(); ++i) {
+		framesObj.insert(i.key(), i.value().getPath());
+	}
+	QJsonObject req;
+	req.insert("id", d_ptr->mNextID++);
+	req.insert("func", function);
+	req.insert("kwargs", QJsonObject::fromVariantMap(kwargs));
+	req.insert("frames", framesObj);
+	if (!returnFrame.isEmpty()) {
+		req.insert("return_frame", returnFrame);
+	}
+	DAPyWorkerTaskPtr task = std::make_shared< DAPyWorkerTask >();
+	task->request          = QJsonDocument(req).toJson(QJsonDocument::Compact) + '\n';
+	std::future< DAPyWorkerReply > future = task->promise.get_future();
+	std::shared_ptr< DAPyWorkerPoolCore > core = d_ptr->mCore;
+	{
+		QMutexLocker locker(&(core->mMutex));
+		core->mPending.push_back(task);
+		core->dispatchLocked();
+	}
+	// 等待回复，超时或者取消时放弃请求
+	auto waitReply = [ & ]() -> QString {
+		while (future.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready) {
+			QString reason;
+			if (task->canceled || (isCanceled && isCanceled())) {
+				reason = tr("python worker call is canceled");  // cn:python工作进程调用已取消
+			} else if (timeoutMs >= 0 && timer.elapsed() >= timeoutMs) {
+				reason = tr("python worker call timed out after %1 ms").arg(timeoutMs);  // cn:python工作进程调用超时
+			} else {
+				continue;
+			}
+			QMutexLocker locker(&(core->mMutex));
+			// 加锁后再确认一次，回复可能刚好到达
+			if (future.wait_for(std::chrono::milliseconds(0)) == std::future_status::ready) {
+				return QString();
+			}
+			core->abandonLocked(task);
+			return reason;
+		}
+		return QString();
+	};
+	QString abortReason;
+	if (PyGILState_Check()) {
+		// 等待期间释放GIL，让其他线程的python代码可以执行
+		pybind11::gil_scoped_release release;
+		abortReason = waitReply();
+	} else {
+		abortReason = waitReply();
+	}
+	// 输入文件由调用方的句柄负责删除
+	if (!abortReason.isEmpty()) {
+		res.canceled = true;
+		res.error    = abortReason;
+		return res;
+	}
+	const DAPyWorkerReply reply = future.get();
+	res.success = reply.success;
+	res.error   = reply.error;
+	res.value   = reply.value;
+	for (auto i = reply.framePaths.begin(); i != reply.framePaths.end(); ++i) {
+		res.frames[ i.key() ] = DAPySharedFrame(i.value());
+	}
+	return res;
+}
+
+}  // end DA
@@ -0,0 +1,123 @@
+﻿#ifndef DAPYWORKERPOOL_H
+#define DAPYWORKERPOOL_H
+#include <functional>
+#include <QObject>
+#include <QMap>
+#include <QVariant>
+#include "DAPyScriptsGlobal.h"
+#include "pandas/DAPyDataFrame.h"
+#include "DAPySharedFrame.h"
+namespace DA
+{
+
+/**
+ * @brief python工作进程池
+ *
+ * 内嵌解释器只有一个GIL，python计算量大的节点即使在不同线程中执行也会串行，
+ * 工作进程池启动多个本地python进程（基于@ref DAProcessWithThread ），每个进程有独立的解释器并加载DAWorkbench脚本，
+ * 可以真正利用多核执行python函数
+ *
+ * dataframe不经过管道传输，而是以Arrow IPC文件的形式写入共享内存目录（linux下为/dev/shm），
+ * 由对方以内存映射的方式读取，管道只传输一行json请求和回复，具体协议见PyScripts/DAWorkbench/worker.py
+ *
+ * 调度：工作进程加载完成后会先回复一行就绪消息，请求只派发给已就绪的空闲工作进程，
+ * 工作进程异常退出时它正在执行的请求返回失败，下次调用时会重新启动退出的工作进程
+ *
+ * 超时和取消：call可以指定超时时间和取消判断函数，@ref cancelAll 会取消所有正在等待的调用，
+ * 中止时排队中的请求直接移除，正在执行的请求会结束对应的工作进程（python函数无法中断），下次调用时重新启动
+ *
+ * 不经过主程序解释器的调用：@ref callShared 的输入输出都是共享内存文件的句柄（@ref DAPySharedFrame ），
+ * 整个调用过程不获取GIL，进程池执行的工作流节点之间直接传递句柄，
+ * 只有来自主程序的dataframe需要先通过@ref writeShared 写入共享内存（需要GIL）
+ *
+ * 用法，在节点的exec中调用（节点在执行器线程中运行，等待期间会释放GIL，不会阻塞界面和其他python节点），
+ * @ref DAPyScriptsDataProcess 在非主线程调用时会自动通过进程池执行：
+ * @code
+ * DAPyWorkerPool::Result r = DAPyWorkerPool::getInstance().call("DAWorkbench.data_processing.da_xxx",
+ *                                                               { { "df", df } },
+ *                                                               { { "window", 5 } });
+ * if (r.success) {
+ *     DAPyDataFrame out = r.frames.value("result");
+ * }
+ * @endcode
+ *
+ * @note 输入可以是DataFrame或者Series，Series在工作进程中仍然是Series；
+ * 函数返回DataFrame/Series时结果名为result（Series会转换为DataFrame），返回DataFrame的list/tuple时结果名为序号，返回dict时结果名为key，
+ * 其余返回值需要能被json序列化，通过@ref Result::value 获取
+ *
+ * @note Result持有python对象，和其他DAPy对象一样需要在持有GIL时销毁
+ */
+class DAPYSCRIPTS_API DAPyWorkerPool : public QObject
+{
+	Q_OBJECT
+	DA_DECLARE_PRIVATE(DAPyWorkerPool)
+public:
+	/**
+	 * @brief 调用结果
+	 */
+	struct DAPYSCRIPTS_API Result
+	{
+		bool success { false };                  ///< 是否成功
+		bool canceled { false };                 ///< 是否因超时或者取消而中止
+		QString error;                           ///< 错误信息，python异常时为traceback
+		QMap< QString, DAPyDataFrame > frames;  ///< 返回的dataframe
+		QVariant value;                          ///< 非dataframe的返回值
+	};
+
+	/**
+	 * @brief @ref callShared 的调用结果，dataframe保留在共享内存中，不持有python对象
+	 */
+	struct DAPYSCRIPTS_API SharedResult
+	{
+		bool success { false };                    ///< 是否成功
+		bool canceled { false };                   ///< 是否因超时或者取消而中止
+		QString error;                             ///< 错误信息，python异常时为traceback
+		QMap< QString, DAPySharedFrame > frames;  ///< 返回的dataframe
+		QVariant value;                            ///< 非dataframe的返回值
+	};
+
+public:
+	DAPyWorkerPool(QObject* par = nullptr);
+	~DAPyWorkerPool();
+	// 全局的进程池，可以在任意线程第一次获取，随QCoreApplication销毁
+	static DAPyWorkerPool& getInstance();
+	// python解释器路径，默认为DAPyInterpreter::getPythonInterpreterPath
+	void setPythonProgram(const QString& program);
+	QString getPythonProgram() const;
+	// PyScripts目录，默认为程序目录下的PyScripts
+	void setScriptsPath(const QString& path);
+	QString getScriptsPath() const;
+	// 共享内存目录，默认linux下为/dev/shm，其余为临时目录
+	void setSharedDir(const QString& dir);
+	QString getSharedDir() const;
+	// 工作进程数量，默认为cpu核数减1，需要在start之前设置
+	void setWorkerCount(int c);
+	int getWorkerCount() const;
+	// 启动/停止工作进程，call会自动启动
+	bool start();
+	void stop();
+	bool isStarted() const;
+	// 空闲的工作进程数量
+	int getIdleWorkerCount() const;
+	// 排队中的请求数量
+	int getPendingCount() const;
+	// 调用python函数，阻塞直到返回、超时或者取消，等待期间会释放当前线程持有的GIL
+	Result call(const QString& function,
+	            const QMap< QString, DAPyObjectWrapper >& frames = QMap< QString, DAPyObjectWrapper >(),
+	            const QVariantMap& kwargs                       = QVariantMap(),
+	            int timeoutMs                                   = -1,
+	            const std::function< bool() >& isCanceled       = std::function< bool() >());
+	// 调用python函数，输入输出都在共享内存中，整个过程不获取GIL
+	SharedResult callShared(const QString& function,
+	                        const QMap< QString, DAPySharedFrame >& frames = QMap< QString, DAPySharedFrame >(),
+	                        const QVariantMap& kwargs                     = QVariantMap(),
+	                        int timeoutMs                                 = -1,
+	                        const std::function< bool() >& isCanceled     = std::function< bool() >(),
+	                        const QString& returnFrame                    = QString());
+	// 把主程序中的dataframe或series写入共享内存，会获取GIL
+	DAPySharedFrame writeShared(const DAPyObjectWrapper& obj, QString* err = nullptr);
+	// 取消所有正在等待的调用
+	void cancelAll();
+};
+}  // end DA
+#endif  // DAPYWORKERPOOL_H
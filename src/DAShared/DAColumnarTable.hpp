@@ -0,0 +1,1484 @@
+﻿#ifndef DACOLUMNARTABLE_H
+#define DACOLUMNARTABLE_H
+// std
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+// Qt
+#include <QHash>
+#include <QList>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+namespace DA
+{
+
+/**
+ * @brief 按Align字节对齐的分配器，默认64字节（缓存行及avx-512的宽度）
+ */
+template< typename T, std::size_t Align = 64 >
+class DAAlignedAllocator
+{
+public:
+    using value_type = T;
+    template< typename U >
+    struct rebind
+    {
+        using other = DAAlignedAllocator< U, Align >;
+    };
+
+    DAAlignedAllocator() noexcept = default;
+    template< typename U >
+    DAAlignedAllocator(const DAAlignedAllocator< U, Align >&) noexcept
+    {
+    }
+    T* allocate(std::size_t n)
+    {
+        return static_cast< T* >(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+    template< typename U >
+    bool operator==(const DAAlignedAllocator< U, Align >&) const noexcept
+    {
+        return true;
+    }
+    template< typename U >
+    bool operator!=(const DAAlignedAllocator< U, Align >&) const noexcept
+    {
+        return false;
+    }
+};
+
+template< typename T >
+using DAAlignedVector = std::vector< T, DAAlignedAllocator< T > >;
+
+/**
+ * @brief 有效位图，每一位代表一个元素是否有效（非null）
+ */
+class DAColumnarBitmap
+{
+public:
+    DAColumnarBitmap() = default;
+    std::size_t size() const
+    {
+        return mSize;
+    }
+    void reserve(std::size_t n)
+    {
+        mWords.reserve((n + 63) / 64);
+    }
+    void resize(std::size_t n, bool valid = true)
+    {
+        const std::size_t old = mSize;
+        mWords.resize((n + 63) / 64, valid ? ~std::uint64_t(0) : std::uint64_t(0));
+        mSize = n;
+        for (std::size_t i = old; i < n && (i % 64) != 0; ++i) {
+            set(i, valid);
+        }
+        clearTail();
+    }
+    void append(bool valid)
+    {
+        if ((mSize % 64) == 0) {
+            mWords.push_back(0);
+        }
+        ++mSize;
+        set(mSize - 1, valid);
+    }
+    bool get(std::size_t i) const
+    {
+        return (mWords[ i >> 6 ] >> (i & 63)) & 1u;
+    }
+    void set(std::size_t i, bool valid)
+    {
+        const std::uint64_t bit = std::uint64_t(1) << (i & 63);
+        if (valid) {
+            mWords[ i >> 6 ] |= bit;
+        } else {
+            mWords[ i >> 6 ] &= ~bit;
+        }
+    }
+    // 无效位的数量
+    std::size_t countInvalid() const
+    {
+        std::size_t valid = 0;
+        for (std::uint64_t w : mWords) {
+            valid += std::bitset< 64 >(w).count();
+        }
+        return mSize - valid;
+    }
+    void clear()
+    {
+        mWords.clear();
+        mSize = 0;
+    }
+    const DAAlignedVector< std::uint64_t >& words() const
+    {
+        return mWords;
+    }
+
+private:
+    // 保证超出size的位为0
+    void clearTail()
+    {
+        if ((mSize % 64) != 0 && !mWords.empty()) {
+            mWords.back() &= (std::uint64_t(1) << (mSize % 64)) - 1;
+        }
+    }
+
+private:
+    DAAlignedVector< std::uint64_t > mWords;
+    std::size_t mSize { 0 };
+};
+
+/**
+ * @brief 列式表的一列
+ *
+ * 每列只有一种类型，数据存放在64字节对齐的连续内存中，null通过有效位图记录（null位置的数据为0）：
+ * - Bool存为uint8
+ * - Int64/Double直接存放
+ * - String使用字典编码，数据为int32的编码，字典由列持有，take等操作产生的新列共享字典
+ *
+ * 浮点数写入Int64列时向0截断，NaN、±inf和超出Int64范围的值为null（见@ref toInt64 ）
+ */
+class DAColumnarColumn
+{
+public:
+    enum Type
+    {
+        Bool,
+        Int64,
+        Double,
+        String
+    };
+    using Ptr = std::shared_ptr< DAColumnarColumn >;
+
+    /**
+     * @brief 字符串字典
+     */
+    struct Dictionary
+    {
+        QStringList values;
+        QHash< QString, std::int32_t > codes;
+        std::int32_t encode(const QString& s)
+        {
+            auto i = codes.find(s);
+            if (i != codes.end()) {
+                return i.value();
+            }
+            const std::int32_t c = static_cast< std::int32_t >(values.size());
+            values.append(s);
+            codes.insert(s, c);
+            return c;
+        }
+        std::int32_t find(const QString& s) const
+        {
+            return codes.value(s, -1);
+        }
+    };
+
+public:
+    DAColumnarColumn(Type t, const QString& name = QString()) : mType(t), mName(name)
+    {
+        if (t == String) {
+            mDict = std::make_shared< Dictionary >();
+        }
+    }
+    static Ptr make(Type t, const QString& name = QString())
+    {
+        return std::make_shared< DAColumnarColumn >(t, name);
+    }
+    /**
+     * @brief 浮点数向0截断为Int64
+     *
+     * 直接static_cast非有限值或超出范围的值是未定义行为，因此先检查
+     * @return 值为NaN、±inf或截断后超出Int64范围时返回false，out不变
+     */
+    static bool toInt64(double v, std::int64_t& out)
+    {
+        // 2^63可以用double精确表示，截断后小于2^63且大于等于-2^63的值都在范围内
+        constexpr double limit = 9223372036854775808.0;
+        if (!std::isfinite(v) || v >= limit || v < -limit) {
+            return false;
+        }
+        out = static_cast< std::int64_t >(v);
+        return true;
+    }
+
+    Type type() const
+    {
+        return mType;
+    }
+    bool isNumeric() const
+    {
+        return mType != String;
+    }
+    QString name() const
+    {
+        return mName;
+    }
+    void setName(const QString& n)
+    {
+        mName = n;
+    }
+    std::size_t size() const
+    {
+        return mValidity.size();
+    }
+    std::size_t nullCount() const
+    {
+        return mNullCount;
+    }
+    bool isNull(std::size_t i) const
+    {
+        return mNullCount > 0 && !mValidity.get(i);
+    }
+    void reserve(std::size_t n)
+    {
+        mValidity.reserve(n);
+        switch (mType) {
+        case Bool:
+            mBools.reserve(n);
+            break;
+        case Int64:
+            mInts.reserve(n);
+            break;
+        case Double:
+            mDoubles.reserve(n);
+            break;
+        case String:
+            mCodes.reserve(n);
+            break;
+        }
+    }
+
+    // 追加
+    void appendNull()
+    {
+        switch (mType) {
+        case Bool:
+            mBools.push_back(0);
+            break;
+        case Int64:
+            mInts.push_back(0);
+            break;
+        case Double:
+            mDoubles.push_back(0.0);
+            break;
+        case String:
+            mCodes.push_back(0);
+            break;
+        }
+        mValidity.append(false);
+        ++mNullCount;
+    }
+    void appendBool(bool v)
+    {
+        if (mType != Bool) {
+            appendDouble(v ? 1.0 : 0.0);
+            return;
+        }
+        mBools.push_back(v ? 1 : 0);
+        mValidity.append(true);
+    }
+    void appendInt(std::int64_t v)
+    {
+        switch (mType) {
+        case Int64:
+            mInts.push_back(v);
+            mValidity.append(true);
+            break;
+        case Double:
+            appendDouble(static_cast< double >(v));
+            break;
+        case Bool:
+            appendBool(v != 0);
+            break;
+        case String:
+            appendString(QString::number(v));
+            break;
+        }
+    }
+    void appendDouble(double v)
+    {
+        switch (mType) {
+        case Double:
+            mDoubles.push_back(v);
+            mValidity.append(true);
+            break;
+        case Int64: {
+            std::int64_t i = 0;
+            if (toInt64(v, i)) {
+                mInts.push_back(i);
+                mValidity.append(true);
+            } else {
+                appendNull();
+            }
+            break;
+        }
+        case Bool:
+            appendBool(v != 0.0);
+            break;
+        case String:
+            appendString(QString::number(v));
+            break;
+        }
+    }
+    void appendString(const QString& v)
+    {
+        if (mType != String) {
+            append(QVariant(v));
+            return;
+        }
+        mCodes.push_back(mDict->encode(v));
+        mValidity.append(true);
+    }
+    /**
+     * @brief 追加一个QVariant，无效的QVariant或者无法转换的值为null
+     */
+    void append(const QVariant& v)
+    {
+        if (!v.isValid() || v.isNull()) {
+            appendNull();
+            return;
+        }
+        bool ok = true;
+        switch (mType) {
+        case Bool:
+            appendBool(v.toBool());
+            return;
+        case Int64: {
+            if (isFloatingPoint(v)) {
+                // QVariant把浮点数转换为整数时不检查范围
+                appendDouble(v.toDouble());
+                return;
+            }
+            const qlonglong i = v.toLongLong(&ok);
+            ok ? appendInt(i) : appendNull();
+            return;
+        }
+        case Double: {
+            const double d = v.toDouble(&ok);
+            ok ? appendDouble(d) : appendNull();
+            return;
+        }
+        case String:
+            appendString(v.toString());
+            return;
+        }
+    }
+
+    // QVariant是否为浮点数
+    static bool isFloatingPoint(const QVariant& v)
+    {
+        const int t = v.userType();
+        return t == QMetaType::Double || t == QMetaType::Float;
+    }
+
+    // 读取
+    bool boolAt(std::size_t i) const
+    {
+        switch (mType) {
+        case Bool:
+            return mBools[ i ] != 0;
+        case Int64:
+            return mInts[ i ] != 0;
+        case Double:
+            return mDoubles[ i ] != 0.0;
+        case String:
+            return !mDict->values.at(mCodes[ i ]).isEmpty();
+        }
+        return false;
+    }
+    // 无法转换为Int64的值（例如Double列的NaN、±inf）返回0
+    std::int64_t intAt(std::size_t i) const
+    {
+        switch (mType) {
+        case Bool:
+            return mBools[ i ];
+        case Int64:
+            return mInts[ i ];
+        case Double: {
+            std::int64_t v = 0;
+            toInt64(mDoubles[ i ], v);
+            return v;
+        }
+        case String:
+            return mDict->values.at(mCodes[ i ]).toLongLong();
+        }
+        return 0;
+    }
+    // null为NaN
+    double doubleAt(std::size_t i) const
+    {
+        if (isNull(i)) {
+            return std::numeric_limits< double >::quiet_NaN();
+        }
+        switch (mType) {
+        case Bool:
+            return mBools[ i ];
+        case Int64:
+            return static_cast< double >(mInts[ i ]);
+        case Double:
+            return mDoubles[ i ];
+        case String: {
+            bool ok         = false;
+            const double d  = mDict->values.at(mCodes[ i ]).toDouble(&ok);
+            return ok ? d : std::numeric_limits< double >::quiet_NaN();
+        }
+        }
+        return 0.0;
+    }
+    QString stringAt(std::size_t i) const
+    {
+        if (isNull(i)) {
+            return QString();
+        }
+        switch (mType) {
+        case Bool:
+            return mBools[ i ] ? QStringLiteral("true") : QStringLiteral("false");
+        case Int64:
+            return QString::number(mInts[ i ]);
+        case Double:
+            return QString::number(mDoubles[ i ]);
+        case String:
+            return mDict->values.at(mCodes[ i ]);
+        }
+        return QString();
+    }
+    // null返回无效的QVariant
+    QVariant value(std::size_t i) const
+    {
+        if (isNull(i)) {
+            return QVariant();
+        }
+        switch (mType) {
+        case Bool:
+            return QVariant(mBools[ i ] != 0);
+        case Int64:
+            return QVariant(static_cast< qlonglong >(mInts[ i ]));
+        case Double:
+            return QVariant(mDoubles[ i ]);
+        case String:
+            return QVariant(mDict->values.at(mCodes[ i ]));
+        }
+        return QVariant();
+    }
+
+    // 原始数据，供计算内核使用
+    const std::uint8_t* boolData() const
+    {
+        return mBools.data();
+    }
+    const std::int64_t* intData() const
+    {
+        return mInts.data();
+    }
+    const double* doubleData() const
+    {
+        return mDoubles.data();
+    }
+    const std::int32_t* codeData() const
+    {
+        return mCodes.data();
+    }
+    const DAColumnarBitmap& validity() const
+    {
+        return mValidity;
+    }
+    // 字符串列的字典
+    std::shared_ptr< Dictionary > dictionary() const
+    {
+        return mDict;
+    }
+
+    /**
+     * @brief 按索引收集元素形成新列，索引为负代表null
+     *
+     * 字符串列的新列和原列共享字典
+     */
+    Ptr take(const std::vector< std::int64_t >& indices) const
+    {
+        Ptr res   = make(mType, mName);
+        res->mDict = mDict;
+        const std::size_t n = indices.size();
+        res->mValidity.resize(n, true);
+        switch (mType) {
+        case Bool:
+            res->mBools.resize(n);
+            gather(mBools.data(), indices, res->mBools.data());
+            break;
+        case Int64:
+            res->mInts.resize(n);
+            gather(mInts.data(), indices, res->mInts.data());
+            break;
+        case Double:
+            res->mDoubles.resize(n);
+            gather(mDoubles.data(), indices, res->mDoubles.data());
+            break;
+        case String:
+            res->mCodes.resize(n);
+            gather(mCodes.data(), indices, res->mCodes.data());
+            break;
+        }
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::int64_t src = indices[ i ];
+            if (src < 0 || isNull(static_cast< std::size_t >(src))) {
+                res->mValidity.set(i, false);
+                ++(res->mNullCount);
+            }
+        }
+        return res;
+    }
+
+    /**
+     * @brief 转换为double序列，null为NaN，用于绘图
+     */
+    QVector< double > toDoubleVector() const
+    {
+        QVector< double > res(static_cast< int >(size()));
+        for (std::size_t i = 0; i < size(); ++i) {
+            res[ static_cast< int >(i) ] = doubleAt(i);
+        }
+        return res;
+    }
+
+private:
+    template< typename T >
+    static void gather(const T* src, const std::vector< std::int64_t >& indices, T* dst)
+    {
+        const std::size_t n = indices.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const std::int64_t s = indices[ i ];
+            dst[ i ]             = (s < 0) ? T() : src[ s ];
+        }
+    }
+
+private:
+    Type mType;
+    QString mName;
+    DAColumnarBitmap mValidity;
+    std::size_t mNullCount { 0 };
+    DAAlignedVector< std::uint8_t > mBools;
+    DAAlignedVector< std::int64_t > mInts;
+    DAAlignedVector< double > mDoubles;
+    DAAlignedVector< std::int32_t > mCodes;
+    std::shared_ptr< Dictionary > mDict;
+};
+
+/**
+ * @brief 多类型的列式表
+ *
+ * 和@ref DAColumnTable 每列同一类型不同，每列可以是不同的类型（@ref DAColumnarColumn::Type ），
+ * 并提供过滤、排序、分组聚合、连接等计算内核，计算在C++中完成，不依赖python
+ *
+ * 内核都返回新表，未改变的列在新表和原表之间共享，因此表的复制很廉价，
+ * 复制后的表对列的追加操作会影响共享该列的其他表，需要独立修改时应先take
+ *
+ * @code
+ * DAColumnarTable t;
+ * t.addColumn(DAColumnarColumn::String, "name");
+ * t.addColumn(DAColumnarColumn::Double, "value");
+ * t.appendRow({ "a", 1.0 });
+ * t.appendRow({ "b", 2.0 });
+ * t.appendRow({ "a", 3.0 });
+ * DAColumnarTable big = t.filter(t.compare(1, DAColumnarTable::Greater, 1.5));
+ * DAColumnarTable sum = t.groupBy({ 0 }, { { 1, DAColumnarTable::Sum } });
+ * @endcode
+ */
+class DAColumnarTable
+{
+public:
+    using ColumnPtr = DAColumnarColumn::Ptr;
+    using Mask      = DAAlignedVector< std::uint8_t >;  ///< 行掩码，非0为选中
+    using Indices   = std::vector< std::int64_t >;      ///< 行索引，负数代表null
+
+    enum CompareOp
+    {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+    enum Aggregate
+    {
+        Count,  ///< 非null的数量
+        Sum,    ///< Int64列的结果为Int64，其余为Double
+        Mean,   ///< 结果为Double
+        Min,    ///< Int64列的结果为Int64，其余为Double
+        Max,    ///< Int64列的结果为Int64，其余为Double
+        First   ///< 分组的第一个值，保留原列的类型
+    };
+    enum JoinType
+    {
+        InnerJoin,
+        LeftJoin
+    };
+    /**
+     * @brief 排序的键
+     */
+    struct SortKey
+    {
+        int column { 0 };
+        bool ascending { true };
+    };
+    /**
+     * @brief 聚合的描述
+     */
+    struct AggregateSpec
+    {
+        int column { 0 };
+        Aggregate aggregate { Sum };
+        QString name;  ///< 结果列名，为空时为“列名_聚合名”
+    };
+
+public:
+    DAColumnarTable() = default;
+
+    int rowCount() const
+    {
+        return static_cast< int >(mRows);
+    }
+    int columnCount() const
+    {
+        return static_cast< int >(mColumns.size());
+    }
+    bool isEmpty() const
+    {
+        return mColumns.empty();
+    }
+    void clear()
+    {
+        mColumns.clear();
+        mRows = 0;
+    }
+
+    // 添加一个空列，表中已经有数据时用null填充
+    ColumnPtr addColumn(DAColumnarColumn::Type t, const QString& name)
+    {
+        ColumnPtr c = DAColumnarColumn::make(t, name);
+        c->reserve(mRows);
+        for (std::size_t i = 0; i < mRows; ++i) {
+            c->appendNull();
+        }
+        mColumns.push_back(c);
+        return c;
+    }
+    // 添加一个已有的列，列的长度需要和表的行数一致（空表除外）
+    bool addColumn(const ColumnPtr& c)
+    {
+        if (!c || (!mColumns.empty() && c->size() != mRows)) {
+            return false;
+        }
+        mRows = c->size();
+        mColumns.push_back(c);
+        return true;
+    }
+    // 移除一列，索引越界时返回false
+    bool removeColumn(int c)
+    {
+        if (c < 0 || c >= columnCount()) {
+            return false;
+        }
+        mColumns.erase(mColumns.begin() + c);
+        if (mColumns.empty()) {
+            mRows = 0;
+        }
+        return true;
+    }
+    ColumnPtr column(int c) const
+    {
+        return mColumns.at(static_cast< std::size_t >(c));
+    }
+    ColumnPtr column(const QString& n) const
+    {
+        const int c = columnIndex(n);
+        return c < 0 ? nullptr : mColumns[ static_cast< std::size_t >(c) ];
+    }
+    int columnIndex(const QString& n) const
+    {
+        for (std::size_t i = 0; i < mColumns.size(); ++i) {
+            if (mColumns[ i ]->name() == n) {
+                return static_cast< int >(i);
+            }
+        }
+        return -1;
+    }
+    QStringList columnNames() const
+    {
+        QStringList res;
+        for (const ColumnPtr& c : mColumns) {
+            res.append(c->name());
+        }
+        return res;
+    }
+    // 追加一行，不足的列为null
+    void appendRow(const QVariantList& row)
+    {
+        for (std::size_t i = 0; i < mColumns.size(); ++i) {
+            mColumns[ i ]->append(i < static_cast< std::size_t >(row.size()) ? row.at(static_cast< int >(i)) : QVariant());
+        }
+        if (!mColumns.empty()) {
+            ++mRows;
+        }
+    }
+    QVariant value(int r, int c) const
+    {
+        return mColumns.at(static_cast< std::size_t >(c))->value(static_cast< std::size_t >(r));
+    }
+    // 两列组成点序列，任意一个为null的行跳过，用于绘图
+    QVector< QPointF > toPoints(int xc, int yc) const
+    {
+        QVector< QPointF > res;
+        res.reserve(static_cast< int >(mRows));
+        const ColumnPtr& x = mColumns.at(static_cast< std::size_t >(xc));
+        const ColumnPtr& y = mColumns.at(static_cast< std::size_t >(yc));
+        for (std::size_t i = 0; i < mRows; ++i) {
+            if (!x->isNull(i) && !y->isNull(i)) {
+                res.append(QPointF(x->doubleAt(i), y->doubleAt(i)));
+            }
+        }
+        return res;
+    }
+
+    //----------------------------------------------------
+    // 内核
+    //----------------------------------------------------
+
+    /**
+     * @brief 列和标量比较，生成行掩码，null不满足任何比较
+     *
+     * 数值列在连续内存上逐元素比较，字符串列先对字典中的每个值比较一次，再按编码查表
+     *
+     * 数值列和无法转换为数值的标量（例如"abc"）比较时，不会把标量当作0，NotEqual对所有非null行成立，其余比较都不成立
+     */
+    Mask compare(int c, CompareOp op, const QVariant& v) const
+    {
+        const ColumnPtr& col = mColumns.at(static_cast< std::size_t >(c));
+        Mask m(mRows, 0);
+        if (mRows == 0 || !v.isValid()) {
+            return m;
+        }
+        if (col->type() == DAColumnarColumn::Double || col->type() == DAColumnarColumn::Int64) {
+            bool numeric = false;
+            v.toDouble(&numeric);
+            if (!numeric) {
+                if (op == NotEqual) {
+                    std::fill(m.begin(), m.end(), 1);
+                    applyValidity(*col, m);
+                }
+                return m;
+            }
+        }
+        switch (col->type()) {
+        case DAColumnarColumn::Double:
+            compareKernel(col->doubleData(), mRows, op, v.toDouble(), m.data());
+            break;
+        case DAColumnarColumn::Int64: {
+            bool ok         = false;
+            std::int64_t iv = 0;
+            const double dv = v.toDouble();
+            if (DAColumnarColumn::isFloatingPoint(v)) {
+                ok = DAColumnarColumn::toInt64(dv, iv);
+            } else {
+                iv = v.toLongLong(&ok);
+            }
+            if (ok && static_cast< double >(iv) == dv) {
+                compareKernel(col->intData(), mRows, op, static_cast< std::int64_t >(iv), m.data());
+            } else {
+                // 和非整数比较，转为double
+                std::vector< double > tmp(col->intData(), col->intData() + mRows);
+                compareKernel(tmp.data(), mRows, op, dv, m.data());
+            }
+            break;
+        }
+        case DAColumnarColumn::Bool:
+            compareKernel(col->boolData(), mRows, op, static_cast< std::uint8_t >(v.toBool() ? 1 : 0), m.data());
+            break;
+        case DAColumnarColumn::String: {
+            const QStringList& dict = col->dictionary()->values;
+            const QString s         = v.toString();
+            std::vector< std::uint8_t > codeMatch(static_cast< std::size_t >(dict.size()));
+            for (int i = 0; i < dict.size(); ++i) {
+                codeMatch[ static_cast< std::size_t >(i) ] = compareValue(dict.at(i).compare(s), 0, op);
+            }
+            const std::int32_t* codes = col->codeData();
+            for (std::size_t i = 0; i < mRows; ++i) {
+                m[ i ] = codeMatch[ static_cast< std::size_t >(codes[ i ]) ];
+            }
+            break;
+        }
+        }
+        applyValidity(*col, m);
+        return m;
+    }
+    // 列是否为null的掩码
+    Mask isNullMask(int c, bool null = true) const
+    {
+        const ColumnPtr& col = mColumns.at(static_cast< std::size_t >(c));
+        Mask m(mRows, null ? 0 : 1);
+        if (col->nullCount() > 0) {
+            for (std::size_t i = 0; i < mRows; ++i) {
+                m[ i ] = (col->isNull(i) == null) ? 1 : 0;
+            }
+        }
+        return m;
+    }
+    static Mask maskAnd(const Mask& a, const Mask& b)
+    {
+        Mask r(std::min(a.size(), b.size()));
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            r[ i ] = a[ i ] & b[ i ];
+        }
+        return r;
+    }
+    static Mask maskOr(const Mask& a, const Mask& b)
+    {
+        Mask r(std::min(a.size(), b.size()));
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            r[ i ] = a[ i ] | b[ i ];
+        }
+        return r;
+    }
+    static Mask maskNot(const Mask& a)
+    {
+        Mask r(a.size());
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            r[ i ] = a[ i ] ? 0 : 1;
+        }
+        return r;
+    }
+
+    // 按行索引收集，生成新表
+    DAColumnarTable take(const Indices& indices) const
+    {
+        DAColumnarTable res;
+        for (const ColumnPtr& c : mColumns) {
+            res.mColumns.push_back(c->take(indices));
+        }
+        res.mRows = res.mColumns.empty() ? 0 : indices.size();
+        return res;
+    }
+
+    // 保留掩码选中的行
+    DAColumnarTable filter(const Mask& mask) const
+    {
+        Indices indices;
+        indices.reserve(static_cast< std::size_t >(std::count_if(mask.begin(), mask.end(), [](std::uint8_t v) { return v != 0; })));
+        const std::size_t n = std::min(mask.size(), mRows);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (mask[ i ]) {
+                indices.push_back(static_cast< std::int64_t >(i));
+            }
+        }
+        return take(indices);
+    }
+
+    /**
+     * @brief 排序后的行索引，稳定排序，null总是排在最后
+     *
+     * 字符串列先对字典排序得到每个编码的序号，比较时只比较整数
+     */
+    Indices sortIndices(const QList< SortKey >& keys) const
+    {
+        Indices indices(mRows);
+        std::iota(indices.begin(), indices.end(), 0);
+        if (keys.isEmpty()) {
+            return indices;
+        }
+        std::vector< KeyView > views;
+        for (const SortKey& k : keys) {
+            views.push_back(makeKeyView(*mColumns.at(static_cast< std::size_t >(k.column)), k.ascending));
+        }
+        std::stable_sort(indices.begin(), indices.end(), [ &views ](std::int64_t a, std::int64_t b) {
+            for (const KeyView& v : views) {
+                const int r = v.compare(static_cast< std::size_t >(a), static_cast< std::size_t >(b));
+                if (r != 0) {
+                    return r < 0;
+                }
+            }
+            return false;
+        });
+        return indices;
+    }
+    DAColumnarTable sort(const QList< SortKey >& keys) const
+    {
+        return take(sortIndices(keys));
+    }
+
+    /**
+     * @brief 哈希分组聚合
+     *
+     * 结果表依次为分组列和聚合列，分组按首次出现的顺序排列，null作为一个单独的分组
+     * @param keys 分组列
+     * @param aggs 聚合
+     */
+    DAColumnarTable groupBy(const QList< int >& keys, const QList< AggregateSpec >& aggs) const
+    {
+        // 每行的分组号
+        std::vector< std::int32_t > groupOfRow(mRows, 0);
+        Indices firstRows;
+        if (keys.isEmpty()) {
+            if (mRows > 0) {
+                firstRows.push_back(0);
+            }
+        } else {
+            std::vector< const DAColumnarColumn* > keyCols;
+            for (int k : keys) {
+                keyCols.push_back(mColumns.at(static_cast< std::size_t >(k)).get());
+            }
+            std::unordered_map< std::vector< std::int64_t >, std::int32_t, KeyHash > groups;
+            groups.reserve(mRows / 4 + 16);
+            std::vector< std::int64_t > key(keyCols.size() * 2);
+            for (std::size_t r = 0; r < mRows; ++r) {
+                for (std::size_t k = 0; k < keyCols.size(); ++k) {
+                    encodeKey(*keyCols[ k ], r, key[ 2 * k ], key[ 2 * k + 1 ]);
+                }
+                auto it = groups.find(key);
+                if (it == groups.end()) {
+                    it = groups.emplace(key, static_cast< std::int32_t >(firstRows.size())).first;
+                    firstRows.push_back(static_cast< std::int64_t >(r));
+                }
+                groupOfRow[ r ] = it->second;
+            }
+        }
+        const std::size_t groupCount = firstRows.size();
+        DAColumnarTable res;
+        for (int k : keys) {
+            res.mColumns.push_back(mColumns.at(static_cast< std::size_t >(k))->take(firstRows));
+        }
+        for (const AggregateSpec& a : aggs) {
+            ColumnPtr c = aggregateColumn(*mColumns.at(static_cast< std::size_t >(a.column)), a.aggregate, groupOfRow, firstRows);
+            c->setName(a.name.isEmpty() ? QString("%1_%2").arg(mColumns.at(static_cast< std::size_t >(a.column))->name(), aggregateName(a.aggregate))
+                                        : a.name);
+            res.mColumns.push_back(c);
+        }
+        res.mRows = res.mColumns.empty() ? 0 : groupCount;
+        return res;
+    }
+
+    /**
+     * @brief 哈希连接
+     *
+     * 对右表的键建立哈希表，再逐行探测左表，结果为左表所有列加右表的非键列，右表列名冲突时加后缀_right，
+     * null键不匹配任何行；字符串键的编码先映射到左表的字典，整数和浮点键按数值比较
+     * @param right 右表
+     * @param leftKeys 左表的键
+     * @param rightKeys 右表的键，数量需要和leftKeys一致
+     * @param t 连接方式
+     */
+    DAColumnarTable join(const DAColumnarTable& right, const QList< int >& leftKeys, const QList< int >& rightKeys, JoinType t = InnerJoin) const
+    {
+        DAColumnarTable res;
+        if (leftKeys.size() != rightKeys.size() || leftKeys.isEmpty()) {
+            return res;
+        }
+        const std::size_t nk = static_cast< std::size_t >(leftKeys.size());
+        std::vector< JoinKeyView > leftViews, rightViews;
+        for (std::size_t k = 0; k < nk; ++k) {
+            const DAColumnarColumn& lc = *mColumns.at(static_cast< std::size_t >(leftKeys[ static_cast< int >(k) ]));
+            const DAColumnarColumn& rc = *right.mColumns.at(static_cast< std::size_t >(rightKeys[ static_cast< int >(k) ]));
+            makeJoinKeyViews(lc, rc, leftViews, rightViews);
+        }
+        // 右表建立哈希链
+        std::unordered_map< std::vector< std::int64_t >, std::int64_t, KeyHash > heads;
+        heads.reserve(right.mRows + 16);
+        std::vector< std::int64_t > next(right.mRows, -1);
+        std::vector< std::int64_t > key(nk);
+        for (std::size_t r = right.mRows; r-- > 0;) {
+            if (!buildJoinKey(rightViews, r, key)) {
+                continue;
+            }
+            auto it = heads.find(key);
+            if (it == heads.end()) {
+                heads.emplace(key, static_cast< std::int64_t >(r));
+            } else {
+                next[ r ]  = it->second;
+                it->second = static_cast< std::int64_t >(r);
+            }
+        }
+        // 探测左表
+        Indices leftIdx, rightIdx;
+        leftIdx.reserve(mRows);
+        rightIdx.reserve(mRows);
+        for (std::size_t l = 0; l < mRows; ++l) {
+            bool matched = false;
+            if (buildJoinKey(leftViews, l, key)) {
+                auto it = heads.find(key);
+                if (it != heads.end()) {
+                    for (std::int64_t r = it->second; r >= 0; r = next[ static_cast< std::size_t >(r) ]) {
+                        leftIdx.push_back(static_cast< std::int64_t >(l));
+                        rightIdx.push_back(r);
+                        matched = true;
+                    }
+                }
+            }
+            if (!matched && t == LeftJoin) {
+                leftIdx.push_back(static_cast< std::int64_t >(l));
+                rightIdx.push_back(-1);
+            }
+        }
+        res = take(leftIdx);
+        const QStringList leftNames = columnNames();
+        for (int c = 0; c < right.columnCount(); ++c) {
+            if (rightKeys.contains(c)) {
+                continue;
+            }
+            ColumnPtr col = right.mColumns[ static_cast< std::size_t >(c) ]->take(rightIdx);
+            if (leftNames.contains(col->name())) {
+                col->setName(col->name() + QStringLiteral("_right"));
+            }
+            res.mColumns.push_back(col);
+        }
+        res.mRows = leftIdx.size();
+        return res;
+    }
+
+    /**
+     * @brief 对一列做聚合，忽略null
+     * @return 没有有效值时Count为0，其余为无效的QVariant
+     */
+    QVariant aggregate(int c, Aggregate a) const
+    {
+        const DAColumnarColumn& col = *mColumns.at(static_cast< std::size_t >(c));
+        std::vector< std::int32_t > groupOfRow(mRows, 0);
+        Indices first;
+        if (mRows > 0) {
+            first.push_back(0);
+        }
+        ColumnPtr r = aggregateColumn(col, a, groupOfRow, first);
+        if (r->size() == 0) {
+            return (a == Count) ? QVariant(0) : QVariant();
+        }
+        return r->value(0);
+    }
+
+    static QString aggregateName(Aggregate a)
+    {
+        switch (a) {
+        case Count:
+            return QStringLiteral("count");
+        case Sum:
+            return QStringLiteral("sum");
+        case Mean:
+            return QStringLiteral("mean");
+        case Min:
+            return QStringLiteral("min");
+        case Max:
+            return QStringLiteral("max");
+        case First:
+            return QStringLiteral("first");
+        }
+        return QString();
+    }
+
+private:
+    template< typename A, typename B >
+    static std::uint8_t compareValue(const A& a, const B& b, CompareOp op)
+    {
+        switch (op) {
+        case Equal:
+            return a == b;
+        case NotEqual:
+            return a != b;
+        case Less:
+            return a < b;
+        case LessEqual:
+            return a <= b;
+        case Greater:
+            return a > b;
+        case GreaterEqual:
+            return a >= b;
+        }
+        return 0;
+    }
+
+    // 分支在循环外，循环体可以被编译器向量化
+    template< typename T >
+    static void compareKernel(const T* d, std::size_t n, CompareOp op, T v, std::uint8_t* out)
+    {
+        switch (op) {
+        case Equal:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] == v;
+            }
+            break;
+        case NotEqual:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] != v;
+            }
+            break;
+        case Less:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] < v;
+            }
+            break;
+        case LessEqual:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] <= v;
+            }
+            break;
+        case Greater:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] > v;
+            }
+            break;
+        case GreaterEqual:
+            for (std::size_t i = 0; i < n; ++i) {
+                out[ i ] = d[ i ] >= v;
+            }
+            break;
+        }
+    }
+
+    // null的行掩码置0，按64位一组处理
+    void applyValidity(const DAColumnarColumn& col, Mask& m) const
+    {
+        if (col.nullCount() == 0) {
+            return;
+        }
+        const DAAlignedVector< std::uint64_t >& words = col.validity().words();
+        for (std::size_t w = 0; w < words.size(); ++w) {
+            const std::uint64_t bits = words[ w ];
+            if (bits == ~std::uint64_t(0)) {
+                continue;
+            }
+            const std::size_t end = std::min(mRows, (w + 1) * 64);
+            for (std::size_t i = w * 64; i < end; ++i) {
+                m[ i ] &= static_cast< std::uint8_t >((bits >> (i & 63)) & 1u);
+            }
+        }
+    }
+
+    /**
+     * @brief 排序时一列的视图
+     */
+    struct KeyView
+    {
+        const DAColumnarColumn* col { nullptr };
+        bool ascending { true };
+        std::vector< std::int32_t > rank;  ///< 字符串编码的序号
+        int compare(std::size_t a, std::size_t b) const
+        {
+            const bool na = col->isNull(a);
+            const bool nb = col->isNull(b);
+            if (na || nb) {
+                return (na == nb) ? 0 : (na ? 1 : -1);
+            }
+            int r = 0;
+            switch (col->type()) {
+            case DAColumnarColumn::Bool:
+                r = cmp(col->boolData()[ a ], col->boolData()[ b ]);
+                break;
+            case DAColumnarColumn::Int64:
+                r = cmp(col->intData()[ a ], col->intData()[ b ]);
+                break;
+            case DAColumnarColumn::Double:
+                r = cmpDouble(col->doubleData()[ a ], col->doubleData()[ b ]);
+                break;
+            case DAColumnarColumn::String:
+                r = cmp(rank[ static_cast< std::size_t >(col->codeData()[ a ]) ], rank[ static_cast< std::size_t >(col->codeData()[ b ]) ]);
+                break;
+            }
+            return ascending ? r : -r;
+        }
+        template< typename T >
+        static int cmp(const T& a, const T& b)
+        {
+            return (a < b) ? -1 : ((b < a) ? 1 : 0);
+        }
+        // NaN排在最后
+        static int cmpDouble(double a, double b)
+        {
+            const bool na = std::isnan(a);
+            const bool nb = std::isnan(b);
+            if (na || nb) {
+                return (na == nb) ? 0 : (na ? 1 : -1);
+            }
+            return cmp(a, b);
+        }
+    };
+
+    static KeyView makeKeyView(const DAColumnarColumn& col, bool ascending)
+    {
+        KeyView v;
+        v.col       = &col;
+        v.ascending = ascending;
+        if (col.type() == DAColumnarColumn::String) {
+            const QStringList& dict = col.dictionary()->values;
+            std::vector< std::int32_t > order(static_cast< std::size_t >(dict.size()));
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [ &dict ](std::int32_t a, std::int32_t b) { return dict.at(a) < dict.at(b); });
+            v.rank.resize(order.size());
+            for (std::size_t i = 0; i < order.size(); ++i) {
+                v.rank[ static_cast< std::size_t >(order[ i ]) ] = static_cast< std::int32_t >(i);
+            }
+        }
+        return v;
+    }
+
+    struct KeyHash
+    {
+        std::size_t operator()(const std::vector< std::int64_t >& k) const
+        {
+            std::uint64_t h = 1469598103934665603ull;
+            for (std::int64_t v : k) {
+                h ^= static_cast< std::uint64_t >(v) + 0x9e3779b97f4a7c15ull + (h << 6) + (h >> 2);
+            }
+            return static_cast< std::size_t >(h);
+        }
+    };
+
+    static std::int64_t doubleBits(double d)
+    {
+        if (d == 0.0) {
+            d = 0.0;  // -0.0和0.0为同一分组
+        }
+        if (std::isnan(d)) {
+            d = std::numeric_limits< double >::quiet_NaN();
+        }
+        std::int64_t bits = 0;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return bits;
+    }
+
+    // 分组键，null作为单独的值
+    static void encodeKey(const DAColumnarColumn& col, std::size_t r, std::int64_t& value, std::int64_t& null)
+    {
+        if (col.isNull(r)) {
+            value = 0;
+            null  = 1;
+            return;
+        }
+        null = 0;
+        switch (col.type()) {
+        case DAColumnarColumn::Bool:
+            value = col.boolData()[ r ];
+            break;
+        case DAColumnarColumn::Int64:
+            value = col.intData()[ r ];
+            break;
+        case DAColumnarColumn::Double:
+            value = doubleBits(col.doubleData()[ r ]);
+            break;
+        case DAColumnarColumn::String:
+            value = col.codeData()[ r ];
+            break;
+        }
+    }
+
+    /**
+     * @brief 连接时一个键的视图
+     */
+    struct JoinKeyView
+    {
+        enum Mode
+        {
+            Raw,       ///< 直接比较原始值
+            AsDouble,  ///< 整数和浮点混合，按数值比较
+            Mapped,    ///< 字符串，编码映射到左表的字典
+            Never      ///< 类型不兼容，不匹配
+        };
+        const DAColumnarColumn* col { nullptr };
+        Mode mode { Raw };
+        std::vector< std::int32_t > codeMap;
+        bool key(std::size_t r, std::int64_t& v) const
+        {
+            if (mode == Never || col->isNull(r)) {
+                return false;
+            }
+            switch (mode) {
+            case AsDouble:
+                v = doubleBits(col->doubleAt(r));
+                return true;
+            case Mapped: {
+                const std::int32_t c = codeMap[ static_cast< std::size_t >(col->codeData()[ r ]) ];
+                v                    = c;
+                return c >= 0;
+            }
+            default:
+                break;
+            }
+            std::int64_t dummy = 0;
+            encodeKey(*col, r, v, dummy);
+            return true;
+        }
+    };
+
+    static void makeJoinKeyViews(const DAColumnarColumn& lc, const DAColumnarColumn& rc, std::vector< JoinKeyView >& lv, std::vector< JoinKeyView >& rv)
+    {
+        JoinKeyView l, r;
+        l.col = &lc;
+        r.col = &rc;
+        if (lc.type() == DAColumnarColumn::String || rc.type() == DAColumnarColumn::String) {
+            if (lc.type() != rc.type()) {
+                l.mode = r.mode = JoinKeyView::Never;
+            } else if (lc.dictionary() != rc.dictionary()) {
+                r.mode                  = JoinKeyView::Mapped;
+                const QStringList& dict = rc.dictionary()->values;
+                r.codeMap.resize(static_cast< std::size_t >(dict.size()));
+                for (int i = 0; i < dict.size(); ++i) {
+                    r.codeMap[ static_cast< std::size_t >(i) ] = lc.dictionary()->find(dict.at(i));
+                }
+            }
+        } else if (lc.type() != rc.type()) {
+            l.mode = r.mode = JoinKeyView::AsDouble;
+        }
+        lv.push_back(l);
+        rv.push_back(r);
+    }
+
+    static bool buildJoinKey(const std::vector< JoinKeyView >& views, std::size_t r, std::vector< std::int64_t >& key)
+    {
+        for (std::size_t k = 0; k < views.size(); ++k) {
+            if (!views[ k ].key(r, key[ k ])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 按分组聚合整数列的Sum/Min/Max，结果保持为Int64，避免超过2^53的值经过double丢失精度
+    static ColumnPtr aggregateIntColumn(const DAColumnarColumn& col,
+                                        Aggregate a,
+                                        const std::vector< std::int32_t >& groupOfRow,
+                                        std::size_t groups)
+    {
+        const std::size_t n = groupOfRow.size();
+        std::vector< std::int64_t > acc(groups,
+                                        (a == Min) ? std::numeric_limits< std::int64_t >::max()
+                                                   : ((a == Max) ? std::numeric_limits< std::int64_t >::min() : 0));
+        std::vector< std::int64_t > count(groups, 0);
+        const std::int64_t* d = col.intData();
+        const bool noNull     = (col.nullCount() == 0);
+        for (std::size_t r = 0; r < n; ++r) {
+            if (!noNull && col.isNull(r)) {
+                continue;
+            }
+            const std::size_t g = static_cast< std::size_t >(groupOfRow[ r ]);
+            switch (a) {
+            case Min:
+                acc[ g ] = std::min(acc[ g ], d[ r ]);
+                break;
+            case Max:
+                acc[ g ] = std::max(acc[ g ], d[ r ]);
+                break;
+            default:
+                // 和numpy一样溢出时回绕，通过无符号运算避免未定义行为
+                acc[ g ] = static_cast< std::int64_t >(static_cast< std::uint64_t >(acc[ g ]) + static_cast< std::uint64_t >(d[ r ]));
+                break;
+            }
+            ++count[ g ];
+        }
+        ColumnPtr res = DAColumnarColumn::make(DAColumnarColumn::Int64);
+        res->reserve(groups);
+        for (std::size_t g = 0; g < groups; ++g) {
+            if (count[ g ] == 0 && a != Sum) {
+                res->appendNull();
+            } else {
+                res->appendInt(acc[ g ]);
+            }
+        }
+        return res;
+    }
+
+    // 按分组聚合一列
+    static ColumnPtr aggregateColumn(const DAColumnarColumn& col,
+                                     Aggregate a,
+                                     const std::vector< std::int32_t >& groupOfRow,
+                                     const Indices& firstRows)
+    {
+        const std::size_t groups = firstRows.size();
+        const std::size_t n      = groupOfRow.size();
+        if (a == First) {
+            return col.take(firstRows);
+        }
+        std::vector< std::int64_t > count(groups, 0);
+        if (a == Count) {
+            for (std::size_t r = 0; r < n; ++r) {
+                count[ static_cast< std::size_t >(groupOfRow[ r ]) ] += col.isNull(r) ? 0 : 1;
+            }
+            ColumnPtr res = DAColumnarColumn::make(DAColumnarColumn::Int64);
+            res->reserve(groups);
+            for (std::size_t g = 0; g < groups; ++g) {
+                res->appendInt(count[ g ]);
+            }
+            return res;
+        }
+        if (col.type() == DAColumnarColumn::Int64 && (a == Sum || a == Min || a == Max)) {
+            return aggregateIntColumn(col, a, groupOfRow, groups);
+        }
+        std::vector< double > acc(groups, (a == Min) ? std::numeric_limits< double >::infinity()
+                                                   : ((a == Max) ? -std::numeric_limits< double >::infinity() : 0.0));
+        const bool noNull = (col.nullCount() == 0);
+        if (noNull && col.type() == DAColumnarColumn::Double && (a == Sum || a == Mean) && groups == 1) {
+            // 整列求和，连续内存上的简单循环
+            const double* d = col.doubleData();
+            double s        = 0.0;
+            for (std::size_t r = 0; r < n; ++r) {
+                s += d[ r ];
+            }
+            acc[ 0 ]   = s;
+            count[ 0 ] = static_cast< std::int64_t >(n);
+        } else {
+            for (std::size_t r = 0; r < n; ++r) {
+                if (!noNull && col.isNull(r)) {
+                    continue;
+                }
+                const double v = col.doubleAt(r);
+                if (std::isnan(v)) {
+                    continue;
+                }
+                const std::size_t g = static_cast< std::size_t >(groupOfRow[ r ]);
+                switch (a) {
+                case Min:
+                    acc[ g ] = std::min(acc[ g ], v);
+                    break;
+                case Max:
+                    acc[ g ] = std::max(acc[ g ], v);
+                    break;
+                default:
+                    acc[ g ] += v;
+                    break;
+                }
+                ++count[ g ];
+            }
+        }
+        ColumnPtr res = DAColumnarColumn::make(DAColumnarColumn::Double);
+        res->reserve(groups);
+        for (std::size_t g = 0; g < groups; ++g) {
+            if (count[ g ] == 0) {
+                if (a == Sum) {
+                    res->appendDouble(0.0);
+                } else {
+                    res->appendNull();
+                }
+                continue;
+            }
+            res->appendDouble((a == Mean) ? acc[ g ] / static_cast< double >(count[ g ]) : acc[ g ]);
+        }
+        return res;
+    }
+
+private:
+    std::vector< ColumnPtr > mColumns;
+    std::size_t mRows { 0 };
+};
+
+}  // end DA
+#endif  // DACOLUMNARTABLE_H
@@ -2,13 +2,17 @@
 #define DAROWTABLE_H
 // std
 #include <memory>
+#include <numeric>
 // DA
 #include "da_algorithm.hpp"
-#include "DAVector.h"
+#include "DAVector.hpp"
 // Qt
 #include <QDebug>
+#include <QHash>
 namespace DA
 {
+template< typename T >
+class DARowTableGroup;
 
 //==============================================================
 // DARowTable
@@ -172,6 +176,13 @@ public:
      */
     TablePtr takeByValue(const QString& field, T value) const;
 
+    /**
+     * @brief 按列序号提取列作为新表
+     * @param columns
+     * @return
+     */
+    TablePtr takeByColumns(const QVector< int >& columns) const;
+
     /**
      * @brief groupby
      * @param field
@@ -180,6 +191,13 @@ public:
      */
     QPair< QList< TablePtr >, QList< T > > groupBy(const QString& field) const;
 
+    /**
+     * @brief groupby，只返回每个分组的列序号，不复制数据
+     * @param field
+     * @return
+     */
+    QList< DARowTableGroup< T > > groupIndexes(const QString& field) const;
+
     /**
      * @brief orderBy
      * @param sn
@@ -225,26 +243,100 @@ private:
 // 全局函数
 //==============================================================
 
+//==============================================================
+// DARowTableGroup
+//==============================================================
+/**
+ * @brief groupby的一个分组
+ *
+ * 分组只记录属于这个分组的列序号，不复制数据，需要时通过@ref toTable 生成表
+ * @note 分组引用原表，原表在分组使用期间需要保持有效且不能修改
+ */
 template< typename T >
-typename DARowTable< T >::TablePtr takeByValue(const DARowTable< T >& table, const QString& field, T value)
+class DARowTableGroup
 {
-    const int r = table.nameToIndex(field);
+public:
+    DARowTableGroup() : m_table(nullptr)
+    {
+    }
+
+    DARowTableGroup(const DARowTable< T >* t, const T& k) : m_table(t), m_key(k)
+    {
+    }
+
+    // 分组的值
+    const T& key() const
+    {
+        return (m_key);
+    }
 
+    // 分组包含的列序号，按原表的顺序排列
+    const QVector< int >& indexes() const
+    {
+        return (m_indexes);
+    }
+
+    QVector< int >& indexes()
+    {
+        return (m_indexes);
+    }
+
+    int columnCount() const
+    {
+        return (m_indexes.size());
+    }
+
+    // 分组中第r行第c列的单元格
+    const T& at(int r, int c) const
+    {
+        return (m_table->at(r, m_indexes[ c ]));
+    }
+
+    // 生成分组对应的表
+    typename DARowTable< T >::TablePtr toTable() const
+    {
+        return (takeByColumns(*m_table, m_indexes));
+    }
+
+private:
+    const DARowTable< T >* m_table;
+    T m_key;
+    QVector< int > m_indexes;
+};
+
+/**
+ * @brief 按列序号提取列作为新表，每行做一次gather
+ * @param table
+ * @param columns 列序号
+ * @return
+ */
+template< typename T >
+typename DARowTable< T >::TablePtr takeByColumns(const DARowTable< T >& table, const QVector< int >& columns)
+{
     typename DARowTable< T >::TablePtr res = DARowTable< T >::makeTable();
 
     res->setName(table.getName());
-    res->setRowNames(table.rowNames());
-    int csize = table.columnCount();
-
-    for (int i = 0; i < csize; ++i) {
-        if (table.cell(r, i) == value) {
-            typename DARowTable< T >::SeriesPtr col = table.colunm(i);
-            res->appendColumn(col->begin(), col->end());
-        }
+    res->setMode(table.getMode());
+    const int rc = table.rowCount();
+
+    for (int r = 0; r < rc; ++r) {
+        const typename DARowTable< T >::SeriesPtr& src = table.row(r);
+        typename DARowTable< T >::SeriesPtr ns         = DARowTable< T >::makeSeries(src->getName());
+        ns->resize(columns.size());
+        copy_inner_indexs(src->cbegin(), columns.cbegin(), columns.cend(), ns->begin());
+        res->appendRow(ns);
     }
     return (res);
 }
 
+template< typename T >
+typename DARowTable< T >::TablePtr takeByValue(const DARowTable< T >& table, const QString& field, T value)
+{
+    const int r = table.nameToIndex(field);
+
+    return (takeByValue(table, r, value));
+}
+
 /**
  * @brief takeByValue 类似于select * from table where table.r = value
  * @param table
@@ -255,26 +347,67 @@ typename DARowTable< T >::TablePtr takeByValue(const DARowTable< T >& table, con
 template< typename T >
 typename DARowTable< T >::TablePtr takeByValue(const DARowTable< T >& table, int r, T value)
 {
-    typename DARowTable< T >::TablePtr res = DARowTable< T >::makeTable();
-
-    res->setName(table.getName());
-    res->setRowNames(table.rowNames());
-    int csize = table.columnCount();
+    QVector< int > columns;
+    const int csize = table.columnCount();
 
     for (int i = 0; i < csize; ++i) {
         if (table.cell(r, i) == value) {
-            typename DARowTable< T >::SeriesPtr col = table.colunm(i);
-            res->appendColumn(col->begin(), col->end());
+            columns.append(i);
+        }
+    }
+    return (takeByColumns(table, columns));
+}
+
+/**
+ * @brief 对某个字段分组，一次遍历建立值到列序号的哈希表
+ * @param table
+ * @param r 字段（行）索引
+ * @return 按分组值升序排列的分组，分组只记录列序号
+ */
+template< typename T >
+QList< DARowTableGroup< T > > groupIndexes(const DARowTable< T >& table, int r)
+{
+    std::vector< DARowTableGroup< T > > groups;
+    QList< DARowTableGroup< T > > res;
+
+    if ((r < 0) || (r >= table.rowCount()) || (table.row(r) == nullptr)) {
+        return (res);
+    }
+    const typename DARowTable< T >::SeriesType& series = *(table.row(r));
+    const int csize                                    = qMin(series.size(), table.columnCount());
+    QHash< T, int > keyToGroup;
+
+    for (int c = 0; c < csize; ++c) {
+        const T& v = series[ c ];
+        auto ite   = keyToGroup.find(v);
+        if (ite == keyToGroup.end()) {
+            ite = keyToGroup.insert(v, static_cast< int >(groups.size()));
+            groups.emplace_back(&table, v);
         }
+        groups[ ite.value() ].indexes().append(c);
+    }
+    std::sort(groups.begin(), groups.end(), [](const DARowTableGroup< T >& a, const DARowTableGroup< T >& b) {
+        return (a.key() < b.key());
+    });
+    res.reserve(static_cast< int >(groups.size()));
+    for (DARowTableGroup< T >& g : groups) {
+        res.append(std::move(g));
     }
     return (res);
 }
 
+template< typename T >
+QList< DARowTableGroup< T > > groupIndexes(const DARowTable< T >& table, const QString& field)
+{
+    return (groupIndexes(table, table.nameToIndex(field)));
+}
+
 /**
  * @brief groupby 对某个字段执行group by操作
  * @param table
  * @param field
  * @return 返回一个pair，first：group by后的结构表，second，group by的结果
+ * @note 只需要分组的列序号时使用@ref groupIndexes ，避免复制数据
  */
 template< typename T >
 QPair< QList< typename DARowTable< T >::TablePtr >, QList< T > > groupby(const DARowTable< T >& table, const QString& field)
@@ -285,14 +418,10 @@ QPair< QList< typename DARowTable< T >::TablePtr >, QList< T > > groupby(const D
     int rindex = table.nameToIndex(field);
 
     Q_ASSERT_X(rindex >= 0, "groupby", "unknow field");
-    typename DARowTable< T >::SeriesPtr r = table.row(rindex);
-    if (r == nullptr) {
-        return (qMakePair(restables, gr));
-    }
-    gr = r->toList().toSet().toList();
-    std::sort(gr.begin(), gr.end());
-    for (T v : gr) {
-        restables.append(takeByValue(table, rindex, v));
+    const QList< DARowTableGroup< T > > groups = groupIndexes(table, rindex);
+    for (const DARowTableGroup< T >& g : groups) {
+        restables.append(g.toTable());
+        gr.append(g.key());
     }
     return (qMakePair(restables, gr));
 }
@@ -351,25 +480,41 @@ void orderBy(DARowTable< T >& table, const QString& field)
     orderBy(table, r);
 }
 
+/**
+ * @brief 按某个字段排序后的列序号（稳定排序）
+ * @param table
+ * @param r 字段（行）索引
+ * @return
+ */
 template< typename T >
-void orderBy(DARowTable< T >& table, int r)
+QVector< int > orderIndexes(const DARowTable< T >& table, int r)
 {
-    typename DARowTable< T >::SeriesPtr row = table.row(r);
-    Q_ASSERT_X(row != nullptr, "orderBy", "unknow field");
-    auto ordser = makeIndexSeries< T >(row);
+    const typename DARowTable< T >::SeriesPtr& row = table.row(r);
+    Q_ASSERT_X(row != nullptr, "orderIndexes", "unknow field");
+    QVector< int > perm(row->size());
+    std::iota(perm.begin(), perm.end(), 0);
+    const T* d = row->constData();
+    parallel_stable_sort(perm.begin(), perm.end(), [ d ](int a, int b) { return (d[ a ] < d[ b ]); });
+    return (perm);
+}
 
-    std::sort(ordser->begin(), ordser->end());
-    int rowcount = table.rowCount();
+/**
+ * @brief 按某个字段排序，先计算一次排列，再对每行做gather
+ * @param table
+ * @param r
+ */
+template< typename T >
+void orderBy(DARowTable< T >& table, int r)
+{
+    const QVector< int > perm = orderIndexes(table, r);
+    const int rowcount        = table.rowCount();
 
-    //开始逐一转换
     for (int rc = 0; rc < rowcount; ++rc) {
-        typename DARowTable< T >::SeriesPtr series = table.row(rc);
-        typename DARowTable< T >::SeriesPtr ns     = DARowTable< T >::makeSeries(series->getName());
-        ns->reserve(series->size());
-        for (auto i = ordser->begin(); i != ordser->end(); ++i) {
-            ns->push_back(series->at((*i).index));
-        }
-        table.row(rc).swap(ns);
+        typename DARowTable< T >::SeriesPtr& series = table.row(rc);
+        typename DARowTable< T >::SeriesPtr ns      = DARowTable< T >::makeSeries(series->getName());
+        ns->resize(perm.size());
+        copy_inner_indexs(series->cbegin(), perm.cbegin(), perm.cend(), ns->begin());
+        series.swap(ns);
     }
 }
 
@@ -764,12 +909,24 @@ typename DARowTable< T >::TablePtr DARowTable< T >::takeByValue(const QString& f
     return (DA::takeByValue(*this, field, value));
 }
 
+template< typename T >
+typename DARowTable< T >::TablePtr DARowTable< T >::takeByColumns(const QVector< int >& columns) const
+{
+    return (DA::takeByColumns(*this, columns));
+}
+
 template< typename T >
 QPair< QList< typename DARowTable< T >::TablePtr >, QList< T > > DARowTable< T >::groupBy(const QString& field) const
 {
     return (DA::groupby(*this, field));
 }
 
+template< typename T >
+QList< DARowTableGroup< T > > DARowTable< T >::groupIndexes(const QString& field) const
+{
+    return (DA::groupIndexes(*this, field));
+}
+
 template< typename T >
 void DARowTable< T >::orderBy(const QString& sn)
 {
@@ -3,11 +3,15 @@
 // Qt
 #include <QDebug>
 // std
+#include <algorithm>
+#include <iterator>
 #include <memory>
 #include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 // DA
 #include "da_algorithm.hpp"
-#include "da_hash_table.hpp"
 #include "da_vector_table.hpp"
 #include "da_array_table.hpp"
 namespace DA
@@ -16,20 +20,100 @@ namespace DA
 /**
  * @brief 是一个支持稀疏和各种算法的表
  *
- * 其内部使用da_hash_table，但封装了shape，让获取尺寸更方便
+ * 按行存储：每行是按列升序排列的单元格（行列索引和值），同一行的单元格在连续内存中，
+ * 按行遍历（@ref transferRow ）和显示表格时顺序访问，查找单元格在一行内二分查找，
+ * 同时维护每列单元格的数量，删除边界上的单元格时按计数收缩shape，均摊O(1)，不需要遍历所有单元格
+ *
+ * 迭代器按行、行内按列的顺序访问所有单元格，解引用为@ref value_type ，first为行列索引，second为值
+ *
+ * @note 行列索引不能为负
+ * @note 通过@ref rawData 修改内容后需要调用@ref recalcShape 重新计算shape
  */
 template< typename T >
 class DATable
 {
 public:
-    using Type               = T;
-    using IndexType          = int;
-    using IndexPair          = std::pair< IndexType, IndexType >;
-    using TableType          = da_hash_table< T, IndexType >;
-    using TableIterator      = typename TableType::iterator;
-    using TableConstIterator = typename TableType::const_iterator;
-    using value_type         = typename TableType::value_type;  // 兼容std
-    using PredFun            = std::function< bool(const value_type&) >;
+    using Type       = T;
+    using IndexType  = int;
+    using IndexPair  = std::pair< IndexType, IndexType >;
+    using value_type = std::pair< IndexPair, T >;  // 兼容std，first不允许修改
+    using RowType    = std::vector< value_type >;  ///< 一行的单元格，按列升序
+    using TableType  = std::vector< RowType >;
+    using PredFun    = std::function< bool(const value_type&) >;
+
+    /**
+     * @brief 按行遍历所有单元格的迭代器，跳过空行
+     */
+    template< bool IsConst >
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = typename DATable::value_type;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = typename std::conditional< IsConst, const value_type*, value_type* >::type;
+        using reference         = typename std::conditional< IsConst, const value_type&, value_type& >::type;
+        using TablePointer      = typename std::conditional< IsConst, const TableType*, TableType* >::type;
+
+        Iterator() = default;
+        Iterator(TablePointer t, std::size_t r, std::size_t i) : mTable(t), mRow(r), mIndex(i)
+        {
+            skipEmpty();
+        }
+        // 非const迭代器可以转换为const迭代器
+        template< bool OtherConst, typename = typename std::enable_if< IsConst && !OtherConst >::type >
+        Iterator(const Iterator< OtherConst >& other) : mTable(other.mTable), mRow(other.mRow), mIndex(other.mIndex)
+        {
+        }
+        reference operator*() const
+        {
+            return (*mTable)[ mRow ][ mIndex ];
+        }
+        pointer operator->() const
+        {
+            return &((*mTable)[ mRow ][ mIndex ]);
+        }
+        Iterator& operator++()
+        {
+            ++mIndex;
+            skipEmpty();
+            return *this;
+        }
+        Iterator operator++(int)
+        {
+            Iterator r = *this;
+            ++(*this);
+            return r;
+        }
+        bool operator==(const Iterator& o) const
+        {
+            return mRow == o.mRow && mIndex == o.mIndex;
+        }
+        bool operator!=(const Iterator& o) const
+        {
+            return !(*this == o);
+        }
+
+    private:
+        void skipEmpty()
+        {
+            while (mRow < mTable->size() && mIndex >= (*mTable)[ mRow ].size()) {
+                ++mRow;
+                mIndex = 0;
+            }
+        }
+
+    private:
+        friend class DATable;
+        friend class Iterator< !IsConst >;
+        TablePointer mTable { nullptr };
+        std::size_t mRow { 0 };
+        std::size_t mIndex { 0 };
+    };
+    using TableIterator      = Iterator< false >;
+    using TableConstIterator = Iterator< true >;
+    using iterator           = TableIterator;
+    using const_iterator     = TableConstIterator;
 
 public:
     DATable() : mShape(0, 0)
@@ -37,24 +121,34 @@ public:
     }
     DATable(const DATable& other)
     {
-        mData  = other.mData;
-        mShape = other.mShape;
+        mRows         = other.mRows;
+        mShape        = other.mShape;
+        mColumnCounts = other.mColumnCounts;
+        mSize         = other.mSize;
     }
     DATable(DATable&& other)
     {
-        mData  = std::move(other.mData);
-        mShape = std::move(other.mShape);
+        mRows         = std::move(other.mRows);
+        mShape        = std::move(other.mShape);
+        mColumnCounts = std::move(other.mColumnCounts);
+        mSize         = other.mSize;
+        other.clear();
     }
     DATable< T >& operator=(const DATable& other)
     {
-        mData  = other.mData;
-        mShape = other.mShape;
+        mRows         = other.mRows;
+        mShape        = other.mShape;
+        mColumnCounts = other.mColumnCounts;
+        mSize         = other.mSize;
         return *this;
     }
     DATable< T >& operator=(DATable&& other)
     {
-        mData  = std::move(other.mData);
-        mShape = std::move(other.mShape);
+        mRows         = std::move(other.mRows);
+        mShape        = std::move(other.mShape);
+        mColumnCounts = std::move(other.mColumnCounts);
+        mSize         = other.mSize;
+        other.clear();
         return *this;
     }
     /**
@@ -65,11 +159,11 @@ public:
      */
     bool contain(int r, int c) const
     {
-        return (mData.cend() != mData.find({ r, c }));
+        return nullptr != cellData(r, c);
     }
     bool contain(IndexPair i) const
     {
-        return (mData.cend() != mData.find(i));
+        return contain(i.first, i.second);
     }
     /**
      * @brief 获取表的shape，first：最大行，second：最大列
@@ -79,21 +173,29 @@ public:
     {
         return mShape;
     }
+    /**
+     * @brief 获取单元格的引用
+     * @note 单元格没有内容时抛出std::out_of_range
+     */
     const T& at(int r, int c) const
     {
-        return mData.at(r, c);
+        const T* v = cellData(r, c);
+        if (!v) {
+            throw std::out_of_range("DATable::at");
+        }
+        return *v;
     }
     T& at(int r, int c)
     {
-        return mData.at(r, c);
+        return const_cast< T& >(static_cast< const DATable& >(*this).at(r, c));
     }
     const T& at(const IndexPair& i) const
     {
-        return mData.at(i);
+        return at(i.first, i.second);
     }
     T& at(const IndexPair& i)
     {
-        return mData.at(i);
+        return at(i.first, i.second);
     }
     /**
      * @brief cell函数返回的是值，如果单元格没有，也返回一个默认构造的值
@@ -103,30 +205,67 @@ public:
      */
     T cell(int r, int c) const
     {
-        return mData.value(r, c);
+        const T* v = cellData(r, c);
+        return v ? *v : T();
     }
     T cell(const IndexPair& i) const
     {
-        return mData.value(i);
+        return cell(i.first, i.second);
+    }
+    /**
+     * @brief 单元格值的指针，没有内容返回nullptr
+     *
+     * 只在一行内二分查找，适合逐个单元格访问（例如model的data函数）
+     * @param r
+     * @param c
+     * @return
+     */
+    const T* cellData(int r, int c) const
+    {
+        if (r < 0 || r >= static_cast< IndexType >(mRows.size())) {
+            return nullptr;
+        }
+        const RowType& row = mRows[ r ];
+        auto ite           = lowerBound(row, c);
+        return (ite != row.end() && ite->first.second == c) ? &(ite->second) : nullptr;
     }
     T& operator[](const IndexPair& i)
     {
-        reflashShape(i);
-        return mData[ i ];
+        if (i.first < 0 || i.second < 0) {
+            throw std::out_of_range("DATable::operator[] negative index");
+        }
+        RowType& row = rowForInsert(i.first);
+        auto ite     = lowerBound(row, i.second);
+        if (ite != row.end() && ite->first.second == i.second) {
+            return ite->second;
+        }
+        ite = row.emplace(ite, i, T());
+        onCellInserted(i);
+        return ite->second;
     }
     const T& operator[](const IndexPair& i) const
     {
-        return mData[ i ];
+        return at(i);
     }
     /**
      * @brief 插入内容
      * @param k
      * @param v
+     * @note 索引为负时忽略
      */
     void set(const IndexPair& k, const T& v)
     {
-        mData[ k ] = v;
-        reflashShape(k);
+        if (k.first < 0 || k.second < 0) {
+            return;
+        }
+        RowType& row = rowForInsert(k.first);
+        auto ite     = lowerBound(row, k.second);
+        if (ite != row.end() && ite->first.second == k.second) {
+            ite->second = v;
+            return;
+        }
+        row.emplace(ite, k, v);
+        onCellInserted(k);
     }
     void set(IndexType row, IndexType col, const T& v)
     {
@@ -161,11 +300,60 @@ public:
     }
 
     /**
-     * @brief 重新计算shape
+     * @brief 重新计算shape和每列单元格的数量，通过@ref rawData 修改内容后调用
      */
     void recalcShape()
     {
-        mShape = mData.shape();
+        mColumnCounts.clear();
+        mSize = 0;
+        for (const RowType& row : mRows) {
+            for (const value_type& v : row) {
+                const IndexType c = v.first.second;
+                if (c >= static_cast< IndexType >(mColumnCounts.size())) {
+                    mColumnCounts.resize(c + 1, 0);
+                }
+                ++mColumnCounts[ c ];
+            }
+            mSize += row.size();
+        }
+        shrinkShape();
+    }
+
+    /**
+     * @brief 某行的单元格，按列升序
+     * @param r
+     * @return
+     */
+    const RowType& row(IndexType r) const
+    {
+        static const RowType s_empty;
+        if (r < 0 || r >= static_cast< IndexType >(mRows.size())) {
+            return s_empty;
+        }
+        return mRows[ r ];
+    }
+
+    /**
+     * @brief 某行单元格的数量
+     * @param r
+     * @return
+     */
+    std::size_t rowCellCount(IndexType r) const
+    {
+        return row(r).size();
+    }
+
+    /**
+     * @brief 某列单元格的数量
+     * @param c
+     * @return
+     */
+    std::size_t columnCellCount(IndexType c) const
+    {
+        if (c < 0 || c >= static_cast< IndexType >(mColumnCounts.size())) {
+            return 0;
+        }
+        return static_cast< std::size_t >(mColumnCounts[ c ]);
     }
 
     /**
@@ -174,7 +362,7 @@ public:
      */
     std::size_t size() const
     {
-        return mData.size();
+        return mSize;
     }
 
     /**
@@ -185,17 +373,19 @@ public:
      */
     bool removeCell(int r, int c)
     {
-        auto i = mData.find({ r, c });
-        if (i != mData.end()) {
-            mData.erase(i);
-            // 判断是否触发reshape
-            if (r == (mShape.first - 1) || c == (mShape.second - 1)) {
-                // 但凡有一边接触到边界，在删除后都有重新计算边界
-                recalcShape();
-            }
-            return true;
+        if (r < 0 || r >= static_cast< IndexType >(mRows.size())) {
+            return false;
         }
-        return false;
+        RowType& row = mRows[ r ];
+        auto ite     = lowerBound(row, c);
+        if (ite == row.end() || ite->first.second != c) {
+            return false;
+        }
+        row.erase(ite);
+        --mSize;
+        --mColumnCounts[ c ];
+        shrinkShape();
+        return true;
     }
     /**
      * @brief 移除一个cell
@@ -212,21 +402,23 @@ public:
      */
     void clear()
     {
-        mData.clear();
+        mRows.clear();
         mShape = IndexPair(0, 0);
+        mColumnCounts.clear();
+        mSize = 0;
     }
     /**
-     * @brief 获取内部的table
-     * @note 此函数不安全,写操作完成后应该调用recalcShape
+     * @brief 获取内部按行存储的数据
+     * @note 此函数不安全,写操作完成后应该调用recalcShape，每行需要保持按列升序，单元格的行索引需要和所在的行一致
      * @return
      */
     TableType& rawData()
     {
-        return mData;
+        return mRows;
     }
     const TableType& rawData() const
     {
-        return mData;
+        return mRows;
     }
     /**
      * @brief 查找索引
@@ -235,7 +427,15 @@ public:
      */
     TableConstIterator find(const IndexPair& i) const
     {
-        return mData.find(i);
+        if (i.first < 0 || i.first >= static_cast< IndexType >(mRows.size())) {
+            return end();
+        }
+        const RowType& row = mRows[ i.first ];
+        auto ite           = lowerBound(row, i.second);
+        if (ite == row.end() || ite->first.second != i.second) {
+            return end();
+        }
+        return TableConstIterator(&mRows, static_cast< std::size_t >(i.first), static_cast< std::size_t >(ite - row.begin()));
     }
     TableConstIterator find(int r, int c) const
     {
@@ -243,7 +443,8 @@ public:
     }
     TableIterator find(const IndexPair& i)
     {
-        return mData.find(i);
+        TableConstIterator ite = static_cast< const DATable& >(*this).find(i);
+        return TableIterator(&mRows, ite.mRow, ite.mIndex);
     }
     TableIterator find(int r, int c)
     {
@@ -251,23 +452,23 @@ public:
     }
     TableConstIterator end() const
     {
-        return mData.end();
+        return TableConstIterator(&mRows, mRows.size(), 0);
     }
     TableIterator end()
     {
-        return mData.end();
+        return TableIterator(&mRows, mRows.size(), 0);
     }
     TableConstIterator begin() const
     {
-        return mData.begin();
+        return TableConstIterator(&mRows, 0, 0);
     }
     TableIterator begin()
     {
-        return mData.begin();
+        return TableIterator(&mRows, 0, 0);
     }
     bool empty() const
     {
-        return mData.empty();
+        return 0 == mSize;
     }
     /**
      * @brief 按条件删除元素
@@ -276,36 +477,44 @@ public:
      */
     std::size_t erase_if(PredFun pred)
     {
-        std::size_t r = erase_if__(pred);
-        recalcShape();
-        return r;
+        const std::size_t oldSize = mSize;
+        for (RowType& row : mRows) {
+            auto last = std::remove_if(row.begin(), row.end(), [ this, &pred ](const value_type& v) -> bool {
+                if (pred(v)) {
+                    --mColumnCounts[ v.first.second ];
+                    return true;
+                }
+                return false;
+            });
+            mSize -= static_cast< std::size_t >(row.end() - last);
+            row.erase(last, row.end());
+        }
+        shrinkShape();
+        return oldSize - mSize;
     }
     /**
      * @brief 移除一列，所有大于此索引的列向左移动
+     *
+     * 每行删除这一列的单元格后，后面的单元格列号减1，行内仍然保持升序
      * @param col
      */
     void dropColumn(IndexType col)
     {
-        // 分两步，第一步删除，第二部移动
-        // 先把列号等于col的移除
-        std::vector< value_type > temp;
-        std::ignore = erase_if__([ col, &temp ](const value_type& v) -> bool {
-            if (v.first.second == col) {
-                return true;
-            } else if (v.first.second > col) {
-                // 大于这个列的也要删除，但要把值缓存起来，并进行左移动
-                temp.emplace_back(v);
-                return true;
+        if (col < 0 || col >= static_cast< IndexType >(mColumnCounts.size())) {
+            return;
+        }
+        for (RowType& row : mRows) {
+            auto ite = lowerBound(row, col);
+            if (ite != row.end() && ite->first.second == col) {
+                ite = row.erase(ite);
+                --mSize;
             }
-            return false;
-        });
-        // 再把列号大于col的全部减去1
-        std::for_each(temp.begin(), temp.end(), [ this ](value_type& v) {
-            IndexPair k = v.first;
-            --k.second;
-            mData[ k ] = v.second;
-        });
-        recalcShape();
+            for (; ite != row.end(); ++ite) {
+                --(ite->first.second);
+            }
+        }
+        mColumnCounts.erase(mColumnCounts.begin() + col);
+        shrinkShape();
     }
 
     /**
@@ -325,8 +534,10 @@ public:
     DATable< OtherType > transfered(std::function< OtherType(const T& v) > trFun) const
     {
         DATable< OtherType > other;
-        for (auto i = mData.cbegin(), last = mData.cend(); i != last; ++i) {
-            other[ i.first ] = trFun(*i);
+        for (const RowType& row : mRows) {
+            for (const value_type& v : row) {
+                other.set(v.first, trFun(v.second));
+            }
         }
         return other;
     }
@@ -338,17 +549,32 @@ public:
 	 */
 	void transferColumn(IndexType col, std::function< bool(const T& v) > trFun) const
 	{
-		auto rowCnt = rowCount();
-		for (auto r = 0;r<rowCnt;++r) {
-			auto ite = mData.find(IndexPair(r,col));
-			if(ite!=mData.end()){
-				if(!trFun(ite->second)){
+		// 找到这一列所有的单元格后就可以提前结束
+		std::size_t remain = columnCellCount(col);
+		auto rowCnt        = rowCount();
+		for (auto r = 0; r < rowCnt && remain > 0; ++r) {
+			if (const T* v = cellData(r, col)) {
+				--remain;
+				if (!trFun(*v)) {
 					return;
 				}
 			}
 		}
 	}
 
+	/**
+	 * @brief 按列的顺序遍历一行，只访问有内容的单元格，直接顺序访问行的存储
+	 * @param trFun 参数为列号和值，如果返回true,继续迭代，如果返回false，就退出迭代
+	 */
+	void transferRow(IndexType r, std::function< bool(IndexType col, const T& v) > trFun) const
+	{
+		for (const value_type& v : row(r)) {
+			if (!trFun(v.first.second, v.second)) {
+				return;
+			}
+		}
+	}
+
     /**
      * @brief operator =
      * @param other
@@ -369,8 +595,27 @@ public:
     }
 
 private:
-    void reflashShape(const IndexPair& k)
+    // 行内第一个列号不小于c的单元格
+    template< typename Row >
+    static auto lowerBound(Row& row, IndexType c) -> decltype(row.begin())
+    {
+        return std::lower_bound(row.begin(), row.end(), c, [](const value_type& v, IndexType col) { return v.first.second < col; });
+    }
+    RowType& rowForInsert(IndexType r)
+    {
+        if (r >= static_cast< IndexType >(mRows.size())) {
+            mRows.resize(r + 1);
+        }
+        return mRows[ r ];
+    }
+    // 新增了单元格，更新计数和shape
+    void onCellInserted(const IndexPair& k)
     {
+        ++mSize;
+        if (k.second >= static_cast< IndexType >(mColumnCounts.size())) {
+            mColumnCounts.resize(k.second + 1, 0);
+        }
+        ++mColumnCounts[ k.second ];
         if (k.first >= mShape.first) {
             mShape.first = k.first + 1;
         }
@@ -378,22 +623,23 @@ private:
             mShape.second = k.second + 1;
         }
     }
-    std::size_t erase_if__(PredFun pred)
+    // 边界上的行列变空时收缩shape，每个索引只会收缩一次，均摊O(1)
+    void shrinkShape()
     {
-        auto old_size = size();
-        for (auto i = mData.begin(), last = mData.end(); i != last;) {
-            if (pred(*i)) {
-                i = mData.erase(i);
-            } else {
-                ++i;
-            }
+        while (!mRows.empty() && mRows.back().empty()) {
+            mRows.pop_back();
+        }
+        while (!mColumnCounts.empty() && mColumnCounts.back() <= 0) {
+            mColumnCounts.pop_back();
         }
-        return old_size - size();
+        mShape = IndexPair(static_cast< IndexType >(mRows.size()), static_cast< IndexType >(mColumnCounts.size()));
     }
 
 private:
-    TableType mData;
+    TableType mRows;                        ///< 每行的单元格，按列升序
     IndexPair mShape;
+    std::vector< IndexType > mColumnCounts;  ///< 每列单元格的数量
+    std::size_t mSize { 0 };                 ///< 单元格的数量
 };
 
 /**
@@ -2,9 +2,127 @@
 #define DA_ALGORITHM_H
 
 #include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// 数据量大于此值时，拷贝类的算法会分块在多个线程中执行
+#ifndef DA_ALGORITHM_PARALLEL_MIN_SIZE
+#define DA_ALGORITHM_PARALLEL_MIN_SIZE 262144
+#endif
 
 namespace DA
 {
+namespace detail
+{
+inline std::size_t& parallel_min_size_ref()
+{
+    static std::size_t s_min_size = DA_ALGORITHM_PARALLEL_MIN_SIZE;
+    return s_min_size;
+}
+}  // end detail
+
+///
+/// \brief 设置拷贝类算法并行执行的最小数据量，默认为DA_ALGORITHM_PARALLEL_MIN_SIZE
+/// \note 小于4时不并行；非线程安全，应在程序初始化时设置
+///
+inline void set_parallel_min_size(std::size_t s)
+{
+    detail::parallel_min_size_ref() = s;
+}
+
+inline std::size_t get_parallel_min_size()
+{
+    return detail::parallel_min_size_ref();
+}
+
+namespace detail
+{
+// 迭代器是否都是随机访问迭代器
+template< typename... _IT >
+struct is_random_access
+    : std::integral_constant< bool,
+                              (std::is_base_of< std::random_access_iterator_tag, typename std::iterator_traits< _IT >::iterator_category >::value && ...) >
+{
+};
+
+// 元素的拷贝不会抛出异常，可以放到其他线程中执行
+template< typename _IT >
+struct is_nothrow_copy
+    : std::is_nothrow_copy_assignable< typename std::iterator_traits< _IT >::value_type >
+{
+};
+
+///
+/// \brief 数据量为n时分块的数量，小于并行的最小数据量时为1，最多为cpu核数
+///
+inline std::size_t parallel_parts(std::size_t n)
+{
+    const std::size_t min_size = get_parallel_min_size();
+    if (min_size < 4 || n < min_size) {
+        return 1;
+    }
+    const std::size_t hw = std::max(1u, std::thread::hardware_concurrency());
+    return std::max< std::size_t >(1, std::min< std::size_t >(hw, n / (min_size / 4)));
+}
+
+///
+/// \brief 第part块的起始位置
+///
+inline std::size_t parallel_part_begin(std::size_t n, std::size_t parts, std::size_t part)
+{
+    return n * part / parts;
+}
+
+///
+/// \brief 执行fun(0)……fun(parts-1)，每块一个线程，当前线程执行第0块
+///
+template< typename _Fun >
+void parallel_run(std::size_t parts, _Fun fun)
+{
+    if (parts < 2) {
+        fun(std::size_t(0));
+        return;
+    }
+    std::vector< std::thread > threads;
+    threads.reserve(parts - 1);
+    for (std::size_t i = 1; i < parts; ++i) {
+        threads.emplace_back([ &fun, i ]() { fun(i); });
+    }
+    fun(std::size_t(0));
+    for (std::thread& t : threads) {
+        t.join();
+    }
+}
+
+///
+/// \brief 随机访问迭代器的n元transform，循环体没有分支，可以被编译器向量化
+///
+template< class OutputIterator, class Operation, class... InputIterators >
+OutputIterator transform_n(std::size_t n, OutputIterator result_first, Operation op, InputIterators... firsts)
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        result_first[ i ] = op(firsts[ i ]...);
+    }
+    return (result_first + n);
+}
+
+template< class OutputIterator, class Operation, class... InputIterators >
+OutputIterator parallel_transform_n(std::size_t n, OutputIterator result_first, Operation op, InputIterators... firsts)
+{
+    const std::size_t parts = parallel_parts(n);
+    parallel_run(parts, [ & ](std::size_t p) {
+        const std::size_t b = parallel_part_begin(n, parts, p);
+        const std::size_t e = parallel_part_begin(n, parts, p + 1);
+        transform_n(e - b, result_first + b, op, (firsts + b)...);
+    });
+    return (result_first + n);
+}
+}  // end detail
+
 ///
 /// \brief 把索引范围之外的内容拷贝
 /// \param input_begin 容器起始迭代器
@@ -16,10 +134,69 @@ namespace DA
 /// \code
 /// std::sort(index_begin,index_end);
 /// \endcode
+/// \note 输入和索引是随机访问迭代器时，按索引之间的区段整段拷贝（连续内存的平凡类型由std::copy转为memmove），
+/// 输出也是随机访问迭代器且数据量大于DA_ALGORITHM_PARALLEL_MIN_SIZE时，先生成剔除位图，再分块并行拷贝
 ///
 template< typename _IT, typename _IT_Index, typename _IT_RES >
 void copy_out_of_indexs(_IT input_begin, _IT input_end, _IT_Index index_begin, _IT_Index index_end, _IT_RES output_begin, size_t inputIndexStart = 0)
 {
+    if constexpr (detail::is_random_access< _IT >::value) {
+        const std::size_t n = static_cast< std::size_t >(std::distance(input_begin, input_end));
+        if constexpr (detail::is_random_access< _IT_RES >::value && detail::is_nothrow_copy< _IT >::value) {
+            const std::size_t parts = detail::parallel_parts(n);
+            if (parts > 1) {
+                // 位图：1为剔除
+                std::vector< unsigned char > drop(n, 0);
+                for (_IT_Index i = index_begin; i != index_end; ++i) {
+                    const std::size_t idx = static_cast< std::size_t >(*i);
+                    if (idx >= inputIndexStart && idx - inputIndexStart < n) {
+                        drop[ idx - inputIndexStart ] = 1;
+                    }
+                }
+                // 每块保留的数量，得到每块输出的起始位置
+                std::vector< std::size_t > offsets(parts + 1, 0);
+                detail::parallel_run(parts, [ & ](std::size_t p) {
+                    const std::size_t b = detail::parallel_part_begin(n, parts, p);
+                    const std::size_t e = detail::parallel_part_begin(n, parts, p + 1);
+                    std::size_t keep    = 0;
+                    for (std::size_t i = b; i < e; ++i) {
+                        keep += (drop[ i ] == 0);
+                    }
+                    offsets[ p + 1 ] = keep;
+                });
+                std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+                detail::parallel_run(parts, [ & ](std::size_t p) {
+                    const std::size_t b = detail::parallel_part_begin(n, parts, p);
+                    const std::size_t e = detail::parallel_part_begin(n, parts, p + 1);
+                    _IT_RES out         = output_begin + offsets[ p ];
+                    for (std::size_t i = b; i < e; ++i) {
+                        if (!drop[ i ]) {
+                            *out = input_begin[ i ];
+                            ++out;
+                        }
+                    }
+                });
+                return;
+            }
+        }
+        // 索引之间的区段整段拷贝
+        std::size_t cur = 0;
+        for (; index_begin != index_end; ++index_begin) {
+            const std::size_t idx = static_cast< std::size_t >(*index_begin);
+            if (idx < inputIndexStart + cur) {
+                // 重复的索引或者起始位置之前的索引
+                continue;
+            }
+            const std::size_t i = idx - inputIndexStart;
+            if (i >= n) {
+                break;
+            }
+            output_begin = std::copy(input_begin + cur, input_begin + i, output_begin);
+            cur          = i + 1;
+        }
+        std::copy(input_begin + cur, input_end, output_begin);
+        return;
+    }
     if (index_begin == index_end) {
         std::copy(input_begin, input_end, output_begin);
         return;
@@ -61,6 +238,25 @@ void copy_inner_indexs(_IT input_begin, _IT input_end, _IT_Index index_begin, _I
     if (index_begin == index_end) {
         return;
     }
+    if constexpr (detail::is_random_access< _IT >::value) {
+        // 随机访问时直接按索引取值，不用逐个遍历输入
+        const std::size_t n = static_cast< std::size_t >(std::distance(input_begin, input_end));
+        std::size_t next    = 0;  // 下一个可以拷贝的位置，用于跳过重复的索引
+        for (; index_begin != index_end; ++index_begin) {
+            const std::size_t idx = static_cast< std::size_t >(*index_begin);
+            if (idx < inputIndexStart + next) {
+                continue;
+            }
+            const std::size_t i = idx - inputIndexStart;
+            if (i >= n) {
+                return;
+            }
+            *output_begin = input_begin[ i ];
+            ++output_begin;
+            next = i + 1;
+        }
+        return;
+    }
     while (input_begin != input_end) {
         if (inputIndexStart == *index_begin) {
             *output_begin = *input_begin;
@@ -92,6 +288,22 @@ void copy_inner_indexs(_IT input_begin, _IT_Index index_begin, _IT_Index index_e
     if (index_begin == index_end) {
         return;
     }
+    if constexpr (detail::is_random_access< _IT, _IT_Index, _IT_RES >::value) {
+        // gather，没有分支，可以被编译器向量化，数据量大时分块并行
+        const std::size_t n = static_cast< std::size_t >(std::distance(index_begin, index_end));
+        std::size_t parts   = 1;
+        if constexpr (detail::is_nothrow_copy< _IT >::value) {
+            parts = detail::parallel_parts(n);
+        }
+        detail::parallel_run(parts, [ & ](std::size_t p) {
+            const std::size_t b = detail::parallel_part_begin(n, parts, p);
+            const std::size_t e = detail::parallel_part_begin(n, parts, p + 1);
+            for (std::size_t i = b; i < e; ++i) {
+                output_begin[ i ] = input_begin[ index_begin[ i ] ];
+            }
+        });
+        return;
+    }
     while (index_begin != index_end) {
         *output_begin = *(input_begin + *index_begin);
         ++output_begin;
@@ -204,6 +416,9 @@ void split_with_indexs(_IT input_begin,
 template< class InputIterator1, class InputIterator2, class InputIterator3, class OutputIterator, class ThreeOperation >
 OutputIterator transform(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator3 first3, OutputIterator result_first, ThreeOperation three_op)
 {
+    if constexpr (detail::is_random_access< InputIterator1, InputIterator2, InputIterator3, OutputIterator >::value) {
+        return (detail::transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, three_op, first1, first2, first3));
+    }
     while (first1 != last1) {
         *result_first = three_op(*first1, *first2, *first3);  // or: *result=binary_op(*first1,*first2++);
         ++result_first;
@@ -234,6 +449,9 @@ OutputIterator transform(InputIterator1 first1,
                          OutputIterator result_first,
                          FourOperation four_op)
 {
+    if constexpr (detail::is_random_access< InputIterator1, InputIterator2, InputIterator3, InputIterator4, OutputIterator >::value) {
+        return (detail::transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, four_op, first1, first2, first3, first4));
+    }
     while (first1 != last1) {
         *result_first = four_op(*first1, *first2, *first3, *first4);  // or: *result=binary_op(*first1,*first2++);
         ++result_first;
@@ -267,6 +485,9 @@ OutputIterator transform(InputIterator1 first1,
                          OutputIterator result_first,
                          FiveOperation five_op)
 {
+    if constexpr (detail::is_random_access< InputIterator1, InputIterator2, InputIterator3, InputIterator4, InputIterator5, OutputIterator >::value) {
+        return (detail::transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, five_op, first1, first2, first3, first4, first5));
+    }
     while (first1 != last1) {
         *result_first = five_op(*first1, *first2, *first3, *first4, *first5);  // or: *result=binary_op(*first1,*first2++);
         ++result_first;
@@ -303,6 +524,9 @@ OutputIterator transform(InputIterator1 first1,
                          OutputIterator result_first,
                          SixOperation six_op)
 {
+    if constexpr (detail::is_random_access< InputIterator1, InputIterator2, InputIterator3, InputIterator4, InputIterator5, InputIterator6, OutputIterator >::value) {
+        return (detail::transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, six_op, first1, first2, first3, first4, first5, first6));
+    }
     while (first1 != last1) {
         *result_first = six_op(*first1, *first2, *first3, *first4, *first5, *first6);  // or: *result=binary_op(*first1,*first2++);
         ++result_first;
@@ -315,6 +539,120 @@ OutputIterator transform(InputIterator1 first1,
     }
     return (result_first);
 }
+
+///
+/// \brief 并行的transform，参数和DA::transform一致，数据量大于DA_ALGORITHM_PARALLEL_MIN_SIZE时分块在多个线程中执行
+/// \note 所有迭代器需要是随机访问迭代器，op会在多个线程中同时调用，需要是线程安全的，且不能抛出异常
+///
+template< class InputIterator1, class InputIterator2, class InputIterator3, class OutputIterator, class ThreeOperation >
+OutputIterator parallel_transform(InputIterator1 first1, InputIterator1 last1, InputIterator2 first2, InputIterator3 first3, OutputIterator result_first, ThreeOperation three_op)
+{
+    return (detail::parallel_transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, three_op, first1, first2, first3));
+}
+
+template< class InputIterator1, class InputIterator2, class InputIterator3, class InputIterator4, class OutputIterator, class FourOperation >
+OutputIterator parallel_transform(InputIterator1 first1,
+                                  InputIterator1 last1,
+                                  InputIterator2 first2,
+                                  InputIterator3 first3,
+                                  InputIterator4 first4,
+                                  OutputIterator result_first,
+                                  FourOperation four_op)
+{
+    return (detail::parallel_transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, four_op, first1, first2, first3, first4));
+}
+
+template< class InputIterator1, class InputIterator2, class InputIterator3, class InputIterator4, class InputIterator5, class OutputIterator, class FiveOperation >
+OutputIterator parallel_transform(InputIterator1 first1,
+                                  InputIterator1 last1,
+                                  InputIterator2 first2,
+                                  InputIterator3 first3,
+                                  InputIterator4 first4,
+                                  InputIterator5 first5,
+                                  OutputIterator result_first,
+                                  FiveOperation five_op)
+{
+    return (detail::parallel_transform_n(static_cast< std::size_t >(std::distance(first1, last1)), result_first, five_op, first1, first2, first3, first4, first5));
+}
+
+template< class InputIterator1, class InputIterator2, class InputIterator3, class InputIterator4, class InputIterator5, class InputIterator6, class OutputIterator, class SixOperation >
+OutputIterator parallel_transform(InputIterator1 first1,
+                                  InputIterator1 last1,
+                                  InputIterator2 first2,
+                                  InputIterator3 first3,
+                                  InputIterator4 first4,
+                                  InputIterator5 first5,
+                                  InputIterator6 first6,
+                                  OutputIterator result_first,
+                                  SixOperation six_op)
+{
+    return (detail::parallel_transform_n(static_cast< std::size_t >(std::distance(first1, last1)),
+                                         result_first,
+                                         six_op,
+                                         first1,
+                                         first2,
+                                         first3,
+                                         first4,
+                                         first5,
+                                         first6));
+}
+
+///
+/// \brief 并行的稳定排序，把序列分为若干段，在多个线程中分别排序后再两两归并
+/// \param first 随机访问迭代器
+/// \param last 随机访问迭代器
+/// \param comp 比较函数，需要是线程安全的
+/// \param min_parallel_size 长度小于此值时直接调用std::stable_sort
+///
+template< typename _IT_Random, typename _Compare >
+void parallel_stable_sort(_IT_Random first, _IT_Random last, _Compare comp, std::size_t min_parallel_size = 65536)
+{
+    const std::size_t n = static_cast< std::size_t >(std::distance(first, last));
+    std::size_t parts   = std::thread::hardware_concurrency();
+    if (min_parallel_size < 2) {
+        min_parallel_size = 2;
+    }
+    parts = std::min(parts, n / (min_parallel_size / 2));
+    if (n < min_parallel_size || parts < 2) {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+    // 分段的边界
+    std::vector< _IT_Random > bounds;
+    bounds.reserve(parts + 1);
+    for (std::size_t i = 0; i < parts; ++i) {
+        bounds.push_back(first + static_cast< std::ptrdiff_t >(n * i / parts));
+    }
+    bounds.push_back(last);
+    // 每段一个线程排序，当前线程处理第一段
+    std::vector< std::thread > threads;
+    threads.reserve(parts - 1);
+    for (std::size_t i = 1; i < parts; ++i) {
+        threads.emplace_back([ &bounds, &comp, i ]() { std::stable_sort(bounds[ i ], bounds[ i + 1 ], comp); });
+    }
+    std::stable_sort(bounds[ 0 ], bounds[ 1 ], comp);
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    // 逐级两两归并，同一级的归并互不重叠，可以并行
+    while (bounds.size() > 2) {
+        std::vector< _IT_Random > next;
+        threads.clear();
+        for (std::size_t i = 0; i + 2 < bounds.size(); i += 2) {
+            threads.emplace_back([ &bounds, &comp, i ]() { std::inplace_merge(bounds[ i ], bounds[ i + 1 ], bounds[ i + 2 ], comp); });
+            next.push_back(bounds[ i ]);
+        }
+        if ((bounds.size() - 1) % 2 != 0) {
+            // 段数为奇数，最后一段留到下一级
+            next.push_back(bounds[ bounds.size() - 2 ]);
+        }
+        next.push_back(last);
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        bounds.swap(next);
+    }
+}
 }
 
 #endif  // DA_ALGORITHM_H
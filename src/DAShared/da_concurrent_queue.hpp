@@ -1,6 +1,7 @@
 ﻿#ifndef DA_CONCURRENT_QUEUE_H
 #define DA_CONCURRENT_QUEUE_H
 #include <queue>
+#include <chrono>
 #include <mutex>
 #include <condition_variable>
 
@@ -28,9 +29,11 @@ public:
     bool        empty() const;
     std::size_t size() const;
     void        push(const T& v);
+    bool        push(const T& v, int waitms);
     void        set(const T& v);
     T           get();
     T           get(int waitms);
+    bool        get(T& v, int waitms);
 
 private:
     size_type               m_capacity;  ///< 容积,0代表不做限制
@@ -90,6 +93,28 @@ void da_concurrent_queue< T >::push(const T& v)
     m_popWait.notify_one();
 }
 
+/**
+ * @brief 有等待时间的推入
+ *
+ * 队列已满时最多等待waitms毫秒，用于生产者在等待期间需要检查取消标记的场景
+ * @param v
+ * @param waitms 等待的毫秒
+ * @return 超时没有推入返回false
+ */
+template< typename T >
+bool da_concurrent_queue< T >::push(const T& v, int waitms)
+{
+    std::unique_lock< std::mutex > lg(m_mutex);
+    if (m_capacity > 0) {
+        if (!m_pushWait.wait_for(lg, std::chrono::milliseconds(waitms), [this] { return this->m_fifo.size() < this->m_capacity; })) {
+            return false;
+        }
+    }
+    m_fifo.push(v);
+    m_popWait.notify_one();
+    return true;
+}
+
 template< typename T >
 void da_concurrent_queue< T >::set(const T& v)
 {
@@ -142,6 +167,29 @@ T da_concurrent_queue< T >::get(int waitms)
     return v;
 }
 
+/**
+ * @brief 有等待时间的获取，可以区分超时和取到的值
+ * @param v 获取的值，超时时不改变
+ * @param waitms 等待的毫秒
+ * @return 超时返回false
+ */
+template< typename T >
+bool da_concurrent_queue< T >::get(T& v, int waitms)
+{
+    std::unique_lock< std::mutex > lg(m_mutex);
+    if (!m_popWait.wait_for(lg, std::chrono::milliseconds(waitms), [this] { return !(this->m_fifo.empty()); })) {
+        return false;
+    }
+    v = m_fifo.front();
+
+    m_fifo.pop();
+    if (m_capacity > 0) {
+        //如果有推出，则推入的等待可以唤醒
+        m_pushWait.notify_one();
+    }
+    return true;
+}
+
 /**
  * @brief 获取队列的尺寸
  * @return
@@ -0,0 +1,904 @@
+﻿#include "DACsvChunkReader.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QSet>
+#include <QThread>
+namespace DA
+{
+const qint64 DACsvChunkReader::NullDateTime = std::numeric_limits< qint64 >::min();
+
+/**
+ * @brief 字段在块中的位置
+ */
+struct _DACsvField
+{
+	quint32 offset { 0 };  ///< 相对块起始位置的偏移
+	quint32 length { 0 };  ///< 字段长度，最高位为1代表字段内有""转义
+};
+static const quint32 c_csvFieldEscapedMask = 0x80000000u;
+static const qint64 c_csvMaxChunkBytes     = 0x7FFFFFFF;
+
+/**
+ * @brief 推断的类型，Empty代表目前只遇到缺失值
+ */
+enum _DACsvInferType
+{
+	CsvInferEmpty = 0,
+	CsvInferInt64,
+	CsvInferDouble,
+	CsvInferDateTime,
+	CsvInferBool,
+	CsvInferString
+};
+
+/**
+ * @brief 一个解析块
+ */
+struct _DACsvChunk
+{
+	qint64 begin { 0 };  ///< 在文件中的起始字节
+	qint64 end { 0 };    ///< 在文件中的结束字节（不包含）
+	int rowCount { 0 };
+	qint64 rowOffset { 0 };                             ///< 此块第一行在整个表中的行号
+	std::vector< std::vector< _DACsvField > > fields;  ///< 按列存放的字段
+	std::vector< _DACsvInferType > types;               ///< 此块每列推断的类型
+	std::vector< char > hasMissing;                     ///< 此块每列是否有缺失值
+};
+
+/**
+ * @brief 合并两个推断类型
+ */
+static _DACsvInferType mergeCsvInferType(_DACsvInferType a, _DACsvInferType b)
+{
+	if (a == CsvInferEmpty) {
+		return b;
+	}
+	if (b == CsvInferEmpty || a == b) {
+		return a;
+	}
+	if ((a == CsvInferInt64 && b == CsvInferDouble) || (a == CsvInferDouble && b == CsvInferInt64)) {
+		return CsvInferDouble;
+	}
+	return CsvInferString;
+}
+
+/**
+ * @brief 判断是否为缺失值，和pandas默认的na_values一致
+ *
+ * 和pandas一样不去除首尾空白，" NA"不是缺失值
+ */
+static bool isCsvNullToken(const char* p, int len)
+{
+	static const char* const s_tokens[] = { "NA",   "NaN",  "nan",    "N/A",     "n/a",    "<NA>",    "#NA",
+		                                    "#N/A", "NULL", "null",   "None",    "-NaN",   "-nan",    "1.#IND",
+		                                    "-1.#IND", "1.#QNAN", "-1.#QNAN", "#N/A N/A" };
+	if (0 == len) {
+		return true;
+	}
+	for (const char* t : s_tokens) {
+		if (static_cast< int >(std::strlen(t)) == len && std::memcmp(p, t, static_cast< size_t >(len)) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief 判断是否为布尔值，和pandas默认的true_values/false_values一致
+ */
+static bool isCsvBoolToken(const char* p, int len)
+{
+	switch (len) {
+	case 4:
+		return std::memcmp(p, "True", 4) == 0 || std::memcmp(p, "TRUE", 4) == 0 || std::memcmp(p, "true", 4) == 0;
+	case 5:
+		return std::memcmp(p, "False", 5) == 0 || std::memcmp(p, "FALSE", 5) == 0 || std::memcmp(p, "false", 5) == 0;
+	default:
+		break;
+	}
+	return false;
+}
+
+/**
+ * @brief 去除首尾的空格和制表符，pandas解析数值时会忽略数值两侧的空白
+ */
+static void trimCsvSpace(const char*& p, int& len)
+{
+	while (len > 0 && (*p == ' ' || *p == '\t')) {
+		++p;
+		--len;
+	}
+	while (len > 0 && (p[ len - 1 ] == ' ' || p[ len - 1 ] == '\t')) {
+		--len;
+	}
+}
+
+static bool parseCsvInt64(const char* p, int len, qint64& v)
+{
+	trimCsvSpace(p, len);
+	if (len > 0 && *p == '+') {
+		++p;
+		--len;
+	}
+	if (len <= 0) {
+		return false;
+	}
+	auto r = std::from_chars(p, p + len, v);
+	return r.ec == std::errc() && r.ptr == p + len;
+}
+
+static bool parseCsvDouble(const char* p, int len, double& v)
+{
+	trimCsvSpace(p, len);
+	if (len > 0 && *p == '+') {
+		++p;
+		--len;
+	}
+	if (len <= 0) {
+		return false;
+	}
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+	auto r = std::from_chars(p, p + len, v);
+	return r.ec == std::errc() && r.ptr == p + len;
+#else
+	// 不支持浮点from_chars的标准库，使用和locale无关的Qt转换
+	bool ok = false;
+	v       = QByteArray::fromRawData(p, len).toDouble(&ok);
+	return ok;
+#endif
+}
+
+/**
+ * @brief 公历日期到1970-01-01的天数
+ */
+static qint64 csvDaysFromCivil(qint64 y, int m, int d)
+{
+	y -= m <= 2;
+	const qint64 era = (y >= 0 ? y : y - 399) / 400;
+	const qint64 yoe = y - era * 400;
+	const qint64 doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	const qint64 doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+/**
+ * @brief 解析日期时间
+ *
+ * 支持yyyy-MM-dd、yyyy/MM/dd，后面可以跟[空格或T]HH:mm[:ss[.zzz]]，末尾可以带Z
+ * @param ms 1970-01-01以来的毫秒数
+ */
+static bool parseCsvDateTime(const char* p, int len, qint64& ms)
+{
+	if (len > 0 && p[ len - 1 ] == 'Z') {
+		--len;
+	}
+	if (len < 10) {
+		return false;
+	}
+	auto isDigit = [ p ](int i) { return p[ i ] >= '0' && p[ i ] <= '9'; };
+	auto num     = [ p ](int i, int n) {
+        int v = 0;
+        for (int k = 0; k < n; ++k) {
+            v = v * 10 + (p[ i + k ] - '0');
+        }
+        return v;
+	};
+	for (int i : { 0, 1, 2, 3, 5, 6, 8, 9 }) {
+		if (!isDigit(i)) {
+			return false;
+		}
+	}
+	if ((p[ 4 ] != '-' && p[ 4 ] != '/') || p[ 7 ] != p[ 4 ]) {
+		return false;
+	}
+	const int y = num(0, 4);
+	const int m = num(5, 2);
+	const int d = num(8, 2);
+	if (m < 1 || m > 12 || d < 1 || d > 31) {
+		return false;
+	}
+	int h = 0, mi = 0, s = 0, msec = 0;
+	if (len > 10) {
+		if ((p[ 10 ] != ' ' && p[ 10 ] != 'T') || len < 16 || !isDigit(11) || !isDigit(12) || p[ 13 ] != ':'
+			|| !isDigit(14) || !isDigit(15)) {
+			return false;
+		}
+		h     = num(11, 2);
+		mi    = num(14, 2);
+		int i = 16;
+		if (len > 16) {
+			if (p[ 16 ] != ':' || len < 19 || !isDigit(17) || !isDigit(18)) {
+				return false;
+			}
+			s = num(17, 2);
+			i = 19;
+			if (len > 19) {
+				if (p[ 19 ] != '.') {
+					return false;
+				}
+				int nd = 0;
+				for (i = 20; i < len && isDigit(i); ++i, ++nd) {
+					if (nd < 3) {
+						msec = msec * 10 + (p[ i ] - '0');
+					}
+				}
+				if (nd == 0) {
+					return false;
+				}
+				for (; nd < 3; ++nd) {
+					msec *= 10;
+				}
+			}
+		}
+		if (i != len || h > 23 || mi > 59 || s > 60) {
+			return false;
+		}
+	}
+	const qint64 days = csvDaysFromCivil(y, m, d);
+	ms                = (((days * 24 + h) * 60 + mi) * 60 + s) * 1000 + msec;
+	return true;
+}
+
+/**
+ * @brief 根据字段更新推断类型
+ * @param parseDates 是否推断日期时间，pandas默认不解析日期，日期列保持为字符串
+ */
+static _DACsvInferType inferCsvField(_DACsvInferType t, const char* p, int len, bool escaped, bool parseDates)
+{
+	if (escaped || t == CsvInferString) {
+		return CsvInferString;
+	}
+	qint64 iv;
+	double dv;
+	switch (t) {
+	case CsvInferEmpty:
+		if (parseCsvInt64(p, len, iv)) {
+			return CsvInferInt64;
+		}
+		if (parseCsvDouble(p, len, dv)) {
+			return CsvInferDouble;
+		}
+		if (parseDates && parseCsvDateTime(p, len, iv)) {
+			return CsvInferDateTime;
+		}
+		if (isCsvBoolToken(p, len)) {
+			return CsvInferBool;
+		}
+		return CsvInferString;
+	case CsvInferInt64:
+		if (parseCsvInt64(p, len, iv)) {
+			return CsvInferInt64;
+		}
+		return parseCsvDouble(p, len, dv) ? CsvInferDouble : CsvInferString;
+	case CsvInferDouble:
+		return parseCsvDouble(p, len, dv) ? CsvInferDouble : CsvInferString;
+	case CsvInferDateTime:
+		return parseCsvDateTime(p, len, iv) ? CsvInferDateTime : CsvInferString;
+	case CsvInferBool:
+		return isCsvBoolToken(p, len) ? CsvInferBool : CsvInferString;
+	default:
+		break;
+	}
+	return CsvInferString;
+}
+
+/**
+ * @brief 计算[b,e)内引号个数的奇偶性，通过memchr查找
+ */
+static bool csvQuoteParity(const char* b, const char* e)
+{
+	bool odd = false;
+	while (b < e) {
+		const char* q = static_cast< const char* >(std::memchr(b, '"', static_cast< size_t >(e - b)));
+		if (!q) {
+			break;
+		}
+		odd = !odd;
+		b   = q + 1;
+	}
+	return odd;
+}
+
+/**
+ * @brief 解析一条记录，cur会移动到下一条记录的开头
+ * @param chunkBegin 字段偏移的基准
+ */
+static void parseCsvRecord(const char*& cur, const char* end, const char* chunkBegin, char delim, std::vector< _DACsvField >& row)
+{
+	row.clear();
+	while (true) {
+		_DACsvField f;
+		if (cur < end && *cur == '"') {
+			++cur;
+			const char* s = cur;
+			bool escaped  = false;
+			while (true) {
+				const char* q = static_cast< const char* >(std::memchr(cur, '"', static_cast< size_t >(end - cur)));
+				if (!q) {
+					// 引号不闭合，到末尾结束
+					f.offset = static_cast< quint32 >(s - chunkBegin);
+					f.length = static_cast< quint32 >(end - s);
+					cur      = end;
+					break;
+				}
+				if (q + 1 < end && q[ 1 ] == '"') {
+					escaped = true;
+					cur     = q + 2;
+					continue;
+				}
+				f.offset = static_cast< quint32 >(s - chunkBegin);
+				f.length = static_cast< quint32 >(q - s);
+				cur      = q + 1;
+				break;
+			}
+			if (escaped) {
+				f.length |= c_csvFieldEscapedMask;
+			}
+			// 闭合引号到分隔符之间的内容忽略
+			while (cur < end && *cur != delim && *cur != '\n' && *cur != '\r') {
+				++cur;
+			}
+		} else {
+			const char* s = cur;
+			while (cur < end && *cur != delim && *cur != '\n' && *cur != '\r') {
+				++cur;
+			}
+			f.offset = static_cast< quint32 >(s - chunkBegin);
+			f.length = static_cast< quint32 >(cur - s);
+		}
+		row.push_back(f);
+		if (cur >= end) {
+			return;
+		}
+		if (*cur == delim) {
+			++cur;
+			if (cur >= end) {
+				// 文件以分隔符结尾，最后一个字段为空
+				row.push_back(_DACsvField());
+				return;
+			}
+			continue;
+		}
+		if (*cur == '\r') {
+			++cur;
+			if (cur < end && *cur == '\n') {
+				++cur;
+			}
+		} else {
+			++cur;
+		}
+		return;
+	}
+}
+
+/**
+ * @brief 把字段转换为字符串，处理""转义
+ */
+static QString csvFieldToString(const char* chunkBegin, const _DACsvField& f)
+{
+	const char* p   = chunkBegin + f.offset;
+	const int len   = static_cast< int >(f.length & ~c_csvFieldEscapedMask);
+	const bool esc  = (f.length & c_csvFieldEscapedMask) != 0;
+	if (!esc) {
+		return QString::fromUtf8(p, len);
+	}
+	QByteArray b(p, len);
+	b.replace("\"\"", "\"");
+	return QString::fromUtf8(b);
+}
+
+//===================================================
+// DACsvChunkReader::PrivateData
+//===================================================
+class DACsvChunkReader::PrivateData
+{
+	DA_DECLARE_PUBLIC(DACsvChunkReader)
+public:
+	PrivateData(DACsvChunkReader* p);
+	bool parse(const char* data, qint64 size);
+	// 切分块
+	std::vector< _DACsvChunk > splitChunks(const char* data, qint64 begin, qint64 size) const;
+	// 第一阶段：解析块内的字段并推断类型
+	void scanChunk(const char* data, _DACsvChunk& c, int colCount);
+	// 第二阶段：把块内的字段转换为类型化的列
+	void convertChunk(const char* data, _DACsvChunk& c);
+	// 在工作线程执行任务，调用线程负责汇报进度，返回false代表取消或出错
+	bool runTasks(std::vector< _DACsvChunk >& chunks, const std::function< void(_DACsvChunk&) >& fn, qint64 progressBase, qint64 total);
+
+public:
+	char mDelimiter { ',' };
+	bool mHaveHeader { true };
+	bool mParseDates { false };
+	int mThreadCount { 0 };
+	qint64 mChunkSize { 16 * 1024 * 1024 };
+	ProgressCallback mProgress;
+	std::atomic_bool mCancel { false };
+	QString mLastError;
+	int mRowCount { 0 };
+	std::vector< Column > mColumns;
+};
+
+DACsvChunkReader::PrivateData::PrivateData(DACsvChunkReader* p) : q_ptr(p)
+{
+	mThreadCount = std::max(1, QThread::idealThreadCount());
+}
+
+/**
+ * @brief 按mChunkSize切分块，块的边界一定是引号外的换行之后
+ *
+ * 切分是顺序执行的，只通过memchr统计引号的奇偶性和查找换行，不解析字段
+ */
+std::vector< _DACsvChunk > DACsvChunkReader::PrivateData::splitChunks(const char* data, qint64 begin, qint64 size) const
+{
+	std::vector< qint64 > bounds { begin };
+	qint64 pos    = begin;
+	bool inQuote  = false;
+	while (true) {
+		const qint64 target = bounds.back() + mChunkSize;
+		if (target >= size) {
+			break;
+		}
+		inQuote ^= csvQuoteParity(data + pos, data + target);
+		pos        = target;
+		bool found = false;
+		while (pos < size) {
+			const char* nl = static_cast< const char* >(std::memchr(data + pos, '\n', static_cast< size_t >(size - pos)));
+			if (!nl) {
+				pos = size;
+				break;
+			}
+			inQuote ^= csvQuoteParity(data + pos, nl);
+			pos = (nl - data) + 1;
+			if (!inQuote) {
+				found = true;
+				break;
+			}
+		}
+		if (!found || pos >= size) {
+			break;
+		}
+		bounds.push_back(pos);
+	}
+	bounds.push_back(size);
+	std::vector< _DACsvChunk > chunks(bounds.size() - 1);
+	for (size_t i = 0; i < chunks.size(); ++i) {
+		chunks[ i ].begin = bounds[ i ];
+		chunks[ i ].end   = bounds[ i + 1 ];
+	}
+	return chunks;
+}
+
+void DACsvChunkReader::PrivateData::scanChunk(const char* data, _DACsvChunk& c, int colCount)
+{
+	const char* chunkBegin = data + c.begin;
+	const char* cur        = chunkBegin;
+	const char* end        = data + c.end;
+	c.fields.assign(colCount, std::vector< _DACsvField >());
+	c.types.assign(colCount, CsvInferEmpty);
+	c.hasMissing.assign(colCount, 0);
+	std::vector< _DACsvField > row;
+	row.reserve(colCount);
+	int rows = 0;
+	while (cur < end) {
+		parseCsvRecord(cur, end, chunkBegin, mDelimiter, row);
+		if (row.size() == 1 && row[ 0 ].length == 0) {
+			// 空行
+			continue;
+		}
+		if (static_cast< int >(row.size()) > colCount) {
+			// pandas遇到多余的字段会报错（首行多一个字段时作为索引），这里不丢弃字段，交给调用者回退到pandas
+			throw std::runtime_error(QObject::tr("expected %1 fields, saw %2")
+			                             .arg(colCount)
+			                             .arg(row.size())
+			                             .toStdString());
+		}
+		for (int col = 0; col < colCount; ++col) {
+			const _DACsvField f = (col < static_cast< int >(row.size())) ? row[ col ] : _DACsvField();
+			c.fields[ col ].push_back(f);
+			const char* p    = chunkBegin + f.offset;
+			const int len    = static_cast< int >(f.length & ~c_csvFieldEscapedMask);
+			const bool esc   = (f.length & c_csvFieldEscapedMask) != 0;
+			if (!esc && isCsvNullToken(p, len)) {
+				c.hasMissing[ col ] = 1;
+			} else {
+				c.types[ col ] = inferCsvField(c.types[ col ], p, len, esc, mParseDates);
+			}
+		}
+		++rows;
+		if ((rows & 0x3FFF) == 0 && mCancel) {
+			return;
+		}
+	}
+	c.rowCount = rows;
+}
+
+void DACsvChunkReader::PrivateData::convertChunk(const char* data, _DACsvChunk& c)
+{
+	const char* chunkBegin = data + c.begin;
+	for (size_t col = 0; col < mColumns.size(); ++col) {
+		Column& column                          = mColumns[ col ];
+		const std::vector< _DACsvField >& flds = c.fields[ col ];
+		const size_t base                       = static_cast< size_t >(c.rowOffset);
+		for (size_t r = 0; r < flds.size(); ++r) {
+			const _DACsvField& f = flds[ r ];
+			const char* p        = chunkBegin + f.offset;
+			const int len        = static_cast< int >(f.length & ~c_csvFieldEscapedMask);
+			const bool esc       = (f.length & c_csvFieldEscapedMask) != 0;
+			const bool missing   = !esc && isCsvNullToken(p, len);
+			switch (column.type) {
+			case ColumnInt64: {
+				qint64 v = 0;
+				parseCsvInt64(p, len, v);
+				column.int64s[ base + r ] = v;
+			} break;
+			case ColumnDouble: {
+				double v = std::numeric_limits< double >::quiet_NaN();
+				if (!missing && !parseCsvDouble(p, len, v)) {
+					v = std::numeric_limits< double >::quiet_NaN();
+				}
+				column.doubles[ base + r ] = v;
+			} break;
+			case ColumnDateTime: {
+				qint64 v = NullDateTime;
+				if (!missing && !parseCsvDateTime(p, len, v)) {
+					v = NullDateTime;
+				}
+				column.int64s[ base + r ] = v;
+			} break;
+			default:
+				if (!missing) {
+					column.strings[ base + r ] = csvFieldToString(chunkBegin, f);
+				}
+				break;
+			}
+		}
+		// 转换完成释放字段位置
+		std::vector< _DACsvField >().swap(c.fields[ col ]);
+	}
+}
+
+bool DACsvChunkReader::PrivateData::runTasks(std::vector< _DACsvChunk >& chunks,
+                                             const std::function< void(_DACsvChunk&) >& fn,
+                                             qint64 progressBase,
+                                             qint64 total)
+{
+	const int n = static_cast< int >(chunks.size());
+	std::atomic_int next { 0 };
+	std::atomic< qint64 > processed { 0 };
+	std::atomic_bool failed { false };
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::string why;
+	const int threadCount = std::max(1, std::min(mThreadCount, n));
+	int activeCount       = threadCount;
+	auto worker           = [ & ]() {
+        while (!mCancel && !failed) {
+            const int i = next++;
+            if (i >= n) {
+                break;
+            }
+            try {
+                fn(chunks[ i ]);
+            } catch (const std::exception& e) {
+                std::lock_guard< std::mutex > lk(mutex);
+                why    = e.what();
+                failed = true;
+            }
+            processed += chunks[ i ].end - chunks[ i ].begin;
+            cv.notify_one();
+        }
+        {
+            std::lock_guard< std::mutex > lk(mutex);
+            --activeCount;
+        }
+        cv.notify_one();
+	};
+	std::vector< std::thread > threads;
+	threads.reserve(threadCount);
+	for (int i = 0; i < threadCount; ++i) {
+		threads.emplace_back(worker);
+	}
+	while (true) {
+		bool allDone = false;
+		{
+			std::unique_lock< std::mutex > lk(mutex);
+			cv.wait_for(lk, std::chrono::milliseconds(100));
+			allDone = (0 == activeCount);
+		}
+		if (mProgress && !mProgress(progressBase + processed, total)) {
+			mCancel = true;
+		}
+		if (allDone) {
+			break;
+		}
+	}
+	for (std::thread& t : threads) {
+		t.join();
+	}
+	if (failed) {
+		mLastError = QObject::tr("parse csv failed:%1").arg(QString::fromStdString(why));
+		return false;
+	}
+	if (mCancel) {
+		mLastError = QObject::tr("read csv canceled");
+		return false;
+	}
+	return true;
+}
+
+bool DACsvChunkReader::PrivateData::parse(const char* data, qint64 size)
+{
+	qint64 start = 0;
+	if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0) {
+		start = 3;
+	}
+	// 跳过开头的空行
+	while (start < size && (data[ start ] == '\n' || data[ start ] == '\r')) {
+		++start;
+	}
+	if (start >= size) {
+		mLastError = QObject::tr("csv file is empty");
+		return false;
+	}
+	//! 1.解析表头
+	std::vector< _DACsvField > header;
+	const char* cur = data + start;
+	parseCsvRecord(cur, data + std::min(size, start + c_csvMaxChunkBytes), data + start, mDelimiter, header);
+	const int colCount = static_cast< int >(header.size());
+	QSet< QString > names;
+	mColumns.assign(colCount, Column());
+	for (int i = 0; i < colCount; ++i) {
+		QString name = mHaveHeader ? csvFieldToString(data + start, header[ i ]) : QString::number(i);
+		if (name.isEmpty()) {
+			// 和pandas一样，空表头命名为Unnamed: 列号
+			name = QStringLiteral("Unnamed: %1").arg(i);
+		}
+		// 重名的列和pandas一样加上.n后缀
+		if (names.contains(name)) {
+			int k = 1;
+			while (names.contains(QStringLiteral("%1.%2").arg(name).arg(k))) {
+				++k;
+			}
+			name = QStringLiteral("%1.%2").arg(name).arg(k);
+		}
+		names.insert(name);
+		mColumns[ i ].name = name;
+	}
+	const qint64 dataBegin = mHaveHeader ? (cur - data) : start;
+	//! 2.切分块
+	std::vector< _DACsvChunk > chunks = splitChunks(data, dataBegin, size);
+	for (const _DACsvChunk& c : chunks) {
+		if (c.end - c.begin > c_csvMaxChunkBytes) {
+			mLastError = QObject::tr("csv record is too large");
+			return false;
+		}
+	}
+	const qint64 total = 2 * (size - dataBegin);
+	//! 3.并行解析字段并推断类型
+	if (!runTasks(chunks, [ this, data, colCount ](_DACsvChunk& c) { scanChunk(data, c, colCount); }, 0, total)) {
+		mColumns.clear();
+		return false;
+	}
+	//! 4.合并各块的类型
+	qint64 rows = 0;
+	for (_DACsvChunk& c : chunks) {
+		c.rowOffset = rows;
+		rows += c.rowCount;
+	}
+	if (rows > std::numeric_limits< int >::max()) {
+		mLastError = QObject::tr("csv file has too many rows");
+		mColumns.clear();
+		return false;
+	}
+	for (int col = 0; col < colCount; ++col) {
+		_DACsvInferType t = CsvInferEmpty;
+		bool missing      = false;
+		for (const _DACsvChunk& c : chunks) {
+			t       = mergeCsvInferType(t, c.types[ col ]);
+			missing = missing || c.hasMissing[ col ];
+		}
+		Column& column = mColumns[ col ];
+		switch (t) {
+		case CsvInferInt64:
+			// 整数列有缺失值时和pandas一样转为浮点
+			column.type = missing ? ColumnDouble : ColumnInt64;
+			break;
+		case CsvInferDateTime:
+			column.type = ColumnDateTime;
+			break;
+		case CsvInferString:
+			column.type = ColumnString;
+			break;
+		case CsvInferBool:
+			// 布尔列在pandas中为bool或object，这里没有对应的列类型，交给调用者回退到pandas
+			mLastError = QObject::tr("column %1 is boolean").arg(column.name);
+			mColumns.clear();
+			return false;
+		default:
+			column.type = ColumnDouble;
+			break;
+		}
+		switch (column.type) {
+		case ColumnInt64:
+		case ColumnDateTime:
+			column.int64s.resize(static_cast< size_t >(rows));
+			break;
+		case ColumnDouble:
+			column.doubles.resize(static_cast< size_t >(rows));
+			break;
+		default:
+			column.strings.resize(static_cast< size_t >(rows));
+			break;
+		}
+	}
+	//! 5.并行转换为类型化的列
+	if (!runTasks(chunks, [ this, data ](_DACsvChunk& c) { convertChunk(data, c); }, size - dataBegin, total)) {
+		mColumns.clear();
+		return false;
+	}
+	mRowCount = static_cast< int >(rows);
+	return true;
+}
+
+//===================================================
+// DACsvChunkReader
+//===================================================
+DACsvChunkReader::DACsvChunkReader() : DA_PIMPL_CONSTRUCT
+{
+}
+
+DACsvChunkReader::~DACsvChunkReader()
+{
+}
+
+void DACsvChunkReader::setDelimiter(char c)
+{
+	d_ptr->mDelimiter = c;
+}
+
+char DACsvChunkReader::getDelimiter() const
+{
+	return d_ptr->mDelimiter;
+}
+
+void DACsvChunkReader::setHaveHeader(bool on)
+{
+	d_ptr->mHaveHeader = on;
+}
+
+bool DACsvChunkReader::isHaveHeader() const
+{
+	return d_ptr->mHaveHeader;
+}
+
+/**
+ * @brief 设置是否把yyyy-MM-dd[ HH:mm:ss]格式的列解析为日期时间
+ *
+ * pandas默认不解析日期，日期列为字符串，为了和pandas的结果一致默认为false
+ * @param on
+ */
+void DACsvChunkReader::setParseDates(bool on)
+{
+	d_ptr->mParseDates = on;
+}
+
+bool DACsvChunkReader::isParseDates() const
+{
+	return d_ptr->mParseDates;
+}
+
+void DACsvChunkReader::setThreadCount(int n)
+{
+	d_ptr->mThreadCount = std::max(1, n);
+}
+
+int DACsvChunkReader::getThreadCount() const
+{
+	return d_ptr->mThreadCount;
+}
+
+/**
+ * @brief 设置每块的字节数
+ * @param bytes 最小为64KB，最大为1GB
+ */
+void DACsvChunkReader::setChunkSize(qint64 bytes)
+{
+	d_ptr->mChunkSize = qBound< qint64 >(64 * 1024, bytes, 1024 * 1024 * 1024);
+}
+
+qint64 DACsvChunkReader::getChunkSize() const
+{
+	return d_ptr->mChunkSize;
+}
+
+void DACsvChunkReader::setProgressCallback(const ProgressCallback& fn)
+{
+	d_ptr->mProgress = fn;
+}
+
+/**
+ * @brief 读取文件
+ * @param filePath
+ * @return 成功返回true，失败或取消返回false，可以通过@ref getLastErrorString 获取原因
+ */
+bool DACsvChunkReader::read(const QString& filePath)
+{
+	d_ptr->mColumns.clear();
+	d_ptr->mRowCount = 0;
+	d_ptr->mLastError.clear();
+	d_ptr->mCancel = false;
+	QFile file(filePath);
+	if (!file.open(QIODevice::ReadOnly)) {
+		d_ptr->mLastError = QObject::tr("can not open file %1").arg(filePath);
+		return false;
+	}
+	const qint64 size = file.size();
+	if (size <= 0) {
+		d_ptr->mLastError = QObject::tr("csv file is empty");
+		return false;
+	}
+	// 优先内存映射，映射在file关闭时解除
+	QByteArray buffer;
+	const char* data = reinterpret_cast< const char* >(file.map(0, size));
+	if (!data) {
+		buffer = file.readAll();
+		if (buffer.size() != size) {
+			d_ptr->mLastError = QObject::tr("can not read file %1").arg(filePath);
+			return false;
+		}
+		data = buffer.constData();
+	}
+	return d_ptr->parse(data, size);
+}
+
+void DACsvChunkReader::cancel()
+{
+	d_ptr->mCancel = true;
+}
+
+bool DACsvChunkReader::isCanceled() const
+{
+	return d_ptr->mCancel;
+}
+
+QString DACsvChunkReader::getLastErrorString() const
+{
+	return d_ptr->mLastError;
+}
+
+int DACsvChunkReader::rowCount() const
+{
+	return d_ptr->mRowCount;
+}
+
+int DACsvChunkReader::columnCount() const
+{
+	return static_cast< int >(d_ptr->mColumns.size());
+}
+
+const DACsvChunkReader::Column& DACsvChunkReader::column(int i) const
+{
+	return d_ptr->mColumns[ static_cast< size_t >(i) ];
+}
+
+std::vector< DACsvChunkReader::Column > DACsvChunkReader::takeColumns()
+{
+	std::vector< Column > res;
+	res.swap(d_ptr->mColumns);
+	d_ptr->mRowCount = 0;
+	return res;
+}
+}  // end namespace DA
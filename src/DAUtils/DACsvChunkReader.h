@@ -0,0 +1,111 @@
+﻿#ifndef DACSVCHUNKREADER_H
+#define DACSVCHUNKREADER_H
+#include "DAUtilsAPI.h"
+#include <functional>
+#include <vector>
+#include <QString>
+namespace DA
+{
+
+/**
+ * @brief 分块并行读取csv文件
+ *
+ * 相比@ref DACsvStream 逐行通过QTextStream解析，此类针对大文件导入：
+ *
+ * - 文件通过内存映射读取（映射失败时一次性读入）
+ * - 通过memchr查找换行和引号，按引号奇偶性把文件切分为互不相关的块
+ * - 每个块在工作线程中解析，字段以偏移+长度的形式记录，不生成临时字符串
+ * - 每列推断类型（整数/浮点/日期时间/字符串），合并各块的推断结果后再并行转换为类型化的列
+ *
+ * 解析结果和pandas.read_csv的默认参数保持一致：数值两侧的空白会忽略，空表头命名为"Unnamed: n"，
+ * 默认不解析日期（@ref setParseDates ），遇到pandas有不同处理的情况（字段数多于表头、布尔列）会读取失败，
+ * 调用者应回退到pandas
+ *
+ * 读取过程可以通过进度回调获取进度，回调返回false或调用@ref cancel 可以取消读取
+ *
+ * @code
+ * DACsvChunkReader reader;
+ * reader.setProgressCallback([](qint64 done, qint64 total) { qDebug() << done << "/" << total; return true; });
+ * if (reader.read("data.csv")) {
+ *     for (int i = 0; i < reader.columnCount(); ++i) {
+ *         const DACsvChunkReader::Column& c = reader.column(i);
+ *     }
+ * }
+ * @endcode
+ *
+ * @note 只支持utf-8编码（带bom或不带bom）
+ */
+class DAUTILS_API DACsvChunkReader
+{
+	DA_DECLARE_PRIVATE(DACsvChunkReader)
+public:
+	/**
+	 * @brief 列类型
+	 */
+	enum ColumnType
+	{
+		ColumnInt64,     ///< 整数，存放在int64s
+		ColumnDouble,    ///< 浮点，存放在doubles，缺失值为nan
+		ColumnDateTime,  ///< 日期时间，存放在int64s，为1970-01-01以来的毫秒数，缺失值为@ref NullDateTime
+		ColumnString     ///< 字符串，存放在strings
+	};
+
+	/**
+	 * @brief 一列数据
+	 */
+	struct Column
+	{
+		QString name;
+		ColumnType type { ColumnDouble };
+		std::vector< qint64 > int64s;
+		std::vector< double > doubles;
+		std::vector< QString > strings;
+	};
+
+	/**
+	 * @brief 进度回调，processed为已经处理的字节数，total为总字节数，返回false将取消读取
+	 */
+	using ProgressCallback = std::function< bool(qint64 processed, qint64 total) >;
+
+	/**
+	 * @brief 日期时间的缺失值，和numpy的NaT一致
+	 */
+	static const qint64 NullDateTime;
+
+public:
+	DACsvChunkReader();
+	~DACsvChunkReader();
+	// 分隔符，默认为逗号
+	void setDelimiter(char c);
+	char getDelimiter() const;
+	// 第一行是否为表头，默认为true
+	void setHaveHeader(bool on);
+	bool isHaveHeader() const;
+	// 是否解析日期时间，默认为false，和pandas一致
+	void setParseDates(bool on);
+	bool isParseDates() const;
+	// 解析线程数，默认为QThread::idealThreadCount
+	void setThreadCount(int n);
+	int getThreadCount() const;
+	// 每块的字节数，默认16MB
+	void setChunkSize(qint64 bytes);
+	qint64 getChunkSize() const;
+	// 进度回调，回调在调用read的线程执行
+	void setProgressCallback(const ProgressCallback& fn);
+	// 读取文件
+	bool read(const QString& filePath);
+	// 取消读取，可以在其它线程调用
+	void cancel();
+	bool isCanceled() const;
+	// 错误信息
+	QString getLastErrorString() const;
+	// 读取的结果
+	int rowCount() const;
+	int columnCount() const;
+	const Column& column(int i) const;
+	// 取出所有列，调用后reader中不再持有数据
+	std::vector< Column > takeColumns();
+};
+}  // end namespace DA
+
+#endif  // DACSVCHUNKREADER_H
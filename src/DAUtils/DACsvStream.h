@@ -8,6 +8,8 @@ namespace DA
 {
 ///
 /// \brief 写csv文件类支持
+///
+/// 逐行读取适合小文件，大文件导入使用\sa DACsvChunkReader
 /// \author czy
 /// \date 2016-08-10
 ///
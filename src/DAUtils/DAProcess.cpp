@@ -10,6 +10,8 @@ DAProcess::DAProcess(QObject* par) : QProcess(par)
 {
 	connect(this, &DAProcess::readyReadStandardError, this, &DAProcess::onReadyReadStandardError);
 	connect(this, &DAProcess::readyReadStandardOutput, this, &DAProcess::onReadyReadStandardOutput);
+	// 先于外部的finished连接，保证最后的输出在finished之前发出
+	connect(this, QOverload< int, QProcess::ExitStatus >::of(&DAProcess::finished), this, &DAProcess::onProcessFinished);
 }
 
 void DAProcess::run()
@@ -32,6 +34,15 @@ void DAProcess::setEncoding(const char* codecName)
 	mCodecName = codecName;
 }
 
+/**
+ * @brief 写入标准输入
+ * @param data
+ */
+void DAProcess::sendData(const QByteArray& data)
+{
+	write(data);
+}
+
 void DAProcess::run(const QString& command, QIODevice::OpenMode mode)
 {
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
@@ -43,24 +54,60 @@ void DAProcess::run(const QString& command, QIODevice::OpenMode mode)
 
 void DAProcess::onReadyReadStandardOutput()
 {
-	QByteArray allout = readAll();
-	QTextStream ss(&allout);
-	setEncoding(&ss, mCodecName);
-	while (!ss.atEnd()) {
-		QString line = ss.readLine();
+	const QStringList lines = takeLines(mOutputBuffer, readAllStandardOutput());
+	for (const QString& line : lines) {
 		emit processStarandOutput(line);
 	}
 }
 
 void DAProcess::onReadyReadStandardError()
 {
-	QByteArray allout = readAll();
-	QTextStream ss(&allout);
+	const QStringList lines = takeLines(mErrorBuffer, readAllStandardError());
+	for (const QString& line : lines) {
+		emit processErrorOutput(line);
+	}
+}
+
+/**
+ * @brief 进程结束时读取剩余的输出，最后一行没有换行结尾时也会发出
+ */
+void DAProcess::onProcessFinished()
+{
+	const QStringList outLines = takeLines(mOutputBuffer, readAllStandardOutput(), true);
+	for (const QString& line : outLines) {
+		emit processStarandOutput(line);
+	}
+	const QStringList errLines = takeLines(mErrorBuffer, readAllStandardError(), true);
+	for (const QString& line : errLines) {
+		emit processErrorOutput(line);
+	}
+}
+
+/**
+ * @brief 把完整的行发出，不完整的行保留在缓存中
+ *
+ * 一次readyRead可能只读到一行的一部分，直接按行解析会把一行拆成两行
+ * @param buffer 缓存
+ * @param data 新读取的数据
+ * @param flush 为true时缓存中不完整的行也作为一行发出，用于进程结束
+ * @return
+ */
+QStringList DAProcess::takeLines(QByteArray& buffer, const QByteArray& data, bool flush)
+{
+	buffer.append(data);
+	QStringList res;
+	const int end = flush ? buffer.size() - 1 : buffer.lastIndexOf('\n');
+	if (end < 0) {
+		return res;
+	}
+	QByteArray complete = buffer.left(end + 1);
+	buffer.remove(0, end + 1);
+	QTextStream ss(&complete);
 	setEncoding(&ss, mCodecName);
 	while (!ss.atEnd()) {
-		QString line = ss.readLine();
-		emit processErrorOutput(line);
+		res.append(ss.readLine());
 	}
+	return res;
 }
 
 void DAProcess::setEncoding(QTextStream* ss, const QString& codec)
@@ -140,6 +187,7 @@ void DAProcessWithThread::runProcess()
 		});  // 线程结束了，指针清空
 		// 把beginRunProcess 和DAProcess::run的槽绑定
 		connect(this, &DAProcessWithThread::beginRunProcess, mProcess, QOverload<>::of(&DA::DAProcess::run));
+		connect(this, &DAProcessWithThread::beginSendData, mProcess, &DAProcess::sendData);
 		connect(this, &DAProcessWithThread::beginKillProcess, mProcess, &DAProcess::kill);
 		connect(this, &DAProcessWithThread::beginTerminateProcess, mProcess, &DAProcess::terminate);
 		// 错误发生
@@ -151,14 +199,19 @@ void DAProcessWithThread::runProcess()
 			this->mLastError = errstr;
 			emit errorOccurred(error, errstr);
 		});
-		connect(mProcess, &DA::DAProcess::started, this, &DAProcessWithThread::processStarted);
+		// 信号在进程线程直接转发，接收者使用AutoConnection时仍会排队到接收者的线程
+		connect(mProcess, &DA::DAProcess::started, this, &DAProcessWithThread::processStarted, Qt::DirectConnection);
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
-		connect(mProcess, QOverload< int >::of(&DA::DAProcess::finished), this, &DAProcessWithThread::processFinished);
+		connect(mProcess,
+		        QOverload< int >::of(&DA::DAProcess::finished),
+		        this,
+		        &DAProcessWithThread::processFinished,
+		        Qt::DirectConnection);
 #else
-		connect(mProcess, &DA::DAProcess::finished, this, &DAProcessWithThread::processFinished);
+		connect(mProcess, &DA::DAProcess::finished, this, &DAProcessWithThread::processFinished, Qt::DirectConnection);
 #endif
-		connect(mProcess, &DA::DAProcess::processStarandOutput, this, &DAProcessWithThread::processStarandOutput);
-		connect(mProcess, &DA::DAProcess::processErrorOutput, this, &DAProcessWithThread::processErrorOutput);
+		connect(mProcess, &DA::DAProcess::processStarandOutput, this, &DAProcessWithThread::processStarandOutput, Qt::DirectConnection);
+		connect(mProcess, &DA::DAProcess::processErrorOutput, this, &DAProcessWithThread::processErrorOutput, Qt::DirectConnection);
 		mProcess->setProgram(mProgram);
 		mProcess->setArguments(mArguments);
 		mThread->start();
@@ -167,6 +220,11 @@ void DAProcessWithThread::runProcess()
 	emit beginRunProcess();
 }
 
+void DAProcessWithThread::sendData(const QByteArray& data)
+{
+	emit beginSendData(data);
+}
+
 void DAProcessWithThread::kill()
 {
 	emit beginKillProcess();
@@ -23,6 +23,8 @@ public slots:
 	void run(const QString& program, const QStringList& arguments, QIODevice::OpenMode mode);
 	// 设置编码
 	void setEncoding(const char* codecName);
+	// 写入标准输入
+	void sendData(const QByteArray& data);
 signals:
 	/**
 	 * @brief 标准输出
@@ -43,12 +45,18 @@ private slots:
 	void onReadyReadStandardOutput();
 	// 标准错误
 	void onReadyReadStandardError();
+	// 进程结束，发出缓存中剩余的输出
+	void onProcessFinished();
 
 private:
 	void setEncoding(QTextStream* ss, const QString& codec);
+	// 把完整的行发出，不完整的行保留在缓存中，flush为true时不完整的行也发出
+	QStringList takeLines(QByteArray& buffer, const QByteArray& data, bool flush = false);
 
 private:
-	QString mCodecName;  ///< 编码，决定了程序返回内容的编码解析
+	QString mCodecName;        ///< 编码，决定了程序返回内容的编码解析
+	QByteArray mOutputBuffer;  ///< 标准输出中未结束的行
+	QByteArray mErrorBuffer;   ///< 标准错误中未结束的行
 };
 
 /**
@@ -66,6 +74,9 @@ private:
  * mProcess.setProgram(xx);
  * mProcess.setArguments({"--value","12"});
  * @endcode
+ *
+ * 进程的输出信号在进程所在的线程中发射，使用Qt::AutoConnection连接时会自动排队到接收者的线程，
+ * 使用Qt::DirectConnection连接时可以不经过接收者线程的事件循环直接处理输出
  */
 class DAUTILS_API DAProcessWithThread : public QObject
 {
@@ -83,6 +94,8 @@ public:
 public slots:
 	// 运行进程，发射beginRunProcess
 	void runProcess();
+	// 写入进程的标准输入，发射beginSendData
+	void sendData(const QByteArray& data);
 	// kill,发射beginKillProcess
 	void kill();
 	// terminate,发射beginTerminateProcess
@@ -120,6 +133,11 @@ signals:
 	 * @param code 结束返回的代码
 	 */
 	void processFinished(int code);
+	/**
+	 * @brief 开始写入标准输入的信号
+	 * @param data
+	 */
+	void beginSendData(const QByteArray& data);
 	/**
 	 * @brief 进程开始kill
 	 */
@@ -0,0 +1,47 @@
+﻿#include "DAScriptTimeScope.h"
+namespace DA
+{
+/**
+ * @brief 当前线程累计的脚本时间（微秒）
+ */
+static thread_local qint64 s_script_time_us = 0;
+/**
+ * @brief 当前线程嵌套的作用域层数
+ */
+static thread_local int s_script_scope_depth = 0;
+
+DAScriptTimeScope::DAScriptTimeScope()
+{
+	if (0 == s_script_scope_depth++) {
+		mTimer.start();
+	}
+}
+
+DAScriptTimeScope::~DAScriptTimeScope()
+{
+	if (0 == --s_script_scope_depth) {
+		s_script_time_us += mTimer.nsecsElapsed() / 1000;
+	}
+}
+
+/**
+ * @brief 累计当前线程的脚本时间
+ * @param us 微秒
+ */
+void DAScriptTimeScope::addTime(qint64 us)
+{
+	s_script_time_us += us;
+}
+
+/**
+ * @brief 取出当前线程累计的脚本时间并清零
+ * @return 微秒
+ */
+qint64 DAScriptTimeScope::takeTime()
+{
+	const qint64 us = s_script_time_us;
+	s_script_time_us = 0;
+	return us;
+}
+
+}  // end DA
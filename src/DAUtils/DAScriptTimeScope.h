@@ -0,0 +1,37 @@
+﻿#ifndef DASCRIPTTIMESCOPE_H
+#define DASCRIPTTIMESCOPE_H
+#include <QElapsedTimer>
+#include "DAUtilsAPI.h"
+namespace DA
+{
+/**
+ * @brief 记录一段脚本（python）执行时间
+ *
+ * 时间累计到当前线程上，由使用者（例如工作流的性能分析器）在合适的时候通过@ref takeTime 取出，
+ * 因此只需在调用脚本的地方构造：
+ * @code
+ * {
+ *     DAScriptTimeScope s;
+ *     pyfun(args);
+ * }
+ * @endcode
+ *
+ * 嵌套的作用域只有最外层计时，脚本封装函数互相调用时不会重复累计
+ *
+ * 放在DAUtils中，DAPyScripts不需要依赖DAWorkFlow
+ */
+class DAUTILS_API DAScriptTimeScope
+{
+public:
+	DAScriptTimeScope();
+	~DAScriptTimeScope();
+	// 累计当前线程的脚本时间（微秒）
+	static void addTime(qint64 us);
+	// 取出当前线程累计的脚本时间（微秒）并清零
+	static qint64 takeTime();
+
+private:
+	QElapsedTimer mTimer;
+};
+}  // end DA
+#endif  // DASCRIPTTIMESCOPE_H
@@ -5,12 +5,16 @@
 #include "DAAbstractNodeFactory.h"
 #include "DAQtContainerUtil.hpp"
 #include "DAUniqueIDGenerater.h"
+#include "DANodeBatchStream.h"
 
 // Qxml
 #include <QPointer>
 #include <QDomComment>
 #include <QDomElement>
 #include <QDateTime>
+#include <QDataStream>
+#include <QReadWriteLock>
+#include <algorithm>
 
 /**
  * @def 此打印开启将会打印辅助信息
@@ -19,6 +23,36 @@
 
 namespace DA
 {
+/**
+ * @brief 合并哈希
+ */
+static uint64_t combineNodeHash(uint64_t seed, uint64_t v)
+{
+	return seed ^ (v + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2));
+}
+
+/**
+ * @brief 字节内容的哈希
+ */
+static uint64_t bytesNodeHash(const char* p, int len)
+{
+	return combineNodeHash(static_cast< uint64_t >(qHashBits(p, static_cast< size_t >(len), 0)), static_cast< uint64_t >(len));
+}
+
+/**
+ * @brief 自定义类型哈希函数的注册表
+ */
+struct DANodeVariantHashRegistry
+{
+	QReadWriteLock lock;
+	QHash< int, DAAbstractNode::VariantHashFunction > functions;
+	static DANodeVariantHashRegistry& instance()
+	{
+		static DANodeVariantHashRegistry s_registry;
+		return s_registry;
+	}
+};
+
 class DAAbstractNode::PrivateData
 {
 	DA_DECLARE_PUBLIC(DAAbstractNode)
@@ -40,6 +74,8 @@ public:
 	QList< LinkData > getOutputLinkData(const QString& k);
 	QList< LinkData > getInputLinkData(const QString& k);
 	static bool isEnableCallback(const std::shared_ptr< DAAbstractNodeFactory >& f);
+	// 连线改变，通知工作流执行计划失效
+	static void notifyLinkChanged(const DAAbstractNode* n);
 
 public:
 	PrivateData(DAAbstractNode* p);
@@ -54,6 +90,11 @@ public:
 	QPointer< DAWorkFlow > mWorkflow;               ///< 持有的workflow
 	DAAbstractNodeGraphicsItem* mItem { nullptr };  ///< node 对应的item
 	DAAbstractNodeFactory::WeakPointer mFactory;  ///< 保存节点的工厂，工厂的设置在DAWorkFlow::createNode中
+	uint64_t mOutputCacheFingerprint { 0 };       ///< 输出缓存对应的指纹，0代表没有有效的输出缓存
+	QSet< QString > mStreamingOutputKeys;         ///< 流式输出的key
+	QHash< QString, QList< DANodeBatchStream::SharedPointer > > mOutputStreams;  ///< 流式输出key对应的数据流，每条连线一个
+	QSet< QString > mReadInputKeys;  ///< 非流式输入作为单个批次读取后记录，避免重复读取
+	bool mKeepDataForInspection { false };  ///< 保留执行数据用于查看
 };
 
 //================================================
@@ -126,6 +167,15 @@ bool DAAbstractNode::PrivateData::isEnableCallback(const std::shared_ptr< DAAbst
 	return false;
 }
 
+void DAAbstractNode::PrivateData::notifyLinkChanged(const DAAbstractNode* n)
+{
+	if (n) {
+		if (DAWorkFlow* wf = n->workflow()) {
+			wf->invalidateExecutePlan();
+		}
+	}
+}
+
 //==============================================================
 // DAAbstractNode::PrivateData
 //==============================================================
@@ -551,6 +601,9 @@ bool DAAbstractNode::detachInputLinks(const QString& key)
 			}
 		}
 	}
+	if (!ins.isEmpty()) {
+		PrivateData::notifyLinkChanged(this);
+	}
 	return ins.size() > 0;
 }
 
@@ -571,6 +624,9 @@ bool DAAbstractNode::detachOutputLinks(const QString& key)
 			}
 		}
 	}
+	if (!outs.isEmpty()) {
+		PrivateData::notifyLinkChanged(this);
+	}
 	return outs.size() > 0;
 }
 
@@ -613,6 +669,9 @@ void DAAbstractNode::detachAll()
 			}
 		}
 	}
+	if (!d_ptr->mLinksInfo.isEmpty()) {
+		PrivateData::notifyLinkChanged(this);
+	}
 	d_ptr->mLinksInfo.clear();
 	//! 清空关系这里，不能清除workflow和factory的关系，尤其不能清除factory的关系
 	//! 因为在redo/undo下，undo后factory会丢失
@@ -788,6 +847,7 @@ void DAAbstractNode::setInputData(const QString& key, const QVariant& dp)
 		return;
 	}
 	d_ptr->mInputData[ key ] = dp;
+	d_ptr->mReadInputKeys.remove(key);
 }
 
 /**
@@ -941,6 +1001,7 @@ bool DAAbstractNode::linkTo_(const QString& outKey, DAAbstractNode::SharedPointe
 	DAAbstractNode::PrivateData::LinkData ld(pointer(), outKey, inNode, inKey);
 	d_ptr->mLinksInfo.append(ld);             // 当前记录连接信息
 	inNode->d_func()->mLinksInfo.append(ld);  // 被连接的节点也记录下连接信息
+	PrivateData::notifyLinkChanged(this);
 	return (true);
 }
 
@@ -994,6 +1055,311 @@ void DAAbstractNode::removeAllOutputKeys()
 	d_ptr->mOutputKeys.clear();
 }
 
+/**
+ * @brief 计算节点指纹
+ *
+ * 指纹由节点原型、所有属性以及所有输入数据计算得到，增量执行时指纹和上次执行成功时一致，说明节点的输出不会改变，
+ * 执行器会跳过此节点的执行，直接把上次的输出传递给下游节点
+ *
+ * 如果节点的输出还依赖于属性和输入之外的状态，可以重写此函数把这些状态加入指纹，或者在状态改变时调用@ref invalidateOutputCache
+ * @return 存在无法计算哈希的输入或属性时返回0，此时节点每次都会执行
+ * @sa variantHash
+ */
+uint64_t DAAbstractNode::calcFingerprint() const
+{
+	uint64_t h = combineNodeHash(0, qHash(getNodePrototype()));
+	// 属性按key排序，保证相同内容得到相同的指纹
+	QList< QString > keys = d_ptr->mPropertys.keys();
+	std::sort(keys.begin(), keys.end());
+	for (const QString& k : qAsConst(keys)) {
+		const QVariant& v = d_ptr->mPropertys[ k ];
+		uint64_t vh       = variantHash(v);
+		if (0 == vh && v.isValid()) {
+			return 0;
+		}
+		h = combineNodeHash(combineNodeHash(h, qHash(k)), vh);
+	}
+	// 输入按mInputKeys的顺序
+	for (const QString& k : qAsConst(d_ptr->mInputKeys)) {
+		const QVariant v = d_ptr->mInputData.value(k);
+		uint64_t vh      = variantHash(v);
+		if (0 == vh && v.isValid()) {
+			return 0;
+		}
+		h = combineNodeHash(combineNodeHash(h, qHash(k)), vh);
+	}
+	return (0 == h) ? 1 : h;
+}
+
+/**
+ * @brief 输出缓存对应的指纹
+ * @return 0代表没有有效的输出缓存
+ */
+uint64_t DAAbstractNode::getOutputCacheFingerprint() const
+{
+	return d_ptr->mOutputCacheFingerprint;
+}
+
+/**
+ * @brief 使输出缓存失效，下次执行时节点一定会执行
+ */
+void DAAbstractNode::invalidateOutputCache()
+{
+	d_ptr->mOutputCacheFingerprint = 0;
+}
+
+/**
+ * @brief 注册自定义类型的哈希函数
+ *
+ * 节点之间传递的自定义类型（例如DAData）需要注册哈希函数才能参与指纹计算，
+ * 哈希函数应该足够廉价，例如使用数据的id和修订号，而不是遍历数据内容
+ * @param typeId 类型id，可通过qMetaTypeId获取
+ * @param fn 哈希函数，返回0代表无法计算
+ */
+void DAAbstractNode::registVariantHashFunction(int typeId, VariantHashFunction fn)
+{
+	DANodeVariantHashRegistry& r = DANodeVariantHashRegistry::instance();
+	QWriteLocker locker(&(r.lock));
+	if (fn) {
+		r.functions[ typeId ] = fn;
+	} else {
+		r.functions.remove(typeId);
+	}
+}
+
+/**
+ * @brief 计算QVariant的哈希
+ *
+ * 优先使用@ref registVariantHashFunction 注册的函数，Qt内置类型通过序列化内容计算哈希，
+ * 其余未注册的自定义类型无法计算哈希
+ * @param v
+ * @return 无法计算时返回0，空的QVariant也返回0
+ */
+uint64_t DAAbstractNode::variantHash(const QVariant& v)
+{
+	if (!v.isValid()) {
+		return 0;
+	}
+	const int typeId = v.userType();
+	{
+		DANodeVariantHashRegistry& r = DANodeVariantHashRegistry::instance();
+		QReadLocker locker(&(r.lock));
+		auto ite = r.functions.constFind(typeId);
+		if (ite != r.functions.constEnd()) {
+			return ite.value()(v);
+		}
+	}
+	uint64_t h = 0;
+	switch (typeId) {
+	case QMetaType::QString: {
+		const QString s = v.toString();
+		h               = bytesNodeHash(reinterpret_cast< const char* >(s.constData()), s.size() * int(sizeof(QChar)));
+	} break;
+	case QMetaType::QByteArray: {
+		const QByteArray b = v.toByteArray();
+		h                  = bytesNodeHash(b.constData(), b.size());
+	} break;
+	default: {
+		if (typeId >= QMetaType::User) {
+			return 0;
+		}
+		QByteArray b;
+		QDataStream st(&b, QIODevice::WriteOnly);
+		st << v;
+		h = bytesNodeHash(b.constData(), b.size());
+	} break;
+	}
+	h = combineNodeHash(h, static_cast< uint64_t >(typeId));
+	return (0 == h) ? 1 : h;
+}
+
+/**
+ * @brief 设置是否保留执行数据用于查看
+ *
+ * 工作流开启提前释放中间数据（@ref DAWorkFlow::setEnableReleaseIntermediateData ）时，
+ * 执行器在节点的输出传递给所有下游节点后释放节点的输出，在节点执行完成后释放节点的输入，
+ * 以降低工作流执行过程中的内存峰值，需要在执行后查看这个节点的中间结果时设置为true
+ * @param on
+ * @sa DAWorkFlow::setEnableReleaseIntermediateData
+ */
+void DAAbstractNode::setKeepDataForInspection(bool on)
+{
+	d_ptr->mKeepDataForInspection = on;
+}
+
+/**
+ * @brief 是否保留执行数据用于查看
+ * @return 默认为false
+ */
+bool DAAbstractNode::isKeepDataForInspection() const
+{
+	return d_ptr->mKeepDataForInspection;
+}
+
+/**
+ * @brief 记录输出缓存对应的指纹
+ * @param fp
+ */
+void DAAbstractNode::setOutputCacheFingerprint(uint64_t fp)
+{
+	d_ptr->mOutputCacheFingerprint = fp;
+}
+
+/**
+ * @brief 释放输出数据，同时输出缓存失效
+ */
+void DAAbstractNode::releaseOutputData()
+{
+	d_ptr->mOutputData.clear();
+	d_ptr->mOutputCacheFingerprint = 0;
+}
+
+/**
+ * @brief 释放某个输出key的数据
+ *
+ * 输出的数据是共享的，下游节点的输入仍然持有数据，最后一个持有者释放后数据才真正释放
+ * @param key
+ */
+void DAAbstractNode::releaseOutputData(const QString& key)
+{
+	d_ptr->mOutputData.remove(key);
+}
+
+/**
+ * @brief 释放某个输入key的数据，输入key保留
+ * @param key
+ */
+void DAAbstractNode::releaseInputData(const QString& key)
+{
+	d_ptr->mInputData.remove(key);
+	d_ptr->mReadInputKeys.remove(key);
+}
+
+/**
+ * @brief 设置输出key为流式输出
+ *
+ * 流式输出的key在节点执行期间通过@ref writeOutputBatch 逐批写入，下游节点在第一个批次到达前就开始执行，
+ * 通过@ref readInputBatch 逐批读取，一般在节点的构造函数中设置
+ *
+ * 开启并行执行且节点线程安全（@ref DANodeMetaData::isThreadSafe ）时，数据流是有界的，上下游节点同时执行；
+ * 否则数据流不限制容量，上游执行完成后下游再读取，结果一致但不会节省内存
+ *
+ * @note 同一个下游节点同时连接了本节点的流式输出和非流式输出（或者经由其它节点依赖本节点）时，
+ * 下游节点无法提前开始执行，执行器会为这个节点使用不限制容量的数据流，避免死锁
+ * @param key
+ * @param on
+ */
+void DAAbstractNode::setOutputStreaming(const QString& key, bool on)
+{
+	if (on) {
+		d_ptr->mStreamingOutputKeys.insert(key);
+	} else {
+		d_ptr->mStreamingOutputKeys.remove(key);
+	}
+}
+
+/**
+ * @brief 输出key是否为流式输出
+ * @param key
+ * @return
+ */
+bool DAAbstractNode::isOutputStreaming(const QString& key) const
+{
+	return d_ptr->mStreamingOutputKeys.contains(key);
+}
+
+/**
+ * @brief 是否存在流式输出
+ * @return
+ */
+bool DAAbstractNode::hasStreamingOutput() const
+{
+	return !d_ptr->mStreamingOutputKeys.isEmpty();
+}
+
+/**
+ * @brief 向流式输出写入一个批次
+ *
+ * 批次会写入这个输出key每条连线对应的数据流，数据流已满时阻塞
+ * @param key 流式输出的key
+ * @param batch 批次数据
+ * @return 没有下游在读取（未连接或者下游已经执行完成）时返回false，此时节点可以停止生产
+ */
+bool DAAbstractNode::writeOutputBatch(const QString& key, const QVariant& batch)
+{
+	const QList< DANodeBatchStream::SharedPointer > streams = d_ptr->mOutputStreams.value(key);
+	bool alive                                              = false;
+	for (const DANodeBatchStream::SharedPointer& s : streams) {
+		if (s->write(batch)) {
+			alive = true;
+		}
+	}
+	return alive;
+}
+
+/**
+ * @brief 从输入读取下一个批次
+ *
+ * 上游为流式输出时逐批读取，数据流为空时阻塞；上游为普通输出时，整个输入数据作为唯一的批次读取，
+ * 因此流式处理的节点也可以连接普通节点
+ * @param key 输入key
+ * @param batch 批次数据
+ * @return 数据读完时返回false
+ */
+bool DAAbstractNode::readInputBatch(const QString& key, QVariant& batch)
+{
+	const QVariant v = d_ptr->mInputData.value(key);
+	if (v.canConvert< DANodeBatchStream::SharedPointer >()) {
+		DANodeBatchStream::SharedPointer s = v.value< DANodeBatchStream::SharedPointer >();
+		return s && s->read(batch);
+	}
+	if (!v.isValid() || d_ptr->mReadInputKeys.contains(key)) {
+		return false;
+	}
+	d_ptr->mReadInputKeys.insert(key);
+	batch = v;
+	return true;
+}
+
+/**
+ * @brief 关闭所有输出流，下游读完剩余批次后结束
+ */
+void DAAbstractNode::closeOutputStreams()
+{
+	for (auto i = d_ptr->mOutputStreams.begin(); i != d_ptr->mOutputStreams.end(); ++i) {
+		for (const DANodeBatchStream::SharedPointer& s : qAsConst(i.value())) {
+			s->close();
+		}
+	}
+	d_ptr->mOutputStreams.clear();
+}
+
+/**
+ * @brief 取消所有输入流，上游不再阻塞在已满的数据流上
+ */
+void DAAbstractNode::cancelInputStreams()
+{
+	for (auto i = d_ptr->mInputData.begin(); i != d_ptr->mInputData.end(); ++i) {
+		if (i.value().canConvert< DANodeBatchStream::SharedPointer >()) {
+			DANodeBatchStream::SharedPointer s = i.value().value< DANodeBatchStream::SharedPointer >();
+			if (s) {
+				s->cancel();
+			}
+		}
+	}
+	d_ptr->mReadInputKeys.clear();
+}
+
+/**
+ * @brief 设置输出key对应的数据流
+ * @param key
+ * @param streams 每条连线对应一个数据流
+ */
+void DAAbstractNode::setOutputStreams(const QString& key, const QList< DANodeBatchStream::SharedPointer >& streams)
+{
+	d_ptr->mOutputStreams[ key ] = streams;
+}
+
 /**
  * @brief 记录工厂
  * @param fc
@@ -1,6 +1,7 @@
 ﻿#ifndef DAABSTRACTNODE_H
 #define DAABSTRACTNODE_H
 #include <memory>
+#include <functional>
 #include <QMetaEnum>
 #include <QVersionNumber>
 #include "DAWorkFlowGlobal.h"
@@ -15,6 +16,8 @@ class DAAbstractNodeGraphicsItem;
 class DAWorkFlow;
 class DAAbstractNodeFactory;
 class DAAbstractNodeLinkGraphicsItem;
+class DAWorkFlowExecuter;
+class DANodeBatchStream;
 /**
  * @brief 节点对应的基类
  *
@@ -53,11 +56,16 @@ class DAWORKFLOW_API DAAbstractNode : public std::enable_shared_from_this< DAAbs
 	friend class DAAbstractNodeGraphicsItem;
 	friend class DAAbstractNodeFactory;
 	friend class DAWorkFlow;
+	friend class DAWorkFlowExecuter;
 
 public:
 	using SharedPointer = std::shared_ptr< DAAbstractNode >;
 	using WeakPointer   = std::weak_ptr< DAAbstractNode >;
 	using IdType        = uint64_t;
+	/**
+	 * @brief QVariant的哈希函数，用于计算节点指纹，返回0代表此数据无法计算哈希
+	 */
+	using VariantHashFunction = std::function< uint64_t(const QVariant&) >;
 
 public:
 	/**
@@ -129,6 +137,9 @@ public:
 	virtual void loadExternInfoFromXml(const QDomElement* nodeElement, const QVersionNumber& ver);
 	// 节点类型默认都为NormalNode
 	virtual NodeType nodeType() const;
+	// 是否保留执行数据用于查看，保留时执行器不会提前释放节点的输入和输出
+	void setKeepDataForInspection(bool on);
+	bool isKeepDataForInspection() const;
 
 public:  // 连接相关
 	// 获取所有输入的参数名
@@ -204,6 +215,33 @@ public:  // 连接相关
 		return std::dynamic_pointer_cast< T >(pointer());
 	}
 
+public:  // 增量执行相关
+	// 计算节点指纹，由节点原型、属性和输入数据决定，返回0说明无法计算指纹
+	virtual uint64_t calcFingerprint() const;
+	// 输出缓存对应的指纹，0代表没有有效的输出缓存
+	uint64_t getOutputCacheFingerprint() const;
+	// 使输出缓存失效，节点在属性和输入之外的状态改变时需要调用此函数
+	void invalidateOutputCache();
+	// 注册自定义类型的哈希函数
+	static void registVariantHashFunction(int typeId, VariantHashFunction fn);
+	// 计算QVariant的哈希
+	static uint64_t variantHash(const QVariant& v);
+
+public:  // 流式数据相关
+	// 设置输出key为流式输出，流式输出的数据通过writeOutputBatch逐批写入
+	void setOutputStreaming(const QString& key, bool on = true);
+	bool isOutputStreaming(const QString& key) const;
+	// 是否存在流式输出
+	bool hasStreamingOutput() const;
+	// 向流式输出写入一个批次，下游处理慢时阻塞，所有下游都不再读取时返回false
+	bool writeOutputBatch(const QString& key, const QVariant& batch);
+	// 从输入读取下一个批次，数据读完时返回false
+	bool readInputBatch(const QString& key, QVariant& batch);
+	// 关闭所有输出流，由执行器在节点执行完成后调用
+	void closeOutputStreams();
+	// 取消所有输入流，由执行器在节点执行完成后调用
+	void cancelInputStreams();
+
 public:
 	// 执行
 	virtual bool exec() = 0;
@@ -222,6 +260,16 @@ protected:
 	void unregistItem();
 	// linkTo的实现
 	bool linkTo_(const QString& outKey, SharedPointer inNode, const QString& inKey);
+	// 记录输出缓存对应的指纹，由执行器在节点执行成功后调用
+	void setOutputCacheFingerprint(uint64_t fp);
+	// 释放输出数据，输出缓存被淘汰时调用
+	void releaseOutputData();
+	// 释放某个输出key的数据，数据已经传递给所有下游节点后调用
+	void releaseOutputData(const QString& key);
+	// 释放某个输入key的数据，节点执行完成后调用
+	void releaseInputData(const QString& key);
+	// 设置输出key对应的数据流，由执行器在节点执行前调用
+	void setOutputStreams(const QString& key, const QList< std::shared_ptr< DANodeBatchStream > >& streams);
 
 protected:
 	// 注册工作流
@@ -761,7 +761,8 @@ QVariant DAAbstractNodeLinkGraphicsItem::itemChange(QGraphicsItem::GraphicsItemC
 	default:
 		break;
 	}
-	return (QGraphicsItem::itemChange(change, value));
+	// 要调用基类的itemChange，场景的id索引由DAGraphicsItem::itemChange维护
+	return (DAGraphicsLinkItem::itemChange(change, value));
 }
 
 void DAAbstractNodeLinkGraphicsItem::callItemIsDestroying(DAAbstractNodeGraphicsItem* item, const DA::DANodeLinkPoint& pl)
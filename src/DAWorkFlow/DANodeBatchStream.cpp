@@ -0,0 +1,125 @@
+﻿#include "DANodeBatchStream.h"
+
+namespace DA
+{
+/**
+ * @brief 生产者等待队列空闲、消费者等待数据的间隔，每个间隔检查一次取消标记
+ */
+static const int c_batchstream_wait_ms = 50;
+
+//===================================================
+// DANodeBatchStream
+//===================================================
+DANodeBatchStream::DANodeBatchStream(std::size_t capacity) : mQueue(capacity), mCapacity(capacity)
+{
+}
+
+DANodeBatchStream::~DANodeBatchStream()
+{
+}
+
+/**
+ * @brief 写入一个批次
+ *
+ * 队列已满时阻塞，直到消费者读取或者取消
+ * @param batch 无效的QVariant用作结束标记，不会写入
+ * @return 数据流已取消或已关闭时返回false，此时生产者应停止生产
+ */
+bool DANodeBatchStream::write(const QVariant& batch)
+{
+    if (!batch.isValid() || mClosed) {
+        return false;
+    }
+    while (!mCanceled) {
+        if (mQueue.push(batch, c_batchstream_wait_ms)) {
+            ++mWrittenCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief 生产者结束写入
+ *
+ * 推入一个无效的QVariant作为结束标记，消费者读到结束标记后@ref read 返回false
+ */
+void DANodeBatchStream::close()
+{
+    if (mClosed.exchange(true)) {
+        return;
+    }
+    while (!mCanceled) {
+        if (mQueue.push(QVariant(), c_batchstream_wait_ms)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 读取下一个批次
+ *
+ * 没有数据时阻塞，直到生产者写入、关闭或者数据流被取消
+ * @param batch
+ * @return 数据流结束或已取消返回false
+ */
+bool DANodeBatchStream::read(QVariant& batch)
+{
+    if (mReadEnd) {
+        return false;
+    }
+    QVariant v;
+    while (!mCanceled) {
+        if (!mQueue.get(v, c_batchstream_wait_ms)) {
+            continue;
+        }
+        if (!v.isValid()) {
+            mReadEnd = true;
+            return false;
+        }
+        batch = v;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief 取消数据流，生产者的写入和消费者的读取都将返回false
+ *
+ * 消费者执行完成后由执行器调用，也用于终止工作流时唤醒阻塞在数据流上的上下游节点
+ */
+void DANodeBatchStream::cancel()
+{
+    mCanceled = true;
+}
+
+bool DANodeBatchStream::isClosed() const
+{
+    return mClosed;
+}
+
+bool DANodeBatchStream::isCanceled() const
+{
+    return mCanceled;
+}
+
+/**
+ * @brief 容量
+ * @return 0代表不限制容量
+ */
+std::size_t DANodeBatchStream::capacity() const
+{
+    return mCapacity;
+}
+
+/**
+ * @brief 已写入的批次数量
+ * @return
+ */
+qint64 DANodeBatchStream::getWrittenCount() const
+{
+    return mWrittenCount;
+}
+
+DA_AUTO_REGISTER_META_TYPE(DANodeBatchStream::SharedPointer)
+}  // end of namespace DA
@@ -0,0 +1,62 @@
+﻿#ifndef DANODEBATCHSTREAM_H
+#define DANODEBATCHSTREAM_H
+#include <memory>
+#include <atomic>
+#include <QVariant>
+#include "DAWorkFlowGlobal.h"
+#include "da_concurrent_queue.hpp"
+
+namespace DA
+{
+/**
+ * @brief 节点之间的批次数据流
+ *
+ * 节点默认通过@ref DAAbstractNode::setOutputData 一次性输出完整的数据，下游节点只有在上游节点执行完成后才会执行，
+ * 处理超出内存的数据时，每个中间结果都要完整的保存在内存中。
+ *
+ * 输出key设置为流式输出（@ref DAAbstractNode::setOutputStreaming ）后，执行器会为这个输出key的每条连线创建一个数据流，
+ * 上游节点在执行过程中通过@ref DAAbstractNode::writeOutputBatch 逐批写入数据（例如dataframe的一个分块），
+ * 下游节点通过@ref DAAbstractNode::readInputBatch 逐批读取，上下游节点同时执行：
+ *
+ * - 数据流是有界的，队列已满时生产者阻塞，下游处理慢时上游不会无限占用内存（背压）
+ * - 生产者执行完成后执行器关闭数据流，消费者读完剩余批次后@ref read 返回false
+ * - 消费者执行完成后执行器取消数据流，生产者的@ref write 返回false，生产者应停止生产
+ *
+ * 一个数据流只对应一个生产者和一个消费者
+ */
+class DAWORKFLOW_API DANodeBatchStream
+{
+public:
+    using SharedPointer = std::shared_ptr< DANodeBatchStream >;
+
+public:
+    // 容量为0代表不限制容量
+    DANodeBatchStream(std::size_t capacity = 0);
+    ~DANodeBatchStream();
+    // 写入一个批次，队列已满时阻塞，数据流已取消时返回false
+    bool write(const QVariant& batch);
+    // 生产者结束写入
+    void close();
+    // 读取下一个批次，数据流结束时返回false
+    bool read(QVariant& batch);
+    // 消费者不再读取
+    void cancel();
+    // 状态
+    bool isClosed() const;
+    bool isCanceled() const;
+    // 容量
+    std::size_t capacity() const;
+    // 已写入的批次数量
+    qint64 getWrittenCount() const;
+
+private:
+    da_concurrent_queue< QVariant > mQueue;
+    std::size_t mCapacity { 0 };
+    std::atomic< bool > mClosed { false };
+    std::atomic< bool > mCanceled { false };
+    std::atomic< qint64 > mWrittenCount { 0 };
+    bool mReadEnd { false };  ///< 消费者已经读到结束标记
+};
+}  // end of namespace DA
+Q_DECLARE_METATYPE(DA::DANodeBatchStream::SharedPointer)
+#endif  // DANODEBATCHSTREAM_H
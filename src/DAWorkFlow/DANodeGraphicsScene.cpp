@@ -3,6 +3,7 @@
 #include <QScopedPointer>
 #include <QPointer>
 #include <QPainter>
+#include <QFontMetricsF>
 #include "DAGraphicsPixmapItem.h"
 #include "DAStandardNodeLinkGraphicsItem.h"
 #include "DAGraphicsTextItem.h"
@@ -27,6 +28,9 @@ public:
 
 public:
 	QPointer< DAWorkFlow > mWorkflow;
+	DAWorkFlowProfiler::SharedPointer mProfiler;  ///< 热力图对应的性能记录
+	QHash< uint64_t, qint64 > mProfileWallTimes;  ///< 每个节点的耗时，key为节点id
+	qint64 mProfileMaxUs { 0 };                   ///< 最大的节点耗时
 };
 
 DANodeGraphicsScene::PrivateData::PrivateData(DANodeGraphicsScene* p) : q_ptr(p)
@@ -256,7 +260,7 @@ int DANodeGraphicsScene::removeSelectedItems_()
 	}
 	QList< QGraphicsItem* > gl = rawcmd->getAllRemovedItems();
 	if (gl.size() > 0) {
-		emit itemsRemoved(gl);
+		emitItemsRemoved(gl);
 	}
 	return rc;
 }
@@ -264,19 +268,19 @@ int DANodeGraphicsScene::removeSelectedItems_()
 void DANodeGraphicsScene::removeNodeItem_(DAAbstractNodeGraphicsItem* i)
 {
 	push(new DACommandsForWorkFlowRemoveNodeItem(this, i));
-	emit itemsRemoved({ i });
+	emitItemsRemoved({ i });
 }
 
 void DANodeGraphicsScene::addNodeItem_(DAAbstractNodeGraphicsItem* i)
 {
 	push(new DACommandsForWorkFlowAddNodeItem(this, i));
-	emit itemsAdded({ i });
+	emitItemsAdded({ i });
 }
 
 void DANodeGraphicsScene::addNodeLink_(DAAbstractNodeLinkGraphicsItem* link)
 {
 	push(new DACommandsForWorkFlowCreateLink(link, this));
-	emit itemsAdded({ link });
+	emitItemsAdded({ link });
 }
 
 /**
@@ -323,7 +327,7 @@ DAAbstractNodeGraphicsItem* DANodeGraphicsScene::createNode_(const DANodeMetaDat
 		return nullptr;
 	}
 	push(cmd.release());
-	emit itemsAdded({ item });
+	emitItemsAdded({ item });
 	return item;
 }
 
@@ -369,6 +373,86 @@ DAAbstractNodeGraphicsItem* DANodeGraphicsScene::nodeItemAt(const QPointF& scene
 	return nullptr;
 }
 
+/**
+ * @brief 设置性能热力图
+ *
+ * 按节点耗时占最大耗时的比例，在节点上叠加从绿色到红色的半透明颜色，并在节点上方标注耗时和占总时间的百分比，
+ * 复用输出的节点标注为cached，没有执行的节点不显示
+ * @param profiler 通常为@ref DAWorkFlow::getLastExecuteProfiler ，为nullptr时清除热力图
+ */
+void DANodeGraphicsScene::setProfileOverlay(const DAWorkFlowProfiler::SharedPointer& profiler)
+{
+	d_ptr->mProfiler = profiler;
+	d_ptr->mProfileWallTimes.clear();
+	d_ptr->mProfileMaxUs = 0;
+	if (profiler) {
+		d_ptr->mProfileWallTimes = profiler->getNodeWallTimes();
+		for (qint64 us : qAsConst(d_ptr->mProfileWallTimes)) {
+			d_ptr->mProfileMaxUs = qMax(d_ptr->mProfileMaxUs, us);
+		}
+	}
+	update();
+}
+
+/**
+ * @brief 热力图对应的性能记录
+ * @return 没有显示热力图返回nullptr
+ */
+DAWorkFlowProfiler::SharedPointer DANodeGraphicsScene::getProfileOverlay() const
+{
+	return d_ptr->mProfiler;
+}
+
+/**
+ * @brief 绘制性能热力图
+ * @param painter
+ * @param rect
+ */
+void DANodeGraphicsScene::drawForeground(QPainter* painter, const QRectF& rect)
+{
+	DAGraphicsScene::drawForeground(painter, rect);
+	if (!d_ptr->mProfiler) {
+		return;
+	}
+	const double total = qMax< qint64 >(1, d_ptr->mProfiler->getTotalWallUs());
+	const double maxUs = qMax< qint64 >(1, d_ptr->mProfileMaxUs);
+	painter->save();
+	QFont font = painter->font();
+	font.setPointSizeF(font.pointSizeF() * 0.85);
+	painter->setFont(font);
+	const QFontMetricsF fm(font);
+	const QList< DAAbstractNodeGraphicsItem* > items = getNodeGraphicsItems();
+	for (DAAbstractNodeGraphicsItem* item : items) {
+		const DAAbstractNode* n = item->rawNode();
+		if (!n || !item->isVisible()) {
+			continue;
+		}
+		auto ite = d_ptr->mProfileWallTimes.constFind(n->getID());
+		if (ite == d_ptr->mProfileWallTimes.constEnd()) {
+			continue;
+		}
+		const QRectF br   = item->sceneBoundingRect();
+		const QRectF textRect(br.left(), br.top() - fm.height() - 2, qMax(br.width(), 120.0), fm.height());
+		if (!rect.intersects(br) && !rect.intersects(textRect)) {
+			continue;
+		}
+		const qint64 us    = ite.value();
+		const double ratio = us / maxUs;
+		// 耗时越多越接近红色
+		QColor c = QColor::fromHsvF((1.0 - ratio) / 3.0, 0.85, 0.95);
+		c.setAlphaF(0.25 + 0.35 * ratio);
+		painter->setPen(Qt::NoPen);
+		painter->setBrush(c);
+		painter->drawRect(br);
+		const QString text = (0 == us) ? QStringLiteral("cached")
+		                               : QStringLiteral("%1 ms (%2%)").arg(us / 1000.0, 0, 'f', 1).arg(100.0 * us / total, 0, 'f', 1);
+		c.setAlphaF(1.0);
+		painter->setPen(c.darker(160));
+		painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter, text);
+	}
+	painter->restore();
+}
+
 void DANodeGraphicsScene::initConnect()
 {
 	// qRegisterMetaType< DANodeLinkPoint >("DANodeLinkPoint");
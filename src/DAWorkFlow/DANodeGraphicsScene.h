@@ -8,6 +8,7 @@
 #include "DAAbstractNodeGraphicsItem.h"
 #include "DAAbstractNodeLinkGraphicsItem.h"
 #include "DAWorkFlow.h"
+#include "DAWorkFlowProfiler.h"
 
 class QGraphicsSceneMouseEvent;
 namespace DA
@@ -82,6 +83,10 @@ public:
 	DAGraphicsPixmapItem* addPixmapItem_(const QImage& img);
 	// 通过位置获取DAAbstractNodeGraphicsItem，此函数是加强版的itemAt
 	DAAbstractNodeGraphicsItem* nodeItemAt(const QPointF& scenePos) const;
+
+	// 设置性能热力图，在节点上叠加显示执行耗时，传入nullptr清除
+	void setProfileOverlay(const DAWorkFlowProfiler::SharedPointer& profiler);
+	DAWorkFlowProfiler::SharedPointer getProfileOverlay() const;
 signals:
 
 	/**
@@ -140,6 +145,8 @@ protected slots:
 protected:
 	// 鼠标点击事件
 	void mousePressEvent(QGraphicsSceneMouseEvent* mouseEvent) override;
+	// 绘制性能热力图
+	void drawForeground(QPainter* painter, const QRectF& rect) override;
 
 	// itemlink都没用节点连接时会调用这个函数，发出
 	void callNodeItemLinkIsEmpty(DAAbstractNodeLinkGraphicsItem* link);
@@ -102,6 +102,78 @@ void DANodeMetaData::setNodeTooltip(const QString& tp)
     mNodeToolTip = tp;
 }
 
+/**
+ * @brief 节点是否线程安全
+ *
+ * 线程安全的节点在并行执行模式下会放到线程池中执行，非线程安全的节点始终在执行器线程中串行执行
+ *
+ * 节点的exec只读写自身的输入输出和属性，不访问界面、不依赖调用线程（例如持有python的gil执行脚本）时才能标记为线程安全，
+ * 标准节点中只有纯C++实现的@ref DAStandardNodeConstValue 标记为线程安全，
+ * @ref DAStandardNodeInputOutput 是插件节点的基类，由插件节点根据自身的实现设置
+ * @return 默认为false
+ * @sa DAWorkFlowExecuter::setEnableParallelExecute
+ */
+bool DANodeMetaData::isThreadSafe() const
+{
+    return mThreadSafe;
+}
+
+/**
+ * @brief 设置节点是否线程安全
+ * @param on
+ */
+void DANodeMetaData::setThreadSafe(bool on)
+{
+    mThreadSafe = on;
+}
+
+/**
+ * @brief 节点是否可缓存
+ *
+ * 可缓存的节点其输出只由节点属性和输入数据决定，没有副作用，在增量执行模式下，
+ * 节点指纹（@ref DAAbstractNode::calcFingerprint ）和上次执行时一致，节点不会再执行，直接复用上次的输出
+ *
+ * 标准节点中@ref DAStandardNodeConstValue 标记为可缓存
+ * @return 默认为false
+ * @sa DAWorkFlow::setEnableIncrementalExecute
+ */
+bool DANodeMetaData::isCacheable() const
+{
+    return mCacheable;
+}
+
+/**
+ * @brief 设置节点是否可缓存
+ * @param on
+ */
+void DANodeMetaData::setCacheable(bool on)
+{
+    mCacheable = on;
+}
+
+/**
+ * @brief 节点是否使用python
+ *
+ * 执行器线程和线程池中的线程都不持有GIL，使用python的节点在exec中调用python前需要获取GIL（pybind11::gil_scoped_acquire），
+ * 或者通过DAPyWorkerPool在python工作进程中执行；主线程只在事件循环空闲时释放GIL，
+ * 因此这类节点必须在主线程之外执行，不能在主线程中等待它们执行完成；
+ * 参数扫描（DAWorkFlowSweep）中使用python的节点不会在线程池中同时执行，变体依次执行
+ * @return 默认为false
+ */
+bool DANodeMetaData::isUsePython() const
+{
+    return mUsePython;
+}
+
+/**
+ * @brief 设置节点是否使用python
+ * @param on
+ */
+void DANodeMetaData::setUsePython(bool on)
+{
+    mUsePython = on;
+}
+
 /**
  * @brief 是否正常
  * @return
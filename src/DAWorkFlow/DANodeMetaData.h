@@ -38,6 +38,18 @@ public:
 	QString getNodeTooltip() const;
 	void setNodeTooltip(const QString& tp);
 
+	// 节点是否线程安全，线程安全的节点在并行执行模式下可以放到线程池中执行
+	bool isThreadSafe() const;
+	void setThreadSafe(bool on);
+
+	// 节点是否可缓存，可缓存的节点在指纹不变时会跳过执行，复用上次的输出
+	bool isCacheable() const;
+	void setCacheable(bool on);
+
+	// 节点是否使用python，使用python的节点在exec中自行获取GIL或者通过进程池执行
+	bool isUsePython() const;
+	void setUsePython(bool on);
+
 	// 判断是否正常
 	bool isValid() const;
 	// 重载bool操作符
@@ -56,6 +68,9 @@ private:
 	QString mNodeToolTip;
 	QIcon mNodeIcon;
 	QString mGroup;
+	bool mThreadSafe { false };
+	bool mCacheable { false };
+	bool mUsePython { false };
 };
 // qHash
 #if QT_VERSION_MAJOR >= 6
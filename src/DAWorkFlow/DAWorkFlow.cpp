@@ -3,6 +3,7 @@
 #include <QMap>
 #include <QDebug>
 #include <QThread>
+#include <QMutex>
 #include "DAWorkFlowExecuter.h"
 #include "DAAbstractNodeFactory.h"
 #include "DAQtContainerUtil.hpp"
@@ -29,6 +30,7 @@ public:
 	QList< DAAbstractNode::SharedPointer > mNodes;
 	QMap< DAAbstractNode::IdType, DAAbstractNode::SharedPointer > mIdToNode;  ///< 文本信息列表
 	DAAbstractNode::WeakPointer mStartNode;                                   ///< 开始执行的节点
+	DAAbstractNode::WeakPointer mTargetNode;                                  ///< 按需执行的目标节点，只在execTo过程中有效
 	QThread* mExecuterThread { nullptr };                                     ///< 执行器线程
 	DA::DAWorkFlowExecuter* mExecuter { nullptr };                            ///< 执行器
 	bool mIsExecuting { false };                                              ///< 正在执行
@@ -37,6 +39,22 @@ public:
 	QList< DAWorkFlow::CallbackPrepareEndExecute > mPrepareEndCallback;
 	DANodeGraphicsScene* mScene { nullptr };  ///< 记录工作流对应的scene，让工作流能获取scene指针
 	bool mEnableFactoryCb { true };           ///< 是否允许工厂回调
+	bool mEnableParallelExecute { false };    ///< 是否并行执行
+	bool mEnableIncrementalExecute { true };  ///< 是否增量执行
+	int mOutputCacheCapacity { 64 };          ///< 输出缓存的容量
+	int mStreamCapacity { 4 };                ///< 流式连线的数据流容量
+	bool mEnableReleaseIntermediate { false }; ///< 是否提前释放中间数据
+	DAWorkFlowExecuter::MemoryReport mLastMemoryReport;  ///< 最近一次执行的内存报告
+	bool mEnableProfile { false };                       ///< 是否记录节点的性能
+	DAWorkFlowProfiler::SharedPointer mLastProfiler;     ///< 最近一次执行的性能记录
+	/**
+	 * @brief 有输出缓存的节点，按最近使用排序，最后一个为最近使用的节点
+	 *
+	 * 此列表会在执行器线程中修改，因此需要mOutputCacheMutex保护
+	 */
+	QList< DAAbstractNode::SharedPointer > mOutputCacheLru;
+	QMutex mOutputCacheMutex;
+	DAWorkFlowExecutePlan::SharedPointer mExecutePlan;  ///< 执行计划，图结构改变后置空，下次执行时重新编译
 };
 
 //===================================================
@@ -59,7 +77,14 @@ void DAWorkFlow::PrivateData::createExecuter()
 	mExecuter       = new DA::DAWorkFlowExecuter();
 	// 设置开始节点
 	mExecuter->setStartNode(mStartNode.lock());
+	mExecuter->setTargetNode(mTargetNode.lock());
 	mExecuter->setWorkFlow(q_ptr);
+	mExecuter->setExecutePlan(mExecutePlan);
+	mExecuter->setEnableParallelExecute(mEnableParallelExecute);
+	mExecuter->setEnableIncrementalExecute(mEnableIncrementalExecute);
+	mExecuter->setStreamCapacity(mStreamCapacity);
+	mExecuter->setEnableReleaseIntermediateData(mEnableReleaseIntermediate);
+	mExecuter->setEnableProfile(mEnableProfile);
 	mExecuter->moveToThread(mExecuterThread);
 	QObject::connect(mExecuterThread, &QThread::finished, mExecuter, &QObject::deleteLater);
 	QObject::connect(mExecuterThread, &QThread::finished, mExecuterThread, &QObject::deleteLater);
@@ -77,6 +102,7 @@ void DAWorkFlow::PrivateData::recordNode(DAAbstractNode::SharedPointer& node)
 {
 	mNodes.append(node);
 	mIdToNode[ node->getID() ] = node;
+	mExecutePlan.reset();
 }
 
 //==============================================================
@@ -279,6 +305,11 @@ void DAWorkFlow::clear()
 	}
 	d_ptr->mNodes.clear();
 	d_ptr->mIdToNode.clear();
+	d_ptr->mExecutePlan.reset();
+	{
+		QMutexLocker locker(&(d_ptr->mOutputCacheMutex));
+		d_ptr->mOutputCacheLru.clear();
+	}
 	emit workflowCleared();
 }
 
@@ -305,6 +336,8 @@ void DAWorkFlow::removeNode(const DAAbstractNode::SharedPointer& n)
 	n->detachAll();
 	d_ptr->mNodes.removeAll(n);
 	d_ptr->mIdToNode.remove(n->getID());
+	d_ptr->mExecutePlan.reset();
+	removeOutputCache(n);
 	emit nodeRemoved(n);
 }
 
@@ -412,6 +445,12 @@ void DAWorkFlow::exec()
 	}
 
 	if (nullptr == d_ptr->mExecuter) {
+		// 执行计划在工作流线程中编译，执行器只读使用
+		if (!getExecutePlan()) {
+			qCritical() << d_ptr->mLastErr;
+			emit finished(false);
+			return;
+		}
 		d_ptr->createExecuter();
 	}
 	d_ptr->mIsExecuting = true;
@@ -419,6 +458,21 @@ void DAWorkFlow::exec()
 	emit startExecute();
 }
 
+/**
+ * @brief 按需运行
+ *
+ * 只运行计算目标节点所需的最小上游节点集合，和目标节点无关的分支不会执行，
+ * 结合增量执行（@ref setEnableIncrementalExecute ），调整某个节点参数后只需重新计算这个节点到目标节点的路径
+ * @param target 目标节点，为nullptr时等同于@ref exec
+ * @sa DAWorkFlowExecuter::setTargetNode
+ */
+void DAWorkFlow::execTo(DAAbstractNode::SharedPointer target)
+{
+	d_ptr->mTargetNode = target;
+	exec();
+	d_ptr->mTargetNode.reset();
+}
+
 /**
  * @brief 终止
  */
@@ -548,6 +602,200 @@ bool DAWorkFlow::isEnableFactoryCallBack() const
     return d_ptr->mEnableFactoryCb;
 }
 
+/**
+ * @brief 设置是否并行执行工作流
+ *
+ * 设置在下次@ref exec 时生效
+ * @param on
+ * @sa DAWorkFlowExecuter::setEnableParallelExecute
+ */
+void DAWorkFlow::setEnableParallelExecute(bool on)
+{
+    d_ptr->mEnableParallelExecute = on;
+}
+
+/**
+ * @brief 是否并行执行工作流
+ * @return
+ */
+bool DAWorkFlow::isEnableParallelExecute() const
+{
+    return d_ptr->mEnableParallelExecute;
+}
+
+/**
+ * @brief 设置是否增量执行
+ *
+ * 增量执行时，可缓存的节点（@ref DANodeMetaData::isCacheable ）如果指纹（@ref DAAbstractNode::calcFingerprint ）
+ * 和上次执行成功时一致，执行器不会再执行此节点，而是直接把上次的输出传递给下游，
+ * 这样修改某个节点的属性后再执行，只有这个节点及其下游受影响的节点会重新执行
+ *
+ * 设置在下次@ref exec 时生效
+ * @param on 默认为true
+ * @sa DAWorkFlowExecuter::setEnableIncrementalExecute
+ */
+void DAWorkFlow::setEnableIncrementalExecute(bool on)
+{
+    d_ptr->mEnableIncrementalExecute = on;
+}
+
+/**
+ * @brief 是否增量执行
+ * @return
+ */
+bool DAWorkFlow::isEnableIncrementalExecute() const
+{
+    return d_ptr->mEnableIncrementalExecute;
+}
+
+/**
+ * @brief 设置是否提前释放中间数据
+ *
+ * 设置在下次@ref exec 时生效。默认不释放，界面中执行后还可以查看每个节点的输入输出，
+ * 无界面的批处理（DAWorkbenchRunner）会开启。开启后仍需要查看某个节点的中间结果时，可以只对这个节点设置
+ * @ref DAAbstractNode::setKeepDataForInspection
+ * @param on 默认为false
+ * @sa DAWorkFlowExecuter::setEnableReleaseIntermediateData
+ */
+void DAWorkFlow::setEnableReleaseIntermediateData(bool on)
+{
+    d_ptr->mEnableReleaseIntermediate = on;
+}
+
+/**
+ * @brief 是否提前释放中间数据
+ * @return
+ */
+bool DAWorkFlow::isEnableReleaseIntermediateData() const
+{
+    return d_ptr->mEnableReleaseIntermediate;
+}
+
+/**
+ * @brief 最近一次执行的内存报告
+ *
+ * 在@ref finished 信号发射前更新
+ * @return
+ */
+DAWorkFlowExecuter::MemoryReport DAWorkFlow::getLastExecuteMemoryReport() const
+{
+    return d_ptr->mLastMemoryReport;
+}
+
+/**
+ * @brief 设置是否记录节点的性能
+ *
+ * 设置在下次@ref exec 时生效
+ * @param on 默认为false
+ * @sa DAWorkFlowExecuter::setEnableProfile
+ */
+void DAWorkFlow::setEnableProfile(bool on)
+{
+    d_ptr->mEnableProfile = on;
+}
+
+/**
+ * @brief 是否记录节点的性能
+ * @return
+ */
+bool DAWorkFlow::isEnableProfile() const
+{
+    return d_ptr->mEnableProfile;
+}
+
+/**
+ * @brief 最近一次执行的性能记录
+ *
+ * 在@ref finished 信号发射前更新，可以导出chrome trace或者设置到场景显示热力图
+ * @return 没有开启性能记录时返回nullptr
+ * @sa DAWorkFlowProfiler::saveChromeTrace DANodeGraphicsScene::setProfileOverlay
+ */
+DAWorkFlowProfiler::SharedPointer DAWorkFlow::getLastExecuteProfiler() const
+{
+    return d_ptr->mLastProfiler;
+}
+
+/**
+ * @brief 设置流式连线的数据流容量
+ *
+ * 设置在下次@ref exec 时生效
+ * @param c 小于1时为1
+ * @sa DAWorkFlowExecuter::setStreamCapacity
+ */
+void DAWorkFlow::setStreamCapacity(int c)
+{
+    d_ptr->mStreamCapacity = qMax(1, c);
+}
+
+/**
+ * @brief 流式连线的数据流容量
+ * @return 默认为4
+ */
+int DAWorkFlow::getStreamCapacity() const
+{
+    return d_ptr->mStreamCapacity;
+}
+
+/**
+ * @brief 获取执行计划
+ *
+ * 执行计划缓存在工作流中，图结构（节点、连线）不变时多次执行共享同一个执行计划，
+ * 避免每次执行都重新分析图结构
+ * @return 图结构存在环时编译失败，返回nullptr，错误信息通过@ref getLastErrorString 获取
+ * @sa DAWorkFlowExecutePlan
+ */
+DAWorkFlowExecutePlan::SharedPointer DAWorkFlow::getExecutePlan()
+{
+	if (!d_ptr->mExecutePlan) {
+		d_ptr->mExecutePlan = DAWorkFlowExecutePlan::compile(d_ptr->mNodes, &(d_ptr->mLastErr));
+	}
+	return d_ptr->mExecutePlan;
+}
+
+/**
+ * @brief 设置输出缓存的容量
+ *
+ * 容量为缓存输出的节点数量，超出容量后最久未使用的节点会释放输出数据，下次执行时这个节点需要重新执行
+ * @param c 小于0按0处理，为0时不缓存任何节点的输出
+ */
+void DAWorkFlow::setOutputCacheCapacity(int c)
+{
+	QList< DAAbstractNode::SharedPointer > evicts;
+	{
+		QMutexLocker locker(&(d_ptr->mOutputCacheMutex));
+		d_ptr->mOutputCacheCapacity = qMax(0, c);
+		while (d_ptr->mOutputCacheLru.size() > d_ptr->mOutputCacheCapacity) {
+			evicts.append(d_ptr->mOutputCacheLru.takeFirst());
+		}
+	}
+	for (const DAAbstractNode::SharedPointer& n : qAsConst(evicts)) {
+		n->releaseOutputData();
+	}
+}
+
+/**
+ * @brief 输出缓存的容量
+ * @return 默认为64
+ */
+int DAWorkFlow::getOutputCacheCapacity() const
+{
+    return d_ptr->mOutputCacheCapacity;
+}
+
+/**
+ * @brief 清空所有节点的输出缓存
+ *
+ * 节点的输出数据会保留，只是缓存失效，下次执行所有节点都会重新执行
+ */
+void DAWorkFlow::clearOutputCache()
+{
+	QMutexLocker locker(&(d_ptr->mOutputCacheMutex));
+	for (const DAAbstractNode::SharedPointer& n : qAsConst(d_ptr->mOutputCacheLru)) {
+		n->invalidateOutputCache();
+	}
+	d_ptr->mOutputCacheLru.clear();
+}
+
 void DAWorkFlow::emitNodeNameChanged(DAAbstractNode::SharedPointer node, const QString& oldName, const QString& newName)
 {
     emit nodeNameChanged(node, oldName, newName);
@@ -567,6 +815,11 @@ void DAWorkFlow::nodeIDChanged(const DAAbstractNode::SharedPointer& node, const
 void DAWorkFlow::onExecuteFinished(bool success)
 {
 	d_ptr->mIsExecuting = false;
+	if (d_ptr->mExecuter) {
+		// 执行器在线程结束后才删除，此时还可以获取
+		d_ptr->mLastMemoryReport = d_ptr->mExecuter->getMemoryReport();
+		d_ptr->mLastProfiler     = d_ptr->mExecuter->getProfiler();
+	}
 	// 无需quit，已经结束了
 	//  d_ptr->_executerThread->quit();
 	d_ptr->mExecuterThread = nullptr;
@@ -584,4 +837,46 @@ void DAWorkFlow::recordScene(DANodeGraphicsScene* sc)
 {
     d_ptr->mScene = sc;
 }
+
+/**
+ * @brief 记录节点的输出缓存
+ *
+ * 节点移动到最近使用的位置，超出容量时释放最久未使用的节点的输出数据
+ * @param n
+ */
+void DAWorkFlow::recordOutputCache(const DAAbstractNode::SharedPointer& n)
+{
+	QList< DAAbstractNode::SharedPointer > evicts;
+	{
+		QMutexLocker locker(&(d_ptr->mOutputCacheMutex));
+		d_ptr->mOutputCacheLru.removeOne(n);
+		d_ptr->mOutputCacheLru.append(n);
+		while (d_ptr->mOutputCacheLru.size() > d_ptr->mOutputCacheCapacity) {
+			evicts.append(d_ptr->mOutputCacheLru.takeFirst());
+		}
+	}
+	for (const DAAbstractNode::SharedPointer& e : qAsConst(evicts)) {
+		e->releaseOutputData();
+	}
+}
+
+/**
+ * @brief 移除节点的输出缓存记录，节点的输出数据不会释放
+ * @param n
+ */
+void DAWorkFlow::removeOutputCache(const DAAbstractNode::SharedPointer& n)
+{
+	QMutexLocker locker(&(d_ptr->mOutputCacheMutex));
+	d_ptr->mOutputCacheLru.removeOne(n);
+}
+
+/**
+ * @brief 图结构改变，执行计划失效
+ *
+ * 节点的连线建立或解除时由节点调用，正在执行的执行器持有原来的执行计划，不受影响
+ */
+void DAWorkFlow::invalidateExecutePlan()
+{
+	d_ptr->mExecutePlan.reset();
+}
 }  // end of namespace DA
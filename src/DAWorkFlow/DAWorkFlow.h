@@ -6,6 +6,8 @@
 #include <QVersionNumber>
 #include "DAWorkFlowGlobal.h"
 #include "DAAbstractNode.h"
+#include "DAWorkFlowExecutePlan.h"
+#include "DAWorkFlowExecuter.h"
 class QDomDocument;
 class QDomElement;
 
@@ -23,6 +25,7 @@ class DAWORKFLOW_API DAWorkFlow : public QObject
 	DA_DECLARE_PRIVATE(DAWorkFlow)
 	friend class DAAbstractNode;
 	friend class DANodeGraphicsScene;
+	friend class DAWorkFlowExecuter;
 
 public:
 	using CallbackPrepareStartExecute = std::function< bool(DAWorkFlowExecuter*) >;
@@ -95,9 +98,37 @@ public:
     void disableFactoryCallBack();
     void enableFactoryCallBack();
     bool isEnableFactoryCallBack() const;
+    // 是否并行执行，并行执行时相互独立的分支会同时执行
+    void setEnableParallelExecute(bool on);
+    bool isEnableParallelExecute() const;
+    // 是否增量执行，增量执行时指纹未变化的可缓存节点不会重复执行
+    void setEnableIncrementalExecute(bool on);
+    bool isEnableIncrementalExecute() const;
+    // 是否提前释放中间数据，释放后节点的中间结果无法在执行后查看
+    void setEnableReleaseIntermediateData(bool on);
+    bool isEnableReleaseIntermediateData() const;
+    // 最近一次执行的内存报告
+    DAWorkFlowExecuter::MemoryReport getLastExecuteMemoryReport() const;
+    // 是否记录节点的性能，记录执行时间、cpu时间、数据大小等
+    void setEnableProfile(bool on);
+    bool isEnableProfile() const;
+    // 最近一次执行的性能记录，没有开启时返回nullptr
+    DAWorkFlowProfiler::SharedPointer getLastExecuteProfiler() const;
+    // 流式连线的数据流容量（批次数），并行执行时上游节点在数据流已满后阻塞
+    void setStreamCapacity(int c);
+    int getStreamCapacity() const;
+    // 输出缓存的容量（缓存输出的节点数量），超出后淘汰最久未使用的节点输出
+    void setOutputCacheCapacity(int c);
+    int getOutputCacheCapacity() const;
+    // 清空所有节点的输出缓存，下次执行所有节点都会重新执行
+    void clearOutputCache();
+    // 获取执行计划，图结构改变后会重新编译，编译失败返回nullptr
+    DAWorkFlowExecutePlan::SharedPointer getExecutePlan();
 public slots:
 	// 运行工作流
 	void exec();
+	// 按需运行，只运行计算目标节点所需的上游节点
+	void execTo(DAAbstractNode::SharedPointer target);
 	// 终止
 	void terminate();
 
@@ -169,6 +200,12 @@ private slots:
 private:
 	// 记录工作流对应的scene
 	void recordScene(DANodeGraphicsScene* sc);
+	// 记录节点的输出缓存，由执行器调用
+	void recordOutputCache(const DAAbstractNode::SharedPointer& n);
+	// 移除节点的输出缓存记录
+	void removeOutputCache(const DAAbstractNode::SharedPointer& n);
+	// 图结构改变，执行计划失效
+	void invalidateExecutePlan();
 };
 }  // end of namespace DA
 #endif  // FCWORKFLOW_H
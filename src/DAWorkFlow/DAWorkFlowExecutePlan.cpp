@@ -0,0 +1,304 @@
+﻿#include "DAWorkFlowExecutePlan.h"
+#include <QSet>
+#include <QObject>
+#include <QStringList>
+#include "DAAbstractNodeFactory.h"
+
+namespace DA
+{
+
+//===================================================
+// DAWorkFlowExecutePlan
+//===================================================
+DAWorkFlowExecutePlan::DAWorkFlowExecutePlan()
+{
+}
+
+DAWorkFlowExecutePlan::~DAWorkFlowExecutePlan()
+{
+}
+
+/**
+ * @brief 编译执行计划
+ *
+ * 编译过程只在图结构改变后进行一次：
+ * - 给节点分配连续索引，连接到工作流之外节点的连线会被忽略
+ * - 每个节点的连线按输出key归并为输出槽，同一个输出key的数据只需获取一次
+ * - 计算入度、上游节点、全局/孤立/开始节点以及拓扑顺序
+ * - 拓扑排序失败说明图结构中存在环，此时编译失败
+ *
+ * @param nodes 工作流的所有节点
+ * @param errString 编译失败时的错误信息
+ * @return 编译失败返回nullptr
+ */
+DAWorkFlowExecutePlan::SharedPointer DAWorkFlowExecutePlan::compile(const QList< DAAbstractNode::SharedPointer >& nodes,
+                                                                    QString* errString)
+{
+    std::shared_ptr< DAWorkFlowExecutePlan > plan = std::make_shared< DAWorkFlowExecutePlan >();
+    const int n                                   = nodes.size();
+    plan->mNodes.reserve(n);
+    plan->mNodeIndex.reserve(n);
+    for (const DAAbstractNode::SharedPointer& node : nodes) {
+        plan->mNodeIndex.insert(node.get(), plan->mNodes.size());
+        plan->mNodes.append(node);
+    }
+    plan->mIndegree.fill(0, n);
+    plan->mIsGlobal.fill(0, n);
+    plan->mSlotOffsets.reserve(n + 1);
+    plan->mSlotOffsets.append(0);
+    QSet< std::shared_ptr< DAAbstractNodeFactory > > factorys;
+    // 输出槽和边
+    for (int i = 0; i < n; ++i) {
+        const DAAbstractNode::SharedPointer& node = plan->mNodes[ i ];
+        factorys.insert(node->factory());
+        if (DAAbstractNode::GlobalNode == node->nodeType()) {
+            plan->mIsGlobal[ i ] = 1;
+            plan->mGlobalNodes.append(i);
+        }
+        const QList< DAAbstractNode::LinkInfo > outInfo = node->getAllOutputLinkInfo();
+        for (const DAAbstractNode::LinkInfo& li : outInfo) {
+            OutputSlot s;
+            s.key       = li.key;
+            s.edgeBegin = plan->mEdges.size();
+            for (const QPair< QString, DAAbstractNode::SharedPointer >& pair : li.nodes) {
+                const int t = plan->indexOf(pair.second);
+                if (t < 0) {
+                    // 连接到工作流之外的节点，忽略
+                    continue;
+                }
+                Edge e;
+                e.target   = t;
+                e.inputKey = pair.first;
+                plan->mEdges.append(e);
+                ++(plan->mIndegree[ t ]);
+            }
+            s.edgeEnd = plan->mEdges.size();
+            if (s.edgeEnd > s.edgeBegin) {
+                plan->mSlots.append(s);
+            }
+        }
+        plan->mSlotOffsets.append(plan->mSlots.size());
+    }
+    // 上游节点，通过边反向计算
+    QVector< QVector< int > > inputs(n);
+    for (int i = 0; i < n; ++i) {
+        for (int s = plan->slotBegin(i); s < plan->slotEnd(i); ++s) {
+            const OutputSlot& os = plan->mSlots[ s ];
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                QVector< int >& in = inputs[ plan->mEdges[ e ].target ];
+                if (!in.contains(i)) {
+                    in.append(i);
+                }
+            }
+        }
+    }
+    plan->mInputOffsets.reserve(n + 1);
+    plan->mInputOffsets.append(0);
+    for (int i = 0; i < n; ++i) {
+        plan->mInputNodes += inputs[ i ];
+        plan->mInputOffsets.append(plan->mInputNodes.size());
+    }
+    // 孤立节点和开始节点
+    for (int i = 0; i < n; ++i) {
+        if (0 != plan->mIndegree[ i ]) {
+            continue;
+        }
+        if (0 == plan->outdegree(i)) {
+            // 如果孤立节点是全局节点，那么不作为孤立节点
+            if (!plan->mIsGlobal[ i ]) {
+                plan->mIsolatedNodes.append(i);
+            }
+        } else {
+            plan->mBeginNodes.append(i);
+        }
+    }
+    // 拓扑排序（Kahn），同时检查环
+    QVector< int > remain = plan->mIndegree;
+    plan->mTopologicalOrder.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        if (0 == remain[ i ]) {
+            plan->mTopologicalOrder.append(i);
+        }
+    }
+    for (int k = 0; k < plan->mTopologicalOrder.size(); ++k) {
+        const int i = plan->mTopologicalOrder[ k ];
+        for (int s = plan->slotBegin(i); s < plan->slotEnd(i); ++s) {
+            const OutputSlot& os = plan->mSlots[ s ];
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const int t = plan->mEdges[ e ].target;
+                if (0 == --remain[ t ]) {
+                    plan->mTopologicalOrder.append(t);
+                }
+            }
+        }
+    }
+    if (plan->mTopologicalOrder.size() != n) {
+        if (errString) {
+            QStringList names;
+            for (int i = 0; i < n; ++i) {
+                if (remain[ i ] > 0) {
+                    names.append(plan->mNodes[ i ]->getNodeName());
+                }
+            }
+            *errString = QObject::tr("workflow contains a cycle, nodes involved:%1").arg(names.join(","));  // cn:工作流存在环，涉及的节点:%1
+        }
+        return nullptr;
+    }
+    for (const auto& f : qAsConst(factorys)) {
+        if (f) {
+            plan->mFactorys.append(f);
+        }
+    }
+    return plan;
+}
+
+/**
+ * @brief 节点数量
+ * @return
+ */
+int DAWorkFlowExecutePlan::nodeCount() const
+{
+    return mNodes.size();
+}
+
+/**
+ * @brief 通过索引获取节点
+ * @param i
+ * @return
+ */
+const DAAbstractNode::SharedPointer& DAWorkFlowExecutePlan::node(int i) const
+{
+    return mNodes[ i ];
+}
+
+/**
+ * @brief 获取节点的索引
+ * @param n
+ * @return 不在计划中返回-1
+ */
+int DAWorkFlowExecutePlan::indexOf(const DAAbstractNode::SharedPointer& n) const
+{
+    return indexOf(n.get());
+}
+
+int DAWorkFlowExecutePlan::indexOf(const DAAbstractNode* n) const
+{
+    return mNodeIndex.value(n, -1);
+}
+
+/**
+ * @brief 节点的入度，也就是连接到此节点的连线数量
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::indegree(int i) const
+{
+    return mIndegree[ i ];
+}
+
+/**
+ * @brief 节点的出度，也就是此节点连接出去的连线数量
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::outdegree(int i) const
+{
+    const int sb = slotBegin(i);
+    const int se = slotEnd(i);
+    if (sb == se) {
+        return 0;
+    }
+    return mSlots[ se - 1 ].edgeEnd - mSlots[ sb ].edgeBegin;
+}
+
+/**
+ * @brief 节点输出槽的开始索引
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::slotBegin(int i) const
+{
+    return mSlotOffsets[ i ];
+}
+
+/**
+ * @brief 节点输出槽的结束索引（不包含）
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::slotEnd(int i) const
+{
+    return mSlotOffsets[ i + 1 ];
+}
+
+const DAWorkFlowExecutePlan::OutputSlot& DAWorkFlowExecutePlan::outputSlot(int s) const
+{
+    return mSlots[ s ];
+}
+
+const DAWorkFlowExecutePlan::Edge& DAWorkFlowExecutePlan::edge(int e) const
+{
+    return mEdges[ e ];
+}
+
+/**
+ * @brief 节点上游节点的开始索引
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::inputBegin(int i) const
+{
+    return mInputOffsets[ i ];
+}
+
+/**
+ * @brief 节点上游节点的结束索引（不包含）
+ * @param i
+ * @return
+ */
+int DAWorkFlowExecutePlan::inputEnd(int i) const
+{
+    return mInputOffsets[ i + 1 ];
+}
+
+/**
+ * @brief 上游节点的索引
+ * @param k 范围为[inputBegin(i),inputEnd(i))
+ * @return
+ */
+int DAWorkFlowExecutePlan::inputNode(int k) const
+{
+    return mInputNodes[ k ];
+}
+
+const QVector< int >& DAWorkFlowExecutePlan::globalNodes() const
+{
+    return mGlobalNodes;
+}
+
+const QVector< int >& DAWorkFlowExecutePlan::isolatedNodes() const
+{
+    return mIsolatedNodes;
+}
+
+const QVector< int >& DAWorkFlowExecutePlan::beginNodes() const
+{
+    return mBeginNodes;
+}
+
+const QVector< int >& DAWorkFlowExecutePlan::topologicalOrder() const
+{
+    return mTopologicalOrder;
+}
+
+bool DAWorkFlowExecutePlan::isGlobalNode(int i) const
+{
+    return mIsGlobal[ i ] != 0;
+}
+
+const QList< std::shared_ptr< DAAbstractNodeFactory > >& DAWorkFlowExecutePlan::factorys() const
+{
+    return mFactorys;
+}
+
+}  // end of namespace DA
@@ -0,0 +1,108 @@
+﻿#ifndef DAWORKFLOWEXECUTEPLAN_H
+#define DAWORKFLOWEXECUTEPLAN_H
+#include <memory>
+#include <QVector>
+#include <QHash>
+#include "DAWorkFlowGlobal.h"
+#include "DAAbstractNode.h"
+
+namespace DA
+{
+class DAAbstractNodeFactory;
+/**
+ * @brief 工作流的执行计划
+ *
+ * 执行计划是对工作流图结构的一次“编译”：校验图结构（是否存在环），给节点分配连续的索引，
+ * 把节点的连接关系按CSR（压缩稀疏行）的形式保存，并预先把输出key归并为输出槽，
+ * 执行器执行时只需通过索引访问数组，不需要每次执行节点都调用@ref DAAbstractNode::getAllOutputLinkInfo 重新构建连接信息
+ *
+ * 执行计划是只读的，编译后可以在多个执行器（多次执行）之间共享，工作流的图结构改变后执行计划失效，由@ref DAWorkFlow 重新编译
+ *
+ * 输出的数据结构如下：
+ *
+ * - 节点i的输出槽为[slotBegin(i),slotEnd(i))，一个输出槽对应节点一个有连接的输出key
+ * - 输出槽s的边为[outputSlot(s).edgeBegin,outputSlot(s).edgeEnd)，一条边对应一条连线
+ * - 节点i的上游节点为[inputBegin(i),inputEnd(i))，通过inputNode获取上游节点的索引
+ */
+class DAWORKFLOW_API DAWorkFlowExecutePlan
+{
+public:
+    using SharedPointer = std::shared_ptr< const DAWorkFlowExecutePlan >;
+
+    /**
+     * @brief 输出槽，对应节点一个有连接的输出key
+     */
+    struct OutputSlot
+    {
+        QString key;        ///< 输出key
+        int edgeBegin { 0 };  ///< 边的开始索引
+        int edgeEnd { 0 };    ///< 边的结束索引（不包含）
+    };
+
+    /**
+     * @brief 边，对应一条连线
+     */
+    struct Edge
+    {
+        int target { -1 };  ///< 连接到的节点索引
+        QString inputKey;   ///< 连接到的节点的输入key
+    };
+
+public:
+    DAWorkFlowExecutePlan();
+    ~DAWorkFlowExecutePlan();
+    // 编译执行计划，图结构存在环时返回nullptr
+    static SharedPointer compile(const QList< DAAbstractNode::SharedPointer >& nodes, QString* errString = nullptr);
+    // 节点数量
+    int nodeCount() const;
+    // 通过索引获取节点
+    const DAAbstractNode::SharedPointer& node(int i) const;
+    // 获取节点的索引，不在计划中返回-1
+    int indexOf(const DAAbstractNode::SharedPointer& n) const;
+    int indexOf(const DAAbstractNode* n) const;
+    // 节点的入度（连线数量）
+    int indegree(int i) const;
+    // 节点的出度（连线数量）
+    int outdegree(int i) const;
+    // 节点的输出槽范围
+    int slotBegin(int i) const;
+    int slotEnd(int i) const;
+    const OutputSlot& outputSlot(int s) const;
+    // 边
+    const Edge& edge(int e) const;
+    // 节点的上游节点范围
+    int inputBegin(int i) const;
+    int inputEnd(int i) const;
+    int inputNode(int k) const;
+    // 全局节点
+    const QVector< int >& globalNodes() const;
+    // 孤立节点
+    const QVector< int >& isolatedNodes() const;
+    // 开始节点
+    const QVector< int >& beginNodes() const;
+    // 拓扑顺序
+    const QVector< int >& topologicalOrder() const;
+    // 节点是否为全局节点
+    bool isGlobalNode(int i) const;
+    // 涉及到的工厂
+    const QList< std::shared_ptr< DAAbstractNodeFactory > >& factorys() const;
+
+private:
+    QVector< DAAbstractNode::SharedPointer > mNodes;            ///< 索引对应的节点
+    QHash< const DAAbstractNode*, int > mNodeIndex;              ///< 节点对应的索引
+    QVector< int > mIndegree;                                    ///< 节点入度
+    QVector< int > mSlotOffsets;                                 ///< 节点输出槽的偏移，尺寸为节点数+1
+    QVector< OutputSlot > mSlots;                                ///< 输出槽
+    QVector< Edge > mEdges;                                      ///< 边
+    QVector< int > mInputOffsets;                                ///< 节点上游节点的偏移，尺寸为节点数+1
+    QVector< int > mInputNodes;                                  ///< 上游节点（去重）
+    QVector< int > mGlobalNodes;                                 ///< 全局节点
+    QVector< int > mIsolatedNodes;                               ///< 孤立节点
+    QVector< int > mBeginNodes;                                  ///< 开始节点
+    QVector< int > mTopologicalOrder;                            ///< 拓扑顺序
+    QVector< char > mIsGlobal;                                   ///< 是否为全局节点
+    QList< std::shared_ptr< DAAbstractNodeFactory > > mFactorys;  ///< 涉及到的工厂
+};
+}  // end of namespace DA
+
+#endif  // DAWORKFLOWEXECUTEPLAN_H
@@ -1,42 +1,187 @@
 ﻿#include "DAWorkFlowExecuter.h"
-#include <QMap>
 #include <QDebug>
 #include <QPointer>
-#include <QSet>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include "da_concurrent_queue.hpp"
 #include "DAWorkFlow.h"
+#include "DANodeBatchStream.h"
+#include "DAWorkFlowProfiler.h"
+#if defined(Q_OS_WIN)
+#ifndef PSAPI_VERSION
+// 使用kernel32中的K32GetProcessMemoryInfo，无需链接psapi
+#define PSAPI_VERSION 2
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_MACOS)
+#include <mach/mach.h>
+#elif defined(Q_OS_LINUX)
+#include <cstdio>
+#include <unistd.h>
+#endif
 #include "DAAbstractNodeFactory.h"
 
 namespace DA
 {
+/**
+ * @brief 节点数据的估算字节数
+ * @param n
+ * @param keys
+ * @param input 是否为输入
+ * @return 都无法估算时返回-1
+ */
+static qint64 executer_data_bytes(const DAAbstractNode::SharedPointer& n, const QList< QString >& keys, bool input)
+{
+    qint64 res = -1;
+    for (const QString& k : keys) {
+        const qint64 s = DAWorkFlowProfiler::estimateSize(input ? n->getInputData(k) : n->getOutputData(k));
+        if (s >= 0) {
+            res = qMax< qint64 >(res, 0) + s;
+        }
+    }
+    return res;
+}
+
+/**
+ * @brief 执行节点，执行完成后关闭输出流、取消输入流
+ *
+ * profiler不为空时记录节点的执行时间、cpu时间、脚本时间和数据大小，此函数会在线程池的线程中调用
+ * @param n
+ * @param profiler
+ * @return
+ */
+static bool executer_run_node(const DAAbstractNode::SharedPointer& n, DAWorkFlowProfiler* profiler)
+{
+    if (!profiler) {
+        bool state = n->exec();
+        n->closeOutputStreams();
+        n->cancelInputStreams();
+        return state;
+    }
+    DANodeProfile p;
+    p.nodeId     = n->getID();
+    p.nodeName   = n->getNodeName();
+    p.prototype  = n->metaData().getNodePrototype();
+    p.threadId   = DAWorkFlowProfiler::currentThreadId();
+    p.inputBytes = executer_data_bytes(n, n->getInputKeys(), true);
+    DAWorkFlowProfiler::takeScriptTime();
+    const qint64 cpu = DAWorkFlowProfiler::currentThreadCpuTimeUs();
+    p.startUs        = profiler->elapsedUs();
+    p.success        = n->exec();
+    n->closeOutputStreams();
+    n->cancelInputStreams();
+    p.wallUs = profiler->elapsedUs() - p.startUs;
+    if (cpu >= 0) {
+        p.cpuUs = DAWorkFlowProfiler::currentThreadCpuTimeUs() - cpu;
+    }
+    p.scriptUs    = DAWorkFlowProfiler::takeScriptTime();
+    p.outputBytes = executer_data_bytes(n, n->getOutputKeys(), false);
+    profiler->record(p);
+    return p.success;
+}
+
+/**
+ * @brief 并行执行模式下，在线程池中执行节点的任务
+ *
+ * 任务只调用节点的exec，执行结果推入完成队列，参数的传递和后续节点的调度都在执行器线程中进行，
+ * 这样节点之间的数据传递不需要额外加锁
+ *
+ * 节点执行完成后立即在工作线程中关闭输出流、取消输入流，不需要等待执行器线程处理完成队列
+ */
+class DAWorkFlowNodeRunnable : public QRunnable
+{
+public:
+    using FinishedQueue = da_concurrent_queue< QPair< int, bool > >;
+    DAWorkFlowNodeRunnable(const DAAbstractNode::SharedPointer& n, int index, FinishedQueue* q, DAWorkFlowProfiler* profiler)
+        : mNode(n), mIndex(index), mQueue(q), mProfiler(profiler)
+    {
+        setAutoDelete(true);
+    }
+    void run() override
+    {
+        bool state = executer_run_node(mNode, mProfiler);
+        mQueue->push(qMakePair(mIndex, state));
+    }
+
+private:
+    DAAbstractNode::SharedPointer mNode;
+    int mIndex;
+    FinishedQueue* mQueue;
+    DAWorkFlowProfiler* mProfiler;
+};
+
 class DAWorkFlowExecuter::PrivateData
 {
     DA_DECLARE_PUBLIC(DAWorkFlowExecuter)
 public:
     PrivateData(DAWorkFlowExecuter* p);
-    // 查找开始节点，根据网结构， 查找到最终的顶层节点_isolatedNodes和_beginNodes通过此函数查找
-    void prepareStartExec();
+    // 准备执行，执行计划不存在时编译执行计划，并重置本次执行的状态
+    bool prepareStartExec();
+    // 确保执行计划可用，用于没有经过startExecute而直接执行节点的情况
+    bool ensurePlan();
     // 清空内容
     void clear();
-    //
-    void sendParam(DAAbstractNode::SharedPointer& n, const QList< DAAbstractNode::LinkInfo >& outInfo);
-    void transmit(const QList< DAAbstractNode::LinkInfo >& outInfo);
+    // 把节点的输出传递到下游节点
+    void sendParam(int i);
+    // 执行入度已满足的下游节点
+    void transmit(int i);
+    // 节点入度是否已经满足
+    bool isIndegreeSatisfied(int i) const;
+    // 查找目标节点的所有上游节点
+    void collectTargetClosure(int target);
+    // 节点是否在本次执行的范围内
+    bool isInScope(int i) const;
+    // 增量执行时判断节点能否复用上次的输出
+    bool isOutputCacheHit(int i);
+    // 执行节点，能复用上次输出的节点不会执行
+    bool execNode(int i);
+    // 节点执行完成并传递参数后记录输出缓存
+    void recordOutputCache(int i, bool state);
+    // 为节点的流式输出创建数据流并传递给下游节点
+    void openOutputStreams(int i, std::size_t capacity);
+    // 流式输出的上下游节点能否同时执行
+    bool isStreamConcurrent(int i) const;
+    // 执行节点，执行完成后关闭输出流、取消输入流
+    bool runNode(const DAAbstractNode::SharedPointer& n);
+    // 记录复用输出的节点
+    void recordCacheHit(int i);
+    // 节点执行完成并传递参数后释放不再需要的输入输出
+    void releaseIntermediateData(int i);
+    // 采样内存
+    void sampleMemory(int i);
+    // 把索引转换为节点
+    QList< DAAbstractNode::SharedPointer > toNodes(const QVector< int >& indexs) const;
 
 public:
     bool mIsTerminateRequest { false };  ///< 请求终止
     QPointer< DAWorkFlow > mWorkflow;
     DAAbstractNode::SharedPointer mStartNode;
+    DAAbstractNode::SharedPointer mTargetNode;  ///< 目标节点，按需执行时只执行目标节点的上游闭包
     QList< DAWorkFlow::CallbackPrepareStartExecute > mCallbackStart;
     QList< DAWorkFlow::CallbackPrepareEndExecute > mCallbackEnd;
+    DAWorkFlowExecutePlan::SharedPointer mPlan;  ///< 执行计划
     /**
-     * @brief 记录所有节点执行的入度数量
+     * @brief 记录所有节点执行的入度数量，索引为执行计划中节点的索引
      *
      * 只有入度数量满足,才能触发节点的出度进行后续的传递，此变量用于解决多从入度和出度下的执行顺序问题
      */
-    QMap< DAAbstractNode::SharedPointer, int > mNodeIndegreeSetCount;
-    QList< DAAbstractNode::SharedPointer > mGlobalNodes;          ///< 全局节点
-    QList< DAAbstractNode::SharedPointer > mIsolatedNodes;        ///< 孤立节点
-    QList< DAAbstractNode::SharedPointer > mBeginNodes;           ///< 开始节点
-    QList< DAAbstractNodeFactory::SharedPointer > mNodeFactorys;  ///< 记录本次工作流涉及到的工厂
+    QVector< int > mIndegreeSetCount;
+    QVector< char > mScope;              ///< 本次执行的节点范围，为空时执行所有节点
+    QVector< char > mExecuted;           ///< 本次执行中已经执行过的节点，避免同一节点通过多条链接被重复触发
+    QVector< uint64_t > mExecFingerprints;  ///< 本次执行的可缓存节点的指纹
+    QVector< char > mStreamNodes;  ///< 本次执行中通过有界数据流同时执行的节点，这些节点在线程池中额外占用线程
+    bool mEnableParallel { false };                        ///< 是否并行执行
+    int mMaxThreadCount { QThread::idealThreadCount() };   ///< 并行执行的最大线程数
+    QThreadPool mThreadPool;                               ///< 并行执行的线程池
+    DAWorkFlowNodeRunnable::FinishedQueue mFinishedQueue;  ///< 线程池中执行完成的节点
+    bool mEnableIncremental { false };                     ///< 是否增量执行
+    int mStreamCapacity { 4 };                             ///< 有界数据流的容量
+    bool mEnableRelease { false };                         ///< 是否提前释放中间数据
+    DAWorkFlowExecuter::MemoryReport mMemoryReport;        ///< 内存报告
+    bool mEnableProfile { false };                         ///< 是否记录节点的性能
+    DAWorkFlowProfiler::SharedPointer mProfiler;           ///< 最近一次执行的性能记录
 };
 
 //===================================================
@@ -47,44 +192,57 @@ DAWorkFlowExecuter::PrivateData::PrivateData(DAWorkFlowExecuter* p) : q_ptr(p)
 }
 
 /**
- * @brief 通过网结构查找顶层
- *
- * - 所有没有入度的节点都认为是顶层
- * - 入度和出度都没有的节点属于孤立节点，孤立节点先执行
+ * @brief 准备执行
  *
+ * 图结构的分析（全局节点、孤立节点、开始节点、入度）都在执行计划中完成，
+ * 这里只需按节点数量重置本次执行的状态
+ * @return 执行计划编译失败返回false
  */
-void DAWorkFlowExecuter::PrivateData::prepareStartExec()
+bool DAWorkFlowExecuter::PrivateData::prepareStartExec()
 {
     // 请求终止标记为false
     mIsTerminateRequest = false;
     // 清空记录
     clear();
-    // 查找孤立节点和0入度节点
-    QList< DAAbstractNode::SharedPointer > nodes = mWorkflow->nodes();
-    QSet< std::shared_ptr< DAAbstractNodeFactory > > factorys;
-    for (const DAAbstractNode::SharedPointer& n : qAsConst(nodes)) {
-        factorys.insert(n->factory());
-        if (DAAbstractNode::GlobalNode == n->nodeType()) {
-            mGlobalNodes.append(n);
+    if (!mPlan) {
+        if (!mWorkflow) {
+            return false;
         }
-        // 全局节点的判断和隐式节点类型的判断不冲突，这里是if不是else if
-        if (0 == n->getInputNodesCount()) {
-            if (0 == n->getOutputNodesCount()) {
-                // 孤立节点
-                if (!mGlobalNodes.contains(n)) {
-                    // 如果孤立节点是全局节点，那么不作为孤立节点
-                    mIsolatedNodes.append(n);
-                }
-            } else {
-                // 否则为开始节点
-                mBeginNodes.append(n);
-            }
+        QString err;
+        mPlan = DAWorkFlowExecutePlan::compile(mWorkflow->nodes(), &err);
+        if (!mPlan) {
+            qCritical() << err;
+            return false;
         }
     }
-    // 记录工厂
-    for (auto f : qAsConst(factorys)) {
-        mNodeFactorys.append(f);
+    const int n = mPlan->nodeCount();
+    mIndegreeSetCount.fill(0, n);
+    mExecuted.fill(0, n);
+    mExecFingerprints.fill(0, n);
+    mStreamNodes.fill(0, n);
+    mMemoryReport            = DAWorkFlowExecuter::MemoryReport();
+    mMemoryReport.startBytes = DAWorkFlowExecuter::processResidentMemory();
+    mMemoryReport.peakBytes  = mMemoryReport.startBytes;
+    if (mEnableProfile) {
+        // 每次执行使用新的分析器，上次执行的记录可能还在被界面使用
+        mProfiler = std::make_shared< DAWorkFlowProfiler >();
+        mProfiler->start();
+    } else {
+        mProfiler.reset();
     }
+    return true;
+}
+
+/**
+ * @brief 确保执行计划可用
+ * @return
+ */
+bool DAWorkFlowExecuter::PrivateData::ensurePlan()
+{
+    if (mPlan && mIndegreeSetCount.size() == mPlan->nodeCount()) {
+        return true;
+    }
+    return prepareStartExec();
 }
 
 /**
@@ -92,52 +250,419 @@ void DAWorkFlowExecuter::PrivateData::prepareStartExec()
  */
 void DAWorkFlowExecuter::PrivateData::clear()
 {
-    mNodeIndegreeSetCount.clear();
-    mGlobalNodes.clear();
-    mIsolatedNodes.clear();
-    mBeginNodes.clear();
-    mNodeFactorys.clear();
+    mIndegreeSetCount.clear();
+    mScope.clear();
+    mExecuted.clear();
+    mExecFingerprints.clear();
+    mStreamNodes.clear();
 }
 
 /**
  * @brief 传递参数
  *
- * 把节点的出度的参数传递到对应的入度节点中
+ * 把节点的出度的参数传递到对应的入度节点中，每个输出槽的数据只获取一次，
+ * 流式输出已经在节点执行前通过@ref openOutputStreams 传递，这里跳过
  * @note 参数只传递，并不会执行对应的节点
- * @param n
- * @param outInfo
- */
-void DAWorkFlowExecuter::PrivateData::sendParam(DAAbstractNode::SharedPointer& n,
-                                                const QList< DAAbstractNode::LinkInfo >& outInfo)
-{
-    for (const DAAbstractNode::LinkInfo& li : qAsConst(outInfo)) {
-        QVariant v = n->getOutputData(li.key);
-        for (const QPair< QString, DAAbstractNode::SharedPointer >& pair : qAsConst(li.nodes)) {
-            pair.second->setInputData(pair.first, v);
-            auto ite = mNodeIndegreeSetCount.find(pair.second);
-            if (ite == mNodeIndegreeSetCount.end()) {
-                ite = mNodeIndegreeSetCount.insert(pair.second, 1);
-            } else {
-                ++(ite.value());
+ * @param i 节点索引
+ */
+void DAWorkFlowExecuter::PrivateData::sendParam(int i)
+{
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+        const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+        if (n->isOutputStreaming(os.key)) {
+            continue;
+        }
+        const QVariant v                            = n->getOutputData(os.key);
+        for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+            const DAWorkFlowExecutePlan::Edge& edge = mPlan->edge(e);
+            if (!isInScope(edge.target)) {
+                // 按需执行时不影响范围外的节点
+                continue;
             }
+            mPlan->node(edge.target)->setInputData(edge.inputKey, v);
+            ++(mIndegreeSetCount[ edge.target ]);
         }
     }
 }
 
 /**
  * @brief 查询输出连接到的节点，并查看节点是否满足执行条件，如果满足则执行
- * @param outInfo
+ * @param i 节点索引
  */
-void DAWorkFlowExecuter::PrivateData::transmit(const QList< DAAbstractNode::LinkInfo >& outInfo)
+void DAWorkFlowExecuter::PrivateData::transmit(int i)
 {
-    for (const DAAbstractNode::LinkInfo& li : qAsConst(outInfo)) {
-        for (const QPair< QString, DAAbstractNode::SharedPointer >& pair : qAsConst(li.nodes)) {
-            if (pair.second->getInputNodesCount() == mNodeIndegreeSetCount[ pair.second ]) {
+    for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+        const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+        for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+            const int t = mPlan->edge(e).target;
+            if (!mExecuted[ t ] && isInScope(t) && isIndegreeSatisfied(t)) {
                 // 达成执行条件
-                q_ptr->executeNode(pair.second);
+                q_ptr->executeNodeByIndex(t);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 节点入度是否已经满足
+ *
+ * 入度在执行计划中一次性计算，避免每次都遍历节点的链接信息
+ * @param i 节点索引
+ * @return
+ */
+bool DAWorkFlowExecuter::PrivateData::isIndegreeSatisfied(int i) const
+{
+    return mPlan->indegree(i) == mIndegreeSetCount[ i ];
+}
+
+/**
+ * @brief 查找目标节点的上游闭包
+ *
+ * 从目标节点沿执行计划的上游节点反向遍历，得到计算目标节点所需的最小节点集合，
+ * 闭包内任意节点的所有上游节点也都在闭包内，因此闭包内节点的入度和全图一致
+ * @param target 目标节点索引
+ */
+void DAWorkFlowExecuter::PrivateData::collectTargetClosure(int target)
+{
+    mScope.fill(0, mPlan->nodeCount());
+    QVector< int > stack;
+    stack.append(target);
+    mScope[ target ] = 1;
+    while (!stack.isEmpty()) {
+        const int i = stack.takeLast();
+        for (int k = mPlan->inputBegin(i); k < mPlan->inputEnd(i); ++k) {
+            const int in = mPlan->inputNode(k);
+            if (!mScope[ in ]) {
+                mScope[ in ] = 1;
+                stack.append(in);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 节点是否在本次执行的范围内
+ * @param i 节点索引
+ * @return 没有设置目标节点时所有节点都在范围内
+ */
+bool DAWorkFlowExecuter::PrivateData::isInScope(int i) const
+{
+    return mScope.isEmpty() || mScope[ i ];
+}
+
+/**
+ * @brief 增量执行时判断节点能否复用上次的输出
+ *
+ * 节点的输入在此函数调用前已经传递完成，如果节点的指纹和输出缓存的指纹一致，说明节点的输出不会改变，
+ * 否则原来的输出缓存失效，节点需要重新执行
+ * @param i 节点索引
+ * @return 能复用返回true
+ */
+bool DAWorkFlowExecuter::PrivateData::isOutputCacheHit(int i)
+{
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    if (!mEnableIncremental || !n->metaData().isCacheable() || n->hasStreamingOutput()) {
+        // 流式输出在执行过程中被下游消费，无法复用
+        return false;
+    }
+    const uint64_t fp = n->calcFingerprint();
+    if (0 != fp) {
+        mExecFingerprints[ i ] = fp;
+        if (fp == n->getOutputCacheFingerprint()) {
+            return true;
+        }
+    }
+    // 节点将重新执行，原来的输出缓存不再对应节点的输出
+    n->invalidateOutputCache();
+    if (mWorkflow) {
+        mWorkflow->removeOutputCache(n);
+    }
+    return false;
+}
+
+/**
+ * @brief 执行节点
+ * @param i 节点索引
+ * @return 节点的执行结果，复用上次输出时返回true
+ */
+bool DAWorkFlowExecuter::PrivateData::execNode(int i)
+{
+    mExecuted[ i ] = 1;
+    if (isOutputCacheHit(i)) {
+        qDebug() << DAWorkFlowExecuter::tr("reuse cached output of node, name=%1").arg(mPlan->node(i)->getNodeName());
+        recordCacheHit(i);
+        return true;
+    }
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    if (n->hasStreamingOutput()) {
+        // 串行执行时上下游不会同时执行，数据流不能限制容量
+        openOutputStreams(i, 0);
+    }
+    return runNode(n);
+}
+
+/**
+ * @brief 记录输出缓存
+ *
+ * 必须在参数传递完成后调用，因为超出缓存容量时可能会释放节点的输出数据
+ * @param i 节点索引
+ * @param state 节点的执行结果，执行失败不会缓存
+ */
+void DAWorkFlowExecuter::PrivateData::recordOutputCache(int i, bool state)
+{
+    const uint64_t fp      = mExecFingerprints[ i ];
+    mExecFingerprints[ i ] = 0;
+    if (0 == fp || !state || !mWorkflow) {
+        return;
+    }
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    n->setOutputCacheFingerprint(fp);
+    mWorkflow->recordOutputCache(n);
+}
+
+/**
+ * @brief 为节点的流式输出创建数据流
+ *
+ * 流式输出的每条连线对应一个数据流，数据流作为输入数据直接传递给下游节点，下游节点的入度随之满足，
+ * 因此下游节点可以和本节点同时执行
+ * @param i 节点索引
+ * @param capacity 数据流容量，0代表不限制容量，不为0时上下游节点记录为同时执行的节点
+ */
+void DAWorkFlowExecuter::PrivateData::openOutputStreams(int i, std::size_t capacity)
+{
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+        const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+        if (!n->isOutputStreaming(os.key)) {
+            continue;
+        }
+        QList< DANodeBatchStream::SharedPointer > streams;
+        for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+            const DAWorkFlowExecutePlan::Edge& edge = mPlan->edge(e);
+            if (!isInScope(edge.target)) {
+                continue;
+            }
+            DANodeBatchStream::SharedPointer stream = std::make_shared< DANodeBatchStream >(capacity);
+            mPlan->node(edge.target)->setInputData(edge.inputKey, QVariant::fromValue(stream));
+            ++(mIndegreeSetCount[ edge.target ]);
+            streams.append(stream);
+            if (capacity > 0) {
+                mStreamNodes[ edge.target ] = 1;
+            }
+        }
+        n->setOutputStreams(os.key, streams);
+    }
+    if (capacity > 0) {
+        mStreamNodes[ i ] = 1;
+    }
+}
+
+/**
+ * @brief 流式输出的上下游节点能否同时执行
+ *
+ * 以下情况上下游节点不能同时执行，否则本节点阻塞在已满的有界数据流上，下游节点又在等待本节点执行完成，导致死锁：
+ *
+ * - 本节点或者流式输出的下游节点不能在线程池中执行
+ * - 流式输出的下游节点同时连接了本节点的非流式输出
+ * - 流式输出的下游节点还有其它上游节点依赖本节点（本节点的后代节点），这些上游节点要等本节点执行完成
+ *
+ * 不能同时执行时数据流不限制容量，上游执行完成后下游再读取
+ * @param i 节点索引
+ * @return
+ */
+bool DAWorkFlowExecuter::PrivateData::isStreamConcurrent(int i) const
+{
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    if (!mEnableParallel || !n->metaData().isThreadSafe()) {
+        return false;
+    }
+    // 本节点的后代节点，包含通过非流式输出直接连接的下游节点
+    QVector< char > descendant(mPlan->nodeCount(), 0);
+    QVector< int > stack;
+    for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+        const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+        const bool streaming                        = n->isOutputStreaming(os.key);
+        for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+            const int t = mPlan->edge(e).target;
+            if (streaming) {
+                // 流式输出的下游节点先作为后代节点的起点，不算作依赖
+                stack.append(t);
+            } else if (!descendant[ t ]) {
+                descendant[ t ] = 1;
+                stack.append(t);
+            }
+        }
+    }
+    while (!stack.isEmpty()) {
+        const int k = stack.takeLast();
+        for (int s = mPlan->slotBegin(k); s < mPlan->slotEnd(k); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const int t = mPlan->edge(e).target;
+                if (!descendant[ t ]) {
+                    descendant[ t ] = 1;
+                    stack.append(t);
+                }
             }
         }
     }
+    for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+        const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+        if (!n->isOutputStreaming(os.key)) {
+            continue;
+        }
+        for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+            const int t = mPlan->edge(e).target;
+            if (!isInScope(t)) {
+                continue;
+            }
+            if (!mPlan->node(t)->metaData().isThreadSafe() || descendant[ t ]) {
+                return false;
+            }
+            for (int k = mPlan->inputBegin(t); k < mPlan->inputEnd(t); ++k) {
+                const int u = mPlan->inputNode(k);
+                if (u != i && isInScope(u) && descendant[ u ]) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 执行节点
+ *
+ * 执行完成后关闭输出流，下游读完剩余批次后结束；取消输入流，上游不再阻塞
+ * @param n
+ * @return
+ */
+bool DAWorkFlowExecuter::PrivateData::runNode(const DAAbstractNode::SharedPointer& n)
+{
+    return executer_run_node(n, mProfiler.get());
+}
+
+/**
+ * @brief 记录复用输出的节点，时间为0，用于在时间线上标识节点没有执行
+ * @param i
+ */
+void DAWorkFlowExecuter::PrivateData::recordCacheHit(int i)
+{
+    if (!mProfiler) {
+        return;
+    }
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    DANodeProfile p;
+    p.nodeId    = n->getID();
+    p.nodeName  = n->getNodeName();
+    p.prototype = n->metaData().getNodePrototype();
+    p.threadId  = DAWorkFlowProfiler::currentThreadId();
+    p.startUs   = mProfiler->elapsedUs();
+    p.success   = true;
+    p.cacheHit  = true;
+    mProfiler->record(p);
+}
+
+/**
+ * @brief 释放不再需要的中间数据
+ *
+ * 输出数据以QVariant的形式共享，传递参数后下游节点的输入持有同一份数据，
+ * 因此节点的输出传递完成后即可释放，数据由还未执行的下游节点持有，下游节点执行完成后释放输入，
+ * 最后一个下游节点执行完成时数据才真正释放，相当于对每个输出按剩余的下游节点做引用计数
+ *
+ * 以下情况不会释放：
+ * - 节点设置了保留执行数据（@ref DAAbstractNode::isKeepDataForInspection ）
+ * - 节点的输出被记录为输出缓存，增量执行时需要复用
+ * - 没有连接的输出，这些输出通常就是工作流的结果
+ * @param i 节点索引
+ */
+void DAWorkFlowExecuter::PrivateData::releaseIntermediateData(int i)
+{
+    const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+    if (!mEnableRelease || n->isKeepDataForInspection()) {
+        return;
+    }
+    if (0 == n->getOutputCacheFingerprint()) {
+        for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+            const QString& key = mPlan->outputSlot(s).key;
+            if (n->getOutputData(key).isValid()) {
+                n->releaseOutputData(key);
+                ++(mMemoryReport.releasedDataCount);
+            }
+        }
+    }
+    if (mPlan->inputBegin(i) != mPlan->inputEnd(i)) {
+        // 只释放有连接的输入，没有连接的输入是用户设置的，下次执行还需要使用
+        const QList< QString > keys = n->getLinkedInputKeys();
+        for (const QString& key : keys) {
+            if (n->getInputData(key).isValid()) {
+                n->releaseInputData(key);
+                ++(mMemoryReport.releasedDataCount);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 采样内存
+ *
+ * 在节点执行完成、释放中间数据之前采样，此时节点的输入输出同时存在
+ * @param i 刚执行完成的节点索引
+ */
+void DAWorkFlowExecuter::PrivateData::sampleMemory(int i)
+{
+    const qint64 m = DAWorkFlowExecuter::processResidentMemory();
+    if (m > mMemoryReport.peakBytes) {
+        mMemoryReport.peakBytes    = m;
+        mMemoryReport.peakNodeName = mPlan->node(i)->getNodeName();
+    }
+}
+
+/**
+ * @brief 把索引转换为节点
+ * @param indexs
+ * @return
+ */
+QList< DAAbstractNode::SharedPointer > DAWorkFlowExecuter::PrivateData::toNodes(const QVector< int >& indexs) const
+{
+    QList< DAAbstractNode::SharedPointer > res;
+    if (!mPlan) {
+        return res;
+    }
+    res.reserve(indexs.size());
+    for (int i : indexs) {
+        res.append(mPlan->node(i));
+    }
+    return res;
+}
+
+//====================================
+// DAWorkFlowExecuter::MemoryReport
+//====================================
+
+/**
+ * @brief 是否有效
+ * @return 当前平台无法获取内存时无效
+ */
+bool DAWorkFlowExecuter::MemoryReport::isValid() const
+{
+    return peakBytes >= 0;
+}
+
+/**
+ * @brief 转换为可读的文本
+ * @return
+ */
+QString DAWorkFlowExecuter::MemoryReport::toString() const
+{
+    if (!isValid()) {
+        return DAWorkFlowExecuter::tr("memory report is not available on this platform");  // cn:当前平台无法获取内存报告
+    }
+    auto mb = [](qint64 b) { return QString::number(static_cast< double >(b) / (1024.0 * 1024.0), 'f', 1); };
+    return DAWorkFlowExecuter::tr("memory(MB):start=%1,peak=%2(after node \"%3\"),end=%4,released %5 intermediate data")
+        .arg(mb(startBytes), mb(peakBytes), peakNodeName, mb(endBytes))
+        .arg(releasedDataCount);  // cn:内存(MB):开始=%1,峰值=%2(节点"%3"执行后),结束=%4,提前释放了%5个中间数据
 }
 
 //====================================
@@ -163,6 +688,19 @@ void DAWorkFlowExecuter::setStartNode(DAAbstractNode::SharedPointer n)
     d_ptr->mStartNode = n;
 }
 
+/**
+ * @brief 设置目标节点
+ *
+ * 设置目标节点后为按需执行模式：只执行计算目标节点所需的上游节点（以及全局节点），
+ * 按拓扑顺序执行，开启并行执行时相互独立的上游分支会同时执行，和目标节点无关的分支不会执行，也不会收到参数
+ * @param n 为nullptr时执行整个工作流
+ * @note 目标节点优先于开始节点（@ref setStartNode ）
+ */
+void DAWorkFlowExecuter::setTargetNode(DAAbstractNode::SharedPointer n)
+{
+    d_ptr->mTargetNode = n;
+}
+
 /**
  * @brief 设置工作流
  * @param wf
@@ -174,13 +712,33 @@ void DAWorkFlowExecuter::setWorkFlow(DAWorkFlow* wf)
     d_ptr->mCallbackEnd   = wf->getEndWorkflowCallback();
 }
 
+/**
+ * @brief 设置执行计划
+ *
+ * 执行计划由@ref DAWorkFlow 编译并在多次执行之间共享，没有设置时执行器在开始执行时自行编译
+ * @param plan
+ */
+void DAWorkFlowExecuter::setExecutePlan(DAWorkFlowExecutePlan::SharedPointer plan)
+{
+    d_ptr->mPlan = plan;
+}
+
+/**
+ * @brief 获取执行计划
+ * @return
+ */
+DAWorkFlowExecutePlan::SharedPointer DAWorkFlowExecuter::getExecutePlan() const
+{
+    return d_ptr->mPlan;
+}
+
 /**
  * @brief 获取全局节点
  * @return
  */
 QList< DAAbstractNode::SharedPointer > DAWorkFlowExecuter::getGlobalNodes() const
 {
-    return d_ptr->mGlobalNodes;
+    return d_ptr->mPlan ? d_ptr->toNodes(d_ptr->mPlan->globalNodes()) : QList< DAAbstractNode::SharedPointer >();
 }
 
 /**
@@ -189,7 +747,7 @@ QList< DAAbstractNode::SharedPointer > DAWorkFlowExecuter::getGlobalNodes() cons
  */
 QList< DAAbstractNode::SharedPointer > DAWorkFlowExecuter::getIsolatedNodesNodes() const
 {
-    return d_ptr->mIsolatedNodes;
+    return d_ptr->mPlan ? d_ptr->toNodes(d_ptr->mPlan->isolatedNodes()) : QList< DAAbstractNode::SharedPointer >();
 }
 
 /**
@@ -201,6 +759,183 @@ bool DAWorkFlowExecuter::isTerminateRequest() const
     return d_ptr->mIsTerminateRequest;
 }
 
+/**
+ * @brief 设置是否开启并行执行
+ *
+ * 并行执行模式下，入度满足的节点会同时进入就绪状态，线程安全的节点(@ref DANodeMetaData::isThreadSafe)
+ * 放到线程池中执行，其余节点在执行器线程中执行，节点执行完成后立即触发入度已满足的后续节点
+ * @param on 默认为false，即按深度优先串行执行
+ */
+void DAWorkFlowExecuter::setEnableParallelExecute(bool on)
+{
+    d_ptr->mEnableParallel = on;
+}
+
+/**
+ * @brief 是否开启并行执行
+ * @return
+ */
+bool DAWorkFlowExecuter::isEnableParallelExecute() const
+{
+    return d_ptr->mEnableParallel;
+}
+
+/**
+ * @brief 设置并行执行的最大线程数
+ * @param c 小于1时使用QThread::idealThreadCount
+ */
+void DAWorkFlowExecuter::setMaxThreadCount(int c)
+{
+    d_ptr->mMaxThreadCount = (c < 1) ? QThread::idealThreadCount() : c;
+}
+
+/**
+ * @brief 并行执行的最大线程数
+ * @return 默认为QThread::idealThreadCount
+ */
+int DAWorkFlowExecuter::getMaxThreadCount() const
+{
+    return d_ptr->mMaxThreadCount;
+}
+
+/**
+ * @brief 设置是否开启增量执行
+ *
+ * 增量执行时，可缓存节点的指纹和上次执行成功时一致，节点不再执行，直接传递上次的输出
+ * @param on
+ * @sa DAWorkFlow::setEnableIncrementalExecute
+ */
+void DAWorkFlowExecuter::setEnableIncrementalExecute(bool on)
+{
+    d_ptr->mEnableIncremental = on;
+}
+
+/**
+ * @brief 是否开启增量执行
+ * @return
+ */
+bool DAWorkFlowExecuter::isEnableIncrementalExecute() const
+{
+    return d_ptr->mEnableIncremental;
+}
+
+/**
+ * @brief 设置是否提前释放中间数据
+ *
+ * 开启后节点的输出传递给下游节点后释放，节点执行完成后释放输入，
+ * 中间数据在最后一个下游节点执行完成后即被释放，而不是保留到下次执行，工作流的内存峰值接近同时存活的中间数据之和，
+ * 释放后执行完成时无法再查看中间节点的数据
+ * @param on 默认为false
+ * @sa DAAbstractNode::setKeepDataForInspection
+ */
+void DAWorkFlowExecuter::setEnableReleaseIntermediateData(bool on)
+{
+    d_ptr->mEnableRelease = on;
+}
+
+/**
+ * @brief 是否提前释放中间数据
+ * @return
+ */
+bool DAWorkFlowExecuter::isEnableReleaseIntermediateData() const
+{
+    return d_ptr->mEnableRelease;
+}
+
+/**
+ * @brief 最近一次执行的内存报告
+ * @return
+ */
+DAWorkFlowExecuter::MemoryReport DAWorkFlowExecuter::getMemoryReport() const
+{
+    return d_ptr->mMemoryReport;
+}
+
+/**
+ * @brief 进程的常驻内存
+ * @return 字节数，无法获取时返回-1
+ */
+qint64 DAWorkFlowExecuter::processResidentMemory()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return static_cast< qint64 >(pmc.WorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_MACOS)
+    mach_task_basic_info info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (KERN_SUCCESS == task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast< task_info_t >(&info), &count)) {
+        return static_cast< qint64 >(info.resident_size);
+    }
+    return -1;
+#elif defined(Q_OS_LINUX)
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) {
+        return -1;
+    }
+    long pages    = 0;
+    long resident = 0;
+    const int n   = std::fscanf(f, "%ld %ld", &pages, &resident);
+    std::fclose(f);
+    if (2 != n) {
+        return -1;
+    }
+    return static_cast< qint64 >(resident) * static_cast< qint64 >(sysconf(_SC_PAGESIZE));
+#else
+    return -1;
+#endif
+}
+
+/**
+ * @brief 设置是否记录节点的性能
+ *
+ * 开启后每个节点执行时记录墙钟时间、cpu时间、线程、数据大小和脚本时间，
+ * 记录的开销主要是输入输出数据大小的估算，因此默认关闭
+ * @param on
+ * @sa DAWorkFlowProfiler
+ */
+void DAWorkFlowExecuter::setEnableProfile(bool on)
+{
+    d_ptr->mEnableProfile = on;
+}
+
+bool DAWorkFlowExecuter::isEnableProfile() const
+{
+    return d_ptr->mEnableProfile;
+}
+
+/**
+ * @brief 最近一次执行的性能记录
+ * @return 没有开启性能记录时返回nullptr
+ */
+DAWorkFlowProfiler::SharedPointer DAWorkFlowExecuter::getProfiler() const
+{
+    return d_ptr->mProfiler;
+}
+
+/**
+ * @brief 设置流式连线的数据流容量
+ *
+ * 并行执行时，流式输出（@ref DAAbstractNode::setOutputStreaming ）的上下游节点同时执行，
+ * 数据流中缓存的批次达到容量后上游节点阻塞，内存占用约为容量乘以批次大小
+ * @param c 小于1时为1
+ */
+void DAWorkFlowExecuter::setStreamCapacity(int c)
+{
+    d_ptr->mStreamCapacity = qMax(1, c);
+}
+
+/**
+ * @brief 流式连线的数据流容量
+ * @return 默认为4
+ */
+int DAWorkFlowExecuter::getStreamCapacity() const
+{
+    return d_ptr->mStreamCapacity;
+}
+
 /**
  * @brief 开始执行节点运算
  *
@@ -212,53 +947,87 @@ void DAWorkFlowExecuter::startExecute()
     //! 首先执行注册的prepareStartexec回调
     for (DAWorkFlow::CallbackPrepareStartExecute& fn : d_ptr->mCallbackStart) {
         if (isTerminateRequest()) {
-            emit finished(false);
+            finishExecute(false);
             return;
         }
         if (!fn(this)) {
-            emit finished(false);
+            finishExecute(false);
             return;
         }
     }
 
-    d_ptr->prepareStartExec();
-    if (d_ptr->mStartNode) {
+    if (!d_ptr->prepareStartExec()) {
+        finishExecute(false);
+        return;
+    }
+    const DAWorkFlowExecutePlan::SharedPointer plan = d_ptr->mPlan;
+    const int targetIndex                           = d_ptr->mTargetNode ? plan->indexOf(d_ptr->mTargetNode) : -1;
+    const int startIndex                            = d_ptr->mStartNode ? plan->indexOf(d_ptr->mStartNode) : -1;
+    if (targetIndex >= 0 || d_ptr->mEnableParallel) {
+        QVector< int > readyNodes;
+        if (targetIndex < 0 && startIndex >= 0) {
+            readyNodes.append(startIndex);
+        } else {
+            if (targetIndex >= 0) {
+                // 按需执行，只执行目标节点的上游闭包
+                d_ptr->collectTargetClosure(targetIndex);
+            }
+            // 全局节点只执行不传递，先串行执行
+            for (int i : plan->globalNodes()) {
+                if (isTerminateRequest()) {
+                    finishExecute(false);
+                    return;
+                }
+                executeNodeNotTransmitByIndex(i);
+            }
+            // 孤立节点、开始节点以及全局节点传递后入度已经满足的节点都进入就绪状态
+            for (int i : plan->topologicalOrder()) {
+                if (!plan->isGlobalNode(i) && d_ptr->isInScope(i) && d_ptr->isIndegreeSatisfied(i)) {
+                    readyNodes.append(i);
+                }
+            }
+        }
+        if (!executeParallel(readyNodes)) {
+            finishExecute(false);
+            return;
+        }
+    } else if (startIndex >= 0) {
         // 如果指定了开始节点，就从开始节点开始执行
-        executeNode(d_ptr->mStartNode);
+        executeNodeByIndex(startIndex);
         if (isTerminateRequest()) {
-            emit finished(false);
+            finishExecute(false);
             return;
         }
     } else {
         // 否则自动查找节点开始执行
         // 执行全局节点，全局节点只执行不传递，也就是说执行节点后，节点的连线并不会执行
-        for (const DAAbstractNode::SharedPointer& n : qAsConst(d_ptr->mGlobalNodes)) {
+        for (int i : plan->globalNodes()) {
             if (isTerminateRequest()) {
-                emit finished(false);
+                finishExecute(false);
                 return;
             }
-            executeNodeNotTransmit(n);
+            executeNodeNotTransmitByIndex(i);
         }
         // 开始执行孤立节点
-        for (const DAAbstractNode::SharedPointer& n : qAsConst(d_ptr->mIsolatedNodes)) {
+        for (int i : plan->isolatedNodes()) {
             if (isTerminateRequest()) {
-                emit finished(false);
+                finishExecute(false);
                 return;
             }
-            executeNode(n);
+            executeNodeByIndex(i);
         }
         // 开始执行开始节点
-        for (const DAAbstractNode::SharedPointer& n : qAsConst(d_ptr->mBeginNodes)) {
+        for (int i : plan->beginNodes()) {
             if (isTerminateRequest()) {
-                emit finished(false);
+                finishExecute(false);
                 return;
             }
-            if (!d_ptr->mGlobalNodes.contains(n)) {
+            if (!plan->isGlobalNode(i)) {
                 // 如果开始节点并不是全局节点，正常执行
-                executeNode(n);
+                executeNodeByIndex(i);
             } else {
                 // 既是开始节点也是全局节点，这时候全局节点已经执行并传递了数据，只需执行传递操作
-                d_ptr->transmit(n->getAllOutputLinkInfo());
+                d_ptr->transmit(i);
             }
         }
     }
@@ -266,18 +1035,33 @@ void DAWorkFlowExecuter::startExecute()
     //! 最后执行注册的prepareEndexec回调
     for (DAWorkFlow::CallbackPrepareEndExecute& fn : d_ptr->mCallbackEnd) {
         if (isTerminateRequest()) {
-            emit finished(false);
+            finishExecute(false);
             return;
         }
         if (fn) {
             if (!fn(this)) {
-                emit finished(false);
+                finishExecute(false);
                 return;
             }
         }
     }
 
-    emit finished(true);
+    finishExecute(true);
+}
+
+/**
+ * @brief 结束执行
+ * @param success
+ */
+void DAWorkFlowExecuter::finishExecute(bool success)
+{
+    d_ptr->mMemoryReport.endBytes = processResidentMemory();
+    qInfo() << d_ptr->mMemoryReport.toString();
+    if (d_ptr->mProfiler) {
+        d_ptr->mProfiler->finish();
+        qInfo().noquote() << d_ptr->mProfiler->toString();
+    }
+    emit finished(success);
 }
 
 /**
@@ -318,15 +1102,15 @@ void DAWorkFlowExecuter::terminateRequest()
  */
 void DAWorkFlowExecuter::executeNode(DAAbstractNode::SharedPointer n)
 {
-    qDebug() << tr("execute node, name=%1,type=%2").arg(n->getNodeName(), n->metaData().getNodePrototype());
-    bool state = n->exec();
-    emit nodeExecuteFinished(n, state);
-    // 获取节点的输出
-    QList< DAAbstractNode::LinkInfo > outInfo = n->getAllOutputLinkInfo();
-    // 给输出的节点传参数
-    d_ptr->sendParam(n, outInfo);
-    // 执行输出节点，输出节点的执行要满足入度数量和入度节点链接数量一致才能执行
-    d_ptr->transmit(outInfo);
+    if (!d_ptr->ensurePlan()) {
+        return;
+    }
+    const int i = d_ptr->mPlan->indexOf(n);
+    if (i < 0) {
+        qWarning() << tr("node %1 is not in the execute plan").arg(n->getNodeName());  // cn:节点%1不在执行计划中
+        return;
+    }
+    executeNodeByIndex(i);
 }
 
 /**
@@ -342,12 +1126,149 @@ void DAWorkFlowExecuter::executeNode(DAAbstractNode::SharedPointer n)
  */
 void DAWorkFlowExecuter::executeNodeNotTransmit(DAAbstractNode::SharedPointer n)
 {
+    if (!d_ptr->ensurePlan()) {
+        return;
+    }
+    const int i = d_ptr->mPlan->indexOf(n);
+    if (i >= 0) {
+        executeNodeNotTransmitByIndex(i);
+    }
+}
+
+/**
+ * @brief 通过执行计划中的索引执行节点，并执行入度满足的下游节点
+ * @param i
+ * @sa executeNode
+ */
+void DAWorkFlowExecuter::executeNodeByIndex(int i)
+{
+    const DAAbstractNode::SharedPointer n = d_ptr->mPlan->node(i);
+    qDebug() << tr("execute node, name=%1,type=%2").arg(n->getNodeName(), n->metaData().getNodePrototype());
+    bool state = d_ptr->execNode(i);
+    emit nodeExecuteFinished(n, state);
+    d_ptr->sampleMemory(i);
+    // 给输出的节点传参数
+    d_ptr->sendParam(i);
+    d_ptr->recordOutputCache(i, state);
+    d_ptr->releaseIntermediateData(i);
+    // 执行输出节点，输出节点的执行要满足入度数量和入度节点链接数量一致才能执行
+    d_ptr->transmit(i);
+}
+
+/**
+ * @brief 通过执行计划中的索引执行节点，只传递参数，不执行下游节点
+ * @param i
+ * @sa executeNodeNotTransmit
+ */
+void DAWorkFlowExecuter::executeNodeNotTransmitByIndex(int i)
+{
+    const DAAbstractNode::SharedPointer n = d_ptr->mPlan->node(i);
     qDebug() << tr("execute node(not transmit), name=%1,type=%2").arg(n->getNodeName(), n->metaData().getNodePrototype());
-    bool state = n->exec();
+    bool state = d_ptr->execNode(i);
     emit nodeExecuteFinished(n, state);
-    // 获取节点的输出
-    QList< DAAbstractNode::LinkInfo > outInfo = n->getAllOutputLinkInfo();
+    d_ptr->sampleMemory(i);
     // 给输出的节点传参数
-    d_ptr->sendParam(n, outInfo);
+    d_ptr->sendParam(i);
+    d_ptr->recordOutputCache(i, state);
+    d_ptr->releaseIntermediateData(i);
+}
+
+/**
+ * @brief 并行执行
+ *
+ * 以readyNodes作为就绪队列，线程安全的节点投递到线程池，非线程安全的节点直接在执行器线程执行
+ * （没有开启并行执行时，所有节点都在执行器线程中按拓扑顺序执行），
+ * 节点执行完成后在执行器线程中传递参数，入度满足的后续节点加入就绪队列，
+ * 这样@ref executeNode 注释中[2.1]和[3.1]这类相互独立的分支可以同时执行
+ *
+ * 有流式输出的节点在投递到线程池前先创建有界数据流，下游节点随即进入就绪状态，和上游节点同时执行，
+ * 通过数据流同时执行的节点各自额外占用一个线程，不会因为线程池已满而互相等待
+ * @param readyNodes 初始就绪的节点索引
+ * @return 如果被终止返回false
+ */
+bool DAWorkFlowExecuter::executeParallel(const QVector< int >& readyNodes)
+{
+    const DAWorkFlowExecutePlan::SharedPointer plan = d_ptr->mPlan;
+    d_ptr->mThreadPool.setMaxThreadCount(d_ptr->mMaxThreadCount);
+    QVector< int > readys = readyNodes;
+    int readyPos          = 0;
+    // 避免同一节点通过多条链接被重复调度
+    QVector< char >& scheduled = d_ptr->mExecuted;
+    for (int i : qAsConst(readys)) {
+        scheduled[ i ] = 1;
+    }
+    int runningCount = 0;
+    int streamCount  = 0;
+    // 把入度满足的后续节点加入就绪队列
+    auto scheduleSatisfied = [ this, &plan, &readys, &scheduled ](int i) {
+        for (int s = plan->slotBegin(i); s < plan->slotEnd(i); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = plan->outputSlot(s);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const int t = plan->edge(e).target;
+                if (!scheduled[ t ] && d_ptr->isInScope(t) && d_ptr->isIndegreeSatisfied(t)) {
+                    scheduled[ t ] = 1;
+                    readys.append(t);
+                }
+            }
+        }
+    };
+    // 节点完成后的处理：传参并把入度满足的后续节点加入就绪队列
+    auto onNodeFinished = [ this, &plan, &scheduleSatisfied ](int i, bool state) {
+        emit nodeExecuteFinished(plan->node(i), state);
+        d_ptr->sampleMemory(i);
+        d_ptr->sendParam(i);
+        d_ptr->recordOutputCache(i, state);
+        d_ptr->releaseIntermediateData(i);
+        scheduleSatisfied(i);
+    };
+    while (true) {
+        while (readyPos < readys.size() && !isTerminateRequest()) {
+            const int i                           = readys[ readyPos++ ];
+            const DAAbstractNode::SharedPointer n = plan->node(i);
+            qDebug() << tr("execute node(parallel), name=%1,type=%2").arg(n->getNodeName(), n->metaData().getNodePrototype());
+            if (d_ptr->isOutputCacheHit(i)) {
+                // 复用上次的输出，无需投递到线程池
+                d_ptr->recordCacheHit(i);
+                onNodeFinished(i, true);
+            } else if (d_ptr->mEnableParallel && n->metaData().isThreadSafe()) {
+                if (n->hasStreamingOutput()) {
+                    const bool concurrent = d_ptr->isStreamConcurrent(i);
+                    d_ptr->openOutputStreams(i, concurrent ? static_cast< std::size_t >(d_ptr->mStreamCapacity) : 0);
+                    if (concurrent) {
+                        // 下游节点不等待本节点执行完成
+                        scheduleSatisfied(i);
+                    }
+                }
+                if (d_ptr->mStreamNodes[ i ]) {
+                    ++streamCount;
+                    d_ptr->mThreadPool.setMaxThreadCount(d_ptr->mMaxThreadCount + streamCount);
+                }
+                ++runningCount;
+                d_ptr->mThreadPool.start(new DAWorkFlowNodeRunnable(n, i, &(d_ptr->mFinishedQueue), d_ptr->mProfiler.get()));
+            } else {
+                if (n->hasStreamingOutput()) {
+                    d_ptr->openOutputStreams(i, 0);
+                }
+                bool state = d_ptr->runNode(n);
+                onNodeFinished(i, state);
+            }
+        }
+        if (0 == runningCount) {
+            break;
+        }
+        // 等待线程池中任意一个节点执行完成
+        QPair< int, bool > res = d_ptr->mFinishedQueue.get();
+        --runningCount;
+        if (d_ptr->mStreamNodes[ res.first ]) {
+            --streamCount;
+            d_ptr->mThreadPool.setMaxThreadCount(d_ptr->mMaxThreadCount + streamCount);
+        }
+        if (isTerminateRequest()) {
+            // 终止时不再传递，只需等待正在执行的节点结束
+            continue;
+        }
+        onNodeFinished(res.first, res.second);
+    }
+    return !isTerminateRequest();
 }
 }  // end of namespace DA
@@ -3,6 +3,8 @@
 #include <QObject>
 #include "DAWorkFlowGlobal.h"
 #include "DAAbstractNode.h"
+#include "DAWorkFlowExecutePlan.h"
+#include "DAWorkFlowProfiler.h"
 
 namespace DA
 {
@@ -13,19 +15,65 @@ class DAWORKFLOW_API DAWorkFlowExecuter : public QObject
 {
     Q_OBJECT
     DA_DECLARE_PRIVATE(DAWorkFlowExecuter)
+public:
+    /**
+     * @brief 一次执行的内存报告
+     *
+     * 内存为进程的常驻内存（字节），在每个节点执行完成、释放中间数据之前采样，小于0代表当前平台无法获取
+     */
+    struct DAWORKFLOW_API MemoryReport
+    {
+        qint64 startBytes { -1 };     ///< 开始执行时的内存
+        qint64 peakBytes { -1 };      ///< 执行过程中采样到的内存峰值
+        qint64 endBytes { -1 };       ///< 执行结束时的内存
+        QString peakNodeName;         ///< 出现峰值时刚执行完成的节点
+        int releasedDataCount { 0 };  ///< 提前释放的输入输出数据数量
+        bool isValid() const;
+        QString toString() const;
+    };
+
 public:
     DAWorkFlowExecuter(QObject* p = nullptr);
     ~DAWorkFlowExecuter();
     //设置查询的开始点
     void setStartNode(DAAbstractNode::SharedPointer n);
+    //设置目标节点，设置后只执行目标节点及其所有上游节点
+    void setTargetNode(DAAbstractNode::SharedPointer n);
     //设置workflow
     void setWorkFlow(DAWorkFlow* wf);
+    //设置执行计划，没有设置时在开始执行时编译
+    void setExecutePlan(DAWorkFlowExecutePlan::SharedPointer plan);
+    DAWorkFlowExecutePlan::SharedPointer getExecutePlan() const;
     //获取全局节点
     QList< DAAbstractNode::SharedPointer > getGlobalNodes() const;
     //获取孤立节点
     QList< DAAbstractNode::SharedPointer > getIsolatedNodesNodes() const;
     //判断是否在请求结束
     bool isTerminateRequest() const;
+    //是否开启并行执行
+    void setEnableParallelExecute(bool on);
+    bool isEnableParallelExecute() const;
+    //并行执行的最大线程数
+    void setMaxThreadCount(int c);
+    int getMaxThreadCount() const;
+    //是否开启增量执行
+    void setEnableIncrementalExecute(bool on);
+    bool isEnableIncrementalExecute() const;
+    //是否提前释放中间数据，节点的输出传递完成后释放输出，节点执行完成后释放输入
+    void setEnableReleaseIntermediateData(bool on);
+    bool isEnableReleaseIntermediateData() const;
+    //最近一次执行的内存报告
+    MemoryReport getMemoryReport() const;
+    //进程的常驻内存（字节），无法获取时返回-1
+    static qint64 processResidentMemory();
+    //流式连线的数据流容量（批次数）
+    void setStreamCapacity(int c);
+    int getStreamCapacity() const;
+    //是否记录节点的性能
+    void setEnableProfile(bool on);
+    bool isEnableProfile() const;
+    //最近一次执行的性能记录，没有开启时返回nullptr
+    DAWorkFlowProfiler::SharedPointer getProfiler() const;
 public slots:
     //开始执行
     void startExecute();
@@ -48,6 +96,13 @@ signals:
     void finished(bool success);
 
 private:
+    //结束执行，记录内存报告并发射finished信号
+    void finishExecute(bool success);
+    //通过执行计划的索引执行节点
+    void executeNodeByIndex(int i);
+    void executeNodeNotTransmitByIndex(int i);
+    //并行执行，从readyNodes开始，按入度调度后续节点
+    bool executeParallel(const QVector< int >& readyNodes);
 };
 
 }  // end of namespace DA
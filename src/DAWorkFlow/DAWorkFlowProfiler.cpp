@@ -0,0 +1,347 @@
+﻿#include "DAWorkFlowProfiler.h"
+#include <algorithm>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMetaType>
+#include <QMutexLocker>
+#include <QObject>
+#include <QStringList>
+#include <QThread>
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace DA
+{
+/**
+ * @brief 数据大小估算函数的注册表
+ */
+static QMutex& profiler_estimator_mutex()
+{
+    static QMutex s_mutex;
+    return s_mutex;
+}
+
+static QHash< int, DAWorkFlowProfiler::FpSizeEstimator >& profiler_estimators()
+{
+    static QHash< int, DAWorkFlowProfiler::FpSizeEstimator > s_estimators;
+    return s_estimators;
+}
+
+//===================================================
+// DANodeProfile
+//===================================================
+
+qint64 DANodeProfile::nativeUs() const
+{
+    return qMax< qint64 >(0, wallUs - scriptUs);
+}
+
+//===================================================
+// DAWorkFlowProfiler
+//===================================================
+DAWorkFlowProfiler::DAWorkFlowProfiler()
+{
+}
+
+DAWorkFlowProfiler::~DAWorkFlowProfiler()
+{
+}
+
+void DAWorkFlowProfiler::start()
+{
+    QMutexLocker locker(&mMutex);
+    mProfiles.clear();
+    mTotalUs = 0;
+    mTimer.start();
+}
+
+void DAWorkFlowProfiler::finish()
+{
+    mTotalUs = elapsedUs();
+}
+
+qint64 DAWorkFlowProfiler::elapsedUs() const
+{
+    return mTimer.isValid() ? mTimer.nsecsElapsed() / 1000 : 0;
+}
+
+/**
+ * @brief 记录
+ *
+ * 并行执行时在线程池的线程中调用
+ * @param p
+ */
+void DAWorkFlowProfiler::record(const DANodeProfile& p)
+{
+    QMutexLocker locker(&mMutex);
+    mProfiles.append(p);
+}
+
+QList< DANodeProfile > DAWorkFlowProfiler::getProfiles() const
+{
+    QMutexLocker locker(&mMutex);
+    return mProfiles;
+}
+
+/**
+ * @brief 每个节点累计的墙钟时间
+ *
+ * 复用输出的节点时间为0，同一节点在一次执行中被多次执行时累加
+ * @return
+ */
+QHash< uint64_t, qint64 > DAWorkFlowProfiler::getNodeWallTimes() const
+{
+    QMutexLocker locker(&mMutex);
+    QHash< uint64_t, qint64 > res;
+    for (const DANodeProfile& p : mProfiles) {
+        res[ p.nodeId ] += p.wallUs;
+    }
+    return res;
+}
+
+/**
+ * @brief 总时间
+ * @return 没有调用@ref finish 时返回从开始到现在的时间
+ */
+qint64 DAWorkFlowProfiler::getTotalWallUs() const
+{
+    return mTotalUs > 0 ? mTotalUs : elapsedUs();
+}
+
+/**
+ * @brief 转换为chrome trace格式的json
+ *
+ * 每次节点执行对应一个完整事件（ph=X），tid为执行线程，并行执行的节点在时间线上按线程分行显示，
+ * args中记录cpu时间、脚本时间和数据大小
+ * @return
+ */
+QByteArray DAWorkFlowProfiler::toChromeTrace() const
+{
+    const QList< DANodeProfile > profiles = getProfiles();
+    QJsonArray events;
+    QHash< quint64, int > threadIndex;
+    for (const DANodeProfile& p : profiles) {
+        if (!threadIndex.contains(p.threadId)) {
+            const int idx = threadIndex.size();
+            threadIndex.insert(p.threadId, idx);
+            QJsonObject meta;
+            meta[ "name" ] = "thread_name";
+            meta[ "ph" ]   = "M";
+            meta[ "pid" ]  = 1;
+            meta[ "tid" ]  = idx;
+            QJsonObject args;
+            args[ "name" ] = (0 == idx) ? QStringLiteral("executer") : QStringLiteral("worker-%1").arg(idx);
+            meta[ "args" ] = args;
+            events.append(meta);
+        }
+        QJsonObject e;
+        e[ "name" ] = p.nodeName;
+        e[ "cat" ]  = p.cacheHit ? QStringLiteral("cache") : QStringLiteral("node");
+        e[ "ph" ]   = "X";
+        e[ "ts" ]   = p.startUs;
+        e[ "dur" ]  = p.wallUs;
+        e[ "pid" ]  = 1;
+        e[ "tid" ]  = threadIndex.value(p.threadId);
+        QJsonObject args;
+        args[ "prototype" ]    = p.prototype;
+        args[ "id" ]           = QString::number(p.nodeId);
+        args[ "success" ]      = p.success;
+        args[ "cpu_us" ]       = p.cpuUs;
+        args[ "script_us" ]    = p.scriptUs;
+        args[ "native_us" ]    = p.nativeUs();
+        args[ "input_bytes" ]  = p.inputBytes;
+        args[ "output_bytes" ] = p.outputBytes;
+        e[ "args" ]            = args;
+        events.append(e);
+    }
+    QJsonObject root;
+    root[ "traceEvents" ]     = events;
+    root[ "displayTimeUnit" ] = "ms";
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
+
+/**
+ * @brief 保存chrome trace
+ * @param path
+ * @return
+ */
+bool DAWorkFlowProfiler::saveChromeTrace(const QString& path) const
+{
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+    return f.write(toChromeTrace()) >= 0;
+}
+
+/**
+ * @brief 耗时最多的若干节点
+ * @param topCount
+ * @return
+ */
+QString DAWorkFlowProfiler::toString(int topCount) const
+{
+    QList< DANodeProfile > profiles = getProfiles();
+    std::sort(profiles.begin(), profiles.end(), [](const DANodeProfile& a, const DANodeProfile& b) {
+        return a.wallUs > b.wallUs;
+    });
+    const double total = qMax< qint64 >(1, getTotalWallUs());
+    QStringList lines;
+    lines.append(QObject::tr("workflow execute %1 ms,%2 nodes").arg(total / 1000.0, 0, 'f', 1).arg(profiles.size()));  // cn:工作流执行%1毫秒，%2个节点
+    for (int i = 0; i < profiles.size() && i < topCount; ++i) {
+        const DANodeProfile& p = profiles[ i ];
+        lines.append(QStringLiteral("  %1: %2 ms (%3%), cpu %4 ms, script %5 ms")
+                         .arg(p.nodeName)
+                         .arg(p.wallUs / 1000.0, 0, 'f', 1)
+                         .arg(100.0 * p.wallUs / total, 0, 'f', 1)
+                         .arg(p.cpuUs / 1000.0, 0, 'f', 1)
+                         .arg(p.scriptUs / 1000.0, 0, 'f', 1));
+    }
+    return lines.join('\n');
+}
+
+/**
+ * @brief 当前线程的cpu时间
+ *
+ * 和墙钟时间对比可以看出节点是在计算还是在等待（io、锁、数据流）
+ * @return 微秒，无法获取返回-1
+ */
+qint64 DAWorkFlowProfiler::currentThreadCpuTimeUs()
+{
+#if defined(Q_OS_WIN)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        return -1;
+    }
+    auto toUs = [](const FILETIME& ft) -> qint64 {
+        // FILETIME单位为100纳秒
+        return ((static_cast< qint64 >(ft.dwHighDateTime) << 32) | ft.dwLowDateTime) / 10;
+    };
+    return toUs(kernelTime) + toUs(userTime);
+#elif defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    if (0 != clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts)) {
+        return -1;
+    }
+    return static_cast< qint64 >(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#else
+    return -1;
+#endif
+}
+
+quint64 DAWorkFlowProfiler::currentThreadId()
+{
+    return static_cast< quint64 >(reinterpret_cast< quintptr >(QThread::currentThreadId()));
+}
+
+/**
+ * @brief 累计当前线程的脚本时间
+ * @param us
+ * @sa ScriptScope
+ */
+void DAWorkFlowProfiler::addScriptTime(qint64 us)
+{
+    DAScriptTimeScope::addTime(us);
+}
+
+qint64 DAWorkFlowProfiler::takeScriptTime()
+{
+    return DAScriptTimeScope::takeTime();
+}
+
+/**
+ * @brief 注册数据大小估算函数
+ *
+ * 例如注册dataframe的估算函数：
+ * @code
+ * DAWorkFlowProfiler::registerSizeEstimator(qMetaTypeId< DAPyDataFrame >(), [](const QVariant& v) -> qint64 {
+ *     ...
+ * });
+ * @endcode
+ * @param metaTypeId
+ * @param fn 为空时取消注册
+ */
+void DAWorkFlowProfiler::registerSizeEstimator(int metaTypeId, DAWorkFlowProfiler::FpSizeEstimator fn)
+{
+    QMutexLocker locker(&profiler_estimator_mutex());
+    if (fn) {
+        profiler_estimators().insert(metaTypeId, fn);
+    } else {
+        profiler_estimators().remove(metaTypeId);
+    }
+}
+
+/**
+ * @brief 估算数据大小
+ *
+ * 只是估算数据本身占用的字节数，不包含容器的额外开销
+ * @param v
+ * @return 无法估算返回-1
+ */
+qint64 DAWorkFlowProfiler::estimateSize(const QVariant& v)
+{
+    if (!v.isValid()) {
+        return 0;
+    }
+    const int type = v.userType();
+    FpSizeEstimator fn;
+    {
+        QMutexLocker locker(&profiler_estimator_mutex());
+        fn = profiler_estimators().value(type);
+    }
+    if (fn) {
+        // 估算函数可能要获取gil，不能在持有锁时调用
+        return fn(v);
+    }
+    switch (type) {
+    case QMetaType::QByteArray:
+        return v.toByteArray().size();
+    case QMetaType::QString:
+        return v.toString().size() * static_cast< qint64 >(sizeof(QChar));
+    case QMetaType::QStringList: {
+        qint64 s = 0;
+        for (const QString& str : v.toStringList()) {
+            s += str.size() * static_cast< qint64 >(sizeof(QChar));
+        }
+        return s;
+    }
+    case QMetaType::QVariantList: {
+        qint64 s = 0;
+        for (const QVariant& i : v.toList()) {
+            const qint64 is = estimateSize(i);
+            if (is < 0) {
+                return -1;
+            }
+            s += is;
+        }
+        return s;
+    }
+    case QMetaType::QVariantMap: {
+        qint64 s = 0;
+        const QVariantMap m = v.toMap();
+        for (auto ite = m.cbegin(); ite != m.cend(); ++ite) {
+            const qint64 is = estimateSize(ite.value());
+            if (is < 0) {
+                return -1;
+            }
+            s += is + ite.key().size() * static_cast< qint64 >(sizeof(QChar));
+        }
+        return s;
+    }
+    default:
+        break;
+    }
+    if (type < QMetaType::User) {
+        // 内置的值类型
+        const int s = QMetaType(type).sizeOf();
+        return s > 0 ? s : -1;
+    }
+    return -1;
+}
+
+}  // end of namespace DA
@@ -0,0 +1,109 @@
+﻿#ifndef DAWORKFLOWPROFILER_H
+#define DAWORKFLOWPROFILER_H
+#include <memory>
+#include <functional>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QVariant>
+#include "DAWorkFlowGlobal.h"
+#include "DAScriptTimeScope.h"
+
+namespace DA
+{
+/**
+ * @brief 一个节点一次执行的性能记录
+ *
+ * 时间单位都是微秒，开始时间相对于执行开始的时刻
+ */
+struct DAWORKFLOW_API DANodeProfile
+{
+    uint64_t nodeId { 0 };      ///< 节点id
+    QString nodeName;           ///< 节点名
+    QString prototype;          ///< 节点原型
+    qint64 startUs { 0 };       ///< 开始时间
+    qint64 wallUs { 0 };        ///< 墙钟时间
+    qint64 cpuUs { -1 };        ///< 执行线程的cpu时间，无法获取时为-1
+    qint64 scriptUs { 0 };      ///< 其中调用脚本（python）的时间，见@ref DAWorkFlowProfiler::ScriptScope
+    quint64 threadId { 0 };     ///< 执行线程id
+    qint64 inputBytes { -1 };   ///< 输入数据的估算字节数，无法估算时为-1
+    qint64 outputBytes { -1 };  ///< 输出数据的估算字节数，无法估算时为-1
+    bool success { false };     ///< 执行是否成功
+    bool cacheHit { false };    ///< 是否复用了上次的输出，复用时没有执行
+    // 非脚本（原生）时间
+    qint64 nativeUs() const;
+};
+
+/**
+ * @brief 工作流执行的性能分析器
+ *
+ * 开启@ref DAWorkFlow::setEnableProfile 后，执行器在每个节点exec前后记录墙钟时间、线程cpu时间、线程id、
+ * 输入输出数据大小以及脚本时间，并行执行时各个线程同时记录，记录函数是线程安全的
+ *
+ * 执行结束后可以：
+ * - 通过@ref saveChromeTrace 导出chrome://tracing或Perfetto可以打开的时间线
+ * - 通过@ref DANodeGraphicsScene::setProfileOverlay 在节点图元上显示耗时热力图
+ *
+ * 脚本时间通过@ref ScriptScope （即@ref DAScriptTimeScope ）记录，DAPyScripts的封装函数都已经计时，
+ * 节点直接调用python时在调用处构造@ref ScriptScope ，分析器把这段时间计入@ref DANodeProfile::scriptUs
+ *
+ * 数据大小通过@ref estimateSize 估算，内置了Qt常用类型，其他类型（如dataframe）通过@ref registerSizeEstimator 注册
+ */
+class DAWORKFLOW_API DAWorkFlowProfiler
+{
+public:
+    using SharedPointer = std::shared_ptr< DAWorkFlowProfiler >;
+    // 数据大小的估算函数，无法估算返回-1
+    using FpSizeEstimator = std::function< qint64(const QVariant&) >;
+
+    // 记录一段脚本执行时间，执行器在节点执行完成后取出当前线程累计的时间
+    using ScriptScope = DAScriptTimeScope;
+
+public:
+    DAWorkFlowProfiler();
+    ~DAWorkFlowProfiler();
+    // 开始计时，清空之前的记录
+    void start();
+    // 结束计时
+    void finish();
+    // 从开始到现在的时间（微秒）
+    qint64 elapsedUs() const;
+    // 记录，线程安全
+    void record(const DANodeProfile& p);
+    // 所有记录，按记录顺序
+    QList< DANodeProfile > getProfiles() const;
+    // 每个节点累计的墙钟时间，key为节点id
+    QHash< uint64_t, qint64 > getNodeWallTimes() const;
+    // 总时间
+    qint64 getTotalWallUs() const;
+    // 转换为chrome trace格式的json
+    QByteArray toChromeTrace() const;
+    // 保存chrome trace
+    bool saveChromeTrace(const QString& path) const;
+    // 耗时最多的若干节点
+    QString toString(int topCount = 10) const;
+
+public:
+    // 当前线程的cpu时间（微秒），无法获取返回-1
+    static qint64 currentThreadCpuTimeUs();
+    // 当前线程id
+    static quint64 currentThreadId();
+    // 累计当前线程的脚本时间
+    static void addScriptTime(qint64 us);
+    // 取出当前线程累计的脚本时间并清零
+    static qint64 takeScriptTime();
+    // 注册数据大小估算函数
+    static void registerSizeEstimator(int metaTypeId, FpSizeEstimator fn);
+    // 估算数据大小
+    static qint64 estimateSize(const QVariant& v);
+
+private:
+    mutable QMutex mMutex;
+    QElapsedTimer mTimer;
+    qint64 mTotalUs { 0 };
+    QList< DANodeProfile > mProfiles;
+};
+
+}  // end of namespace DA
+#endif  // DAWORKFLOWPROFILER_H
@@ -0,0 +1,704 @@
+﻿#include "DAWorkFlowSweep.h"
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <QDebug>
+#include <QDomDocument>
+#include <QPointer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include "DAWorkFlow.h"
+#include "DAWorkFlowExecutePlan.h"
+
+namespace DA
+{
+/**
+ * @brief 在线程池中执行一个变体
+ */
+class DAWorkFlowSweepRunnable : public QRunnable
+{
+public:
+    DAWorkFlowSweepRunnable(std::function< void(int) > fn, int variant) : mFun(fn), mVariant(variant)
+    {
+        setAutoDelete(true);
+    }
+    void run() override
+    {
+        mFun(mVariant);
+    }
+
+private:
+    std::function< void(int) > mFun;
+    int mVariant;
+};
+
+class DAWorkFlowSweep::PrivateData
+{
+    DA_DECLARE_PUBLIC(DAWorkFlowSweep)
+public:
+    PrivateData(DAWorkFlowSweep* p);
+    // 在主线程中分析执行计划并克隆变体节点
+    bool prepare();
+    // 在扫描线程中执行
+    void run();
+    // 执行公共前缀
+    bool runPrefix();
+    // 执行一个变体
+    void runVariant(int v);
+    // 变体对应的参数取值
+    QList< QVariant > combination(int v) const;
+    // 克隆节点
+    DAAbstractNode::SharedPointer cloneNode(const DAAbstractNode::SharedPointer& n) const;
+    // 执行节点
+    static bool runNode(const DAAbstractNode::SharedPointer& n);
+
+public:
+    QPointer< DAWorkFlow > mWorkflow;
+    QList< DAWorkFlowSweep::Parameter > mParams;
+    QList< DAWorkFlowSweep::Output > mOutputs;
+    int mMaxThreadCount { QThread::idealThreadCount() };
+    QVersionNumber mVersion;
+    QThread* mThread { nullptr };
+    std::atomic< bool > mTerminate { false };
+    std::atomic< int > mFinishedCount { 0 };
+    bool mSuccess { false };
+    QString mError;
+    DAWorkFlowExecutePlan::SharedPointer mPlan;
+    QVector< int > mPrefixOrder;  ///< 公共前缀的节点，按拓扑顺序
+    QVector< int > mTailOrder;    ///< 每个变体需要执行的节点，按拓扑顺序
+    QVector< int > mTailPos;      ///< 节点在mTailOrder中的位置，不在尾部为-1
+    QVector< QVector< DAAbstractNode::SharedPointer > > mVariants;  ///< 每个变体克隆的尾部节点，执行完成后释放
+    QVector< QList< QVariant > > mVariantOutputs;                  ///< 每个变体的输出
+    QVector< char > mVariantSuccess;                                ///< 每个变体是否执行成功
+    bool mVariantConcurrent { false };                              ///< 变体能否同时执行
+    QStringList mColumnNames;
+    DATable< QVariant > mResult;
+};
+
+//===================================================
+// DAWorkFlowSweep::Parameter
+//===================================================
+QString DAWorkFlowSweep::Parameter::name() const
+{
+    return QString("%1.%2").arg(node ? node->getNodeName() : QString(), propertyKey);
+}
+
+QString DAWorkFlowSweep::Output::name() const
+{
+    return QString("%1.%2").arg(node ? node->getNodeName() : QString(), outputKey);
+}
+
+//===================================================
+// DAWorkFlowSweep::PrivateData
+//===================================================
+DAWorkFlowSweep::PrivateData::PrivateData(DAWorkFlowSweep* p) : q_ptr(p)
+{
+}
+
+/**
+ * @brief 分析执行计划并克隆变体节点
+ *
+ * 被扫描节点的下游闭包和输出节点的上游闭包的交集是尾部，上游闭包的其余部分是公共前缀。
+ * 全局节点和执行器中一样总是执行，不受参数影响的全局节点放在公共前缀的最前面。
+ * 节点的创建可能依赖工厂的状态，因此克隆在主线程中完成
+ * @return
+ */
+bool DAWorkFlowSweep::PrivateData::prepare()
+{
+    mError.clear();
+    mPrefixOrder.clear();
+    mTailOrder.clear();
+    mVariants.clear();
+    mVariantOutputs.clear();
+    mVariantSuccess.clear();
+    mResult.clear();
+    mColumnNames.clear();
+    if (!mWorkflow) {
+        mError = DAWorkFlowSweep::tr("workflow is null");  // cn:工作流为空
+        return false;
+    }
+    if (mWorkflow->isRunning()) {
+        mError = DAWorkFlowSweep::tr("workflow is running");  // cn:工作流正在执行
+        return false;
+    }
+    if (mParams.isEmpty() || mOutputs.isEmpty()) {
+        mError = DAWorkFlowSweep::tr("sweep needs at least one parameter and one output");  // cn:扫描至少需要一个参数和一个输出
+        return false;
+    }
+    mPlan = mWorkflow->getExecutePlan();
+    if (!mPlan) {
+        mError = DAWorkFlowSweep::tr("workflow can not be compiled");  // cn:工作流无法编译
+        return false;
+    }
+    const int n = mPlan->nodeCount();
+    // 尾部：被扫描节点的下游闭包
+    QVector< char > affected(n, 0);
+    QVector< int > stack;
+    for (const DAWorkFlowSweep::Parameter& p : qAsConst(mParams)) {
+        const int i = mPlan->indexOf(p.node);
+        if (i < 0 || p.values.isEmpty()) {
+            mError = DAWorkFlowSweep::tr("parameter %1 is invalid").arg(p.name());  // cn:参数%1无效
+            return false;
+        }
+        stack.append(i);
+    }
+    while (!stack.isEmpty()) {
+        const int i = stack.takeLast();
+        if (affected[ i ]) {
+            continue;
+        }
+        affected[ i ] = 1;
+        for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                stack.append(mPlan->edge(e).target);
+            }
+        }
+    }
+    // 计算输出所需的节点：输出节点的上游闭包
+    QVector< char > needed(n, 0);
+    for (const DAWorkFlowSweep::Output& o : qAsConst(mOutputs)) {
+        const int i = mPlan->indexOf(o.node);
+        if (i < 0) {
+            mError = DAWorkFlowSweep::tr("output %1 is invalid").arg(o.name());  // cn:输出%1无效
+            return false;
+        }
+        stack.append(i);
+    }
+    while (!stack.isEmpty()) {
+        const int i = stack.takeLast();
+        if (needed[ i ]) {
+            continue;
+        }
+        needed[ i ] = 1;
+        for (int k = mPlan->inputBegin(i); k < mPlan->inputEnd(i); ++k) {
+            stack.append(mPlan->inputNode(k));
+        }
+    }
+    // 全局节点和执行器中一样都要执行（例如设置全局状态的节点），即使输出不依赖它们
+    for (int i : mPlan->globalNodes()) {
+        needed[ i ] = 1;
+    }
+    mTailPos.fill(-1, n);
+    // 不受参数影响的全局节点在公共前缀的最前面执行
+    for (int i : mPlan->globalNodes()) {
+        if (!affected[ i ]) {
+            mPrefixOrder.append(i);
+        }
+    }
+    bool concurrent = true;
+    for (int i : mPlan->topologicalOrder()) {
+        if (!needed[ i ]) {
+            continue;
+        }
+        const DAAbstractNode::SharedPointer& node = mPlan->node(i);
+        if (node->hasStreamingOutput()) {
+            mError = DAWorkFlowSweep::tr("node %1 has streaming output,which is not supported by sweep").arg(node->getNodeName());  // cn:节点%1有流式输出，参数扫描不支持流式输出
+            return false;
+        }
+        if (affected[ i ]) {
+            mTailPos[ i ] = mTailOrder.size();
+            mTailOrder.append(i);
+            // python节点同时执行只会在GIL上排队，依次执行
+            concurrent &= node->metaData().isThreadSafe() && !node->metaData().isUsePython();
+        } else if (!mPlan->isGlobalNode(i)) {
+            mPrefixOrder.append(i);
+        }
+    }
+    if (mTailOrder.isEmpty()) {
+        mError = DAWorkFlowSweep::tr("outputs are not affected by any parameter");  // cn:输出不受任何参数影响
+        return false;
+    }
+    mVariantConcurrent = concurrent && mMaxThreadCount > 1;
+    // 克隆
+    const int variantCount = q_ptr->getVariantCount();
+    mVariants.resize(variantCount);
+    mVariantOutputs.resize(variantCount);
+    mVariantSuccess.fill(0, variantCount);
+    for (int v = 0; v < variantCount; ++v) {
+        QVector< DAAbstractNode::SharedPointer >& clones = mVariants[ v ];
+        clones.reserve(mTailOrder.size());
+        for (int i : qAsConst(mTailOrder)) {
+            DAAbstractNode::SharedPointer c = cloneNode(mPlan->node(i));
+            if (!c) {
+                mError = DAWorkFlowSweep::tr("can not clone node %1").arg(mPlan->node(i)->getNodeName());  // cn:无法克隆节点%1
+                mVariants.clear();
+                return false;
+            }
+            clones.append(c);
+        }
+        const QList< QVariant > values = combination(v);
+        for (int k = 0; k < mParams.size(); ++k) {
+            // 不影响输出的参数对应的节点不会被克隆
+            const int pos = mTailPos[ mPlan->indexOf(mParams[ k ].node) ];
+            if (pos >= 0) {
+                clones[ pos ]->setProperty(mParams[ k ].propertyKey, values[ k ]);
+            }
+        }
+    }
+    for (const DAWorkFlowSweep::Parameter& p : qAsConst(mParams)) {
+        mColumnNames.append(p.name());
+    }
+    for (const DAWorkFlowSweep::Output& o : qAsConst(mOutputs)) {
+        mColumnNames.append(o.name());
+    }
+    mColumnNames.append(QStringLiteral("success"));
+    return true;
+}
+
+/**
+ * @brief 在扫描线程中执行
+ */
+void DAWorkFlowSweep::PrivateData::run()
+{
+    mSuccess = false;
+    if (!runPrefix()) {
+        mVariants.clear();
+        return;
+    }
+    // 公共前缀的输出传递给每个变体
+    for (int i : qAsConst(mPrefixOrder)) {
+        const DAAbstractNode::SharedPointer& src = mPlan->node(i);
+        for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+            const QVariant v                            = src->getOutputData(os.key);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const DAWorkFlowExecutePlan::Edge& edge = mPlan->edge(e);
+                const int pos                           = mTailPos[ edge.target ];
+                if (pos < 0) {
+                    continue;
+                }
+                for (QVector< DAAbstractNode::SharedPointer >& clones : mVariants) {
+                    clones[ pos ]->setInputData(edge.inputKey, v);
+                }
+            }
+        }
+    }
+    const int variantCount = mVariants.size();
+    if (mVariantConcurrent) {
+        QThreadPool pool;
+        pool.setMaxThreadCount(mMaxThreadCount);
+        for (int v = 0; v < variantCount; ++v) {
+            pool.start(new DAWorkFlowSweepRunnable([ this ](int i) { runVariant(i); }, v));
+        }
+        pool.waitForDone();
+    } else {
+        for (int v = 0; v < variantCount && !mTerminate; ++v) {
+            runVariant(v);
+        }
+    }
+    if (mTerminate) {
+        mVariants.clear();
+        return;
+    }
+    // 汇总
+    for (int v = 0; v < variantCount; ++v) {
+        const QList< QVariant > values = combination(v);
+        int col                        = 0;
+        for (const QVariant& pv : values) {
+            mResult.set(v, col++, pv);
+        }
+        for (const QVariant& ov : qAsConst(mVariantOutputs[ v ])) {
+            mResult.set(v, col++, ov);
+        }
+        mResult.set(v, mColumnNames.size() - 1, static_cast< bool >(mVariantSuccess[ v ]));
+    }
+    mVariants.clear();
+    mSuccess = true;
+}
+
+/**
+ * @brief 在原工作流的节点上执行公共前缀
+ * @return
+ */
+bool DAWorkFlowSweep::PrivateData::runPrefix()
+{
+    for (int i : qAsConst(mPrefixOrder)) {
+        if (mTerminate) {
+            return false;
+        }
+        const DAAbstractNode::SharedPointer& n = mPlan->node(i);
+        if (!runNode(n)) {
+            mError = DAWorkFlowSweep::tr("shared node %1 execute failed").arg(n->getNodeName());  // cn:公共节点%1执行失败
+            return false;
+        }
+        for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+            const QVariant v                            = n->getOutputData(os.key);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const DAWorkFlowExecutePlan::Edge& edge = mPlan->edge(e);
+                if (mTailPos[ edge.target ] < 0) {
+                    mPlan->node(edge.target)->setInputData(edge.inputKey, v);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief 执行一个变体
+ *
+ * 并行时在线程池中调用，每个变体只访问自己的克隆节点和结果
+ * @param v
+ */
+void DAWorkFlowSweep::PrivateData::runVariant(int v)
+{
+    QVector< DAAbstractNode::SharedPointer >& clones = mVariants[ v ];
+    bool success                                     = true;
+    for (int pos = 0; pos < mTailOrder.size(); ++pos) {
+        if (mTerminate) {
+            return;
+        }
+        const DAAbstractNode::SharedPointer& c = clones[ pos ];
+        if (!runNode(c)) {
+            qWarning() << DAWorkFlowSweep::tr("sweep variant %1 failed at node %2").arg(v).arg(c->getNodeName());  // cn:扫描变体%1在节点%2执行失败
+            success = false;
+            break;
+        }
+        const int i = mTailOrder[ pos ];
+        for (int s = mPlan->slotBegin(i); s < mPlan->slotEnd(i); ++s) {
+            const DAWorkFlowExecutePlan::OutputSlot& os = mPlan->outputSlot(s);
+            const QVariant d                            = c->getOutputData(os.key);
+            for (int e = os.edgeBegin; e < os.edgeEnd; ++e) {
+                const DAWorkFlowExecutePlan::Edge& edge = mPlan->edge(e);
+                const int tp                            = mTailPos[ edge.target ];
+                if (tp >= 0) {
+                    clones[ tp ]->setInputData(edge.inputKey, d);
+                }
+            }
+        }
+    }
+    QList< QVariant >& outs = mVariantOutputs[ v ];
+    for (const DAWorkFlowSweep::Output& o : qAsConst(mOutputs)) {
+        const int pos = mTailPos[ mPlan->indexOf(o.node) ];
+        outs.append(success ? (pos >= 0 ? clones[ pos ]->getOutputData(o.outputKey) : o.node->getOutputData(o.outputKey))
+                            : QVariant());
+    }
+    mVariantSuccess[ v ] = success ? 1 : 0;
+    // 变体执行完成后即释放克隆节点，同时存在的中间数据不超过同时执行的变体数
+    clones.clear();
+    emit q_ptr->progress(++mFinishedCount, mVariants.size());
+}
+
+/**
+ * @brief 变体对应的参数取值，最后一个参数变化最快
+ * @param v
+ * @return
+ */
+QList< QVariant > DAWorkFlowSweep::PrivateData::combination(int v) const
+{
+    QList< QVariant > res;
+    for (int k = mParams.size() - 1; k >= 0; --k) {
+        const QList< QVariant >& values = mParams[ k ].values;
+        res.prepend(values[ v % values.size() ]);
+        v /= values.size();
+    }
+    return res;
+}
+
+/**
+ * @brief 克隆节点
+ * @param n
+ * @return
+ */
+DAAbstractNode::SharedPointer DAWorkFlowSweep::PrivateData::cloneNode(const DAAbstractNode::SharedPointer& n) const
+{
+    DAAbstractNode::SharedPointer c = mWorkflow->createNode(n->metaData());
+    if (!c) {
+        return nullptr;
+    }
+    c->setNodeName(n->getNodeName());
+    c->propertys() = n->propertys();
+    const QList< QString > inKeys = c->getInputKeys();
+    for (const QString& k : n->getInputKeys()) {
+        if (!inKeys.contains(k)) {
+            c->addInputKey(k);
+        }
+    }
+    const QList< QString > outKeys = c->getOutputKeys();
+    for (const QString& k : n->getOutputKeys()) {
+        if (!outKeys.contains(k)) {
+            c->addOutputKey(k);
+        }
+    }
+    // 未连接的输入是用户设置的
+    const QList< QString > linked = n->getLinkedInputKeys();
+    for (const QString& k : n->getInputKeys()) {
+        if (!linked.contains(k)) {
+            const QVariant v = n->getInputData(k);
+            if (v.isValid()) {
+                c->setInputData(k, v);
+            }
+        }
+    }
+    QDomDocument doc;
+    QDomElement ele = doc.createElement("node");
+    n->saveExternInfoToXml(&doc, &ele, mVersion);
+    c->loadExternInfoFromXml(&ele, mVersion);
+    return c;
+}
+
+bool DAWorkFlowSweep::PrivateData::runNode(const DAAbstractNode::SharedPointer& n)
+{
+    bool state = n->exec();
+    n->closeOutputStreams();
+    n->cancelInputStreams();
+    return state;
+}
+
+//===================================================
+// DAWorkFlowSweep
+//===================================================
+DAWorkFlowSweep::DAWorkFlowSweep(DAWorkFlow* wf, QObject* par) : QObject(par), DA_PIMPL_CONSTRUCT
+{
+    d_ptr->mWorkflow = wf;
+}
+
+/**
+ * @brief 析构时终止并等待扫描线程结束
+ *
+ * 尾部有python节点时，在主线程析构前需要释放GIL，否则扫描线程拿不到GIL无法结束
+ */
+DAWorkFlowSweep::~DAWorkFlowSweep()
+{
+    if (d_ptr->mThread) {
+        d_ptr->mTerminate = true;
+        d_ptr->mThread->wait();
+        delete d_ptr->mThread;
+        d_ptr->mThread = nullptr;
+    }
+}
+
+DAWorkFlow* DAWorkFlowSweep::getWorkflow() const
+{
+    return d_ptr->mWorkflow.data();
+}
+
+void DAWorkFlowSweep::addParameter(const DAWorkFlowSweep::Parameter& p)
+{
+    d_ptr->mParams.append(p);
+}
+
+void DAWorkFlowSweep::clearParameters()
+{
+    d_ptr->mParams.clear();
+}
+
+QList< DAWorkFlowSweep::Parameter > DAWorkFlowSweep::getParameters() const
+{
+    return d_ptr->mParams;
+}
+
+void DAWorkFlowSweep::addOutput(const DAWorkFlowSweep::Output& o)
+{
+    d_ptr->mOutputs.append(o);
+}
+
+void DAWorkFlowSweep::clearOutputs()
+{
+    d_ptr->mOutputs.clear();
+}
+
+QList< DAWorkFlowSweep::Output > DAWorkFlowSweep::getOutputs() const
+{
+    return d_ptr->mOutputs;
+}
+
+/**
+ * @brief 变体数量
+ * @return 没有参数时返回0
+ */
+int DAWorkFlowSweep::getVariantCount() const
+{
+    if (d_ptr->mParams.isEmpty()) {
+        return 0;
+    }
+    int c = 1;
+    for (const Parameter& p : qAsConst(d_ptr->mParams)) {
+        c *= p.values.size();
+    }
+    return c;
+}
+
+/**
+ * @brief 设置同时执行的变体数量
+ * @param c 为1时变体依次执行
+ */
+void DAWorkFlowSweep::setMaxThreadCount(int c)
+{
+    d_ptr->mMaxThreadCount = qMax(1, c);
+}
+
+int DAWorkFlowSweep::getMaxThreadCount() const
+{
+    return d_ptr->mMaxThreadCount;
+}
+
+/**
+ * @brief 设置克隆节点扩展信息时使用的版本号，通常为工程文件的当前版本
+ * @param v
+ */
+void DAWorkFlowSweep::setVersionNumber(const QVersionNumber& v)
+{
+    d_ptr->mVersion = v;
+}
+
+QVersionNumber DAWorkFlowSweep::getVersionNumber() const
+{
+    return d_ptr->mVersion;
+}
+
+bool DAWorkFlowSweep::isRunning() const
+{
+    return d_ptr->mThread != nullptr;
+}
+
+/**
+ * @brief 等待扫描线程结束
+ *
+ * 结束的通知（@ref finished ）仍通过事件循环发出
+ * @param msecs 超时时间
+ * @return 超时返回false
+ */
+bool DAWorkFlowSweep::wait(unsigned long msecs)
+{
+    if (!d_ptr->mThread) {
+        return true;
+    }
+    return d_ptr->mThread->wait(msecs);
+}
+
+/**
+ * @brief 公共前缀的节点数
+ * @return
+ */
+int DAWorkFlowSweep::getSharedNodeCount() const
+{
+    return d_ptr->mPrefixOrder.size();
+}
+
+/**
+ * @brief 每个变体执行的节点数
+ * @return
+ */
+int DAWorkFlowSweep::getVariantNodeCount() const
+{
+    return d_ptr->mTailOrder.size();
+}
+
+/**
+ * @brief 对比表的列名
+ * @return
+ */
+QStringList DAWorkFlowSweep::getResultColumnNames() const
+{
+    return d_ptr->mColumnNames;
+}
+
+/**
+ * @brief 对比表，每个变体一行，执行成功后有效
+ * @return
+ */
+const DATable< QVariant >& DAWorkFlowSweep::getResultTable() const
+{
+    return d_ptr->mResult;
+}
+
+QString DAWorkFlowSweep::getLastErrorString() const
+{
+    return d_ptr->mError;
+}
+
+/**
+ * @brief 解析取值
+ *
+ * - “1,2,5”：逗号分隔的取值
+ * - “0:1:0.25”：从0到1（包含）步长0.25，步长省略时为1
+ *
+ * 能转换为整数的取值为整数，能转换为浮点数的为浮点数，否则为字符串
+ * @param str
+ * @return 解析失败返回空列表
+ */
+QList< QVariant > DAWorkFlowSweep::parseValues(const QString& str)
+{
+    QList< QVariant > res;
+    const QStringList range = str.split(':');
+    if (range.size() == 2 || range.size() == 3) {
+        bool ok1 = false, ok2 = false, ok3 = true;
+        const double start = range[ 0 ].trimmed().toDouble(&ok1);
+        const double stop  = range[ 1 ].trimmed().toDouble(&ok2);
+        const double step  = (range.size() == 3) ? range[ 2 ].trimmed().toDouble(&ok3) : 1.0;
+        if (!ok1 || !ok2 || !ok3 || step == 0.0 || (stop - start) / step < 0) {
+            return res;
+        }
+        bool isInt = true;
+        for (const QString& s : range) {
+            bool ok = false;
+            s.trimmed().toInt(&ok);
+            isInt &= ok;
+        }
+        // 容差避免浮点误差丢掉结束值
+        const int count = static_cast< int >(std::floor((stop - start) / step + 1e-9)) + 1;
+        for (int i = 0; i < count; ++i) {
+            const double v = start + i * step;
+            res.append(isInt ? QVariant(static_cast< int >(std::lround(v))) : QVariant(v));
+        }
+        return res;
+    }
+    const QStringList items = str.split(',', Qt::SkipEmptyParts);
+    for (const QString& item : items) {
+        const QString s = item.trimmed();
+        bool ok         = false;
+        const int i     = s.toInt(&ok);
+        if (ok) {
+            res.append(i);
+            continue;
+        }
+        const double d = s.toDouble(&ok);
+        res.append(ok ? QVariant(d) : QVariant(s));
+    }
+    return res;
+}
+
+/**
+ * @brief 开始扫描
+ *
+ * 克隆在调用线程中完成，公共前缀和变体在扫描线程中执行，结束后发射@ref finished
+ * @return 无法开始返回false，错误信息通过@ref getLastErrorString 获取
+ */
+bool DAWorkFlowSweep::exec()
+{
+    if (isRunning()) {
+        return false;
+    }
+    d_ptr->mTerminate     = false;
+    d_ptr->mFinishedCount = 0;
+    if (!d_ptr->prepare()) {
+        qCritical() << d_ptr->mError;
+        return false;
+    }
+    qInfo() << tr("sweep %1 variants,%2 shared nodes execute once,%3 nodes execute per variant")
+                   .arg(d_ptr->mVariants.size())
+                   .arg(d_ptr->mPrefixOrder.size())
+                   .arg(d_ptr->mTailOrder.size());  // cn:扫描%1个变体，%2个公共节点只执行一次，每个变体执行%3个节点
+    d_ptr->mThread = QThread::create([ this ]() { d_ptr->run(); });
+    connect(d_ptr->mThread, &QThread::finished, this, [ this ]() {
+        d_ptr->mThread->deleteLater();
+        d_ptr->mThread = nullptr;
+        emit finished(d_ptr->mSuccess);
+    });
+    d_ptr->mThread->start();
+    return true;
+}
+
+/**
+ * @brief 终止扫描
+ */
+void DAWorkFlowSweep::terminate()
+{
+    d_ptr->mTerminate = true;
+}
+
+}  // end of namespace DA
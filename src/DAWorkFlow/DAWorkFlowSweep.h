@@ -0,0 +1,123 @@
+﻿#ifndef DAWORKFLOWSWEEP_H
+#define DAWORKFLOWSWEEP_H
+#include <climits>
+#include <QObject>
+#include <QStringList>
+#include <QVersionNumber>
+#include "DAWorkFlowGlobal.h"
+#include "DAAbstractNode.h"
+#include "DATable.hpp"
+
+namespace DA
+{
+class DAWorkFlow;
+
+/**
+ * @brief 工作流的参数扫描
+ *
+ * 对若干节点属性的取值做笛卡尔积，每个组合称为一个变体，所有变体执行完成后把指定节点的输出汇总为一张对比表，
+ * 每个变体一行，列依次为扫描的参数、指定的输出以及执行是否成功
+ *
+ * 变体之间共享不受扫描参数影响的上游节点：
+ * - 被扫描的节点及其所有下游节点是变体需要重新执行的尾部，只有尾部中计算输出所需的节点会被克隆
+ * - 其余计算输出所需的节点是公共前缀，在原工作流的节点上只执行一次，输出以QVariant隐式共享的方式传给所有变体，
+ *   因此节点不应修改输入数据
+ * - 全局节点（@ref DAAbstractNode::GlobalNode ）和执行器中一样总是执行，不受参数影响的全局节点在公共前缀的最前面执行
+ *
+ * 尾部节点都是线程安全（@ref DANodeMetaData::isThreadSafe ）且不使用python（@ref DANodeMetaData::isUsePython ）时
+ * 变体在线程池中同时执行，否则在扫描线程中依次执行：python节点在exec中需要获取GIL，同时执行只会在GIL上排队，
+ * 主线程持有GIL时还会一起阻塞，因此尾部有python节点的扫描总是依次执行
+ *
+ * 扫描线程中的python节点需要主线程释放GIL（事件循环空闲时由DAPyGILIdleRelease释放），
+ * 在主线程中等待扫描结束（@ref wait 、析构）前需要先释放GIL
+ *
+ * 节点的克隆通过工厂创建同原型的节点，复制属性、未连接的输入数据和扩展信息（@ref DAAbstractNode::saveExternInfoToXml ），
+ * 克隆的节点不加入工作流，节点间的数据按执行计划直接传递，不建立连接
+ *
+ * @note 扫描不支持流式输出的节点
+ */
+class DAWORKFLOW_API DAWorkFlowSweep : public QObject
+{
+    Q_OBJECT
+    DA_DECLARE_PRIVATE(DAWorkFlowSweep)
+public:
+    /**
+     * @brief 扫描的参数
+     */
+    struct DAWORKFLOW_API Parameter
+    {
+        DAAbstractNode::SharedPointer node;  ///< 节点
+        QString propertyKey;                 ///< 属性名
+        QList< QVariant > values;            ///< 取值
+        // 列名，格式为“节点名.属性名”
+        QString name() const;
+    };
+
+    /**
+     * @brief 需要汇总的输出
+     */
+    struct DAWORKFLOW_API Output
+    {
+        DAAbstractNode::SharedPointer node;  ///< 节点
+        QString outputKey;                   ///< 输出key
+        // 列名，格式为“节点名.输出key”
+        QString name() const;
+    };
+
+public:
+    DAWorkFlowSweep(DAWorkFlow* wf, QObject* par = nullptr);
+    ~DAWorkFlowSweep();
+    DAWorkFlow* getWorkflow() const;
+    // 扫描的参数
+    void addParameter(const Parameter& p);
+    void clearParameters();
+    QList< Parameter > getParameters() const;
+    // 需要汇总的输出
+    void addOutput(const Output& o);
+    void clearOutputs();
+    QList< Output > getOutputs() const;
+    // 变体数量，也就是所有参数取值数量的乘积
+    int getVariantCount() const;
+    // 同时执行的变体数量
+    void setMaxThreadCount(int c);
+    int getMaxThreadCount() const;
+    // 克隆节点扩展信息时使用的版本号
+    void setVersionNumber(const QVersionNumber& v);
+    QVersionNumber getVersionNumber() const;
+    // 是否正在执行
+    bool isRunning() const;
+    // 等待扫描线程结束，在主线程调用前需要释放GIL
+    bool wait(unsigned long msecs = ULONG_MAX);
+    // 公共前缀的节点数和每个变体的节点数，执行后有效
+    int getSharedNodeCount() const;
+    int getVariantNodeCount() const;
+    // 对比表
+    QStringList getResultColumnNames() const;
+    const DATable< QVariant >& getResultTable() const;
+    // 错误信息
+    QString getLastErrorString() const;
+    // 解析取值，支持“1,2,5”以及“开始:结束:步长”的格式
+    static QList< QVariant > parseValues(const QString& str);
+public slots:
+    // 开始扫描，无法开始返回false
+    bool exec();
+    // 终止，正在执行的变体执行完当前节点后停止
+    void terminate();
+signals:
+    /**
+     * @brief 变体执行进度
+     *
+     * 在扫描线程或线程池的线程中发射，连接时应使用队列连接（Qt::QueuedConnection）
+     * @param finishedCount 已完成的变体数量
+     * @param totalCount 变体总数
+     */
+    void progress(int finishedCount, int totalCount);
+
+    /**
+     * @brief 扫描结束
+     * @param success 公共前缀执行失败或者被终止时为false，单个变体失败只记录在对比表中
+     */
+    void finished(bool success);
+};
+}  // end of namespace DA
+#endif  // DAWORKFLOWSWEEP_H
@@ -0,0 +1,54 @@
+﻿#include "DAStandardNodeBatchCollect.h"
+namespace DA
+{
+
+DAStandardNodeBatchCollect::DAStandardNodeBatchCollect() : DAStandardNodeInputOutput()
+{
+	metaData().setNodePrototype("DA.BatchCollect");
+	metaData().setGroup(u8"stream");
+	metaData().setNodeName(u8"Batch Collect");
+	metaData().setThreadSafe(true);
+	addInputKey("batch");
+	addOutputKey("value");
+}
+
+DAStandardNodeBatchCollect::~DAStandardNodeBatchCollect()
+{
+}
+
+/**
+ * @brief 读取批次并合并
+ *
+ * 列表批次展开合并，其它批次作为一个元素，读满@ref getMaxBatchCount 个批次后提前结束，
+ * 执行器随后取消输入流，上游不再阻塞
+ * @return
+ */
+bool DAStandardNodeBatchCollect::exec()
+{
+	const int maxCount = getMaxBatchCount();
+	QVariantList res;
+	QVariant batch;
+	int count = 0;
+	while ((maxCount <= 0 || count < maxCount) && readInputBatch("batch", batch)) {
+		if (batch.canConvert< QVariantList >()) {
+			res.append(batch.toList());
+		} else {
+			res.append(batch);
+		}
+		++count;
+	}
+	setOutputData("value", res);
+	return true;
+}
+
+void DAStandardNodeBatchCollect::setMaxBatchCount(int c)
+{
+	setProperty("max-batch-count", qMax(0, c));
+}
+
+int DAStandardNodeBatchCollect::getMaxBatchCount() const
+{
+	return getProperty("max-batch-count", 0).toInt();
+}
+
+}
@@ -0,0 +1,24 @@
+﻿#ifndef DASTANDARDNODEBATCHCOLLECT_H
+#define DASTANDARDNODEBATCHCOLLECT_H
+#include "DAStandardNodeInputOutput.h"
+namespace DA
+{
+/**
+ * @brief 合批节点
+ *
+ * 逐批读取输入“batch”，合并为一个列表从“value”输出，是流式输出的消费者节点，
+ * 输入为普通输出时，整个输入作为一个批次
+ */
+class DAWORKFLOW_API DAStandardNodeBatchCollect : public DAStandardNodeInputOutput
+{
+public:
+	DAStandardNodeBatchCollect();
+	~DAStandardNodeBatchCollect();
+	// 运行
+	virtual bool exec() override;
+	// 最多读取的批次数量，0代表全部读取
+	void setMaxBatchCount(int c);
+	int getMaxBatchCount() const;
+};
+}
+#endif  // DASTANDARDNODEBATCHCOLLECT_H
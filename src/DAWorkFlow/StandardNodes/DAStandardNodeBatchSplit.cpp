@@ -0,0 +1,67 @@
+﻿#include "DAStandardNodeBatchSplit.h"
+namespace DA
+{
+
+DAStandardNodeBatchSplit::DAStandardNodeBatchSplit() : DAStandardNodeInputOutput()
+{
+	metaData().setNodePrototype("DA.BatchSplit");
+	metaData().setGroup(u8"stream");
+	metaData().setNodeName(u8"Batch Split");
+	metaData().setThreadSafe(true);
+	addInputKey("value");
+	addOutputKey("batch");
+	setOutputStreaming("batch");
+	setBatchSize(1024);
+}
+
+DAStandardNodeBatchSplit::~DAStandardNodeBatchSplit()
+{
+}
+
+/**
+ * @brief 逐批写入输入的列表
+ *
+ * 下游不再读取时（@ref writeOutputBatch 返回false）停止拆分，这不是错误
+ * @return
+ */
+bool DAStandardNodeBatchSplit::exec()
+{
+	mWrittenBatchCount  = 0;
+	const int batchSize = getBatchSize();
+	QVariant in;
+	while (readInputBatch("value", in)) {
+		const QVariantList values = in.canConvert< QVariantList >() ? in.toList() : QVariantList { in };
+		for (int i = 0; i < values.size(); i += batchSize) {
+			if (!writeOutputBatch("batch", values.mid(i, batchSize))) {
+				return true;
+			}
+			++mWrittenBatchCount;
+		}
+	}
+	return true;
+}
+
+/**
+ * @brief 设置每批的元素个数
+ * @param s 小于1时按1处理
+ */
+void DAStandardNodeBatchSplit::setBatchSize(int s)
+{
+	setProperty("batch-size", qMax(1, s));
+}
+
+int DAStandardNodeBatchSplit::getBatchSize() const
+{
+	return qMax(1, getProperty("batch-size", 1024).toInt());
+}
+
+/**
+ * @brief 上次执行写入的批次数量，下游提前结束时小于输入的批次数量
+ * @return
+ */
+int DAStandardNodeBatchSplit::getWrittenBatchCount() const
+{
+	return mWrittenBatchCount;
+}
+
+}
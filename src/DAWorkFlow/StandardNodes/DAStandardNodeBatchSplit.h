@@ -0,0 +1,29 @@
+﻿#ifndef DASTANDARDNODEBATCHSPLIT_H
+#define DASTANDARDNODEBATCHSPLIT_H
+#include "DAStandardNodeInputOutput.h"
+namespace DA
+{
+/**
+ * @brief 分批节点
+ *
+ * 把输入的列表按批次大小拆分（不是列表的输入作为只有一个元素的列表），通过流式输出“batch”逐批写入，是流式输出的生产者节点，
+ * 输入本身也可以是流式输出，此时对每个输入批次再拆分
+ */
+class DAWORKFLOW_API DAStandardNodeBatchSplit : public DAStandardNodeInputOutput
+{
+public:
+	DAStandardNodeBatchSplit();
+	~DAStandardNodeBatchSplit();
+	// 运行
+	virtual bool exec() override;
+	// 每批的元素个数
+	void setBatchSize(int s);
+	int getBatchSize() const;
+	// 已写入的批次数量
+	int getWrittenBatchCount() const;
+
+private:
+	int mWrittenBatchCount { 0 };
+};
+}
+#endif  // DASTANDARDNODEBATCHSPLIT_H
@@ -8,6 +8,9 @@ DAStandardNodeConstValue::DAStandardNodeConstValue() : DAAbstractNode()
 	metaData().setNodePrototype("DA.ConstValue");
 	metaData().setGroup(u8"common");
 	metaData().setNodeName(u8"Const Value");
+	metaData().setThreadSafe(true);
+	// 输出只由常数决定，常数改变时使缓存失效
+	metaData().setCacheable(true);
 	addOutputKey("value");
 }
 
@@ -17,6 +20,7 @@ DAStandardNodeConstValue::~DAStandardNodeConstValue()
 
 bool DAStandardNodeConstValue::exec()
 {
+	setOutputData("value", mValue);
 	return true;
 }
 
@@ -36,9 +40,19 @@ QString DAStandardNodeConstValue::getDisplayName() const
 	return getProperty("display-name").toString();
 }
 
+/**
+ * @brief 设置常数
+ *
+ * 常数不是节点属性，不参与指纹计算，因此改变时需要使输出缓存失效
+ * @param v
+ */
 void DAStandardNodeConstValue::setValue(const QVariant& v)
 {
+	if (mValue == v) {
+		return;
+	}
 	mValue = v;
+	invalidateOutputCache();
 }
 
 QVariant DAStandardNodeConstValue::getValue() const
@@ -6,6 +6,9 @@ namespace DA
 class DAAbstractNodeFactory;
 /**
  * @brief 标准输入输出节点
+ *
+ * 作为插件节点的基类，默认非线程安全，子类的exec只使用C++实现时应在构造函数中调用metaData().setThreadSafe(true)，
+ * 这样并行执行时才会放到线程池中执行
  */
 class DAWORKFLOW_API DAStandardNodeInputOutput : public DAAbstractNode
 {
@@ -0,0 +1,415 @@
+﻿#include "DAWorkbenchRunner.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include "DAWorkFlow.h"
+#include "DAXmlHelper.h"
+#include "DAZipArchive.h"
+#include "DAPluginManager.h"
+#include "DAAbstractNodePlugin.h"
+#include "DAAbstractNodeFactory.h"
+
+namespace DA
+{
+/**
+ * @brief 工程文件中工作流的文件名
+ */
+static const QString c_runner_workflowxml_filename = QStringLiteral("workflow.xml");
+
+/**
+ * @brief 一个工作流副本
+ */
+struct DAWorkbenchRunner::Job
+{
+    DAWorkFlow* workflow { nullptr };
+    int fileIndex { -1 };
+    QElapsedTimer timer;
+};
+
+//===================================================
+// DAWorkbenchRunner
+//===================================================
+DAWorkbenchRunner::DAWorkbenchRunner(QObject* par) : QObject(par)
+{
+}
+
+DAWorkbenchRunner::~DAWorkbenchRunner()
+{
+}
+
+/**
+ * @brief 加载节点插件
+ *
+ * 无界面运行时插件的core为nullptr，依赖界面接口的插件初始化会失败，这些插件的节点无法在批处理中使用
+ */
+void DAWorkbenchRunner::loadPlugins()
+{
+    DAPluginManager& pluginMgr = DAPluginManager::instance();
+    if (!pluginMgr.isLoaded()) {
+        pluginMgr.load(nullptr);
+    }
+    mNodePlugins.clear();
+    const QList< DAPluginOption > plugins = pluginMgr.getPluginOptions();
+    for (const DAPluginOption& opt : plugins) {
+        if (!opt.isValid()) {
+            continue;
+        }
+        if (DAAbstractNodePlugin* np = dynamic_cast< DAAbstractNodePlugin* >(opt.plugin())) {
+            mNodePlugins.append(np);
+            qInfo() << tr("load node plugin %1").arg(np->getName());  // cn:加载节点插件%1
+        }
+    }
+}
+
+/**
+ * @brief 加载工程
+ * @param path 工程文件（压缩包）或者工程中的workflow.xml
+ * @param workflowName 工作流名，为空时使用第一个工作流
+ * @return
+ */
+bool DAWorkbenchRunner::loadProject(const QString& path, const QString& workflowName)
+{
+    QByteArray data;
+    if (DAZipArchive::isCorrectFile(path)) {
+        DAZipArchive zip(path);
+        if (!zip.open()) {
+            qCritical() << tr("can not open project %1").arg(path);  // cn:无法打开工程%1
+            return false;
+        }
+        data = zip.read(c_runner_workflowxml_filename);
+        zip.close();
+    } else {
+        QFile f(path);
+        if (!f.open(QIODevice::ReadOnly)) {
+            qCritical() << tr("can not open project %1").arg(path);  // cn:无法打开工程%1
+            return false;
+        }
+        data = f.readAll();
+    }
+    QString error;
+    if (!mDoc.setContent(data, &error)) {
+        qCritical() << tr("invalid workflow xml:%1").arg(error);  // cn:工作流xml无效:%1
+        return false;
+    }
+    QDomElement workflowsEle = mDoc.documentElement().firstChildElement("project").firstChildElement("workflows");
+    const QString verString  = workflowsEle.attribute("ver");
+    mWorkflowVersion = verString.isEmpty() ? QVersionNumber(1, 1, 0) : QVersionNumber::fromString(verString);
+    mWorkflowEle     = QDomElement();
+    QDomNodeList wfListNodes = workflowsEle.childNodes();
+    for (int i = 0; i < wfListNodes.size(); ++i) {
+        QDomElement ele = wfListNodes.at(i).toElement();
+        if (ele.tagName() != "workflow") {
+            continue;
+        }
+        if (workflowName.isEmpty() || ele.attribute("name") == workflowName) {
+            mWorkflowEle = ele;
+            break;
+        }
+    }
+    if (mWorkflowEle.isNull()) {
+        qCritical() << tr("can not find workflow \"%1\" in %2").arg(workflowName, path);  // cn:在%2中找不到工作流"%1"
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief 解析参数模板
+ * @param str 格式为“节点名:属性名=值”
+ * @param p
+ * @return 格式错误返回false
+ */
+bool DAWorkbenchRunner::parseParamTemplate(const QString& str, DAWorkbenchRunner::ParamTemplate& p)
+{
+    const int eq    = str.indexOf('=');
+    const int colon = str.lastIndexOf(':', eq);
+    if (eq < 0 || colon <= 0) {
+        return false;
+    }
+    p.nodeName    = str.left(colon);
+    p.propertyKey = str.mid(colon + 1, eq - colon - 1);
+    p.value       = str.mid(eq + 1);
+    return !p.propertyKey.isEmpty();
+}
+
+/**
+ * @brief 展开通配符
+ *
+ * 通配符只作用于文件名部分，例如data/*.csv，结果按文件名排序
+ * @param glob
+ * @return 文件的绝对路径
+ */
+QStringList DAWorkbenchRunner::expandGlob(const QString& glob)
+{
+    QStringList res;
+    QFileInfo fi(glob);
+    if (!glob.contains('*') && !glob.contains('?') && !glob.contains('[')) {
+        if (fi.isFile()) {
+            res.append(fi.absoluteFilePath());
+        }
+        return res;
+    }
+    QDir dir(fi.path());
+    const QFileInfoList files = dir.entryInfoList(QStringList() << fi.fileName(), QDir::Files, QDir::Name);
+    for (const QFileInfo& f : files) {
+        res.append(f.absoluteFilePath());
+    }
+    return res;
+}
+
+void DAWorkbenchRunner::setParamTemplates(const QList< DAWorkbenchRunner::ParamTemplate >& params)
+{
+    mParams = params;
+}
+
+void DAWorkbenchRunner::setOutputDir(const QString& dir)
+{
+    mOutputDir = QDir(dir).absolutePath();
+}
+
+/**
+ * @brief 设置同时处理的文件数
+ * @param jobs 小于1时为1
+ */
+void DAWorkbenchRunner::setJobs(int jobs)
+{
+    mJobCount = qMax(1, jobs);
+}
+
+/**
+ * @brief 单个工作流内部是否并行执行
+ * @param on
+ */
+void DAWorkbenchRunner::setEnableParallelExecute(bool on)
+{
+    mEnableParallel = on;
+}
+
+/**
+ * @brief 设置性能记录的输出目录
+ *
+ * 设置后每个文件的执行过程导出为“文件名.trace.json”，可以在chrome://tracing或Perfetto中打开
+ * @param dir 为空时不记录
+ */
+void DAWorkbenchRunner::setTraceDir(const QString& dir)
+{
+    mTraceDir = dir.isEmpty() ? QString() : QDir(dir).absolutePath();
+}
+
+/**
+ * @brief 开始处理
+ * @param files 输入文件
+ * @return 没有输入文件或者工作流创建失败返回false
+ */
+bool DAWorkbenchRunner::start(const QStringList& files)
+{
+    mFiles       = files;
+    mNextFile    = 0;
+    mRunningJobs = 0;
+    mResults.clear();
+    mJobs.clear();
+    if (mFiles.isEmpty()) {
+        qCritical() << tr("no input file");  // cn:没有输入文件
+        return false;
+    }
+    if (!mOutputDir.isEmpty()) {
+        QDir().mkpath(mOutputDir);
+    }
+    if (!mTraceDir.isEmpty()) {
+        QDir().mkpath(mTraceDir);
+    }
+    const int jobs = qMin(mJobCount, mFiles.size());
+    for (int i = 0; i < jobs; ++i) {
+        std::shared_ptr< Job > job = std::make_shared< Job >();
+        job->workflow              = createWorkflow();
+        if (!job->workflow) {
+            return false;
+        }
+        // 使用队列连接，工作流在exec中直接结束时也不会递归调度
+        connect(
+            job->workflow, &DAWorkFlow::finished, this, [ this, i ](bool success) { onJobFinished(i, success); }, Qt::QueuedConnection);
+        mJobs.append(job);
+    }
+    qInfo() << tr("process %1 files with %2 jobs").arg(mFiles.size()).arg(jobs);  // cn:使用%2个任务处理%1个文件
+    for (int i = 0; i < jobs; ++i) {
+        startNext(i);
+    }
+    return true;
+}
+
+QList< DAWorkbenchRunner::FileResult > DAWorkbenchRunner::getResults() const
+{
+    return mResults;
+}
+
+/**
+ * @brief 写出耗时汇总
+ * @param path 为空时输出到标准输出
+ * @return
+ */
+bool DAWorkbenchRunner::writeSummary(const QString& path) const
+{
+    QFile f;
+    if (path.isEmpty()) {
+        if (!f.open(stdout, QIODevice::WriteOnly | QIODevice::Text)) {
+            return false;
+        }
+    } else {
+        f.setFileName(path);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+            qCritical() << tr("can not write summary to %1").arg(path);  // cn:无法写入汇总文件%1
+            return false;
+        }
+    }
+    QTextStream st(&f);
+    st << "file,success,elapsed_ms,job\n";
+    qint64 total = 0;
+    int failed   = 0;
+    for (const FileResult& r : mResults) {
+        st << '"' << QString(r.file).replace('"', "\"\"") << "\"," << (r.success ? 1 : 0) << ',' << r.elapsedMs << ','
+           << r.job << '\n';
+        total += r.elapsedMs;
+        if (!r.success) {
+            ++failed;
+        }
+    }
+    st.flush();
+    qInfo() << tr("processed %1 files,failed %2,total node time %3 ms").arg(mResults.size()).arg(failed).arg(total);  // cn:处理了%1个文件，失败%2个，累计耗时%3毫秒
+    return true;
+}
+
+/**
+ * @brief 创建一个工作流副本
+ *
+ * 每个副本使用独立的节点工厂，节点之间互不影响
+ * @return 加载失败返回nullptr
+ */
+DAWorkFlow* DAWorkbenchRunner::createWorkflow()
+{
+    DAWorkFlow* wf = new DAWorkFlow(this);
+    for (DAAbstractNodePlugin* np : qAsConst(mNodePlugins)) {
+        std::shared_ptr< DAAbstractNodeFactory > fac(np->createNodeFactory());
+        if (fac) {
+            wf->registFactory(fac);
+        }
+    }
+    DAXmlHelper xml;
+    xml.setLoadedVersionNumber(mWorkflowVersion);
+    if (!xml.loadElement(wf, &mWorkflowEle)) {
+        qWarning() << tr("workflow is not completely loaded, some nodes or links are missing");  // cn:工作流没有完整加载，部分节点或连接丢失
+    }
+    if (wf->isEmpty()) {
+        qCritical() << tr("workflow is empty");  // cn:工作流为空
+        delete wf;
+        return nullptr;
+    }
+    wf->setEnableParallelExecute(mEnableParallel);
+    // 批处理不需要查看中间结果，提前释放以降低内存峰值
+    wf->setEnableReleaseIntermediateData(true);
+    wf->setEnableProfile(!mTraceDir.isEmpty());
+    return wf;
+}
+
+/**
+ * @brief 给工作流分配下一个文件
+ * @param job
+ */
+void DAWorkbenchRunner::startNext(int job)
+{
+    if (mNextFile >= mFiles.size()) {
+        if (0 == mRunningJobs) {
+            int failed = 0;
+            for (const FileResult& r : qAsConst(mResults)) {
+                failed += r.success ? 0 : 1;
+            }
+            emit finished(failed);
+        }
+        return;
+    }
+    Job* j       = mJobs[ job ].get();
+    j->fileIndex = mNextFile++;
+    const QString& file = mFiles[ j->fileIndex ];
+    if (0 == applyParams(j->workflow, file, j->fileIndex) && !mParams.isEmpty()) {
+        qWarning() << tr("no node property was replaced for %1, please check the node names").arg(file);  // cn:%1没有替换任何节点属性，请检查节点名
+    }
+    ++mRunningJobs;
+    j->timer.start();
+    j->workflow->exec();
+}
+
+/**
+ * @brief 工作流执行完成
+ * @param job
+ * @param success
+ */
+void DAWorkbenchRunner::onJobFinished(int job, bool success)
+{
+    Job* j = mJobs[ job ].get();
+    FileResult r;
+    r.file      = mFiles.value(j->fileIndex);
+    r.success   = success;
+    r.elapsedMs = j->timer.elapsed();
+    r.job       = job;
+    mResults.append(r);
+    --mRunningJobs;
+    if (DAWorkFlowProfiler::SharedPointer profiler = j->workflow->getLastExecuteProfiler()) {
+        const QString tracePath = QDir(mTraceDir).filePath(QFileInfo(r.file).completeBaseName() + ".trace.json");
+        if (!profiler->saveChromeTrace(tracePath)) {
+            qWarning() << tr("can not write trace to %1").arg(tracePath);  // cn:无法写入性能记录%1
+        }
+    }
+    qInfo().noquote() << QString("[%1/%2] %3 %4 ms %5")
+                             .arg(mResults.size())
+                             .arg(mFiles.size())
+                             .arg(success ? "ok" : "failed", QString::number(r.elapsedMs), r.file);
+    startNext(job);
+}
+
+/**
+ * @brief 替换节点参数
+ * @param wf
+ * @param file
+ * @param index
+ * @return 替换的属性数量
+ */
+int DAWorkbenchRunner::applyParams(DAWorkFlow* wf, const QString& file, int index) const
+{
+    int cnt                                             = 0;
+    const QList< DAAbstractNode::SharedPointer > nodes = wf->nodes();
+    for (const ParamTemplate& p : mParams) {
+        const QString v = expandTemplate(p.value, file, index);
+        for (const DAAbstractNode::SharedPointer& n : nodes) {
+            if (n->getNodeName() == p.nodeName) {
+                n->setProperty(p.propertyKey, v);
+                // 属性之外的状态可能也依赖文件，确保节点重新执行
+                n->invalidateOutputCache();
+                ++cnt;
+            }
+        }
+    }
+    return cnt;
+}
+
+/**
+ * @brief 展开占位符
+ * @param t
+ * @param file
+ * @param index
+ * @return
+ */
+QString DAWorkbenchRunner::expandTemplate(const QString& t, const QString& file, int index) const
+{
+    QFileInfo fi(file);
+    QString res = t;
+    res.replace("{input}", fi.absoluteFilePath());
+    res.replace("{name}", fi.fileName());
+    res.replace("{basename}", fi.completeBaseName());
+    res.replace("{dir}", fi.absolutePath());
+    res.replace("{output}", mOutputDir);
+    res.replace("{index}", QString::number(index));
+    return res;
+}
+
+}  // end of namespace DA
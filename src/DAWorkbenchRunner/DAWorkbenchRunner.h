@@ -0,0 +1,119 @@
+﻿#ifndef DAWORKBENCHRUNNER_H
+#define DAWORKBENCHRUNNER_H
+#include <memory>
+#include <QObject>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVersionNumber>
+namespace DA
+{
+class DAWorkFlow;
+class DAAbstractNodeFactory;
+class DAAbstractNodePlugin;
+
+/**
+ * @brief 无界面的工作流批处理
+ *
+ * 从工程文件（或单独的workflow.xml）中无界面加载工作流（不创建图元），
+ * 对每个输入文件替换节点属性后执行一次工作流，输出由工作流中的节点负责写出。
+ *
+ * 批处理会创建jobs个工作流副本，每个副本同一时间只处理一个文件，因此多个文件可以同时处理，
+ * 每个工作流在自己的执行器线程中执行，调度和汇总都在主线程的事件循环中完成
+ *
+ * 节点属性通过参数模板替换，模板格式为`节点名:属性名=值`，值中可以使用如下占位符：
+ *
+ * - {input} 输入文件的绝对路径
+ * - {name} 输入文件的文件名
+ * - {basename} 输入文件不含后缀的文件名
+ * - {dir} 输入文件所在的目录
+ * - {output} 输出目录
+ * - {index} 输入文件的序号
+ */
+class DAWorkbenchRunner : public QObject
+{
+    Q_OBJECT
+public:
+    /**
+     * @brief 参数模板
+     */
+    struct ParamTemplate
+    {
+        QString nodeName;     ///< 节点名
+        QString propertyKey;  ///< 属性名
+        QString value;        ///< 值模板
+    };
+
+    /**
+     * @brief 一个文件的处理结果
+     */
+    struct FileResult
+    {
+        QString file;
+        bool success { false };
+        qint64 elapsedMs { 0 };
+        int job { -1 };
+    };
+
+public:
+    DAWorkbenchRunner(QObject* par = nullptr);
+    ~DAWorkbenchRunner();
+    // 加载节点插件，无界面运行时插件的core为nullptr
+    void loadPlugins();
+    // 加载工程，可以是工程文件也可以是单独的workflow.xml
+    bool loadProject(const QString& path, const QString& workflowName = QString());
+    // 解析参数模板，格式为“节点名:属性名=值”
+    static bool parseParamTemplate(const QString& str, ParamTemplate& p);
+    // 展开通配符，如data/*.csv
+    static QStringList expandGlob(const QString& glob);
+    // 设置参数
+    void setParamTemplates(const QList< ParamTemplate >& params);
+    void setOutputDir(const QString& dir);
+    void setJobs(int jobs);
+    void setEnableParallelExecute(bool on);
+    // 设置后记录节点性能，每个文件导出一个chrome trace
+    void setTraceDir(const QString& dir);
+    // 开始处理，处理完成发射finished信号
+    bool start(const QStringList& files);
+    // 结果
+    QList< FileResult > getResults() const;
+    // 写出耗时汇总，格式为csv
+    bool writeSummary(const QString& path) const;
+signals:
+    /**
+     * @brief 所有文件处理完成
+     * @param failedCount 处理失败的文件数
+     */
+    void finished(int failedCount);
+
+private:
+    struct Job;
+    // 创建一个工作流副本
+    DAWorkFlow* createWorkflow();
+    // 给工作流分配下一个文件
+    void startNext(int job);
+    // 工作流执行完成
+    void onJobFinished(int job, bool success);
+    // 替换节点参数
+    int applyParams(DAWorkFlow* wf, const QString& file, int index) const;
+    // 展开占位符
+    QString expandTemplate(const QString& t, const QString& file, int index) const;
+
+private:
+    QList< DAAbstractNodePlugin* > mNodePlugins;
+    QDomDocument mDoc;
+    QDomElement mWorkflowEle;
+    QVersionNumber mWorkflowVersion;
+    QList< ParamTemplate > mParams;
+    QString mOutputDir;
+    int mJobCount { 1 };
+    bool mEnableParallel { false };
+    QString mTraceDir;
+    QStringList mFiles;
+    int mNextFile { 0 };
+    int mRunningJobs { 0 };
+    QList< std::shared_ptr< Job > > mJobs;
+    QList< FileResult > mResults;
+};
+}  // end of namespace DA
+#endif  // DAWORKBENCHRUNNER_H
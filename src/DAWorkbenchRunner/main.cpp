@@ -0,0 +1,147 @@
+﻿#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include "DAConfigs.h"
+#include "DAPluginManager.h"
+#include "DAWorkbenchRunner.h"
+#if DA_ENABLE_PYTHON
+#include "DAPyScripts.h"
+#include "DAPyInterpreter.h"
+#include "DAPyGILIdleRelease.h"
+#include "DAWorkFlowSizeEstimators.h"
+#endif
+
+bool initializePythonEnv();
+
+/**
+ * @brief 无界面批处理工作流
+ *
+ * 用法：
+ * @code
+ * DAWorkbenchRunner project.asproj --input-glob "data/*.csv" --param "Read:path={input}"
+ *     --param "Write:path={output}/{basename}.csv" --output-dir out --jobs 4 --summary summary.csv
+ * @endcode
+ *
+ * 全部文件处理成功返回0，否则返回1
+ *
+ * 事件循环空闲时释放GIL，执行器线程中的python节点才能获取GIL
+ */
+int main(int argc, char* argv[])
+{
+	// 节点会创建图标等gui资源，需要QApplication，没有显示环境时使用offscreen
+	if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+		qputenv("QT_QPA_PLATFORM", "offscreen");
+	}
+	QApplication app(argc, argv);
+	QApplication::setApplicationVersion(DA_VERSION);
+	QApplication::setApplicationName("DAWorkbenchRunner");
+
+	QCommandLineParser cmd;
+	cmd.setApplicationDescription(QObject::tr("run a workflow of project for each input file without gui"));  // cn:无界面对每个输入文件执行工程中的工作流
+	cmd.addHelpOption();
+	cmd.addVersionOption();
+	cmd.addPositionalArgument("project", QObject::tr("project file or workflow xml file"));  // cn:工程文件或工作流xml文件
+	QCommandLineOption inputGlobOpt("input-glob", QObject::tr("input files glob,such as data/*.csv"), "glob");  // cn:输入文件通配符
+	QCommandLineOption inputOpt("input", QObject::tr("input file"), "file");  // cn:输入文件
+	QCommandLineOption paramOpt("param",
+	                            QObject::tr("node property template,format is node:property=value,"
+	                                        "placeholders:{input} {name} {basename} {dir} {output} {index}"),
+	                            "param");  // cn:节点属性模板
+	QCommandLineOption outputDirOpt("output-dir", QObject::tr("output directory"), "dir");  // cn:输出目录
+	QCommandLineOption jobsOpt("jobs", QObject::tr("number of files processed at the same time"), "N", "1");  // cn:同时处理的文件数
+	QCommandLineOption workflowOpt("workflow", QObject::tr("workflow name,default is the first workflow"), "name");  // cn:工作流名
+	QCommandLineOption summaryOpt("summary", QObject::tr("write timing summary csv to file"), "file");  // cn:耗时汇总文件
+	QCommandLineOption parallelOpt("parallel", QObject::tr("execute nodes of workflow in parallel"));  // cn:工作流节点并行执行
+	QCommandLineOption traceDirOpt("trace-dir", QObject::tr("profile nodes and write a chrome trace for each file to directory"), "dir");  // cn:记录节点性能并为每个文件输出chrome trace
+	QCommandLineOption pluginDirOpt("plugin-dir", QObject::tr("plugin directory,default is the plugins directory beside the program"), "dir");  // cn:插件目录，默认为程序所在目录下的plugins
+	cmd.addOptions({ inputGlobOpt, inputOpt, paramOpt, outputDirOpt, jobsOpt, workflowOpt, summaryOpt, parallelOpt, traceDirOpt, pluginDirOpt });
+	cmd.process(app);
+
+	const QStringList positional = cmd.positionalArguments();
+	if (positional.isEmpty()) {
+		qCritical().noquote() << cmd.helpText();
+		return 2;
+	}
+	QStringList files;
+	for (const QString& g : cmd.values(inputGlobOpt)) {
+		files += DA::DAWorkbenchRunner::expandGlob(g);
+	}
+	for (const QString& f : cmd.values(inputOpt)) {
+		files.append(QFileInfo(f).absoluteFilePath());
+	}
+	QList< DA::DAWorkbenchRunner::ParamTemplate > params;
+	for (const QString& p : cmd.values(paramOpt)) {
+		DA::DAWorkbenchRunner::ParamTemplate t;
+		if (!DA::DAWorkbenchRunner::parseParamTemplate(p, t)) {
+			qCritical() << QObject::tr("invalid param \"%1\",format is node:property=value").arg(p);  // cn:参数"%1"格式错误
+			return 2;
+		}
+		params.append(t);
+	}
+
+	const bool isPythonReady = initializePythonEnv();
+	if (cmd.isSet(pluginDirOpt)) {
+		DA::DAPluginManager::instance().setPluginPath(QDir(cmd.value(pluginDirOpt)).absolutePath());
+	}
+	DA::DAWorkbenchRunner runner;
+	runner.loadPlugins();
+	if (!runner.loadProject(positional.first(), cmd.value(workflowOpt))) {
+		return 2;
+	}
+	runner.setParamTemplates(params);
+	runner.setOutputDir(cmd.isSet(outputDirOpt) ? cmd.value(outputDirOpt) : QDir::currentPath());
+	runner.setJobs(cmd.value(jobsOpt).toInt());
+	runner.setEnableParallelExecute(cmd.isSet(parallelOpt));
+	runner.setTraceDir(cmd.value(traceDirOpt));
+	const QString summaryPath = cmd.value(summaryOpt);
+	QObject::connect(&runner, &DA::DAWorkbenchRunner::finished, &app, [ &runner, summaryPath ](int failedCount) {
+		runner.writeSummary(summaryPath);
+		QCoreApplication::exit(failedCount > 0 ? 1 : 0);
+	});
+	if (!runner.start(files)) {
+		return 2;
+	}
+#if DA_ENABLE_PYTHON
+	if (isPythonReady) {
+		DA::DAPyGILIdleRelease::getInstance().install();
+	}
+#else
+	Q_UNUSED(isPythonReady);
+#endif
+	const int res = app.exec();
+#if DA_ENABLE_PYTHON
+	DA::DAPyGILIdleRelease::getInstance().uninstall();
+#endif
+	return res;
+}
+
+/**
+ * @brief 初始化python环境，脚本节点依赖python环境
+ * @return
+ */
+bool initializePythonEnv()
+{
+#if DA_ENABLE_PYTHON
+	try {
+		DA::DAPyInterpreter& python = DA::DAPyInterpreter::getInstance();
+		QString pypath              = DA::DAPyInterpreter::getPythonInterpreterPath();
+		QFileInfo fi(pypath);
+		python.setPythonHomePath(fi.absolutePath());
+		python.initializePythonInterpreter();
+		// DA::DAPyScripts::appendSysPath必须在getInstance前执行
+		DA::DAPyScripts::appendSysPath(QDir::toNativeSeparators(QApplication::applicationDirPath() + "/PyScripts"));
+		if (!DA::DAPyScripts::getInstance().isInitScripts()) {
+			qCritical() << QObject::tr("Scripts initialize error");
+			return false;
+		}
+		// --trace-dir导出的时间线需要估算dataframe的大小
+		DA::registerWorkFlowSizeEstimators();
+	} catch (const std::exception& e) {
+		qCritical() << QObject::tr("Initialize python environment error:%1").arg(e.what());
+		return false;
+	}
+#endif
+	return true;
+}
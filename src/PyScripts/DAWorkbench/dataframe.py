@@ -1,5 +1,6 @@
 # -*- coding: utf-8 -*-
 import os
+import re
 import sys
 from typing import List, Dict, Optional, Union
 # 根据Python版本动态导入Literal
@@ -15,7 +16,13 @@ from pandas._typing import Axis, Scalar
 import pandas as pd
 import numpy as np
 from DAWorkbench.logger import log_function_call  # type: ignore # 引入装饰器
+from DAWorkbench.progress import has_progress, report_progress, progress_range  # type: ignore
 import copy
+import hashlib
+import io
+import json
+import struct
+import zipfile
 
 '''
 本文件da_打头的变量和函数属于da系统的默认函数，如果改动会导致da系统异常
@@ -23,6 +30,33 @@ import copy
 此文件封装dataframe的操作
 '''
 
+# 设置了进度回调时，逐列操作分块执行的块数
+_PROGRESS_CHUNKS = 20
+
+
+def _apply_by_columns(df: pd.DataFrame, fun):
+    '''
+    列之间互不影响的原地操作，设置了进度回调时按列分块执行，每块完成后报告进度，
+    否则整体执行一次
+    :param df: pd.DataFrame
+    :param fun: fun(df)，原地修改传入的dataframe
+    '''
+    n = df.shape[1]
+    if not has_progress() or n <= 1:
+        fun(df)
+        return
+    step = max(1, -(-n // _PROGRESS_CHUNKS))
+    chunks = [list(range(s, min(n, s + step))) for s in range(0, n, step)]
+    for i, cols in enumerate(chunks):
+        part = df.iloc[:, cols].copy()
+        fun(part)
+        for j, c in enumerate(cols):
+            if hasattr(df, 'isetitem'):
+                df.isetitem(c, part.iloc[:, j])
+            else:
+                df[df.columns[c]] = part.iloc[:, j]
+        report_progress(i + 1, len(chunks))
+
 
 @log_function_call
 def da_drop_irow(df: pd.DataFrame, index: List[int]):
@@ -106,7 +140,7 @@ def da_fill_na(df: pd.DataFrame, value: Union[Scalar, dict, None] = None, axis:
     values = {"A": 0, "B": 1, "C": 2, "D": 3}
     df.fillna(value=values)
     '''
-    df.fillna(axis=axis, value=value, downcast=downcast, inplace=True)
+    _apply_by_columns(df, lambda d: d.fillna(axis=axis, value=value, downcast=downcast, inplace=True))
 
 
 @log_function_call
@@ -135,24 +169,18 @@ def da_bfill_na(df: pd.DataFrame, axis: Optional[Axis] = None, limit: Optional[i
     df.bfill(axis=axis, inplace=True, limit=limit, limit_area=limit_area)
 
 
-@log_function_call
-def da_nstd_filter_outlier(df: pd.DataFrame, n=3, axis: Optional[int] = None, index: Optional[List[int]] = None):
-    """
-    使用n倍标准差法过滤DataFrame的行或列（直接在原数据上修改）
-    :param df: 输入的pd.DataFrame
-    :param n: 标准差的倍数，范围是0.1~10，默认为3
-    :param axis: 过滤方向，1表示基于选中列过滤行(默认)，0表示基于选中行过滤列
-    :param index: 需要过滤的行或列的索引列表，如果为None，则不进行过滤
-    :return: 过滤后的DataFrame
-    """
-    # 如果没有指定要过滤的列/行，直接返回原DataFrame
+def _keep_rows_nstd_filter_outlier(df: pd.DataFrame, n=3, axis: Optional[int] = None, index: Optional[List[int]] = None):
+    '''
+    da_nstd_filter_outlier需要保留的行的掩码，不需要过滤时返回None
+    '''
+    # 没有指定要过滤的列/行，不过滤
     if index is None or len(index) == 0:
-        return df
+        return None
         
     # 检查所选列是否全是字符串类型，如果是则跳过计算
     selected_columns = df.iloc[:, index]
     if all(selected_columns.dtypes == "object"):  # Pandas 中字符串列的类型通常是 'object'
-        return df
+        return None
     
     # 计算均值和标准差
     if axis == 1:  # 计算选中列的值，过滤行
@@ -176,8 +204,25 @@ def da_nstd_filter_outlier(df: pd.DataFrame, n=3, axis: Optional[int] = None, in
             keep_rows = keep_rows & (col_data >= col_lower) & (
                 col_data <= col_upper)
 
-        # 直接删除不符合条件的行
-        df.drop(df.index[~keep_rows], inplace=True)
+        return keep_rows
+    return None
+
+
+@log_function_call
+def da_nstd_filter_outlier(df: pd.DataFrame, n=3, axis: Optional[int] = None, index: Optional[List[int]] = None):
+    """
+    使用n倍标准差法过滤DataFrame的行或列（直接在原数据上修改）
+    :param df: 输入的pd.DataFrame
+    :param n: 标准差的倍数，范围是0.1~10，默认为3
+    :param axis: 过滤方向，1表示基于选中列过滤行(默认)，0表示基于选中行过滤列
+    :param index: 需要过滤的行或列的索引列表，如果为None，则不进行过滤
+    :return: 过滤后的DataFrame
+    """
+    keep_rows = _keep_rows_nstd_filter_outlier(df, n, axis, index)
+    if keep_rows is None:
+        return df
+    # 直接删除不符合条件的行
+    df.drop(df.index[~keep_rows], inplace=True)
 
 
 @log_function_call
@@ -195,8 +240,14 @@ def da_fill_interpolate(df: pd.DataFrame, method: Literal['spline', 'polynomial'
     :param downcast:可选的字典，指定向下转型操作（例如将浮点数转换为整数等）。
     :return: 此函数不返回值，直接改变df
     '''
-    df.interpolate(method=method, order=order, axis=axis,
-                   downcast=downcast, inplace=True)
+    def fun(d):
+        d.interpolate(method=method, order=order, axis=axis,
+                      downcast=downcast, inplace=True)
+    if axis in (0, 'index'):
+        # 沿行方向插值时各列独立
+        _apply_by_columns(df, fun)
+    else:
+        fun(df)
 
 
 @log_function_call
@@ -209,7 +260,7 @@ def da_clip_outlier(df: pd.DataFrame, lower: Optional[float] = None, upper: Opti
     :param axis: 填充的轴方向，0 或 'index' 表示按行填充，1 或 'columns' 表示按列填充。
     :return: 此函数不返回值，直接改变df
     '''
-    df.clip(lower=lower, upper=upper, axis=axis, inplace=True)
+    _apply_by_columns(df, lambda d: d.clip(lower=lower, upper=upper, axis=axis, inplace=True))
 
 
 @log_function_call
@@ -323,6 +374,99 @@ def da_sort(df: pd.DataFrame, by: str, ascending: bool):
     '''
     df.sort_values(by = by ,ascending = ascending, inplace = True)
 
+# 逐行独立的过滤操作，返回需要保留的行的掩码，连续的过滤可以合并为一个掩码只删除一次
+def _mask_drop_na(df: pd.DataFrame, axis: int = 0, how: str = 'any', index: Optional[List[int]] = None, thresh: Optional[int] = None):
+    if axis != 0:
+        return None
+    data = df if not index else df.iloc[:, index]
+    if thresh is not None:
+        return data.notna().sum(axis=1) >= thresh
+    if how == 'all':
+        return data.notna().any(axis=1)
+    return data.notna().all(axis=1)
+
+
+def _mask_data_select(df: pd.DataFrame, index: str, lower: Optional[float] = None, upper: Optional[float] = None):
+    if lower is None and upper is None:
+        raise ValueError("必须指定lower或upper至少一个条件")
+    col_series = df[index]
+    if lower is not None and upper is not None:
+        return col_series.between(lower, upper)
+    if lower is not None:
+        return col_series >= lower
+    return col_series <= upper
+
+
+def _mask_query_datas(df: pd.DataFrame, expr: Optional[str]):
+    mask = df.eval(expr)
+    if not isinstance(mask, pd.Series) or mask.dtype != bool:
+        return None
+    return mask
+
+
+# 可以合并为掩码的过滤操作
+_PIPELINE_MASKS = {
+    'drop_na': _mask_drop_na,
+    'data_select': _mask_data_select,
+    'query_datas': _mask_query_datas,
+}
+
+# 表达式可能包含聚合（例如a > a.mean()），结果依赖于前面过滤后的行，计算掩码前需要先删除行
+_PIPELINE_MASK_AFTER_FLUSH = {'query_datas'}
+
+# 逐元素的操作，和逐行过滤的先后顺序不影响保留行的结果，不需要在执行前删除行
+_PIPELINE_ELEMENTWISE = {'clip_outlier', 'fill_na'}
+
+
+def _pipeline_flush(df: pd.DataFrame, mask):
+    if mask is not None and not mask.all():
+        # 按位置删除，index有重复值时按标签删除会多删
+        df._update_inplace(df.take(np.flatnonzero(mask)))
+
+
+@log_function_call
+def da_apply_pipeline(df: pd.DataFrame, steps: List[Dict]):
+    '''
+    一次调用按顺序执行多个dataframe操作，等价于依次调用对应的da_函数
+    :param df: pd.DataFrame
+    :param steps: 操作列表，每个操作为{"op":"drop_na","args":{...}}，op为去掉da_前缀的函数名，args为函数的参数
+    :return: 此函数不返回值，直接改变df
+
+    相比逐个调用：
+    - 只跨越一次C++/python边界，参数只转换一次，中间步骤不再逐个记录日志
+    - 连续的逐行过滤（drop_na(axis=0)、data_select、query_datas）合并为一个掩码，最后只删除一次行，
+      避免每次inplace删除都重新分配一次dataframe；中间的逐元素操作（clip_outlier、fill_na）不影响合并；
+      query_datas的表达式可能包含聚合，计算前会先删除已经累积的行
+    - 设置了进度回调（见DAWorkbench.progress）时每完成一步报告一次进度，步骤内部的进度映射到这一步的区间
+    '''
+    mask = None
+    for i, step in enumerate(steps):
+        op = step['op']
+        args = step.get('args') or {}
+        mask_fun = _PIPELINE_MASKS.get(op)
+        if mask_fun is not None:
+            if op in _PIPELINE_MASK_AFTER_FLUSH:
+                _pipeline_flush(df, mask)
+                mask = None
+            m = mask_fun(df, **args)
+            if m is not None:
+                # 转为numpy数组，避免index有重复值时按标签对齐
+                m = np.asarray(m, dtype=bool)
+                mask = m if mask is None else (mask & m)
+                report_progress(i + 1, len(steps))
+                continue
+        if op not in _PIPELINE_ELEMENTWISE:
+            # 其余操作依赖前面过滤后的行，先把累积的过滤执行掉
+            _pipeline_flush(df, mask)
+            mask = None
+        fun = globals().get('da_' + op)
+        if fun is None:
+            raise ValueError('unknown dataframe operate:{}'.format(op))
+        with progress_range(i, len(steps)):
+            getattr(fun, '__wrapped__', fun)(df, **args)
+        report_progress(i + 1, len(steps))
+    _pipeline_flush(df, mask)
+
 @log_function_call
 def da_to_csv(df: pd.DataFrame, path: str, sep: str):
     '''
@@ -385,6 +529,344 @@ def da_from_parquet(df: pd.DataFrame, path: str):
     tmp = pd.read_parquet(path)
     df.__init__(tmp)
 
+# DA列式文件的标识，前5字节为DACOL，后3字节为版本号
+_DA_COLUMNAR_MAGIC = b'DACOL\x00\x02\x00'
+# 数据块的对齐字节数
+_DA_COLUMNAR_ALIGN = 64
+# 可以按原始字节存放的numpy类型，读取时只允许这些类型，避免按文件内容构造object数组
+_DA_COLUMNAR_RAW_KINDS = 'biufcmM'
+# 可空的整数、浮点和布尔类型，按数值和缺失值掩码两个数据块存放
+_DA_COLUMNAR_MASKED_DTYPES = ('Int8', 'Int16', 'Int32', 'Int64', 'UInt8', 'UInt16', 'UInt32', 'UInt64',
+                              'Float32', 'Float64', 'boolean')
+
+
+def _da_columnar_align(n: int) -> int:
+    return (n + _DA_COLUMNAR_ALIGN - 1) // _DA_COLUMNAR_ALIGN * _DA_COLUMNAR_ALIGN
+
+
+class _DAColumnarUnsupported(TypeError):
+    '''
+    dataframe中有列式文件无法无损保存的值，da_to_columnar会改为保存parquet
+    '''
+    pass
+
+
+def _da_columnar_json_value(v):
+    '''
+    json可以无损保存的值（None、bool、int、float、str），其它类型抛出_DAColumnarUnsupported
+    '''
+    if isinstance(v, np.generic):
+        v = v.item()
+    if v is None or isinstance(v, (str, bool, int, float)):
+        return v
+    raise _DAColumnarUnsupported(f'{type(v).__name__} can not be stored in DA columnar file')
+
+
+def _da_columnar_label(v):
+    '''
+    index名转换为json可以保存的值，其它类型转换为字符串（和parquet一样，index名只作为元数据保存）
+    '''
+    try:
+        return _da_columnar_json_value(v)
+    except _DAColumnarUnsupported:
+        return str(v)
+
+
+def _da_columnar_put(payloads: list, arr: np.ndarray) -> int:
+    payloads.append(np.ascontiguousarray(arr).reshape(-1).view(np.uint8))
+    return len(payloads) - 1
+
+
+def _da_columnar_encode(values, payloads: list) -> dict:
+    '''
+    把一列（或一个index层级）编码为数据块，返回写入文件头的描述
+
+    - 数值、布尔、日期类型：原始字节
+    - 可空数值类型：原始字节+缺失值掩码
+    - 带时区的日期：UTC的原始字节+时区名
+    - 分类：编码的原始字节+分类值
+    - 字符串：偏移量块（int64，长度n+1）+UTF-8数据块+缺失值掩码
+    - 其余object列：json，只支持None、bool、int、float、str，其它值抛出_DAColumnarUnsupported
+    '''
+    dtype = values.dtype
+    n = len(values)
+    if isinstance(dtype, np.dtype) and dtype.kind in _DA_COLUMNAR_RAW_KINDS:
+        arr = np.ascontiguousarray(np.asarray(values))
+        return {'kind': 'raw', 'length': n, 'dtype': arr.dtype.str, 'block': _da_columnar_put(payloads, arr)}
+    if isinstance(dtype, pd.CategoricalDtype):
+        cat = pd.Categorical(values)
+        return {'kind': 'category', 'length': n, 'ordered': bool(dtype.ordered),
+                'codes': _da_columnar_encode(np.asarray(cat.codes), payloads),
+                'categories': _da_columnar_encode(cat.categories, payloads)}
+    if isinstance(dtype, pd.DatetimeTZDtype):
+        utc = pd.DatetimeIndex(values).tz_convert('UTC').tz_localize(None)
+        return {'kind': 'datetimetz', 'length': n, 'tz': str(dtype.tz),
+                'values': _da_columnar_encode(utc.to_numpy(), payloads)}
+    mask = np.asarray(pd.isna(values), dtype=np.bool_)
+    if dtype.name in _DA_COLUMNAR_MASKED_DTYPES:
+        arr = np.asarray(values.to_numpy(dtype=dtype.numpy_dtype, na_value=0))
+        return {'kind': 'masked', 'length': n, 'dtype': dtype.name,
+                'values': _da_columnar_encode(arr, payloads), 'mask': _da_columnar_put(payloads, mask)}
+    obj = np.asarray(values, dtype=object)
+    if all(isinstance(v, str) for v in obj[~mask]):
+        encoded = [b'' if m else v.encode('utf-8', 'surrogatepass') for v, m in zip(obj, mask)]
+        offsets = np.zeros(n + 1, dtype='<i8')
+        np.cumsum(np.fromiter(map(len, encoded), dtype='<i8', count=n), out=offsets[1:])
+        return {'kind': 'string', 'length': n, 'dtype': 'string' if dtype.name == 'string' else 'object',
+                'offsets': _da_columnar_put(payloads, offsets),
+                'data': _da_columnar_put(payloads, np.frombuffer(b''.join(encoded), dtype=np.uint8)),
+                'mask': _da_columnar_put(payloads, mask)}
+    b = json.dumps([None if m else _da_columnar_json_value(v) for v, m in zip(obj, mask)]).encode('utf-8')
+    return {'kind': 'json', 'length': n, 'block': _da_columnar_put(payloads, np.frombuffer(b, dtype=np.uint8))}
+
+
+def _da_columnar_encode_index(index: pd.Index, payloads: list) -> dict:
+    if isinstance(index, pd.RangeIndex):
+        return {'kind': 'range', 'start': int(index.start), 'stop': int(index.stop), 'step': int(index.step),
+                'name': _da_columnar_label(index.name)}
+    if isinstance(index, pd.MultiIndex):
+        return {'kind': 'multi', 'names': [_da_columnar_label(n) for n in index.names],
+                'levels': [_da_columnar_encode(index.get_level_values(i), payloads) for i in range(index.nlevels)]}
+    return {'kind': 'index', 'name': _da_columnar_label(index.name), 'values': _da_columnar_encode(index, payloads)}
+
+
+def _da_columnar_decode(desc: dict, block):
+    '''
+    _da_columnar_encode的逆过程，只按文件头中描述的类型构造数组，不会执行文件中的任何内容
+    :param block: 根据块序号获取数据块(np.uint8数组)的函数
+    '''
+    kind = desc['kind']
+    n = int(desc['length'])
+    if kind == 'raw':
+        dtype = np.dtype(desc['dtype'])
+        if dtype.kind not in _DA_COLUMNAR_RAW_KINDS:
+            raise ValueError(f'unsupported columnar dtype {dtype}')
+        return np.frombuffer(block(desc['block']), dtype=dtype, count=n)
+    if kind == 'category':
+        codes = _da_columnar_decode(desc['codes'], block)
+        categories = _da_columnar_decode(desc['categories'], block)
+        return pd.Categorical.from_codes(codes, categories=categories, ordered=bool(desc['ordered']))
+    if kind == 'datetimetz':
+        utc = pd.DatetimeIndex(_da_columnar_decode(desc['values'], block)).tz_localize('UTC')
+        try:
+            return utc.tz_convert(desc['tz']).array
+        except Exception:
+            return utc.array
+    if kind == 'masked':
+        if desc['dtype'] not in _DA_COLUMNAR_MASKED_DTYPES:
+            raise ValueError(f'unsupported columnar dtype {desc["dtype"]}')
+        arr = pd.array(_da_columnar_decode(desc['values'], block), dtype=desc['dtype'])
+        mask = np.frombuffer(block(desc['mask']), dtype=np.bool_, count=n)
+        if mask.any():
+            arr[mask] = pd.NA
+        return arr
+    if kind == 'string':
+        offsets = np.frombuffer(block(desc['offsets']), dtype='<i8', count=n + 1).tolist()
+        data = block(desc['data']).tobytes()
+        mask = np.frombuffer(block(desc['mask']), dtype=np.bool_, count=n)
+        values = np.empty(n, dtype=object)
+        values[:] = [data[s:e].decode('utf-8', 'surrogatepass') for s, e in zip(offsets, offsets[1:])]
+        if desc['dtype'] == 'string':
+            values[mask] = pd.NA
+            return pd.array(values, dtype='string')
+        values[mask] = np.nan
+        return values
+    if kind == 'json':
+        values = np.empty(n, dtype=object)
+        values[:] = json.loads(block(desc['block']).tobytes().decode('utf-8'))
+        return values
+    raise ValueError(f'unknown columnar kind {kind}')
+
+
+def _da_columnar_decode_index(desc: dict, block) -> pd.Index:
+    kind = desc['kind']
+    if kind == 'range':
+        return pd.RangeIndex(int(desc['start']), int(desc['stop']), int(desc['step']), name=desc['name'])
+    if kind == 'multi':
+        return pd.MultiIndex.from_arrays([_da_columnar_decode(d, block) for d in desc['levels']], names=desc['names'])
+    return pd.Index(_da_columnar_decode(desc['values'], block), name=desc['name'])
+
+
+def _da_columnar_parse(buf: np.ndarray) -> pd.DataFrame:
+    '''
+    从内存中（可以是内存映射）的DA列式文件内容构造dataframe，原始字节存放的列直接引用buf，不会拷贝
+    :param buf: np.uint8数组
+    '''
+    head = len(_DA_COLUMNAR_MAGIC)
+    if buf[:head].tobytes() != _DA_COLUMNAR_MAGIC:
+        raise ValueError('not a supported DA columnar file')
+    (header_len,) = struct.unpack('<Q', buf[head:head + 8].tobytes())
+    header = json.loads(buf[head + 8:head + 8 + header_len].tobytes().decode('utf-8'))
+    data_start = _da_columnar_align(head + 8 + header_len)
+    blocks = header['blocks']
+
+    def block(i: int):
+        start = data_start + int(blocks[i]['offset'])
+        end = start + int(blocks[i]['nbytes'])
+        if end > len(buf):
+            raise ValueError('DA columnar file is truncated')
+        return buf[start:end]
+
+    index = _da_columnar_decode_index(header['index'], block)
+    columns = _da_columnar_decode_index(header['columns_index'], block)
+    data = {i: _da_columnar_decode(c, block) for i, c in enumerate(header['columns'])}
+    if len(data) == 0:
+        return pd.DataFrame(index=index, columns=columns)
+    # copy=False避免pandas拷贝和合并数据块，保持对内存映射的引用
+    res = pd.DataFrame(data, copy=False)
+    res.columns = columns
+    res.index = index
+    return res
+
+
+def _da_columnar_open(path: str):
+    '''
+    以只读方式打开用于内存映射的文件
+
+    windows下允许其它进程删除和改名（FILE_SHARE_DELETE），工程文件被映射时仍可以被保存时的新文件替换
+    '''
+    if sys.platform != 'win32':
+        return open(path, 'rb')
+    import ctypes
+    import msvcrt
+    from ctypes import wintypes
+    create_file = ctypes.windll.kernel32.CreateFileW
+    create_file.restype = wintypes.HANDLE
+    create_file.argtypes = [wintypes.LPCWSTR, wintypes.DWORD, wintypes.DWORD, wintypes.LPVOID,
+                            wintypes.DWORD, wintypes.DWORD, wintypes.HANDLE]
+    # GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL
+    handle = create_file(path, 0x80000000, 0x7, None, 3, 0x80, None)
+    if handle is None or handle == wintypes.HANDLE(-1).value:
+        raise OSError(ctypes.GetLastError(), f'can not open {path}')
+    return os.fdopen(msvcrt.open_osfhandle(handle, os.O_RDONLY | os.O_BINARY), 'rb')
+
+
+def _da_columnar_map(path: str, offset: int = 0, size: Optional[int] = None) -> np.ndarray:
+    '''
+    以copy-on-write模式内存映射文件的一段，对数组的修改不会写回文件
+    '''
+    with _da_columnar_open(path) as f:
+        if size is None:
+            size = os.fstat(f.fileno()).st_size - offset
+        if size <= 0:
+            return np.zeros(0, dtype=np.uint8)
+        return np.memmap(f, dtype=np.uint8, mode='c', offset=offset, shape=(size,))
+
+
+@log_function_call
+def da_is_columnar_file(path: str) -> bool:
+    '''
+    判断文件是否为DA列式文件
+    :param path: 文件路径
+    :return: bool
+    '''
+    with open(path, 'rb') as f:
+        return f.read(len(_DA_COLUMNAR_MAGIC)) == _DA_COLUMNAR_MAGIC
+
+
+@log_function_call
+def da_to_columnar(df: pd.DataFrame, path: str):
+    '''
+    把dataframe写为DA列式文件，此格式读取时可以通过内存映射按需加载列
+
+    文件结构：magic(8字节) + 头长度(uint64,小端) + 头(json) + 按64字节对齐的数据块
+
+    数值、布尔、日期类型的列按列连续存放原始字节，字符串列以偏移量+UTF-8数据存放，
+    列名、index和类型信息都记录在json头中，文件中不包含任何需要反序列化执行的内容（不使用pickle）
+
+    有json无法无损保存的值（如date、Decimal、bytes、Period、Interval）时，整个dataframe改为保存为parquet，
+    读取时根据文件头区分（见DAData::readFromFile、da_from_archive），parquet也无法保存时抛出异常
+    :param df: pd.DataFrame
+    :param path: 文件路径
+    :return: 此函数不返回值
+    '''
+    payloads = []
+    try:
+        index = _da_columnar_encode_index(df.index, payloads)
+        columns_index = _da_columnar_encode_index(df.columns, payloads)
+        columns = [_da_columnar_encode(df.iloc[:, i], payloads) for i in range(df.shape[1])]
+    except _DAColumnarUnsupported:
+        df.to_parquet(path)
+        return
+    blocks = []
+    offset = 0
+    for p in payloads:
+        blocks.append({'offset': offset, 'nbytes': int(p.nbytes)})
+        offset = _da_columnar_align(offset + p.nbytes)
+    header = json.dumps({'version': 2, 'nrows': int(df.shape[0]), 'index': index, 'columns_index': columns_index,
+                         'columns': columns, 'blocks': blocks}).encode('utf-8')
+    head_size = len(_DA_COLUMNAR_MAGIC) + 8 + len(header)
+    with open(path, 'wb') as f:
+        f.write(_DA_COLUMNAR_MAGIC)
+        f.write(struct.pack('<Q', len(header)))
+        f.write(header)
+        f.write(b'\x00' * (_da_columnar_align(head_size) - head_size))
+        for b, p in zip(blocks, payloads):
+            f.write(p.data)
+            f.write(b'\x00' * (_da_columnar_align(b['nbytes']) - b['nbytes']))
+
+
+@log_function_call
+def da_read_columnar(path: str) -> pd.DataFrame:
+    '''
+    读取DA列式文件
+
+    文件通过np.memmap（copy-on-write模式）映射，原始字节存放的列用np.frombuffer直接构造，
+    不会把整个文件读入内存，只有被访问到的列才会由系统按页加载，对列的修改不会写回文件
+    :param path: 文件路径
+    :return: pd.DataFrame
+    '''
+    return _da_columnar_parse(_da_columnar_map(path))
+
+
+@log_function_call
+def da_from_columnar(df: pd.DataFrame, path: str):
+    '''
+    从DA列式文件加载到dataframe
+    :param df: pd.DataFrame
+    :param path: 文件路径
+    :return: 此函数不返回值，直接改变df
+    '''
+    df.__init__(da_read_columnar(path))
+
+
+def _da_zip_entry_data_offset(path: str, info: zipfile.ZipInfo) -> int:
+    '''
+    获取zip条目数据在文件中的偏移，本地文件头为30字节+文件名+扩展字段
+    '''
+    with open(path, 'rb') as f:
+        f.seek(info.header_offset)
+        local = f.read(30)
+    if len(local) != 30 or local[:4] != b'PK\x03\x04':
+        raise ValueError(f'bad local header of {info.filename} in {path}')
+    name_len, extra_len = struct.unpack('<HH', local[26:30])
+    return info.header_offset + 30 + name_len + extra_len
+
+
+@log_function_call
+def da_from_archive(df: pd.DataFrame, path: str, entry: str):
+    '''
+    从工程档案（zip）的条目中加载dataframe，不需要先把条目解压到临时文件
+
+    以不压缩（stored）方式存放的DA列式条目直接内存映射档案文件中的对应区间，按需加载；
+    压缩存放的条目（旧版本工程）读入内存后解析，旧版本工程的parquet条目同样支持
+    :param df: pd.DataFrame
+    :param path: 档案路径
+    :param entry: 条目在档案中的路径
+    :return: 此函数不返回值，直接改变df
+    '''
+    with zipfile.ZipFile(path) as zf:
+        info = zf.getinfo(entry)
+        if info.compress_type == zipfile.ZIP_STORED and not (info.flag_bits & 0x1):
+            buf = _da_columnar_map(path, _da_zip_entry_data_offset(path, info), info.file_size)
+        else:
+            buf = np.frombuffer(zf.read(entry), dtype=np.uint8)
+    if buf[:5].tobytes() == _DA_COLUMNAR_MAGIC[:5]:
+        df.__init__(_da_columnar_parse(buf))
+    else:
+        df.__init__(pd.read_parquet(io.BytesIO(buf.tobytes())))
+
+
 @log_function_call
 def da_astype(df: pd.DataFrame, colsIndex: List[int], dtype: np.dtype):
     '''
@@ -423,9 +905,10 @@ def da_cast_to_num(df: pd.DataFrame,
         errors = {'ignore', 'raise', 'coerce'},
     '''
     cols = [df.columns[v] for v in colsIndex]
-    for col in cols:
+    for i, col in enumerate(cols):
         df[col] = pd.to_numeric(
             df[col], errors=errors, downcast=downcast)
+        report_progress(i + 1, len(cols))
 
 
 @log_function_call
@@ -448,12 +931,13 @@ def da_cast_to_datetime(df: pd.DataFrame,
         format
     '''
     cols = [df.columns[v] for v in colsIndex]
-    for col in cols:
+    for i, col in enumerate(cols):
         df[col] = pd.to_datetime(
             df[col], errors=errors, dayfirst=dayfirst, yearfirst=yearfirst, utc=utc,
             format=format, exact=exact,
             unit=unit, infer_datetime_format=infer_datetime_format,
             origin=origin, cache=cache)
+        report_progress(i + 1, len(cols))
 
 
 @log_function_call
@@ -566,6 +1050,287 @@ def da_insert_at(df: pd.DataFrame, col: int, series: pd.Series):
     df.insert(col, series.name, series)
 
 
+@log_function_call
+def da_memory_usage(df: pd.DataFrame) -> int:
+    '''
+    获取dataframe占用的内存（字节），包含index，object列按实际内容统计
+    :param df: pd.DataFrame
+    :return: 字节数
+    '''
+    return int(df.memory_usage(index=True, deep=True).sum())
+
+
+@log_function_call
+def da_content_hash(df: pd.DataFrame) -> int:
+    '''
+    计算dataframe内容的64位哈希，包含index、列名和dtype，用于判断数据是否有变化
+    :param df: pd.DataFrame
+    :return: 无符号64位整数
+    '''
+    hasher = hashlib.blake2b(digest_size=8)
+    hasher.update(pd.util.hash_pandas_object(df, index=True).values.tobytes())
+    hasher.update(repr([str(c) for c in df.columns]).encode('utf-8'))
+    hasher.update(repr([str(t) for t in df.dtypes]).encode('utf-8'))
+    return int.from_bytes(hasher.digest(), 'little')
+
+
+@log_function_call
+def da_copy(df: pd.DataFrame) -> pd.DataFrame:
+    '''
+    深拷贝dataframe，用于内存中的快照
+    :param df: pd.DataFrame
+    :return: 副本
+    '''
+    return df.copy(deep=True)
+
+
+@log_function_call
+def da_restore(df: pd.DataFrame, snapshot: pd.DataFrame):
+    '''
+    用快照恢复dataframe，快照本身不会被改变，可以重复恢复
+    :param df: pd.DataFrame
+    :param snapshot: da_copy得到的快照
+    :return: 此函数不返回值，直接改变df
+    '''
+    df.__init__(snapshot.copy(deep=True))
+
+
+@log_function_call
+def da_read_pickle(path: str) -> pd.DataFrame:
+    '''
+    从pickle文件读取dataframe
+    :param path: 文件路径
+    :return: pd.DataFrame
+    '''
+    return pd.read_pickle(path)
+
+
+@log_function_call
+def da_nan_columns(df: pd.DataFrame) -> List[int]:
+    '''
+    含有缺失值的列的索引，填充缺失值的操作只会改变这些列
+    :param df: pd.DataFrame
+    :return: 列索引
+    '''
+    return [int(i) for i in np.flatnonzero(df.isna().any(axis=0).to_numpy())]
+
+
+@log_function_call
+def da_clip_columns(df: pd.DataFrame, lower: Optional[float] = None, upper: Optional[float] = None) -> List[int]:
+    '''
+    da_clip_outlier会改变的列的索引，即存在小于lower或者大于upper的值的数值列
+    :param df: pd.DataFrame
+    :param lower: 下界，None不限制
+    :param upper: 上界，None不限制
+    :return: 列索引
+    '''
+    res = []
+    for i in range(df.shape[1]):
+        s = df.iloc[:, i]
+        if not pd.api.types.is_numeric_dtype(s) or pd.api.types.is_bool_dtype(s):
+            continue
+        if (lower is not None and (s < lower).any()) or (upper is not None and (s > upper).any()):
+            res.append(i)
+    return res
+
+
+@log_function_call
+def da_snapshot_columns(df: pd.DataFrame, colsIndex: List[int]) -> pd.DataFrame:
+    '''
+    提取指定列的副本，列按索引从小到大排列
+    :param df: pd.DataFrame
+    :param colsIndex: 列索引
+    :return: 指定列组成的dataframe副本
+    '''
+    cols = sorted(set(colsIndex))
+    return df.iloc[:, cols].copy(deep=True)
+
+
+@log_function_call
+def da_restore_columns(df: pd.DataFrame, colsIndex: List[int], snapshot: pd.DataFrame, columnCount: Optional[int] = None):
+    '''
+    用da_snapshot_columns得到的快照恢复被修改的列（已有列的位置没有改变）
+    :param df: pd.DataFrame
+    :param colsIndex: 列索引
+    :param snapshot: 列快照
+    :param columnCount: 操作前的列数，操作追加在最后的列会被删除，None表示列数没有改变
+    :return: 此函数不返回值，直接改变df
+    '''
+    if columnCount is not None and df.shape[1] > columnCount:
+        df.drop(columns=df.columns[columnCount:], inplace=True)
+    cols = sorted(set(colsIndex))
+    for i, c in enumerate(cols):
+        s = snapshot.iloc[:, i].copy(deep=True)
+        if hasattr(df, 'isetitem'):
+            df.isetitem(c, s)
+        else:
+            df[df.columns[c]] = s
+
+
+@log_function_call
+def da_restore_dropped_columns(df: pd.DataFrame, colsIndex: List[int], snapshot: pd.DataFrame):
+    '''
+    把da_snapshot_columns得到的快照插回原来的位置，用于撤销删除列
+    :param df: pd.DataFrame
+    :param colsIndex: 删除前的列索引
+    :param snapshot: 列快照
+    :return: 此函数不返回值，直接改变df
+    '''
+    cols = sorted(set(colsIndex))
+    for i, c in enumerate(cols):
+        df.insert(c, snapshot.columns[i], snapshot.iloc[:, i].copy(deep=True), allow_duplicates=True)
+
+
+@log_function_call
+def da_snapshot_rows(df: pd.DataFrame, rowsIndex: List[int]) -> Optional[pd.DataFrame]:
+    '''
+    提取指定行的副本，行按索引从小到大排列
+    da_drop_irow是按标签删除的，index存在重复值时删除的行数和位置无法确定，此时返回None
+    :param df: pd.DataFrame
+    :param rowsIndex: 行索引
+    :return: 指定行组成的dataframe副本，无法按行保存时返回None
+    '''
+    if not df.index.is_unique:
+        return None
+    rows = sorted(set(rowsIndex))
+    return df.iloc[rows].copy(deep=True)
+
+
+@log_function_call
+def da_restore_dropped_rows(df: pd.DataFrame, rowsIndex: List[int], snapshot: pd.DataFrame):
+    '''
+    把da_snapshot_rows得到的快照插回原来的位置，用于撤销删除行
+    :param df: pd.DataFrame
+    :param rowsIndex: 删除前的行索引
+    :param snapshot: 行快照
+    :return: 此函数不返回值，直接改变df
+    '''
+    rows = sorted(set(rowsIndex))
+    remain = df.shape[0]
+    n = remain + len(rows)
+    mask = np.ones(n, dtype=bool)
+    mask[rows] = False
+    order = np.empty(n, dtype=np.int64)
+    order[mask] = np.arange(remain)
+    order[rows] = remain + np.arange(len(rows))
+    df.__init__(pd.concat([df, snapshot]).iloc[order])
+
+
+# 逐行过滤的da_函数需要保留的行的掩码，参数和对应的da_函数完全一致（注意和流水线的_mask_函数不同，
+# 例如da_drop_na的index为空列表时不删除任何行），撤销时只需要保存被删除的行
+def _keep_rows_drop_na(df: pd.DataFrame, axis: int = 0, how: str = 'any', index: Optional[List[int]] = None, thresh: Optional[int] = None):
+    if axis != 0:
+        return None
+    data = df
+    if index is not None:
+        if not df.columns.is_unique:
+            # da_drop_na按列名选择，列名重复时会选中更多的列
+            return None
+        data = df.iloc[:, list(index)]
+    if thresh is not None:
+        return data.notna().sum(axis=1) >= thresh
+    if how == 'all':
+        return data.notna().any(axis=1)
+    return data.notna().all(axis=1)
+
+
+def _keep_rows_drop_duplicates(df: pd.DataFrame, keep: str = 'first', index: Optional[List[int]] = None, ignore_index=False):
+    subset = None
+    if index is not None:
+        subset = df.columns[index].tolist()
+    return ~df.duplicated(subset=subset, keep=keep)
+
+
+def _keep_rows_nstd_filter_outlier_all(df: pd.DataFrame, n=3, axis: Optional[int] = None, index: Optional[List[int]] = None):
+    keep = _keep_rows_nstd_filter_outlier(df, n, axis, index)
+    return np.ones(df.shape[0], dtype=bool) if keep is None else keep
+
+
+_DROPPED_ROWS_MASKS = {
+    'drop_na': _keep_rows_drop_na,
+    'drop_duplicates': _keep_rows_drop_duplicates,
+    'nstd_filter_outlier': _keep_rows_nstd_filter_outlier_all,
+    'data_select': _mask_data_select,
+    'query_datas': _mask_query_datas,
+}
+
+
+@log_function_call
+def da_dropped_rows(df: pd.DataFrame, op: str, args: Optional[Dict] = None) -> Optional[List[int]]:
+    '''
+    计算逐行过滤操作将删除的行，用于撤销时只保存被删除的行（da_snapshot_rows）而不是整个dataframe
+    :param df: pd.DataFrame
+    :param op: 操作名，去掉da_前缀的函数名，支持drop_na(axis=0)、drop_duplicates、nstd_filter_outlier、data_select、query_datas
+    :param args: 操作的参数，和对应的da_函数一致
+    :return: 删除前的行索引，无法确定时返回None
+    '''
+    fun = _DROPPED_ROWS_MASKS.get(op)
+    if fun is None:
+        return None
+    keep = fun(df, **(args or {}))
+    if keep is None:
+        return None
+    return [int(i) for i in np.flatnonzero(~np.asarray(keep, dtype=bool))]
+
+
+@log_function_call
+def da_eval_columns(df: pd.DataFrame, expr: str) -> Optional[List[int]]:
+    '''
+    da_eval_datas会改变的已有列的索引，新增的列追加在最后，撤销时删除即可
+    只识别每一行“列名 = 表达式”形式的赋值，无法确定时返回None
+    :param df: pd.DataFrame
+    :param expr: 表达式
+    :return: 列索引
+    '''
+    cols = set()
+    for line in str(expr).splitlines():
+        line = line.strip()
+        if not line:
+            continue
+        m = re.match(r'^(`[^`]+`|[A-Za-z_]\w*)\s*=(?!=)', line)
+        if m is None:
+            return None
+        name = m.group(1).strip('`')
+        if name in df.columns:
+            loc = df.columns.get_loc(name)
+            if not isinstance(loc, int):
+                return None
+            cols.add(loc)
+    return sorted(cols)
+
+
+@log_function_call
+def da_sort_permutation(df: pd.DataFrame, by: str, ascending: bool) -> pd.DataFrame:
+    '''
+    da_sort排序后每一行在排序前的位置，撤销排序时只需要保存这个排列
+    和DataFrame.sort_values一样通过Series.sort_values（nargsort）计算，结果和da_sort一致
+    :param df: pd.DataFrame
+    :param by: 数据排序依据
+    :param ascending: 数据排序方式
+    :return: 只有一列position的dataframe
+    '''
+    key = df[by]
+    if isinstance(key, pd.DataFrame):
+        # 列名重复时da_sort会失败，这里也无法确定排列
+        raise ValueError('column {} is not unique'.format(by))
+    order = key.reset_index(drop=True).sort_values(ascending=ascending).index.to_numpy()
+    return pd.DataFrame({'position': order.astype(np.int64)})
+
+
+@log_function_call
+def da_restore_permutation(df: pd.DataFrame, snapshot: pd.DataFrame):
+    '''
+    用da_sort_permutation得到的排列恢复排序前的行顺序，用于撤销排序
+    :param df: pd.DataFrame
+    :param snapshot: 排列
+    :return: 此函数不返回值，直接改变df
+    '''
+    order = snapshot.iloc[:, 0].to_numpy()
+    inverse = np.empty_like(order)
+    inverse[order] = np.arange(len(order))
+    df._update_inplace(df.take(inverse))
+
+
 def make_dataframe(size: int = 100) -> pd.DataFrame:
     '''构建一个数据类型较全面的dataframe
 
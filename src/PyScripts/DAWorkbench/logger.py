@@ -1,5 +1,6 @@
 # -*- coding: utf-8 -*-
 import os
+import functools
 from loguru import logger
 import inspect
 
@@ -12,7 +13,9 @@ import inspect
 def log_function_call(func):
     """
     装饰器：自动记录函数调用时的所有参数。
+    原函数可以通过__wrapped__获取，批量调用时可以跳过逐次记录
     """
+    @functools.wraps(func)
     def wrapper(*args, **kwargs):
         # 获取函数签名
         sig = inspect.signature(func)
@@ -0,0 +1,61 @@
+# -*- coding: utf-8 -*-
+import threading
+import contextlib
+from typing import Callable, Optional
+
+'''
+本文件da_打头的变量和函数属于da系统的默认函数，如果改动会导致da系统异常
+
+此文件封装耗时操作的进度报告，进度回调按线程设置，由C++的异步任务（DAPyAsyncTask）在工作线程中设置，
+回调抛出异常（例如任务被取消时抛出KeyboardInterrupt）会中止正在执行的操作
+'''
+
+_da_progress = threading.local()
+
+
+def da_set_progress_callback(callback: Optional[Callable[[int, int], None]]):
+    '''
+    设置当前线程的进度回调
+    :param callback: callback(done, total)，None为取消回调
+    :return: 此函数不返回值
+    '''
+    _da_progress.callback = callback
+    _da_progress.ranges = []
+
+
+def has_progress() -> bool:
+    '''
+    当前线程是否设置了进度回调，没有回调时耗时操作不需要为了报告进度而分块执行
+    '''
+    return getattr(_da_progress, 'callback', None) is not None
+
+
+def report_progress(done: int, total: int):
+    '''
+    报告进度，在@ref progress_range 内报告的进度会映射到外层的区间
+    :param done: 已完成的数量
+    :param total: 总数
+    '''
+    callback = getattr(_da_progress, 'callback', None)
+    if callback is None or total <= 0:
+        return
+    frac = min(1.0, done / total)
+    for base, span in reversed(_da_progress.ranges):
+        frac = base + span * frac
+    callback(int(frac * 1000), 1000)
+
+
+@contextlib.contextmanager
+def progress_range(done: int, total: int):
+    '''
+    内部报告的0~100%映射为外层的done/total~(done+1)/total，用于嵌套的操作，例如批量操作中的一个步骤
+    '''
+    ranges = getattr(_da_progress, 'ranges', None)
+    if ranges is None or total <= 0:
+        yield
+        return
+    ranges.append((done / total, 1.0 / total))
+    try:
+        yield
+    finally:
+        ranges.pop()
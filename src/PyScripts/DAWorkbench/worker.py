@@ -0,0 +1,284 @@
+# -*- coding: utf-8 -*-
+import os
+import sys
+import json
+import uuid
+import base64
+import pickle
+import tempfile
+import importlib
+import traceback
+from typing import Dict, Optional
+
+'''
+本文件da_打头的变量和函数属于da系统的默认函数，如果改动会导致da系统异常
+
+此文件是python工作进程的入口，主程序通过DAPyWorkerPool启动多个工作进程，每个进程有独立的解释器，
+不受主程序GIL的限制
+
+协议：
+- 工作进程加载完成后先向标准输出写入一行就绪消息：@DA-WORKER {"ready":true,"pid":进程号}，主程序收到后才派发请求
+- 主程序每次向标准输入写入一行json请求：{"id":1,"func":"模块.函数","kwargs":{},"frames":{"参数名":"文件路径"},"return_frame":"参数名"}，
+  return_frame可选，函数返回None时（直接修改输入的函数）把这个dataframe参数作为结果返回
+- 工作进程处理完成后向标准输出写入一行以@DA-WORKER开头的json回复：{"id":1,"ok":true,"frames":{},"value":null,"error":""}
+- dataframe不经过管道，以Arrow IPC（feather）文件的形式写入共享内存目录（linux下为/dev/shm），没有pyarrow时退化为pickle，
+  series写入时转换为单列dataframe，arrow中的列统一以位置命名，原始的列标签、列名、索引（层数、名称、RangeIndex）和series名称
+  记录在schema的da_pandas元数据中，读取后精确还原
+- 请求为{"exit":true}或者标准输入关闭时进程退出
+
+函数执行期间的print会被重定向到标准错误，避免干扰协议
+'''
+
+DA_WORKER_REPLY_PREFIX = '@DA-WORKER '
+
+try:
+    import pyarrow as _pa
+    import pyarrow.feather as _feather
+except ImportError:
+    _pa = None
+    _feather = None
+
+
+def da_shared_dir() -> str:
+    '''
+    共享内存目录，linux下为/dev/shm，其余系统为临时目录
+    '''
+    if os.path.isdir('/dev/shm'):
+        return '/dev/shm'
+    return tempfile.gettempdir()
+
+
+def da_shared_path(shm_dir: Optional[str] = None) -> str:
+    '''
+    生成一个共享内存文件路径
+    '''
+    return os.path.join(shm_dir or da_shared_dir(), 'da-{}-{}.arrow'.format(os.getpid(), uuid.uuid4().hex))
+
+
+def _encode_label(v):
+    '''
+    把列标签、索引名编码为可json序列化的值，保留类型，无法直接表示的标签以pickle保存
+    '''
+    import numpy as np
+    if v is None:
+        return ['n']
+    if isinstance(v, (bool, np.bool_)):
+        return ['b', bool(v)]
+    if isinstance(v, (int, np.integer)):
+        return ['i', int(v)]
+    if isinstance(v, str):
+        return ['s', v]
+    if isinstance(v, (float, np.floating)):
+        return ['f', repr(float(v))]
+    if isinstance(v, tuple):
+        return ['t', [_encode_label(i) for i in v]]
+    return ['p', base64.b64encode(pickle.dumps(v)).decode('ascii')]
+
+
+def _decode_label(v):
+    '''
+    _encode_label的逆过程
+    '''
+    tag = v[0]
+    if tag == 'n':
+        return None
+    if tag == 'f':
+        return float(v[1])
+    if tag == 't':
+        return tuple(_decode_label(i) for i in v[1])
+    if tag == 'p':
+        return pickle.loads(base64.b64decode(v[1]))
+    return v[1]
+
+
+def _encode_axis(axis) -> Dict:
+    '''
+    记录索引或列的结构：层数、名称，RangeIndex还会记录起点、终点和步长
+    '''
+    import pandas as pd
+    info = {'nlevels': axis.nlevels, 'names': [_encode_label(n) for n in axis.names]}
+    if isinstance(axis, pd.RangeIndex):
+        info['range'] = [axis.start, axis.stop, axis.step]
+    return info
+
+
+def da_write_shared(df, path: str):
+    '''
+    把dataframe写入共享内存文件
+    :param df: pd.DataFrame或者pd.Series
+    :param path: 文件路径
+    '''
+    import pandas as pd
+    if _feather is None:
+        df.to_pickle(path)
+        return
+    is_series = isinstance(df, pd.Series)
+    meta = {'series': is_series}
+    if is_series:
+        meta['name'] = _encode_label(df.name)
+        df = df.to_frame(name=0)
+    meta['columns'] = [_encode_label(c) for c in df.columns]
+    meta['columns_axis'] = _encode_axis(df.columns)
+    meta['index'] = _encode_axis(df.index)
+    # arrow中的列以位置命名，避免非字符串和重复的列名，索引为RangeIndex时只记录参数，其余索引的每一层单独保存为一列
+    data = {}
+    if not isinstance(df.index, pd.RangeIndex):
+        for i in range(df.index.nlevels):
+            data['i{}'.format(i)] = df.index.get_level_values(i).array
+    for i in range(df.shape[1]):
+        data['c{}'.format(i)] = df.iloc[:, i].array
+    table = _pa.Table.from_pandas(pd.DataFrame(data, index=pd.RangeIndex(len(df))), preserve_index=False)
+    table = table.replace_schema_metadata({**(table.schema.metadata or {}),
+                                           b'da_pandas': json.dumps(meta).encode('utf-8')})
+    _feather.write_feather(table, path, compression='uncompressed')
+
+
+def _restore_pandas(df, meta: Dict):
+    '''
+    按da_pandas元数据还原列标签、索引和series
+    '''
+    import pandas as pd
+    index_info = meta['index']
+    names = [_decode_label(n) for n in index_info['names']]
+    if 'range' in index_info:
+        index = pd.RangeIndex(*index_info['range'], name=names[0])
+    else:
+        # 不使用set_index，避免等差的整数索引被转换为RangeIndex
+        keys = ['i{}'.format(i) for i in range(index_info['nlevels'])]
+        if len(keys) == 1:
+            index = pd.Index(df[keys[0]].array, name=names[0])
+        else:
+            index = pd.MultiIndex.from_arrays([df[k].array for k in keys], names=names)
+        df = df.drop(columns=keys)
+    df.index = index
+    labels = [_decode_label(c) for c in meta['columns']]
+    columns_info = meta['columns_axis']
+    if 'range' in columns_info:
+        columns = pd.RangeIndex(*columns_info['range'])
+    elif columns_info['nlevels'] > 1:
+        columns = pd.MultiIndex.from_tuples(labels)
+    else:
+        columns = pd.Index(labels)
+    columns.names = [_decode_label(n) for n in columns_info['names']]
+    df.columns = columns
+    if meta.get('series'):
+        df = df.iloc[:, 0]
+        df.name = _decode_label(meta['name'])
+    return df
+
+
+def da_read_shared(path: str, remove: bool = True, as_frame: bool = False):
+    '''
+    从共享内存文件读取dataframe
+    :param path: 文件路径
+    :param remove: 读取后是否删除文件
+    :param as_frame: 为True时series也以dataframe返回
+    '''
+    import pandas as pd
+    try:
+        if _feather is None:
+            df = pd.read_pickle(path)
+        else:
+            table = _feather.read_table(path, memory_map=True)
+            df = table.to_pandas()
+            metadata = table.schema.metadata or {}
+            if b'da_pandas' in metadata:
+                df = _restore_pandas(df, json.loads(metadata[b'da_pandas'].decode('utf-8')))
+        if as_frame and isinstance(df, pd.Series):
+            df = df.to_frame()
+        return df
+    finally:
+        if remove:
+            try:
+                os.remove(path)
+            except OSError:
+                pass
+
+
+def _resolve(name: str):
+    '''
+    把“模块.函数”解析为函数对象
+    '''
+    module_name, _, attr = name.rpartition('.')
+    if not module_name:
+        raise ValueError('function name must be module.function,but got {}'.format(name))
+    return getattr(importlib.import_module(module_name), attr)
+
+
+def _to_reply(obj, shm_dir: str) -> Dict:
+    '''
+    把函数返回值转换为回复，dataframe写入共享内存，其余值需要能被json序列化
+    '''
+    import pandas as pd
+    frame_types = (pd.DataFrame, pd.Series)
+    if isinstance(obj, frame_types):
+        obj = {'result': obj}
+    elif isinstance(obj, (list, tuple)) and obj and all(isinstance(v, frame_types) for v in obj):
+        obj = {str(i): v for i, v in enumerate(obj)}
+    frames = {}
+    value = None
+    if isinstance(obj, dict) and obj and all(isinstance(v, frame_types) for v in obj.values()):
+        for k, v in obj.items():
+            path = da_shared_path(shm_dir)
+            da_write_shared(v, path)
+            frames[str(k)] = path
+    else:
+        try:
+            json.dumps(obj)
+            value = obj
+        except (TypeError, ValueError):
+            value = str(obj)
+    return {'ok': True, 'frames': frames, 'value': value, 'error': ''}
+
+
+def _handle(req: Dict, shm_dir: str) -> Dict:
+    kwargs = dict(req.get('kwargs') or {})
+    for k, path in (req.get('frames') or {}).items():
+        # 输入文件由主程序负责删除
+        kwargs[k] = da_read_shared(path, remove=False)
+    fn = _resolve(req['func'])
+    res = fn(**kwargs)
+    return_frame = req.get('return_frame')
+    if res is None and return_frame in kwargs:
+        # da_函数的约定是直接修改df，返回修改后的输入
+        res = kwargs[return_frame]
+    return _to_reply(res, shm_dir)
+
+
+def da_worker_main(argv=None):
+    '''
+    工作进程主循环
+    '''
+    argv = sys.argv[1:] if argv is None else argv
+    shm_dir = da_shared_dir()
+    if '--shm-dir' in argv:
+        shm_dir = argv[argv.index('--shm-dir') + 1]
+    out = sys.stdout
+    # 用户函数的print输出到标准错误
+    sys.stdout = sys.stderr
+    # 先加载pandas，就绪后主程序才派发请求
+    import pandas  # noqa: F401
+    out.write(DA_WORKER_REPLY_PREFIX + json.dumps({'ready': True, 'pid': os.getpid()}) + '\n')
+    out.flush()
+    for line in sys.stdin:
+        line = line.strip()
+        if not line:
+            continue
+        rid = None
+        try:
+            req = json.loads(line)
+            if req.get('exit'):
+                break
+            rid = req.get('id')
+            reply = _handle(req, shm_dir)
+        except Exception:
+            reply = {'ok': False, 'frames': {}, 'value': None, 'error': traceback.format_exc()}
+        reply['id'] = rid
+        out.write(DA_WORKER_REPLY_PREFIX + json.dumps(reply) + '\n')
+        out.flush()
+
+
+if __name__ == '__main__':
+    # 作为脚本运行时，把PyScripts目录加入路径，以便引入DAWorkbench包
+    sys.path.insert(0, os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+    da_worker_main()
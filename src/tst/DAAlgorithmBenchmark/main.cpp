@@ -0,0 +1,167 @@
+﻿// da_algorithm.hpp 拷贝类算法的微基准
+// 对比三种实现：
+// scalar   ：前向迭代器，走原来逐个遍历的通用实现
+// simd     ：随机访问迭代器，区段拷贝/无分支gather，可被编译器向量化，关闭并行
+// parallel ：随机访问迭代器，分块多线程
+// 三种实现的结果必须一致，不一致时返回1，--quick只测较小的数据量（用于ctest）
+// 建议以-O3 -march=native编译
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <vector>
+#include "da_algorithm.hpp"
+
+// 把指针包装为前向迭代器，用于测试通用实现
+template< typename T >
+class ForwardIterator
+{
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = typename std::remove_const< T >::type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = T*;
+    using reference         = T&;
+
+    ForwardIterator(T* p = nullptr) : m_p(p)
+    {
+    }
+    reference operator*() const
+    {
+        return *m_p;
+    }
+    ForwardIterator& operator++()
+    {
+        ++m_p;
+        return *this;
+    }
+    ForwardIterator operator++(int)
+    {
+        ForwardIterator r = *this;
+        ++m_p;
+        return r;
+    }
+    bool operator==(const ForwardIterator& o) const
+    {
+        return m_p == o.m_p;
+    }
+    bool operator!=(const ForwardIterator& o) const
+    {
+        return m_p != o.m_p;
+    }
+
+private:
+    T* m_p;
+};
+
+template< typename T >
+ForwardIterator< T > fwd(T* p)
+{
+    return ForwardIterator< T >(p);
+}
+
+// 多次执行取最短的时间，单位毫秒
+static double bench(const std::function< void() >& fun, int repeat = 5)
+{
+    double best = 1e100;
+    for (int i = 0; i < repeat; ++i) {
+        auto b = std::chrono::steady_clock::now();
+        fun();
+        auto e = std::chrono::steady_clock::now();
+        best   = std::min(best, std::chrono::duration< double, std::milli >(e - b).count());
+    }
+    return best;
+}
+
+// 分别以标量、向量化、并行执行，out为输出，比较三种实现的结果，一致返回true
+static bool run(const char* name,
+                std::size_t n,
+                std::vector< double >& out,
+                const std::function< void() >& scalar,
+                const std::function< void() >& vectorized)
+{
+    const std::size_t oldMinSize = DA::get_parallel_min_size();
+    std::fill(out.begin(), out.end(), 0.0);
+    const double ts                    = bench(scalar);
+    const std::vector< double > expect = out;
+    std::fill(out.begin(), out.end(), 0.0);
+    DA::set_parallel_min_size(0);
+    const double tv = bench(vectorized);
+    bool same       = (out == expect);
+    std::fill(out.begin(), out.end(), 0.0);
+    DA::set_parallel_min_size(4096);
+    const double tp = bench(vectorized);
+    same            = same && (out == expect);
+    DA::set_parallel_min_size(oldMinSize);
+    std::printf("%-20s %10zu %12.3f %12.3f %12.3f %8.2fx %8.2fx%s\n", name, n, ts, tv, tp, ts / tv, ts / tp, same ? "" : "  MISMATCH");
+    return same;
+}
+
+int main(int argc, char* argv[])
+{
+    const bool quick = (argc > 1 && std::strcmp(argv[ 1 ], "--quick") == 0);
+    const std::size_t maxSize = quick ? (std::size_t(1) << 16) : (std::size_t(1) << 24);
+    int failed                = 0;
+    std::printf("%-20s %10s %12s %12s %12s %9s %9s\n", "kernel", "size", "scalar(ms)", "simd(ms)", "parallel(ms)", "simd", "parallel");
+    std::mt19937 rng(1988);
+    for (std::size_t n : { std::size_t(1) << 12, std::size_t(1) << 16, std::size_t(1) << 20, std::size_t(1) << 24 }) {
+        if (n > maxSize) {
+            break;
+        }
+        std::vector< double > input(n);
+        for (double& v : input) {
+            v = std::uniform_real_distribution< double >(-1, 1)(rng);
+        }
+        // 有序的索引，约10%
+        std::vector< int > indexs;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (rng() % 10 == 0) {
+                indexs.push_back(static_cast< int >(i));
+            }
+        }
+        // 随机排列，用于gather
+        std::vector< int > perm(n);
+        std::iota(perm.begin(), perm.end(), 0);
+        std::shuffle(perm.begin(), perm.end(), rng);
+        std::vector< double > out(n);
+        const double* in = input.data();
+        const int* idx   = indexs.data();
+        double* o        = out.data();
+
+        failed += !run(
+            "copy_out_of_indexs",
+            n,
+            out,
+            [ & ]() { DA::copy_out_of_indexs(fwd(in), fwd(in + n), fwd(idx), fwd(idx + indexs.size()), fwd(o)); },
+            [ & ]() { DA::copy_out_of_indexs(in, in + n, idx, idx + indexs.size(), o); });
+        failed += !run(
+            "copy_inner_indexs",
+            n,
+            out,
+            [ & ]() { DA::copy_inner_indexs(fwd(in), fwd(in + n), fwd(idx), fwd(idx + indexs.size()), fwd(o)); },
+            [ & ]() { DA::copy_inner_indexs(in, in + n, idx, idx + indexs.size(), o); });
+        failed += !run(
+            "gather",
+            n,
+            out,
+            [ & ]() { DA::copy_inner_indexs(in, fwd(perm.data()), fwd(perm.data() + n), fwd(o)); },
+            [ & ]() { DA::copy_inner_indexs(in, perm.data(), perm.data() + n, o); });
+        auto op3 = [](double a, double b, double c) { return a * b + c; };
+        failed += !run(
+            "transform(3)",
+            n,
+            out,
+            [ & ]() { DA::transform(fwd(in), fwd(in + n), fwd(in), fwd(in), fwd(o), op3); },
+            [ & ]() {
+                if (DA::get_parallel_min_size() == 0) {
+                    DA::transform(in, in + n, in, in, o, op3);
+                } else {
+                    DA::parallel_transform(in, in + n, in, in, o, op3);
+                }
+            });
+    }
+    std::printf("%s\n", failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,154 @@
+﻿// DAColumnarTable.hpp计算内核的测试
+// - 聚合：Int64列的Sum/Min/Max保持Int64，Sum溢出时回绕，null被忽略，空表的Count为0、其余为无效值
+// - 比较：null不满足任何比较，Int64列和非整数、±inf、超出Int64范围的浮点数、非数值比较
+// - 类型转换：浮点数写入Int64列时向0截断，NaN、±inf和超出Int64范围的值为null，Double列的intAt不会溢出
+// - removeColumn的越界检查
+// 全部通过返回0，否则返回1
+#include <cstdio>
+#include <limits>
+#include <vector>
+#include <QDebug>
+#include "DAColumnarTable.hpp"
+
+using namespace DA;
+
+static int s_failed = 0;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        qCritical() << "check failed:" << what;
+        ++s_failed;
+    }
+}
+
+static std::vector< int > to_vector(const DAColumnarTable::Mask& m)
+{
+    return std::vector< int >(m.begin(), m.end());
+}
+
+// Int64列 [1, 2, null, 4]
+static DAColumnarTable make_int_table()
+{
+    DAColumnarTable t;
+    t.addColumn(DAColumnarColumn::String, "key");
+    t.addColumn(DAColumnarColumn::Int64, "value");
+    t.appendRow({ "a", 1 });
+    t.appendRow({ "b", 2 });
+    t.appendRow({ "a", QVariant() });
+    t.appendRow({ "a", 4 });
+    return t;
+}
+
+static void tst_aggregate()
+{
+    const DAColumnarTable t = make_int_table();
+    const QVariant sum      = t.aggregate(1, DAColumnarTable::Sum);
+    check(sum.userType() == QMetaType::LongLong && sum.toLongLong() == 7, "int sum");
+    check(t.aggregate(1, DAColumnarTable::Count).toLongLong() == 3, "count ignores null");
+    check(t.aggregate(1, DAColumnarTable::Mean).toDouble() == 7.0 / 3.0, "mean");
+    check(t.aggregate(1, DAColumnarTable::Min).toLongLong() == 1, "int min");
+    check(t.aggregate(1, DAColumnarTable::Max).toLongLong() == 4, "int max");
+    // 和numpy一样溢出时回绕
+    DAColumnarTable big;
+    big.addColumn(DAColumnarColumn::Int64, "v");
+    big.appendRow({ std::numeric_limits< qlonglong >::max() });
+    big.appendRow({ 1 });
+    check(big.aggregate(0, DAColumnarTable::Sum).toLongLong() == std::numeric_limits< qlonglong >::min(), "int sum wraps");
+    // 全为null
+    DAColumnarTable nulls;
+    nulls.addColumn(DAColumnarColumn::Double, "v");
+    nulls.appendRow({ QVariant() });
+    check(nulls.aggregate(0, DAColumnarTable::Count).toLongLong() == 0, "count of nulls");
+    check(nulls.aggregate(0, DAColumnarTable::Sum).toDouble() == 0.0, "sum of nulls");
+    check(!nulls.aggregate(0, DAColumnarTable::Mean).isValid(), "mean of nulls");
+    // 空表
+    DAColumnarTable empty;
+    empty.addColumn(DAColumnarColumn::Double, "v");
+    check(empty.aggregate(0, DAColumnarTable::Count).toInt() == 0, "count of empty table");
+    check(!empty.aggregate(0, DAColumnarTable::Max).isValid(), "max of empty table");
+    // 分组
+    const DAColumnarTable g = t.groupBy({ 0 }, { { 1, DAColumnarTable::Sum, QString() } });
+    check(g.rowCount() == 2 && g.columnCount() == 2, "group by shape");
+    check(g.value(0, 0).toString() == "a" && g.value(0, 1).toLongLong() == 5, "group a");
+    check(g.value(1, 0).toString() == "b" && g.value(1, 1).toLongLong() == 2, "group b");
+    check(g.column(1)->name() == "value_sum", "aggregate column name");
+}
+
+static void tst_compare()
+{
+    const DAColumnarTable t = make_int_table();
+    const double inf        = std::numeric_limits< double >::infinity();
+    const double nan        = std::numeric_limits< double >::quiet_NaN();
+    check(to_vector(t.compare(1, DAColumnarTable::Equal, 2)) == std::vector< int > { 0, 1, 0, 0 }, "int equal");
+    check(to_vector(t.compare(1, DAColumnarTable::Greater, 1.5)) == std::vector< int > { 0, 1, 0, 1 }, "int greater than double");
+    check(to_vector(t.compare(1, DAColumnarTable::LessEqual, 2.0)) == std::vector< int > { 1, 1, 0, 0 }, "int less equal integral double");
+    check(to_vector(t.compare(1, DAColumnarTable::Less, inf)) == std::vector< int > { 1, 1, 0, 1 }, "int less than inf");
+    check(to_vector(t.compare(1, DAColumnarTable::Greater, -inf)) == std::vector< int > { 1, 1, 0, 1 }, "int greater than -inf");
+    check(to_vector(t.compare(1, DAColumnarTable::Less, 1e30)) == std::vector< int > { 1, 1, 0, 1 }, "int less than 1e30");
+    check(to_vector(t.compare(1, DAColumnarTable::Equal, nan)) == std::vector< int > { 0, 0, 0, 0 }, "int equal nan");
+    check(to_vector(t.compare(1, DAColumnarTable::Equal, "abc")) == std::vector< int > { 0, 0, 0, 0 }, "int equal string");
+    check(to_vector(t.compare(1, DAColumnarTable::NotEqual, "abc")) == std::vector< int > { 1, 1, 0, 1 }, "int not equal string");
+    check(to_vector(t.compare(1, DAColumnarTable::Equal, QVariant())) == std::vector< int > { 0, 0, 0, 0 }, "compare invalid");
+    check(to_vector(t.compare(0, DAColumnarTable::Equal, "a")) == std::vector< int > { 1, 0, 1, 1 }, "string equal");
+    check(to_vector(t.isNullMask(1)) == std::vector< int > { 0, 0, 1, 0 }, "null mask");
+    const DAColumnarTable f = t.filter(t.compare(1, DAColumnarTable::Greater, 1));
+    check(f.rowCount() == 2 && f.value(0, 1).toLongLong() == 2 && f.value(1, 1).toLongLong() == 4, "filter");
+}
+
+static void tst_cast()
+{
+    const double inf = std::numeric_limits< double >::infinity();
+    const double nan = std::numeric_limits< double >::quiet_NaN();
+    std::int64_t v   = 0;
+    check(DAColumnarColumn::toInt64(-9223372036854775808.0, v) && v == std::numeric_limits< std::int64_t >::min(), "int64 min");
+    check(DAColumnarColumn::toInt64(9223372036854774784.0, v) && v == 9223372036854774784LL, "largest double below 2^63");
+    check(!DAColumnarColumn::toInt64(9223372036854775808.0, v), "2^63 is out of range");
+    check(!DAColumnarColumn::toInt64(-9223372036854777856.0, v), "below int64 min");
+
+    DAColumnarColumn c(DAColumnarColumn::Int64);
+    c.appendDouble(2.7);
+    c.appendDouble(-2.7);
+    c.appendDouble(nan);
+    c.appendDouble(inf);
+    c.appendDouble(-inf);
+    c.appendDouble(1e30);
+    c.append(QVariant(2.7));
+    c.append(QVariant(1e30));
+    c.append(QVariant(QString("12")));
+    c.append(QVariant(QString("abc")));
+    check(c.size() == 10 && c.nullCount() == 6, "int column size and null count");
+    check(c.value(0).toLongLong() == 2 && c.value(1).toLongLong() == -2, "double truncated toward zero");
+    check(c.isNull(2) && c.isNull(3) && c.isNull(4) && c.isNull(5), "nan/inf/out of range become null");
+    check(c.value(6).toLongLong() == 2 && c.isNull(7), "double QVariant");
+    check(c.value(8).toLongLong() == 12 && c.isNull(9), "string QVariant");
+
+    DAColumnarColumn d(DAColumnarColumn::Double);
+    d.appendDouble(-3.9);
+    d.appendDouble(inf);
+    d.appendDouble(nan);
+    d.appendDouble(1e30);
+    check(d.intAt(0) == -3 && d.intAt(1) == 0 && d.intAt(2) == 0 && d.intAt(3) == 0, "double column intAt");
+    check(d.nullCount() == 0 && std::isinf(d.doubleAt(1)), "double column keeps inf");
+}
+
+static void tst_remove_column()
+{
+    DAColumnarTable t = make_int_table();
+    check(!t.removeColumn(-1) && !t.removeColumn(2) && t.columnCount() == 2, "remove out of range");
+    check(t.removeColumn(0) && t.columnCount() == 1 && t.rowCount() == 4 && t.column(0)->name() == "value", "remove first column");
+    check(t.removeColumn(0) && t.columnCount() == 0 && t.rowCount() == 0, "remove last column");
+    check(!t.removeColumn(0), "remove from empty table");
+}
+
+int main(int argc, char* argv[])
+{
+    Q_UNUSED(argc);
+    Q_UNUSED(argv);
+    tst_aggregate();
+    tst_compare();
+    tst_cast();
+    tst_remove_column();
+    std::printf("%s\n", s_failed ? "FAILED" : "PASSED");
+    return s_failed ? 1 : 0;
+}
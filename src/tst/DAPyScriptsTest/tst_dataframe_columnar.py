@@ -0,0 +1,106 @@
+# -*- coding: utf-8 -*-
+# DA列式文件的往返测试，对应da_to_columnar/da_read_columnar/da_from_archive
+# 列式文件无法无损保存的值应改为保存parquet，读取后与原来完全一致
+# 全部通过返回0，否则返回1
+import datetime
+import decimal
+import os
+import sys
+import tempfile
+import traceback
+import zipfile
+
+import numpy as np
+import pandas as pd
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'PyScripts'))
+import DAWorkbench.dataframe as D  # noqa: E402
+
+
+def _read_back(df):
+    '''
+    写入后按DAData::readFromFile的方式读取，返回(是否为列式文件, 读取的dataframe)
+    '''
+    with tempfile.TemporaryDirectory() as tmp:
+        path = os.path.join(tmp, 'data')
+        D.da_to_columnar(df, path)
+        columnar = D.da_is_columnar_file(path)
+        res = pd.DataFrame()
+        if columnar:
+            # 内存映射的文件需要在删除目录前释放
+            res = D.da_read_columnar(path).copy(deep=True)
+        else:
+            D.da_from_parquet(res, path)
+        # 工程档案中不压缩存放的条目
+        archive = os.path.join(tmp, 'project.zip')
+        with zipfile.ZipFile(archive, 'w', zipfile.ZIP_STORED) as zf:
+            zf.write(path, 'data/0')
+        fromzip = pd.DataFrame()
+        D.da_from_archive(fromzip, archive, 'data/0')
+        fromzip = fromzip.copy(deep=True)
+    pd.testing.assert_frame_equal(res, fromzip, check_exact=True)
+    return columnar, res
+
+
+def tst_native_columns():
+    df = pd.DataFrame({
+        'f': [1.5, np.nan, 3.0],
+        'i': np.array([1, 2, 3], dtype=np.int64),
+        's': ['x', None, 'z'],
+        't': pd.to_datetime(['2024-01-01', '2024-01-02', None]),
+        'c': pd.Categorical(['a', 'b', 'a']),
+        'n': pd.array([1, None, 3], dtype='Int64'),
+        'o': pd.Series([1, 'a', 2.5], dtype=object),
+    }, index=pd.Index([10, 20, 30], name='id'))
+    columnar, res = _read_back(df)
+    if not columnar:
+        raise AssertionError('native columns should be saved as DA columnar file')
+    pd.testing.assert_frame_equal(res, df, check_exact=True)
+
+
+def tst_object_columns_fallback():
+    df = pd.DataFrame({
+        'date': pd.Series([datetime.date(2024, 1, 1), datetime.date(2024, 2, 29), None], dtype=object),
+        'decimal': pd.Series([decimal.Decimal('1.10'), decimal.Decimal('-2.5'), None], dtype=object),
+        'bytes': pd.Series([b'\x00\xff', b'abc', None], dtype=object),
+        'period': pd.period_range('2024-01', periods=3, freq='M'),
+        'interval': pd.interval_range(0, 3),
+    })
+    for name in df.columns:
+        sub = df[[name]]
+        columnar, res = _read_back(sub)
+        if columnar:
+            raise AssertionError('{} column should fall back to parquet'.format(name))
+        pd.testing.assert_frame_equal(res, sub, check_exact=True)
+        # 原来会被转换为字符串，确认值的类型没有改变
+        for a, b in zip(res[name], sub[name]):
+            if type(a) is not type(b):
+                raise AssertionError('{} value {!r} changed to {!r}'.format(name, b, a))
+    columnar, res = _read_back(df)
+    if columnar:
+        raise AssertionError('frame with object columns should fall back to parquet')
+    pd.testing.assert_frame_equal(res, df, check_exact=True)
+
+
+def tst_column_labels():
+    # 列名和index一样按列编码，不会被转换为字符串
+    df = pd.DataFrame({pd.Timestamp('2024-01-01'): [1.0, 2.0], pd.Timestamp('2024-01-02'): [3.0, 4.0]})
+    columnar, res = _read_back(df)
+    if not columnar:
+        raise AssertionError('timestamp column labels should be saved as DA columnar file')
+    pd.testing.assert_frame_equal(res, df, check_exact=True)
+
+
+if __name__ == '__main__':
+    failed = 0
+    for name, fun in sorted(globals().items()):
+        if name.startswith('tst_') and callable(fun):
+            try:
+                fun()
+                print('PASS', name)
+            except Exception:
+                failed += 1
+                print('FAIL', name)
+                traceback.print_exc()
+    print('FAILED' if failed else 'PASSED')
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,110 @@
+# -*- coding: utf-8 -*-
+# 撤销数据的测试，对应DACommandWithTemporaryData只保存被删除的行、被改变的列或排序的排列
+# 执行操作前计算快照，执行后用快照恢复，dataframe应与原来完全一致
+# 全部通过返回0，否则返回1
+import os
+import sys
+import traceback
+
+import numpy as np
+import pandas as pd
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'PyScripts'))
+import DAWorkbench.dataframe as D  # noqa: E402
+
+
+def _make():
+    return pd.DataFrame({
+        'a': [1.0, np.nan, 3.0, 3.0, 100.0, 2.0, np.nan, 4.0],
+        'b': [1, 2, 3, 3, 4, 1, 7, 2],
+        's': ['x', 'y', 'z', 'z', 'w', 'x', None, 'v'],
+    }, index=[10, 11, 12, 13, 14, 15, 16, 17])
+
+
+def _check_rows(op, args, fun):
+    df = _make()
+    orig = df.copy(deep=True)
+    rows = D.da_dropped_rows(df, op, args)
+    if rows is None:
+        raise AssertionError('{} can not compute dropped rows'.format(op))
+    snapshot = D.da_snapshot_rows(df, rows)
+    fun(df, **args)
+    if df.shape[0] != orig.shape[0] - len(rows):
+        raise AssertionError('{} dropped {} rows, expected {}'.format(op, orig.shape[0] - df.shape[0], len(rows)))
+    D.da_restore_dropped_rows(df, rows, snapshot)
+    pd.testing.assert_frame_equal(df, orig, check_exact=True)
+    return rows
+
+
+def tst_drop_na():
+    if _check_rows('drop_na', {'axis': 0, 'how': 'any', 'index': [0, 2], 'thresh': None}, D.da_drop_na) != [1, 6]:
+        raise AssertionError('drop_na dropped wrong rows')
+    _check_rows('drop_na', {'axis': 0, 'how': 'all', 'index': [0, 2], 'thresh': None}, D.da_drop_na)
+    _check_rows('drop_na', {'axis': 0, 'how': 'any', 'index': [0], 'thresh': 1}, D.da_drop_na)
+    # 和da_drop_na一致，空的列索引不删除任何行
+    if _check_rows('drop_na', {'axis': 0, 'how': 'any', 'index': [], 'thresh': None}, D.da_drop_na) != []:
+        raise AssertionError('drop_na with empty index should not drop rows')
+
+
+def tst_drop_duplicates():
+    if _check_rows('drop_duplicates', {'keep': 'first', 'index': None}, D.da_drop_duplicates) != [3]:
+        raise AssertionError('drop_duplicates dropped wrong rows')
+    _check_rows('drop_duplicates', {'keep': 'last', 'index': [1]}, D.da_drop_duplicates)
+
+
+def tst_nstd_filter_outlier():
+    _check_rows('nstd_filter_outlier', {'n': 1.0, 'axis': 1, 'index': [0]}, D.da_nstd_filter_outlier)
+    _check_rows('nstd_filter_outlier', {'n': 1.0, 'axis': 1, 'index': [0, 1]}, D.da_nstd_filter_outlier)
+    # 只过滤行，axis=0时不删除
+    _check_rows('nstd_filter_outlier', {'n': 1.0, 'axis': 0, 'index': [0]}, D.da_nstd_filter_outlier)
+
+
+def tst_data_select():
+    _check_rows('data_select', {'lower': 2.0, 'upper': 4.0, 'index': 'a'}, D.da_data_select)
+    _check_rows('data_select', {'lower': None, 'upper': 3.0, 'index': 'b'}, D.da_data_select)
+
+
+def tst_query_datas():
+    _check_rows('query_datas', {'expr': 'b > 2 and a < 50'}, D.da_query_datas)
+
+
+def tst_eval_columns():
+    df = _make()
+    orig = df.copy(deep=True)
+    expr = 'b = b * 2\nc = a + b'
+    cols = D.da_eval_columns(df, expr)
+    if cols != [1]:
+        raise AssertionError('eval columns should be [1], got {}'.format(cols))
+    snapshot = D.da_snapshot_columns(df, cols)
+    D.da_eval_datas(df, expr)
+    D.da_restore_columns(df, cols, snapshot, orig.shape[1])
+    pd.testing.assert_frame_equal(df, orig, check_exact=True)
+    if D.da_eval_columns(df, 'a + b') is not None:
+        raise AssertionError('expression without assignment should not be recognized')
+
+
+def tst_sort_permutation():
+    for by, ascending in (('a', True), ('b', False), ('s', True)):
+        df = _make()
+        orig = df.copy(deep=True)
+        perm = D.da_sort_permutation(df, by, ascending)
+        D.da_sort(df, by, ascending)
+        expected = orig.take(perm.iloc[:, 0].to_numpy())
+        pd.testing.assert_frame_equal(df, expected, check_exact=True)
+        D.da_restore_permutation(df, perm)
+        pd.testing.assert_frame_equal(df, orig, check_exact=True)
+
+
+if __name__ == '__main__':
+    failed = 0
+    for name, fun in sorted(globals().items()):
+        if name.startswith('tst_') and callable(fun):
+            try:
+                fun()
+                print('PASS', name)
+            except Exception:
+                failed += 1
+                print('FAIL', name)
+                traceback.print_exc()
+    print('FAILED' if failed else 'PASSED')
+    sys.exit(1 if failed else 0)
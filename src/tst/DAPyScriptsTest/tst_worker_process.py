@@ -0,0 +1,119 @@
+# -*- coding: utf-8 -*-
+# DAWorkbench.worker工作进程协议的测试
+# 按DAPyWorkerPool的方式启动worker.py，通过标准输入输出发送请求：
+# - 就绪消息先于任何回复
+# - 返回dataframe的函数，结果写入共享内存
+# - 直接修改输入的函数（返回None）在指定return_frame时返回修改后的输入
+# - 上一次的输出文件可以直接作为下一次的输入
+# - 异常返回traceback，进程继续处理后续请求
+# 全部通过返回0，否则返回1
+import json
+import os
+import subprocess
+import sys
+import tempfile
+import traceback
+
+import pandas as pd
+
+PYSCRIPTS_DIR = os.path.normpath(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'PyScripts'))
+sys.path.insert(0, PYSCRIPTS_DIR)
+from DAWorkbench.worker import DA_WORKER_REPLY_PREFIX, da_write_shared, da_read_shared  # noqa: E402
+
+
+class Worker:
+    def __init__(self):
+        self.shm_dir = tempfile.mkdtemp(prefix='tst-da-worker-')
+        self.proc = subprocess.Popen([sys.executable, '-u', os.path.join(PYSCRIPTS_DIR, 'DAWorkbench', 'worker.py'),
+                                      '--shm-dir', self.shm_dir],
+                                     stdin=subprocess.PIPE, stdout=subprocess.PIPE, text=True)
+        self.next_id = 1
+
+    def read_reply(self):
+        while True:
+            line = self.proc.stdout.readline()
+            if not line:
+                raise AssertionError('worker exited')
+            if line.startswith(DA_WORKER_REPLY_PREFIX):
+                return json.loads(line[len(DA_WORKER_REPLY_PREFIX):])
+
+    def call(self, func, frames=None, kwargs=None, return_frame=None):
+        req = {'id': self.next_id, 'func': func, 'kwargs': kwargs or {}, 'frames': frames or {}}
+        if return_frame:
+            req['return_frame'] = return_frame
+        self.next_id += 1
+        self.proc.stdin.write(json.dumps(req) + '\n')
+        self.proc.stdin.flush()
+        reply = self.read_reply()
+        if reply['id'] != req['id']:
+            raise AssertionError('reply id {} != {}'.format(reply['id'], req['id']))
+        return reply
+
+    def write(self, df):
+        path = os.path.join(self.shm_dir, 'input-{}.arrow'.format(self.next_id))
+        da_write_shared(df, path)
+        return path
+
+    def close(self):
+        self.proc.stdin.write('{"exit":true}\n')
+        self.proc.stdin.flush()
+        self.proc.wait(timeout=30)
+
+
+def tst_protocol(w):
+    ready = w.read_reply()
+    assert ready.get('ready') is True, ready
+
+    df = pd.DataFrame({'a': [1, 2, 3, 4], 'b': [4.0, 3.0, 2.0, 1.0]}, index=[10, 11, 12, 13])
+    src = w.write(df)
+
+    # 返回dataframe
+    r = w.call('DAWorkbench.dataframe.da_create_pivot_table', {'df': src}, {'index': 'a', 'values': 'b', 'aggfunc': 'sum'})
+    assert r['ok'], r['error']
+    pivot = da_read_shared(r['frames']['result'])
+    assert list(pivot['b']) == [4.0, 3.0, 2.0, 1.0], pivot
+
+    # 直接修改输入的函数，没有return_frame时没有输出
+    r = w.call('DAWorkbench.dataframe.da_query_datas', {'df': src}, {'expr': 'a > 1'})
+    assert r['ok'] and not r['frames'], r
+
+    # 指定return_frame时返回修改后的输入，输入文件不变
+    r = w.call('DAWorkbench.dataframe.da_query_datas', {'df': src}, {'expr': 'a > 1'}, return_frame='df')
+    assert r['ok'], r['error']
+    filtered_path = r['frames']['result']
+    pd.testing.assert_frame_equal(da_read_shared(src, remove=False), df)
+
+    # 上一次的输出直接作为下一次的输入
+    r = w.call('DAWorkbench.dataframe.da_sort', {'df': filtered_path}, {'by': 'b', 'ascending': True}, return_frame='df')
+    assert r['ok'], r['error']
+    os.remove(filtered_path)
+    res = da_read_shared(r['frames']['result'])
+    pd.testing.assert_frame_equal(res, df[df['a'] > 1].sort_values('b'))
+
+    # 异常
+    r = w.call('DAWorkbench.dataframe.da_not_exist', {'df': src})
+    assert not r['ok'] and 'da_not_exist' in r['error'], r
+    r = w.call('DAWorkbench.dataframe.da_query_datas', {'df': src}, {'expr': 'a > 3'}, return_frame='df')
+    assert r['ok'] and len(da_read_shared(r['frames']['result'])) == 1, r
+    os.remove(src)
+
+
+if __name__ == '__main__':
+    failed = 0
+    w = Worker()
+    try:
+        tst_protocol(w)
+        print('PASS tst_protocol')
+    except Exception:
+        failed += 1
+        print('FAIL tst_protocol')
+        traceback.print_exc()
+    finally:
+        w.close()
+    left = os.listdir(w.shm_dir)
+    if left:
+        failed += 1
+        print('FAIL shared files are left:', left)
+    os.rmdir(w.shm_dir) if not left else None
+    print('FAILED' if failed else 'PASSED')
+    sys.exit(1 if failed else 0)
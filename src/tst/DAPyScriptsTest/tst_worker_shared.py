@@ -0,0 +1,106 @@
+# -*- coding: utf-8 -*-
+# DAWorkbench.worker共享内存文件读写的往返测试
+# dataframe/series写入共享内存后再读取，列标签、索引、名称和类型都应与原来一致
+# 全部通过返回0，否则返回1
+import os
+import sys
+import tempfile
+import traceback
+
+import numpy as np
+import pandas as pd
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'PyScripts'))
+from DAWorkbench.worker import da_write_shared, da_read_shared  # noqa: E402
+
+
+def _round_trip(obj):
+    path = os.path.join(tempfile.gettempdir(), 'tst-da-worker-{}.arrow'.format(os.getpid()))
+    da_write_shared(obj, path)
+    res = da_read_shared(path, remove=True)
+    if os.path.exists(path):
+        raise AssertionError('shared file is not removed')
+    return res
+
+
+def _check(obj):
+    res = _round_trip(obj)
+    if isinstance(obj, pd.Series):
+        pd.testing.assert_series_equal(res, obj, check_exact=True)
+    else:
+        pd.testing.assert_frame_equal(res, obj, check_exact=True)
+        pd.testing.assert_index_equal(res.columns, obj.columns, exact=True)
+    pd.testing.assert_index_equal(res.index, obj.index, exact=True)
+
+
+def tst_int_columns():
+    _check(pd.DataFrame({0: [1, 2], 1: [3.5, 4.5]}))
+
+
+def tst_mixed_and_duplicate_columns():
+    df = pd.DataFrame([[1, 2, 3]], columns=['a', 1, 'a'])
+    _check(df)
+
+
+def tst_unnamed_index():
+    _check(pd.DataFrame({'a': [1, 2, 3]}, index=[10, 20, 30]))
+
+
+def tst_named_index():
+    _check(pd.DataFrame({'a': [1, 2]}, index=pd.Index(['x', 'y'], name='key')))
+
+
+def tst_range_index():
+    _check(pd.DataFrame({'a': [1, 2, 3]}, index=pd.RangeIndex(5, 11, 2, name='r')))
+
+
+def tst_multi_index():
+    idx = pd.MultiIndex.from_tuples([('a', 1), ('a', 2), ('b', 1)], names=['k', None])
+    _check(pd.DataFrame({'v': [1.0, 2.0, 3.0]}, index=idx))
+
+
+def tst_multi_columns():
+    cols = pd.MultiIndex.from_tuples([('a', 'x'), ('a', 'y'), ('b', 'x')], names=['l0', 'l1'])
+    _check(pd.DataFrame([[1, 2, 3]], columns=cols))
+
+
+def tst_existing_index_column():
+    # 原来reset_index时已有index列会失败
+    _check(pd.DataFrame({'index': [1, 2], 'level_0': [3, 4]}, index=[7, 8]))
+
+
+def tst_series():
+    _check(pd.Series([1, 2, 3]))
+    _check(pd.Series([1, 2, 3], name='s', index=['a', 'b', 'c']))
+    _check(pd.Series([1.5, 2.5], name=3))
+
+
+def tst_dtypes():
+    df = pd.DataFrame({
+        'cat': pd.Categorical(['a', 'b', 'a']),
+        'dt': pd.date_range('2024-01-01', periods=3, tz='Asia/Shanghai'),
+        'i64': pd.array([1, None, 3], dtype='Int64'),
+        'b': [True, False, True],
+        'f': [np.nan, 1.0, 2.0],
+    })
+    _check(df)
+
+
+def tst_empty():
+    _check(pd.DataFrame({'a': pd.Series([], dtype='float64')}))
+    _check(pd.DataFrame(index=[1, 2, 3]))
+
+
+if __name__ == '__main__':
+    failed = 0
+    for name, fun in sorted(globals().items()):
+        if name.startswith('tst_') and callable(fun):
+            try:
+                fun()
+                print('PASS', name)
+            except Exception:
+                failed += 1
+                print('FAIL', name)
+                traceback.print_exc()
+    print('FAILED' if failed else 'PASSED')
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,119 @@
+﻿// python工作进程池的测试
+// - 主线程一直持有GIL时，其他线程通过callShared调用进程池不需要GIL（会获取GIL的实现在这里会死锁）
+// - 直接修改输入的函数通过returnFrame返回修改后的dataframe
+// - 上一次调用输出的共享内存dataframe可以直接作为下一次调用的输入，句柄销毁后文件删除
+// - 函数不存在时返回失败，取消时返回canceled
+// 全部通过返回0，否则返回1
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include "DAPyInterpreter.h"
+#include "DAPyScripts.h"
+#include "DAPyWorkerPool.h"
+#include "DAPybind11InQt.h"
+
+using namespace DA;
+
+#define TST_CHECK(cond, msg)                                                                                           \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            qCritical() << msg;                                                                                        \
+            ++failed;                                                                                                  \
+        }                                                                                                              \
+    } while (0)
+
+/**
+ * @brief 在工作线程中执行的调用，不获取GIL
+ */
+struct TstPoolCalls
+{
+    DAPyWorkerPool::SharedResult filtered;
+    DAPyWorkerPool::SharedResult sorted;
+    DAPyWorkerPool::SharedResult notExist;
+    DAPyWorkerPool::SharedResult canceled;
+    bool holdGIL { true };
+};
+
+static TstPoolCalls run_calls(DAPyWorkerPool& pool, const DAPySharedFrame& input)
+{
+    TstPoolCalls c;
+    c.holdGIL  = (PyGILState_Check() != 0);
+    c.filtered = pool.callShared("DAWorkbench.dataframe.da_query_datas", { { "df", input } }, { { "expr", "a > 1" } }, -1, {}, "df");
+    c.sorted   = pool.callShared("DAWorkbench.dataframe.da_sort",
+                               { { "df", c.filtered.frames.value("result") } },
+                               { { "by", "b" }, { "ascending", true } },
+                               -1,
+                               {},
+                               "df");
+    c.notExist = pool.callShared("DAWorkbench.dataframe.da_not_exist", { { "df", input } });
+    c.canceled = pool.callShared("DAWorkbench.dataframe.da_sort",
+                                 { { "df", input } },
+                                 { { "by", "b" }, { "ascending", true } },
+                                 -1,
+                                 []() { return true; });
+    return c;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    int failed = 0;
+    try {
+        DAPyInterpreter& python = DAPyInterpreter::getInstance();
+        python.setPythonHomePath(QFileInfo(DAPyInterpreter::getPythonInterpreterPath()).absolutePath());
+        python.initializePythonInterpreter();
+        DAPyScripts::appendSysPath(QDir::toNativeSeparators(DA_TST_PYSCRIPTS_DIR));
+    } catch (const std::exception& e) {
+        qCritical() << "initialize python error:" << e.what();
+        return 1;
+    }
+    DAPyWorkerPool& pool = DAPyWorkerPool::getInstance();
+    pool.setScriptsPath(DA_TST_PYSCRIPTS_DIR);
+    pool.setWorkerCount(2);
+
+    // 主线程持有GIL，创建输入
+    DAPySharedFrame input;
+    {
+        pybind11::dict data;
+        data[ "a" ] = pybind11::make_tuple(1, 2, 3, 4);
+        data[ "b" ] = pybind11::make_tuple(4.0, 3.0, 2.0, 1.0);
+        DAPyDataFrame df(pybind11::module_::import("pandas").attr("DataFrame")(data));
+        input = pool.writeShared(df);
+    }
+    TST_CHECK(!input.isNull() && QFile::exists(input.getPath()), "write shared frame failed");
+
+    // 主线程不释放GIL，调用在其他线程进行
+    std::future< TstPoolCalls > future = std::async(std::launch::async, [ &pool, input ]() { return run_calls(pool, input); });
+    if (future.wait_for(std::chrono::seconds(120)) != std::future_status::ready) {
+        qCritical() << "callShared blocks while the main thread holds the GIL";
+        std::_Exit(1);
+    }
+    TstPoolCalls c = future.get();
+    TST_CHECK(!c.holdGIL, "call thread should not hold the GIL");
+    TST_CHECK(c.filtered.success && !c.filtered.frames.value("result").isNull(),
+              "in place function should return the modified frame:" << c.filtered.error);
+    TST_CHECK(c.sorted.success, "shared output should be used as input:" << c.sorted.error);
+    TST_CHECK(!c.notExist.success && !c.notExist.canceled, "call of not exist function should fail");
+    TST_CHECK(c.canceled.canceled, "canceled call should return canceled");
+
+    // 主线程读取结果
+    const DAPySharedFrame sorted = c.sorted.frames.value("result");
+    {
+        DAPyDataFrame df = sorted.toDataFrame();
+        TST_CHECK(df.shape().first == 3, "sorted frame should have 3 rows");
+        TST_CHECK(df.iat(0, 1).toDouble() == 1.0, "sorted frame should be ascending by b");
+    }
+    // 句柄全部销毁后删除共享内存文件
+    const QString filteredPath = c.filtered.frames.value("result").getPath();
+    c = TstPoolCalls();
+    TST_CHECK(!QFile::exists(filteredPath), "shared file should be removed with the last handle");
+
+    pool.stop();
+    qInfo() << (failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
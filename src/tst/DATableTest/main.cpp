@@ -0,0 +1,177 @@
+﻿// DATable.hpp按行存储的稀疏表的测试
+// - 单元格的读写、查找、at越界、负索引
+// - 迭代器按行、行内按列升序访问，row/transferRow直接遍历行的存储，transferColumn
+// - 删除边界上的单元格、erase_if、dropColumn后shape和每行/每列的计数正确
+// - 随机读写大的稀疏表，和std::map的结果一致
+// 全部通过返回0，否则返回1
+#include <cstdio>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include <QDebug>
+#include "DATable.hpp"
+
+using namespace DA;
+using Table = DATable< int >;
+
+static int s_failed = 0;
+
+static void check(bool ok, const char* what)
+{
+    if (!ok) {
+        qCritical() << "check failed:" << what;
+        ++s_failed;
+    }
+}
+
+static std::vector< Table::IndexPair > keys_of(const Table& t)
+{
+    std::vector< Table::IndexPair > res;
+    for (auto i = t.begin(); i != t.end(); ++i) {
+        res.push_back(i->first);
+    }
+    return res;
+}
+
+static void tst_cell()
+{
+    Table t;
+    check(t.empty() && t.shape() == Table::IndexPair(0, 0), "empty table");
+    t.set(2, 3, 23);
+    t.set(0, 1, 1);
+    t[ { 2, 0 } ] = 20;
+    t.set(2, 3, 230);
+    check(t.size() == 3 && t.shape() == Table::IndexPair(3, 4), "shape after set");
+    check(t.cell(2, 3) == 230 && t.at(2, 0) == 20 && t.cell(1, 1) == 0, "cell value");
+    check(t.contain(0, 1) && !t.contain(1, 1) && !t.contain(-1, 0) && !t.contain(9, 9), "contain");
+    check(t.cellData(0, 1) && *t.cellData(0, 1) == 1 && !t.cellData(0, 2), "cellData");
+    check(t.find(2, 0) != t.end() && t.find(2, 0)->second == 20 && t.find(2, 1) == t.end(), "find");
+    t.find(2, 0)->second = 21;
+    check(t.cell(2, 0) == 21, "modify through iterator");
+    bool thrown = false;
+    try {
+        std::ignore = t.at(1, 1);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    check(thrown, "at throws for missing cell");
+    // 负索引
+    t.set(-1, 0, 1);
+    check(t.size() == 3, "negative index is ignored");
+    thrown = false;
+    try {
+        t[ { 0, -1 } ] = 1;
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    check(thrown, "operator[] throws for negative index");
+    // 拷贝和移动
+    Table copy = t;
+    Table moved(std::move(copy));
+    check(moved.size() == 3 && moved.cell(2, 3) == 230 && moved.shape() == t.shape(), "copy and move");
+    check(copy.empty() && copy.shape() == Table::IndexPair(0, 0), "moved-from table is empty");
+}
+
+static void tst_row_order()
+{
+    Table t;
+    t.set(3, 5, 35);
+    t.set(0, 2, 2);
+    t.set(3, 1, 31);
+    t.set(0, 0, 0);
+    t.set(3, 3, 33);
+    const std::vector< Table::IndexPair > expect { { 0, 0 }, { 0, 2 }, { 3, 1 }, { 3, 3 }, { 3, 5 } };
+    check(keys_of(t) == expect, "iteration is row major and column ascending");
+    check(t.rowCellCount(3) == 3 && t.rowCellCount(1) == 0 && t.rowCellCount(100) == 0, "row cell count");
+    check(t.row(3).size() == 3 && t.row(3)[ 1 ].second == 33, "row storage");
+    std::vector< int > cols;
+    t.transferRow(3, [ &cols ](int c, const int& v) {
+        cols.push_back(c);
+        return v != 33;
+    });
+    check(cols == std::vector< int > { 1, 3 }, "transferRow stops when the function returns false");
+    std::vector< int > values;
+    t.set(1, 3, 13);
+    t.transferColumn(3, [ &values ](const int& v) {
+        values.push_back(v);
+        return true;
+    });
+    check(values == std::vector< int > { 13, 33 } && t.columnCellCount(3) == 2, "transferColumn");
+    const DATable< double > d = t.transfered< double >([](const int& v) -> double { return v / 2.0; });
+    check(d.size() == t.size() && d.cell(3, 5) == 17.5, "transfered");
+    const da_vector_table< int > v = table_transfered< int, int >(t);
+    check(v.row_count() == 4 && v[ 3 ][ 5 ] == 35 && v[ 2 ][ 0 ] == 0, "table_transfered");
+}
+
+static void tst_shrink()
+{
+    Table t;
+    for (int r = 0; r < 5; ++r) {
+        for (int c = 0; c < 4; ++c) {
+            t.set(r, c, r * 10 + c);
+        }
+    }
+    check(t.removeCell(2, 2) && !t.removeCell(2, 2) && t.shape() == Table::IndexPair(5, 4), "remove inner cell");
+    for (int c = 0; c < 4; ++c) {
+        t.removeCell(4, c);
+    }
+    check(t.shape() == Table::IndexPair(4, 4), "remove last row");
+    // 删除最后一列，shape收缩到下一个有内容的列
+    t.erase_if([](const Table::value_type& v) { return v.first.second >= 2; });
+    check(t.shape() == Table::IndexPair(4, 2) && t.size() == 8, "erase_if shrinks columns");
+    check(t.columnCellCount(0) == 4 && t.columnCellCount(2) == 0, "column counts after erase_if");
+    t.dropColumn(0);
+    check(t.shape() == Table::IndexPair(4, 1) && t.size() == 4 && t.cell(3, 0) == 31, "dropColumn shifts columns left");
+    t.erase_if([](const Table::value_type& v) { return v.first.first >= 1; });
+    check(t.shape() == Table::IndexPair(1, 1) && t.size() == 1, "erase_if shrinks rows");
+    t.clear();
+    check(t.empty() && t.shape() == Table::IndexPair(0, 0) && t.begin() == t.end(), "clear");
+}
+
+static void tst_random()
+{
+    const int rows = 100000;
+    const int cols = 1000;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution< int > rd(0, rows - 1), cd(0, cols - 1);
+    Table t;
+    std::map< Table::IndexPair, int > ref;
+    for (int i = 0; i < 200000; ++i) {
+        const Table::IndexPair k(rd(rng), cd(rng));
+        if (i % 3 == 2) {
+            check(t.removeCell(k) == (ref.erase(k) > 0), "random remove");
+        } else {
+            t.set(k, i);
+            ref[ k ] = i;
+        }
+    }
+    int maxRow = -1, maxCol = -1;
+    for (const auto& v : ref) {
+        maxRow = std::max(maxRow, v.first.first);
+        maxCol = std::max(maxCol, v.first.second);
+    }
+    check(t.size() == ref.size() && t.shape() == Table::IndexPair(maxRow + 1, maxCol + 1), "random shape");
+    auto i    = t.begin();
+    bool same = true;
+    for (const auto& v : ref) {
+        if (i == t.end() || i->first != v.first || i->second != v.second) {
+            same = false;
+            break;
+        }
+        ++i;
+    }
+    check(same && i == t.end(), "random content");
+}
+
+int main(int argc, char* argv[])
+{
+    Q_UNUSED(argc);
+    Q_UNUSED(argv);
+    tst_cell();
+    tst_row_order();
+    tst_shrink();
+    tst_random();
+    std::printf("%s\n", s_failed ? "FAILED" : "PASSED");
+    return s_failed ? 1 : 0;
+}
@@ -0,0 +1,111 @@
+﻿// 工作流增量执行的测试
+// 常数节点（DAStandardNodeConstValue）连接一个可缓存的计数节点和一个不可缓存的计数节点：
+// - 常数节点输出常数，标记为可缓存
+// - 开启增量执行，工作流第二次执行时可缓存节点不再执行，下游拿到和上次一样的数据
+// - 常数改变后，可缓存节点重新执行
+// - 不可缓存的节点和关闭增量执行时，节点每次都执行
+// 全部通过返回0，否则返回1
+#include <QApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <atomic>
+#include "DAWorkFlow.h"
+#include "StandardNodes/DAStandardNodeConstValue.h"
+
+using namespace DA;
+
+// 计数节点，输出输入的2倍，记录执行次数
+class TstCountNode : public DAAbstractNode
+{
+public:
+    TstCountNode(bool cacheable)
+    {
+        metaData().setNodePrototype("tst.Count");
+        metaData().setNodeName("Count");
+        metaData().setThreadSafe(true);
+        metaData().setCacheable(cacheable);
+        addInputKey("in");
+        addOutputKey("out");
+    }
+    bool exec() override
+    {
+        ++execCount;
+        setOutputData("out", getInputData("in").toInt() * 2);
+        return true;
+    }
+    DAAbstractNodeGraphicsItem* createGraphicsItem() override
+    {
+        return nullptr;
+    }
+    std::atomic< int > execCount { 0 };
+};
+
+/**
+ * @brief 执行工作流，等待执行完成
+ * @param wf
+ * @return 执行是否成功
+ */
+static bool run_workflow(DAWorkFlow& wf)
+{
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(&wf, &DAWorkFlow::finished, &loop, [ &loop, &success ](bool s) {
+        success = s;
+        loop.quit();
+    });
+    wf.exec();
+    loop.exec();
+    return success;
+}
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    int failed = 0;
+
+    DAWorkFlow wf;
+    wf.setEnableIncrementalExecute(true);
+    auto constValue = std::make_shared< DAStandardNodeConstValue >();
+    auto cached     = std::make_shared< TstCountNode >(true);
+    auto uncached   = std::make_shared< TstCountNode >(false);
+    if (!constValue->metaData().isCacheable()) {
+        qCritical() << "DAStandardNodeConstValue should be cacheable";
+        ++failed;
+    }
+    constValue->setValue(2);
+    wf.addNode(constValue);
+    wf.addNode(cached);
+    wf.addNode(uncached);
+    constValue->linkTo("value", cached, "in");
+    constValue->linkTo("value", uncached, "in");
+
+    // 第一次执行，全部节点都执行
+    if (!run_workflow(wf) || cached->execCount != 1 || uncached->execCount != 1 || cached->getOutputData("out").toInt() != 4) {
+        qCritical() << "first execute failed, cached exec count =" << cached->execCount << ", out =" << cached->getOutputData("out");
+        ++failed;
+    }
+    // 第二次执行，可缓存的节点复用输出
+    if (!run_workflow(wf) || cached->execCount != 1 || uncached->execCount != 2 || cached->getOutputData("out").toInt() != 4) {
+        qCritical() << "unchanged cacheable node should not execute again, exec count =" << cached->execCount;
+        ++failed;
+    }
+    // 改变常数，可缓存节点重新执行
+    constValue->setValue(3);
+    if (!run_workflow(wf) || cached->execCount != 2 || cached->getOutputData("out").toInt() != 6) {
+        qCritical() << "cacheable node should execute after the const value changed, exec count =" << cached->execCount
+                    << ", out =" << cached->getOutputData("out");
+        ++failed;
+    }
+    // 关闭增量执行，每次都执行
+    wf.setEnableIncrementalExecute(false);
+    if (!run_workflow(wf) || cached->execCount != 3) {
+        qCritical() << "cacheable node should execute when incremental execute is disabled, exec count =" << cached->execCount;
+        ++failed;
+    }
+
+    qInfo() << (failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
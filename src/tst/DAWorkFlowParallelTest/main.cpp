@@ -0,0 +1,137 @@
+﻿// 工作流并行执行的测试
+// 一个源节点连接4个耗时200ms的分支节点：
+// - 分支节点线程安全时，开启并行执行后应同时运行（最大并发数>1）
+// - 分支节点非线程安全时，即使开启并行执行也只能在执行器线程中串行执行（最大并发数=1）
+// - 标准节点中的纯C++节点（DAStandardNodeConstValue）应标记为线程安全
+// 全部通过返回0，否则返回1
+#include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QThread>
+#include <atomic>
+#include "DAWorkFlow.h"
+#include "StandardNodes/DAStandardNodeConstValue.h"
+
+using namespace DA;
+
+static std::atomic< int > s_running { 0 };
+static std::atomic< int > s_max_running { 0 };
+
+// 源节点，输出一个整数
+class TstSourceNode : public DAAbstractNode
+{
+public:
+    TstSourceNode()
+    {
+        metaData().setNodePrototype("tst.Source");
+        metaData().setNodeName("Source");
+        metaData().setThreadSafe(true);
+        addOutputKey("out");
+    }
+    bool exec() override
+    {
+        setOutputData("out", 1);
+        return true;
+    }
+    DAAbstractNodeGraphicsItem* createGraphicsItem() override
+    {
+        return nullptr;
+    }
+};
+
+// 耗时节点，记录同时执行的节点数量
+class TstSleepNode : public DAAbstractNode
+{
+public:
+    TstSleepNode(bool threadSafe)
+    {
+        metaData().setNodePrototype("tst.Sleep");
+        metaData().setNodeName("Sleep");
+        metaData().setThreadSafe(threadSafe);
+        addInputKey("in");
+        addOutputKey("out");
+    }
+    bool exec() override
+    {
+        const int r = ++s_running;
+        int m       = s_max_running.load();
+        while (r > m && !s_max_running.compare_exchange_weak(m, r)) {
+        }
+        QThread::msleep(200);
+        --s_running;
+        setOutputData("out", getInputData("in"));
+        return true;
+    }
+    DAAbstractNodeGraphicsItem* createGraphicsItem() override
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * @brief 执行源节点+4个分支的工作流
+ * @param threadSafe 分支节点是否线程安全
+ * @param maxRunning 最大并发数
+ * @param ms 耗时
+ * @return 执行是否成功
+ */
+static bool run_branches(bool threadSafe, int& maxRunning, qint64& ms)
+{
+    s_running     = 0;
+    s_max_running = 0;
+    DAWorkFlow wf;
+    wf.setEnableParallelExecute(true);
+    auto src = std::make_shared< TstSourceNode >();
+    wf.addNode(src);
+    for (int i = 0; i < 4; ++i) {
+        auto n = std::make_shared< TstSleepNode >(threadSafe);
+        wf.addNode(n);
+        src->linkTo("out", n, "in");
+    }
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(&wf, &DAWorkFlow::finished, &loop, [ &loop, &success ](bool s) {
+        success = s;
+        loop.quit();
+    });
+    QElapsedTimer timer;
+    timer.start();
+    wf.exec();
+    loop.exec();
+    ms         = timer.elapsed();
+    maxRunning = s_max_running.load();
+    return success;
+}
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    int failed = 0;
+
+    DAStandardNodeConstValue constValue;
+    if (!constValue.metaData().isThreadSafe()) {
+        qCritical() << "DAStandardNodeConstValue should be thread safe";
+        ++failed;
+    }
+
+    int maxRunning = 0;
+    qint64 ms      = 0;
+    if (!run_branches(true, maxRunning, ms) || maxRunning < 2) {
+        qCritical() << "thread safe branches should run concurrently, max running =" << maxRunning;
+        ++failed;
+    }
+    qInfo() << "thread safe branches: max running =" << maxRunning << ", cost" << ms << "ms";
+
+    if (!run_branches(false, maxRunning, ms) || maxRunning != 1) {
+        qCritical() << "non thread safe branches should run one by one, max running =" << maxRunning;
+        ++failed;
+    }
+    qInfo() << "non thread safe branches: max running =" << maxRunning << ", cost" << ms << "ms";
+
+    qInfo() << (failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
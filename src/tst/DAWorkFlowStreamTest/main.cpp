@@ -0,0 +1,168 @@
+﻿// 工作流流式输出的测试
+// 常数节点输出一个列表，分批节点（DAStandardNodeBatchSplit）逐批写入流式输出，合批节点（DAStandardNodeBatchCollect）逐批读取：
+// - 并行执行（有界数据流）和串行执行（不限制容量的数据流）的结果和输入一致
+// - 合批节点只读取1个批次后提前结束，数据流被取消，分批节点的写入返回false并停止，工作流不会卡住
+// - 下游节点同时连接流式输出和依赖上游的普通输出时，执行器改用不限制容量的数据流，工作流不会死锁
+// 死锁时测试由ctest的超时判为失败
+// 全部通过返回0，否则返回1
+#include <QApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include "DAWorkFlow.h"
+#include "StandardNodes/DAStandardNodeConstValue.h"
+#include "StandardNodes/DAStandardNodeBatchSplit.h"
+#include "StandardNodes/DAStandardNodeBatchCollect.h"
+
+using namespace DA;
+
+// 同时读取流式输入“batch”和普通输入“list”，输出两者元素个数之和
+class TstMixedNode : public DAAbstractNode
+{
+public:
+    TstMixedNode()
+    {
+        metaData().setNodePrototype("tst.Mixed");
+        metaData().setNodeName("Mixed");
+        metaData().setThreadSafe(true);
+        addInputKey("batch");
+        addInputKey("list");
+        addOutputKey("out");
+    }
+    bool exec() override
+    {
+        int count = getInputData("list").toList().size();
+        QVariant batch;
+        while (readInputBatch("batch", batch)) {
+            count += batch.toList().size();
+        }
+        setOutputData("out", count);
+        return true;
+    }
+    DAAbstractNodeGraphicsItem* createGraphicsItem() override
+    {
+        return nullptr;
+    }
+};
+
+/**
+ * @brief 执行工作流，等待执行完成
+ * @param wf
+ * @return 执行是否成功
+ */
+static bool run_workflow(DAWorkFlow& wf)
+{
+    bool success = false;
+    QEventLoop loop;
+    QObject::connect(&wf, &DAWorkFlow::finished, &loop, [ &loop, &success ](bool s) {
+        success = s;
+        loop.quit();
+    });
+    wf.exec();
+    loop.exec();
+    return success;
+}
+
+static QVariantList make_values(int n)
+{
+    QVariantList res;
+    for (int i = 0; i < n; ++i) {
+        res.append(i);
+    }
+    return res;
+}
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    int failed = 0;
+
+    // 完整读取，并行和串行的结果一致
+    {
+        const QVariantList values = make_values(10);
+        DAWorkFlow wf;
+        wf.setStreamCapacity(2);
+        auto constValue = std::make_shared< DAStandardNodeConstValue >();
+        auto split      = std::make_shared< DAStandardNodeBatchSplit >();
+        auto collect    = std::make_shared< DAStandardNodeBatchCollect >();
+        if (!split->isOutputStreaming("batch") || !split->metaData().isThreadSafe() || !collect->metaData().isThreadSafe()) {
+            qCritical() << "batch split/collect should be thread safe with a streaming output";
+            ++failed;
+        }
+        constValue->setValue(values);
+        split->setBatchSize(3);
+        wf.addNode(constValue);
+        wf.addNode(split);
+        wf.addNode(collect);
+        constValue->linkTo("value", split, "value");
+        split->linkTo("batch", collect, "batch");
+        for (bool parallel : { true, false }) {
+            wf.setEnableParallelExecute(parallel);
+            if (!run_workflow(wf) || collect->getOutputData("value").toList() != values || split->getWrittenBatchCount() != 4) {
+                qCritical() << "stream result mismatch, parallel =" << parallel << ", batches =" << split->getWrittenBatchCount()
+                            << ", value =" << collect->getOutputData("value");
+                ++failed;
+            }
+        }
+    }
+
+    // 下游提前结束，上游的写入返回false
+    {
+        const int n = 1000;
+        DAWorkFlow wf;
+        wf.setEnableParallelExecute(true);
+        wf.setStreamCapacity(2);
+        auto constValue = std::make_shared< DAStandardNodeConstValue >();
+        auto split      = std::make_shared< DAStandardNodeBatchSplit >();
+        auto collect    = std::make_shared< DAStandardNodeBatchCollect >();
+        constValue->setValue(make_values(n));
+        split->setBatchSize(1);
+        collect->setMaxBatchCount(1);
+        wf.addNode(constValue);
+        wf.addNode(split);
+        wf.addNode(collect);
+        constValue->linkTo("value", split, "value");
+        split->linkTo("batch", collect, "batch");
+        if (!run_workflow(wf) || collect->getOutputData("value").toList() != QVariantList { 0 }) {
+            qCritical() << "canceled stream failed, value =" << collect->getOutputData("value");
+            ++failed;
+        }
+        // 有界数据流中最多积压容量个批次，取消后生产者停止
+        if (split->getWrittenBatchCount() >= n) {
+            qCritical() << "producer should stop after the consumer canceled, batches =" << split->getWrittenBatchCount();
+            ++failed;
+        }
+    }
+
+    // 下游同时依赖流式输出和上游的普通输出
+    {
+        const int n = 100;
+        DAWorkFlow wf;
+        wf.setEnableParallelExecute(true);
+        wf.setStreamCapacity(2);
+        auto constValue = std::make_shared< DAStandardNodeConstValue >();
+        auto split      = std::make_shared< DAStandardNodeBatchSplit >();
+        auto collect    = std::make_shared< DAStandardNodeBatchCollect >();
+        auto mixed      = std::make_shared< TstMixedNode >();
+        constValue->setValue(make_values(n));
+        split->setBatchSize(1);
+        wf.addNode(constValue);
+        wf.addNode(split);
+        wf.addNode(collect);
+        wf.addNode(mixed);
+        constValue->linkTo("value", split, "value");
+        split->linkTo("batch", collect, "batch");
+        split->linkTo("batch", mixed, "batch");
+        // mixed要等collect执行完成，collect又要等split执行完成，有界数据流会使split阻塞
+        collect->linkTo("value", mixed, "list");
+        if (!run_workflow(wf) || mixed->getOutputData("out").toInt() != 2 * n) {
+            qCritical() << "mixed stream inputs failed, out =" << mixed->getOutputData("out");
+            ++failed;
+        }
+    }
+
+    qInfo() << (failed ? "FAILED" : "PASSED");
+    return failed ? 1 : 0;
+}
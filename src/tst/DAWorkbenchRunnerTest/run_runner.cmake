@@ -0,0 +1,34 @@
+
+# 运行DAWorkbenchRunner并检查输出
+# 参数：DA_RUNNER DA_PLUGIN_DIR DA_WORKFLOW DA_INPUT_DIR DA_OUTPUT_DIR
+
+file(REMOVE_RECURSE ${DA_OUTPUT_DIR})
+execute_process(
+    COMMAND ${DA_RUNNER} ${DA_WORKFLOW}
+        --input-glob ${DA_INPUT_DIR}/*.csv
+        --param "Read:path={input}"
+        --param "Write:path={output}/{basename}.csv"
+        --output-dir ${DA_OUTPUT_DIR}
+        --plugin-dir ${DA_PLUGIN_DIR}
+        --jobs 2
+    RESULT_VARIABLE DA_RES
+)
+if(NOT DA_RES EQUAL 0)
+    message(FATAL_ERROR "DAWorkbenchRunner return ${DA_RES}")
+endif()
+
+# a.csv过滤后保留3行，b.csv保留2行
+foreach(DA_CASE "a;4" "b;3")
+    list(GET DA_CASE 0 DA_NAME)
+    list(GET DA_CASE 1 DA_LINES)
+    set(DA_FILE ${DA_OUTPUT_DIR}/${DA_NAME}.csv)
+    if(NOT EXISTS ${DA_FILE})
+        message(FATAL_ERROR "missing output ${DA_FILE}")
+    endif()
+    file(STRINGS ${DA_FILE} DA_CONTENT)
+    list(LENGTH DA_CONTENT DA_COUNT)
+    if(NOT DA_COUNT EQUAL DA_LINES)
+        message(FATAL_ERROR "${DA_FILE} has ${DA_COUNT} lines,expected ${DA_LINES}")
+    endif()
+endforeach()
+message(STATUS "PASSED")